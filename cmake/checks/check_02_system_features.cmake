@@ -18,6 +18,8 @@
 #
 #   DEAL_II_HAVE_GETHOSTNAME
 #   DEAL_II_HAVE_GETPID
+#   DEAL_II_HAVE_LINUX_PERF_EVENT_H
+#   DEAL_II_HAVE_SYS_MMAN_H
 #   DEAL_II_HAVE_SYS_RESOURCE_H
 #   DEAL_II_HAVE_UNISTD_H
 #   DEAL_II_MSVC
@@ -33,12 +35,18 @@
 #
 # Check for various posix (and linux) specific header files and symbols
 #
+CHECK_INCLUDE_FILE_CXX("sys/mman.h" DEAL_II_HAVE_SYS_MMAN_H)
 CHECK_INCLUDE_FILE_CXX("sys/resource.h" DEAL_II_HAVE_SYS_RESOURCE_H)
 
 CHECK_INCLUDE_FILE_CXX("unistd.h" DEAL_II_HAVE_UNISTD_H)
 CHECK_CXX_SYMBOL_EXISTS("gethostname" "unistd.h" DEAL_II_HAVE_GETHOSTNAME)
 CHECK_CXX_SYMBOL_EXISTS("getpid" "unistd.h" DEAL_II_HAVE_GETPID)
 
+#
+# The perf_event_open interface used for reading hardware counters:
+#
+CHECK_INCLUDE_FILE_CXX("linux/perf_event.h" DEAL_II_HAVE_LINUX_PERF_EVENT_H)
+
 ########################################################################
 #                                                                      #
 #                        Mac OSX specific setup:                       #
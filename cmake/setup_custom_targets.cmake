@@ -151,6 +151,7 @@ FILE(WRITE ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/print_info.cmake
 #    package        - build binary package
 #
 #    test           - run a minimal set of tests
+#    benchmarks     - run the benchmarks and compare against their baselines
 #
 #    setup_tests    - set up testsuite subprojects
 #    prune_tests    - remove all testsuite subprojects
@@ -34,9 +34,18 @@
 #endif
 #include <boost/serialization/split_member.hpp>
 
+#include <cstdint>
 #include <cstring>
+#include <functional>
+#include <limits>
 #include <type_traits>
 
+#if defined(DEAL_II_WITH_MPI) || defined(DEAL_II_WITH_PETSC)
+#  include <mpi.h>
+#else
+using MPI_Comm = int;
+#endif
+
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -232,6 +241,37 @@ public:
   void
   fill(const T &element);
 
+  /**
+   * Replicate the content of the vector on the process @p root_process of
+   * @p communicator to all other processes. For MPI implementations that
+   * support shared memory (MPI 3.0 and newer), the data is only stored once
+   * per node: The first process of each node allocates the memory in a
+   * window created with `MPI_Win_allocate_shared`, and all other processes
+   * of the node access the elements in that window. This is useful for
+   * large arrays that are identical on all processes, such as look-up tables
+   * or data describing a mesh, whose memory consumption would otherwise be
+   * multiplied by the number of processes per node.
+   *
+   * After this call, the elements must be treated as read-only, because write
+   * accesses from different processes to the shared memory are not
+   * synchronized. All operations that change the vector, i.e., clear(),
+   * resize(), resize_fast(), reserve(), push_back(), insert_back(), and the
+   * assignment operators, first move the elements to memory owned by the
+   * calling process, or release the shared memory if there are none left.
+   * Since the shared memory is released collectively, these operations and
+   * the destructor must be called by all processes of @p communicator at the
+   * same time.
+   *
+   * Without MPI, this function does nothing.
+   *
+   * @note This function can only be used for trivially copyable types @p T,
+   * because the processes can only access memory within the shared window,
+   * not memory pointed to by elements of the vector.
+   */
+  void
+  replicate_across_communicator(const MPI_Comm &   communicator,
+                                const unsigned int root_process);
+
   /**
    * Swaps the given vector with the calling vector.
    */
@@ -356,6 +396,14 @@ private:
    * Pointer to the end of the allocated memory.
    */
   T *allocated_end;
+
+  /**
+   * Function releasing the memory of this vector in case it has not been
+   * allocated by reserve(), but set up as a shared memory window by
+   * replicate_across_communicator(). Empty for the usual memory which is
+   * released by free().
+   */
+  std::function<void()> deleter;
 };
 
 
@@ -752,10 +800,12 @@ inline AlignedVector<T>::AlignedVector(AlignedVector<T> &&vec) noexcept
   : data_begin(vec.data_begin)
   , data_end(vec.data_end)
   , allocated_end(vec.allocated_end)
+  , deleter(std::move(vec.deleter))
 {
   vec.data_begin    = nullptr;
   vec.data_end      = nullptr;
   vec.allocated_end = nullptr;
+  vec.deleter       = nullptr;
 }
 
 
@@ -764,6 +814,9 @@ template <class T>
 inline AlignedVector<T> &
 AlignedVector<T>::operator=(const AlignedVector<T> &vec)
 {
+  // release the memory shared with other processes before writing to it
+  if (deleter)
+    clear();
   resize(0);
   resize_fast(vec.data_end - vec.data_begin);
   internal::AlignedVectorCopy<T>(vec.data_begin, vec.data_end, data_begin);
@@ -781,10 +834,12 @@ AlignedVector<T>::operator=(AlignedVector<T> &&vec) noexcept
   data_begin    = vec.data_begin;
   data_end      = vec.data_end;
   allocated_end = vec.allocated_end;
+  deleter       = std::move(vec.deleter);
 
   vec.data_begin    = nullptr;
   vec.data_end      = nullptr;
   vec.allocated_end = nullptr;
+  vec.deleter       = nullptr;
 
   return *this;
 }
@@ -871,13 +926,18 @@ AlignedVector<T>::reserve(const size_type size_alloc)
 {
   const size_type old_size       = data_end - data_begin;
   const size_type allocated_size = allocated_end - data_begin;
-  if (size_alloc > allocated_size)
+  // memory shared with other processes by replicate_across_communicator()
+  // must not be written to, so move the data to local memory whenever the
+  // vector gets modified
+  if (size_alloc > allocated_size || (deleter && size_alloc > 0))
     {
       // if we continuously increase the size of the vector, we might be
       // reallocating a lot of times. therefore, try to increase the size more
       // aggressively
       size_type new_size = size_alloc;
-      if (size_alloc < (2 * allocated_size))
+      if (deleter)
+        new_size = std::max(size_alloc, old_size);
+      else if (size_alloc < (2 * allocated_size))
         new_size = 2 * allocated_size;
 
       const size_type size_actual_allocate = new_size * sizeof(T);
@@ -895,14 +955,16 @@ AlignedVector<T>::reserve(const size_type size_alloc)
       data_end      = data_begin + old_size;
       allocated_end = data_begin + new_size;
       if (data_end != data_begin)
+        dealii::internal::AlignedVectorMove<T>(new_data,
+                                               new_data + old_size,
+                                               data_begin);
+      if (deleter)
         {
-          dealii::internal::AlignedVectorMove<T>(new_data,
-                                                 new_data + old_size,
-                                                 data_begin);
-          free(new_data);
+          deleter();
+          deleter = nullptr;
         }
       else
-        Assert(new_data == nullptr, ExcInternalError());
+        free(new_data);
     }
   else if (size_alloc == 0)
     clear();
@@ -916,11 +978,21 @@ AlignedVector<T>::clear()
 {
   if (data_begin != nullptr)
     {
-      if (std::is_trivial<T>::value == false)
-        while (data_end != data_begin)
-          (--data_end)->~T();
+      if (deleter)
+        {
+          // the elements in shared memory are trivially copyable and thus
+          // need not be destroyed
+          deleter();
+          deleter = nullptr;
+        }
+      else
+        {
+          if (std::is_trivial<T>::value == false)
+            while (data_end != data_begin)
+              (--data_end)->~T();
 
-      free(data_begin);
+          free(data_begin);
+        }
     }
   data_begin    = nullptr;
   data_end      = nullptr;
@@ -1009,6 +1081,148 @@ AlignedVector<T>::swap(AlignedVector<T> &vec)
   std::swap(data_begin, vec.data_begin);
   std::swap(data_end, vec.data_end);
   std::swap(allocated_end, vec.allocated_end);
+  std::swap(deleter, vec.deleter);
+}
+
+
+
+template <class T>
+inline void
+AlignedVector<T>::replicate_across_communicator(const MPI_Comm &   communicator,
+                                                const unsigned int root_process)
+{
+#  ifdef DEAL_II_WITH_MPI
+  static_assert(std::is_trivially_copyable<T>::value,
+                "AlignedVector::replicate_across_communicator() can only be "
+                "used for trivially copyable types.");
+
+  int rank = 0;
+  int ierr = MPI_Comm_rank(communicator, &rank);
+  AssertThrowMPI(ierr);
+  const bool is_root = rank == static_cast<int>(root_process);
+
+  unsigned long long int n_elements = size();
+  ierr                              = MPI_Bcast(&n_elements,
+                   1,
+                   MPI_UNSIGNED_LONG_LONG,
+                   root_process,
+                   communicator);
+  AssertThrowMPI(ierr);
+  const std::size_t n_bytes = n_elements * sizeof(T);
+
+  // MPI_Bcast takes the number of bytes as int, so send large arrays in
+  // several pieces
+  const auto broadcast_bytes = [n_bytes](void *         buffer,
+                                         const int      root,
+                                         const MPI_Comm comm) {
+    const std::size_t max_chunk = std::numeric_limits<int>::max();
+    for (std::size_t start = 0; start < n_bytes; start += max_chunk)
+      {
+        const int ierr =
+          MPI_Bcast(static_cast<char *>(buffer) + start,
+                    static_cast<int>(std::min(max_chunk, n_bytes - start)),
+                    MPI_CHAR,
+                    root,
+                    comm);
+        AssertThrowMPI(ierr);
+      }
+  };
+
+#    if DEAL_II_MPI_VERSION_GTE(3, 0)
+  if (n_elements == 0)
+    {
+      clear();
+      return;
+    }
+
+  // group the processes by the node they run on. the root process is made
+  // the first process on its node by passing zero as its key
+  const int key = is_root ? 0 : rank + 1;
+  MPI_Comm  shmem_communicator;
+  ierr = MPI_Comm_split_type(
+    communicator, MPI_COMM_TYPE_SHARED, key, MPI_INFO_NULL, &shmem_communicator);
+  AssertThrowMPI(ierr);
+  int shmem_rank = 0;
+  ierr           = MPI_Comm_rank(shmem_communicator, &shmem_rank);
+  AssertThrowMPI(ierr);
+
+  // only the first process on each node (including the root process)
+  // receives the data
+  MPI_Comm leader_communicator;
+  ierr = MPI_Comm_split(communicator,
+                        shmem_rank == 0 ? 0 : MPI_UNDEFINED,
+                        key,
+                        &leader_communicator);
+  AssertThrowMPI(ierr);
+
+  // allocate the memory on the first process of the node, including some
+  // extra space to align the data to 64 bytes like in reserve()
+  constexpr std::size_t alignment = 64;
+  void *                base_pointer;
+  MPI_Win               window;
+  ierr = MPI_Win_allocate_shared(shmem_rank == 0 ? n_bytes + alignment : 0,
+                                 1,
+                                 MPI_INFO_NULL,
+                                 shmem_communicator,
+                                 &base_pointer,
+                                 &window);
+  AssertThrowMPI(ierr);
+
+  MPI_Aint window_size;
+  int      displacement_unit;
+  ierr = MPI_Win_shared_query(
+    window, 0, &window_size, &displacement_unit, &base_pointer);
+  AssertThrowMPI(ierr);
+
+  unsigned int offset =
+    (alignment - reinterpret_cast<std::uintptr_t>(base_pointer) % alignment) %
+    alignment;
+  ierr = MPI_Bcast(&offset, 1, MPI_UNSIGNED, 0, shmem_communicator);
+  AssertThrowMPI(ierr);
+  T *shared_data =
+    reinterpret_cast<T *>(static_cast<char *>(base_pointer) + offset);
+
+  if (shmem_rank == 0)
+    {
+      if (is_root)
+        std::memcpy(static_cast<void *>(shared_data),
+                    static_cast<void *>(data_begin),
+                    n_bytes);
+      broadcast_bytes(shared_data, 0, leader_communicator);
+      ierr = MPI_Comm_free(&leader_communicator);
+      AssertThrowMPI(ierr);
+    }
+
+  // make sure the data written by the first process is visible on all
+  // processes of the node before the data gets accessed
+  ierr = MPI_Barrier(shmem_communicator);
+  AssertThrowMPI(ierr);
+
+  clear();
+  data_begin    = shared_data;
+  data_end      = shared_data + n_elements;
+  allocated_end = data_end;
+  deleter       = [window, shmem_communicator]() mutable {
+    // MPI_Win_free is collective and waits for all processes of the node,
+    // so no process is still reading from the memory when it gets released
+    int ierr = MPI_Win_free(&window);
+    AssertThrowMPI(ierr);
+    ierr = MPI_Comm_free(&shmem_communicator);
+    AssertThrowMPI(ierr);
+  };
+
+#    else
+
+  // without shared memory support, each process holds its own copy
+  if (!is_root)
+    resize_fast(n_elements);
+  broadcast_bytes(data_begin, root_process, communicator);
+
+#    endif
+#  else
+  (void)communicator;
+  (void)root_process;
+#  endif
 }
 
 
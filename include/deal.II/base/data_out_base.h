@@ -29,8 +29,13 @@
 // To be able to serialize XDMFEntry
 #include <boost/serialization/map.hpp>
 
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <limits>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <typeinfo>
 #include <vector>
@@ -1149,6 +1154,13 @@ namespace DataOutBase
     /**
      * Flag determining the compression level at which zlib, if available, is
      * run. The default is <tt>best_compression</tt>.
+     *
+     * Data arrays larger than one megabyte are split into blocks that are
+     * compressed independently of each other, as allowed by the VTK file
+     * format, and in parallel. If writing compressed output takes a
+     * significant amount of time, <tt>best_speed</tt> is typically several
+     * times faster than <tt>best_compression</tt> at the price of somewhat
+     * larger files.
      */
     ZlibCompressionLevel compression_level;
 
@@ -1256,6 +1268,67 @@ namespace DataOutBase
     static const unsigned int format_version;
   };
 
+  /**
+   * Flags controlling the layout of the datasets written to HDF5 files by
+   * write_hdf5_parallel().
+   *
+   * By default, datasets are stored contiguously and without compression,
+   * which is the fastest way to write them. Storing datasets in chunks is
+   * required for compression, and can also be useful for reading only parts
+   * of large datasets later on.
+   *
+   * @ingroup output
+   */
+  struct Hdf5Flags : public OutputFlagsBase<Hdf5Flags>
+  {
+    /**
+     * A data type providing the different possible compression levels of
+     * the deflate (zlib) filter of HDF5.
+     */
+    enum CompressionLevel
+    {
+      /**
+       * Do not use any compression. This is the default flag.
+       */
+      no_compression,
+      /**
+       * Use the fastest available compression level.
+       */
+      best_speed,
+      /**
+       * Use the compression level which results in the smallest files.
+       */
+      best_compression,
+      /**
+       * Use the default compression level of zlib. This is a compromise
+       * between speed and file size.
+       */
+      default_compression
+    };
+
+    /**
+     * Flag determining the compression level of all datasets.
+     *
+     * @note When writing a file in parallel, HDF5 only supports compressed
+     *   datasets starting with version 1.10.2.
+     */
+    CompressionLevel compression_level;
+
+    /**
+     * The number of rows (i.e., nodes or cells) in each chunk of a dataset.
+     * If this number is zero, datasets are stored contiguously unless
+     * compression is requested, in which case a chunk size of 65536 rows is
+     * used. Chunks are never larger than the dataset itself.
+     */
+    unsigned int chunk_size;
+
+    /**
+     * Constructor.
+     */
+    Hdf5Flags(const CompressionLevel compression_level = no_compression,
+              const unsigned int     chunk_size        = 0);
+  };
+
   /**
    * Flags controlling the DataOutFilter.
    *
@@ -2349,7 +2422,8 @@ namespace DataOutBase
    * false, the mesh data will not be written and the solution file will
    * contain only the solution values. If @p write_mesh_file is true and the
    * filenames are the same, the resulting file will contain both mesh data
-   * and solution values.
+   * and solution values. The last argument determines how the datasets are
+   * stored, see Hdf5Flags.
    */
   template <int dim, int spacedim>
   void
@@ -2358,7 +2432,217 @@ namespace DataOutBase
                       const bool                               write_mesh_file,
                       const std::string &                      mesh_filename,
                       const std::string &solution_filename,
-                      MPI_Comm           comm);
+                      MPI_Comm           comm,
+                      const Hdf5Flags &  flags = Hdf5Flags());
+
+  /**
+   * A class that writes HDF5 files in the background, so that the program
+   * can continue computing while the data is written to disk.
+   *
+   * write_hdf5_parallel() is a collective operation that only returns once
+   * all data has been written, which may take a long time on parallel file
+   * systems. This class instead takes a DataOutFilter object that already
+   * holds a copy of all data to be written, places it into a queue, and
+   * returns immediately. A dedicated thread then takes the snapshots from
+   * the queue in the order in which they were added and writes each of them
+   * using write_hdf5_parallel(). Since all processes add their snapshots in
+   * the same order, the collective operations of the background threads on
+   * the different processes match.
+   *
+   * A typical use in a time stepping loop looks as follows:
+   * @code
+   *   DataOutBase::AsynchronousHDF5Writer<dim> writer(MPI_COMM_WORLD);
+   *   std::vector<XDMFEntry> xdmf_entries;
+   *
+   *   for (unsigned int step = 0; step < n_steps; ++step)
+   *     {
+   *       ... // compute the solution and build the patches of data_out
+   *
+   *       DataOutBase::DataOutFilter data_filter(
+   *         DataOutBase::DataOutFilterFlags(true, true));
+   *       data_out.write_filtered_data(data_filter);
+   *
+   *       const std::string solution_filename =
+   *         "solution-" + Utilities::int_to_string(step, 4) + ".h5";
+   *       xdmf_entries.push_back(data_out.create_xdmf_entry(
+   *         data_filter, "mesh.h5", solution_filename, time, MPI_COMM_WORLD));
+   *       writer.write(std::move(data_filter),
+   *                    step == 0,
+   *                    "mesh.h5",
+   *                    solution_filename);
+   *
+   *       data_out.write_xdmf_file(xdmf_entries,
+   *                                "solution.xdmf",
+   *                                MPI_COMM_WORLD);
+   *     }
+   * @endcode
+   * Here, the mesh is only written at the first time step, and all XDMF
+   * entries refer to this mesh file.
+   *
+   * Each call to write() returns a `std::future` object that becomes ready
+   * once the snapshot has been written, and that rethrows any exception that
+   * happened while writing it. To bound the memory used by snapshots, at
+   * most the number of snapshots given to the constructor are kept at any
+   * time; if this number is reached, write() waits until the oldest
+   * snapshot has been written. The destructor waits for all pending
+   * snapshots to be written.
+   *
+   * @note Writing in the background requires that the other threads of the
+   *   program do not call MPI functions concurrently with the writer
+   *   thread, unless MPI supports this (i.e., it was initialized with
+   *   MPI_THREAD_MULTIPLE), and that they do not use HDF5 while snapshots
+   *   are pending, unless HDF5 was built to be thread-safe. The background
+   *   thread communicates on a duplicate of the communicator given to the
+   *   constructor, so its messages do not interfere with other
+   *   communication on the same communicator. If MPI has been initialized
+   *   but does not support MPI_THREAD_MULTIPLE, write() writes the data
+   *   immediately in the calling thread instead, even if the program runs
+   *   on a single process.
+   *
+   * @note Utilities::MPI::MPI_InitFinalize only requests
+   *   MPI_THREAD_SERIALIZED from MPI. In a typical deal.II program, this
+   *   class therefore always falls back to writing synchronously. To write
+   *   in the background, a program has to initialize MPI itself by calling
+   *   `MPI_Init_thread()` with `MPI_THREAD_MULTIPLE` instead of using
+   *   MPI_InitFinalize.
+   *
+   * @ingroup output
+   */
+  template <int dim, int spacedim = dim>
+  class AsynchronousHDF5Writer
+  {
+  public:
+    /**
+     * Constructor. The data of all snapshots is written collectively on
+     * @p comm, keeping at most @p max_pending_snapshots snapshots in memory
+     * at the same time, and the layout of the HDF5 datasets is determined
+     * by @p flags.
+     */
+    AsynchronousHDF5Writer(const MPI_Comm &   comm,
+                           const unsigned int max_pending_snapshots = 2,
+                           const Hdf5Flags &  flags = Hdf5Flags());
+
+    /**
+     * Destructor. Waits until all pending snapshots have been written.
+     */
+    ~AsynchronousHDF5Writer();
+
+    /**
+     * Queue the data in @p data_filter for being written to HDF5 file(s),
+     * with the same meaning of the remaining arguments as in
+     * write_hdf5_parallel(). The returned object becomes ready once the
+     * data has been written.
+     */
+    std::future<void>
+    write(DataOutFilter &&   data_filter,
+          const bool         write_mesh_file,
+          const std::string &mesh_filename,
+          const std::string &solution_filename);
+
+    /**
+     * Same as above, but write the mesh and the solution values into a
+     * single file.
+     */
+    std::future<void>
+    write(DataOutFilter &&data_filter, const std::string &filename);
+
+    /**
+     * Wait until all snapshots that have been queued so far have been
+     * written.
+     */
+    void
+    wait() const;
+
+    /**
+     * Return the number of snapshots that have been queued but not yet
+     * completely written.
+     */
+    unsigned int
+    n_pending_snapshots() const;
+
+    /**
+     * Return whether snapshots are written by a background thread, or
+     * immediately in write() because MPI does not allow the background
+     * thread to communicate.
+     */
+    bool
+    writes_asynchronously() const;
+
+  private:
+    /**
+     * The data of one call to write().
+     */
+    struct Snapshot
+    {
+      DataOutFilter      data_filter;
+      bool               write_mesh_file;
+      std::string        mesh_filename;
+      std::string        solution_filename;
+      std::promise<void> promise;
+    };
+
+    /**
+     * Write the given snapshot and return the exception that occurred while
+     * doing so, if any.
+     */
+    std::exception_ptr
+    write_snapshot(const Snapshot &snapshot) const;
+
+    /**
+     * The function run by the background thread.
+     */
+    void
+    run();
+
+    /**
+     * The communicator used for writing the files.
+     */
+    const Utilities::MPI::DuplicatedCommunicator communicator;
+
+    /**
+     * The maximal number of snapshots in the queue.
+     */
+    const unsigned int max_pending_snapshots;
+
+    /**
+     * The flags passed to write_hdf5_parallel().
+     */
+    const Hdf5Flags flags;
+
+    /**
+     * Whether a background thread is used.
+     */
+    bool asynchronous;
+
+    /**
+     * The queue of snapshots. The first element is the one that is
+     * presently written. Elements are only removed once they have been
+     * written.
+     */
+    std::deque<Snapshot> pending_snapshots;
+
+    /**
+     * A mutex guarding the queue and the flag to stop the thread.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * A condition variable that is signalled whenever a snapshot is added
+     * to or removed from the queue.
+     */
+    mutable std::condition_variable queue_changed;
+
+    /**
+     * A flag telling the background thread to finish once the queue is
+     * empty.
+     */
+    bool stop_writing;
+
+    /**
+     * The background thread.
+     */
+    std::thread writer_thread;
+  };
 
   /**
    * DataOutFilter is an intermediate data format that reduces the amount of
@@ -2901,7 +3185,8 @@ public:
    * false, the mesh data will not be written and the solution file will
    * contain only the solution values. If write_mesh_file is true and the
    * filenames are the same, the resulting file will contain both mesh data
-   * and solution values.
+   * and solution values. The layout of the datasets is determined by the
+   * DataOutBase::Hdf5Flags set via set_flags().
    */
   void
   write_hdf5_parallel(const DataOutBase::DataOutFilter &data_filter,
@@ -3123,6 +3408,12 @@ private:
    * dimension. Can be changed by using the <tt>set_flags</tt> function.
    */
   DataOutBase::Deal_II_IntermediateFlags deal_II_intermediate_flags;
+
+  /**
+   * Flags to be used upon output of HDF5 data. Can be changed by using the
+   * <tt>set_flags</tt> function.
+   */
+  DataOutBase::Hdf5Flags hdf5_flags;
 };
 
 
@@ -0,0 +1,211 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_hardware_counters_h
+#define dealii_hardware_counters_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <string>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * A class that reads the hardware performance counters of the processor,
+ * such as the number of cycles, instructions, or cache misses, for the
+ * thread that created the object. The counters are accessed through the
+ * <code>perf_event_open</code> interface of the Linux kernel, i.e., the same
+ * interface used by the <code>perf</code> tool, and only count events in
+ * user space.
+ *
+ * The main use of this class is within the Instrumentation namespace, which
+ * records the counters for each region of code if
+ * Instrumentation::enable_hardware_counters() has been called. The class can
+ * also be used on its own, by reading the counters before and after a piece
+ * of code:
+ * @code
+ *   HardwareCounters counters({HardwareCounters::cycles,
+ *                              HardwareCounters::instructions});
+ *   std::vector<double> start, end;
+ *   counters.read(start);
+ *   ... // code to measure
+ *   counters.read(end);
+ *   std::cout << "IPC: " << (end[1] - start[1]) / (end[0] - start[0])
+ *             << std::endl;
+ * @endcode
+ *
+ * Whether a counter is available depends on the operating system, the
+ * processor, and the permissions of the user: The kernel setting
+ * <code>/proc/sys/kernel/perf_event_paranoid</code> must be at most 2, which
+ * is the default on most systems, and virtual machines often do not expose
+ * the counters of the processor at all. Counters that cannot be opened are
+ * reported by is_available() and read as NaN rather than raising an error,
+ * so that a program can use this class unconditionally. On systems other
+ * than Linux, no counters are available.
+ *
+ * If more counters are requested than the processor can count at the same
+ * time, the kernel multiplexes them, and the values returned by read() are
+ * extrapolated from the fraction of time each counter was active.
+ *
+ * @ingroup utilities
+ */
+class HardwareCounters
+{
+public:
+  /**
+   * The events that can be counted.
+   */
+  enum Event
+  {
+    /**
+     * The number of processor cycles.
+     */
+    cycles,
+    /**
+     * The number of retired instructions.
+     */
+    instructions,
+    /**
+     * The number of accesses to the last level cache.
+     */
+    cache_references,
+    /**
+     * The number of accesses to the last level cache that missed, i.e.,
+     * that went to main memory.
+     */
+    cache_misses,
+    /**
+     * The number of retired branch instructions.
+     */
+    branch_instructions,
+    /**
+     * The number of mispredicted branch instructions.
+     */
+    branch_misses,
+    /**
+     * The number of floating point operations in double precision, counting
+     * each lane of a SIMD instruction and both operations of a fused
+     * multiply-add. This counter is only available on Intel processors of
+     * the Broadwell generation and newer.
+     */
+    double_precision_flops,
+    /**
+     * The number of floating point operations in single precision, counted
+     * as for double_precision_flops.
+     */
+    single_precision_flops
+  };
+
+  /**
+   * Return a short name of the given event, suitable for the heading of a
+   * table.
+   */
+  static std::string
+  get_name(const Event event);
+
+  /**
+   * Constructor. Open the counters for the given events, counting the
+   * events of the calling thread from now on.
+   */
+  explicit HardwareCounters(const std::vector<Event> &events);
+
+  /**
+   * Destructor. Close the counters.
+   */
+  ~HardwareCounters();
+
+  /**
+   * The counters belong to the thread that opened them and can therefore
+   * not be copied.
+   */
+  HardwareCounters(const HardwareCounters &) = delete;
+
+  /**
+   * The counters belong to the thread that opened them and can therefore
+   * not be copied.
+   */
+  HardwareCounters &
+  operator=(const HardwareCounters &) = delete;
+
+  /**
+   * Return the events passed to the constructor.
+   */
+  const std::vector<Event> &
+  get_events() const;
+
+  /**
+   * Return whether the counter for the event with the given index in
+   * get_events() could be opened.
+   */
+  bool
+  is_available(const unsigned int index) const;
+
+  /**
+   * Read the number of events counted since the construction of this
+   * object into @p values, which is resized to the number of events. The
+   * entries for counters that are not available are set to NaN.
+   */
+  void
+  read(std::vector<double> &values) const;
+
+private:
+  /**
+   * The events to count.
+   */
+  const std::vector<Event> events;
+
+  /**
+   * For each event, the file descriptor of the leader of the group of
+   * kernel counters from which the event is computed, or -1 if the event is
+   * not available.
+   */
+  std::vector<int> group_leaders;
+
+  /**
+   * For each event, the file descriptors of all counters of the group, and
+   * the weights with which the values of these counters are summed up.
+   */
+  std::vector<std::vector<std::pair<int, double>>> group_members;
+};
+
+
+
+/* ------------------------ inline functions ------------------------ */
+
+#ifndef DOXYGEN
+
+inline const std::vector<HardwareCounters::Event> &
+HardwareCounters::get_events() const
+{
+  return events;
+}
+
+
+
+inline bool
+HardwareCounters::is_available(const unsigned int index) const
+{
+  AssertIndexRange(index, group_leaders.size());
+  return group_leaders[index] >= 0;
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
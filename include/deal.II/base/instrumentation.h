@@ -0,0 +1,531 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_instrumentation_h
+#define dealii_instrumentation_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/hardware_counters.h>
+#include <deal.II/base/mpi.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+// forward declarations
+#ifndef DOXYGEN
+namespace internal
+{
+  namespace Instrumentation
+  {
+    struct ThreadData;
+  }
+} // namespace internal
+#endif
+
+
+/**
+ * A low-overhead instrumentation layer that records how much time a program
+ * spends in named regions of code. In contrast to TimerOutput, which keeps a
+ * flat list of sections in one object shared by all threads and protected by
+ * a mutex, the functions and classes in this namespace
+ * - record regions hierarchically: a region entered while another one is
+ *   active is recorded as a child of the latter, so that the same region
+ *   called from different places shows up separately;
+ * - accumulate the data of each thread separately and without any locks,
+ *   so that regions can be timed within concurrently running tasks;
+ * - record a histogram of the durations of the individual calls of each
+ *   region;
+ * - aggregate the data over all processes of an MPI communicator and report
+ *   the load imbalance between them;
+ * - can record every single call as an event and export the events in the
+ *   trace event format read by the Chrome browser (chrome://tracing) and by
+ *   Perfetto;
+ * - can read hardware performance counters such as cycles, instructions,
+ *   cache misses, and floating point operations at the beginning and the
+ *   end of each region, see enable_hardware_counters().
+ *
+ * The instrumentation is disabled by default, in which case entering and
+ * leaving a region only costs the check of one atomic flag. This allows the
+ * library to place probes into a few central functions, namely
+ * MatrixFree::loop() and the other loops of the MatrixFree class,
+ * SparseMatrix::vmult(), the vector operations and the ghost exchange of
+ * LinearAlgebra::distributed::Vector, SolverCG::solve(),
+ * DataOut::build_patches(), and
+ * Triangulation::execute_coarsening_and_refinement(), which are then
+ * available in every program that calls enable().
+ *
+ * <h3>Usage</h3>
+ *
+ * A region is identified by an object of type Region, which associates an
+ * index with the name of the region once. It is typically a static local
+ * variable, so that this association is only made the first time the code
+ * is executed. The region is then timed by a Scope object:
+ * @code
+ *   void assemble_system()
+ *   {
+ *     static const Instrumentation::Region region("assemble_system");
+ *     Instrumentation::Scope               scope(region);
+ *
+ *     ...
+ *   }
+ *
+ *   void solve()
+ *   {
+ *     static const Instrumentation::Region region("solve");
+ *     Instrumentation::Scope               scope(region);
+ *
+ *     SolverCG<VectorType> cg(solver_control);
+ *     cg.solve(system_matrix, solution, system_rhs, preconditioner);
+ *   }
+ *
+ *   int main(int argc, char **argv)
+ *   {
+ *     Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv);
+ *     // record statistics and all events for the trace
+ *     Instrumentation::enable(true);
+ *
+ *     ... // run the simulation
+ *
+ *     Instrumentation::print_statistics(std::cout, MPI_COMM_WORLD);
+ *     std::ofstream trace("trace.json");
+ *     Instrumentation::write_chrome_trace(trace, MPI_COMM_WORLD);
+ *   }
+ * @endcode
+ * The output of print_statistics() then looks as follows, where the nesting
+ * of the regions is shown by indentation, the times are the accumulated
+ * times per process with their minimum, average and maximum over all
+ * processes, and the last column is the ratio between the maximal and the
+ * average time, i.e., a measure of the load imbalance:
+ * @code
+ * +-------------------+---------+-----------+-----------+-----------+---------+
+ * | Region            |   calls |  min time |  avg time |  max time | max/avg |
+ * +-------------------+---------+-----------+-----------+-----------+---------+
+ * | assemble_system   |      20 |     3.21s |     3.42s |     3.98s |    1.16 |
+ * | solve             |      20 |     11.4s |     11.4s |     11.5s |       1 |
+ * |   SolverCG::solve |      20 |     11.2s |     11.3s |     11.4s |    1.01 |
+ * +-------------------+---------+-----------+-----------+-----------+---------+
+ * @endcode
+ * followed by the histograms of the call durations.
+ *
+ * <h3>Hardware counters</h3>
+ *
+ * When tuning kernels such as the ones of FEEvaluation, the time alone
+ * often does not explain the performance. After a call of
+ * @code
+ *   Instrumentation::enable_hardware_counters(
+ *     {HardwareCounters::cycles,
+ *      HardwareCounters::instructions,
+ *      HardwareCounters::double_precision_flops});
+ * @endcode
+ * every region additionally records the number of these events, which
+ * print_statistics() lists in a second table together with the number of
+ * instructions per cycle and the rate of floating point operations per
+ * thread. This is the same information one would obtain with the region
+ * markers of tools like LIKWID, without the need to add such markers to the
+ * library. The counters are read through the HardwareCounters class, whose
+ * documentation explains under which circumstances they are available;
+ * unavailable counters are shown as "n/a". Since reading the counters
+ * involves a system call for each event, they add an overhead of the order
+ * of a microsecond to each call of a region.
+ *
+ * The counters only count the events of the thread on which a region was
+ * entered. When MatrixFree::loop() runs on several threads, the work done
+ * by the worker threads is therefore not included in the counters of the
+ * region "MatrixFree::loop", and one should either run with one thread per
+ * MPI process, or place regions into the cell and face functions.
+ *
+ * <h3>Threads</h3>
+ *
+ * Every thread that enters a region for the first time registers a data
+ * structure of its own, into which it subsequently records its regions
+ * without synchronization with other threads. The hierarchy of regions is
+ * also tracked per thread: a region entered within a task running on a
+ * worker thread is a top-level region of that thread, not a child of the
+ * region from which the task was spawned. The functions that collect the
+ * recorded data, i.e., get_statistics(), print_statistics(),
+ * write_chrome_trace(), and reset(), read the data of all threads. They must
+ * therefore only be called while no other thread is within an instrumented
+ * region, for example after all tasks have been joined.
+ *
+ * A Scope object must be destroyed on the thread it was created on, and the
+ * scopes of one thread must end in the reverse order of their creation, as
+ * is automatically the case for objects on the stack.
+ *
+ * @ingroup utilities
+ */
+namespace Instrumentation
+{
+  /**
+   * The clock used for all time measurements.
+   */
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * The number of bins of the histograms of the call durations. Bin 0
+   * contains the calls that took less than one microsecond, bin $b>0$ the
+   * ones that took between $2^{b-1}$ and $2^b$ microseconds, and the last bin
+   * all longer calls.
+   */
+  constexpr unsigned int n_histogram_bins = 24;
+
+  /**
+   * Start recording regions. If @p record_trace is true, every call of a
+   * region is additionally stored as an event that can be exported by
+   * write_chrome_trace(). Note that this needs memory proportional to the
+   * number of calls.
+   *
+   * Calls to this function do not need to match calls of disable(), i.e.,
+   * the function may also be used to switch tracing on or off while
+   * recording is enabled.
+   */
+  void
+  enable(const bool record_trace = false);
+
+  /**
+   * Stop recording regions. Scopes that have been entered while recording
+   * was enabled are still recorded when they end. The data recorded so far
+   * is kept.
+   */
+  void
+  disable();
+
+  /**
+   * Return whether regions are currently being recorded.
+   */
+  bool
+  is_enabled();
+
+  /**
+   * Delete all data recorded so far by all threads. This function must not
+   * be called while any thread is within a recorded region.
+   */
+  void
+  reset();
+
+  /**
+   * Record the given hardware counters for every region, in addition to the
+   * time. An empty vector stops the recording of hardware counters. All
+   * counter values recorded so far are discarded, and this function must
+   * not be called while any thread is within a recorded region. In parallel
+   * computations, all processes must enable the same counters before
+   * calling get_statistics() or print_statistics().
+   */
+  void
+  enable_hardware_counters(
+    const std::vector<HardwareCounters::Event> &events);
+
+  /**
+   * Return the hardware counters passed to the last call of
+   * enable_hardware_counters().
+   */
+  std::vector<HardwareCounters::Event>
+  get_hardware_counter_events();
+
+
+
+  /**
+   * A named region of code. The constructor registers the name and
+   * associates a unique index with it, which is all a Scope needs to
+   * identify the region. Since this registration is protected by a mutex,
+   * objects of this class should be created once, typically as static local
+   * variables, and then be reused. Several objects with the same name
+   * identify the same region.
+   */
+  class Region
+  {
+  public:
+    /**
+     * Constructor.
+     */
+    explicit Region(const std::string &name);
+
+    /**
+     * Return the index associated with the name of the region.
+     */
+    unsigned int
+    index() const;
+
+    /**
+     * Return the name of the region.
+     */
+    const std::string &
+    name() const;
+
+  private:
+    /**
+     * The name of the region.
+     */
+    const std::string region_name;
+
+    /**
+     * The index associated with the name.
+     */
+    const unsigned int region_index;
+  };
+
+
+
+  /**
+   * A scope-based object that records the time between its construction and
+   * its destruction, or the call to stop(), as one call of the given region.
+   * If recording is not enabled at the time of the construction, the object
+   * does nothing.
+   */
+  class Scope
+  {
+  public:
+    /**
+     * Constructor. Enter the given region.
+     */
+    explicit Scope(const Region &region);
+
+    /**
+     * Destructor. Calls stop().
+     */
+    ~Scope();
+
+    /**
+     * Leave the region before the destructor is executed. Subsequent calls
+     * have no effect.
+     */
+    void
+    stop();
+
+  private:
+    /**
+     * The data of the thread this scope was created on, or a null pointer
+     * if the scope is not recorded.
+     */
+    internal::Instrumentation::ThreadData *thread_data;
+
+    /**
+     * The node in the hierarchy of regions of the thread that was active
+     * when this scope was entered.
+     */
+    unsigned int parent_node;
+
+    /**
+     * The time at which the scope was entered.
+     */
+    Clock::time_point start_time;
+  };
+
+
+
+  /**
+   * The statistics of one region at one position in the hierarchy of
+   * regions, accumulated over all threads and all processes.
+   */
+  struct RegionStatistics
+  {
+    /**
+     * The names of the region and of all enclosing regions, starting with
+     * the outermost one.
+     */
+    std::vector<std::string> path;
+
+    /**
+     * The total number of calls on all threads and processes.
+     */
+    unsigned long long int n_calls;
+
+    /**
+     * The minimum, average, and maximum over all processes of the time
+     * spent in the region on each process, summed over the threads of a
+     * process. Processes that never entered the region contribute a time of
+     * zero.
+     */
+    Utilities::MPI::MinMaxAvg total_time;
+
+    /**
+     * The duration of the shortest call on any thread and process.
+     */
+    double min_call_time;
+
+    /**
+     * The duration of the longest call on any thread and process.
+     */
+    double max_call_time;
+
+    /**
+     * The histogram of the call durations, see n_histogram_bins for the
+     * definition of the bins.
+     */
+    std::array<unsigned long long int, n_histogram_bins> histogram;
+
+    /**
+     * The values of the hardware counters, summed over all calls on all
+     * threads and processes, in the order of get_hardware_counter_events().
+     * The values of counters that are not available on some thread are
+     * NaN.
+     */
+    std::vector<double> hardware_counters;
+
+    /**
+     * Return the ratio between the maximal and the average time over all
+     * processes, which is one if the work is perfectly balanced.
+     */
+    double
+    imbalance() const;
+  };
+
+
+
+  /**
+   * Collect the statistics of all regions recorded by all threads of all
+   * processes in the given communicator. The entries are sorted such that
+   * each region directly precedes the regions nested in it, and regions
+   * with the same parent are sorted by their names.
+   *
+   * This function is collective over @p mpi_communicator and all processes
+   * obtain the same result.
+   */
+  std::vector<RegionStatistics>
+  get_statistics(const MPI_Comm &mpi_communicator);
+
+  /**
+   * Print the statistics of all regions as collected by get_statistics()
+   * in form of a table, followed by the non-empty bins of the histograms of
+   * the call durations.
+   *
+   * This function is collective over @p mpi_communicator, but only the
+   * process with rank zero writes to @p out.
+   */
+  void
+  print_statistics(std::ostream &out, const MPI_Comm &mpi_communicator);
+
+  /**
+   * Write all events recorded since tracing was enabled in the JSON trace
+   * event format that can be loaded into chrome://tracing or Perfetto. Each
+   * MPI process is shown as a separate process, and each thread that
+   * recorded events as a separate thread within it. The time stamps are
+   * given relative to the first call of enable() on each process and are
+   * therefore not synchronized between processes.
+   *
+   * This function is collective over @p mpi_communicator, but only the
+   * process with rank zero writes to @p out.
+   */
+  void
+  write_chrome_trace(std::ostream &out, const MPI_Comm &mpi_communicator);
+} // namespace Instrumentation
+
+
+
+/* ------------------------ inline functions ------------------------ */
+
+#ifndef DOXYGEN
+
+namespace internal
+{
+  namespace Instrumentation
+  {
+    /**
+     * Whether regions are currently being recorded.
+     */
+    extern std::atomic<bool> enabled;
+
+    /**
+     * Enter the region with the given index on the current thread. Return
+     * the data of the thread, and set @p parent_node to the node that was
+     * active before.
+     */
+    ThreadData *
+    enter_region(const unsigned int region_index, unsigned int &parent_node);
+
+    /**
+     * Leave the current region of the given thread, which was entered at
+     * @p start_time, and make @p parent_node active again.
+     */
+    void
+    leave_region(ThreadData &                                 thread_data,
+                 const unsigned int                           parent_node,
+                 const dealii::Instrumentation::Clock::time_point start_time);
+  } // namespace Instrumentation
+} // namespace internal
+
+
+
+namespace Instrumentation
+{
+  inline bool
+  is_enabled()
+  {
+    return internal::Instrumentation::enabled.load(std::memory_order_relaxed);
+  }
+
+
+
+  inline unsigned int
+  Region::index() const
+  {
+    return region_index;
+  }
+
+
+
+  inline const std::string &
+  Region::name() const
+  {
+    return region_name;
+  }
+
+
+
+  inline Scope::Scope(const Region &region)
+    : thread_data(nullptr)
+    , parent_node(0)
+  {
+    if (is_enabled())
+      {
+        thread_data =
+          internal::Instrumentation::enter_region(region.index(), parent_node);
+        start_time = Clock::now();
+      }
+  }
+
+
+
+  inline Scope::~Scope()
+  {
+    stop();
+  }
+
+
+
+  inline void
+  Scope::stop()
+  {
+    if (thread_data != nullptr)
+      {
+        internal::Instrumentation::leave_region(*thread_data,
+                                                parent_node,
+                                                start_time);
+        thread_data = nullptr;
+      }
+  }
+} // namespace Instrumentation
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -22,6 +22,7 @@
 #include <deal.II/base/cuda.h>
 #include <deal.II/base/exceptions.h>
 
+#include <functional>
 #include <memory>
 
 DEAL_II_NAMESPACE_OPEN
@@ -82,9 +83,11 @@ namespace MemorySpace
     }
 
     /**
-     * Pointer to data on the host.
+     * Pointer to data on the host. The deleter is usually std::free(), but
+     * might also release memory obtained differently, e.g., from an MPI
+     * shared-memory window.
      */
-    std::unique_ptr<Number[], decltype(&std::free)> values;
+    std::unique_ptr<Number[], std::function<void(Number *)>> values;
 
     /**
      * Pointer to data on the device.
@@ -128,7 +131,7 @@ namespace MemorySpace
       std::copy(begin, begin + n_elements, values.get());
     }
 
-    std::unique_ptr<Number[], decltype(&std::free)> values;
+    std::unique_ptr<Number[], std::function<void(Number *)>> values;
 
     // This is not used but it allows to simplify the code until we start using
     // CUDA-aware MPI.
@@ -534,6 +534,38 @@ namespace Utilities
         const MPI_Comm &          mpi_communicator,
         const ArrayView<T> &      sums);
 
+    /**
+     * Like the previous function, but only start the reduction through the
+     * non-blocking <code>MPI_Iallreduce</code> function and return
+     * immediately. The result is available in @p sums only after wait() has
+     * been called on the @p request returned by this function, and neither
+     * @p values nor @p sums must be touched before. In the meantime, the
+     * calling process can do work that does not depend on the result, such
+     * as a matrix-vector product, which hides the latency of the reduction.
+     * Like all collective operations, the reductions must be started in the
+     * same order on all processes of the communicator.
+     *
+     * Input and output arrays may be the same.
+     *
+     * If deal.II is not configured for use of MPI, or the MPI library does
+     * not support the MPI-3 standard, the reduction is done in this function
+     * and @p request is set to <code>MPI_REQUEST_NULL</code>.
+     */
+    template <typename T>
+    void
+    isum(const ArrayView<const T> &values,
+         const MPI_Comm &          mpi_communicator,
+         const ArrayView<T> &      sums,
+         MPI_Request &             request);
+
+    /**
+     * Wait for the completion of a non-blocking operation such as isum(),
+     * and set @p request to <code>MPI_REQUEST_NULL</code>. Nothing is done
+     * if @p request already is <code>MPI_REQUEST_NULL</code>.
+     */
+    void
+    wait(MPI_Request &request);
+
     /**
      * Perform an MPI sum of the entries of a symmetric tensor.
      *
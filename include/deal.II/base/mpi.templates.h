@@ -269,6 +269,39 @@ namespace Utilities
 
 
 
+    template <typename T>
+    void
+    isum(const ArrayView<const T> &values,
+         const MPI_Comm &          mpi_communicator,
+         const ArrayView<T> &      sums,
+         MPI_Request &             request)
+    {
+      AssertDimension(values.size(), sums.size());
+#ifdef DEAL_II_WITH_MPI
+#  if DEAL_II_MPI_VERSION_GTE(3, 0)
+      if (job_supports_mpi())
+        {
+          const int ierr =
+            MPI_Iallreduce(values != sums ?
+                             DEAL_II_MPI_CONST_CAST(values.data()) :
+                             MPI_IN_PLACE,
+                           static_cast<void *>(sums.data()),
+                           static_cast<int>(values.size()),
+                           internal::mpi_type_id(values.data()),
+                           MPI_SUM,
+                           mpi_communicator,
+                           &request);
+          AssertThrowMPI(ierr);
+          return;
+        }
+#  endif
+#endif
+      internal::all_reduce(MPI_SUM, values, mpi_communicator, sums);
+      request = MPI_REQUEST_NULL;
+    }
+
+
+
     template <int rank, int dim, typename Number>
     Tensor<rank, dim, Number>
     sum(const Tensor<rank, dim, Number> &local,
@@ -0,0 +1,569 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mpi_remote_point_evaluation_h
+#define dealii_mpi_remote_point_evaluation_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/mpi_tags.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/fe/mapping.h>
+
+#include <deal.II/grid/grid_tools_cache.h>
+#include <deal.II/grid/tria.h>
+
+#include <boost/signals2/connection.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Utilities
+{
+  namespace MPI
+  {
+    /**
+     * Helper class to access values on non-matching grids, i.e., at arbitrary
+     * points in real space that might be owned by other processes of a
+     * parallel::TriangulationBase.
+     *
+     * The class is set up by a call to reinit() with a list of points and a
+     * GridTools::Cache. During this collective call, the processes that might
+     * own the points are identified with the help of the bounding boxes
+     * stored in GridTools::Cache::get_covering_rtree(), and the points are
+     * sent to these processes via the consensus algorithms of
+     * Utilities::MPI::ConsensusAlgorithms. There, all locally owned cells
+     * around the points are searched and the reference coordinates of the
+     * points within these cells are computed. The result of this search is
+     * kept as a communication pattern, i.e., the lists of ranks to exchange
+     * data with, the number of values exchanged with each of them, and the
+     * permutations between the order of the values in the messages and the
+     * order of the points in the calling process and of the cells in the
+     * evaluating processes, respectively.
+     *
+     * The data can then be accessed repeatedly with evaluate_and_process()
+     * (the values are computed on the cells owning the points and sent to
+     * the processes that requested the points) and process_and_evaluate()
+     * (the values are given at the points and sent to the processes owning
+     * the surrounding cells), each of which only performs a single
+     * non-blocking point-to-point exchange. This is useful for applications
+     * that query the same points many times, e.g., the interface points in
+     * fluid-structure interaction, where a search in each time step would be
+     * prohibitively expensive.
+     *
+     * A point might be found on several cells, e.g., if it is located on a
+     * face or on a vertex of the mesh, possibly owned by different
+     * processes. In this case, all values are returned and the offsets into
+     * the result arrays are given by get_point_ptrs(). A point that is not
+     * found on any cell does not get any value.
+     *
+     * @note The search is done on the triangulation and mapping passed to
+     *   reinit() via the GridTools::Cache object. If the triangulation
+     *   changes, e.g., due to refinement, the communication pattern becomes
+     *   invalid and reinit() needs to be called again, which can be checked
+     *   by is_ready().
+     */
+    template <int dim, int spacedim = dim>
+    class RemotePointEvaluation
+    {
+    public:
+      /**
+       * Constructor.
+       *
+       * @param tolerance Tolerance in terms of unit cell coordinates for
+       *   determining all cells around a point passed to the class during
+       *   reinit(). Depending on the problem, it might be necessary to adjust
+       *   the tolerance in order to be able to identify a cell.
+       */
+      RemotePointEvaluation(const double tolerance = 1e-6);
+
+      /**
+       * Destructor.
+       */
+      ~RemotePointEvaluation();
+
+      /**
+       * Set up the internal data structures and the communication pattern
+       * based on a list of points @p points and the triangulation and mapping
+       * described by @p cache.
+       *
+       * @note This is a collective call that needs to be executed by all
+       *   processors of the communicator of the triangulation.
+       */
+      void
+      reinit(const std::vector<Point<spacedim>> &  points,
+             const GridTools::Cache<dim, spacedim> &cache);
+
+      /**
+       * Data of points positioned in a cell.
+       */
+      struct CellData
+      {
+        /**
+         * Level and index of the cells.
+         */
+        std::vector<std::pair<int, int>> cells;
+
+        /**
+         * Pointers to the beginning and the end of the (reference) points
+         * associated to the cell, i.e., the points of the cell with index
+         * `i` are the entries `reference_point_ptrs[i]` to
+         * `reference_point_ptrs[i+1]-1` of reference_point_values.
+         */
+        std::vector<unsigned int> reference_point_ptrs;
+
+        /**
+         * Reference points in the interval [0,1]^dim.
+         */
+        std::vector<Point<dim>> reference_point_values;
+      };
+
+      /**
+       * Evaluate function @p evaluation_function in the given points and
+       * triangulation. The results are stored in @p output, with the values
+       * of the point with index `i` given by the entries `get_point_ptrs()[i]`
+       * to `get_point_ptrs()[i+1]-1`.
+       *
+       * The function @p evaluation_function is called once with the data of
+       * all cells of the current process that contain points, see CellData,
+       * and is expected to write the values of these points in the order
+       * of CellData::reference_point_values into the array view passed as
+       * first argument.
+       *
+       * @note The vector @p buffer is used as temporary storage for the
+       *   evaluated values and the communication. It is passed in by the
+       *   user to avoid reallocations in repeated calls.
+       *
+       * @note This is a collective call that needs to be executed by all
+       *   processors in the communicator.
+       */
+      template <typename T>
+      void
+      evaluate_and_process(
+        std::vector<T> &output,
+        std::vector<T> &buffer,
+        const std::function<void(const ArrayView<T> &, const CellData &)>
+          &evaluation_function) const;
+
+      /**
+       * This method is the inverse of the method evaluate_and_process(). It
+       * makes the data at the points, provided by @p input, available in the
+       * function @p evaluation_function, where it can be processed on the
+       * cells, e.g., to integrate the values against test functions. The
+       * layout of @p input is the same as the layout of the output of
+       * evaluate_and_process(), i.e., a value has to be given for each time a
+       * point has been found, see get_point_ptrs().
+       *
+       * @note This is a collective call that needs to be executed by all
+       *   processors in the communicator.
+       */
+      template <typename T>
+      void
+      process_and_evaluate(
+        const std::vector<T> &input,
+        std::vector<T> &      buffer,
+        const std::function<void(const ArrayView<const T> &, const CellData &)>
+          &evaluation_function) const;
+
+      /**
+       * Return a CRS-like data structure to determine the position of the
+       * result corresponding to a point and the number of cells it has been
+       * found on.
+       */
+      const std::vector<unsigned int> &
+      get_point_ptrs() const;
+
+      /**
+       * Return if all points passed to reinit() have been found on exactly one
+       * cell, i.e., if the map from points to cells is unique.
+       */
+      bool
+      is_map_unique() const;
+
+      /**
+       * Return the Triangulation object used during reinit().
+       */
+      const Triangulation<dim, spacedim> &
+      get_triangulation() const;
+
+      /**
+       * Return the Mapping object used during reinit().
+       */
+      const Mapping<dim, spacedim> &
+      get_mapping() const;
+
+      /**
+       * Return if the internal data structures have been set up and if
+       * the triangulation has not been modified since the last call to
+       * reinit().
+       */
+      bool
+      is_ready() const;
+
+    private:
+      /**
+       * Tolerance to be used when searching the cells around the points.
+       */
+      const double tolerance;
+
+      /**
+       * Storage for the status of the triangulation signal.
+       */
+      boost::signals2::connection tria_signal;
+
+      /**
+       * Flag indicating if the reinit() function has been called and if yes
+       * the triangulation has not been modified since then.
+       */
+      bool ready_flag;
+
+      /**
+       * Reference to the Triangulation object used during reinit().
+       */
+      SmartPointer<const Triangulation<dim, spacedim>> tria;
+
+      /**
+       * Reference to the Mapping object used during reinit().
+       */
+      SmartPointer<const Mapping<dim, spacedim>> mapping;
+
+      /**
+       * The MPI communicator of the triangulation, or MPI_COMM_SELF for
+       * serial triangulations.
+       */
+      MPI_Comm communicator;
+
+      /**
+       * (One-to-one) relation of points and cells.
+       */
+      bool unique_mapping;
+
+      /**
+       * Since for each point multiple or no results can be available, the
+       * pointers in this vector indicate the first and last entry associated
+       * with a point in a CRS-like fashion.
+       */
+      std::vector<unsigned int> point_ptrs;
+
+      /**
+       * Permutation index within a receive buffer: the value at position `i`
+       * of the buffer, concatenated over all ranks in recv_ranks, is placed
+       * at position `recv_permutation[i]` of the output.
+       */
+      std::vector<unsigned int> recv_permutation;
+
+      /**
+       * Pointers of the data within the receive buffer, one range per rank
+       * in recv_ranks.
+       */
+      std::vector<unsigned int> recv_ptrs;
+
+      /**
+       * Ranks from which data is received, in ascending order.
+       */
+      std::vector<unsigned int> recv_ranks;
+
+      /**
+       * Point data sorted according to cells so that evaluation (incl.
+       * reading of degrees of freedoms) needs to be performed only once per
+       * cell.
+       */
+      CellData cell_data;
+
+      /**
+       * Permutation index within a send buffer: the value at position `i` in
+       * the order of cell_data is placed at position `send_permutation[i]`
+       * of the send buffer, concatenated over all ranks in send_ranks.
+       */
+      std::vector<unsigned int> send_permutation;
+
+      /**
+       * Ranks to send to, in ascending order.
+       */
+      std::vector<unsigned int> send_ranks;
+
+      /**
+       * Pointers of the data within the send buffer, one range per rank in
+       * send_ranks.
+       */
+      std::vector<unsigned int> send_ptrs;
+    };
+
+
+
+    template <int dim, int spacedim>
+    template <typename T>
+    void
+    RemotePointEvaluation<dim, spacedim>::evaluate_and_process(
+      std::vector<T> &output,
+      std::vector<T> &buffer,
+      const std::function<void(const ArrayView<T> &, const CellData &)>
+        &evaluation_function) const
+    {
+      Assert(is_ready(),
+             ExcMessage("RemotePointEvaluation::reinit() has not been called "
+                        "or the triangulation has been modified since then."));
+
+      const unsigned int n_send = send_permutation.size();
+      const unsigned int n_recv = recv_permutation.size();
+
+      output.resize(point_ptrs.back());
+      buffer.resize(2 * n_send + n_recv);
+
+      // evaluate the function on the cells of this process, with the values
+      // in the order of the cells
+      const ArrayView<T> buffer_eval(buffer.data(), n_send);
+      evaluation_function(buffer_eval, cell_data);
+
+      // sort the values according to the ranks they are sent to
+      const ArrayView<T> buffer_send(buffer.data() + n_send, n_send);
+      for (unsigned int i = 0; i < n_send; ++i)
+        buffer_send[send_permutation[i]] = buffer_eval[i];
+
+      const ArrayView<T> buffer_recv(buffer.data() + 2 * n_send, n_recv);
+
+      const unsigned int my_rank = this_mpi_process(communicator);
+
+#ifdef DEAL_II_WITH_MPI
+      std::vector<std::vector<char>> send_buffers_packed(send_ranks.size());
+      std::vector<MPI_Request>       send_requests;
+      send_requests.reserve(send_ranks.size());
+#endif
+
+      for (unsigned int i = 0; i < send_ranks.size(); ++i)
+        {
+          if (send_ranks[i] == my_rank)
+            {
+              // copy the data of this process directly into the receive
+              // buffer
+              const auto ptr = std::find(recv_ranks.begin(),
+                                         recv_ranks.end(),
+                                         my_rank);
+              Assert(ptr != recv_ranks.end(), ExcInternalError());
+              const unsigned int j = std::distance(recv_ranks.begin(), ptr);
+              Assert(recv_ptrs[j + 1] - recv_ptrs[j] ==
+                       send_ptrs[i + 1] - send_ptrs[i],
+                     ExcInternalError());
+              std::copy(buffer_send.begin() + send_ptrs[i],
+                        buffer_send.begin() + send_ptrs[i + 1],
+                        buffer_recv.begin() + recv_ptrs[j]);
+              continue;
+            }
+
+#ifdef DEAL_II_WITH_MPI
+          send_buffers_packed[i] = Utilities::pack(
+            std::vector<T>(buffer_send.begin() + send_ptrs[i],
+                           buffer_send.begin() + send_ptrs[i + 1]),
+            false);
+
+          send_requests.emplace_back(MPI_Request());
+          const int ierr = MPI_Isend(send_buffers_packed[i].data(),
+                                     send_buffers_packed[i].size(),
+                                     MPI_CHAR,
+                                     send_ranks[i],
+                                     internal::Tags::remote_point_evaluation,
+                                     communicator,
+                                     &send_requests.back());
+          AssertThrowMPI(ierr);
+#endif
+        }
+
+#ifdef DEAL_II_WITH_MPI
+      for (unsigned int i = 0; i < recv_ranks.size(); ++i)
+        {
+          if (recv_ranks[i] == my_rank)
+            continue;
+
+          MPI_Status status;
+          int        ierr = MPI_Probe(recv_ranks[i],
+                               internal::Tags::remote_point_evaluation,
+                               communicator,
+                               &status);
+          AssertThrowMPI(ierr);
+
+          int message_length;
+          ierr = MPI_Get_count(&status, MPI_CHAR, &message_length);
+          AssertThrowMPI(ierr);
+
+          std::vector<char> recv_buffer_packed(message_length);
+          ierr = MPI_Recv(recv_buffer_packed.data(),
+                          message_length,
+                          MPI_CHAR,
+                          recv_ranks[i],
+                          internal::Tags::remote_point_evaluation,
+                          communicator,
+                          MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+
+          const auto recv_values =
+            Utilities::unpack<std::vector<T>>(recv_buffer_packed, false);
+          AssertDimension(recv_values.size(), recv_ptrs[i + 1] - recv_ptrs[i]);
+          std::copy(recv_values.begin(),
+                    recv_values.end(),
+                    buffer_recv.begin() + recv_ptrs[i]);
+        }
+
+      const int ierr = MPI_Waitall(send_requests.size(),
+                                   send_requests.data(),
+                                   MPI_STATUSES_IGNORE);
+      AssertThrowMPI(ierr);
+#endif
+
+      // sort the received values according to the points
+      for (unsigned int i = 0; i < n_recv; ++i)
+        output[recv_permutation[i]] = buffer_recv[i];
+    }
+
+
+
+    template <int dim, int spacedim>
+    template <typename T>
+    void
+    RemotePointEvaluation<dim, spacedim>::process_and_evaluate(
+      const std::vector<T> &input,
+      std::vector<T> &      buffer,
+      const std::function<void(const ArrayView<const T> &, const CellData &)>
+        &evaluation_function) const
+    {
+      Assert(is_ready(),
+             ExcMessage("RemotePointEvaluation::reinit() has not been called "
+                        "or the triangulation has been modified since then."));
+      AssertDimension(input.size(), point_ptrs.back());
+
+      const unsigned int n_send = send_permutation.size();
+      const unsigned int n_recv = recv_permutation.size();
+
+      buffer.resize(2 * n_send + n_recv);
+
+      // the roles of the buffers are swapped compared to
+      // evaluate_and_process(): the values at the points are sent back along
+      // the receive pattern and received along the send pattern
+      const ArrayView<T> buffer_recv(buffer.data() + 2 * n_send, n_recv);
+      for (unsigned int i = 0; i < n_recv; ++i)
+        buffer_recv[i] = input[recv_permutation[i]];
+
+      const ArrayView<T> buffer_send(buffer.data() + n_send, n_send);
+
+      const unsigned int my_rank = this_mpi_process(communicator);
+
+#ifdef DEAL_II_WITH_MPI
+      std::vector<std::vector<char>> send_buffers_packed(recv_ranks.size());
+      std::vector<MPI_Request>       send_requests;
+      send_requests.reserve(recv_ranks.size());
+#endif
+
+      for (unsigned int i = 0; i < recv_ranks.size(); ++i)
+        {
+          if (recv_ranks[i] == my_rank)
+            {
+              const auto ptr = std::find(send_ranks.begin(),
+                                         send_ranks.end(),
+                                         my_rank);
+              Assert(ptr != send_ranks.end(), ExcInternalError());
+              const unsigned int j = std::distance(send_ranks.begin(), ptr);
+              Assert(send_ptrs[j + 1] - send_ptrs[j] ==
+                       recv_ptrs[i + 1] - recv_ptrs[i],
+                     ExcInternalError());
+              std::copy(buffer_recv.begin() + recv_ptrs[i],
+                        buffer_recv.begin() + recv_ptrs[i + 1],
+                        buffer_send.begin() + send_ptrs[j]);
+              continue;
+            }
+
+#ifdef DEAL_II_WITH_MPI
+          send_buffers_packed[i] = Utilities::pack(
+            std::vector<T>(buffer_recv.begin() + recv_ptrs[i],
+                           buffer_recv.begin() + recv_ptrs[i + 1]),
+            false);
+
+          send_requests.emplace_back(MPI_Request());
+          const int ierr = MPI_Isend(send_buffers_packed[i].data(),
+                                     send_buffers_packed[i].size(),
+                                     MPI_CHAR,
+                                     recv_ranks[i],
+                                     internal::Tags::remote_point_evaluation,
+                                     communicator,
+                                     &send_requests.back());
+          AssertThrowMPI(ierr);
+#endif
+        }
+
+#ifdef DEAL_II_WITH_MPI
+      for (unsigned int i = 0; i < send_ranks.size(); ++i)
+        {
+          if (send_ranks[i] == my_rank)
+            continue;
+
+          MPI_Status status;
+          int        ierr = MPI_Probe(send_ranks[i],
+                               internal::Tags::remote_point_evaluation,
+                               communicator,
+                               &status);
+          AssertThrowMPI(ierr);
+
+          int message_length;
+          ierr = MPI_Get_count(&status, MPI_CHAR, &message_length);
+          AssertThrowMPI(ierr);
+
+          std::vector<char> recv_buffer_packed(message_length);
+          ierr = MPI_Recv(recv_buffer_packed.data(),
+                          message_length,
+                          MPI_CHAR,
+                          send_ranks[i],
+                          internal::Tags::remote_point_evaluation,
+                          communicator,
+                          MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+
+          const auto recv_values =
+            Utilities::unpack<std::vector<T>>(recv_buffer_packed, false);
+          AssertDimension(recv_values.size(), send_ptrs[i + 1] - send_ptrs[i]);
+          std::copy(recv_values.begin(),
+                    recv_values.end(),
+                    buffer_send.begin() + send_ptrs[i]);
+        }
+
+      const int ierr = MPI_Waitall(send_requests.size(),
+                                   send_requests.data(),
+                                   MPI_STATUSES_IGNORE);
+      AssertThrowMPI(ierr);
+#endif
+
+      // sort the values according to the cells and evaluate
+      const ArrayView<T> buffer_eval(buffer.data(), n_send);
+      for (unsigned int i = 0; i < n_send; ++i)
+        buffer_eval[i] = buffer_send[send_permutation[i]];
+
+      evaluation_function(ArrayView<const T>(buffer_eval.data(), n_send),
+                          cell_data);
+    }
+
+  } // end of namespace MPI
+} // end of namespace Utilities
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -135,6 +135,10 @@ namespace Utilities
           // Utilities::MPI::compute_union
           compute_union,
 
+          /// RemotePointEvaluation::evaluate_and_process() and
+          /// RemotePointEvaluation::process_and_evaluate()
+          remote_point_evaluation,
+
         };
       } // namespace Tags
     }   // namespace internal
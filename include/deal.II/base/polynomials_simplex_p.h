@@ -0,0 +1,217 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_polynomials_simplex_p_h
+#define dealii_polynomials_simplex_p_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/polynomial_space.h>
+#include <deal.II/base/scalar_polynomials_base.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/tensor.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+/**
+ * @addtogroup Polynomials
+ * @{
+ */
+
+/**
+ * The Lagrange basis of the space $P_k$ of polynomials of total degree at
+ * most $k$ on the reference simplex, i.e., the interval $[0,1]$ in 1d, the
+ * triangle with vertices $(0,0)$, $(1,0)$, $(0,1)$ in 2d, and the
+ * tetrahedron with vertices $(0,0,0)$, $(1,0,0)$, $(0,1,0)$, $(0,0,1)$ in
+ * 3d. The support points are the points of the equispaced lattice
+ * $\{\alpha/k: |\alpha|\leq k\}$ on the simplex, and the basis function with
+ * index $i$ is one in the support point with index $i$ and zero in all other
+ * support points, see get_support_points(). These are the shape functions
+ * of the standard continuous $P_k$ element on triangles and tetrahedra.
+ *
+ * The support points are numbered with the vertices of the simplex first
+ * (in the order given above), followed by all other lattice points in
+ * lexicographic order with the first coordinate running fastest. For degree
+ * zero, the only support point is the barycenter of the simplex.
+ *
+ * The basis is computed by expressing the Lagrange polynomials in terms of
+ * the monomials of PolynomialSpace with the inverse of the Vandermonde
+ * matrix in the support points. This is numerically stable for the
+ * moderate degrees typically used on simplices.
+ */
+template <int dim>
+class PolynomialsSimplexP : public ScalarPolynomialsBase<dim>
+{
+public:
+  /**
+   * Access to the dimension of this object, for checking and automatic
+   * setting of dimension in other classes.
+   */
+  static const unsigned int dimension = dim;
+
+  /**
+   * Constructor. Creates all Lagrange polynomials of total degree at most
+   * @p degree on the reference simplex.
+   */
+  explicit PolynomialsSimplexP(const unsigned int degree);
+
+  /**
+   * Compute the value and the first and second derivatives of each
+   * polynomial at <tt>unit_point</tt>.
+   *
+   * The size of the vectors must either be equal 0 or equal n(). In the
+   * first case, the function will not compute these values, i.e. you
+   * indicate what you want to have computed by resizing those vectors which
+   * you want filled.
+   */
+  void
+  evaluate(const Point<dim> &           unit_point,
+           std::vector<double> &        values,
+           std::vector<Tensor<1, dim>> &grads,
+           std::vector<Tensor<2, dim>> &grad_grads,
+           std::vector<Tensor<3, dim>> &third_derivatives,
+           std::vector<Tensor<4, dim>> &fourth_derivatives) const override;
+
+  /**
+   * Compute the value of the <tt>i</tt>th polynomial at unit point
+   * <tt>p</tt>.
+   */
+  double
+  compute_value(const unsigned int i, const Point<dim> &p) const override;
+
+  /**
+   * @copydoc ScalarPolynomialsBase::compute_1st_derivative()
+   */
+  Tensor<1, dim>
+  compute_1st_derivative(const unsigned int i,
+                         const Point<dim> & p) const override;
+
+  /**
+   * @copydoc ScalarPolynomialsBase::compute_2nd_derivative()
+   */
+  Tensor<2, dim>
+  compute_2nd_derivative(const unsigned int i,
+                         const Point<dim> & p) const override;
+
+  /**
+   * @copydoc ScalarPolynomialsBase::compute_3rd_derivative()
+   */
+  Tensor<3, dim>
+  compute_3rd_derivative(const unsigned int i,
+                         const Point<dim> & p) const override;
+
+  /**
+   * @copydoc ScalarPolynomialsBase::compute_4th_derivative()
+   */
+  Tensor<4, dim>
+  compute_4th_derivative(const unsigned int i,
+                         const Point<dim> & p) const override;
+
+  /**
+   * Compute the gradient of the <tt>i</tt>th polynomial at unit point
+   * <tt>p</tt>.
+   */
+  Tensor<1, dim>
+  compute_grad(const unsigned int i, const Point<dim> &p) const override;
+
+  /**
+   * Compute the second derivative (grad_grad) of the <tt>i</tt>th
+   * polynomial at unit point <tt>p</tt>.
+   */
+  Tensor<2, dim>
+  compute_grad_grad(const unsigned int i, const Point<dim> &p) const override;
+
+  /**
+   * Return the support points of the Lagrange polynomials on the reference
+   * simplex.
+   */
+  const std::vector<Point<dim>> &
+  get_support_points() const;
+
+  /**
+   * Return the name of the space, which is <tt>PolynomialsSimplexP</tt>.
+   */
+  std::string
+  name() const override;
+
+  /**
+   * @copydoc ScalarPolynomialsBase::clone()
+   */
+  std::unique_ptr<ScalarPolynomialsBase<dim>>
+  clone() const override;
+
+  /**
+   * Return an estimate (in bytes) for the memory consumption of this
+   * object.
+   */
+  std::size_t
+  memory_consumption() const override;
+
+private:
+  /**
+   * Compute the derivative of order @p order of the <tt>i</tt>th
+   * polynomial as a linear combination of the derivatives of the monomials.
+   */
+  template <int order>
+  Tensor<order, dim>
+  compute_lagrange_derivative(const unsigned int i, const Point<dim> &p) const;
+
+  /**
+   * The monomials of total degree at most the degree of this space.
+   */
+  const PolynomialSpace<dim> monomials;
+
+  /**
+   * The support points of the Lagrange polynomials.
+   */
+  std::vector<Point<dim>> support_points;
+
+  /**
+   * The coefficients of the Lagrange polynomials in terms of the monomials,
+   * i.e., the Lagrange polynomial with index <tt>i</tt> is the sum over
+   * <tt>coefficients(i,j)</tt> times the monomial with index <tt>j</tt>.
+   */
+  Table<2, double> coefficients;
+};
+
+/** @} */
+
+
+
+template <int dim>
+inline const std::vector<Point<dim>> &
+PolynomialsSimplexP<dim>::get_support_points() const
+{
+  return support_points;
+}
+
+
+
+template <int dim>
+inline std::string
+PolynomialsSimplexP<dim>::name() const
+{
+  return "PolynomialsSimplexP";
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -779,6 +779,42 @@ public:
   QSplit(const QSimplex<dim> &base, const Point<dim> &split_point);
 };
 
+
+/**
+ * A Gauss-type quadrature formula on the reference simplex, i.e., the
+ * interval $[0,1]$ in 1d, the triangle with vertices $(0,0)$, $(1,0)$,
+ * $(0,1)$ in 2d, and the tetrahedron with vertices $(0,0,0)$, $(1,0,0)$,
+ * $(0,1,0)$, $(0,0,1)$ in 3d.
+ *
+ * The formula is constructed as a conical product (also known as Stroud's
+ * collapsed-coordinate rule): the reference simplex is obtained from the
+ * unit hypercube by collapsing the hypercube along the coordinate
+ * directions, e.g. $x = \xi_0 (1-\xi_1)$, $y = \xi_1$ in 2d, whose Jacobian
+ * determinant $(1-\xi_1)$ is a polynomial weight in the collapsed
+ * directions. In each direction, the @p n_points_1D points are chosen as
+ * the roots of the Jacobi polynomial that is orthogonal with respect to
+ * this weight, so that the formula with $n^{dim}$ points integrates
+ * polynomials of total degree $2n-1$ exactly, the same degree as the
+ * tensor-product QGauss formula on hypercubes with the same number of
+ * points per direction.
+ *
+ * All points are located in the interior of the simplex, and all weights
+ * are positive and sum up to the volume of the reference simplex, $1/dim!$.
+ * In contrast to fully symmetric formulas, the points are not invariant
+ * under the symmetries of the simplex, which needs to be kept in mind if
+ * the points are also used as support points of some kind.
+ */
+template <int dim>
+class QGaussSimplex : public QSimplex<dim>
+{
+public:
+  /**
+   * Generate a formula with <tt>n_points_1D</tt> quadrature points in each
+   * of the collapsed coordinate directions.
+   */
+  explicit QGaussSimplex(const unsigned int n_points_1D);
+};
+
 /*@}*/
 
 /* -------------- declaration of explicit specializations ------------- */
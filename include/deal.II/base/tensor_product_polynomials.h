@@ -111,6 +111,13 @@ public:
   const std::vector<unsigned int> &
   get_numbering_inverse() const;
 
+  /**
+   * Give read access to the one-dimensional polynomials the tensor product
+   * is built from.
+   */
+  const std::vector<PolynomialType> &
+  get_underlying_polynomials() const;
+
   /**
    * Compute the value and the first and second derivatives of each tensor
    * product polynomial at <tt>unit_point</tt>.
@@ -520,6 +527,15 @@ TensorProductPolynomials<dim, PolynomialType>::get_numbering_inverse() const
 }
 
 
+template <int dim, typename PolynomialType>
+inline const std::vector<PolynomialType> &
+TensorProductPolynomials<dim, PolynomialType>::get_underlying_polynomials()
+  const
+{
+  return polynomials;
+}
+
+
 template <int dim, typename PolynomialType>
 inline std::string
 TensorProductPolynomials<dim, PolynomialType>::name() const
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2014 - 2018 by the deal.II authors
+// Copyright (C) 2014 - 2020 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -38,6 +38,11 @@ namespace TimeStepping
    *   - FORWARD_EULER (first order)
    *   - RK_THIRD_ORDER (third order Runge-Kutta)
    *   - RK_CLASSIC_FOURTH_ORDER (classical fourth order Runge-Kutta)
+   * - Low-storage explicit methods (see LowStorageRungeKutta::initialize):
+   *   - LOW_STORAGE_RK_STAGE3_ORDER3 (three stages, third order)
+   *   - LOW_STORAGE_RK_STAGE5_ORDER4 (five stages, fourth order)
+   *   - LOW_STORAGE_RK_STAGE7_ORDER4 (seven stages, fourth order)
+   *   - LOW_STORAGE_RK_STAGE9_ORDER5 (nine stages, fifth order)
    * - Implicit methods (see ImplicitRungeKutta::initialize):
    *   - BACKWARD_EULER (first order)
    *   - IMPLICIT_MIDPOINT (second order)
@@ -56,6 +61,10 @@ namespace TimeStepping
     FORWARD_EULER,
     RK_THIRD_ORDER,
     RK_CLASSIC_FOURTH_ORDER,
+    LOW_STORAGE_RK_STAGE3_ORDER3,
+    LOW_STORAGE_RK_STAGE5_ORDER4,
+    LOW_STORAGE_RK_STAGE7_ORDER4,
+    LOW_STORAGE_RK_STAGE9_ORDER5,
     BACKWARD_EULER,
     IMPLICIT_MIDPOINT,
     CRANK_NICOLSON,
@@ -318,6 +327,217 @@ namespace TimeStepping
 
 
 
+  /**
+   * LowStorageRungeKutta is derived from RungeKutta and implements the
+   * explicit low-storage Runge-Kutta methods of Kennedy, Carpenter, and
+   * Lewis (2000) in the two-register form. As opposed to
+   * ExplicitRungeKutta, which keeps the function evaluations of all stages,
+   * these methods only need the solution vector and two auxiliary vectors
+   * $r_i$ and $k_i$, independent of the number of stages. The Butcher
+   * tableau of these methods has the special structure
+   * @f{align*}{
+   *   a_{ij} = \begin{cases} b_j & j < i-1, \\ a_{i-1} & j = i-1, \\
+   *   0 & \text{otherwise,}\end{cases}
+   * @f}
+   * i.e., it is described by the weights $b_i$ and the subdiagonal
+   * $a_i$ only. Stage $i$ of a step from $t$ to $t+\Delta t$ then performs
+   * the operations
+   * @f{align*}{
+   *   k_i &= f(t + c_i \Delta t, r_i),\\
+   *   r_{i+1} &= y + a_i \Delta t\, k_i,\\
+   *   y &\leftarrow y + b_i \Delta t\, k_i,
+   * @f}
+   * starting with $r_1 = y$, where $y$ is the solution vector that is
+   * updated in place. The vector $r_{i+1}$ is not needed in the last stage.
+   *
+   * Since the vector updates of a stage only involve entries with the same
+   * index, they can be merged with the evaluation of $f$, e.g., within the
+   * `operation_after_loop` of MatrixFree::cell_loop(), such that each stage
+   * only reads and writes the vectors once. For this purpose, the class
+   * provides an evolve_one_time_step() variant taking a function that
+   * performs a complete stage, see the documentation of that function.
+   * Alternatively, get_coefficients() returns the coefficients of the
+   * method for use in a custom time integrator.
+   */
+  template <typename VectorType>
+  class LowStorageRungeKutta : public RungeKutta<VectorType>
+  {
+  public:
+    using RungeKutta<VectorType>::evolve_one_time_step;
+
+    /**
+     * Default constructor. This constructor creates an object for which
+     * you will want to call <code>initialize(runge_kutta_method)</code>
+     * before it can be used.
+     */
+    LowStorageRungeKutta() = default;
+
+    /**
+     * Constructor. This function calls initialize(runge_kutta_method).
+     */
+    LowStorageRungeKutta(const runge_kutta_method method);
+
+    /**
+     * Initialize the low-storage Runge-Kutta method.
+     */
+    void
+    initialize(const runge_kutta_method method) override;
+
+    /**
+     * This function is used to advance from time @p t to t+ @p delta_t. @p f
+     * is the function $ f(t,y) $ that should be integrated, the input
+     * parameters are the time t and the vector y and the output is value of f
+     * at this point. @p id_minus_tau_J_inverse is not used by explicit
+     * methods. The two auxiliary vectors are allocated within this
+     * function. evolve_one_time_step returns the time at the end of the time
+     * step.
+     */
+    double
+    evolve_one_time_step(
+      const std::function<VectorType(const double, const VectorType &)> &f,
+      const std::function<
+        VectorType(const double, const double, const VectorType &)>
+        &         id_minus_tau_J_inverse,
+      double      t,
+      double      delta_t,
+      VectorType &y) override;
+
+    /**
+     * This function is used to advance from time @p t to t+ @p delta_t. @p f
+     * is the function $ f(t,y) $ that should be integrated. The vectors
+     * @p vec_ri and @p vec_ki are used to store the auxiliary vectors $r_i$
+     * and $k_i$ and can be reused between time steps to avoid memory
+     * allocation. evolve_one_time_step returns the time at the end of the
+     * time step.
+     */
+    double
+    evolve_one_time_step(
+      const std::function<VectorType(const double, const VectorType &)> &f,
+      double                                                             t,
+      double      delta_t,
+      VectorType &solution,
+      VectorType &vec_ri,
+      VectorType &vec_ki);
+
+    /**
+     * Same as above, but the complete work of a stage is done in the
+     * function @p stage_operation. It is called with the arguments
+     * `(time, factor_solution, factor_ai, current_ri, vec_ki, solution,
+     * next_ri)` and must compute
+     * @code
+     * vec_ki = f(time, current_ri);
+     * next_ri = solution + factor_ai * vec_ki; // only if factor_ai != 0
+     * solution += factor_solution * vec_ki;
+     * @endcode
+     * where the assignment to `next_ri` must use the value of `solution`
+     * before its update. The factors already contain the time step size. In
+     * the last stage, `factor_ai` is zero and `next_ri` must not be touched.
+     *
+     * Note that `current_ri` is the same object as `solution` in the first
+     * stage, and that `next_ri` is the same object as `current_ri` in all
+     * other stages. Thus, an entry of `solution` and `next_ri` must only be
+     * written once all entries of `current_ri` that the evaluation of $f$
+     * at that entry depends upon have been read. This is exactly what the
+     * `operation_after_loop` of MatrixFree::cell_loop() guarantees, where
+     * the entries of `vec_ki` of a range are final once the function is
+     * called on that range. An implementation of a stage for the mass
+     * matrix inverse `inv_mass` applied to the cell integrals could look as
+     * follows:
+     * @code
+     * matrix_free.cell_loop(
+     *   &Operator::local_apply_cell, this, vec_ki, current_ri, true,
+     *   [](const unsigned int, const unsigned int) {},
+     *   [&](const unsigned int start, const unsigned int end) {
+     *     for (unsigned int i = start; i < end; ++i)
+     *       {
+     *         const double k_i = inv_mass.local_element(i) *
+     *                            vec_ki.local_element(i);
+     *         const double sol_i = solution.local_element(i);
+     *         if (factor_ai != 0.)
+     *           next_ri.local_element(i) = sol_i + factor_ai * k_i;
+     *         solution.local_element(i) = sol_i + factor_solution * k_i;
+     *       }
+     *   });
+     * @endcode
+     * This way, each stage reads the solution and the stage vector only
+     * once and writes them once, as opposed to separate vector updates after
+     * the operator evaluation.
+     */
+    double
+    evolve_one_time_step(
+      const std::function<void(const double,
+                               const double,
+                               const double,
+                               const VectorType &,
+                               VectorType &,
+                               VectorType &,
+                               VectorType &)> &stage_operation,
+      double                                  t,
+      double                                  delta_t,
+      VectorType &                            solution,
+      VectorType &                            vec_ri,
+      VectorType &                            vec_ki);
+
+    /**
+     * Get the coefficients of the scheme, i.e., the subdiagonal $a_i$ of the
+     * Butcher tableau (with one entry less than the number of stages), the
+     * weights $b_i$, and the stage times $c_i$. These are the coefficients
+     * used for the updates described in the class documentation.
+     */
+    void
+    get_coefficients(std::vector<double> &ai,
+                     std::vector<double> &bi,
+                     std::vector<double> &ci) const;
+
+    /**
+     * This structure stores the name of the method used.
+     */
+    struct Status : public TimeStepping<VectorType>::Status
+    {
+      Status()
+        : method(invalid)
+      {}
+
+      runge_kutta_method method;
+    };
+
+    /**
+     * Return the status of the current object.
+     */
+    const Status &
+    get_status() const override;
+
+  private:
+    /**
+     * Compute one stage of the low-storage Runge-Kutta method with the
+     * operations described in the documentation of the
+     * evolve_one_time_step() variant taking a stage operation.
+     */
+    void
+    compute_one_stage(
+      const std::function<VectorType(const double, const VectorType &)> &f,
+      const double      current_time,
+      const double      factor_solution,
+      const double      factor_ai,
+      const VectorType &current_ri,
+      VectorType &      vec_ki,
+      VectorType &      solution,
+      VectorType &      next_ri) const;
+
+    /**
+     * Subdiagonal of the Butcher tableau, with one entry less than the
+     * number of stages.
+     */
+    std::vector<double> ai;
+
+    /**
+     * Status structure of the object.
+     */
+    Status status;
+  };
+
+
+
   /**
    * This class is derived from RungeKutta and implement the implicit methods.
    * This class works only for Diagonal Implicit Runge-Kutta (DIRK) methods.
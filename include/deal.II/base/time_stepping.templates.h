@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2014 - 2019 by the deal.II authors
+// Copyright (C) 2014 - 2020 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -218,6 +218,271 @@ namespace TimeStepping
 
 
 
+  // ----------------------------------------------------------------------
+  // LowStorageRungeKutta
+  // ----------------------------------------------------------------------
+
+  template <typename VectorType>
+  LowStorageRungeKutta<VectorType>::LowStorageRungeKutta(
+    const runge_kutta_method method)
+  {
+    // virtual functions called in constructors and destructors never use the
+    // override in a derived class
+    // for clarity be explicit on which function is called
+    LowStorageRungeKutta<VectorType>::initialize(method);
+  }
+
+
+
+  template <typename VectorType>
+  void
+  LowStorageRungeKutta<VectorType>::initialize(const runge_kutta_method method)
+  {
+    status.method = method;
+
+    // the coefficients of the methods with three, five, and nine stages are
+    // taken from Kennedy, Carpenter, Lewis, Low-storage, explicit
+    // Runge-Kutta schemes for the compressible Navier-Stokes equations,
+    // Appl. Numer. Math. 35 (2000), the ones of the method with seven stages
+    // from Tselios, Simos, Optimized Runge-Kutta methods with minimal
+    // dispersion and dissipation for problems arising from computational
+    // acoustics, Phys. Lett. A (2007)
+    switch (method)
+      {
+        case (LOW_STORAGE_RK_STAGE3_ORDER3):
+          {
+            this->n_stages = 3;
+
+            this->b = {0.245170287303492, 0.184896052186740, 0.569933660509768};
+            ai      = {0.755726351946097, 0.386954477304099};
+
+            break;
+          }
+        case (LOW_STORAGE_RK_STAGE5_ORDER4):
+          {
+            this->n_stages = 5;
+
+            this->b = {1153189308089. / 22510343858157.,
+                       1772645290293. / 4653164025191.,
+                       -1672844663538. / 4480602732383.,
+                       2114624349019. / 3568978502595.,
+                       5198255086312. / 14908931495163.};
+            ai      = {970286171893. / 4311952581923.,
+                       6584761158862. / 12103376702013.,
+                       2251764453980. / 15575788980749.,
+                       26877169314380. / 34165994151039.};
+
+            break;
+          }
+        case (LOW_STORAGE_RK_STAGE7_ORDER4):
+          {
+            this->n_stages = 7;
+
+            this->b = {0.0941840925477795334,
+                       0.149683694803496998,
+                       0.285204742060440058,
+                       -0.122201846148053668,
+                       0.0605151571191401122,
+                       0.345986987898399296,
+                       0.186627171718797670};
+            ai      = {0.241566650129646868 + this->b[0],
+                       0.0423866513027719953 + this->b[1],
+                       0.215602732678803776 + this->b[2],
+                       0.232328007537583987 + this->b[3],
+                       0.256223412574146438 + this->b[4],
+                       0.0978694102142697230 + this->b[5]};
+
+            break;
+          }
+        case (LOW_STORAGE_RK_STAGE9_ORDER5):
+          {
+            this->n_stages = 9;
+
+            this->b = {2274579626619. / 23610510767302.,
+                       693987741272. / 12394497460941.,
+                       -347131529483. / 15096185902911.,
+                       1144057200723. / 32081666971178.,
+                       1562491064753. / 11797114684756.,
+                       13113619727965. / 44346030145118.,
+                       393957816125. / 7825732611452.,
+                       720647959663. / 6565743875477.,
+                       3559252274877. / 14424734981077.};
+            ai      = {1107026461565. / 5417078080134.,
+                       38141181049399. / 41724347789894.,
+                       493273079041. / 11940823631197.,
+                       1851571280403. / 6147804934346.,
+                       11782306865191. / 62590030070788.,
+                       9452544825720. / 13648368537481.,
+                       4435885630781. / 26285702406235.,
+                       2357909744247. / 11371140753790.};
+
+            break;
+          }
+        default:
+          {
+            AssertThrow(
+              false,
+              ExcMessage("Unimplemented low-storage Runge-Kutta method."));
+          }
+      }
+
+    // the stage times follow from the row sums of the Butcher tableau,
+    // where all entries left of the subdiagonal are given by the weights
+    this->c.resize(this->n_stages);
+    this->c[0]   = 0.;
+    double sum_b = 0.;
+    for (unsigned int i = 1; i < this->n_stages; ++i)
+      {
+        this->c[i] = sum_b + ai[i - 1];
+        sum_b += this->b[i - 1];
+      }
+  }
+
+
+
+  template <typename VectorType>
+  double
+  LowStorageRungeKutta<VectorType>::evolve_one_time_step(
+    const std::function<VectorType(const double, const VectorType &)> &f,
+    const std::function<
+      VectorType(const double, const double, const VectorType &)>
+      & /*id_minus_tau_J_inverse*/,
+    double      t,
+    double      delta_t,
+    VectorType &y)
+  {
+    VectorType vec_ri(y), vec_ki(y);
+    return evolve_one_time_step(f, t, delta_t, y, vec_ri, vec_ki);
+  }
+
+
+
+  template <typename VectorType>
+  double
+  LowStorageRungeKutta<VectorType>::evolve_one_time_step(
+    const std::function<VectorType(const double, const VectorType &)> &f,
+    double                                                             t,
+    double                                                             delta_t,
+    VectorType &                                                       solution,
+    VectorType &                                                       vec_ri,
+    VectorType &                                                       vec_ki)
+  {
+    return evolve_one_time_step(
+      [this, &f](const double      time,
+                 const double      factor_solution,
+                 const double      factor_ai,
+                 const VectorType &current_ri,
+                 VectorType &      ki,
+                 VectorType &      y,
+                 VectorType &      next_ri) {
+        compute_one_stage(
+          f, time, factor_solution, factor_ai, current_ri, ki, y, next_ri);
+      },
+      t,
+      delta_t,
+      solution,
+      vec_ri,
+      vec_ki);
+  }
+
+
+
+  template <typename VectorType>
+  double
+  LowStorageRungeKutta<VectorType>::evolve_one_time_step(
+    const std::function<void(const double,
+                             const double,
+                             const double,
+                             const VectorType &,
+                             VectorType &,
+                             VectorType &,
+                             VectorType &)> &stage_operation,
+    double                                  t,
+    double                                  delta_t,
+    VectorType &                            solution,
+    VectorType &                            vec_ri,
+    VectorType &                            vec_ki)
+  {
+    Assert(this->b.size() > 1,
+           ExcMessage("The low-storage Runge-Kutta method has not been "
+                      "initialized."));
+
+    // the first stage starts from the solution itself
+    stage_operation(t,
+                    this->b[0] * delta_t,
+                    ai[0] * delta_t,
+                    solution,
+                    vec_ki,
+                    solution,
+                    vec_ri);
+
+    for (unsigned int stage = 1; stage < this->n_stages; ++stage)
+      {
+        const double factor_ai =
+          (stage == this->n_stages - 1 ? 0. : ai[stage] * delta_t);
+        stage_operation(t + this->c[stage] * delta_t,
+                        this->b[stage] * delta_t,
+                        factor_ai,
+                        vec_ri,
+                        vec_ki,
+                        solution,
+                        vec_ri);
+      }
+
+    return (t + delta_t);
+  }
+
+
+
+  template <typename VectorType>
+  void
+  LowStorageRungeKutta<VectorType>::get_coefficients(
+    std::vector<double> &ai,
+    std::vector<double> &bi,
+    std::vector<double> &ci) const
+  {
+    ai = this->ai;
+    bi = this->b;
+    ci = this->c;
+  }
+
+
+
+  template <typename VectorType>
+  const typename LowStorageRungeKutta<VectorType>::Status &
+  LowStorageRungeKutta<VectorType>::get_status() const
+  {
+    return status;
+  }
+
+
+
+  template <typename VectorType>
+  void
+  LowStorageRungeKutta<VectorType>::compute_one_stage(
+    const std::function<VectorType(const double, const VectorType &)> &f,
+    const double      current_time,
+    const double      factor_solution,
+    const double      factor_ai,
+    const VectorType &current_ri,
+    VectorType &      vec_ki,
+    VectorType &      solution,
+    VectorType &      next_ri) const
+  {
+    // evaluate f before touching next_ri and solution, which might be the
+    // same objects as current_ri
+    vec_ki = f(current_time, current_ri);
+
+    if (factor_ai != 0.)
+      {
+        next_ri = solution;
+        next_ri.sadd(1., factor_ai, vec_ki);
+      }
+    solution.sadd(1., factor_solution, vec_ki);
+  }
+
+
+
   // ----------------------------------------------------------------------
   // ImplicitRungeKutta
   // ----------------------------------------------------------------------
@@ -539,6 +539,11 @@ private:
  * taken by the 10\% of the slowest and fastest ranks, respectively, to get
  * additional insight into the statistical distribution.
  *
+ * @note This class keeps a flat list of sections that is shared by all
+ * threads. For nested regions, for timing concurrently running tasks, and
+ * for histograms of the individual calls or traces of a run, see the
+ * functions and classes in namespace Instrumentation.
+ *
  * @ingroup utilities
  */
 class TimerOutput
@@ -22,6 +22,7 @@
 #include <deal.II/base/smartpointer.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/template_constraints.h>
+#include <deal.II/base/thread_management.h>
 
 #include <deal.II/distributed/p4est_wrappers.h>
 #include <deal.II/distributed/tria_base.h>
@@ -615,6 +616,44 @@ namespace parallel
       void
       save(const std::string &filename) const;
 
+      /**
+       * Like save(), but return as soon as the data attached to the cells via
+       * register_data_attach() has been packed into buffers in memory. The
+       * buffers are then written to the file system on a separate task while
+       * the computation continues. The files produced are identical to those
+       * of save() and can be read with load().
+       *
+       * The refinement information of the forest and the <tt>.info</tt> file
+       * are small and are written collectively before this function returns.
+       * Only the cell-based data, which typically makes up the bulk of a
+       * checkpoint, is written in the background. In contrast to save(), which
+       * uses MPI-IO, each process writes its part of the files at
+       * precomputed positions with ordinary file operations, so that no MPI
+       * calls are issued from the background task.
+       *
+       * The checkpoints are double-buffered: at most one checkpoint is written
+       * in the background at any time. A subsequent call to save(),
+       * save_async() or load() first packs its own data and then waits for the
+       * previous write to finish before touching any file. If that write
+       * failed on any of the processes, the call throws an exception on all
+       * processes, so that none of them is left waiting for the others. The
+       * destructor of this class also waits for pending writes, but ignores
+       * their errors.
+       *
+       * @return A handle to the background write. Calling join() on it waits
+       * for the checkpoint to be complete on the current process, and
+       * re-throws any error that occurred while writing. Since each process
+       * only writes its own part, a checkpoint is complete on disk only once
+       * all processes have joined their handles.
+       *
+       * @note The background task is created with Threads::new_task(). If the
+       * library has been set up to use only a single thread (see
+       * MultithreadInfo::set_thread_limit()), the data is written before
+       * this function returns.
+       */
+      Threads::Task<>
+      save_async(const std::string &filename) const;
+
       /**
        * Load the refinement information saved with save() back in. The mesh
        * must contain the same coarse mesh that was used in save() before
@@ -1058,6 +1097,25 @@ namespace parallel
                *                parallel_forest,
              const std::string &filename) const;
 
+        /**
+         * Prepare the transfer of data to the file system in the background.
+         *
+         * This function collectively creates the same files as save() and
+         * determines the position of each processor's data in them, which
+         * requires communication. The packed buffers are moved into the
+         * returned function object, which then writes them with ordinary
+         * file operations and without any further communication. It can
+         * therefore be run on a separate thread.
+         *
+         * Data has to be previously packed with pack_data(). The buffers of
+         * this object are empty after this function returns.
+         */
+        std::function<void()>
+        prepare_save_async(
+          const typename dealii::internal::p4est::types<dim>::forest
+            *                parallel_forest,
+          const std::string &filename);
+
         /**
          * Transfer data from file system.
          *
@@ -1131,6 +1189,31 @@ namespace parallel
 
       DataTransfer data_transfer;
 
+      /**
+       * The task writing the cell-based data of the last checkpoint created
+       * with save_async(). It is joined before the files of another
+       * checkpoint are written, and in the destructor.
+       */
+      mutable Threads::Task<> checkpoint_write_task;
+
+      /**
+       * Wait for the task in checkpoint_write_task, if any, on all processes.
+       * If writing failed on one of the processes, an exception is thrown on
+       * all of them: the one of the failed write where it happened, and an
+       * ExcMessage on the other processes.
+       */
+      void
+      wait_for_checkpoint_write() const;
+
+      /**
+       * Implementation of save() and save_async(). If @p write_asynchronously
+       * is true, the cell-based data is not written, but a function object
+       * doing so is returned. Otherwise, the returned object is empty.
+       */
+      std::function<void()>
+      save_checkpoint(const std::string &filename,
+                      const bool         write_asynchronously) const;
+
       /**
        * Two arrays that store which p4est tree corresponds to which coarse
        * grid cell and vice versa. We need these arrays because p4est goes
@@ -1317,6 +1400,13 @@ namespace parallel
       void
       save(const std::string &filename) const;
 
+      /**
+       * This function is not implemented, but needs to be present for the
+       * compiler.
+       */
+      Threads::Task<>
+      save_async(const std::string &filename) const;
+
       bool
       is_multilevel_hierarchy_constructed() const override;
 
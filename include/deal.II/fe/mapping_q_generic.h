@@ -20,6 +20,7 @@
 #include <deal.II/base/config.h>
 
 #include <deal.II/base/derivative_form.h>
+#include <deal.II/base/polynomial.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/vectorization.h>
@@ -585,6 +586,27 @@ public:
     dealii::internal::FEValuesImplementation::MappingRelatedData<dim, spacedim>
       &output_data) const override;
 
+  /**
+   * As opposed to the fill_fe_values() function that relies on information
+   * pre-computed by get_data() for a fixed quadrature formula, this function
+   * computes the mapping data for an arbitrary set of points on the unit cell
+   * that may change from one call to the next. The support points of the
+   * mapping on the cell are combined with the one-dimensional Lagrange
+   * polynomials of the mapping by sum factorization, point by point, which
+   * avoids setting up a new FEValues object or quadrature formula for each
+   * set of points. This function is used by FEPointEvaluation.
+   *
+   * Only the flags update_quadrature_points, update_jacobians, and
+   * update_inverse_jacobians are supported.
+   */
+  void
+  fill_mapping_data_for_generic_points(
+    const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+    const ArrayView<const Point<dim>> &                         unit_points,
+    const UpdateFlags                                           update_flags,
+    dealii::internal::FEValuesImplementation::MappingRelatedData<dim, spacedim>
+      &output_data) const;
+
   /**
    * @}
    */
@@ -607,6 +629,20 @@ protected:
    */
   QGaussLobatto<1> line_support_points;
 
+  /**
+   * The one-dimensional Lagrange polynomials in the points of
+   * line_support_points, used by fill_mapping_data_for_generic_points() to
+   * evaluate the mapping in arbitrary points by sum factorization.
+   */
+  std::vector<Polynomials::Polynomial<double>> polynomials_1d;
+
+  /**
+   * The numbering from the lexicographic ordering of the tensor product of
+   * polynomials_1d to the ordering of the support points returned by
+   * compute_mapping_support_points().
+   */
+  std::vector<unsigned int> renumber_lexicographic_to_hierarchic;
+
   /**
    * A vector of tables of weights by which we multiply the locations of the
    * support points on the perimeter of an object (line, quad, hex) to get the
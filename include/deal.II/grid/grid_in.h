@@ -154,7 +154,9 @@ struct CellData;
  *
  * <li> <tt>%Gmsh 2.0 mesh</tt> format: this is a variant of the above format.
  * The read_msh() function automatically determines whether an input file is
- * version 1 or version 2.
+ * version 1 or version 2. Files in version 4.1 of the format can also be read
+ * in binary encoding when passing the file name to read_msh(), which uses a
+ * parallel parser on the memory-mapped file.
  *
  * <li> <tt>Tecplot</tt> format: this format is used by @p TECPLOT and often
  * serves as a basis for data exchange between different applications. Note,
@@ -508,6 +510,29 @@ public:
   void
   read_msh(std::istream &in);
 
+  /**
+   * Read grid data from the msh file @p filename.
+   *
+   * For files in version 4.1 of the %Gmsh format, both in ASCII and in
+   * binary encoding, this function does not go through a
+   * <code>std::istream</code>: The file is mapped into memory (or read into
+   * memory in one piece on systems without <code>mmap</code>) and parsed
+   * directly from there. The node coordinates and element connectivities,
+   * which make up the bulk of large files, are parsed in parallel using the
+   * functions in the parallel namespace and written into arrays that are
+   * allocated upfront from the sizes given in the file, and %Gmsh node tags
+   * are translated into vertex indices through a table instead of a map. For
+   * the ASCII encoding, a cheap serial pass determines the positions of
+   * chunks of records before the expensive conversion of the numbers is
+   * done in parallel; the binary encoding allows for random access
+   * directly.
+   *
+   * Files in older versions of the format are passed on to
+   * read_msh(std::istream &).
+   */
+  void
+  read_msh(const std::string &filename);
+
   /**
    * Read grid data from a file containing tecplot ASCII data. This also works
    * in the absence of any tecplot installation.
@@ -26,6 +26,10 @@
 
 #include <boost/container/small_vector.hpp>
 
+#include <array>
+#include <map>
+#include <mutex>
+
 DEAL_II_NAMESPACE_OPEN
 
 /**
@@ -950,6 +954,27 @@ private:
  * current implementation by a pre-identification of relevant cells with
  * axis-aligned bounding boxes.
  *
+ * The transformation of the surrounding points to the chart coordinates of
+ * a coarse cell is done with a Newton iteration that calls the manifolds
+ * surrounding the coarse cell in each step, which is by far the most
+ * expensive part of this class. Since the vertices of a cell are the
+ * surrounding points of all new points on the cell's lines, faces and
+ * interior, this class memorizes the chart coordinates of the points it has
+ * transformed and of the points created by get_new_point(). In this way,
+ * the Newton iteration is run only once for each point and coarse cell
+ * during one refinement step or during the setup of a mapping, e.g. by
+ * MappingQCache. The memorized points are discarded whenever the
+ * triangulation signals a change (Triangulation::Signals::any_change), so
+ * that the memory consumption is bounded by the number of points touched in
+ * one such pass. Since the chart of a coarse cell only depends on the
+ * vertices of the coarse cell and the manifolds attached to its lines and
+ * faces, the memorized points of a coarse cell are not used any more once
+ * one of its vertices is moved without notification of the triangulation,
+ * e.g. by GridTools::distort_random() or by directly assigning to
+ * <code>cell->vertex(v)</code>. If the manifold objects describing the
+ * boundary of the coarse cells are changed, initialize() must be called
+ * again.
+ *
  * @ingroup manifold
  */
 template <int dim, int spacedim = dim>
@@ -1021,6 +1046,9 @@ public:
    * pushed forward to the real space according to the transfinite
    * interpolation.
    *
+   * If the coarse cell does not have any curved lines or faces, the push
+   * forward of several points is done at once with VectorizedArray.
+   *
    * The implementation does not allow for @p surrounding_points and
    * @p new_points to point to the same vector, so make sure to pass different
    * objects into the function.
@@ -1111,6 +1139,43 @@ private:
     const Point<dim> &                                          chart_point,
     const Point<spacedim> &pushed_forward_chart_point) const;
 
+  /**
+   * Look up the chart point of the given point in real space on the given
+   * coarse cell in the chart_point_cache. Return true and set
+   * @p chart_point if the point has been found.
+   */
+  bool
+  find_in_chart_point_cache(
+    const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+    const Point<spacedim> &                                     point,
+    Point<dim> &chart_point) const;
+
+  /**
+   * Store the chart point of the given point in real space on the given
+   * coarse cell in the chart_point_cache.
+   */
+  void
+  add_to_chart_point_cache(
+    const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+    const Point<spacedim> &                                     point,
+    const Point<dim> &chart_point) const;
+
+  /**
+   * Return whether the vertices of the given coarse cell are still the ones
+   * recorded in chart_point_cache_coarse_vertices, i.e., whether the points
+   * in the cache for this cell are valid.
+   */
+  bool
+  coarse_cell_matches_chart_point_cache(
+    const typename Triangulation<dim, spacedim>::cell_iterator &cell) const;
+
+  /**
+   * Empty the chart_point_cache and record the current vertices of the
+   * coarse cells.
+   */
+  void
+  reset_chart_point_cache();
+
   /**
    * The underlying triangulation.
    */
@@ -1135,11 +1200,55 @@ private:
    */
   FlatManifold<dim> chart_manifold;
 
+  /**
+   * One part of the chart_point_cache, consisting of a map from the index
+   * of the coarse cell and the coordinates of a point in real space to the
+   * chart point, together with a mutex guarding the map.
+   */
+  struct ChartPointCacheShard
+  {
+    std::mutex mutex;
+    std::map<std::pair<unsigned int, std::array<double, spacedim>>,
+             Point<dim>>
+      chart_points;
+  };
+
+  /**
+   * A cache of the chart points of the points transformed by
+   * compute_chart_points() and of the points created by get_new_point(). It
+   * is used by compute_chart_points() to skip the Newton iteration in
+   * pull_back() for points that have been seen before. As the key uses the
+   * exact coordinates of the point, a point that has been moved can never be
+   * mistaken for a point that has been computed before.
+   *
+   * Since the functions computing new points may be called concurrently,
+   * e.g. from MappingQCache, the cache is split into several shards with
+   * their own mutex, selected by a hash of the key, so that concurrent
+   * accesses are rarely serialized.
+   *
+   * The cache is reset by initialize() and whenever the triangulation
+   * triggers Triangulation::Signals::any_change.
+   */
+  mutable std::array<ChartPointCacheShard, 32> chart_point_cache;
+
+  /**
+   * The vertices of the coarse cells at the time the chart_point_cache was
+   * reset, with GeometryInfo<dim>::vertices_per_cell entries per cell. The
+   * cache is not used for coarse cells whose vertices have changed since.
+   */
+  std::vector<Point<spacedim>> chart_point_cache_coarse_vertices;
+
   /**
    * The connection to Triangulation::signals::clear that must be reset once
    * this class goes out of scope.
    */
   boost::signals2::connection clear_signal;
+
+  /**
+   * The connection to Triangulation::signals::any_change that must be
+   * reset once this class goes out of scope.
+   */
+  boost::signals2::connection any_change_signal;
 };
 
 DEAL_II_NAMESPACE_CLOSE
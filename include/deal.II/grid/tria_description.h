@@ -484,6 +484,90 @@ namespace TriangulationDescription
       const TriangulationDescription::Settings setting =
         TriangulationDescription::Settings::default_setting);
 
+
+    /**
+     * Construct a TriangulationDescription::Description by reading a coarse
+     * mesh in parallel from a file in the binary format written by
+     * write_binary_coarse_mesh(). In contrast to the functions above, no
+     * process ever holds the complete mesh: each process reads only a
+     * contiguous chunk of the cells stored in the file, which then become
+     * its locally owned cells. The cells in the layer of ghost cells around
+     * the locally owned ones are determined in parallel via a distributed
+     * dictionary of vertices, which is set up and queried with the
+     * algorithms in Utilities::MPI::ConsensusAlgorithms. Afterwards, each
+     * process reads the records of its ghost cells as well as the
+     * coordinates of the vertices it needs directly from the file. As a
+     * consequence, the memory consumption per process and the amount of data
+     * read from the file per process is proportional to the number of
+     * locally relevant cells, and the approach scales to meshes with
+     * billions of coarse cells that do not fit into the memory of a single
+     * compute node.
+     *
+     * The partitioning of the mesh is given by the order of the cells in the
+     * file: process $p$ out of $P$ owns the cells with index in the range
+     * $[\lfloor pN/P\rfloor, \lfloor(p+1)N/P\rfloor)$, where $N$ is the
+     * number of cells. To obtain partitions with small interfaces, the cells
+     * should thus be ordered along a space-filling curve (or by any other
+     * locality-preserving numbering) before the file is written.
+     *
+     * The file is expected to be accessible from all processes, e.g., on a
+     * parallel file system. Its layout is as follows, with all integers
+     * stored as 64-bit unsigned integers and all coordinates as double
+     * precision numbers in the native byte order:
+     * - a header of 8 characters `dealIIcm`, followed by the integers `dim`,
+     *   `spacedim`, the number of vertices and the number of cells;
+     * - the coordinates of all vertices, `spacedim` numbers per vertex;
+     * - one record per cell, consisting of the global indices of the
+     *   GeometryInfo<dim>::vertices_per_cell vertices of the cell in the
+     *   usual deal.II ordering, the material id, the manifold id, and the
+     *   boundary id of each of the GeometryInfo<dim>::faces_per_cell faces
+     *   (numbers::internal_face_boundary_id for faces in the interior of
+     *   the mesh), followed in 2D and 3D by the manifold ids of the
+     *   GeometryInfo<dim>::lines_per_cell lines of the cell and in 3D by the
+     *   manifold ids of its faces.
+     *
+     * Since all records have the same size, any cell or vertex can be
+     * accessed without reading the file up to its position.
+     *
+     * @param filename Name of the file to read.
+     * @param comm MPI communicator.
+     * @param smoothing Mesh smoothing type.
+     * @param settings See the description of the Settings enumerator.
+     * @return Description to be used to set up a
+     *   parallel::fullydistributed::Triangulation. It only contains the
+     *   coarse level of the mesh.
+     *
+     * @note The manifold ids of the lines and quads of the cells are set to
+     *   numbers::flat_manifold_id, since they are not stored in the file.
+     *   Periodic boundaries are not supported.
+     */
+    template <int dim, int spacedim = dim>
+    Description<dim, spacedim>
+    create_description_from_binary_coarse_mesh(
+      const std::string &filename,
+      const MPI_Comm     comm,
+      const typename Triangulation<dim, spacedim>::MeshSmoothing smoothing =
+        dealii::Triangulation<dim, spacedim>::none,
+      const TriangulationDescription::Settings settings =
+        TriangulationDescription::Settings::default_setting);
+
+
+    /**
+     * Write the coarse cells of the triangulation @p tria to the file
+     * @p filename in the binary format read by
+     * create_description_from_binary_coarse_mesh(). The cells are written in
+     * the order of their coarse-cell index, which hence determines the
+     * partitioning when the file is read in parallel.
+     *
+     * This function is meant to be called on a single process, e.g., to
+     * convert a mesh read by GridIn into a format that can be read in
+     * parallel.
+     */
+    template <int dim, int spacedim>
+    void
+    write_binary_coarse_mesh(const dealii::Triangulation<dim, spacedim> &tria,
+                             const std::string &filename);
+
   } // namespace Utilities
 
 
@@ -18,6 +18,7 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/memory_space.h>
 #include <deal.II/base/mpi.h>
 #include <deal.II/base/numbers.h>
@@ -44,7 +45,12 @@ namespace LinearAlgebra
   {
     template <typename>
     class BlockVector;
-  }
+
+    namespace internal
+    {
+      class SharedMemoryPattern;
+    }
+  } // namespace distributed
 
   template <typename>
   class ReadWriteVector;
@@ -179,6 +185,24 @@ namespace LinearAlgebra
      * fail in some circumstances. Therefore, it is strongly recommended to
      * not rely on this class to automatically detect the unsupported case.
      *
+     * <h4>Shared-memory mode</h4>
+     *
+     * When the vector is initialized with the reinit() function that takes a
+     * shared-memory communicator in addition to the partitioner, the entries
+     * of all processes of that communicator, which must run on the same
+     * compute node, are allocated in a common MPI-3 shared-memory window
+     * (<code>MPI_Win_allocate_shared</code>). Ghost entries owned by a process
+     * on the same node are then copied directly from the memory of the owner
+     * in update_ghost_values() and compress(), rather than being sent through
+     * MPI, and only the ghost entries owned by processes on other nodes are
+     * exchanged via MPI messages. Alternatively, the arrays of the other
+     * processes on the node can be read in place through
+     * shared_memory_data(). In this mode, update_ghost_values(), compress(),
+     * and all functions that allocate or release memory, including the
+     * destructor, are collective operations on the shared-memory
+     * communicator, and must therefore be called in the same order on all of
+     * its processes. The mode is only available for MemorySpace::Host.
+     *
      * <h4>CUDA support</h4>
      *
      * This vector class supports two different memory spaces: Host and CUDA. By
@@ -361,6 +385,26 @@ namespace LinearAlgebra
       reinit(
         const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner);
 
+      /**
+       * Initialize the vector given to the parallel partitioning described in
+       * @p partitioner, but allocate the entries of all processes of
+       * @p comm_sm in a common MPI-3 shared-memory window, see the section
+       * on the shared-memory mode in the documentation of this class. The
+       * communicator @p comm_sm must only contain processes of the
+       * communicator of the partitioner that run on the same compute node,
+       * as obtained for example by <code>MPI_Comm_split_type</code> with
+       * <code>MPI_COMM_TYPE_SHARED</code>, and must remain valid as long as
+       * the vector is in use. Vectors initialized from this one through
+       * reinit(const Vector &, const bool) share its communication pattern.
+       *
+       * This function involves global communication, and requires MPI 3.0
+       * or newer.
+       */
+      void
+      reinit(
+        const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+        const MPI_Comm &                                          comm_sm);
+
       /**
        * Swap the contents of this vector and the other vector @p v. One could
        * do this operation with a temporary variable and copying over the data
@@ -1086,6 +1130,20 @@ namespace LinearAlgebra
       const std::shared_ptr<const Utilities::MPI::Partitioner> &
       get_partitioner() const;
 
+      /**
+       * Return views of the arrays of all processes of the shared-memory
+       * communicator passed to reinit(), indexed by the rank within that
+       * communicator. Each array holds the locally owned entries of the
+       * respective process followed by its ghost entries. This allows to
+       * read entries owned by other processes on the same compute node in
+       * place, without calling update_ghost_values(), provided that the
+       * processes synchronize, e.g. by <code>MPI_Barrier</code>, between
+       * writing and reading the entries. If the vector is not in the
+       * shared-memory mode, the returned vector is empty.
+       */
+      const std::vector<ArrayView<const Number>> &
+      shared_memory_data() const;
+
       /**
        * Check whether the given partitioner is compatible with the
        * partitioner used for this vector. Two partitioners are compatible if
@@ -1263,6 +1321,20 @@ namespace LinearAlgebra
       mutable ::dealii::MemorySpace::MemorySpaceData<Number, MemorySpace>
         import_data;
 
+      /**
+       * The communication pattern in case the entries are stored in a
+       * shared-memory window, or a null pointer otherwise.
+       */
+      std::shared_ptr<const internal::SharedMemoryPattern>
+        shared_memory_pattern;
+
+      /**
+       * Views of the arrays of all processes of the shared-memory
+       * communicator in case the entries are stored in a shared-memory
+       * window.
+       */
+      std::vector<ArrayView<const Number>> shared_memory_arrays;
+
       /**
        * Stores whether the vector currently allows for reading ghost elements
        * or not. Note that this is to ensure consistent ghost data and does
@@ -1702,6 +1774,15 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number, typename MemorySpace>
+    inline const std::vector<ArrayView<const Number>> &
+    Vector<Number, MemorySpace>::shared_memory_data() const
+    {
+      return shared_memory_arrays;
+    }
+
+
+
     template <typename Number, typename MemorySpace>
     inline void
     Vector<Number, MemorySpace>::set_ghost_state(const bool ghosted) const
@@ -21,9 +21,11 @@
 
 #include <deal.II/base/cuda.h>
 #include <deal.II/base/cuda_size.h>
+#include <deal.II/base/instrumentation.h>
 
 #include <deal.II/lac/exceptions.h>
 #include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/la_parallel_vector_shared_memory.h>
 #include <deal.II/lac/petsc_vector.h>
 #include <deal.II/lac/read_write_vector.h>
 #include <deal.II/lac/trilinos_vector.h>
@@ -97,6 +99,16 @@ namespace LinearAlgebra
             & /*data*/)
         {}
 
+        static void
+        resize_val(
+          const types::global_dof_index /*new_alloc_size*/,
+          types::global_dof_index & /*allocated_size*/,
+          ::dealii::MemorySpace::MemorySpaceData<Number, MemorySpaceType>
+            & /*data*/,
+          const SharedMemoryPattern & /*shared_memory_pattern*/,
+          std::vector<ArrayView<const Number>> & /*shared_memory_arrays*/)
+        {}
+
         static void
         import(
           const ::dealii::LinearAlgebra::ReadWriteVector<Number> & /*V*/,
@@ -141,7 +153,7 @@ namespace LinearAlgebra
                 reinterpret_cast<void **>(&new_val),
                 64,
                 sizeof(Number) * new_alloc_size);
-              data.values.reset(new_val);
+              data.values = {new_val, &std::free};
 
               allocated_size = new_alloc_size;
             }
@@ -152,6 +164,97 @@ namespace LinearAlgebra
             }
         }
 
+        static void
+        resize_val(const types::global_dof_index new_alloc_size,
+                   types::global_dof_index &     allocated_size,
+                   ::dealii::MemorySpace::
+                     MemorySpaceData<Number, ::dealii::MemorySpace::Host> &data,
+                   const SharedMemoryPattern &shared_memory_pattern,
+                   std::vector<ArrayView<const Number>> &shared_memory_arrays)
+        {
+#ifdef DEAL_II_WITH_MPI
+#  if DEAL_II_MPI_VERSION_GTE(3, 0)
+          const MPI_Comm &communicator_sm =
+            shared_memory_pattern.get_sm_mpi_communicator();
+
+          // creating and freeing a window is collective, so always start
+          // from scratch instead of reusing a large enough array as above.
+          // in case the array was also a window, this releases it
+          data.values.reset();
+          shared_memory_arrays.clear();
+
+          // keep the arrays of all processes aligned to 64 bytes, and
+          // allocate at least that much so that every process gets a non-null
+          // pointer that is passed to the deleter below
+          constexpr std::size_t alignment = 64;
+          const std::size_t     n_bytes =
+            (std::max<std::size_t>(sizeof(Number) * new_alloc_size, 1) +
+             alignment - 1) /
+            alignment * alignment;
+
+          MPI_Info info;
+          int      ierr = MPI_Info_create(&info);
+          AssertThrowMPI(ierr);
+          ierr = MPI_Info_set(info, "alloc_shared_noncontig", "true");
+          AssertThrowMPI(ierr);
+
+          Number *new_val;
+          MPI_Win window;
+          ierr = MPI_Win_allocate_shared(n_bytes,
+                                         sizeof(Number),
+                                         info,
+                                         communicator_sm,
+                                         &new_val,
+                                         &window);
+          AssertThrowMPI(ierr);
+          ierr = MPI_Info_free(&info);
+          AssertThrowMPI(ierr);
+
+          data.values = {new_val, [window](Number *) mutable {
+                           // MPI_Win_free is collective and waits for all
+                           // processes of the node, so no process is still
+                           // reading from the memory when it gets released
+                           const int ierr = MPI_Win_free(&window);
+                           AssertThrowMPI(ierr);
+                         }};
+          allocated_size = new_alloc_size;
+
+          const std::vector<unsigned int> &sizes =
+            shared_memory_pattern.get_sm_array_sizes();
+          for (unsigned int p = 0; p < sizes.size(); ++p)
+            {
+              MPI_Aint window_size;
+              int      displacement_unit;
+              Number * array;
+              ierr = MPI_Win_shared_query(
+                window, p, &window_size, &displacement_unit, &array);
+              AssertThrowMPI(ierr);
+              Assert(static_cast<std::size_t>(window_size) >=
+                       sizes[p] * sizeof(Number),
+                     ExcInternalError());
+              shared_memory_arrays.emplace_back(array, sizes[p]);
+            }
+#  else
+          (void)new_alloc_size;
+          (void)allocated_size;
+          (void)data;
+          (void)shared_memory_pattern;
+          (void)shared_memory_arrays;
+          AssertThrow(false,
+                      ExcMessage("The shared-memory mode of "
+                                 "LinearAlgebra::distributed::Vector "
+                                 "requires MPI 3.0 or newer."));
+#  endif
+#else
+          (void)new_alloc_size;
+          (void)allocated_size;
+          (void)data;
+          (void)shared_memory_pattern;
+          (void)shared_memory_arrays;
+          AssertThrow(false, ExcNeedsMPI());
+#endif
+        }
+
         static void
         import(
           const ::dealii::LinearAlgebra::ReadWriteVector<Number> &V,
@@ -256,6 +359,18 @@ namespace LinearAlgebra
             }
         }
 
+        static void
+        resize_val(const types::global_dof_index /*new_alloc_size*/,
+                   types::global_dof_index & /*allocated_size*/,
+                   ::dealii::MemorySpace::
+                     MemorySpaceData<Number, ::dealii::MemorySpace::CUDA>
+                       & /*data*/,
+                   const SharedMemoryPattern & /*shared_memory_pattern*/,
+                   std::vector<ArrayView<const Number>> & /*arrays*/)
+        {
+          Assert(false, ExcNotImplemented());
+        }
+
         static void
         import(const ReadWriteVector<Number> &V,
                VectorOperation::values        operation,
@@ -403,9 +518,28 @@ namespace LinearAlgebra
     void
     Vector<Number, MemorySpaceType>::resize_val(const size_type new_alloc_size)
     {
-      internal::la_parallel_vector_templates_functions<
-        Number,
-        MemorySpaceType>::resize_val(new_alloc_size, allocated_size, data);
+      if (shared_memory_pattern != nullptr)
+        internal::la_parallel_vector_templates_functions<Number,
+                                                         MemorySpaceType>::
+          resize_val(new_alloc_size,
+                     allocated_size,
+                     data,
+                     *shared_memory_pattern,
+                     shared_memory_arrays);
+      else
+        {
+          // a vector that leaves the shared-memory mode must release its
+          // window (collectively) rather than keep it as local storage
+          if (shared_memory_arrays.size() > 0)
+            {
+              data.values.reset();
+              allocated_size = 0;
+              shared_memory_arrays.clear();
+            }
+          internal::la_parallel_vector_templates_functions<
+            Number,
+            MemorySpaceType>::resize_val(new_alloc_size, allocated_size, data);
+        }
 
       thread_loop_partitioner =
         std::make_shared<::dealii::parallel::internal::TBBPartitioner>();
@@ -421,6 +555,7 @@ namespace LinearAlgebra
       clear_mpi_requests();
 
       // check whether we need to reallocate
+      shared_memory_pattern.reset();
       resize_val(size);
 
       // delete previous content in import data
@@ -453,9 +588,11 @@ namespace LinearAlgebra
       // different (check only if the are allocated
       // differently, not if the actual data is
       // different)
-      if (partitioner.get() != v.partitioner.get())
+      if (partitioner.get() != v.partitioner.get() ||
+          shared_memory_pattern != v.shared_memory_pattern)
         {
-          partitioner = v.partitioner;
+          partitioner           = v.partitioner;
+          shared_memory_pattern = v.shared_memory_pattern;
           const size_type new_allocated_size =
             partitioner->local_size() + partitioner->n_ghost_indices();
           resize_val(new_allocated_size);
@@ -516,6 +653,7 @@ namespace LinearAlgebra
     {
       clear_mpi_requests();
       partitioner = partitioner_in;
+      shared_memory_pattern.reset();
 
       // set vector size and allocate memory
       const size_type new_allocated_size =
@@ -538,6 +676,36 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number, typename MemorySpaceType>
+    void
+    Vector<Number, MemorySpaceType>::reinit(
+      const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner_in,
+      const MPI_Comm &                                          comm_sm)
+    {
+      Assert(
+        (std::is_same<MemorySpaceType, ::dealii::MemorySpace::Host>::value),
+        ExcMessage(
+          "The shared-memory mode is only available for MemorySpace::Host."));
+
+      clear_mpi_requests();
+      partitioner = partitioner_in;
+      shared_memory_pattern =
+        std::make_shared<internal::SharedMemoryPattern>(partitioner, comm_sm);
+
+      const size_type new_allocated_size =
+        partitioner->local_size() + partitioner->n_ghost_indices();
+      resize_val(new_allocated_size);
+
+      this->operator=(Number());
+
+      import_data.values.reset();
+      import_data.values_dev.reset();
+
+      vector_is_ghosted = false;
+    }
+
+
+
     template <typename Number, typename MemorySpaceType>
     Vector<Number, MemorySpaceType>::Vector()
       : partitioner(new Utilities::MPI::Partitioner())
@@ -801,16 +969,27 @@ namespace LinearAlgebra
       const unsigned int                communication_channel,
       ::dealii::VectorOperation::values operation)
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::compress_start");
+      Instrumentation::Scope scope(region);
+
       AssertIndexRange(communication_channel, 200);
       Assert(vector_is_ghosted == false,
              ExcMessage("Cannot call compress() on a ghosted vector"));
 
 #ifdef DEAL_II_WITH_MPI
+      // in the shared-memory mode, only the ghost entries owned by processes
+      // on other nodes are exchanged through MPI
+      const Utilities::MPI::Partitioner &mpi_partitioner =
+        shared_memory_pattern != nullptr ?
+          *shared_memory_pattern->get_remote_partitioner() :
+          *partitioner;
+
       // make this function thread safe
       std::lock_guard<std::mutex> lock(mutex);
 
       // allocate import_data in case it is not set up yet
-      if (partitioner->n_import_indices() > 0)
+      if (mpi_partitioner.n_import_indices() > 0)
         {
 #  if defined(DEAL_II_COMPILER_CUDA_AWARE) && \
     defined(DEAL_II_MPI_WITH_CUDA_SUPPORT)
@@ -819,7 +998,7 @@ namespace LinearAlgebra
               if (import_data.values_dev == nullptr)
                 import_data.values_dev.reset(
                   Utilities::CUDA::allocate_device_data<Number>(
-                    partitioner->n_import_indices()));
+                    mpi_partitioner.n_import_indices()));
             }
           else
 #  endif
@@ -836,7 +1015,7 @@ namespace LinearAlgebra
                   Utilities::System::posix_memalign(
                     reinterpret_cast<void **>(&new_val),
                     64,
-                    sizeof(Number) * partitioner->n_import_indices());
+                    sizeof(Number) * mpi_partitioner.n_import_indices());
                   import_data.values.reset(new_val);
                 }
             }
@@ -866,31 +1045,42 @@ namespace LinearAlgebra
         }
 #  endif
 
+      // the ghost entries owned by processes on the same node are combined
+      // with the owned entries directly. this must happen before the
+      // exchange through MPI, which moves the remote ghost entries within
+      // the array of ghost entries
+      if (shared_memory_pattern != nullptr)
+        shared_memory_pattern->import_from_ghosts(
+          operation,
+          shared_memory_arrays,
+          ArrayView<Number>(data.values.get(), allocated_size));
+
 #  if defined(DEAL_II_COMPILER_CUDA_AWARE) && \
     defined(DEAL_II_MPI_WITH_CUDA_SUPPORT)
       if (std::is_same<MemorySpaceType, dealii::MemorySpace::CUDA>::value)
         {
-          partitioner->import_from_ghosted_array_start(
+          mpi_partitioner.import_from_ghosted_array_start(
             operation,
             communication_channel,
             ArrayView<Number, MemorySpace::CUDA>(
               data.values_dev.get() + partitioner->local_size(),
               partitioner->n_ghost_indices()),
             ArrayView<Number, MemorySpace::CUDA>(
-              import_data.values_dev.get(), partitioner->n_import_indices()),
+              import_data.values_dev.get(),
+              mpi_partitioner.n_import_indices()),
             compress_requests);
         }
       else
 #  endif
         {
-          partitioner->import_from_ghosted_array_start(
+          mpi_partitioner.import_from_ghosted_array_start(
             operation,
             communication_channel,
             ArrayView<Number, MemorySpace::Host>(
               data.values.get() + partitioner->local_size(),
               partitioner->n_ghost_indices()),
             ArrayView<Number, MemorySpace::Host>(
-              import_data.values.get(), partitioner->n_import_indices()),
+              import_data.values.get(), mpi_partitioner.n_import_indices()),
             compress_requests);
         }
 #else
@@ -906,6 +1096,10 @@ namespace LinearAlgebra
     Vector<Number, MemorySpaceType>::compress_finish(
       ::dealii::VectorOperation::values operation)
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::compress_finish");
+      Instrumentation::Scope scope(region);
+
 #ifdef DEAL_II_WITH_MPI
       vector_is_ghosted = false;
 
@@ -915,18 +1109,25 @@ namespace LinearAlgebra
 
       // make this function thread safe
       std::lock_guard<std::mutex> lock(mutex);
+
+      const Utilities::MPI::Partitioner &mpi_partitioner =
+        shared_memory_pattern != nullptr ?
+          *shared_memory_pattern->get_remote_partitioner() :
+          *partitioner;
+
 #  if defined(DEAL_II_COMPILER_CUDA_AWARE) && \
     defined(DEAL_II_MPI_WITH_CUDA_SUPPORT)
       if (std::is_same<MemorySpaceType, MemorySpace::CUDA>::value)
         {
-          Assert(partitioner->n_import_indices() == 0 ||
+          Assert(mpi_partitioner.n_import_indices() == 0 ||
                    import_data.values_dev != nullptr,
                  ExcNotInitialized());
-          partitioner
-            ->import_from_ghosted_array_finish<Number, MemorySpace::CUDA>(
+          mpi_partitioner
+            .import_from_ghosted_array_finish<Number, MemorySpace::CUDA>(
               operation,
               ArrayView<const Number, MemorySpace::CUDA>(
-                import_data.values_dev.get(), partitioner->n_import_indices()),
+                import_data.values_dev.get(),
+                mpi_partitioner.n_import_indices()),
               ArrayView<Number, MemorySpace::CUDA>(data.values_dev.get(),
                                                    partitioner->local_size()),
               ArrayView<Number, MemorySpace::CUDA>(
@@ -937,14 +1138,14 @@ namespace LinearAlgebra
       else
 #  endif
         {
-          Assert(partitioner->n_import_indices() == 0 ||
+          Assert(mpi_partitioner.n_import_indices() == 0 ||
                    import_data.values != nullptr,
                  ExcNotInitialized());
-          partitioner
-            ->import_from_ghosted_array_finish<Number, MemorySpace::Host>(
+          mpi_partitioner
+            .import_from_ghosted_array_finish<Number, MemorySpace::Host>(
               operation,
               ArrayView<const Number, MemorySpace::Host>(
-                import_data.values.get(), partitioner->n_import_indices()),
+                import_data.values.get(), mpi_partitioner.n_import_indices()),
               ArrayView<Number, MemorySpace::Host>(data.values.get(),
                                                    partitioner->local_size()),
               ArrayView<Number, MemorySpace::Host>(
@@ -953,6 +1154,13 @@ namespace LinearAlgebra
               compress_requests);
         }
 
+      // the partitioner only zeros the ghost entries it exchanged, so clear
+      // the ghost entries owned on this node as well
+      if (shared_memory_pattern != nullptr)
+        std::fill_n(data.values.get() + partitioner->local_size(),
+                    partitioner->n_ghost_indices(),
+                    Number());
+
 #  if defined DEAL_II_COMPILER_CUDA_AWARE && \
     !defined  DEAL_II_MPI_WITH_CUDA_SUPPORT
       // The communication is done on the host, so we need to
@@ -981,18 +1189,31 @@ namespace LinearAlgebra
     Vector<Number, MemorySpaceType>::update_ghost_values_start(
       const unsigned int communication_channel) const
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::update_ghost_values_start");
+      Instrumentation::Scope scope(region);
+
       AssertIndexRange(communication_channel, 200);
 #ifdef DEAL_II_WITH_MPI
-      // nothing to do when we neither have import nor ghost indices.
-      if (partitioner->n_ghost_indices() == 0 &&
-          partitioner->n_import_indices() == 0)
+      // in the shared-memory mode, only the ghost entries owned by processes
+      // on other nodes are exchanged through MPI
+      const Utilities::MPI::Partitioner &mpi_partitioner =
+        shared_memory_pattern != nullptr ?
+          *shared_memory_pattern->get_remote_partitioner() :
+          *partitioner;
+
+      // nothing to do when we neither have import nor ghost indices. the
+      // ghost entries owned on the same node are copied in
+      // update_ghost_values_finish()
+      if (mpi_partitioner.n_ghost_indices() == 0 &&
+          mpi_partitioner.n_import_indices() == 0)
         return;
 
       // make this function thread safe
       std::lock_guard<std::mutex> lock(mutex);
 
       // allocate import_data in case it is not set up yet
-      if (partitioner->n_import_indices() > 0)
+      if (mpi_partitioner.n_import_indices() > 0)
         {
 #  if defined(DEAL_II_COMPILER_CUDA_AWARE) && \
     defined(DEAL_II_MPI_WITH_CUDA_SUPPORT)
@@ -1003,7 +1224,7 @@ namespace LinearAlgebra
           if (import_data.values_dev == nullptr)
             import_data.values_dev.reset(
               Utilities::CUDA::allocate_device_data<Number>(
-                partitioner->n_import_indices()));
+                mpi_partitioner.n_import_indices()));
 #  else
 #    ifdef DEAL_II_MPI_WITH_CUDA_SUPPORT
           static_assert(
@@ -1016,7 +1237,7 @@ namespace LinearAlgebra
               Utilities::System::posix_memalign(
                 reinterpret_cast<void **>(&new_val),
                 64,
-                sizeof(Number) * partitioner->n_import_indices());
+                sizeof(Number) * mpi_partitioner.n_import_indices());
               import_data.values.reset(new_val);
             }
 #  endif
@@ -1044,23 +1265,23 @@ namespace LinearAlgebra
 
 #  if !(defined(DEAL_II_COMPILER_CUDA_AWARE) && \
         defined(DEAL_II_MPI_WITH_CUDA_SUPPORT))
-      partitioner->export_to_ghosted_array_start<Number, MemorySpace::Host>(
+      mpi_partitioner.export_to_ghosted_array_start<Number, MemorySpace::Host>(
         communication_channel,
         ArrayView<const Number, MemorySpace::Host>(data.values.get(),
                                                    partitioner->local_size()),
-        ArrayView<Number, MemorySpace::Host>(import_data.values.get(),
-                                             partitioner->n_import_indices()),
+        ArrayView<Number, MemorySpace::Host>(
+          import_data.values.get(), mpi_partitioner.n_import_indices()),
         ArrayView<Number, MemorySpace::Host>(data.values.get() +
                                                partitioner->local_size(),
                                              partitioner->n_ghost_indices()),
         update_ghost_values_requests);
 #  else
-      partitioner->export_to_ghosted_array_start<Number, MemorySpace::CUDA>(
+      mpi_partitioner.export_to_ghosted_array_start<Number, MemorySpace::CUDA>(
         communication_channel,
         ArrayView<const Number, MemorySpace::CUDA>(data.values_dev.get(),
                                                    partitioner->local_size()),
-        ArrayView<Number, MemorySpace::CUDA>(import_data.values_dev.get(),
-                                             partitioner->n_import_indices()),
+        ArrayView<Number, MemorySpace::CUDA>(
+          import_data.values_dev.get(), mpi_partitioner.n_import_indices()),
         ArrayView<Number, MemorySpace::CUDA>(data.values_dev.get() +
                                                partitioner->local_size(),
                                              partitioner->n_ghost_indices()),
@@ -1078,11 +1299,20 @@ namespace LinearAlgebra
     void
     Vector<Number, MemorySpaceType>::update_ghost_values_finish() const
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::update_ghost_values_finish");
+      Instrumentation::Scope scope(region);
+
 #ifdef DEAL_II_WITH_MPI
+      const Utilities::MPI::Partitioner &mpi_partitioner =
+        shared_memory_pattern != nullptr ?
+          *shared_memory_pattern->get_remote_partitioner() :
+          *partitioner;
+
       // wait for both sends and receives to complete, even though only
       // receives are really necessary. this gives (much) better performance
-      AssertDimension(partitioner->ghost_targets().size() +
-                        partitioner->import_targets().size(),
+      AssertDimension(mpi_partitioner.ghost_targets().size() +
+                        mpi_partitioner.import_targets().size(),
                       update_ghost_values_requests.size());
       if (update_ghost_values_requests.size() > 0)
         {
@@ -1091,13 +1321,13 @@ namespace LinearAlgebra
 
 #  if !(defined(DEAL_II_COMPILER_CUDA_AWARE) && \
         defined(DEAL_II_MPI_WITH_CUDA_SUPPORT))
-          partitioner->export_to_ghosted_array_finish(
+          mpi_partitioner.export_to_ghosted_array_finish(
             ArrayView<Number, MemorySpace::Host>(
               data.values.get() + partitioner->local_size(),
               partitioner->n_ghost_indices()),
             update_ghost_values_requests);
 #  else
-          partitioner->export_to_ghosted_array_finish(
+          mpi_partitioner.export_to_ghosted_array_finish(
             ArrayView<Number, MemorySpace::CUDA>(
               data.values_dev.get() + partitioner->local_size(),
               partitioner->n_ghost_indices()),
@@ -1105,6 +1335,17 @@ namespace LinearAlgebra
 #  endif
         }
 
+      // copy the ghost entries owned by processes on the same node. this
+      // must happen after the exchange through MPI, which uses the array of
+      // ghost entries as receive buffer
+      if (shared_memory_pattern != nullptr)
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          shared_memory_pattern->update_ghost_values(
+            shared_memory_arrays,
+            ArrayView<Number>(data.values.get(), allocated_size));
+        }
+
 #  if defined DEAL_II_COMPILER_CUDA_AWARE && \
     !defined  DEAL_II_MPI_WITH_CUDA_SUPPORT
       // The communication is done on the host, so we need to
@@ -1254,6 +1495,8 @@ namespace LinearAlgebra
 #endif
 
       std::swap(partitioner, v.partitioner);
+      std::swap(shared_memory_pattern, v.shared_memory_pattern);
+      std::swap(shared_memory_arrays, v.shared_memory_arrays);
       std::swap(thread_loop_partitioner, v.thread_loop_partitioner);
       std::swap(allocated_size, v.allocated_size);
       std::swap(data, v.data);
@@ -1373,6 +1616,10 @@ namespace LinearAlgebra
       const Number                     a,
       const VectorSpaceVector<Number> &vv)
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::add");
+      Instrumentation::Scope scope(region);
+
       // Downcast. Throws an exception if invalid.
       using VectorType = Vector<Number, MemorySpaceType>;
       Assert(dynamic_cast<const VectorType *>(&vv) != nullptr,
@@ -1413,6 +1660,10 @@ namespace LinearAlgebra
                                          const Number                     b,
                                          const VectorSpaceVector<Number> &ww)
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::add");
+      Instrumentation::Scope scope(region);
+
       // Downcast. Throws an exception if invalid.
       using VectorType = Vector<Number, MemorySpaceType>;
       Assert(dynamic_cast<const VectorType *>(&vv) != nullptr,
@@ -1483,6 +1734,10 @@ namespace LinearAlgebra
       const Number                     a,
       const VectorSpaceVector<Number> &vv)
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::sadd");
+      Instrumentation::Scope scope(region);
+
       // Downcast. Throws an exception if invalid.
       using VectorType = Vector<Number, MemorySpaceType>;
       Assert((dynamic_cast<const VectorType *>(&vv) != nullptr),
@@ -1523,6 +1778,10 @@ namespace LinearAlgebra
     Vector<Number, MemorySpaceType> &
     Vector<Number, MemorySpaceType>::operator*=(const Number factor)
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::scale");
+      Instrumentation::Scope scope(region);
+
       AssertIsFinite(factor);
 
       dealii::internal::VectorOperations::
@@ -1551,6 +1810,10 @@ namespace LinearAlgebra
     void
     Vector<Number, MemorySpaceType>::scale(const VectorSpaceVector<Number> &vv)
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::scale");
+      Instrumentation::Scope scope(region);
+
       // Downcast. Throws an exception if invalid.
       using VectorType = Vector<Number, MemorySpaceType>;
       Assert(dynamic_cast<const VectorType *>(&vv) != nullptr,
@@ -1574,6 +1837,10 @@ namespace LinearAlgebra
     Vector<Number, MemorySpaceType>::equ(const Number                     a,
                                          const VectorSpaceVector<Number> &vv)
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::equ");
+      Instrumentation::Scope scope(region);
+
       // Downcast. Throws an exception if invalid.
       using VectorType = Vector<Number, MemorySpaceType>;
       Assert(dynamic_cast<const VectorType *>(&vv) != nullptr,
@@ -1625,6 +1892,10 @@ namespace LinearAlgebra
     Number Vector<Number, MemorySpaceType>::
            operator*(const VectorSpaceVector<Number> &vv) const
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::inner_product");
+      Instrumentation::Scope scope(region);
+
       // Downcast. Throws an exception if invalid.
       using VectorType = Vector<Number, MemorySpaceType>;
       Assert((dynamic_cast<const VectorType *>(&vv) != nullptr),
@@ -1726,6 +1997,10 @@ namespace LinearAlgebra
     typename Vector<Number, MemorySpaceType>::real_type
     Vector<Number, MemorySpaceType>::norm_sqr() const
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::norm_sqr");
+      Instrumentation::Scope scope(region);
+
       real_type local_result = norm_sqr_local();
       if (partitioner->n_mpi_processes() > 1)
         return Utilities::MPI::sum(local_result,
@@ -1835,6 +2110,10 @@ namespace LinearAlgebra
       const VectorSpaceVector<Number> &vv,
       const VectorSpaceVector<Number> &ww)
     {
+      static const Instrumentation::Region region(
+        "LinearAlgebra::distributed::Vector::add_and_dot");
+      Instrumentation::Scope scope(region);
+
       // Downcast. Throws an exception if invalid.
       using VectorType = Vector<Number, MemorySpaceType>;
       Assert((dynamic_cast<const VectorType *>(&vv) != nullptr),
@@ -1890,6 +2169,11 @@ namespace LinearAlgebra
       if (import_data.values != nullptr || import_data.values_dev != nullptr)
         memory += (static_cast<std::size_t>(partitioner->n_import_indices()) *
                    sizeof(Number));
+      if (shared_memory_pattern.use_count() > 0)
+        memory += shared_memory_pattern->memory_consumption() /
+                    shared_memory_pattern.use_count() +
+                  shared_memory_arrays.capacity() *
+                    sizeof(ArrayView<const Number>);
       return memory;
     }
 
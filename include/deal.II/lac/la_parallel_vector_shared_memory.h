@@ -0,0 +1,316 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_la_parallel_vector_shared_memory_h
+#define dealii_la_parallel_vector_shared_memory_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/base/partitioner.templates.h>
+
+#include <deal.II/lac/vector_operation.h>
+
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    namespace internal
+    {
+      /**
+       * The communication pattern of a LinearAlgebra::distributed::Vector
+       * whose entries on the processes of a compute node are stored in a
+       * common MPI-3 shared-memory window, see the
+       * LinearAlgebra::distributed::Vector::reinit() function that takes a
+       * shared-memory communicator.
+       *
+       * The ghost indices of the partitioner are split into two groups: Ghost
+       * entries owned by a process of the shared-memory communicator are
+       * copied directly from the array of that process, whereas ghost entries
+       * owned by processes on other nodes are exchanged through MPI messages.
+       * The latter use the partitioner returned by get_remote_partitioner(),
+       * which has the same locally owned indices as the original partitioner
+       * but only the remote ghost indices, with the original ghost indices
+       * as the larger ghost index set. The vector can therefore keep the
+       * layout of its ghost entries.
+       *
+       * The direct copies are framed by an <code>MPI_Barrier</code> on the
+       * shared-memory communicator, so that no process reads data another
+       * process is still writing. This makes update_ghost_values() and
+       * import_from_ghosts() collective operations of the shared-memory
+       * communicator.
+       */
+      class SharedMemoryPattern
+      {
+      public:
+        /**
+         * Constructor. Set up the pattern for the given @p partitioner,
+         * treating all processes of @p communicator_sm as processes that can
+         * access each other's memory. The processes of @p communicator_sm
+         * must be a subset of the processes of the communicator of the
+         * partitioner, and the function is collective over the latter.
+         */
+        SharedMemoryPattern(
+          const std::shared_ptr<const Utilities::MPI::Partitioner>
+            &             partitioner,
+          const MPI_Comm &communicator_sm);
+
+        /**
+         * Return the shared-memory communicator passed to the constructor.
+         */
+        const MPI_Comm &
+        get_sm_mpi_communicator() const;
+
+        /**
+         * Return the number of entries, locally owned plus ghost, each
+         * process of the shared-memory communicator stores.
+         */
+        const std::vector<unsigned int> &
+        get_sm_array_sizes() const;
+
+        /**
+         * Return the partitioner that describes the ghost entries that are
+         * exchanged through MPI messages.
+         */
+        const std::shared_ptr<const Utilities::MPI::Partitioner> &
+        get_remote_partitioner() const;
+
+        /**
+         * Copy the ghost entries owned by processes of the shared-memory
+         * communicator from the arrays of these processes, given by
+         * @p sm_arrays, into @p array, which holds the locally owned entries
+         * of this process followed by its ghost entries.
+         */
+        template <typename Number>
+        void
+        update_ghost_values(
+          const std::vector<ArrayView<const Number>> &sm_arrays,
+          const ArrayView<Number> &                   array) const;
+
+        /**
+         * Combine the locally owned entries in @p array with the ghost
+         * entries of the processes of the shared-memory communicator that
+         * refer to them, according to @p operation. The ghost entries
+         * themselves are left unchanged.
+         */
+        template <typename Number>
+        void
+        import_from_ghosts(
+          const VectorOperation::values               operation,
+          const std::vector<ArrayView<const Number>> &sm_arrays,
+          const ArrayView<Number> &                   array) const;
+
+        /**
+         * Return the memory consumption of this object in bytes.
+         */
+        std::size_t
+        memory_consumption() const;
+
+      private:
+        /**
+         * A contiguous range of entries copied between the array of this
+         * process and the array of another process of the shared-memory
+         * communicator.
+         */
+        struct Chunk
+        {
+          /**
+           * The rank of the other process within the shared-memory
+           * communicator.
+           */
+          unsigned int sm_rank;
+
+          /**
+           * The first position within the array of this process.
+           */
+          unsigned int position;
+
+          /**
+           * The first position within the array of the other process.
+           */
+          unsigned int sm_position;
+
+          /**
+           * The number of entries.
+           */
+          unsigned int size;
+        };
+
+        /**
+         * The shared-memory communicator.
+         */
+        MPI_Comm communicator_sm;
+
+        /**
+         * The number of entries of the array of each process of the
+         * shared-memory communicator.
+         */
+        std::vector<unsigned int> sm_array_sizes;
+
+        /**
+         * The partitioner for the ghost entries owned on other nodes.
+         */
+        std::shared_ptr<const Utilities::MPI::Partitioner> remote_partitioner;
+
+        /**
+         * The ghost entries of this process owned by other processes of the
+         * shared-memory communicator.
+         */
+        std::vector<Chunk> ghost_chunks;
+
+        /**
+         * The ghost entries of other processes of the shared-memory
+         * communicator owned by this process.
+         */
+        std::vector<Chunk> import_chunks;
+      };
+
+
+
+      /* ---------------------- inline functions ---------------------- */
+
+#ifndef DOXYGEN
+
+      inline const MPI_Comm &
+      SharedMemoryPattern::get_sm_mpi_communicator() const
+      {
+        return communicator_sm;
+      }
+
+
+
+      inline const std::vector<unsigned int> &
+      SharedMemoryPattern::get_sm_array_sizes() const
+      {
+        return sm_array_sizes;
+      }
+
+
+
+      inline const std::shared_ptr<const Utilities::MPI::Partitioner> &
+      SharedMemoryPattern::get_remote_partitioner() const
+      {
+        return remote_partitioner;
+      }
+
+
+
+      template <typename Number>
+      void
+      SharedMemoryPattern::update_ghost_values(
+        const std::vector<ArrayView<const Number>> &sm_arrays,
+        const ArrayView<Number> &                   array) const
+      {
+#  ifdef DEAL_II_WITH_MPI
+        AssertDimension(sm_arrays.size(), sm_array_sizes.size());
+
+        // all processes must have finished writing their locally owned
+        // entries before we read them
+        int ierr = MPI_Barrier(communicator_sm);
+        AssertThrowMPI(ierr);
+
+        for (const Chunk &chunk : ghost_chunks)
+          {
+            AssertIndexRange(chunk.sm_position + chunk.size,
+                             sm_arrays[chunk.sm_rank].size() + 1);
+            AssertIndexRange(chunk.position + chunk.size, array.size() + 1);
+            std::copy(sm_arrays[chunk.sm_rank].data() + chunk.sm_position,
+                      sm_arrays[chunk.sm_rank].data() + chunk.sm_position +
+                        chunk.size,
+                      array.data() + chunk.position);
+          }
+
+        // the owners must not change their entries before all processes
+        // are done reading them
+        ierr = MPI_Barrier(communicator_sm);
+        AssertThrowMPI(ierr);
+#  else
+        (void)sm_arrays;
+        (void)array;
+#  endif
+      }
+
+
+
+      template <typename Number>
+      void
+      SharedMemoryPattern::import_from_ghosts(
+        const VectorOperation::values               operation,
+        const std::vector<ArrayView<const Number>> &sm_arrays,
+        const ArrayView<Number> &                   array) const
+      {
+#  ifdef DEAL_II_WITH_MPI
+        AssertDimension(sm_arrays.size(), sm_array_sizes.size());
+
+        // for insert, the ghost entries are not used, just like in the
+        // exchange through MPI in optimized mode
+        if (operation == VectorOperation::insert)
+          return;
+
+        int ierr = MPI_Barrier(communicator_sm);
+        AssertThrowMPI(ierr);
+
+        for (const Chunk &chunk : import_chunks)
+          {
+            AssertIndexRange(chunk.sm_position + chunk.size,
+                             sm_arrays[chunk.sm_rank].size() + 1);
+            AssertIndexRange(chunk.position + chunk.size, array.size() + 1);
+            const Number *source =
+              sm_arrays[chunk.sm_rank].data() + chunk.sm_position;
+            Number *destination = array.data() + chunk.position;
+            if (operation == VectorOperation::add)
+              for (unsigned int i = 0; i < chunk.size; ++i)
+                destination[i] += source[i];
+            else if (operation == VectorOperation::min)
+              for (unsigned int i = 0; i < chunk.size; ++i)
+                destination[i] =
+                  Utilities::MPI::internal::get_min(source[i],
+                                                    destination[i]);
+            else if (operation == VectorOperation::max)
+              for (unsigned int i = 0; i < chunk.size; ++i)
+                destination[i] =
+                  Utilities::MPI::internal::get_max(source[i],
+                                                    destination[i]);
+            else
+              Assert(false, ExcNotImplemented());
+          }
+
+        // the ghost entries must not be zeroed before all owners are done
+        // reading them
+        ierr = MPI_Barrier(communicator_sm);
+        AssertThrowMPI(ierr);
+#  else
+        (void)operation;
+        (void)sm_arrays;
+        (void)array;
+#  endif
+      }
+
+#endif // DOXYGEN
+
+    } // namespace internal
+  }   // namespace distributed
+} // namespace LinearAlgebra
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -20,7 +20,10 @@
 #include <deal.II/base/config.h>
 
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/instrumentation.h>
 #include <deal.II/base/logstream.h>
+#include <deal.II/base/memory_space.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/subscriptor.h>
 
 #include <deal.II/lac/solver.h>
@@ -28,12 +31,25 @@
 #include <deal.II/lac/tridiagonal_matrix.h>
 
 #include <cmath>
+#include <functional>
+#include <mutex>
+#include <type_traits>
 
 DEAL_II_NAMESPACE_OPEN
 
 // forward declaration
 #ifndef DOXYGEN
 class PreconditionIdentity;
+template <typename VectorType>
+class DiagonalMatrix;
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename Number, typename MemorySpace>
+    class Vector;
+  }
+} // namespace LinearAlgebra
 #endif
 
 
@@ -90,6 +106,53 @@ class PreconditionIdentity;
  * The solve() function of this class uses the mechanism described in the
  * Solver base class to determine convergence. This mechanism can also be used
  * to observe the progress of the iteration.
+ *
+ *
+ * <h3>Fused vector operations with matrix-free operators</h3>
+ *
+ * In the basic form of the algorithm, every iteration reads and writes the
+ * vectors of the method in separate steps: once in the matrix-vector
+ * product, once for the update of the search direction, once for the update
+ * of the solution and the residual, and once for each inner product. For
+ * operators with a low arithmetic intensity such as the matrix-free ones
+ * based on MatrixFree, the vector operations then make up a considerable
+ * part of the run time. If the vector type is
+ * LinearAlgebra::distributed::Vector on the host, the preconditioner is
+ * either PreconditionIdentity or a DiagonalMatrix, and the matrix provides a
+ * function
+ * @code
+ * void vmult(VectorType &dst,
+ *            const VectorType &src,
+ *            const std::function<void(const unsigned int, const unsigned int)>
+ *              &operation_before_matrix_vector_product,
+ *            const std::function<void(const unsigned int, const unsigned int)>
+ *              &operation_after_matrix_vector_product) const;
+ * @endcode
+ * this class instead merges the vector operations into the matrix-vector
+ * product. The two function objects are called on ranges of locally owned
+ * vector entries, passed as half-open range of local indices. The matrix
+ * must call the first operation on a range of entries before any of those
+ * entries of @p src are read, and the second operation once all
+ * contributions to those entries in @p dst have been computed. The matrix is
+ * itself responsible for setting @p dst to zero before adding into it. A
+ * natural implementation forwards the two function objects to the
+ * MatrixFree::cell_loop() variant of the same signature, which schedules
+ * them such that the vector entries of a cell are processed just before and
+ * after the cell is visited, i.e., while they are still in cache. Any
+ * implementation that calls the first operation on all entries before the
+ * product and the second one on all entries after the product gives the
+ * same result.
+ *
+ * In this setting, the update of the search direction is done in the
+ * operation before the product, the inner product between the search
+ * direction and the result of the product in the operation after the
+ * product, and the updates of the solution and the residual are merged with
+ * the two inner products needed for the next iteration into a single sweep
+ * through the vectors. This reduces the memory transfer per iteration
+ * considerably, while the iterates are the same as in the basic algorithm up
+ * to roundoff. Note that the vector @p d passed to print_vectors() lags
+ * behind by one update in this case, as it is only updated within the next
+ * matrix-vector product.
  */
 template <typename VectorType = Vector<double>>
 class SolverCG : public SolverBase<VectorType>
@@ -312,6 +375,406 @@ SolverCG<VectorType>::compute_eigs_and_cond(
 
 
 
+namespace internal
+{
+  namespace SolverCG
+  {
+    // a helper type-trait that leverage SFINAE to figure out if MatrixType
+    // has a vmult function taking two additional std::function objects that
+    // are called on ranges of vector entries before and after the
+    // matrix-vector product
+    template <typename MatrixType, typename VectorType>
+    struct has_vmult_functions
+    {
+    private:
+      static void
+      detect(...);
+
+      template <typename U>
+      static decltype(
+        std::declval<U const>().vmult(
+          std::declval<VectorType &>(),
+          std::declval<const VectorType &>(),
+          std::declval<
+            const std::function<void(const unsigned int, const unsigned int)>
+              &>(),
+          std::declval<
+            const std::function<void(const unsigned int, const unsigned int)>
+              &>()),
+        true)
+      detect(const U &);
+
+    public:
+      static const bool value =
+        !std::is_same<void,
+                      decltype(detect(std::declval<MatrixType>()))>::value;
+    };
+
+    // We need to have a separate declaration for static const members
+    template <typename MatrixType, typename VectorType>
+    const bool has_vmult_functions<MatrixType, VectorType>::value;
+
+
+
+    // a helper type-trait that checks if the preconditioner only scales the
+    // vector entries individually, such that it can be merged into loops
+    // over the vector entries
+    template <typename PreconditionerType, typename VectorType>
+    struct is_diagonal_preconditioner
+    {
+      static const bool value =
+        std::is_same<PreconditionerType, PreconditionIdentity>::value ||
+        std::is_same<PreconditionerType, DiagonalMatrix<VectorType>>::value;
+    };
+
+    template <typename PreconditionerType, typename VectorType>
+    const bool
+      is_diagonal_preconditioner<PreconditionerType, VectorType>::value;
+
+
+
+    // return a pointer to the diagonal entries of a preconditioner of
+    // diagonal type, or a null pointer for the identity
+    template <typename Number>
+    inline const Number *
+    get_diagonal_entries(const PreconditionIdentity &)
+    {
+      return nullptr;
+    }
+
+    template <typename Number, typename VectorType>
+    inline const Number *
+    get_diagonal_entries(const DiagonalMatrix<VectorType> &preconditioner)
+    {
+      return preconditioner.get_vector().begin();
+    }
+
+
+
+    // the vectors and scalars shared by the different variants of the
+    // iteration
+    template <typename VectorType,
+              typename MatrixType,
+              typename PreconditionerType>
+    struct IterationWorkerBase
+    {
+      using Number = typename VectorType::value_type;
+
+      const MatrixType &                         A;
+      const PreconditionerType &                 preconditioner;
+      VectorType &                               x;
+      typename VectorMemory<VectorType>::Pointer g_pointer;
+      typename VectorMemory<VectorType>::Pointer d_pointer;
+      typename VectorMemory<VectorType>::Pointer h_pointer;
+      VectorType &                               g;
+      VectorType &                               d;
+      VectorType &                               h;
+      Number                                     alpha;
+      Number                                     beta;
+      Number                                     gh;
+      double                                     residual_norm;
+
+      IterationWorkerBase(const MatrixType &        A,
+                          const PreconditionerType &preconditioner,
+                          VectorMemory<VectorType> &memory,
+                          VectorType &              x)
+        : A(A)
+        , preconditioner(preconditioner)
+        , x(x)
+        , g_pointer(memory)
+        , d_pointer(memory)
+        , h_pointer(memory)
+        , g(*g_pointer)
+        , d(*d_pointer)
+        , h(*h_pointer)
+        , alpha(0)
+        , beta(0)
+        , gh(0)
+        , residual_norm(0)
+      {}
+
+      // resize the vectors, but do not set the values since they'd be
+      // overwritten soon anyway. Then compute the residual; if the vector is
+      // zero, short-circuit the full computation
+      void
+      startup(const VectorType &b)
+      {
+        g.reinit(x, true);
+        d.reinit(x, true);
+        h.reinit(x, true);
+
+        if (!x.all_zero())
+          {
+            A.vmult(g, x);
+            g.add(-1., b);
+          }
+        else
+          g.equ(-1., b);
+        residual_norm = g.l2_norm();
+      }
+    };
+
+
+
+    // the basic variant of the iteration, working on the vectors as a whole
+    template <typename VectorType,
+              typename MatrixType,
+              typename PreconditionerType,
+              typename = int>
+    struct IterationWorker
+      : public IterationWorkerBase<VectorType, MatrixType, PreconditionerType>
+    {
+      using BaseClass =
+        IterationWorkerBase<VectorType, MatrixType, PreconditionerType>;
+      using Number = typename BaseClass::Number;
+
+      IterationWorker(const MatrixType &        A,
+                      const PreconditionerType &preconditioner,
+                      VectorMemory<VectorType> &memory,
+                      VectorType &              x)
+        : BaseClass(A, preconditioner, memory, x)
+      {}
+
+      void
+      initialize_direction()
+      {
+        if (std::is_same<PreconditionerType, PreconditionIdentity>::value ==
+            false)
+          {
+            this->preconditioner.vmult(this->h, this->g);
+
+            this->d.equ(-1., this->h);
+
+            this->gh = this->g * this->h;
+          }
+        else
+          {
+            this->d.equ(-1., this->g);
+            this->gh = this->residual_norm * this->residual_norm;
+          }
+      }
+
+      void
+      do_iteration(const unsigned int)
+      {
+        this->A.vmult(this->h, this->d);
+
+        Number alpha = this->d * this->h;
+        Assert(std::abs(alpha) != 0., ExcDivideByZero());
+        this->alpha = this->gh / alpha;
+
+        this->x.add(this->alpha, this->d);
+        this->residual_norm = std::sqrt(
+          std::abs(this->g.add_and_dot(this->alpha, this->h, this->g)));
+      }
+
+      void
+      compute_next_direction()
+      {
+        if (std::is_same<PreconditionerType, PreconditionIdentity>::value ==
+            false)
+          {
+            this->preconditioner.vmult(this->h, this->g);
+
+            Number beta = this->gh;
+            Assert(std::abs(beta) != 0., ExcDivideByZero());
+            this->gh   = this->g * this->h;
+            this->beta = this->gh / beta;
+            this->d.sadd(this->beta, -1., this->h);
+          }
+        else
+          {
+            Number beta = this->gh;
+            this->gh    = this->residual_norm * this->residual_norm;
+            this->beta  = this->gh / beta;
+            this->d.sadd(this->beta, -1., this->g);
+          }
+      }
+    };
+
+
+
+    // the variant of the iteration for LinearAlgebra::distributed::Vector
+    // and a matrix that runs operations on vector entries within its
+    // matrix-vector product: the update of the search direction is done
+    // before the product, and the inner product of the search direction with
+    // the result of the product after it. The updates of the solution and
+    // the residual are merged with the computation of the next inner
+    // products into a single loop over the vectors.
+    template <typename Number, typename MatrixType, typename PreconditionerType>
+    struct IterationWorker<
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>,
+      MatrixType,
+      PreconditionerType,
+      typename std::enable_if<
+        has_vmult_functions<
+          MatrixType,
+          LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>::
+            value &&
+          is_diagonal_preconditioner<
+            PreconditionerType,
+            LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>::
+            value &&
+          std::is_floating_point<Number>::value,
+        int>::type>
+      : public IterationWorkerBase<
+          LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>,
+          MatrixType,
+          PreconditionerType>
+    {
+      using VectorType =
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>;
+      using BaseClass =
+        IterationWorkerBase<VectorType, MatrixType, PreconditionerType>;
+
+      const Number *diagonal;
+      bool          direction_is_set;
+      Number        g_dot_pg;
+
+      IterationWorker(const MatrixType &        A,
+                      const PreconditionerType &preconditioner,
+                      VectorMemory<VectorType> &memory,
+                      VectorType &              x)
+        : BaseClass(A, preconditioner, memory, x)
+        , diagonal(get_diagonal_entries<Number>(preconditioner))
+        , direction_is_set(false)
+        , g_dot_pg(0)
+      {}
+
+      // only compute the inner product between the residual and the
+      // preconditioned residual here, the search direction itself is set
+      // within the first matrix-vector product
+      void
+      initialize_direction()
+      {
+        if (diagonal != nullptr)
+          {
+            const Number *     g          = this->g.begin();
+            const unsigned int local_size = this->g.local_size();
+            Number             local_sum  = 0;
+            for (unsigned int i = 0; i < local_size; ++i)
+              local_sum += g[i] * diagonal[i] * g[i];
+            this->gh = Utilities::MPI::sum(local_sum,
+                                           this->g.get_mpi_communicator());
+          }
+        else
+          this->gh = this->residual_norm * this->residual_norm;
+        direction_is_set = false;
+      }
+
+      void
+      do_iteration(const unsigned int)
+      {
+        const Number beta = this->beta;
+        Number *     d    = this->d.begin();
+        const Number *g   = this->g.begin();
+        const Number *h   = this->h.begin();
+
+        Number d_dot_h = 0;
+
+        const auto operation_before_product =
+          [&](const unsigned int begin, const unsigned int end) {
+            if (direction_is_set == false)
+              {
+                if (diagonal != nullptr)
+                  {
+                    DEAL_II_OPENMP_SIMD_PRAGMA
+                    for (unsigned int i = begin; i < end; ++i)
+                      d[i] = -diagonal[i] * g[i];
+                  }
+                else
+                  {
+                    DEAL_II_OPENMP_SIMD_PRAGMA
+                    for (unsigned int i = begin; i < end; ++i)
+                      d[i] = -g[i];
+                  }
+              }
+            else
+              {
+                if (diagonal != nullptr)
+                  {
+                    DEAL_II_OPENMP_SIMD_PRAGMA
+                    for (unsigned int i = begin; i < end; ++i)
+                      d[i] = beta * d[i] - diagonal[i] * g[i];
+                  }
+                else
+                  {
+                    DEAL_II_OPENMP_SIMD_PRAGMA
+                    for (unsigned int i = begin; i < end; ++i)
+                      d[i] = beta * d[i] - g[i];
+                  }
+              }
+          };
+
+        // the ranges might be processed by several threads, so sum up the
+        // contributions of each range within a lock
+        std::mutex mutex;
+        const auto operation_after_product =
+          [&](const unsigned int begin, const unsigned int end) {
+            Number local_sum = 0;
+            for (unsigned int i = begin; i < end; ++i)
+              local_sum += d[i] * h[i];
+            std::lock_guard<std::mutex> lock(mutex);
+            d_dot_h += local_sum;
+          };
+
+        this->A.vmult(this->h,
+                      this->d,
+                      operation_before_product,
+                      operation_after_product);
+        direction_is_set = true;
+
+        d_dot_h = Utilities::MPI::sum(d_dot_h, this->d.get_mpi_communicator());
+        Assert(std::abs(d_dot_h) != 0., ExcDivideByZero());
+        this->alpha = this->gh / d_dot_h;
+
+        // update the solution and the residual, and compute the inner
+        // products for the next iteration in the same loop
+        const Number       alpha      = this->alpha;
+        Number *           x          = this->x.begin();
+        Number *           g_mutable  = this->g.begin();
+        const unsigned int local_size = this->g.local_size();
+        Number             sums[2]    = {0, 0};
+        if (diagonal != nullptr)
+          {
+            for (unsigned int i = 0; i < local_size; ++i)
+              {
+                x[i] += alpha * d[i];
+                g_mutable[i] += alpha * h[i];
+                sums[0] += g_mutable[i] * g_mutable[i];
+                sums[1] += g_mutable[i] * diagonal[i] * g_mutable[i];
+              }
+          }
+        else
+          {
+            for (unsigned int i = 0; i < local_size; ++i)
+              {
+                x[i] += alpha * d[i];
+                g_mutable[i] += alpha * h[i];
+                sums[0] += g_mutable[i] * g_mutable[i];
+              }
+            sums[1] = sums[0];
+          }
+        Utilities::MPI::sum(sums, this->g.get_mpi_communicator(), sums);
+        this->residual_norm = std::sqrt(std::abs(sums[0]));
+        g_dot_pg            = sums[1];
+      }
+
+      // the update of the search direction itself is deferred to the next
+      // matrix-vector product
+      void
+      compute_next_direction()
+      {
+        Assert(std::abs(this->gh) != 0., ExcDivideByZero());
+        this->beta = g_dot_pg / this->gh;
+        this->gh   = g_dot_pg;
+      }
+    };
+  } // namespace SolverCG
+} // namespace internal
+
+
+
 template <typename VectorType>
 template <typename MatrixType, typename PreconditionerType>
 void
@@ -320,22 +783,15 @@ SolverCG<VectorType>::solve(const MatrixType &        A,
                             const VectorType &        b,
                             const PreconditionerType &preconditioner)
 {
+  static const Instrumentation::Region region("SolverCG::solve");
+  Instrumentation::Scope               scope(region);
+
   using number = typename VectorType::value_type;
 
   SolverControl::State conv = SolverControl::iterate;
 
   LogStream::Prefix prefix("cg");
 
-  // Memory allocation
-  typename VectorMemory<VectorType>::Pointer g_pointer(this->memory);
-  typename VectorMemory<VectorType>::Pointer d_pointer(this->memory);
-  typename VectorMemory<VectorType>::Pointer h_pointer(this->memory);
-
-  // define some aliases for simpler access
-  VectorType &g = *g_pointer;
-  VectorType &d = *d_pointer;
-  VectorType &h = *h_pointer;
-
   // Should we build the matrix for eigenvalue computations?
   const bool do_eigenvalues =
     !condition_number_signal.empty() || !all_condition_numbers_signal.empty() ||
@@ -346,87 +802,40 @@ SolverCG<VectorType>::solve(const MatrixType &        A,
   std::vector<typename VectorType::value_type> diagonal;
   std::vector<typename VectorType::value_type> offdiagonal;
 
-  int    it  = 0;
-  double res = -std::numeric_limits<double>::max();
+  int it = 0;
 
   typename VectorType::value_type eigen_beta_alpha = 0;
 
-  // resize the vectors, but do not set
-  // the values since they'd be overwritten
-  // soon anyway.
-  g.reinit(x, true);
-  d.reinit(x, true);
-  h.reinit(x, true);
+  // the worker holds the auxiliary vectors and performs the vector
+  // operations of the algorithm, possibly merged with the matrix-vector
+  // product, see the documentation of this class
+  internal::SolverCG::
+    IterationWorker<VectorType, MatrixType, PreconditionerType>
+      worker(A, preconditioner, this->memory, x);
 
-  number gh, beta;
+  worker.startup(b);
 
-  // compute residual. if vector is
-  // zero, then short-circuit the
-  // full computation
-  if (!x.all_zero())
-    {
-      A.vmult(g, x);
-      g.add(-1., b);
-    }
-  else
-    g.equ(-1., b);
-  res = g.l2_norm();
-
-  conv = this->iteration_status(0, res, x);
+  conv = this->iteration_status(0, worker.residual_norm, x);
   if (conv != SolverControl::iterate)
     return;
 
-  if (std::is_same<PreconditionerType, PreconditionIdentity>::value == false)
-    {
-      preconditioner.vmult(h, g);
-
-      d.equ(-1., h);
-
-      gh = g * h;
-    }
-  else
-    {
-      d.equ(-1., g);
-      gh = res * res;
-    }
+  worker.initialize_direction();
 
   while (conv == SolverControl::iterate)
     {
       it++;
-      A.vmult(h, d);
-
-      number alpha = d * h;
-      Assert(std::abs(alpha) != 0., ExcDivideByZero());
-      alpha = gh / alpha;
+      worker.do_iteration(it);
 
-      x.add(alpha, d);
-      res = std::sqrt(std::abs(g.add_and_dot(alpha, h, g)));
+      print_vectors(it, x, worker.g, worker.d);
 
-      print_vectors(it, x, g, d);
-
-      conv = this->iteration_status(it, res, x);
+      conv = this->iteration_status(it, worker.residual_norm, x);
       if (conv != SolverControl::iterate)
         break;
 
-      if (std::is_same<PreconditionerType, PreconditionIdentity>::value ==
-          false)
-        {
-          preconditioner.vmult(h, g);
-
-          beta = gh;
-          Assert(std::abs(beta) != 0., ExcDivideByZero());
-          gh   = g * h;
-          beta = gh / beta;
-          d.sadd(beta, -1., h);
-        }
-      else
-        {
-          beta = gh;
-          gh   = res * res;
-          beta = gh / beta;
-          d.sadd(beta, -1., g);
-        }
+      worker.compute_next_direction();
 
+      const number alpha = worker.alpha;
+      const number beta  = worker.beta;
       this->coefficients_signal(alpha, beta);
       // set up the vectors
       // containing the diagonal
@@ -451,7 +860,8 @@ SolverCG<VectorType>::solve(const MatrixType &        A,
 
   // in case of failure: throw exception
   if (conv != SolverControl::success)
-    AssertThrow(false, SolverControl::NoConvergence(it, res));
+    AssertThrow(false,
+                SolverControl::NoConvergence(it, worker.residual_norm));
   // otherwise exit as normal
 }
 
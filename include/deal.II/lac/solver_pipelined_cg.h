@@ -0,0 +1,544 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_pipelined_cg_h
+#define dealii_solver_pipelined_cg_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/instrumentation.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/memory_space.h>
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+// forward declaration
+#ifndef DOXYGEN
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename Number, typename MemorySpace>
+    class Vector;
+  }
+} // namespace LinearAlgebra
+#endif
+
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * This class implements the pipelined variant of the preconditioned
+ * Conjugate Gradients (CG) method by P. Ghysels and W. Vanroose, "Hiding
+ * global synchronization latency in the preconditioned Conjugate Gradient
+ * algorithm", Parallel Computing 40 (2014), pp. 224-238. Like SolverCG, the
+ * method may only be used for symmetric positive definite matrices and
+ * preconditioners.
+ *
+ * In parallel, the inner products of the CG method are the main obstacle to
+ * scalability: each of them is a global reduction over all processes, and
+ * the basic algorithm needs two of them per iteration, each of which
+ * depends on the result of the preceding matrix-vector product. On a large
+ * number of processes, the latency of these reductions dominates the run
+ * time once the local work becomes small. The pipelined variant rearranges
+ * the recurrences of the method such that all three inner products of an
+ * iteration, $(r,u)$, $(w,u)$, and $(r,r)$ with the preconditioned residual
+ * $u=Pr$ and $w=Au$, are computed at the same time, and such that the
+ * reduction does not depend on the next application of the preconditioner
+ * and the matrix. The reduction is started with the non-blocking
+ * Utilities::MPI::isum() function, the preconditioner and the matrix are
+ * applied while the reduction is on its way, and only then the result is
+ * awaited. This hides the latency of the reduction behind the local work.
+ *
+ * The price is a higher memory consumption, with nine auxiliary vectors
+ * rather than three, and more vector updates per iteration. If the vector
+ * type is LinearAlgebra::distributed::Vector on the host or the serial
+ * ::Vector class, all vector updates and the computation of the local
+ * contributions to the inner products are merged into a single loop over
+ * the locally owned vector entries. For other vector types, the updates use
+ * the generic vector operations and the inner products are computed by the
+ * vector class, i.e., they are global reductions that are not hidden.
+ *
+ * Since the recurrences differ from the basic CG method, the iterates are
+ * the same only in exact arithmetic. The residual of the pipelined method
+ * is updated by a recurrence that involves more terms, which makes the
+ * method somewhat more susceptible to roundoff, and very tight tolerances
+ * are not always reached. The convergence criterion is applied to the
+ * norm of the unpreconditioned residual, as in SolverCG. Note that the
+ * preconditioner and the matrix are applied once more in the iteration
+ * that detects convergence, since they are overlapped with the reduction
+ * that computes the residual norm.
+ *
+ * The two functions that start and complete the non-blocking reduction
+ * must be called in the same order on all processes, which is the case as
+ * long as the preconditioner and the matrix do not issue collective
+ * operations themselves. Point-to-point messages, such as the ghost
+ * exchange of LinearAlgebra::distributed::Vector, are fine.
+ *
+ * <h3>Observing the progress of linear solver iterations</h3>
+ *
+ * The solve() function of this class uses the mechanism described in the
+ * Solver base class to determine convergence. This mechanism can also be used
+ * to observe the progress of the iteration.
+ */
+template <typename VectorType = Vector<double>>
+class SolverPipelinedCG : public SolverBase<VectorType>
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  using size_type = types::global_dof_index;
+
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   * Here, it doesn't store anything but just exists for consistency
+   * with the other solver classes.
+   */
+  struct AdditionalData
+  {};
+
+  /**
+   * Constructor.
+   */
+  SolverPipelinedCG(SolverControl &           cn,
+                    VectorMemory<VectorType> &mem,
+                    const AdditionalData &    data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverPipelinedCG(SolverControl &       cn,
+                    const AdditionalData &data = AdditionalData());
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~SolverPipelinedCG() override = default;
+
+  /**
+   * Solve the linear system $Ax=b$ for x.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType &        A,
+        VectorType &              x,
+        const VectorType &        b,
+        const PreconditionerType &preconditioner);
+
+protected:
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+namespace internal
+{
+  namespace SolverPipelinedCG
+  {
+    // access to the locally owned entries of the vector types that store
+    // them in a contiguous array, together with the communicator over which
+    // inner products need to be summed. Other vector types only support the
+    // global vector operations
+    template <typename VectorType>
+    struct LocalVectorAccess
+    {
+      static const bool is_supported = false;
+    };
+
+    template <typename VectorType>
+    const bool LocalVectorAccess<VectorType>::is_supported;
+
+    template <typename Number>
+    struct LocalVectorAccess<::dealii::Vector<Number>>
+    {
+      static const bool is_supported = std::is_floating_point<Number>::value;
+
+      static Number *
+      begin(::dealii::Vector<Number> &v)
+      {
+        return v.begin();
+      }
+
+      static const Number *
+      begin(const ::dealii::Vector<Number> &v)
+      {
+        return v.begin();
+      }
+
+      static std::size_t
+      local_size(const ::dealii::Vector<Number> &v)
+      {
+        return v.size();
+      }
+
+      static MPI_Comm
+      get_mpi_communicator(const ::dealii::Vector<Number> &)
+      {
+        return MPI_COMM_SELF;
+      }
+    };
+
+    template <typename Number>
+    const bool LocalVectorAccess<::dealii::Vector<Number>>::is_supported;
+
+    template <typename Number>
+    struct LocalVectorAccess<
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>
+    {
+      using VectorType =
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>;
+
+      static const bool is_supported = std::is_floating_point<Number>::value;
+
+      static Number *
+      begin(VectorType &v)
+      {
+        return v.begin();
+      }
+
+      static const Number *
+      begin(const VectorType &v)
+      {
+        return v.begin();
+      }
+
+      static std::size_t
+      local_size(const VectorType &v)
+      {
+        return v.local_size();
+      }
+
+      static MPI_Comm
+      get_mpi_communicator(const VectorType &v)
+      {
+        return v.get_mpi_communicator();
+      }
+    };
+
+    template <typename Number>
+    const bool LocalVectorAccess<
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>::
+      is_supported;
+
+
+
+    // compute the inner products between the given pairs of vectors into
+    // @p results and start summing them over all processes. The results
+    // are available once Utilities::MPI::wait() has been called on
+    // @p request
+    template <typename VectorType>
+    void
+    start_inner_products(
+      const std::vector<std::pair<const VectorType *, const VectorType *>>
+        &                  pairs,
+      std::vector<double> &results,
+      MPI_Request &        request,
+      std::true_type /*has_local_access*/)
+    {
+      using Access = LocalVectorAccess<VectorType>;
+      results.assign(pairs.size(), 0.);
+      if (pairs.empty())
+        {
+          request = MPI_REQUEST_NULL;
+          return;
+        }
+      const std::size_t local_size = Access::local_size(*pairs[0].first);
+      for (unsigned int p = 0; p < pairs.size(); ++p)
+        {
+          const auto *a   = Access::begin(*pairs[p].first);
+          const auto *b   = Access::begin(*pairs[p].second);
+          double      sum = 0.;
+          for (std::size_t i = 0; i < local_size; ++i)
+            sum += a[i] * b[i];
+          results[p] = sum;
+        }
+      Utilities::MPI::isum(ArrayView<const double>(results),
+                           Access::get_mpi_communicator(*pairs[0].first),
+                           ArrayView<double>(results),
+                           request);
+    }
+
+
+
+    template <typename VectorType>
+    void
+    start_inner_products(
+      const std::vector<std::pair<const VectorType *, const VectorType *>>
+        &                  pairs,
+      std::vector<double> &results,
+      MPI_Request &        request,
+      std::false_type /*has_local_access*/)
+    {
+      results.resize(pairs.size());
+      for (unsigned int p = 0; p < pairs.size(); ++p)
+        results[p] = *pairs[p].first * *pairs[p].second;
+      request = MPI_REQUEST_NULL;
+    }
+
+
+
+    template <typename VectorType>
+    void
+    start_inner_products(
+      const std::vector<std::pair<const VectorType *, const VectorType *>>
+        &                  pairs,
+      std::vector<double> &results,
+      MPI_Request &        request)
+    {
+      start_inner_products(
+        pairs,
+        results,
+        request,
+        std::integral_constant<bool,
+                               LocalVectorAccess<VectorType>::is_supported>());
+    }
+
+
+
+    // the vector updates of one iteration of the pipelined method, merged
+    // into a single loop with the local contributions to the inner
+    // products (r,u), (w,u), and (r,r) for the next iteration, whose sum
+    // over all processes is started at the end
+    template <typename VectorType>
+    void
+    update_vectors(const double                     alpha,
+                   const double                     beta,
+                   const std::vector<VectorType *> &v,
+                   const VectorType &               m,
+                   const VectorType &               n,
+                   VectorType &                     x,
+                   std::vector<double> &            sums,
+                   MPI_Request &                    request,
+                   std::true_type /*has_local_access*/)
+    {
+      using Access = LocalVectorAccess<VectorType>;
+      using Number = typename VectorType::value_type;
+
+      const Number a = alpha;
+      const Number b = beta;
+
+      Number *r = Access::begin(*v[0]);
+      Number *u = Access::begin(*v[1]);
+      Number *w = Access::begin(*v[2]);
+      Number *z = Access::begin(*v[3]);
+      Number *q = Access::begin(*v[4]);
+      Number *s = Access::begin(*v[5]);
+      Number *p = Access::begin(*v[6]);
+
+      Number *      x_data = Access::begin(x);
+      const Number *m_data = Access::begin(m);
+      const Number *n_data = Access::begin(n);
+
+      double sum_ru = 0., sum_wu = 0., sum_rr = 0.;
+
+      const std::size_t local_size = Access::local_size(x);
+      for (std::size_t i = 0; i < local_size; ++i)
+        {
+          z[i] = n_data[i] + b * z[i];
+          q[i] = m_data[i] + b * q[i];
+          s[i] = w[i] + b * s[i];
+          p[i] = u[i] + b * p[i];
+          x_data[i] += a * p[i];
+          r[i] -= a * s[i];
+          u[i] -= a * q[i];
+          w[i] -= a * z[i];
+          sum_ru += r[i] * u[i];
+          sum_wu += w[i] * u[i];
+          sum_rr += r[i] * r[i];
+        }
+      sums = {sum_ru, sum_wu, sum_rr};
+      Utilities::MPI::isum(ArrayView<const double>(sums),
+                           Access::get_mpi_communicator(x),
+                           ArrayView<double>(sums),
+                           request);
+    }
+
+
+
+    template <typename VectorType>
+    void
+    update_vectors(const double                     alpha,
+                   const double                     beta,
+                   const std::vector<VectorType *> &v,
+                   const VectorType &               m,
+                   const VectorType &               n,
+                   VectorType &                     x,
+                   std::vector<double> &            sums,
+                   MPI_Request &                    request,
+                   std::false_type /*has_local_access*/)
+    {
+      VectorType &r = *v[0], &u = *v[1], &w = *v[2], &z = *v[3], &q = *v[4],
+                 &s = *v[5], &p = *v[6];
+      z.sadd(beta, 1., n);
+      q.sadd(beta, 1., m);
+      s.sadd(beta, 1., w);
+      p.sadd(beta, 1., u);
+      x.add(alpha, p);
+      r.add(-alpha, s);
+      u.add(-alpha, q);
+      w.add(-alpha, z);
+      start_inner_products<VectorType>({{&r, &u}, {&w, &u}, {&r, &r}},
+                                       sums,
+                                       request,
+                                       std::false_type());
+    }
+  } // namespace SolverPipelinedCG
+} // namespace internal
+
+
+
+template <typename VectorType>
+SolverPipelinedCG<VectorType>::SolverPipelinedCG(
+  SolverControl &           cn,
+  VectorMemory<VectorType> &mem,
+  const AdditionalData &    data)
+  : SolverBase<VectorType>(cn, mem)
+  , additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+SolverPipelinedCG<VectorType>::SolverPipelinedCG(SolverControl &       cn,
+                                                 const AdditionalData &data)
+  : SolverBase<VectorType>(cn)
+  , additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverPipelinedCG<VectorType>::solve(const MatrixType &        A,
+                                     VectorType &              x,
+                                     const VectorType &        b,
+                                     const PreconditionerType &preconditioner)
+{
+  static const Instrumentation::Region region("SolverPipelinedCG::solve");
+  Instrumentation::Scope               scope(region);
+
+  using has_local_access = std::integral_constant<
+    bool,
+    internal::SolverPipelinedCG::LocalVectorAccess<VectorType>::is_supported>;
+
+  SolverControl::State conv = SolverControl::iterate;
+
+  LogStream::Prefix prefix("pipelined_cg");
+
+  // the residual r, the preconditioned residual u = P r, w = A u, the
+  // auxiliary vectors z = A q, q = P s, s = A p, the search direction p, and
+  // the vectors m = P w and n = A m
+  std::vector<typename VectorMemory<VectorType>::Pointer> pointers;
+  for (unsigned int i = 0; i < 9; ++i)
+    pointers.emplace_back(this->memory);
+  std::vector<VectorType *> v(7);
+  for (unsigned int i = 0; i < 9; ++i)
+    {
+      // z, q, s, and p are multiplied by zero in the first iteration and
+      // must therefore not contain invalid values, all other vectors are
+      // overwritten anyway
+      pointers[i]->reinit(x, i < 3 || i > 6);
+      if (i < 7)
+        v[i] = pointers[i].get();
+    }
+  VectorType &r = *v[0], &u = *v[1], &w = *v[2], &m = *pointers[7],
+             &n = *pointers[8];
+
+  // compute the residual and the first products outside the iteration
+  A.vmult(r, x);
+  r.sadd(-1., 1., b);
+  preconditioner.vmult(u, r);
+  A.vmult(w, u);
+
+  std::vector<double> sums;
+  MPI_Request         request = MPI_REQUEST_NULL;
+  internal::SolverPipelinedCG::start_inner_products<VectorType>(
+    {{&r, &u}, {&w, &u}, {&r, &r}}, sums, request);
+
+  int    it            = 0;
+  double residual_norm = 0.;
+  double gamma_old     = 0.;
+  double alpha         = 0.;
+  while (true)
+    {
+      // apply the preconditioner and the matrix while the inner products
+      // are summed up
+      preconditioner.vmult(m, w);
+      A.vmult(n, m);
+      Utilities::MPI::wait(request);
+
+      residual_norm = std::sqrt(std::abs(sums[2]));
+      conv          = this->iteration_status(it, residual_norm, x);
+      if (conv != SolverControl::iterate)
+        break;
+
+      const double gamma = sums[0];
+      const double delta = sums[1];
+      double       beta  = 0.;
+      if (it > 0)
+        {
+          Assert(std::abs(gamma_old) != 0., ExcDivideByZero());
+          beta = gamma / gamma_old;
+          Assert(std::abs(delta - beta * gamma / alpha) != 0.,
+                 ExcDivideByZero());
+          alpha = gamma / (delta - beta * gamma / alpha);
+        }
+      else
+        {
+          Assert(std::abs(delta) != 0., ExcDivideByZero());
+          alpha = gamma / delta;
+        }
+      gamma_old = gamma;
+
+      internal::SolverPipelinedCG::update_vectors(
+        alpha, beta, v, m, n, x, sums, request, has_local_access());
+
+      ++it;
+    }
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence(it, residual_norm));
+  // otherwise exit as normal
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
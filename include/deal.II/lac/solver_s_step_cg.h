@@ -0,0 +1,426 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_s_step_cg_h
+#define dealii_solver_s_step_cg_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/instrumentation.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_pipelined_cg.h>
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * This class implements the s-step variant of the preconditioned Conjugate
+ * Gradients (CG) method by A.T. Chronopoulos and C.W. Gear, "s-step
+ * iterative methods for symmetric linear systems", Journal of Computational
+ * and Applied Mathematics 25 (1989), pp. 153-168. Like SolverCG, the method
+ * may only be used for symmetric positive definite matrices and
+ * preconditioners.
+ *
+ * Rather than extending the Krylov space by one vector per iteration, the
+ * method builds a basis of $s$ new directions at once, $R_0 = P r$, $R_{j+1}
+ * = P A R_j$, by $s$ applications of the matrix and the preconditioner $P$
+ * without any inner products in between. All inner products that are needed
+ * to make the new directions conjugate to the previous block and to compute
+ * the update of the solution, namely the small matrices $R^T A R$ and $(A
+ * P_{\text{old}})^T R$ together with $R^T r$ and the norm of the residual,
+ * are then summed up in a single global reduction. In exact arithmetic, one
+ * block gives the same iterate as $s$ iterations of the basic CG method,
+ * but needs only one global reduction rather than $2s$, which is what makes
+ * the method interesting when the latency of the reductions limits the
+ * scalability. The reduction is started with the non-blocking
+ * Utilities::MPI::isum() function and overlapped with the update of the
+ * solution by the previous block, which is deferred until then.
+ *
+ * The iteration number passed to the SolverControl object counts the
+ * equivalent CG iterations, i.e., it grows by the number of directions of a
+ * block. Since the residual is only checked once per block, the number of
+ * iterations reported at convergence is usually somewhat larger than for
+ * SolverCG.
+ *
+ * The basis $R$ uses the monomials of $PA$, whose columns become linearly
+ * dependent in finite precision arithmetic for larger $s$ or once the
+ * iteration approaches the solution. The small matrices are therefore
+ * factorized by a Cholesky decomposition in double precision that drops
+ * the directions that are numerically dependent on the previous ones, in
+ * which case the block contributes fewer directions. Values of $s$ between
+ * 2 and 5 are reasonable for most problems.
+ *
+ * The locally owned contributions to the inner products are computed by a
+ * loop over the vector entries for LinearAlgebra::distributed::Vector on
+ * the host and the serial ::Vector class. For other vector types, each
+ * inner product is computed by the vector class and is a global reduction
+ * of its own.
+ *
+ * <h3>Observing the progress of linear solver iterations</h3>
+ *
+ * The solve() function of this class uses the mechanism described in the
+ * Solver base class to determine convergence. This mechanism can also be used
+ * to observe the progress of the iteration.
+ */
+template <typename VectorType = Vector<double>>
+class SolverSStepCG : public SolverBase<VectorType>
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  using size_type = types::global_dof_index;
+
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor. By default, blocks of four directions are built.
+     */
+    explicit AdditionalData(const unsigned int s = 4);
+
+    /**
+     * The number of directions built per block, i.e., the number of matrix
+     * vector products between two global reductions.
+     */
+    unsigned int s;
+  };
+
+  /**
+   * Constructor.
+   */
+  SolverSStepCG(SolverControl &           cn,
+                VectorMemory<VectorType> &mem,
+                const AdditionalData &    data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverSStepCG(SolverControl &       cn,
+                const AdditionalData &data = AdditionalData());
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~SolverSStepCG() override = default;
+
+  /**
+   * Solve the linear system $Ax=b$ for x.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType &        A,
+        VectorType &              x,
+        const VectorType &        b,
+        const PreconditionerType &preconditioner);
+
+protected:
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+namespace internal
+{
+  namespace SolverSStepCG
+  {
+    // compute the Cholesky factor L of the symmetric matrix W into the
+    // lower triangle of L, stopping at the first column that is
+    // numerically dependent on the previous ones. Return the number of
+    // columns that were factorized
+    inline unsigned int
+    truncated_cholesky(const FullMatrix<double> &W, FullMatrix<double> &L)
+    {
+      const unsigned int n = W.m();
+      L.reinit(n, n);
+      for (unsigned int j = 0; j < n; ++j)
+        {
+          double diagonal = W(j, j);
+          for (unsigned int k = 0; k < j; ++k)
+            diagonal -= L(j, k) * L(j, k);
+
+          // the remaining part of the column relative to its length in the
+          // W norm is the sine of the angle to the previous columns
+          if (!(W(j, j) > 0.) || !(diagonal > 1e-12 * W(j, j)))
+            return j;
+
+          L(j, j) = std::sqrt(diagonal);
+          for (unsigned int i = j + 1; i < n; ++i)
+            {
+              double entry = W(i, j);
+              for (unsigned int k = 0; k < j; ++k)
+                entry -= L(i, k) * L(j, k);
+              L(i, j) = entry / L(j, j);
+            }
+        }
+      return n;
+    }
+
+
+
+    // solve L L^T y = y with the first n rows and columns of the Cholesky
+    // factor L
+    inline void
+    cholesky_solve(const FullMatrix<double> &L,
+                   const unsigned int        n,
+                   std::vector<double> &     y)
+    {
+      for (unsigned int i = 0; i < n; ++i)
+        {
+          for (unsigned int k = 0; k < i; ++k)
+            y[i] -= L(i, k) * y[k];
+          y[i] /= L(i, i);
+        }
+      for (unsigned int i = n; i-- > 0;)
+        {
+          for (unsigned int k = i + 1; k < n; ++k)
+            y[i] -= L(k, i) * y[k];
+          y[i] /= L(i, i);
+        }
+    }
+  } // namespace SolverSStepCG
+} // namespace internal
+
+
+
+template <typename VectorType>
+SolverSStepCG<VectorType>::AdditionalData::AdditionalData(
+  const unsigned int s)
+  : s(s)
+{}
+
+
+
+template <typename VectorType>
+SolverSStepCG<VectorType>::SolverSStepCG(SolverControl &           cn,
+                                         VectorMemory<VectorType> &mem,
+                                         const AdditionalData &    data)
+  : SolverBase<VectorType>(cn, mem)
+  , additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+SolverSStepCG<VectorType>::SolverSStepCG(SolverControl &       cn,
+                                         const AdditionalData &data)
+  : SolverBase<VectorType>(cn)
+  , additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverSStepCG<VectorType>::solve(const MatrixType &        A,
+                                 VectorType &              x,
+                                 const VectorType &        b,
+                                 const PreconditionerType &preconditioner)
+{
+  static const Instrumentation::Region region("SolverSStepCG::solve");
+  Instrumentation::Scope               scope(region);
+
+  const unsigned int s = additional_data.s;
+  AssertThrow(s > 0, ExcMessage("The number of steps s must be positive."));
+
+  SolverControl::State conv = SolverControl::iterate;
+
+  LogStream::Prefix prefix("s_step_cg");
+
+  // the residual, the basis R of the new directions and A R, and the
+  // directions P of the previous block and A P
+  typename VectorMemory<VectorType>::Pointer r_pointer(this->memory);
+  std::vector<typename VectorMemory<VectorType>::Pointer> R, AR, P, AP;
+  for (unsigned int j = 0; j < s; ++j)
+    {
+      R.emplace_back(this->memory);
+      AR.emplace_back(this->memory);
+      P.emplace_back(this->memory);
+      AP.emplace_back(this->memory);
+      R[j]->reinit(x, true);
+      AR[j]->reinit(x, true);
+      P[j]->reinit(x, true);
+      AP[j]->reinit(x, true);
+    }
+  VectorType &r = *r_pointer;
+  r.reinit(x, true);
+
+  A.vmult(r, x);
+  r.sadd(-1., 1., b);
+
+  // the number of directions of the previous block, their Cholesky factor
+  // in the A inner product, and the step length along them
+  unsigned int        s_old = 0;
+  FullMatrix<double>  L_old;
+  std::vector<double> a_old;
+
+  FullMatrix<double> G(s, s), W(s, s), L, B;
+
+  std::vector<std::pair<const VectorType *, const VectorType *>> pairs;
+  std::vector<double>                                            sums;
+
+  int    it            = 0;
+  double residual_norm = 0.;
+  while (true)
+    {
+      // build the basis of the new directions
+      preconditioner.vmult(*R[0], r);
+      for (unsigned int j = 0; j < s; ++j)
+        {
+          A.vmult(*AR[j], *R[j]);
+          if (j + 1 < s)
+            preconditioner.vmult(*R[j + 1], *AR[j]);
+        }
+
+      // collect all inner products of this block into a single reduction:
+      // the upper triangle of R^T A R, the products of A P_old with R, the
+      // products of R and P_old with the residual, and the norm of the
+      // residual
+      pairs.clear();
+      for (unsigned int i = 0; i < s; ++i)
+        for (unsigned int j = i; j < s; ++j)
+          pairs.emplace_back(R[i].get(), AR[j].get());
+      for (unsigned int i = 0; i < s_old; ++i)
+        for (unsigned int j = 0; j < s; ++j)
+          pairs.emplace_back(AP[i].get(), R[j].get());
+      for (unsigned int i = 0; i < s; ++i)
+        pairs.emplace_back(R[i].get(), &r);
+      for (unsigned int i = 0; i < s_old; ++i)
+        pairs.emplace_back(P[i].get(), &r);
+      pairs.emplace_back(&r, &r);
+
+      MPI_Request request = MPI_REQUEST_NULL;
+      internal::SolverPipelinedCG::start_inner_products(pairs, sums, request);
+
+      // the deferred update of the solution by the previous block
+      for (unsigned int j = 0; j < s_old; ++j)
+        x.add(a_old[j], *P[j]);
+
+      Utilities::MPI::wait(request);
+
+      residual_norm = std::sqrt(std::abs(sums.back()));
+      conv          = this->iteration_status(it, residual_norm, x);
+      if (conv != SolverControl::iterate)
+        break;
+
+      unsigned int index = 0;
+      for (unsigned int i = 0; i < s; ++i)
+        for (unsigned int j = i; j < s; ++j, ++index)
+          G(i, j) = G(j, i) = sums[index];
+
+      // make the new directions conjugate to the previous block,
+      // B = -W_old^{-1} C, and compute the matrix of the new directions in
+      // the A inner product, W = G + C^T B
+      W = G;
+      B.reinit(s_old, s);
+      std::vector<double> column(s_old);
+      for (unsigned int j = 0; j < s; ++j)
+        {
+          for (unsigned int i = 0; i < s_old; ++i)
+            column[i] = sums[index + i * s + j];
+          internal::SolverSStepCG::cholesky_solve(L_old, s_old, column);
+          for (unsigned int i = 0; i < s_old; ++i)
+            B(i, j) = -column[i];
+        }
+      for (unsigned int i = 0; i < s; ++i)
+        for (unsigned int j = 0; j < s; ++j)
+          for (unsigned int k = 0; k < s_old; ++k)
+            W(i, j) += sums[index + k * s + i] * B(k, j);
+      index += s_old * s;
+
+      unsigned int s_new = internal::SolverSStepCG::truncated_cholesky(W, L);
+
+      // if not even the first new direction is independent of the previous
+      // block, restart from the basis alone
+      if (s_new == 0 && s_old > 0)
+        {
+          s_old = 0;
+          B.reinit(0, s);
+          W     = G;
+          s_new = internal::SolverSStepCG::truncated_cholesky(W, L);
+        }
+      if (s_new == 0)
+        {
+          conv = SolverControl::failure;
+          break;
+        }
+
+      // the step length along the new directions, a = W^{-1} P^T r with
+      // P^T r = R^T r + B^T P_old^T r. The second term vanishes in exact
+      // arithmetic, but including it keeps the step optimal once the
+      // iteration has reached the level of roundoff
+      std::vector<double> a(sums.begin() + index,
+                            sums.begin() + index + s_new);
+      for (unsigned int j = 0; j < s_new; ++j)
+        for (unsigned int i = 0; i < s_old; ++i)
+          a[j] += B(i, j) * sums[index + s + i];
+      internal::SolverSStepCG::cholesky_solve(L, s_new, a);
+
+      // compute the new directions in place of the basis and swap them with
+      // the old ones, then update the residual
+      for (unsigned int j = 0; j < s_new; ++j)
+        for (unsigned int i = 0; i < s_old; ++i)
+          {
+            R[j]->add(B(i, j), *P[i]);
+            AR[j]->add(B(i, j), *AP[i]);
+          }
+      for (unsigned int j = 0; j < s_new; ++j)
+        {
+          std::swap(R[j], P[j]);
+          std::swap(AR[j], AP[j]);
+          r.add(-a[j], *AP[j]);
+        }
+
+      s_old = s_new;
+      L_old = L;
+      a_old = a;
+      it += s_new;
+    }
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence(it, residual_norm));
+  // otherwise exit as normal
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -19,6 +19,7 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/instrumentation.h>
 #include <deal.II/base/parallel.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/utilities.h>
@@ -775,6 +776,9 @@ SparseMatrix<number>::vmult(OutVector &dst, const InVector &src) const
 
   Assert(!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
 
+  static const Instrumentation::Region region("SparseMatrix::vmult");
+  Instrumentation::Scope               scope(region);
+
   parallel::apply_to_subranges(
     0U,
     m(),
@@ -0,0 +1,539 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_matrix_sell_h
+#define dealii_sparse_matrix_sell_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/lac/exceptions.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+// Forward declarations
+#ifndef DOXYGEN
+template <typename number>
+class Vector;
+template <typename number>
+class SparseMatrix;
+class SparsityPattern;
+#endif
+
+/**
+ * @addtogroup Matrix1
+ * @{
+ */
+
+/**
+ * Sparse matrix stored in the sliced ELLPACK format with sorting, also known
+ * as SELL-C-$\sigma$.
+ *
+ * The compressed row storage used by SparseMatrix processes one row at a
+ * time in matrix-vector products. For matrices with short rows, as they
+ * typically arise from finite element discretizations, the loop over the
+ * entries of a row is too short to be vectorized efficiently and the
+ * product does not reach the memory bandwidth of modern processors. This
+ * class instead groups the rows into chunks of $C$ rows, where $C$ is the
+ * number of lanes of VectorizedArray<number>, and stores the entries of a
+ * chunk column by column, i.e., the $k$-th entries of all rows of a chunk
+ * are contiguous in memory. The matrix-vector product then processes all
+ * rows of a chunk at once with SIMD instructions, loading the matrix entries
+ * with packed loads and the vector entries with gather instructions.
+ *
+ * Each chunk is padded with explicit zeros up to the length of its longest
+ * row. In order to keep the padding small, the rows are sorted by their
+ * length within windows of $\sigma$ consecutive rows before they are grouped
+ * into chunks. Sorting only within these windows keeps the access pattern
+ * into the source vector similar to that of the original row order. The
+ * parameter $\sigma$ is passed as @p sorting_scope to reinit(); a value of
+ * one disables the sorting.
+ *
+ * The matrix is set up from an existing SparsityPattern and can then either
+ * be filled entry by entry with set() and add() or by copying the values of
+ * a SparseMatrix with copy_from(). It provides the vmult(), Tvmult(), and
+ * precondition_*() functions required to be used with the linear solvers
+ * (e.g., SolverCG or SolverGMRES) and the relaxation preconditioners
+ * (PreconditionJacobi, PreconditionSOR, PreconditionSSOR) of the library.
+ * The product with the matrix is vectorized and, like for SparseMatrix, also
+ * parallelized with threads. The transpose product and the Gauss-Seidel
+ * type preconditioners are inherently sequential and therefore only
+ * access the matrix in the sliced layout without explicit vectorization.
+ *
+ * Since the gather instructions work with 32-bit offsets, the number of
+ * columns of the matrix must fit into an <tt>unsigned int</tt>.
+ */
+template <typename number>
+class SparseMatrixSELL : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  using size_type = types::global_dof_index;
+
+  /**
+   * Type of the matrix entries.
+   */
+  using value_type = number;
+
+  /**
+   * The number of rows $C$ that are stored together in one chunk, which is
+   * the number of lanes of VectorizedArray<number>.
+   */
+  static constexpr unsigned int chunk_size = VectorizedArray<number>::size();
+
+  /**
+   * The default number $\sigma$ of consecutive rows within which rows are
+   * sorted by their length.
+   */
+  static constexpr unsigned int default_sorting_scope = 8 * chunk_size;
+
+  /**
+   * Constructor. Initialize an empty matrix.
+   */
+  SparseMatrixSELL();
+
+  /**
+   * Constructor. Set up the storage for the entries of @p sparsity and
+   * initialize them to zero. See reinit() for the meaning of
+   * @p sorting_scope.
+   */
+  explicit SparseMatrixSELL(
+    const SparsityPattern &sparsity,
+    const unsigned int     sorting_scope = default_sorting_scope);
+
+  /**
+   * Constructor. Set up the storage for the sparsity pattern of @p matrix and
+   * copy its entries.
+   */
+  template <typename number2>
+  explicit SparseMatrixSELL(
+    const SparseMatrix<number2> &matrix,
+    const unsigned int           sorting_scope = default_sorting_scope);
+
+  /**
+   * Set up the storage for the entries of @p sparsity and initialize them to
+   * zero. Other than SparseMatrix, this object does not keep a reference to
+   * the sparsity pattern, which can be destroyed after this call.
+   *
+   * The rows are sorted by decreasing length within windows of
+   * @p sorting_scope consecutive rows before they are grouped into chunks.
+   * The value should be a multiple of chunk_size.
+   */
+  void
+  reinit(const SparsityPattern &sparsity,
+         const unsigned int     sorting_scope = default_sorting_scope);
+
+  /**
+   * Copy the entries of @p matrix into this object. All entries of @p matrix
+   * must be part of the sparsity pattern this object was initialized with.
+   */
+  template <typename number2>
+  void
+  copy_from(const SparseMatrix<number2> &matrix);
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void
+  clear();
+
+  /**
+   * Return whether the object is empty, i.e., whether it has no rows or no
+   * columns.
+   */
+  bool
+  empty() const;
+
+  /**
+   * Return the number of rows of this matrix.
+   */
+  size_type
+  m() const;
+
+  /**
+   * Return the number of columns of this matrix.
+   */
+  size_type
+  n() const;
+
+  /**
+   * Return the number of entries of the sparsity pattern this matrix was
+   * initialized with.
+   */
+  std::size_t
+  n_nonzero_elements() const;
+
+  /**
+   * Return the number of entries actually stored, including the zeros
+   * padding the rows of each chunk to the same length. The ratio to
+   * n_nonzero_elements() measures the storage overhead of the format.
+   */
+  std::size_t
+  n_stored_elements() const;
+
+  /**
+   * Set all entries of the matrix to @p d, which must be zero.
+   */
+  SparseMatrixSELL &
+  operator=(const double d);
+
+  /**
+   * Set the element (<i>i,j</i>) to @p value. The entry must be part of the
+   * sparsity pattern.
+   */
+  void
+  set(const size_type i, const size_type j, const number value);
+
+  /**
+   * Add @p value to the element (<i>i,j</i>). The entry must be part of the
+   * sparsity pattern.
+   */
+  void
+  add(const size_type i, const size_type j, const number value);
+
+  /**
+   * Return the value of the element (<i>i,j</i>), or zero if the entry is
+   * not part of the sparsity pattern.
+   */
+  number
+  el(const size_type i, const size_type j) const;
+
+  /**
+   * Return the main diagonal element in the <i>i</i>th row. This function
+   * throws an error if the matrix is not quadratic or the diagonal entry is
+   * not part of the sparsity pattern.
+   */
+  number
+  diag_element(const size_type i) const;
+
+  /**
+   * Matrix-vector multiplication: let <i>dst = M*src</i> with <i>M</i>
+   * being this matrix.
+   */
+  template <typename somenumber>
+  void
+  vmult(Vector<somenumber> &dst, const Vector<somenumber> &src) const;
+
+  /**
+   * Matrix-vector multiplication: let <i>dst = M<sup>T</sup>*src</i> with
+   * <i>M</i> being this matrix.
+   */
+  template <typename somenumber>
+  void
+  Tvmult(Vector<somenumber> &dst, const Vector<somenumber> &src) const;
+
+  /**
+   * Adding Matrix-vector multiplication. Add <i>M*src</i> on <i>dst</i>
+   * with <i>M</i> being this matrix.
+   */
+  template <typename somenumber>
+  void
+  vmult_add(Vector<somenumber> &dst, const Vector<somenumber> &src) const;
+
+  /**
+   * Adding Matrix-vector multiplication. Add <i>M<sup>T</sup>*src</i> to
+   * <i>dst</i> with <i>M</i> being this matrix.
+   */
+  template <typename somenumber>
+  void
+  Tvmult_add(Vector<somenumber> &dst, const Vector<somenumber> &src) const;
+
+  /**
+   * Apply the Jacobi preconditioner, which multiplies every element of the
+   * @p src vector by the inverse of the respective diagonal element and
+   * multiplies the result with the damping factor @p omega.
+   */
+  template <typename somenumber>
+  void
+  precondition_Jacobi(Vector<somenumber> &      dst,
+                      const Vector<somenumber> &src,
+                      const number              omega = 1.) const;
+
+  /**
+   * Apply SSOR preconditioning to @p src with damping @p omega, in the same
+   * way as SparseMatrix::precondition_SSOR(). The last argument is only
+   * present for compatibility with the interface expected by
+   * PreconditionSSOR and is ignored.
+   */
+  template <typename somenumber>
+  void
+  precondition_SSOR(Vector<somenumber> &            dst,
+                    const Vector<somenumber> &      src,
+                    const number                    omega = 1.,
+                    const std::vector<std::size_t> &pos_right_of_diagonal =
+                      std::vector<std::size_t>()) const;
+
+  /**
+   * Apply SOR preconditioning matrix to @p src.
+   */
+  template <typename somenumber>
+  void
+  precondition_SOR(Vector<somenumber> &      dst,
+                   const Vector<somenumber> &src,
+                   const number              omega = 1.) const;
+
+  /**
+   * Apply transpose SOR preconditioning matrix to @p src.
+   */
+  template <typename somenumber>
+  void
+  precondition_TSOR(Vector<somenumber> &      dst,
+                    const Vector<somenumber> &src,
+                    const number              omega = 1.) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+  /**
+   * @addtogroup Exceptions
+   * @{
+   */
+
+  /**
+   * Exception
+   */
+  DeclException2(ExcInvalidEntry,
+                 size_type,
+                 size_type,
+                 << "You are trying to access the matrix entry with index <"
+                 << arg1 << ',' << arg2
+                 << ">, but this entry does not exist in the sparsity pattern "
+                    "of this matrix.");
+
+  /**
+   * Exception
+   */
+  DeclException1(ExcTooManyColumns,
+                 size_type,
+                 << "The matrix has " << arg1
+                 << " columns, but the sliced ELLPACK format only supports "
+                    "column indices that fit into an unsigned int.");
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg(ExcSourceEqualsDestination,
+                   "You are attempting an operation on two vectors that "
+                   "are the same object, but the operation requires that the "
+                   "two objects are in fact different.");
+  //@}
+
+private:
+  /**
+   * Return the index into the #values array of the element (<i>i,j</i>), or
+   * numbers::invalid_size_type if the entry is not part of the sparsity
+   * pattern.
+   */
+  std::size_t
+  index_of(const size_type i, const size_type j) const;
+
+  /**
+   * Return the index into the #values array of the first entry of row
+   * @p i. The following entries of the row are found with stride
+   * chunk_size.
+   */
+  std::size_t
+  row_start(const size_type i) const;
+
+  /**
+   * Throw an exception if the matrix is not square or has a zero or
+   * missing diagonal entry, which the preconditioners divide by.
+   */
+  void
+  assert_nonzero_diagonal() const;
+
+  /**
+   * Number of rows.
+   */
+  size_type n_rows;
+
+  /**
+   * Number of columns.
+   */
+  size_type n_cols;
+
+  /**
+   * Number of entries of the sparsity pattern.
+   */
+  std::size_t n_nonzeros;
+
+  /**
+   * Index into #values of the first entry of each chunk, with one additional
+   * element at the end holding the total number of stored entries. The
+   * length of the rows of chunk <i>c</i> (including padding) is
+   * <tt>(chunk_starts[c+1]-chunk_starts[c])/chunk_size</tt>.
+   */
+  std::vector<std::size_t> chunk_starts;
+
+  /**
+   * The row stored at each position after sorting, i.e., lane <i>l</i> of
+   * chunk <i>c</i> holds row <tt>sorted_rows[c*chunk_size+l]</tt>. Padding
+   * lanes beyond the number of rows hold numbers::invalid_unsigned_int.
+   */
+  std::vector<unsigned int> sorted_rows;
+
+  /**
+   * The inverse of #sorted_rows, i.e., the position of each row.
+   */
+  std::vector<unsigned int> row_positions;
+
+  /**
+   * The number of entries of each row without padding.
+   */
+  std::vector<unsigned int> row_lengths;
+
+  /**
+   * Index into #values of the diagonal entry of each row, or
+   * numbers::invalid_size_type if the matrix is not square or the entry is
+   * not part of the sparsity pattern.
+   */
+  std::vector<std::size_t> diagonal_indices;
+
+  /**
+   * The column indices of the stored entries, in the order of #values.
+   * Padding entries repeat the last column index of their row, or zero for
+   * empty rows, so that they can be gathered like regular entries.
+   */
+  AlignedVector<unsigned int> column_indices;
+
+  /**
+   * The values of the stored entries, with the entries of a chunk stored
+   * column by column.
+   */
+  AlignedVector<number> values;
+};
+
+/**
+ * @}
+ */
+
+/*---------------------- Inline functions -----------------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename number>
+inline typename SparseMatrixSELL<number>::size_type
+SparseMatrixSELL<number>::m() const
+{
+  return n_rows;
+}
+
+
+
+template <typename number>
+inline typename SparseMatrixSELL<number>::size_type
+SparseMatrixSELL<number>::n() const
+{
+  return n_cols;
+}
+
+
+
+template <typename number>
+inline std::size_t
+SparseMatrixSELL<number>::row_start(const size_type i) const
+{
+  AssertIndexRange(i, n_rows);
+  const unsigned int position = row_positions[i];
+  return chunk_starts[position / chunk_size] + position % chunk_size;
+}
+
+
+
+template <typename number>
+inline std::size_t
+SparseMatrixSELL<number>::index_of(const size_type i, const size_type j) const
+{
+  AssertIndexRange(j, n_cols);
+  const std::size_t start = row_start(i);
+  for (unsigned int k = 0; k < row_lengths[i]; ++k)
+    if (column_indices[start + k * chunk_size] == j)
+      return start + k * chunk_size;
+  return numbers::invalid_size_type;
+}
+
+
+
+template <typename number>
+inline void
+SparseMatrixSELL<number>::set(const size_type i,
+                              const size_type j,
+                              const number    value)
+{
+  AssertIsFinite(value);
+  const std::size_t index = index_of(i, j);
+  Assert((index != numbers::invalid_size_type) || (value == number()),
+         ExcInvalidEntry(i, j));
+  if (index != numbers::invalid_size_type)
+    values[index] = value;
+}
+
+
+
+template <typename number>
+inline void
+SparseMatrixSELL<number>::add(const size_type i,
+                              const size_type j,
+                              const number    value)
+{
+  AssertIsFinite(value);
+  if (value == number())
+    return;
+  const std::size_t index = index_of(i, j);
+  Assert(index != numbers::invalid_size_type, ExcInvalidEntry(i, j));
+  if (index != numbers::invalid_size_type)
+    values[index] += value;
+}
+
+
+
+template <typename number>
+inline number
+SparseMatrixSELL<number>::el(const size_type i, const size_type j) const
+{
+  const std::size_t index = index_of(i, j);
+  return (index != numbers::invalid_size_type) ? values[index] : number();
+}
+
+
+
+template <typename number>
+inline number
+SparseMatrixSELL<number>::diag_element(const size_type i) const
+{
+  AssertIndexRange(i, n_rows);
+  Assert(diagonal_indices[i] != numbers::invalid_size_type,
+         ExcInvalidEntry(i, i));
+  return values[diagonal_indices[i]];
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
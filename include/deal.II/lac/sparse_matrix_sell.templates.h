@@ -0,0 +1,621 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_matrix_sell_templates_h
+#define dealii_sparse_matrix_sell_templates_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparse_matrix_sell.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace SparseMatrixSELLImplementation
+  {
+    /**
+     * Load the entries of @p src at the positions @p indices into the lanes
+     * of @p out. This is the general version for vectors whose number type
+     * differs from the one of the matrix.
+     */
+    template <typename number, typename somenumber>
+    inline void
+    gather(VectorizedArray<number> &out,
+           const somenumber *       src,
+           const unsigned int *     indices)
+    {
+      for (unsigned int v = 0; v < VectorizedArray<number>::size(); ++v)
+        out[v] = src[indices[v]];
+    }
+
+
+
+    /**
+     * Same as above for vectors with the number type of the matrix, using
+     * the gather instructions of the hardware where available.
+     */
+    template <typename number>
+    inline void
+    gather(VectorizedArray<number> &out,
+           const number *           src,
+           const unsigned int *     indices)
+    {
+      out.gather(src, indices);
+    }
+
+
+
+    /**
+     * Perform a vmult (or vmult_add if @p add is true) on the chunks in the
+     * range [begin_chunk, end_chunk).
+     */
+    template <typename number, typename somenumber>
+    void
+    vmult_on_subrange(const unsigned int        begin_chunk,
+                      const unsigned int        end_chunk,
+                      const std::size_t *       chunk_starts,
+                      const unsigned int *      sorted_rows,
+                      const unsigned int *      column_indices,
+                      const number *            values,
+                      const somenumber *        src,
+                      somenumber *              dst,
+                      const bool                add)
+    {
+      constexpr unsigned int n_lanes = VectorizedArray<number>::size();
+
+      for (unsigned int chunk = begin_chunk; chunk < end_chunk; ++chunk)
+        {
+          VectorizedArray<number> sum = number();
+          for (std::size_t index = chunk_starts[chunk];
+               index < chunk_starts[chunk + 1];
+               index += n_lanes)
+            {
+              VectorizedArray<number> matrix_values, vector_values;
+              matrix_values.load(values + index);
+              gather(vector_values, src, column_indices + index);
+              sum += matrix_values * vector_values;
+            }
+
+          const unsigned int *rows = sorted_rows + chunk * n_lanes;
+          for (unsigned int v = 0; v < n_lanes; ++v)
+            if (rows[v] != numbers::invalid_unsigned_int)
+              {
+                if (add)
+                  dst[rows[v]] += sum[v];
+                else
+                  dst[rows[v]] = sum[v];
+              }
+        }
+    }
+  } // namespace SparseMatrixSELLImplementation
+} // namespace internal
+
+
+
+template <typename number>
+constexpr unsigned int SparseMatrixSELL<number>::chunk_size;
+
+template <typename number>
+constexpr unsigned int SparseMatrixSELL<number>::default_sorting_scope;
+
+
+
+template <typename number>
+SparseMatrixSELL<number>::SparseMatrixSELL()
+  : n_rows(0)
+  , n_cols(0)
+  , n_nonzeros(0)
+{}
+
+
+
+template <typename number>
+SparseMatrixSELL<number>::SparseMatrixSELL(const SparsityPattern &sparsity,
+                                           const unsigned int sorting_scope)
+  : SparseMatrixSELL()
+{
+  reinit(sparsity, sorting_scope);
+}
+
+
+
+template <typename number>
+template <typename number2>
+SparseMatrixSELL<number>::SparseMatrixSELL(const SparseMatrix<number2> &matrix,
+                                           const unsigned int sorting_scope)
+  : SparseMatrixSELL()
+{
+  reinit(matrix.get_sparsity_pattern(), sorting_scope);
+  copy_from(matrix);
+}
+
+
+
+template <typename number>
+void
+SparseMatrixSELL<number>::reinit(const SparsityPattern &sparsity,
+                                 const unsigned int     sorting_scope)
+{
+  Assert(sparsity.is_compressed() || sparsity.empty(),
+         SparsityPattern::ExcNotCompressed());
+  AssertThrow(sparsity.n_cols() <= std::numeric_limits<unsigned int>::max(),
+              ExcTooManyColumns(sparsity.n_cols()));
+  AssertThrow(sparsity.n_rows() < numbers::invalid_unsigned_int,
+              ExcNotImplemented());
+
+  n_rows     = sparsity.n_rows();
+  n_cols     = sparsity.n_cols();
+  n_nonzeros = sparsity.n_nonzero_elements();
+
+  row_lengths.resize(n_rows);
+  for (size_type row = 0; row < n_rows; ++row)
+    row_lengths[row] = sparsity.row_length(row);
+
+  // sort the rows by decreasing length within each window of sorting_scope
+  // rows, keeping the original order for rows of the same length
+  const unsigned int n_chunks = (n_rows + chunk_size - 1) / chunk_size;
+  const unsigned int scope    = std::max(sorting_scope, 1U);
+  sorted_rows.assign(n_chunks * chunk_size, numbers::invalid_unsigned_int);
+  std::iota(sorted_rows.begin(), sorted_rows.begin() + n_rows, 0U);
+  for (unsigned int start = 0; start < n_rows; start += scope)
+    std::stable_sort(sorted_rows.begin() + start,
+                     sorted_rows.begin() +
+                       std::min<std::size_t>(start + scope, n_rows),
+                     [this](const unsigned int a, const unsigned int b) {
+                       return row_lengths[a] > row_lengths[b];
+                     });
+
+  row_positions.resize(n_rows);
+  for (unsigned int position = 0; position < n_rows; ++position)
+    row_positions[sorted_rows[position]] = position;
+
+  // the length of each chunk is the one of its longest row
+  chunk_starts.resize(n_chunks + 1);
+  chunk_starts[0] = 0;
+  for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+    {
+      unsigned int max_length = 0;
+      for (unsigned int v = 0; v < chunk_size; ++v)
+        {
+          const unsigned int row = sorted_rows[chunk * chunk_size + v];
+          if (row != numbers::invalid_unsigned_int)
+            max_length = std::max(max_length, row_lengths[row]);
+        }
+      chunk_starts[chunk + 1] =
+        chunk_starts[chunk] + std::size_t(max_length) * chunk_size;
+    }
+
+  values.clear();
+  values.resize(chunk_starts.back(), number());
+  column_indices.clear();
+  column_indices.resize(chunk_starts.back(), 0U);
+
+  for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+    {
+      const unsigned int length =
+        (chunk_starts[chunk + 1] - chunk_starts[chunk]) / chunk_size;
+      for (unsigned int v = 0; v < chunk_size; ++v)
+        {
+          const unsigned int row = sorted_rows[chunk * chunk_size + v];
+          if (row == numbers::invalid_unsigned_int)
+            continue;
+
+          unsigned int column = 0;
+          for (unsigned int k = 0; k < length; ++k)
+            {
+              if (k < row_lengths[row])
+                column = sparsity.column_number(row, k);
+              column_indices[chunk_starts[chunk] + k * chunk_size + v] =
+                column;
+            }
+        }
+    }
+
+  diagonal_indices.assign(n_rows, numbers::invalid_size_type);
+  if (n_rows == n_cols)
+    for (size_type row = 0; row < n_rows; ++row)
+      diagonal_indices[row] = index_of(row, row);
+}
+
+
+
+template <typename number>
+template <typename number2>
+void
+SparseMatrixSELL<number>::copy_from(const SparseMatrix<number2> &matrix)
+{
+  AssertDimension(m(), matrix.m());
+  AssertDimension(n(), matrix.n());
+
+  *this = 0.;
+
+  for (size_type row = 0; row < n_rows; ++row)
+    {
+      const std::size_t start = row_start(row);
+      unsigned int      k     = 0;
+      for (auto entry = matrix.begin(row); entry != matrix.end(row);
+           ++entry, ++k)
+        {
+          // matrices built from the same sparsity pattern store the entries
+          // of a row in the same order, so only search if they do not match
+          if (k < row_lengths[row] &&
+              column_indices[start + k * chunk_size] == entry->column())
+            values[start + k * chunk_size] = entry->value();
+          else
+            set(row, entry->column(), entry->value());
+        }
+    }
+}
+
+
+
+template <typename number>
+void
+SparseMatrixSELL<number>::clear()
+{
+  n_rows     = 0;
+  n_cols     = 0;
+  n_nonzeros = 0;
+  chunk_starts.clear();
+  sorted_rows.clear();
+  row_positions.clear();
+  row_lengths.clear();
+  diagonal_indices.clear();
+  column_indices.clear();
+  values.clear();
+}
+
+
+
+template <typename number>
+bool
+SparseMatrixSELL<number>::empty() const
+{
+  return (n_rows == 0) || (n_cols == 0);
+}
+
+
+
+template <typename number>
+std::size_t
+SparseMatrixSELL<number>::n_nonzero_elements() const
+{
+  return n_nonzeros;
+}
+
+
+
+template <typename number>
+std::size_t
+SparseMatrixSELL<number>::n_stored_elements() const
+{
+  return values.size();
+}
+
+
+
+template <typename number>
+SparseMatrixSELL<number> &
+SparseMatrixSELL<number>::operator=(const double d)
+{
+  (void)d;
+  Assert(d == 0, ExcScalarAssignmentOnlyForZeroValue());
+
+  std::fill(values.begin(), values.end(), number());
+
+  return *this;
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrixSELL<number>::vmult(Vector<somenumber> &      dst,
+                                const Vector<somenumber> &src) const
+{
+  AssertDimension(dst.size(), m());
+  AssertDimension(src.size(), n());
+  Assert(!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  const unsigned int n_chunks =
+    chunk_starts.empty() ? 0 : chunk_starts.size() - 1;
+  parallel::apply_to_subranges(
+    0U,
+    n_chunks,
+    [this, &src, &dst](const unsigned int begin_chunk,
+                       const unsigned int end_chunk) {
+      internal::SparseMatrixSELLImplementation::vmult_on_subrange(
+        begin_chunk,
+        end_chunk,
+        chunk_starts.data(),
+        sorted_rows.data(),
+        column_indices.data(),
+        values.data(),
+        src.begin(),
+        dst.begin(),
+        false);
+    },
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size /
+        chunk_size +
+      1);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrixSELL<number>::vmult_add(Vector<somenumber> &      dst,
+                                    const Vector<somenumber> &src) const
+{
+  AssertDimension(dst.size(), m());
+  AssertDimension(src.size(), n());
+  Assert(!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  const unsigned int n_chunks =
+    chunk_starts.empty() ? 0 : chunk_starts.size() - 1;
+  parallel::apply_to_subranges(
+    0U,
+    n_chunks,
+    [this, &src, &dst](const unsigned int begin_chunk,
+                       const unsigned int end_chunk) {
+      internal::SparseMatrixSELLImplementation::vmult_on_subrange(
+        begin_chunk,
+        end_chunk,
+        chunk_starts.data(),
+        sorted_rows.data(),
+        column_indices.data(),
+        values.data(),
+        src.begin(),
+        dst.begin(),
+        true);
+    },
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size /
+        chunk_size +
+      1);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrixSELL<number>::Tvmult(Vector<somenumber> &      dst,
+                                 const Vector<somenumber> &src) const
+{
+  dst = 0;
+  Tvmult_add(dst, src);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrixSELL<number>::Tvmult_add(Vector<somenumber> &      dst,
+                                     const Vector<somenumber> &src) const
+{
+  AssertDimension(dst.size(), n());
+  AssertDimension(src.size(), m());
+  Assert(!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  // the products with the matrix entries are computed for all rows of a
+  // chunk at once, but different rows may write into the same entry of
+  // dst, so the results are added one lane at a time. padding entries have
+  // a zero value and point to a valid column
+  for (unsigned int chunk = 0; chunk + 1 < chunk_starts.size(); ++chunk)
+    {
+      VectorizedArray<number> src_values;
+      for (unsigned int v = 0; v < chunk_size; ++v)
+        {
+          const unsigned int row = sorted_rows[chunk * chunk_size + v];
+          src_values[v] =
+            (row != numbers::invalid_unsigned_int) ? src(row) : number();
+        }
+
+      for (std::size_t index = chunk_starts[chunk];
+           index < chunk_starts[chunk + 1];
+           index += chunk_size)
+        {
+          VectorizedArray<number> products;
+          products.load(values.data() + index);
+          products *= src_values;
+          for (unsigned int v = 0; v < chunk_size; ++v)
+            dst(column_indices[index + v]) += products[v];
+        }
+    }
+}
+
+
+
+template <typename number>
+void
+SparseMatrixSELL<number>::assert_nonzero_diagonal() const
+{
+  AssertDimension(m(), n());
+#ifdef DEBUG
+  for (size_type row = 0; row < n_rows; ++row)
+    {
+      Assert(diagonal_indices[row] != numbers::invalid_size_type,
+             ExcInvalidEntry(row, row));
+      Assert(values[diagonal_indices[row]] != number(), ExcDivideByZero());
+    }
+#endif
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrixSELL<number>::precondition_Jacobi(Vector<somenumber> &      dst,
+                                              const Vector<somenumber> &src,
+                                              const number om) const
+{
+  AssertDimension(dst.size(), n());
+  AssertDimension(src.size(), n());
+  assert_nonzero_diagonal();
+
+  const std::size_t *diagonal_ptr = diagonal_indices.data();
+  const number *     values_ptr   = values.data();
+  for (size_type row = 0; row < n_rows; ++row)
+    dst(row) = somenumber(om) * src(row) /
+               somenumber(values_ptr[diagonal_ptr[row]]);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrixSELL<number>::precondition_SSOR(
+  Vector<somenumber> &      dst,
+  const Vector<somenumber> &src,
+  const number              om,
+  const std::vector<std::size_t> &) const
+{
+  AssertDimension(dst.size(), n());
+  AssertDimension(src.size(), n());
+  assert_nonzero_diagonal();
+
+  // forward sweep
+  for (size_type row = 0; row < n_rows; ++row)
+    {
+      const std::size_t start = row_start(row);
+      number            s     = 0;
+      for (unsigned int k = 0; k < row_lengths[row]; ++k)
+        {
+          const unsigned int column = column_indices[start + k * chunk_size];
+          if (column < row)
+            s += values[start + k * chunk_size] * number(dst(column));
+        }
+
+      dst(row) = src(row) - s * om;
+      dst(row) /= values[diagonal_indices[row]];
+    }
+
+  for (size_type row = 0; row < n_rows; ++row)
+    dst(row) *= somenumber(om * (number(2.) - om)) *
+                somenumber(values[diagonal_indices[row]]);
+
+  // backward sweep
+  for (size_type row = n_rows; row-- > 0;)
+    {
+      const std::size_t start = row_start(row);
+      number            s     = 0;
+      for (unsigned int k = 0; k < row_lengths[row]; ++k)
+        {
+          const unsigned int column = column_indices[start + k * chunk_size];
+          if (column > row)
+            s += values[start + k * chunk_size] * number(dst(column));
+        }
+
+      dst(row) -= s * om;
+      dst(row) /= values[diagonal_indices[row]];
+    }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrixSELL<number>::precondition_SOR(Vector<somenumber> &      dst,
+                                           const Vector<somenumber> &src,
+                                           const number              om) const
+{
+  AssertDimension(dst.size(), n());
+  AssertDimension(src.size(), n());
+  assert_nonzero_diagonal();
+
+  dst = src;
+  for (size_type row = 0; row < n_rows; ++row)
+    {
+      const std::size_t start = row_start(row);
+      somenumber        s     = dst(row);
+      for (unsigned int k = 0; k < row_lengths[row]; ++k)
+        {
+          const unsigned int column = column_indices[start + k * chunk_size];
+          if (column < row)
+            s -= somenumber(values[start + k * chunk_size]) * dst(column);
+        }
+
+      dst(row) =
+        s * somenumber(om) / somenumber(values[diagonal_indices[row]]);
+    }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrixSELL<number>::precondition_TSOR(Vector<somenumber> &      dst,
+                                            const Vector<somenumber> &src,
+                                            const number om) const
+{
+  AssertDimension(dst.size(), n());
+  AssertDimension(src.size(), n());
+  assert_nonzero_diagonal();
+
+  dst = src;
+  for (size_type row = n_rows; row-- > 0;)
+    {
+      const std::size_t start = row_start(row);
+      somenumber        s     = dst(row);
+      for (unsigned int k = 0; k < row_lengths[row]; ++k)
+        {
+          const unsigned int column = column_indices[start + k * chunk_size];
+          if (column > row)
+            s -= somenumber(values[start + k * chunk_size]) * dst(column);
+        }
+
+      dst(row) =
+        s * somenumber(om) / somenumber(values[diagonal_indices[row]]);
+    }
+}
+
+
+
+template <typename number>
+std::size_t
+SparseMatrixSELL<number>::memory_consumption() const
+{
+  return sizeof(*this) + MemoryConsumption::memory_consumption(chunk_starts) +
+         MemoryConsumption::memory_consumption(sorted_rows) +
+         MemoryConsumption::memory_consumption(row_positions) +
+         MemoryConsumption::memory_consumption(row_lengths) +
+         MemoryConsumption::memory_consumption(diagonal_indices) +
+         column_indices.memory_consumption() + values.memory_consumption();
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -167,10 +167,18 @@ namespace internal
        * processor, get a temporary number by this function, and will later be
        * assigned the correct index after all the ghost indices have been
        * collected by the call to @p assign_ghosts.
+       *
+       * The indices in @p local_indices_resolved are the ones used for
+       * resolving the constraints and for the access from FEEvaluation. On
+       * cells where hanging-node constraints are applied on the fly, see @p
+       * hanging_node_constraint_masks, the indices on the constrained faces
+       * and edges are replaced by the indices of the coarser neighbor. The
+       * argument @p local_indices holds the plain indices of the cell.
        */
       template <typename number>
       void
       read_dof_indices(
+        const std::vector<types::global_dof_index> &local_indices_resolved,
         const std::vector<types::global_dof_index> &local_indices,
         const std::vector<unsigned int> &           lexicographic_inv,
         const dealii::AffineConstraints<number> &   constraints,
@@ -559,6 +567,18 @@ namespace internal
        */
       std::vector<unsigned int> plain_dof_indices;
 
+      /**
+       * Stores the bit mask of the hanging-node configuration for each cell
+       * in case the hanging-node constraints are applied on the fly by
+       * FEEvaluation rather than expanded into the constraint pool, see
+       * internal::MatrixFreeFunctions::ConstraintKinds for the meaning of the
+       * bits. After the call to reorder_cells(), the entries are sorted
+       * according to the cell batches, with index <tt>cell_batch *
+       * vectorization_length + lane</tt>. The vector is empty if no cell
+       * uses this representation.
+       */
+      std::vector<unsigned short> hanging_node_constraint_masks;
+
       /**
        * Stores the offset in terms of the number of base elements over all
        * DoFInfo objects.
@@ -126,6 +126,7 @@ namespace internal
       start_components.clear();
       row_starts_plain_indices.clear();
       plain_dof_indices.clear();
+      hanging_node_constraint_masks.clear();
       dof_indices_interleaved.clear();
       for (unsigned int i = 0; i < 3; ++i)
         {
@@ -212,6 +213,7 @@ namespace internal
     template <typename number>
     void
     DoFInfo::read_dof_indices(
+      const std::vector<types::global_dof_index> &local_indices_resolved,
       const std::vector<types::global_dof_index> &local_indices,
       const std::vector<unsigned int> &           lexicographic_inv,
       const dealii::AffineConstraints<number> &   constraints,
@@ -246,7 +248,7 @@ namespace internal
                i++)
             {
               types::global_dof_index current_dof =
-                local_indices[lexicographic_inv[i]];
+                local_indices_resolved[lexicographic_inv[i]];
               const auto *entries_ptr =
                 constraints.get_constraint_entries(current_dof);
 
@@ -347,7 +349,8 @@ namespace internal
         }
 
       // now to the plain indices: in case we have constraints on this cell,
-      // store the indices without the constraints resolve once again
+      // including the hanging-node constraints applied on the fly, store the
+      // indices without the constraints resolve once again
       if (store_plain_indices == true)
         {
           if (cell_number == 0)
@@ -356,7 +359,9 @@ namespace internal
           row_starts_plain_indices[cell_number] = plain_dof_indices.size();
           const bool cell_has_constraints =
             (row_starts[(cell_number + 1) * n_components].second >
-             row_starts[cell_number * n_components].second);
+             row_starts[cell_number * n_components].second) ||
+            (!hanging_node_constraint_masks.empty() &&
+             hanging_node_constraint_masks[cell_number] != 0);
           if (cell_has_constraints == true)
             {
               for (unsigned int i = 0; i < dofs_this_cell; ++i)
@@ -548,11 +553,12 @@ namespace internal
         vectorization_length * n_components *
           task_info.cell_partition_data.back() +
         1);
-      std::vector<unsigned int> new_dof_indices;
+      std::vector<unsigned int>   new_dof_indices;
       std::vector<std::pair<unsigned short, unsigned short>>
-                                new_constraint_indicator;
-      std::vector<unsigned int> new_plain_indices, new_rowstart_plain;
-      unsigned int              position_cell = 0;
+                                  new_constraint_indicator;
+      std::vector<unsigned int>   new_plain_indices, new_rowstart_plain;
+      std::vector<unsigned short> new_hanging_node_constraint_masks;
+      unsigned int                position_cell = 0;
       new_dof_indices.reserve(dof_indices.size());
       new_constraint_indicator.reserve(constraint_indicator.size());
       if (store_plain_indices == true)
@@ -563,6 +569,9 @@ namespace internal
                                     numbers::invalid_unsigned_int);
           new_plain_indices.reserve(plain_dof_indices.size());
         }
+      if (!hanging_node_constraint_masks.empty())
+        new_hanging_node_constraint_masks.resize(
+          vectorization_length * task_info.cell_partition_data.back(), 0);
 
       // copy the indices and the constraint indicators to the new data field,
       // where we will go through the cells in the renumbered way. in case the
@@ -602,9 +611,17 @@ namespace internal
                     new_constraint_indicator.push_back(
                       constraint_indicator[index]);
                 }
+              const bool has_hanging_nodes =
+                !hanging_node_constraint_masks.empty() &&
+                hanging_node_constraint_masks[cell_no / n_components] != 0;
+              if (has_hanging_nodes)
+                new_hanging_node_constraint_masks[i * vectorization_length +
+                                                  j] =
+                  hanging_node_constraint_masks[cell_no / n_components];
               if (store_plain_indices &&
-                  row_starts[cell_no].second !=
-                    row_starts[cell_no + n_components].second)
+                  (row_starts[cell_no].second !=
+                     row_starts[cell_no + n_components].second ||
+                   has_hanging_nodes))
                 {
                   new_rowstart_plain[i * vectorization_length + j] =
                     new_plain_indices.size();
@@ -647,6 +664,7 @@ namespace internal
       new_constraint_indicator.swap(constraint_indicator);
       new_plain_indices.swap(plain_dof_indices);
       new_rowstart_plain.swap(row_starts_plain_indices);
+      new_hanging_node_constraint_masks.swap(hanging_node_constraint_masks);
 
 #ifdef DEBUG
       // sanity check 1: all indices should be smaller than the number of dofs
@@ -1956,6 +1974,8 @@ namespace internal
       memory += MemoryConsumption::memory_consumption(dof_indices);
       memory += MemoryConsumption::memory_consumption(row_starts_plain_indices);
       memory += MemoryConsumption::memory_consumption(plain_dof_indices);
+      memory +=
+        MemoryConsumption::memory_consumption(hanging_node_constraint_masks);
       memory += MemoryConsumption::memory_consumption(constraint_indicator);
       memory += MemoryConsumption::memory_consumption(*vector_partitioner);
       return memory;
@@ -29,8 +29,10 @@
 
 #include <deal.II/lac/vector_operation.h>
 
+#include <deal.II/matrix_free/evaluation_flags.h>
 #include <deal.II/matrix_free/evaluation_kernels.h>
 #include <deal.II/matrix_free/evaluation_selector.h>
+#include <deal.II/matrix_free/hanging_nodes_internal.h>
 #include <deal.II/matrix_free/mapping_data_on_the_fly.h>
 #include <deal.II/matrix_free/matrix_free.h>
 #include <deal.II/matrix_free/shape_info.h>
@@ -57,106 +59,6 @@ template <int dim,
 class FEEvaluation;
 
 
-/**
- * @brief The namespace for the EvaluationFlags enum
- *
- * This namespace contains the enum EvaluationFlags used in FEEvaluation
- * to control evaluation and integration of values, gradients, etc..
- */
-namespace EvaluationFlags
-{
-  /**
-   * @brief The EvaluationFlags enum
-   *
-   * This enum contains a set of flags used by FEEvaluation::integrate(),
-   * FEEvaluation::evaluate() and others to determine if values, gradients,
-   * hessians, or a combination of them is being used.
-   */
-  enum EvaluationFlags
-  {
-    /**
-     * Do not use or compute anything.
-     */
-    nothing = 0,
-    /**
-     * Use or evaluate values.
-     */
-    values = 0x1,
-    /**
-     * Use or evaluate gradients.
-     */
-    gradients = 0x2,
-    /**
-     * Use or evaluate hessians.
-     */
-    hessians = 0x4
-  };
-
-
-  /**
-   * Global operator which returns an object in which all bits are set which are
-   * either set in the first or the second argument. This operator exists since
-   * if it did not then the result of the bit-or <tt>operator |</tt> would be an
-   * integer which would in turn trigger a compiler warning when we tried to
-   * assign it to an object of type UpdateFlags.
-   *
-   * @ref EvaluationFlags
-   */
-  inline EvaluationFlags
-  operator|(const EvaluationFlags f1, const EvaluationFlags f2)
-  {
-    return static_cast<EvaluationFlags>(static_cast<unsigned int>(f1) |
-                                        static_cast<unsigned int>(f2));
-  }
-
-
-
-  /**
-   * Global operator which sets the bits from the second argument also in the
-   * first one.
-   *
-   * @ref EvaluationFlags
-   */
-  inline EvaluationFlags &
-  operator|=(EvaluationFlags &f1, const EvaluationFlags f2)
-  {
-    f1 = f1 | f2;
-    return f1;
-  }
-
-
-  /**
-   * Global operator which returns an object in which all bits are set which are
-   * set in the first as well as the second argument. This operator exists since
-   * if it did not then the result of the bit-and <tt>operator &</tt> would be
-   * an integer which would in turn trigger a compiler warning when we tried to
-   * assign it to an object of type UpdateFlags.
-   *
-   * @ref EvaluationFlags
-   */
-  inline EvaluationFlags operator&(const EvaluationFlags f1,
-                                   const EvaluationFlags f2)
-  {
-    return static_cast<EvaluationFlags>(static_cast<unsigned int>(f1) &
-                                        static_cast<unsigned int>(f2));
-  }
-
-
-  /**
-   * Global operator which clears all the bits in the first argument if they are
-   * not also set in the second argument.
-   *
-   * @ref EvaluationFlags
-   */
-  inline EvaluationFlags &
-  operator&=(EvaluationFlags &f1, const EvaluationFlags f2)
-  {
-    f1 = f1 & f2;
-    return f1;
-  }
-
-} // namespace EvaluationFlags
-
 /**
  * This is the base class for the FEEvaluation classes. This class is a base
  * class and needs usually not be called in user code. It does not have any
@@ -993,6 +895,18 @@ protected:
   read_write_operation_global(const VectorOperation &operation,
                               VectorType *           vectors[]) const;
 
+  /**
+   * Apply the hanging-node constraints to the values in the dof values
+   * array on cells where MatrixFree has chosen to resolve them on the fly
+   * rather than through the constraint pool, see
+   * MatrixFree::AdditionalData::use_fast_hanging_node_algorithm. The
+   * interpolation from the indices of the coarser neighbor is applied after
+   * reading the values from a vector, the transpose operation is applied
+   * before writing into a vector.
+   */
+  void
+  apply_hanging_node_constraints(const bool transpose) const;
+
   /**
    * This is the general array for all data fields.
    */
@@ -1173,6 +1087,15 @@ protected:
    */
   unsigned int face_no;
 
+  /**
+   * Stores the number of the face within the cells of the current batch
+   * after a call to FEFaceEvaluation::reinit(cell_index, face_number). On
+   * the exterior side, `face_no` instead holds the number of the face as seen
+   * from the neighbors, whose values are read, and the present variable is
+   * needed to look up these neighbors.
+   */
+  unsigned int face_no_in_cell;
+
   /**
    * Stores the orientation of the given face with respect to the standard
    * orientation, 0 if in standard orientation.
@@ -2965,6 +2888,15 @@ public:
    * method is less efficient than the other reinit() method taking a
    * numbering of the faces because it needs to copy the data associated with
    * the faces to the cells in this call.
+   *
+   * If this object was set up for the exterior side of faces, the vector
+   * access functions read from and write into the neighbors of the cells
+   * across the given face, and the values are interpolated to the face as
+   * seen from the neighbors. This is the basis for the cell-centric loop
+   * MatrixFree::loop_cell_centric() and requires the
+   * MatrixFree::AdditionalData::hold_all_faces_to_owned_cells option. Faces
+   * with hanging nodes and neighbors that see the face with different face
+   * numbers or orientations within one batch of cells are not supported.
    */
   void
   reinit(const unsigned int cell_batch_number, const unsigned int face_number);
@@ -3578,9 +3510,12 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
     std::max(tensor_dofs_per_component + 1, dofs_per_component) *
       n_components_ * 3 +
     2 * n_quadrature_points;
+  // one line of degrees of freedom at the end of the array is reserved for
+  // the hanging-node interpolation
   const unsigned int allocated_size =
     shift + n_components_ * dofs_per_component +
-    (n_components_ * (dim * dim + 2 * dim + 1) * n_quadrature_points);
+    (n_components_ * (dim * dim + 2 * dim + 1) * n_quadrature_points) +
+    (this->data->data.front().fe_degree + 1);
   scratch_data_array->resize_fast(allocated_size);
 
   // set the pointers to the correct position in the data array
@@ -3785,9 +3720,8 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
           const unsigned int cell_this = this->cell * n_lanes + i;
           // compute face ID
           unsigned int face_index =
-            this->matrix_info->get_cell_and_face_to_plain_faces()(this->cell,
-                                                                  this->face_no,
-                                                                  i);
+            this->matrix_info->get_cell_and_face_to_plain_faces()(
+              this->cell, this->face_no_in_cell, i);
 
           if (face_index == numbers::invalid_unsigned_int)
             continue; // invalid face ID: no neighbor on boundary
@@ -3998,15 +3932,54 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
       internal::check_vector_compatibility(*src[0], *dof_info);
     }
 
+  // On the exterior side of a face in the cell-centric loop, the lanes refer
+  // to the neighbors of the cells in the current batch, which are in general
+  // not in the same batch
+  const bool is_neighbor_access =
+    is_face &&
+    dof_access_index ==
+      internal::MatrixFreeFunctions::DoFInfo::dof_access_cell &&
+    is_interior_face == false;
+  std::array<unsigned int, VectorizedArrayType::size()> neighbor_cells;
+  if (is_neighbor_access)
+    neighbor_cells = this->get_cell_ids();
+
+  // On cells where the hanging-node constraints are applied on the fly, the
+  // indices on the constrained faces and edges refer to the coarser
+  // neighbor. The access without constraints and the setter must instead
+  // work on the indices of the cell itself, which are stored as plain indices
+  constexpr bool is_setter =
+    std::is_same<VectorOperation,
+                 internal::VectorSetter<Number, VectorizedArrayType>>::value;
+  bool use_plain_indices_for_hanging_nodes = false;
+  if (!is_face && (apply_constraints == false || is_setter) &&
+      !dof_info->hanging_node_constraint_masks.empty())
+    for (unsigned int v = 0; v < VectorizedArrayType::size(); ++v)
+      if (dof_info->hanging_node_constraint_masks
+            [cell * VectorizedArrayType::size() + v] !=
+          internal::MatrixFreeFunctions::unconstrained)
+        use_plain_indices_for_hanging_nodes = true;
+
   // Case 2: contiguous indices which use reduced storage of indices and can
   // use vectorized load/store operations -> go to separate function
   AssertIndexRange(cell,
                    dof_info->index_storage_variants[dof_access_index].size());
-  if (dof_info->index_storage_variants
-        [is_face ? dof_access_index :
-                   internal::MatrixFreeFunctions::DoFInfo::dof_access_cell]
-        [cell] >=
-      internal::MatrixFreeFunctions::DoFInfo::IndexStorageVariants::contiguous)
+  bool is_contiguous =
+    dof_info->index_storage_variants
+      [is_face ? dof_access_index :
+                 internal::MatrixFreeFunctions::DoFInfo::dof_access_cell]
+      [cell] >=
+    internal::MatrixFreeFunctions::DoFInfo::IndexStorageVariants::contiguous;
+  if (is_neighbor_access)
+    for (const unsigned int neighbor : neighbor_cells)
+      if (neighbor != numbers::invalid_unsigned_int &&
+          dof_info->index_storage_variants
+              [internal::MatrixFreeFunctions::DoFInfo::dof_access_cell]
+              [neighbor / VectorizedArrayType::size()] <
+            internal::MatrixFreeFunctions::DoFInfo::IndexStorageVariants::
+              contiguous)
+        is_contiguous = false;
+  if (is_contiguous && !use_plain_indices_for_hanging_nodes)
     {
       read_write_operation_contiguous(operation, src, mask);
       return;
@@ -4025,11 +3998,13 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
 
   const unsigned int dofs_per_component =
     this->data->dofs_per_component_on_cell;
-  if (dof_info->index_storage_variants
-        [is_face ? dof_access_index :
-                   internal::MatrixFreeFunctions::DoFInfo::dof_access_cell]
-        [cell] ==
-      internal::MatrixFreeFunctions::DoFInfo::IndexStorageVariants::interleaved)
+  if (!is_neighbor_access && !use_plain_indices_for_hanging_nodes &&
+      dof_info->index_storage_variants
+          [is_face ? dof_access_index :
+                     internal::MatrixFreeFunctions::DoFInfo::dof_access_cell]
+          [cell] ==
+        internal::MatrixFreeFunctions::DoFInfo::IndexStorageVariants::
+          interleaved)
     {
       const unsigned int *dof_indices =
         dof_info->dof_indices_interleaved.data() +
@@ -4065,11 +4040,15 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
   const unsigned int *cells;
   unsigned int        n_vectorization_actual =
     dof_info->n_vectorization_lanes_filled[dof_access_index][cell];
-  bool has_constraints = false;
+  bool has_constraints = use_plain_indices_for_hanging_nodes;
+  bool has_empty_lanes = false;
   if (is_face)
     {
-      if (dof_access_index ==
-          internal::MatrixFreeFunctions::DoFInfo::dof_access_cell)
+      if (is_neighbor_access)
+        for (unsigned int v = 0; v < n_vectorization_actual; ++v)
+          cells_copied[v] = neighbor_cells[v];
+      else if (dof_access_index ==
+               internal::MatrixFreeFunctions::DoFInfo::dof_access_cell)
         for (unsigned int v = 0; v < n_vectorization_actual; ++v)
           cells_copied[v] = cell * VectorizedArrayType::size() + v;
       cells = dof_access_index ==
@@ -4080,6 +4059,13 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
                    &this->matrix_info->get_face_info(cell).cells_exterior[0]);
       for (unsigned int v = 0; v < n_vectorization_actual; ++v)
         {
+          // lanes at the boundary have no neighbor to read from
+          if (is_neighbor_access && cells[v] == numbers::invalid_unsigned_int)
+            {
+              dof_indices[v]  = nullptr;
+              has_empty_lanes = true;
+              continue;
+            }
           Assert(cells[v] < dof_info->row_starts.size() - 1,
                  ExcInternalError());
           const std::pair<unsigned int, unsigned int> *my_index_start =
@@ -4127,7 +4113,7 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
 
   // Case where we have no constraints throughout the whole cell: Can go
   // through the list of DoFs directly
-  if (!has_constraints)
+  if (!has_constraints && !has_empty_lanes)
     {
       if (n_vectorization_actual < n_lanes)
         for (unsigned int comp = 0; comp < n_components; ++comp)
@@ -4160,12 +4146,15 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
   // holds local number on cell, index iterates over the elements of
   // index_local_to_global and dof_indices points to the global indices stored
   // in index_local_to_global
-  if (n_vectorization_actual < n_lanes)
+  if (n_vectorization_actual < n_lanes || has_empty_lanes)
     for (unsigned int comp = 0; comp < n_components; ++comp)
       for (unsigned int i = 0; i < dofs_per_component; ++i)
         operation.process_empty(values_dofs[comp][i]);
   for (unsigned int v = 0; v < n_vectorization_actual; ++v)
     {
+      if (dof_indices[v] == nullptr)
+        continue;
+
       const unsigned int cell_index = is_face ? cells[v] : cell * n_lanes + v;
       const unsigned int cell_dof_index =
         cell_index * n_fe_components + first_selected_component;
@@ -4177,10 +4166,15 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
         dof_info->row_starts[cell_dof_index + 1].second;
 
       // For read_dof_values_plain, redirect the dof_indices field to the
-      // unconstrained indices
-      if (apply_constraints == false &&
-          dof_info->row_starts[cell_dof_index].second !=
-            dof_info->row_starts[cell_dof_index + n_components_read].second)
+      // unconstrained indices. The same is done for cells with hanging-node
+      // constraints applied on the fly, see above
+      if ((apply_constraints == false &&
+           dof_info->row_starts[cell_dof_index].second !=
+             dof_info->row_starts[cell_dof_index + n_components_read]
+               .second) ||
+          (use_plain_indices_for_hanging_nodes &&
+           dof_info->hanging_node_constraint_masks[cell_index] !=
+             internal::MatrixFreeFunctions::unconstrained))
         {
           Assert(dof_info->row_starts_plain_indices[cell_index] !=
                    numbers::invalid_unsigned_int,
@@ -4343,6 +4337,47 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
 
 
 
+template <int dim,
+          int n_components_,
+          typename Number,
+          bool is_face,
+          typename VectorizedArrayType>
+inline void
+FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
+  apply_hanging_node_constraints(const bool transpose) const
+{
+  if (is_face || matrix_info == nullptr ||
+      dof_info->hanging_node_constraint_masks.empty())
+    return;
+
+  constexpr unsigned int n_lanes = VectorizedArrayType::size();
+  AssertIndexRange((cell + 1) * n_lanes,
+                   dof_info->hanging_node_constraint_masks.size() + 1);
+  const unsigned short *masks =
+    dof_info->hanging_node_constraint_masks.data() + cell * n_lanes;
+  const unsigned int n_filled_lanes =
+    dof_info->n_vectorization_lanes_filled
+      [internal::MatrixFreeFunctions::DoFInfo::dof_access_cell][cell];
+
+  bool has_hanging_nodes = false;
+  for (unsigned int v = 0; v < n_filled_lanes; ++v)
+    if (masks[v] != internal::MatrixFreeFunctions::unconstrained)
+      has_hanging_nodes = true;
+  if (has_hanging_nodes == false)
+    return;
+
+  internal::MatrixFreeFunctions::apply_hanging_node_constraints<dim>(
+    data->data.front(),
+    masks,
+    n_filled_lanes,
+    n_components,
+    &this->values_dofs[0],
+    scratch_data_array->end() - (data->data.front().fe_degree + 1),
+    transpose);
+}
+
+
+
 template <int dim,
           int n_components_,
           typename Number,
@@ -4374,6 +4409,78 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
   const std::vector<unsigned int> &dof_indices_cont =
     dof_info->dof_indices_contiguous[ind];
 
+  // Exterior side of a face in the cell-centric loop: the neighbors of the
+  // cells in the batch are not laid out along the lanes, so gather their
+  // entries with the stride of the respective neighbor
+  if (is_face &&
+      ind == internal::MatrixFreeFunctions::DoFInfo::dof_access_cell &&
+      is_interior_face == false)
+    {
+      const auto   cells = this->get_cell_ids();
+      unsigned int dof_indices[VectorizedArrayType::size()];
+      unsigned int strides[VectorizedArrayType::size()];
+      bool         all_lanes_filled = true;
+      for (unsigned int v = 0; v < VectorizedArrayType::size(); ++v)
+        if (cells[v] != numbers::invalid_unsigned_int && mask[v] == true)
+          {
+            strides[v] =
+              dof_info->dof_indices_interleave_strides[ind][cells[v]];
+            dof_indices[v] =
+              dof_indices_cont[cells[v]] +
+              dof_info->component_dof_indices_offset[active_fe_index]
+                                                    [first_selected_component] *
+                strides[v];
+          }
+        else
+          {
+            strides[v]       = 0;
+            dof_indices[v]   = numbers::invalid_unsigned_int;
+            all_lanes_filled = false;
+          }
+
+      // with one vector per component, all components start at the same
+      // index, otherwise the components follow each other
+      const bool separate_vectors = n_components == 1 || n_fe_components == 1;
+      const unsigned int dofs_per_component = data->dofs_per_component_on_cell;
+      if (all_lanes_filled)
+        for (unsigned int comp = 0; comp < n_components; ++comp)
+          {
+            unsigned int indices[VectorizedArrayType::size()];
+            for (unsigned int v = 0; v < VectorizedArrayType::size(); ++v)
+              indices[v] =
+                dof_indices[v] +
+                (separate_vectors ? 0 : comp * dofs_per_component) * strides[v];
+            for (unsigned int i = 0; i < dofs_per_component; ++i)
+              {
+                operation.process_dof_gather(indices,
+                                             *src[separate_vectors ? comp : 0],
+                                             0,
+                                             values_dofs[comp][i],
+                                             vector_selector);
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int v = 0; v < VectorizedArrayType::size(); ++v)
+                  indices[v] += strides[v];
+              }
+          }
+      else
+        for (unsigned int comp = 0; comp < n_components; ++comp)
+          {
+            for (unsigned int i = 0; i < dofs_per_component; ++i)
+              operation.process_empty(values_dofs[comp][i]);
+            const unsigned int vector_index = separate_vectors ? comp : 0;
+            const unsigned int component_shift =
+              separate_vectors ? 0 : comp * dofs_per_component;
+            for (unsigned int v = 0; v < VectorizedArrayType::size(); ++v)
+              if (dof_indices[v] != numbers::invalid_unsigned_int)
+                for (unsigned int i = 0; i < dofs_per_component; ++i)
+                  operation.process_dof(dof_indices[v] +
+                                          (component_shift + i) * strides[v],
+                                        *src[vector_index],
+                                        values_dofs[comp][i][v]);
+          }
+      return;
+    }
+
   // Simple case: We have contiguous storage, so we can simply copy out the
   // data
   if (dof_info->index_storage_variants[ind][cell] ==
@@ -4610,6 +4717,8 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
                        std::bitset<VectorizedArrayType::size()>().flip(),
                        true);
 
+  apply_hanging_node_constraints(false);
+
 #  ifdef DEBUG
   dof_values_initialized = true;
 #  endif
@@ -4680,6 +4789,8 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
       IsBlockVector<VectorType>::value>::get_vector_component(dst,
                                                               d + first_index);
 
+  apply_hanging_node_constraints(true);
+
   internal::VectorDistributorLocalToGlobal<Number, VectorizedArrayType>
     distributor;
   read_write_operation(distributor, dst_data, mask);
@@ -7747,9 +7858,87 @@ FEFaceEvaluation<dim,
   this->face_orientation = 0;
   this->subface_index    = GeometryInfo<dim>::max_children_per_cell;
   this->face_no          = face_number;
+  this->face_no_in_cell  = face_number;
   this->dof_access_index =
     internal::MatrixFreeFunctions::DoFInfo::dof_access_cell;
 
+  // On the exterior side, the values are read from the neighbors and must be
+  // interpolated to the face as seen from the neighbor, i.e., with the face
+  // number and orientation of the neighbor. Collect them from the face
+  // batches the cells of the current batch are part of.
+  //
+  // The following restrictions depend on the mesh rather than on the code
+  // calling this function, so they are also checked in release mode.
+  if (this->is_interior_face == false)
+    {
+      AssertThrow(
+        this->matrix_info->get_cell_and_face_to_plain_faces().size(0) >
+          cell_index,
+        ExcMessage("Accessing the neighbors on the exterior side of "
+                   "faces requires that all faces of the owned cells "
+                   "are held by MatrixFree. Set "
+                   "MatrixFree::AdditionalData::"
+                   "hold_all_faces_to_owned_cells to true."));
+
+      constexpr unsigned int n_lanes = VectorizedArrayType::size();
+      bool                   is_first_lane = true;
+      for (unsigned int v = 0; v < n_lanes; ++v)
+        {
+          const unsigned int face_index =
+            this->matrix_info->get_cell_and_face_to_plain_faces()(cell_index,
+                                                                  face_number,
+                                                                  v);
+          if (face_index == numbers::invalid_unsigned_int)
+            continue;
+
+          const internal::MatrixFreeFunctions::FaceToCellTopology<n_lanes>
+            &faces = this->matrix_info->get_face_info(face_index / n_lanes);
+          const unsigned int lane = face_index % n_lanes;
+          if (faces.cells_exterior[lane] == numbers::invalid_unsigned_int)
+            continue; // boundary face: no neighbor
+
+          AssertThrow(faces.subface_index ==
+                        GeometryInfo<dim>::max_children_per_cell,
+                      ExcNotImplemented("Neighbors across faces with hanging "
+                                        "nodes are not supported in the "
+                                        "cell-centric loop."));
+
+          // the face orientation is stored relative to the interior side if
+          // smaller than 8 and relative to the exterior side otherwise
+          const bool cell_is_interior =
+            faces.cells_interior[lane] == cell_index * n_lanes + v;
+          const unsigned int neighbor_face_no =
+            cell_is_interior ? faces.exterior_face_no : faces.interior_face_no;
+          const unsigned int neighbor_orientation =
+            cell_is_interior ?
+              (faces.face_orientation < 8 ? faces.face_orientation : 0) :
+              (faces.face_orientation > 8 ? faces.face_orientation - 8 : 0);
+          AssertThrow((cell_is_interior ?
+                         (faces.face_orientation > 8 ?
+                            faces.face_orientation - 8 :
+                            0) :
+                         (faces.face_orientation < 8 ? faces.face_orientation :
+                                                       0)) == 0,
+                      ExcNotImplemented("The quadrature points on the face of "
+                                        "the present cell are not in standard "
+                                        "orientation."));
+
+          if (is_first_lane)
+            {
+              this->face_no          = neighbor_face_no;
+              this->face_orientation = neighbor_orientation;
+              is_first_lane          = false;
+            }
+          else
+            AssertThrow(this->face_no == neighbor_face_no &&
+                          this->face_orientation == neighbor_orientation,
+                        ExcNotImplemented(
+                          "The neighbors of the cells in the current batch "
+                          "see the face with different face numbers or "
+                          "orientations, which is not supported."));
+        }
+    }
+
   const unsigned int offsets =
     this->matrix_info->get_mapping_info()
       .face_data_by_cells[this->quad_no]
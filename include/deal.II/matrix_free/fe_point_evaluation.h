@@ -0,0 +1,852 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_fe_point_evaluation_h
+#define dealii_fe_point_evaluation_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/polynomial.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/tensor_product_polynomials.h>
+
+#include <deal.II/fe/fe_poly.h>
+#include <deal.II/fe/fe_update_flags.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/matrix_free/evaluation_flags.h>
+#include <deal.II/matrix_free/tensor_product_kernels.h>
+
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace internal
+{
+  namespace FEPointEvaluation
+  {
+    /**
+     * Types and access functions for the values and gradients of a
+     * vector-valued field with @p n_components components.
+     */
+    template <int dim, int spacedim, int n_components, typename Number>
+    struct EvaluatorTypeTraits
+    {
+      using value_type = Tensor<1, n_components, Number>;
+      using gradient_type =
+        Tensor<1, n_components, Tensor<1, spacedim, Number>>;
+      using unit_gradient_type = Tensor<1, dim, value_type>;
+
+      static Number &
+      access(value_type &value, const unsigned int component)
+      {
+        return value[component];
+      }
+
+      static const Number &
+      access(const value_type &value, const unsigned int component)
+      {
+        return value[component];
+      }
+
+      static Number &
+      access(gradient_type &    gradient,
+             const unsigned int component,
+             const unsigned int direction)
+      {
+        return gradient[component][direction];
+      }
+
+      static const Number &
+      access(const gradient_type &gradient,
+             const unsigned int   component,
+             const unsigned int   direction)
+      {
+        return gradient[component][direction];
+      }
+    };
+
+    /**
+     * Specialization of the types and access functions for scalar fields.
+     */
+    template <int dim, int spacedim, typename Number>
+    struct EvaluatorTypeTraits<dim, spacedim, 1, Number>
+    {
+      using value_type         = Number;
+      using gradient_type      = Tensor<1, spacedim, Number>;
+      using unit_gradient_type = Tensor<1, dim, value_type>;
+
+      static Number &
+      access(value_type &value, const unsigned int)
+      {
+        return value;
+      }
+
+      static const Number &
+      access(const value_type &value, const unsigned int)
+      {
+        return value;
+      }
+
+      static Number &
+      access(gradient_type &gradient,
+             const unsigned int,
+             const unsigned int direction)
+      {
+        return gradient[direction];
+      }
+
+      static const Number &
+      access(const gradient_type &gradient,
+             const unsigned int,
+             const unsigned int direction)
+      {
+        return gradient[direction];
+      }
+    };
+  } // namespace FEPointEvaluation
+} // namespace internal
+
+
+
+/**
+ * This class provides an interface to the evaluation of interpolated
+ * solution values and gradients on cells on arbitrary reference point
+ * positions. These points can change from cell to cell, both with respect to
+ * their quantity as well to the location. The two typical use cases are
+ * evaluations on non-matching grids and particle simulations.
+ *
+ * The use of this class is similar to FEValues or FEEvaluation: The class is
+ * first initialized to a cell by calling <code>FEPointEvaluation::reinit(cell,
+ * unit_points)</code>, with the main difference to the other concepts that
+ * the underlying points in reference coordinates need to be passed along.
+ * Then, upon call to evaluate() or integrate(), the user can compute
+ * information at the give points. Eventually, the access functions
+ * get_value() or get_gradient() allow to query this information at a
+ * specific point index.
+ *
+ * The functionality is similar to creating an FEValues object with a
+ * Quadrature object on the <code>unit_points</code> on every cell separately
+ * and then calling FEValues::get_function_values or
+ * FEValues::get_function_gradients, and for some elements and mappings this
+ * is what actually happens internally. For specific combinations of Mapping
+ * and FiniteElement realizations, however, there is a much more efficient
+ * implementation that avoids the memory allocation and other expensive
+ * start-up cost of FEValues. Currently, the functionality is specialized for
+ * mappings derived from MappingQGeneric and for finite elements with tensor
+ * product structure that work with the
+ * @ref matrixfree "matrix-free framework", such as FE_Q and FE_DGQ, either
+ * as scalar elements or within an FESystem whose selected components all
+ * refer to the same type of base element. In those cases, the cost implied
+ * by this class is similar (or sometimes even somewhat lower) than using
+ * `FEValues::reinit(cell)` followed by `FEValues::get_function_gradients`:
+ * The values and gradients are computed point by point with sum
+ * factorization, i.e., by first evaluating the one-dimensional polynomials
+ * in each coordinate direction of the point and then contracting the
+ * coefficients of the cell direction by direction, see
+ * internal::evaluate_tensor_product_value_and_gradient().
+ *
+ * The class also provides the transpose operation, integrate(), that
+ * multiplies the values and gradients submitted by submit_value() and
+ * submit_gradient() at each point by the values and gradients of the test
+ * functions and sums the contributions of all points into the coefficients
+ * of the cell. This is needed to assemble right hand sides or operators in
+ * particle-in-cell or immersed-boundary methods. Note that no quadrature
+ * weights are involved in this operation, so the user needs to multiply the
+ * submitted quantities by the weight associated with each point, if any.
+ *
+ * @tparam n_components Number of vector components when evaluating a
+ * vector-valued field, starting at the component given to the constructor.
+ * For <code>n_components == 1</code>, the values are of type @p Number and
+ * the gradients of type <code>Tensor<1, spacedim, Number></code>; otherwise,
+ * the values are of type <code>Tensor<1, n_components, Number></code> and
+ * the gradients of type
+ * <code>Tensor<1, n_components, Tensor<1, spacedim, Number>></code>.
+ *
+ * @tparam dim Dimension of the reference cell.
+ *
+ * @tparam spacedim Dimension of the space the cell is embedded in.
+ *
+ * @tparam Number Scalar type of the solution coefficients and the evaluated
+ * quantities.
+ */
+template <int n_components,
+          int dim,
+          int spacedim    = dim,
+          typename Number = double>
+class FEPointEvaluation
+{
+public:
+  using value_type = typename internal::FEPointEvaluation::
+    EvaluatorTypeTraits<dim, spacedim, n_components, Number>::value_type;
+  using gradient_type = typename internal::FEPointEvaluation::
+    EvaluatorTypeTraits<dim, spacedim, n_components, Number>::gradient_type;
+
+  /**
+   * Constructor.
+   *
+   * @param mapping The Mapping class describing the actual geometry of a cell
+   * passed to the reinit() function.
+   *
+   * @param fe The FiniteElement object that is used for the evaluation, which
+   * is typically the same on all cells to be evaluated.
+   *
+   * @param update_flags Specify the quantities to be computed by the mapping
+   * during the call of reinit(). During evaluate() or integrate(), this data
+   * is queried to produce the desired result (e.g., the gradient of a finite
+   * element solution). Use update_values and update_gradients to request the
+   * respective operations of evaluate() and integrate(), and
+   * update_quadrature_points, update_jacobians and update_inverse_jacobians
+   * to query the geometry with real_point(), jacobian() and
+   * inverse_jacobian().
+   *
+   * @param first_selected_component For multi-component FiniteElement
+   * objects, this parameter allows to select a range of `n_components`
+   * components starting from this parameter.
+   */
+  FEPointEvaluation(const Mapping<dim, spacedim> &      mapping,
+                    const FiniteElement<dim, spacedim> &fe,
+                    const UpdateFlags                   update_flags,
+                    const unsigned int first_selected_component = 0);
+
+  /**
+   * Set up the mapping information for the given cell, e.g., by computing the
+   * Jacobian of the mapping for the given points if gradients of the
+   * functions are requested.
+   *
+   * @param[in] cell An iterator to the current cell
+   *
+   * @param[in] unit_points List of points in the reference locations of the
+   * current cell where the FiniteElement object should be
+   * evaluated/integrated in the evaluate() and integrate() functions.
+   */
+  void
+  reinit(const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+         const ArrayView<const Point<dim>> &unit_points);
+
+  /**
+   * This function interpolates the finite element solution, represented by
+   * `solution_values`, on the cell and `unit_points` passed to reinit().
+   *
+   * @param[in] solution_values This array is supposed to contain the unknown
+   * values on the element as returned by `cell->get_dof_values(global_vector,
+   * solution_values)`.
+   *
+   * @param[in] evaluation_flag Flags specifying which quantities should be
+   * evaluated at the points.
+   */
+  void
+  evaluate(const ArrayView<const Number> &         solution_values,
+           const EvaluationFlags::EvaluationFlags &evaluation_flag);
+
+  /**
+   * This function multiplies the quantities passed in by previous
+   * submit_value() or submit_gradient() calls by the value or gradient of the
+   * test functions, and performs summation over all given points.
+   *
+   * @param[out] solution_values This array will contain the result of the
+   * integral, which can be used during
+   * `cell->set_dof_values(solution_values, global_vector)` or
+   * `cell->distribute_local_to_global(solution_values, global_vector)`. The
+   * entries that belong to the selected components are overwritten, all
+   * other entries are left untouched.
+   *
+   * @param[in] integration_flags Flags specifying which quantities should be
+   * integrated at the points.
+   */
+  void
+  integrate(const ArrayView<Number> &               solution_values,
+            const EvaluationFlags::EvaluationFlags &integration_flags);
+
+  /**
+   * Return the value at point number @p point_index after a call to
+   * FEPointEvaluation::evaluate() with EvaluationFlags::values set, or the
+   * value that has been stored there with a call to
+   * FEPointEvaluation::submit_value(). If the object is vector-valued, a
+   * vector-valued return argument is given.
+   */
+  const value_type &
+  get_value(const unsigned int point_index) const;
+
+  /**
+   * Write a value to the field containing the values on points with
+   * component point_index. Access to the same field as through get_value().
+   * If applied before the function FEPointEvaluation::integrate() with
+   * EvaluationFlags::values set is called, this specifies the value which is
+   * tested by all basis function on the current cell and integrated over.
+   */
+  void
+  submit_value(const value_type &value, const unsigned int point_index);
+
+  /**
+   * Return the gradient in real coordinates at the point with index
+   * `point_index` after a call to FEPointEvaluation::evaluate() with
+   * EvaluationFlags::gradients set, or the gradient that has been stored
+   * there with a call to FEPointEvaluation::submit_gradient(). The gradient
+   * in real coordinates is obtained by taking the unit gradient and
+   * applying the inverse Jacobian of the mapping.
+   */
+  const gradient_type &
+  get_gradient(const unsigned int point_index) const;
+
+  /**
+   * Write a contribution that is tested by the gradient to the field
+   * containing the values on points with the given `point_index`. Access to
+   * the same field as through get_gradient(). If applied before the function
+   * FEPointEvaluation::integrate(EvaluationFlags::gradients) is called, this
+   * specifies what is tested by all basis function gradients on the current
+   * cell and integrated over.
+   */
+  void
+  submit_gradient(const gradient_type &, const unsigned int point_index);
+
+  /**
+   * Return the Jacobian of the transformation on the current cell with the
+   * given point index. Prerequisite: This class needs to be constructed with
+   * UpdateFlags containing `update_jacobians`.
+   */
+  DerivativeForm<1, dim, spacedim>
+  jacobian(const unsigned int point_index) const;
+
+  /**
+   * Return the inverse of the Jacobian of the transformation on the current
+   * cell with the given point index. Prerequisite: This class needs to be
+   * constructed with UpdateFlags containing `update_inverse_jacobians` or
+   * `update_gradients`.
+   */
+  DerivativeForm<1, spacedim, dim>
+  inverse_jacobian(const unsigned int point_index) const;
+
+  /**
+   * Return the position in real coordinates of the given point index among
+   * the points passed to reinit(). Prerequisite: This class needs to be
+   * constructed with UpdateFlags containing `update_quadrature_points`.
+   */
+  Point<spacedim>
+  real_point(const unsigned int point_index) const;
+
+  /**
+   * Return the position in unit/reference coordinates of the given point
+   * index, i.e., the respective point passed to the reinit() function.
+   */
+  Point<dim>
+  unit_point(const unsigned int point_index) const;
+
+  /**
+   * Return the number of points passed to the last call of reinit().
+   */
+  unsigned int
+  n_points() const;
+
+private:
+  using Traits = internal::FEPointEvaluation::
+    EvaluatorTypeTraits<dim, spacedim, n_components, Number>;
+
+  /**
+   * Pointer to the Mapping object passed to the constructor.
+   */
+  SmartPointer<const Mapping<dim, spacedim>> mapping;
+
+  /**
+   * Pointer to MappingQGeneric class that enables the fast path of this
+   * class, or a null pointer for other mappings.
+   */
+  const MappingQGeneric<dim, spacedim> *mapping_q_generic;
+
+  /**
+   * Pointer to the FiniteElement object passed to the constructor.
+   */
+  SmartPointer<const FiniteElement<dim, spacedim>> fe;
+
+  /**
+   * Description of the 1D polynomial basis for tensor product elements used
+   * for the fast path of this class using tensor product evaluators. Empty
+   * if the fast path is not available for the given element.
+   */
+  std::vector<Polynomials::Polynomial<double>> poly;
+
+  /**
+   * Renumbering between the unknowns of the selected components in the
+   * ordering of the finite element, as passed to evaluate() and integrate(),
+   * and the lexicographic numbering used by the tensor product evaluators,
+   * with the lexicographic index running faster than the component.
+   */
+  std::vector<unsigned int> renumber;
+
+  /**
+   * Temporary array to store the coefficients of the selected components in
+   * lexicographic order, combined into one object of @p value_type per
+   * basis function.
+   */
+  std::vector<value_type> solution_renumbered;
+
+  /**
+   * The first selected component in the active element.
+   */
+  const unsigned int first_selected_component;
+
+  /**
+   * Temporary array to store the values at the points.
+   */
+  std::vector<value_type> values;
+
+  /**
+   * Temporary array to store the gradients in real coordinates at the points.
+   */
+  std::vector<gradient_type> gradients;
+
+  /**
+   * The reference points specified at reinit().
+   */
+  std::vector<Point<dim>> unit_points;
+
+  /**
+   * The desired update flags for the evaluation.
+   */
+  const UpdateFlags update_flags;
+
+  /**
+   * The update flags handed to the mapping.
+   */
+  UpdateFlags update_flags_mapping;
+
+  /**
+   * The FEValues object underlying the slow evaluation path, which is used
+   * when the mapping or the finite element are not supported by the fast
+   * path.
+   */
+  std::shared_ptr<FEValues<dim, spacedim>> fe_values;
+
+  /**
+   * Array with the mapping information at the points, filled in reinit().
+   */
+  internal::FEValuesImplementation::MappingRelatedData<dim, spacedim>
+    mapping_data;
+};
+
+// ----------------------- template and inline function ----------------------
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+FEPointEvaluation<n_components, dim, spacedim, Number>::FEPointEvaluation(
+  const Mapping<dim, spacedim> &      mapping,
+  const FiniteElement<dim, spacedim> &fe,
+  const UpdateFlags                   update_flags,
+  const unsigned int                  first_selected_component)
+  : mapping(&mapping)
+  , mapping_q_generic(
+      dynamic_cast<const MappingQGeneric<dim, spacedim> *>(&mapping))
+  , fe(&fe)
+  , first_selected_component(first_selected_component)
+  , update_flags(update_flags)
+  , update_flags_mapping(update_default)
+{
+  AssertIndexRange(first_selected_component + n_components,
+                   fe.n_components() + 1);
+
+  // check whether all selected components are described by the same type
+  // of scalar tensor product element, in which case the fast path with
+  // sum factorization is possible
+  bool                                same_base_element = true;
+  std::string                         base_element_name;
+  const FE_Poly<dim, spacedim> *      fe_poly = nullptr;
+  for (unsigned int c = 0; c < n_components; ++c)
+    {
+      const FiniteElement<dim, spacedim> &base_element = fe.base_element(
+        fe.component_to_base_index(first_selected_component + c).first);
+      if (c == 0)
+        {
+          base_element_name = base_element.get_name();
+          fe_poly = dynamic_cast<const FE_Poly<dim, spacedim> *>(&base_element);
+        }
+      else if (base_element.get_name() != base_element_name)
+        same_base_element = false;
+    }
+
+  const TensorProductPolynomials<dim> *tensor_product_polynomials =
+    fe_poly != nullptr ? dynamic_cast<const TensorProductPolynomials<dim> *>(
+                           &fe_poly->get_poly_space()) :
+                         nullptr;
+
+  if (same_base_element && tensor_product_polynomials != nullptr &&
+      fe_poly->n_components() == 1 &&
+      tensor_product_polynomials->get_underlying_polynomials().size() <=
+        internal::max_n_polynomials_point_evaluation)
+    {
+      poly = tensor_product_polynomials->get_underlying_polynomials();
+
+      const std::vector<unsigned int> &lexicographic =
+        fe_poly->get_poly_space_numbering_inverse();
+      const unsigned int dofs_per_component = fe_poly->dofs_per_cell;
+      renumber.resize(n_components * dofs_per_component);
+      for (unsigned int c = 0; c < n_components; ++c)
+        for (unsigned int i = 0; i < dofs_per_component; ++i)
+          renumber[c * dofs_per_component + i] =
+            fe.component_to_system_index(first_selected_component + c,
+                                         lexicographic[i]);
+      solution_renumbered.resize(dofs_per_component);
+    }
+
+  if (update_flags & update_gradients)
+    update_flags_mapping |= update_inverse_jacobians;
+  update_flags_mapping |=
+    update_flags &
+    (update_quadrature_points | update_jacobians | update_inverse_jacobians);
+}
+
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+void
+FEPointEvaluation<n_components, dim, spacedim, Number>::reinit(
+  const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+  const ArrayView<const Point<dim>> &                         unit_points)
+{
+  this->unit_points.resize(unit_points.size());
+  std::copy(unit_points.begin(), unit_points.end(), this->unit_points.begin());
+
+  if (!poly.empty() && mapping_q_generic != nullptr)
+    {
+      fe_values.reset();
+      mapping_q_generic->fill_mapping_data_for_generic_points(
+        cell, unit_points, update_flags_mapping, mapping_data);
+    }
+  else
+    {
+      // fall back to FEValues for the mapping data, and also for the shape
+      // functions if the element is not supported by the fast path
+      const UpdateFlags fe_values_flags =
+        update_flags_mapping |
+        (poly.empty() ? (update_flags & (update_values | update_gradients)) :
+                        update_default);
+      fe_values = std::make_shared<FEValues<dim, spacedim>>(
+        *mapping, *fe, Quadrature<dim>(this->unit_points), fe_values_flags);
+      fe_values->reinit(cell);
+
+      mapping_data.initialize(unit_points.size(), update_flags_mapping);
+      for (unsigned int q = 0; q < unit_points.size(); ++q)
+        {
+          if (update_flags_mapping & update_quadrature_points)
+            mapping_data.quadrature_points[q] = fe_values->quadrature_point(q);
+          if (update_flags_mapping & update_jacobians)
+            mapping_data.jacobians[q] = fe_values->jacobian(q);
+          if (update_flags_mapping & update_inverse_jacobians)
+            mapping_data.inverse_jacobians[q] =
+              fe_values->inverse_jacobian(q);
+        }
+    }
+
+  if (update_flags & update_values)
+    values.resize(unit_points.size());
+  if (update_flags & update_gradients)
+    gradients.resize(unit_points.size());
+}
+
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+void
+FEPointEvaluation<n_components, dim, spacedim, Number>::evaluate(
+  const ArrayView<const Number> &         solution_values,
+  const EvaluationFlags::EvaluationFlags &evaluation_flag)
+{
+  if (unit_points.empty())
+    return;
+
+  AssertDimension(solution_values.size(), fe->dofs_per_cell);
+  Assert(!(evaluation_flag & EvaluationFlags::values) ||
+           (update_flags & update_values),
+         ExcNotInitialized());
+  Assert(!(evaluation_flag & EvaluationFlags::gradients) ||
+           (update_flags & update_gradients),
+         ExcNotInitialized());
+
+  if (!poly.empty())
+    {
+      // fast path with tensor product evaluation
+      const unsigned int dofs_per_component = solution_renumbered.size();
+      for (unsigned int i = 0; i < dofs_per_component; ++i)
+        for (unsigned int c = 0; c < n_components; ++c)
+          Traits::access(solution_renumbered[i], c) =
+            solution_values[renumber[c * dofs_per_component + i]];
+
+      for (unsigned int q = 0; q < unit_points.size(); ++q)
+        {
+          const std::pair<value_type, typename Traits::unit_gradient_type>
+            val_and_grad =
+              internal::evaluate_tensor_product_value_and_gradient(
+                poly, solution_renumbered, unit_points[q]);
+          if (evaluation_flag & EvaluationFlags::values)
+            values[q] = val_and_grad.first;
+          if (evaluation_flag & EvaluationFlags::gradients)
+            {
+              // apply the transpose of the inverse Jacobian to get the
+              // gradient in real coordinates
+              const DerivativeForm<1, spacedim, dim> &inverse_jacobian =
+                mapping_data.inverse_jacobians[q];
+              for (unsigned int c = 0; c < n_components; ++c)
+                for (unsigned int e = 0; e < spacedim; ++e)
+                  {
+                    Number sum = 0;
+                    for (unsigned int d = 0; d < dim; ++d)
+                      sum += inverse_jacobian[d][e] *
+                             Traits::access(val_and_grad.second[d], c);
+                    Traits::access(gradients[q], c, e) = sum;
+                  }
+            }
+        }
+    }
+  else
+    {
+      // slow path with FEValues
+      Assert(fe_values.get() != nullptr,
+             ExcMessage(
+               "Not initialized. Please call FEPointEvaluation::reinit()"));
+      if (evaluation_flag & EvaluationFlags::values)
+        {
+          for (unsigned int q = 0; q < unit_points.size(); ++q)
+            values[q] = value_type();
+          for (unsigned int i = 0; i < fe->dofs_per_cell; ++i)
+            for (unsigned int c = 0; c < n_components; ++c)
+              if (fe->get_nonzero_components(i)[first_selected_component + c])
+                for (unsigned int q = 0; q < unit_points.size(); ++q)
+                  Traits::access(values[q], c) +=
+                    fe_values->shape_value_component(
+                      i, q, first_selected_component + c) *
+                    solution_values[i];
+        }
+      if (evaluation_flag & EvaluationFlags::gradients)
+        {
+          for (unsigned int q = 0; q < unit_points.size(); ++q)
+            gradients[q] = gradient_type();
+          for (unsigned int i = 0; i < fe->dofs_per_cell; ++i)
+            for (unsigned int c = 0; c < n_components; ++c)
+              if (fe->get_nonzero_components(i)[first_selected_component + c])
+                for (unsigned int q = 0; q < unit_points.size(); ++q)
+                  {
+                    const Tensor<1, spacedim> shape_gradient =
+                      fe_values->shape_grad_component(
+                        i, q, first_selected_component + c);
+                    for (unsigned int e = 0; e < spacedim; ++e)
+                      Traits::access(gradients[q], c, e) +=
+                        shape_gradient[e] * solution_values[i];
+                  }
+        }
+    }
+}
+
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+void
+FEPointEvaluation<n_components, dim, spacedim, Number>::integrate(
+  const ArrayView<Number> &               solution_values,
+  const EvaluationFlags::EvaluationFlags &integration_flags)
+{
+  AssertDimension(solution_values.size(), fe->dofs_per_cell);
+  Assert(!(integration_flags & EvaluationFlags::values) ||
+           (update_flags & update_values),
+         ExcNotInitialized());
+  Assert(!(integration_flags & EvaluationFlags::gradients) ||
+           (update_flags & update_gradients),
+         ExcNotInitialized());
+
+  if (!poly.empty())
+    {
+      // fast path with tensor product integration
+      const unsigned int dofs_per_component = solution_renumbered.size();
+      for (unsigned int i = 0; i < dofs_per_component; ++i)
+        solution_renumbered[i] = value_type();
+
+      for (unsigned int q = 0; q < unit_points.size(); ++q)
+        {
+          value_type value = value_type();
+          if (integration_flags & EvaluationFlags::values)
+            value = values[q];
+
+          // apply the inverse Jacobian to get the gradient with respect to
+          // the unit coordinates
+          typename Traits::unit_gradient_type unit_gradient;
+          if (integration_flags & EvaluationFlags::gradients)
+            {
+              const DerivativeForm<1, spacedim, dim> &inverse_jacobian =
+                mapping_data.inverse_jacobians[q];
+              for (unsigned int d = 0; d < dim; ++d)
+                for (unsigned int c = 0; c < n_components; ++c)
+                  {
+                    Number sum = 0;
+                    for (unsigned int e = 0; e < spacedim; ++e)
+                      sum += inverse_jacobian[d][e] *
+                             Traits::access(gradients[q], c, e);
+                    Traits::access(unit_gradient[d], c) = sum;
+                  }
+            }
+          internal::integrate_add_tensor_product_value_and_gradient(
+            poly, value, unit_gradient, unit_points[q], solution_renumbered);
+        }
+
+      for (unsigned int i = 0; i < dofs_per_component; ++i)
+        for (unsigned int c = 0; c < n_components; ++c)
+          solution_values[renumber[c * dofs_per_component + i]] =
+            Traits::access(solution_renumbered[i], c);
+    }
+  else
+    {
+      // slow path with FEValues
+      Assert(fe_values.get() != nullptr,
+             ExcMessage(
+               "Not initialized. Please call FEPointEvaluation::reinit()"));
+      for (unsigned int i = 0; i < fe->dofs_per_cell; ++i)
+        {
+          bool   is_selected = false;
+          Number sum         = 0;
+          for (unsigned int c = 0; c < n_components; ++c)
+            if (fe->get_nonzero_components(i)[first_selected_component + c])
+              {
+                is_selected = true;
+                for (unsigned int q = 0; q < unit_points.size(); ++q)
+                  {
+                    if (integration_flags & EvaluationFlags::values)
+                      sum += fe_values->shape_value_component(
+                               i, q, first_selected_component + c) *
+                             Traits::access(values[q], c);
+                    if (integration_flags & EvaluationFlags::gradients)
+                      {
+                        const Tensor<1, spacedim> shape_gradient =
+                          fe_values->shape_grad_component(
+                            i, q, first_selected_component + c);
+                        for (unsigned int e = 0; e < spacedim; ++e)
+                          sum += shape_gradient[e] *
+                                 Traits::access(gradients[q], c, e);
+                      }
+                  }
+              }
+          if (is_selected)
+            solution_values[i] = sum;
+        }
+    }
+}
+
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+inline const typename FEPointEvaluation<n_components, dim, spacedim, Number>::
+  value_type &
+  FEPointEvaluation<n_components, dim, spacedim, Number>::get_value(
+    const unsigned int point_index) const
+{
+  AssertIndexRange(point_index, values.size());
+  return values[point_index];
+}
+
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+inline const typename FEPointEvaluation<n_components, dim, spacedim, Number>::
+  gradient_type &
+  FEPointEvaluation<n_components, dim, spacedim, Number>::get_gradient(
+    const unsigned int point_index) const
+{
+  AssertIndexRange(point_index, gradients.size());
+  return gradients[point_index];
+}
+
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+inline void
+FEPointEvaluation<n_components, dim, spacedim, Number>::submit_value(
+  const value_type & value,
+  const unsigned int point_index)
+{
+  AssertIndexRange(point_index, values.size());
+  values[point_index] = value;
+}
+
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+inline void
+FEPointEvaluation<n_components, dim, spacedim, Number>::submit_gradient(
+  const gradient_type &gradient,
+  const unsigned int   point_index)
+{
+  AssertIndexRange(point_index, gradients.size());
+  gradients[point_index] = gradient;
+}
+
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+inline DerivativeForm<1, dim, spacedim>
+FEPointEvaluation<n_components, dim, spacedim, Number>::jacobian(
+  const unsigned int point_index) const
+{
+  AssertIndexRange(point_index, mapping_data.jacobians.size());
+  return mapping_data.jacobians[point_index];
+}
+
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+inline DerivativeForm<1, spacedim, dim>
+FEPointEvaluation<n_components, dim, spacedim, Number>::inverse_jacobian(
+  const unsigned int point_index) const
+{
+  AssertIndexRange(point_index, mapping_data.inverse_jacobians.size());
+  return mapping_data.inverse_jacobians[point_index];
+}
+
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+inline Point<spacedim>
+FEPointEvaluation<n_components, dim, spacedim, Number>::real_point(
+  const unsigned int point_index) const
+{
+  AssertIndexRange(point_index, mapping_data.quadrature_points.size());
+  return mapping_data.quadrature_points[point_index];
+}
+
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+inline Point<dim>
+FEPointEvaluation<n_components, dim, spacedim, Number>::unit_point(
+  const unsigned int point_index) const
+{
+  AssertIndexRange(point_index, unit_points.size());
+  return unit_points[point_index];
+}
+
+
+
+template <int n_components, int dim, int spacedim, typename Number>
+inline unsigned int
+FEPointEvaluation<n_components, dim, spacedim, Number>::n_points() const
+{
+  return unit_points.size();
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,771 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_matrix_free_hanging_nodes_internal_h
+#define dealii_matrix_free_hanging_nodes_internal_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_tools.h>
+
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+
+#include <deal.II/matrix_free/shape_info.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace internal
+{
+  namespace MatrixFreeFunctions
+  {
+    /**
+     * The bits of the mask describing the hanging-node configuration of a
+     * cell in case the hanging-node constraints are applied on the fly by
+     * FEEvaluation. If the mask is zero, the cell has no hanging nodes that
+     * are treated this way. Otherwise, the mask is composed of three fields
+     * with one bit per coordinate direction:
+     * - The first field gives the position of the cell within its parent,
+     *   i.e., the bit is set if the cell is in the upper half of the parent
+     *   along the respective coordinate direction.
+     * - The second field indicates that the face with the respective
+     *   coordinate direction as normal is a subface of a coarser neighbor.
+     *   Since only the faces on the boundary of the parent can be hanging,
+     *   the side of the face is given by the first field.
+     * - The third field indicates that the edge parallel to the respective
+     *   coordinate direction on the boundary of the parent is a child of an
+     *   edge of a coarser neighbor, without being part of a hanging face
+     *   (only in 3D).
+     */
+    enum ConstraintKinds : unsigned short
+    {
+      unconstrained = 0,
+      subcell_x     = 1 << 0,
+      subcell_y     = 1 << 1,
+      subcell_z     = 1 << 2,
+      face_x        = 1 << 3,
+      face_y        = 1 << 4,
+      face_z        = 1 << 5,
+      edge_x        = 1 << 6,
+      edge_y        = 1 << 7,
+      edge_z        = 1 << 8
+    };
+
+
+
+    /**
+     * Call @p operation for all lines of degrees of freedom along the given
+     * coordinate @p direction of a cell that are affected by hanging-node
+     * constraints according to the given @p mask. The degrees of freedom are
+     * numbered lexicographically with @p n_dofs_1d entries per direction.
+     * The operation is called with the position of the cell within the
+     * parent along @p direction (which selects the interpolation matrix to
+     * the subface), the index of the first degree of freedom on the line,
+     * and the stride between the entries on the line. Each line is visited
+     * at most once, also when it is shared by two hanging faces.
+     */
+    template <int dim, typename LineOperation>
+    inline void
+    for_each_constrained_line(const unsigned short mask,
+                              const unsigned int   n_dofs_1d,
+                              const unsigned int   direction,
+                              const LineOperation &operation)
+    {
+      if (dim == 1)
+        return;
+
+      const unsigned int subcell = (mask >> direction) & 1;
+      const unsigned int stride  = Utilities::pow(n_dofs_1d, direction);
+
+      if (dim == 2)
+        {
+          const unsigned int other = 1 - direction;
+          if (mask & (face_x << other))
+            operation(subcell,
+                      ((mask >> other) & 1) * (n_dofs_1d - 1) *
+                        Utilities::pow(n_dofs_1d, other),
+                      stride);
+          return;
+        }
+
+      // in 3D, go through the lines of the two planes orthogonal to the
+      // other coordinate directions, and the edge where they meet
+      const unsigned int dir_1      = (direction + 1) % 3;
+      const unsigned int dir_2      = (direction + 2) % 3;
+      const bool         has_face_1 = mask & (face_x << dir_1);
+      const bool         has_face_2 = mask & (face_x << dir_2);
+      const bool         has_edge   = mask & (edge_x << direction);
+      if (!has_face_1 && !has_face_2 && !has_edge)
+        return;
+
+      const unsigned int side_1   = ((mask >> dir_1) & 1) * (n_dofs_1d - 1);
+      const unsigned int side_2   = ((mask >> dir_2) & 1) * (n_dofs_1d - 1);
+      const unsigned int stride_1 = Utilities::pow(n_dofs_1d, dir_1);
+      const unsigned int stride_2 = Utilities::pow(n_dofs_1d, dir_2);
+      for (unsigned int i_2 = 0; i_2 < n_dofs_1d; ++i_2)
+        for (unsigned int i_1 = 0; i_1 < n_dofs_1d; ++i_1)
+          if ((has_face_1 && i_1 == side_1) || (has_face_2 && i_2 == side_2) ||
+              (has_edge && i_1 == side_1 && i_2 == side_2))
+            operation(subcell, i_1 * stride_1 + i_2 * stride_2, stride);
+    }
+
+
+
+    /**
+     * Apply the hanging-node constraints on the fly to the degrees of freedom
+     * of a batch of cells, given in lexicographic numbering in the arrays
+     * @p values_dofs for each of the @p n_components components. The array
+     * @p masks contains the hanging-node masks of the @p n_filled_lanes
+     * cells of the batch. Before the call, the entries on the constrained
+     * faces and edges hold the values of the coarser neighbor. The
+     * one-dimensional interpolation matrices from the parent to the two
+     * children stored in @p shape_data are applied line by line, i.e., as a
+     * sum factorization over the constrained planes. If @p transpose is
+     * true, the transpose operation as needed for integration is applied.
+     * The array @p line_buffer must hold space for <tt>n_dofs_1d</tt>
+     * entries.
+     */
+    template <int dim, typename VectorizedArrayType>
+    inline void
+    apply_hanging_node_constraints(
+      const UnivariateShapeData<VectorizedArrayType> &shape_data,
+      const unsigned short *                          masks,
+      const unsigned int                              n_filled_lanes,
+      const unsigned int                              n_components,
+      VectorizedArrayType *const *                    values_dofs,
+      VectorizedArrayType *                           line_buffer,
+      const bool                                      transpose)
+    {
+      const unsigned int n_dofs_1d = shape_data.fe_degree + 1;
+      AssertDimension(shape_data.subface_interpolation_matrices[0].size(),
+                      n_dofs_1d * n_dofs_1d);
+
+      for (unsigned int v = 0; v < n_filled_lanes; ++v)
+        {
+          const unsigned short mask = masks[v];
+          if (mask == unconstrained ||
+              std::find(masks, masks + v, mask) != masks + v)
+            continue;
+
+          // all lanes of the batch with the same mask are processed
+          // together; in case some lanes have a different configuration, the
+          // result is only written into the lanes with the current mask
+          const bool all_lanes_equal =
+            n_filled_lanes == VectorizedArrayType::size() &&
+            std::count(masks, masks + n_filled_lanes, mask) ==
+              static_cast<std::ptrdiff_t>(n_filled_lanes);
+
+          const auto interpolate_line = [&](const unsigned int subcell,
+                                            const unsigned int offset,
+                                            const unsigned int stride) {
+            const VectorizedArrayType *matrix =
+              shape_data.subface_interpolation_matrices[subcell].begin();
+            for (unsigned int c = 0; c < n_components; ++c)
+              {
+                VectorizedArrayType *values = values_dofs[c] + offset;
+                for (unsigned int i = 0; i < n_dofs_1d; ++i)
+                  {
+                    VectorizedArrayType sum = VectorizedArrayType();
+                    if (transpose)
+                      for (unsigned int j = 0; j < n_dofs_1d; ++j)
+                        sum += matrix[j * n_dofs_1d + i] * values[j * stride];
+                    else
+                      for (unsigned int j = 0; j < n_dofs_1d; ++j)
+                        sum += matrix[i * n_dofs_1d + j] * values[j * stride];
+                    line_buffer[i] = sum;
+                  }
+                if (all_lanes_equal)
+                  for (unsigned int i = 0; i < n_dofs_1d; ++i)
+                    values[i * stride] = line_buffer[i];
+                else
+                  for (unsigned int w = v; w < n_filled_lanes; ++w)
+                    if (masks[w] == mask)
+                      for (unsigned int i = 0; i < n_dofs_1d; ++i)
+                        values[i * stride][w] = line_buffer[i][w];
+              }
+          };
+
+          // the transpose operation runs through the directions in reverse
+          // order
+          for (unsigned int d = 0; d < dim; ++d)
+            for_each_constrained_line<dim>(mask,
+                                           n_dofs_1d,
+                                           transpose ? dim - 1 - d : d,
+                                           interpolate_line);
+        }
+    }
+
+
+
+    /**
+     * This class identifies the hanging-node configuration of the cells of a
+     * DoFHandler with an FE_Q element (or a system of several copies of an
+     * FE_Q element) for applying the hanging-node constraints on the fly in
+     * FEEvaluation. It is the counterpart of
+     * CUDAWrappers::internal::HangingNodes for the MatrixFree class: For a
+     * cell with hanging nodes, the indices of the degrees of freedom on the
+     * constrained faces and edges are replaced by the indices of the coarser
+     * neighbor and a mask of type ConstraintKinds is computed.
+     *
+     * The substitution is only performed if the result is equivalent to the
+     * constraints stored in the given AffineConstraints object, which is
+     * checked entry by entry. Otherwise, the cell keeps its original indices
+     * and the constraints are resolved as usual. This is the case, e.g., if
+     * the faces of the two cells are not in standard orientation with
+     * respect to each other.
+     */
+    template <int dim>
+    class HangingNodes
+    {
+    public:
+      /**
+       * Constructor. The argument @p lexicographic_numbering is the
+       * numbering from the lexicographic to the hierarchical numbering of
+       * degrees of freedom of the element in the DoFHandler, concatenated
+       * over the components.
+       */
+      HangingNodes(const DoFHandler<dim> &          dof_handler,
+                   const std::vector<unsigned int> &lexicographic_numbering);
+
+      /**
+       * Return whether the given element can be treated by this class.
+       */
+      static bool
+      is_supported(const FiniteElement<dim> &fe);
+
+      /**
+       * Compute the hanging-node mask of the given active cell and replace
+       * the entries of @p dof_indices (in the hierarchical numbering of the
+       * element) on the constrained faces and edges by the indices of the
+       * coarser neighbor. If the return value is
+       * ConstraintKinds::unconstrained, @p dof_indices is left untouched.
+       */
+      template <typename Number>
+      unsigned short
+      setup_constraints(
+        const typename DoFHandler<dim>::active_cell_iterator &cell,
+        const dealii::AffineConstraints<Number> &             constraints,
+        std::vector<types::global_dof_index> &dof_indices) const;
+
+    private:
+      /**
+       * Return the lexicographic index of the degree of freedom with the
+       * coordinates @p i and @p j within the face @p face of a cell, counted
+       * from the first vertex of the face in the direction of the second and
+       * third vertex, respectively.
+       */
+      unsigned int
+      face_dof_index(const unsigned int face,
+                     const unsigned int i,
+                     const unsigned int j) const;
+
+      /**
+       * Return the lexicographic index of the degree of freedom with the
+       * coordinate @p i along the line @p line of a cell, counted from the
+       * first vertex of the line.
+       */
+      unsigned int
+      line_dof_index(const unsigned int line, const unsigned int i) const;
+
+      /**
+       * Check that applying the interpolation encoded by @p mask to the
+       * indices @p new_indices gives the same result as resolving the
+       * constraints of the original indices @p indices, both in
+       * lexicographic numbering.
+       */
+      template <typename Number>
+      bool
+      check_constraints(
+        const unsigned short                        mask,
+        const std::vector<types::global_dof_index> &indices,
+        const std::vector<types::global_dof_index> &new_indices,
+        const dealii::AffineConstraints<Number> &   constraints) const;
+
+      /**
+       * The numbering from lexicographic to hierarchical degrees of freedom.
+       */
+      const std::vector<unsigned int> lexicographic_numbering;
+
+      /**
+       * The number of degrees of freedom per direction.
+       */
+      const unsigned int n_dofs_1d;
+
+      /**
+       * The number of components of the element.
+       */
+      const unsigned int n_components;
+
+      /**
+       * The interpolation matrices from the parent to the two children in
+       * 1D, see UnivariateShapeData::subface_interpolation_matrices.
+       */
+      std::array<std::vector<double>, 2> interpolation_matrices;
+
+      /**
+       * For each line of the triangulation, the active cells that contain
+       * either the line or its parent, together with the number of the line
+       * within the cell. Used to identify hanging edges in 3D.
+       */
+      std::vector<std::vector<std::pair<
+        typename DoFHandler<dim>::active_cell_iterator,
+        unsigned int>>>
+        line_to_cells;
+    };
+
+
+
+    /* --------------------- inline functions ------------------------------ */
+
+    template <int dim>
+    inline HangingNodes<dim>::HangingNodes(
+      const DoFHandler<dim> &          dof_handler,
+      const std::vector<unsigned int> &lexicographic_numbering)
+      : lexicographic_numbering(lexicographic_numbering)
+      , n_dofs_1d(dof_handler.get_fe().degree + 1)
+      , n_components(dof_handler.get_fe().n_components())
+    {
+      Assert(is_supported(dof_handler.get_fe()), ExcNotImplemented());
+      AssertDimension(lexicographic_numbering.size(),
+                      dof_handler.get_fe().dofs_per_cell);
+
+      // evaluate the 1D basis functions in the support points of the
+      // children
+      const FiniteElement<dim> &fe = dof_handler.get_fe().base_element(0);
+      const std::vector<unsigned int> scalar_lexicographic =
+        FETools::lexicographic_to_hierarchic_numbering<dim>(fe.degree);
+      for (unsigned int c = 0; c < 2; ++c)
+        {
+          interpolation_matrices[c].resize(n_dofs_1d * n_dofs_1d);
+          for (unsigned int i = 0; i < n_dofs_1d; ++i)
+            {
+              Point<dim> point;
+              point[0] =
+                0.5 *
+                (fe.get_unit_support_points()[scalar_lexicographic[i]][0] + c);
+              for (unsigned int j = 0; j < n_dofs_1d; ++j)
+                {
+                  const double value =
+                    fe.shape_value(scalar_lexicographic[j], point);
+                  interpolation_matrices[c][i * n_dofs_1d + j] =
+                    std::abs(value) < 1e-14 ? 0. : value;
+                }
+            }
+        }
+
+      // in 3D, edges can be hanging without any hanging face, so we need to
+      // find the coarser cells around the parent of a line
+      if (dim == 3)
+        {
+          line_to_cells.resize(
+            dof_handler.get_triangulation().n_raw_lines());
+          for (const auto &cell : dof_handler.active_cell_iterators())
+            if (!cell->is_artificial())
+              for (unsigned int l = 0; l < GeometryInfo<dim>::lines_per_cell;
+                   ++l)
+                {
+                  const auto line = cell->line(l);
+                  line_to_cells[line->index()].emplace_back(cell, l);
+                  if (line->has_children())
+                    for (unsigned int c = 0; c < line->n_children(); ++c)
+                      line_to_cells[line->child(c)->index()].emplace_back(cell,
+                                                                          l);
+                }
+        }
+    }
+
+
+
+    template <int dim>
+    inline bool
+    HangingNodes<dim>::is_supported(const FiniteElement<dim> &fe)
+    {
+      return dim > 1 && fe.n_base_elements() == 1 &&
+             dynamic_cast<const FE_Q<dim> *>(&fe.base_element(0)) != nullptr;
+    }
+
+
+
+    template <int dim>
+    inline unsigned int
+    HangingNodes<dim>::face_dof_index(const unsigned int face,
+                                      const unsigned int i,
+                                      const unsigned int j) const
+    {
+      const unsigned int degree = n_dofs_1d - 1;
+      const Point<dim>   v0     = GeometryInfo<dim>::unit_cell_vertex(
+        GeometryInfo<dim>::face_to_cell_vertices(face, 0));
+      const Point<dim> v1 = GeometryInfo<dim>::unit_cell_vertex(
+        GeometryInfo<dim>::face_to_cell_vertices(face, 1));
+
+      std::array<unsigned int, 3> coordinates = {{0, 0, 0}};
+      for (unsigned int d = 0; d < dim; ++d)
+        coordinates[d] = v0[d] > 0.5 ? degree : 0;
+      for (unsigned int d = 0; d < dim; ++d)
+        if (v1[d] != v0[d])
+          coordinates[d] = v0[d] < v1[d] ? i : degree - i;
+      if (dim == 3)
+        {
+          const Point<dim> v2 = GeometryInfo<dim>::unit_cell_vertex(
+            GeometryInfo<dim>::face_to_cell_vertices(face, 2));
+          for (unsigned int d = 0; d < dim; ++d)
+            if (v2[d] != v0[d])
+              coordinates[d] = v0[d] < v2[d] ? j : degree - j;
+        }
+
+      return coordinates[0] +
+             n_dofs_1d * (coordinates[1] + n_dofs_1d * coordinates[2]);
+    }
+
+
+
+    template <int dim>
+    inline unsigned int
+    HangingNodes<dim>::line_dof_index(const unsigned int line,
+                                      const unsigned int i) const
+    {
+      const unsigned int degree = n_dofs_1d - 1;
+      const Point<dim>   v0     = GeometryInfo<dim>::unit_cell_vertex(
+        GeometryInfo<dim>::line_to_cell_vertices(line, 0));
+      const Point<dim> v1 = GeometryInfo<dim>::unit_cell_vertex(
+        GeometryInfo<dim>::line_to_cell_vertices(line, 1));
+
+      std::array<unsigned int, 3> coordinates = {{0, 0, 0}};
+      for (unsigned int d = 0; d < dim; ++d)
+        coordinates[d] =
+          v1[d] != v0[d] ? (v0[d] < v1[d] ? i : degree - i) :
+                           (v0[d] > 0.5 ? degree : 0);
+
+      return coordinates[0] +
+             n_dofs_1d * (coordinates[1] + n_dofs_1d * coordinates[2]);
+    }
+
+
+
+    template <int dim>
+    template <typename Number>
+    inline unsigned short
+    HangingNodes<dim>::setup_constraints(
+      const typename DoFHandler<dim>::active_cell_iterator &cell,
+      const dealii::AffineConstraints<Number> &             constraints,
+      std::vector<types::global_dof_index> &                dof_indices) const
+    {
+      AssertDimension(dof_indices.size(), lexicographic_numbering.size());
+
+      // only cells refined isotropically from a parent can have hanging
+      // nodes; we need the parent to find the position of the cell
+      if (cell->level() == 0 || !cell->is_locally_owned())
+        return unconstrained;
+      const auto parent = cell->parent();
+      if (parent->refinement_case() !=
+          RefinementCase<dim>::isotropic_refinement)
+        return unconstrained;
+
+      unsigned short subcell = 0;
+      for (; subcell < parent->n_children(); ++subcell)
+        if (parent->child(subcell)->index() == cell->index())
+          break;
+      AssertIndexRange(subcell, parent->n_children());
+
+      const unsigned int dofs_per_component =
+        Utilities::fixed_power<dim>(n_dofs_1d);
+      const unsigned int degree = n_dofs_1d - 1;
+
+      std::vector<types::global_dof_index> indices(dof_indices.size());
+      for (unsigned int i = 0; i < indices.size(); ++i)
+        indices[i] = dof_indices[lexicographic_numbering[i]];
+      std::vector<types::global_dof_index> new_indices(indices);
+      std::vector<types::global_dof_index> neighbor_indices(
+        dof_indices.size());
+
+      unsigned short mask = unconstrained;
+      for (const unsigned int face : GeometryInfo<dim>::face_indices())
+        {
+          if (cell->at_boundary(face) || !cell->neighbor_is_coarser(face))
+            continue;
+
+          const unsigned int direction = face / 2;
+          const auto         neighbor  = cell->neighbor(face);
+          if (neighbor->is_artificial() ||
+              face % 2 != ((subcell >> direction) & 1u))
+            return unconstrained;
+
+          // the face of the parent and the face of the neighbor must be in
+          // standard orientation with respect to each other
+          const unsigned int neighbor_face =
+            cell->neighbor_of_coarser_neighbor(face).first;
+          for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_face;
+               ++v)
+            if (parent->vertex_index(
+                  GeometryInfo<dim>::face_to_cell_vertices(face, v)) !=
+                neighbor->vertex_index(
+                  GeometryInfo<dim>::face_to_cell_vertices(neighbor_face, v)))
+              return unconstrained;
+
+          neighbor->get_dof_indices(neighbor_indices);
+          for (unsigned int j = 0; j < (dim == 3 ? n_dofs_1d : 1); ++j)
+            for (unsigned int i = 0; i < n_dofs_1d; ++i)
+              {
+                const unsigned int index = face_dof_index(face, i, j);
+                const unsigned int neighbor_index =
+                  face_dof_index(neighbor_face, i, j);
+                for (unsigned int c = 0; c < n_components; ++c)
+                  new_indices[c * dofs_per_component + index] =
+                    neighbor_indices[lexicographic_numbering
+                                       [c * dofs_per_component +
+                                        neighbor_index]];
+              }
+
+          mask |= face_x << direction;
+        }
+
+      // in 3D, look for hanging edges on the boundary of the parent that are
+      // not part of a hanging face
+      if (dim == 3)
+        for (unsigned int line = 0; line < GeometryInfo<dim>::lines_per_cell;
+             ++line)
+          {
+            const Point<dim> v0 = GeometryInfo<dim>::unit_cell_vertex(
+              GeometryInfo<dim>::line_to_cell_vertices(line, 0));
+            const Point<dim> v1 = GeometryInfo<dim>::unit_cell_vertex(
+              GeometryInfo<dim>::line_to_cell_vertices(line, 1));
+            unsigned int direction = 0;
+            for (unsigned int d = 0; d < dim; ++d)
+              if (v0[d] != v1[d])
+                direction = d;
+
+            bool on_parent_edge = true, in_hanging_face = false;
+            for (unsigned int d = 0; d < dim; ++d)
+              if (d != direction)
+                {
+                  const unsigned int side = v0[d] > 0.5 ? 1 : 0;
+                  if (side != ((subcell >> d) & 1u))
+                    on_parent_edge = false;
+                  else if (mask & (face_x << d))
+                    in_hanging_face = true;
+                }
+            if (!on_parent_edge || in_hanging_face)
+              continue;
+
+            for (const auto &neighbor :
+                 line_to_cells[cell->line(line)->index()])
+              if (neighbor.first->level() < cell->level())
+                {
+                  // the fine line runs along the first or second half of the
+                  // coarse line, depending on the position of the cell within
+                  // the parent
+                  const unsigned int vertex_start =
+                    cell->vertex_index(GeometryInfo<dim>::line_to_cell_vertices(
+                      line, v0[direction] < v1[direction] ? 0 : 1));
+                  const unsigned int vertex_end =
+                    cell->vertex_index(GeometryInfo<dim>::line_to_cell_vertices(
+                      line, v0[direction] < v1[direction] ? 1 : 0));
+                  const unsigned int parent_vertex =
+                    ((subcell >> direction) & 1u) ? vertex_end : vertex_start;
+                  const bool at_start = !((subcell >> direction) & 1u);
+                  const unsigned int neighbor_line = neighbor.second;
+                  const unsigned int neighbor_v0 =
+                    neighbor.first->vertex_index(
+                      GeometryInfo<dim>::line_to_cell_vertices(neighbor_line,
+                                                               0));
+                  const unsigned int neighbor_v1 =
+                    neighbor.first->vertex_index(
+                      GeometryInfo<dim>::line_to_cell_vertices(neighbor_line,
+                                                               1));
+                  bool same_direction = false;
+                  if (parent_vertex == (at_start ? neighbor_v0 : neighbor_v1))
+                    same_direction = true;
+                  else if (parent_vertex !=
+                           (at_start ? neighbor_v1 : neighbor_v0))
+                    return unconstrained;
+
+                  neighbor.first->get_dof_indices(neighbor_indices);
+                  for (unsigned int i = 0; i < n_dofs_1d; ++i)
+                    {
+                      // index along the coordinate direction of the cell
+                      const unsigned int index = line_dof_index(
+                        line, v0[direction] < v1[direction] ? i : degree - i);
+                      const unsigned int neighbor_index =
+                        line_dof_index(neighbor_line,
+                                       same_direction ? i : degree - i);
+                      for (unsigned int c = 0; c < n_components; ++c)
+                        new_indices[c * dofs_per_component + index] =
+                          neighbor_indices[lexicographic_numbering
+                                             [c * dofs_per_component +
+                                              neighbor_index]];
+                    }
+
+                  mask |= edge_x << direction;
+                  break;
+                }
+          }
+
+      if (mask == unconstrained)
+        return unconstrained;
+
+      mask |= subcell;
+      if (!check_constraints(mask, indices, new_indices, constraints))
+        return unconstrained;
+
+      for (unsigned int i = 0; i < new_indices.size(); ++i)
+        dof_indices[lexicographic_numbering[i]] = new_indices[i];
+
+      return mask;
+    }
+
+
+
+    template <int dim>
+    template <typename Number>
+    inline bool
+    HangingNodes<dim>::check_constraints(
+      const unsigned short                        mask,
+      const std::vector<types::global_dof_index> &indices,
+      const std::vector<types::global_dof_index> &new_indices,
+      const dealii::AffineConstraints<Number> &   constraints) const
+    {
+      using Entries = std::vector<std::pair<types::global_dof_index, double>>;
+
+      // sort the entries of a linear combination of degrees of freedom and
+      // merge duplicates
+      const auto compress = [](Entries &entries) {
+        std::sort(entries.begin(), entries.end());
+        Entries compressed;
+        for (const auto &entry : entries)
+          if (!compressed.empty() && compressed.back().first == entry.first)
+            compressed.back().second += entry.second;
+          else
+            compressed.push_back(entry);
+        entries.swap(compressed);
+      };
+
+      // express a linear combination in terms of unconstrained degrees of
+      // freedom
+      const auto resolve = [&](const Entries &entries) {
+        Entries result;
+        for (const auto &entry : entries)
+          {
+            const auto *constraint_entries =
+              constraints.get_constraint_entries(entry.first);
+            if (constraint_entries == nullptr)
+              result.push_back(entry);
+            else
+              for (const auto &c : *constraint_entries)
+                result.emplace_back(c.first, entry.second * c.second);
+          }
+        compress(result);
+        return result;
+      };
+
+      const unsigned int dofs_per_component =
+        Utilities::fixed_power<dim>(n_dofs_1d);
+      for (unsigned int c = 0; c < n_components; ++c)
+        {
+          // apply the interpolation of FEEvaluation to the coarse indices
+          std::vector<Entries> values(dofs_per_component);
+          for (unsigned int i = 0; i < dofs_per_component; ++i)
+            values[i].emplace_back(new_indices[c * dofs_per_component + i],
+                                   1.);
+          for (unsigned int d = 0; d < dim; ++d)
+            for_each_constrained_line<dim>(
+              mask,
+              n_dofs_1d,
+              d,
+              [&](const unsigned int subcell,
+                  const unsigned int offset,
+                  const unsigned int stride) {
+                std::vector<Entries> line(n_dofs_1d);
+                for (unsigned int i = 0; i < n_dofs_1d; ++i)
+                  for (unsigned int j = 0; j < n_dofs_1d; ++j)
+                    {
+                      const double weight =
+                        interpolation_matrices[subcell][i * n_dofs_1d + j];
+                      if (weight != 0.)
+                        for (const auto &entry : values[offset + j * stride])
+                          line[i].emplace_back(entry.first,
+                                               weight * entry.second);
+                    }
+                for (unsigned int i = 0; i < n_dofs_1d; ++i)
+                  {
+                    compress(line[i]);
+                    values[offset + i * stride].swap(line[i]);
+                  }
+              });
+
+          // compare with the constraints of the original indices
+          for (unsigned int i = 0; i < dofs_per_component; ++i)
+            {
+              const types::global_dof_index index =
+                indices[c * dofs_per_component + i];
+              if (values[i].size() == 1 && values[i][0].first == index &&
+                  values[i][0].second == 1.)
+                continue;
+
+              const Entries actual   = resolve(values[i]);
+              const Entries expected =
+                resolve(Entries(1, std::make_pair(index, 1.)));
+              unsigned int  a = 0, e = 0;
+              while (a < actual.size() || e < expected.size())
+                {
+                  if (a < actual.size() && e < expected.size() &&
+                      actual[a].first == expected[e].first)
+                    {
+                      if (std::abs(actual[a].second - expected[e].second) >
+                          1e-10)
+                        return false;
+                      ++a;
+                      ++e;
+                    }
+                  else if (a < actual.size() &&
+                           (e == expected.size() ||
+                            actual[a].first < expected[e].first))
+                    {
+                      if (std::abs(actual[a].second) > 1e-10)
+                        return false;
+                      ++a;
+                    }
+                  else
+                    {
+                      if (std::abs(expected[e].second) > 1e-10)
+                        return false;
+                      ++e;
+                    }
+                }
+            }
+        }
+
+      return true;
+    }
+  } // namespace MatrixFreeFunctions
+} // namespace internal
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -2992,15 +2992,18 @@ namespace internal
                      (cell_it->at_boundary(face) &&
                       cell_it->has_periodic_neighbor(face)));
 
+                  // the derivatives on the neighbor are evaluated on its
+                  // own face, so its Jacobian must be reordered accordingly
+                  unsigned int neighbor_face = face;
                   if (is_local)
                     {
                       auto cell_it_neigh =
                         cell_it->neighbor_or_periodic_neighbor(face);
-                      fe_val_neigh.reinit(cell_it_neigh,
-                                          cell_it->at_boundary(face) ?
-                                            cell_it->periodic_neighbor_face_no(
-                                              face) :
-                                            cell_it->neighbor_face_no(face));
+                      neighbor_face =
+                        cell_it->at_boundary(face) ?
+                          cell_it->periodic_neighbor_face_no(face) :
+                          cell_it->neighbor_face_no(face);
+                      fe_val_neigh.reinit(cell_it_neigh, neighbor_face);
                     }
 
                   // copy data for affine data type
@@ -3026,22 +3029,20 @@ namespace internal
                               }
                         }
                       if (is_local && (update_flags & update_jacobians))
-                        for (unsigned int q = 0; q < fe_val.n_quadrature_points;
-                             ++q)
-                          {
-                            DerivativeForm<1, dim, dim> inv_jac =
-                              fe_val_neigh.jacobian(q).covariant_form();
-                            for (unsigned int d = 0; d < dim; ++d)
-                              for (unsigned int e = 0; e < dim; ++e)
-                                {
-                                  const unsigned int ee = ExtractFaceHelper::
-                                    reorder_face_derivative_indices<dim>(face,
-                                                                         e);
-                                  face_data_by_cells[my_q]
-                                    .jacobians[1][offset + q][d][e][v] =
-                                    inv_jac[d][ee];
-                                }
-                          }
+                        {
+                          DerivativeForm<1, dim, dim> inv_jac =
+                            fe_val_neigh.jacobian(0).covariant_form();
+                          for (unsigned int d = 0; d < dim; ++d)
+                            for (unsigned int e = 0; e < dim; ++e)
+                              {
+                                const unsigned int ee = ExtractFaceHelper::
+                                  reorder_face_derivative_indices<dim>(
+                                    neighbor_face, e);
+                                face_data_by_cells[my_q]
+                                  .jacobians[1][offset][d][e][v] =
+                                  inv_jac[d][ee];
+                              }
+                        }
                       if (update_flags & update_jacobian_grads)
                         {
                           Assert(false, ExcNotImplemented());
@@ -3077,6 +3078,23 @@ namespace internal
                                     inv_jac[d][ee];
                                 }
                           }
+                      if (is_local && (update_flags & update_jacobians))
+                        for (unsigned int q = 0; q < fe_val.n_quadrature_points;
+                             ++q)
+                          {
+                            DerivativeForm<1, dim, dim> inv_jac =
+                              fe_val_neigh.jacobian(q).covariant_form();
+                            for (unsigned int d = 0; d < dim; ++d)
+                              for (unsigned int e = 0; e < dim; ++e)
+                                {
+                                  const unsigned int ee = ExtractFaceHelper::
+                                    reorder_face_derivative_indices<dim>(
+                                      neighbor_face, e);
+                                  face_data_by_cells[my_q]
+                                    .jacobians[1][offset + q][d][e][v] =
+                                    inv_jac[d][ee];
+                                }
+                          }
                       if (update_flags & update_jacobian_grads)
                         {
                           Assert(false, ExcNotImplemented());
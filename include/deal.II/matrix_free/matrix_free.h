@@ -224,7 +224,8 @@ public:
       const bool         initialize_mapping  = true,
       const bool         overlap_communication_computation    = true,
       const bool         hold_all_faces_to_owned_cells        = false,
-      const bool         cell_vectorization_categories_strict = false)
+      const bool         cell_vectorization_categories_strict = false,
+      const bool         use_fast_hanging_node_algorithm      = false)
       : tasks_parallel_scheme(tasks_parallel_scheme)
       , tasks_block_size(tasks_block_size)
       , mapping_update_flags(mapping_update_flags)
@@ -240,6 +241,7 @@ public:
       , hold_all_faces_to_owned_cells(hold_all_faces_to_owned_cells)
       , cell_vectorization_categories_strict(
           cell_vectorization_categories_strict)
+      , use_fast_hanging_node_algorithm(use_fast_hanging_node_algorithm)
     {}
 
     /**
@@ -265,6 +267,7 @@ public:
       , cell_vectorization_category(other.cell_vectorization_category)
       , cell_vectorization_categories_strict(
           other.cell_vectorization_categories_strict)
+      , use_fast_hanging_node_algorithm(other.use_fast_hanging_node_algorithm)
     {}
 
     /**
@@ -291,6 +294,7 @@ public:
       cell_vectorization_category   = other.cell_vectorization_category;
       cell_vectorization_categories_strict =
         other.cell_vectorization_categories_strict;
+      use_fast_hanging_node_algorithm = other.use_fast_hanging_node_algorithm;
 
       return *this;
     }
@@ -410,10 +414,14 @@ public:
      * example for block-Jacobi methods where the full operator to a cell
      * including its faces are evaluated. This data is accessed by
      * <code>FEFaceEvaluation::reinit(cell_batch_index,
-     * face_number)</code>. However, currently no coupling terms to neighbors
-     * can be computed with this approach because the neighbors are not laid
-     * out by the VectorizedArray data layout with an
-     * array-of-struct-of-array-type data structures.
+     * face_number)</code>. Together with `hold_all_faces_to_owned_cells`, it
+     * allows to evaluate the coupling terms to the neighbors in the
+     * cell-centric loop MatrixFree::loop_cell_centric(), where an
+     * FEFaceEvaluation object for the exterior side reads the values of the
+     * neighbors directly. Neighbors across faces with hanging nodes or with
+     * a face orientation other than the standard one are not supported for
+     * the exterior side, and FEFaceEvaluation::reinit() throws an exception
+     * when it encounters them.
      *
      * Note that you should only compute this data field in case you really
      * need it as it more than doubles the memory required by the mapping data
@@ -523,6 +531,30 @@ public:
      * them in a single vectorized array.
      */
     bool cell_vectorization_categories_strict;
+
+    /**
+     * If set to @p true, hanging-node constraints of continuous
+     * FE_Q elements are not resolved into the general constraint pool of the
+     * DoFInfo class. Instead, each cell at a hanging face or edge stores the
+     * indices of the coarser neighbor on the constrained entries together
+     * with a compact bit mask describing the refinement configuration, and
+     * FEEvaluation applies the constraints on the fly with the
+     * one-dimensional interpolation matrices of the element. This reduces
+     * the memory traffic for the indices and allows for vectorized
+     * evaluation of the constraints also in mixed batches of cells.
+     *
+     * The algorithm is only used for a single FE_Q base element (possibly
+     * within an FESystem) on the active cells without face integrals and
+     * with @p store_plain_indices enabled. It checks that the constraints
+     * generated from the mesh agree with the ones contained in the
+     * AffineConstraints object (which may additionally contain, e.g.,
+     * Dirichlet conditions on other entries) and falls back to the general
+     * constraint pool on cells where this is not the case.
+     *
+     * The default is @p false, which keeps the layout of the constraint pool
+     * and of the indices stored in DoFInfo unchanged.
+     */
+    bool use_fast_hanging_node_algorithm;
   };
 
   /**
@@ -38,6 +38,7 @@
 
 #include <deal.II/matrix_free/face_info.h>
 #include <deal.II/matrix_free/face_setup_internal.h>
+#include <deal.II/matrix_free/hanging_nodes_internal.h>
 #include <deal.II/matrix_free/matrix_free.h>
 
 #ifdef DEAL_II_WITH_TBB
@@ -703,6 +704,7 @@ namespace internal
     const bool                       cell_vectorization_categories_strict,
     const bool                       do_face_integrals,
     const bool                       overlap_communication_computation,
+    const bool                       use_fast_hanging_node_algorithm,
     MatrixFreeFunctions::TaskInfo &  task_info,
     std::vector<std::pair<unsigned int, unsigned int>> &cell_level_index,
     std::vector<MatrixFreeFunctions::DoFInfo> &         dof_info,
@@ -723,7 +725,8 @@ namespace internal
     AssertDimension(n_dof_handlers, locally_owned_dofs.size());
     AssertDimension(n_dof_handlers, constraint.size());
 
-    std::vector<types::global_dof_index>                local_dof_indices;
+    std::vector<types::global_dof_index> local_dof_indices,
+      local_dof_indices_resolved;
     std::vector<std::vector<std::vector<unsigned int>>> lexicographic(
       n_dof_handlers);
 
@@ -731,6 +734,11 @@ namespace internal
 
     bool cell_categorization_enabled = !cell_vectorization_category.empty();
 
+    // the hanging-node constraints are applied on the fly for the supported
+    // elements on active cells without face integrals
+    std::vector<std::unique_ptr<MatrixFreeFunctions::HangingNodes<dim>>>
+      hanging_nodes(n_dof_handlers);
+
     for (unsigned int no = 0; no < n_dof_handlers; ++no)
       {
         const dealii::hp::FECollection<dim> &fes =
@@ -805,6 +813,19 @@ namespace internal
               dof_info[no].dofs_per_cell[fe_index]);
           }
 
+        dof_info[no].hanging_node_constraint_masks.clear();
+        if (use_fast_hanging_node_algorithm && !do_face_integrals &&
+            mg_level == numbers::invalid_unsigned_int && fes.size() == 1 &&
+            dof_info[no].store_plain_indices &&
+            MatrixFreeFunctions::HangingNodes<dim>::is_supported(fes[0]))
+          {
+            hanging_nodes[no] =
+              std::make_unique<MatrixFreeFunctions::HangingNodes<dim>>(
+                *dof_handler[no], lexicographic[no][0]);
+            dof_info[no].hanging_node_constraint_masks.resize(
+              n_active_cells, MatrixFreeFunctions::unconstrained);
+          }
+
         // set locally owned range for each component
         Assert(locally_owned_dofs[no].is_contiguous(), ExcNotImplemented());
         dof_info[no].vector_partitioner =
@@ -860,7 +881,13 @@ namespace internal
                   dof_info[no].cell_active_fe_index[counter] = fe_index;
                 local_dof_indices.resize(dof_info[no].dofs_per_cell[fe_index]);
                 cell_it->get_dof_indices(local_dof_indices);
-                dof_info[no].read_dof_indices(local_dof_indices,
+                local_dof_indices_resolved = local_dof_indices;
+                if (hanging_nodes[no])
+                  dof_info[no].hanging_node_constraint_masks[counter] =
+                    hanging_nodes[no]->setup_constraints(
+                      cell_it, *constraint[no], local_dof_indices_resolved);
+                dof_info[no].read_dof_indices(local_dof_indices_resolved,
+                                              local_dof_indices,
                                               lexicographic[no][fe_index],
                                               *constraint[no],
                                               counter,
@@ -888,6 +915,7 @@ namespace internal
                 local_dof_indices.resize(dof_info[no].dofs_per_cell[0]);
                 cell_it->get_mg_dof_indices(local_dof_indices);
                 dof_info[no].read_dof_indices(local_dof_indices,
+                                              local_dof_indices,
                                               lexicographic[no][0],
                                               *constraint[no],
                                               counter,
@@ -911,6 +939,15 @@ namespace internal
           subdomain_boundary_cells.push_back(counter);
       }
 
+    // only keep the masks if some cell actually has hanging nodes
+    for (unsigned int no = 0; no < n_dof_handlers; ++no)
+      if (std::all_of(dof_info[no].hanging_node_constraint_masks.begin(),
+                      dof_info[no].hanging_node_constraint_masks.end(),
+                      [](const unsigned short mask) {
+                        return mask == MatrixFreeFunctions::unconstrained;
+                      }))
+        dof_info[no].hanging_node_constraint_masks.clear();
+
     task_info.n_active_cells = cell_level_index_end_local;
     task_info.n_ghost_cells  = n_active_cells - cell_level_index_end_local;
 
@@ -1322,6 +1359,7 @@ MatrixFree<dim, Number, VectorizedArrayType>::initialize_indices(
     additional_data.cell_vectorization_categories_strict,
     do_face_integrals,
     additional_data.overlap_communication_computation,
+    additional_data.use_fast_hanging_node_algorithm,
     task_info,
     cell_level_index,
     dof_info,
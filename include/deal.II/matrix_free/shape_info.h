@@ -247,6 +247,19 @@ namespace internal
        */
       AlignedVector<Number> hessians_within_subface[2];
 
+      /**
+       * Stores the interpolation from the degrees of freedom of the
+       * one-dimensional parent element to the support points of the two
+       * children, i.e., the values of the shape functions at the support
+       * points divided by one half (index 0) and shifted by one half (index
+       * 1). These matrices are used to resolve hanging-node constraints on
+       * the fly in FEEvaluation. The length of each array is
+       * <tt>n_dofs_1d * n_dofs_1d</tt> with the index of the shape function
+       * running fastest. The arrays are only filled for elements that define
+       * support points.
+       */
+      AlignedVector<Number> subface_interpolation_matrices[2];
+
       /**
        * We store a copy of the one-dimensional quadrature formula
        * used for initialization.
@@ -297,6 +297,31 @@ namespace internal
             fe->shape_grad_grad(my_i, q_point)[0][0];
         }
 
+      // evaluate the basis functions in the support points of the two
+      // children, which gives the interpolation matrices for hanging nodes
+      if (fe->has_support_points())
+        for (unsigned int c = 0; c < 2; ++c)
+          {
+            auto &matrix =
+              univariate_shape_data.subface_interpolation_matrices[c];
+            matrix.resize_fast(n_dofs_1d * n_dofs_1d);
+            for (unsigned int i = 0; i < n_dofs_1d; ++i)
+              {
+                Point<dim> q_point = unit_point;
+                q_point[0] =
+                  0.5 *
+                  (fe->get_unit_support_points()[scalar_lexicographic[i]][0] +
+                   c);
+                for (unsigned int j = 0; j < n_dofs_1d; ++j)
+                  {
+                    const double value =
+                      fe->shape_value(scalar_lexicographic[j], q_point);
+                    matrix[i * n_dofs_1d + j] =
+                      std::abs(value) < 1e-14 ? 0. : value;
+                  }
+              }
+          }
+
       // get gradient and Hessian transformation matrix for the polynomial
       // space associated with the quadrature rule (collocation space). We
       // need to avoid the case with more than a few hundreds of quadrature
@@ -735,6 +760,8 @@ namespace internal
             MemoryConsumption::memory_consumption(values_within_subface[i]);
           memory +=
             MemoryConsumption::memory_consumption(gradients_within_subface[i]);
+          memory += MemoryConsumption::memory_consumption(
+            subface_interpolation_matrices[i]);
         }
       return memory;
     }
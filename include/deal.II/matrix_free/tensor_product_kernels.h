@@ -20,8 +20,14 @@
 #include <deal.II/base/config.h>
 
 #include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/polynomial.h>
+#include <deal.II/base/tensor.h>
 #include <deal.II/base/utilities.h>
 
+#include <utility>
+#include <vector>
+
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -2257,6 +2263,188 @@ namespace internal
       }
   }
 
+
+
+  /**
+   * Maximal number of one-dimensional polynomials supported by
+   * evaluate_tensor_product_value_and_gradient() and
+   * integrate_add_tensor_product_value_and_gradient(), which keep the values
+   * and derivatives of the one-dimensional polynomials in a fixed-size array
+   * on the stack.
+   */
+  constexpr unsigned int max_n_polynomials_point_evaluation = 40;
+
+
+
+  /**
+   * Compute the values and first derivatives of the one-dimensional
+   * polynomials @p poly in the coordinates of the point @p p and store them
+   * in @p shapes, with the value of polynomial i in direction d at
+   * <code>shapes[d][i][0]</code> and the derivative at
+   * <code>shapes[d][i][1]</code>.
+   */
+  template <int dim>
+  inline void
+  compute_values_of_array(
+    const std::vector<Polynomials::Polynomial<double>> &poly,
+    const Point<dim> &                                  p,
+    double (&shapes)[dim][max_n_polynomials_point_evaluation][2])
+  {
+    const unsigned int n_shapes = poly.size();
+    AssertIndexRange(n_shapes, max_n_polynomials_point_evaluation + 1);
+    for (unsigned int d = 0; d < dim; ++d)
+      for (unsigned int i = 0; i < n_shapes; ++i)
+        poly[i].value(p[d], 1, shapes[d][i]);
+  }
+
+
+
+  /**
+   * Evaluate the values and the gradients of a function given by the
+   * expansion coefficients @p values in a tensor product basis of the
+   * one-dimensional polynomials @p poly at an arbitrary point @p p on the
+   * unit cell. Rather than looping over all $n^d$ basis functions and
+   * evaluating each of them in the point, as done by
+   * TensorProductPolynomials::compute(), this function evaluates the $n$
+   * one-dimensional polynomials in each direction and then sums the
+   * coefficients direction by direction, i.e., in a sum factorization
+   * fashion, at a cost of $\mathcal O(n^d)$ operations.
+   *
+   * The coefficients are expected in lexicographic order, or in the order
+   * given by the optional argument @p renumber, in which case the coefficient
+   * of the lexicographic basis function $i$ is taken as
+   * <code>values[renumber[i]]</code>. The type @p Number of the coefficients
+   * can be a scalar or a tensor, e.g. to evaluate several components or the
+   * position of a point in a polynomial mapping at once. The gradient is
+   * returned with respect to the unit coordinates.
+   */
+  template <int dim, typename Number>
+  inline std::pair<Number, Tensor<1, dim, Number>>
+  evaluate_tensor_product_value_and_gradient(
+    const std::vector<Polynomials::Polynomial<double>> &poly,
+    const std::vector<Number> &                         values,
+    const Point<dim> &                                  p,
+    const std::vector<unsigned int> &                   renumber = {})
+  {
+    static_assert(dim >= 1 && dim <= 3, "Only dim=1,2,3 implemented");
+
+    const unsigned int n_shapes = poly.size();
+    AssertDimension(Utilities::fixed_power<dim>(n_shapes), values.size());
+    Assert(renumber.empty() || renumber.size() == values.size(),
+           ExcDimensionMismatch(renumber.size(), values.size()));
+
+    double shapes[dim][max_n_polynomials_point_evaluation][2];
+    compute_values_of_array(poly, p, shapes);
+
+    // sum up the coefficients in x direction first, then multiply the result
+    // by the shape functions in y and z direction, respectively
+    Number                 result = Number();
+    Tensor<1, dim, Number> gradient;
+    for (unsigned int i2 = 0, i = 0; i2 < (dim > 2 ? n_shapes : 1); ++i2)
+      {
+        Number value_y = Number(), deriv_x_y = Number(), deriv_y_y = Number();
+        for (unsigned int i1 = 0; i1 < (dim > 1 ? n_shapes : 1); ++i1)
+          {
+            Number value_x = Number(), deriv_x = Number();
+            for (unsigned int i0 = 0; i0 < n_shapes; ++i0, ++i)
+              {
+                const Number &coefficient =
+                  renumber.empty() ? values[i] : values[renumber[i]];
+                value_x += shapes[0][i0][0] * coefficient;
+                deriv_x += shapes[0][i0][1] * coefficient;
+              }
+            if (dim > 1)
+              {
+                value_y += shapes[1 % dim][i1][0] * value_x;
+                deriv_x_y += shapes[1 % dim][i1][0] * deriv_x;
+                deriv_y_y += shapes[1 % dim][i1][1] * value_x;
+              }
+            else
+              {
+                value_y   = value_x;
+                deriv_x_y = deriv_x;
+              }
+          }
+        if (dim > 2)
+          {
+            result += shapes[2 % dim][i2][0] * value_y;
+            gradient[0] += shapes[2 % dim][i2][0] * deriv_x_y;
+            gradient[1 % dim] += shapes[2 % dim][i2][0] * deriv_y_y;
+            gradient[2 % dim] += shapes[2 % dim][i2][1] * value_y;
+          }
+        else
+          {
+            result      = value_y;
+            gradient[0] = deriv_x_y;
+            if (dim > 1)
+              gradient[1 % dim] = deriv_y_y;
+          }
+      }
+
+    return std::make_pair(result, gradient);
+  }
+
+
+
+  /**
+   * Multiply the given @p value and @p gradient in an arbitrary point @p p
+   * on the unit cell by the values and gradients of all functions of the
+   * tensor product basis of the one-dimensional polynomials @p poly,
+   * respectively, and add the sum of the two to the entries of @p values,
+   * i.e., compute the transpose of
+   * evaluate_tensor_product_value_and_gradient(). The gradient is given with
+   * respect to the unit coordinates. The entries of @p values are in
+   * lexicographic order, or in the order given by the optional argument
+   * @p renumber.
+   */
+  template <int dim, typename Number>
+  inline void
+  integrate_add_tensor_product_value_and_gradient(
+    const std::vector<Polynomials::Polynomial<double>> &poly,
+    const Number &                                      value,
+    const Tensor<1, dim, Number> &                      gradient,
+    const Point<dim> &                                  p,
+    std::vector<Number> &                               values,
+    const std::vector<unsigned int> &                   renumber = {})
+  {
+    static_assert(dim >= 1 && dim <= 3, "Only dim=1,2,3 implemented");
+
+    const unsigned int n_shapes = poly.size();
+    AssertDimension(Utilities::fixed_power<dim>(n_shapes), values.size());
+    Assert(renumber.empty() || renumber.size() == values.size(),
+           ExcDimensionMismatch(renumber.size(), values.size()));
+
+    double shapes[dim][max_n_polynomials_point_evaluation][2];
+    compute_values_of_array(poly, p, shapes);
+
+    for (unsigned int i2 = 0, i = 0; i2 < (dim > 2 ? n_shapes : 1); ++i2)
+      {
+        Number test_value_z = value, test_grad_x_z = gradient[0],
+               test_grad_y_z = gradient[1 % dim];
+        if (dim > 2)
+          {
+            test_value_z = shapes[2 % dim][i2][0] * value +
+                           shapes[2 % dim][i2][1] * gradient[2 % dim];
+            test_grad_x_z = shapes[2 % dim][i2][0] * gradient[0];
+            test_grad_y_z = shapes[2 % dim][i2][0] * gradient[1 % dim];
+          }
+        for (unsigned int i1 = 0; i1 < (dim > 1 ? n_shapes : 1); ++i1)
+          {
+            Number test_value_y = test_value_z, test_grad_x_y = test_grad_x_z;
+            if (dim > 1)
+              {
+                test_value_y = shapes[1 % dim][i1][0] * test_value_z +
+                               shapes[1 % dim][i1][1] * test_grad_y_z;
+                test_grad_x_y = shapes[1 % dim][i1][0] * test_grad_x_z;
+              }
+            for (unsigned int i0 = 0; i0 < n_shapes; ++i0, ++i)
+              (renumber.empty() ? values[i] : values[renumber[i]]) +=
+                shapes[0][i0][0] * test_value_y +
+                shapes[0][i0][1] * test_grad_x_y;
+          }
+      }
+  }
+
 } // end of namespace internal
 
 
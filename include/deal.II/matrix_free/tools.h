@@ -18,6 +18,20 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include <vector>
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -27,7 +41,538 @@ DEAL_II_NAMESPACE_OPEN
  * evaluation.
  */
 namespace MatrixFreeTools
-{} // namespace MatrixFreeTools
+{
+  /**
+   * Compute the diagonal of a linear operator (@p diagonal_global), given
+   * @p matrix_free and the local cell integral operation @p local_vmult. The
+   * vector is initialized to the right size in the function.
+   *
+   * The operation @p local_vmult is given an FEEvaluation object that has
+   * been reinitialized to the current cell batch and whose degrees of
+   * freedom have been set to a unit vector. It has to evaluate the
+   * operator on the cell, i.e., call FEEvaluation::evaluate(), apply the
+   * operation at the quadrature points, and call FEEvaluation::integrate().
+   * It must not read from or write to global vectors:
+   * @code
+   * MatrixFreeTools::compute_diagonal(
+   *   matrix_free,
+   *   constraints,
+   *   diagonal,
+   *   std::function<void(FEEvaluation<dim, fe_degree> &)>(
+   *     [](FEEvaluation<dim, fe_degree> &phi) {
+   *       phi.evaluate(false, true);
+   *       for (unsigned int q = 0; q < phi.n_q_points; ++q)
+   *         phi.submit_gradient(phi.get_gradient(q), q);
+   *       phi.integrate(false, true);
+   *     }));
+   * @endcode
+   *
+   * The operation is applied to all unit vectors on the cell, and the
+   * resulting columns of the cell matrices of all lanes of the cell batch
+   * are condensed into the diagonal according to @p constraints. This is
+   * the same result as the diagonal of the matrix assembled with
+   * AffineConstraints::distribute_local_to_global() from the same cell
+   * matrices, including the entries of the constrained rows, which are set
+   * to the same values that function puts there. Thus, the constraints
+   * must be the same that the degrees of freedom of the matrix-free
+   * operator are subject to, typically those passed to MatrixFree::reinit()
+   * for the DoFHandler with index @p dof_no. If @p matrix_free has been set
+   * up for a multigrid level, the level degrees of freedom are used and
+   * @p constraints should only contain the constraints on that level.
+   *
+   * The cost of this function is the cost of one operator evaluation per
+   * degree of freedom on each cell, i.e., it is proportional to the cost of
+   * an operator evaluation times the number of degrees of freedom per cell.
+   * For moderate polynomial degrees this is still cheaper than assembling
+   * the diagonal with FEValues.
+   */
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType>
+  void
+  compute_diagonal(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    const AffineConstraints<Number> &                   constraints,
+    LinearAlgebra::distributed::Vector<Number> &        diagonal_global,
+    const std::function<void(FEEvaluation<dim,
+                                          fe_degree,
+                                          n_q_points_1d,
+                                          n_components,
+                                          Number,
+                                          VectorizedArrayType> &)>
+      &                local_vmult,
+    const unsigned int dof_no                   = 0,
+    const unsigned int quad_no                  = 0,
+    const unsigned int first_selected_component = 0);
+
+  /**
+   * Same as above but with a member function pointer of class @p CLASS as
+   * the local operation, which allows the compiler to deduce all template
+   * arguments from the signature of the member function.
+   */
+  template <typename CLASS,
+            int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType>
+  void
+  compute_diagonal(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    const AffineConstraints<Number> &                   constraints,
+    LinearAlgebra::distributed::Vector<Number> &        diagonal_global,
+    void (CLASS::*cell_operation)(FEEvaluation<dim,
+                                               fe_degree,
+                                               n_q_points_1d,
+                                               n_components,
+                                               Number,
+                                               VectorizedArrayType> &) const,
+    const CLASS *      owning_class,
+    const unsigned int dof_no                   = 0,
+    const unsigned int quad_no                  = 0,
+    const unsigned int first_selected_component = 0);
+
+  /**
+   * Compute the matrix of a linear operator given @p matrix_free and the
+   * local cell integral operation @p local_vmult, and add it into
+   * @p matrix. The local operation has the same meaning as in
+   * compute_diagonal(). The cell matrices are added into the global matrix
+   * with AffineConstraints::distribute_local_to_global() using
+   * @p constraints, so the sparsity pattern of @p matrix must have been
+   * created with the same constraints, e.g. with
+   * DoFTools::make_sparsity_pattern() and @p keep_constrained_dofs set to
+   * false. Any matrix type supported by that function can be used, e.g.
+   * SparseMatrix or TrilinosWrappers::SparseMatrix, which makes it possible
+   * to set up algebraic multigrid preconditioners or coarse-grid solvers
+   * from a matrix-free operator without a second, matrix-based
+   * implementation of the same operator. At the end, the function calls
+   * `matrix.compress(VectorOperation::add)`.
+   *
+   * The matrix is not zeroed in this function.
+   */
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType,
+            typename MatrixType>
+  void
+  compute_matrix(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    const AffineConstraints<Number> &                   constraints,
+    MatrixType &                                        matrix,
+    const std::function<void(FEEvaluation<dim,
+                                          fe_degree,
+                                          n_q_points_1d,
+                                          n_components,
+                                          Number,
+                                          VectorizedArrayType> &)>
+      &                local_vmult,
+    const unsigned int dof_no                   = 0,
+    const unsigned int quad_no                  = 0,
+    const unsigned int first_selected_component = 0);
+
+  /**
+   * Same as above but with a member function pointer of class @p CLASS as
+   * the local operation.
+   */
+  template <typename CLASS,
+            int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType,
+            typename MatrixType>
+  void
+  compute_matrix(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    const AffineConstraints<Number> &                   constraints,
+    MatrixType &                                        matrix,
+    void (CLASS::*cell_operation)(FEEvaluation<dim,
+                                               fe_degree,
+                                               n_q_points_1d,
+                                               n_components,
+                                               Number,
+                                               VectorizedArrayType> &) const,
+    const CLASS *      owning_class,
+    const unsigned int dof_no                   = 0,
+    const unsigned int quad_no                  = 0,
+    const unsigned int first_selected_component = 0);
+
+
+
+  // ----------------------- Inline functions ----------------------------
+
+#ifndef DOXYGEN
+
+  namespace internal
+  {
+    /**
+     * Call the function @p cell_operation with the matrices of all cells
+     * of @p matrix_free and the global indices of their degrees of freedom,
+     * using the numbering of the degrees of freedom within FEEvaluation for
+     * the rows and columns of the cell matrices.
+     */
+    template <int dim,
+              int fe_degree,
+              int n_q_points_1d,
+              int n_components,
+              typename Number,
+              typename VectorizedArrayType>
+    void
+    loop_over_cell_matrices(
+      const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+      const std::function<void(FEEvaluation<dim,
+                                            fe_degree,
+                                            n_q_points_1d,
+                                            n_components,
+                                            Number,
+                                            VectorizedArrayType> &)>
+        &                local_vmult,
+      const unsigned int dof_no,
+      const unsigned int quad_no,
+      const unsigned int first_selected_component,
+      const std::function<
+        void(const FullMatrix<Number> &,
+             const std::vector<types::global_dof_index> &)> &cell_operation)
+    {
+      FEEvaluation<dim,
+                   fe_degree,
+                   n_q_points_1d,
+                   n_components,
+                   Number,
+                   VectorizedArrayType>
+        phi(matrix_free, dof_no, quad_no, first_selected_component);
+
+      const unsigned int dofs_per_cell = phi.dofs_per_cell;
+
+      // translate the numbering of FEEvaluation (component by component in
+      // lexicographic order, starting at the selected component) into the
+      // numbering of the degrees of freedom on the cell of the finite
+      // element
+      const auto &dof_info = matrix_free.get_dof_info(dof_no);
+      const unsigned int base_element =
+        dof_info.component_to_base_index[first_selected_component];
+      const unsigned int first_component_within_base =
+        first_selected_component - dof_info.start_components[base_element];
+      const unsigned int dofs_per_component =
+        phi.get_shape_info().dofs_per_component_on_cell;
+      const std::vector<unsigned int> &lexicographic_numbering =
+        phi.get_internal_dof_numbering();
+
+      std::vector<unsigned int> cell_dof_index(dofs_per_cell);
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
+        cell_dof_index[i] = lexicographic_numbering
+          [first_component_within_base * dofs_per_component + i];
+
+      const unsigned int n_dofs_on_cell =
+        matrix_free.get_dof_handler(dof_no).get_fe().dofs_per_cell;
+      std::vector<types::global_dof_index> dof_indices_on_cell(
+        n_dofs_on_cell);
+      std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
+
+      std::vector<FullMatrix<Number>> cell_matrices(
+        VectorizedArrayType::size(),
+        FullMatrix<Number>(dofs_per_cell, dofs_per_cell));
+
+      for (unsigned int cell = 0; cell < matrix_free.n_cell_batches(); ++cell)
+        {
+          const unsigned int n_lanes =
+            matrix_free.n_active_entries_per_cell_batch(cell);
+
+          phi.reinit(cell);
+
+          // apply the operator to all unit vectors, one column of the cell
+          // matrices of all lanes at a time
+          for (unsigned int i = 0; i < dofs_per_cell; ++i)
+            {
+              for (unsigned int j = 0; j < dofs_per_cell; ++j)
+                phi.begin_dof_values()[j] = Number();
+              phi.begin_dof_values()[i] = Number(1.);
+
+              local_vmult(phi);
+
+              for (unsigned int j = 0; j < dofs_per_cell; ++j)
+                for (unsigned int v = 0; v < n_lanes; ++v)
+                  cell_matrices[v](j, i) = phi.begin_dof_values()[j][v];
+            }
+
+          for (unsigned int v = 0; v < n_lanes; ++v)
+            {
+              const auto cell_iterator =
+                matrix_free.get_cell_iterator(cell, v, dof_no);
+              if (matrix_free.get_mg_level() != numbers::invalid_unsigned_int)
+                cell_iterator->get_mg_dof_indices(dof_indices_on_cell);
+              else
+                cell_iterator->get_dof_indices(dof_indices_on_cell);
+
+              for (unsigned int j = 0; j < dofs_per_cell; ++j)
+                dof_indices[j] = dof_indices_on_cell[cell_dof_index[j]];
+
+              cell_operation(cell_matrices[v], dof_indices);
+            }
+        }
+    }
+  } // namespace internal
+
+
+
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType>
+  void
+  compute_diagonal(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    const AffineConstraints<Number> &                   constraints,
+    LinearAlgebra::distributed::Vector<Number> &        diagonal_global,
+    const std::function<void(FEEvaluation<dim,
+                                          fe_degree,
+                                          n_q_points_1d,
+                                          n_components,
+                                          Number,
+                                          VectorizedArrayType> &)>
+      &                local_vmult,
+    const unsigned int dof_no,
+    const unsigned int quad_no,
+    const unsigned int first_selected_component)
+  {
+    matrix_free.initialize_dof_vector(diagonal_global, dof_no);
+
+    // list of (global row, row of the cell matrix, weight) describing how
+    // the rows of the cell matrix are condensed into the global rows
+    std::vector<std::tuple<types::global_dof_index, unsigned int, Number>>
+      condensed_rows;
+
+    internal::loop_over_cell_matrices(
+      matrix_free,
+      local_vmult,
+      dof_no,
+      quad_no,
+      first_selected_component,
+      std::function<void(const FullMatrix<Number> &,
+                         const std::vector<types::global_dof_index> &)>(
+        [&](const FullMatrix<Number> &                  cell_matrix,
+            const std::vector<types::global_dof_index> &dof_indices) {
+          condensed_rows.clear();
+          bool has_constraints = false;
+          for (unsigned int i = 0; i < dof_indices.size(); ++i)
+            if (constraints.is_constrained(dof_indices[i]))
+              {
+                has_constraints = true;
+                for (const auto &entry :
+                     *constraints.get_constraint_entries(dof_indices[i]))
+                  condensed_rows.emplace_back(entry.first, i, entry.second);
+              }
+            else
+              condensed_rows.emplace_back(dof_indices[i], i, Number(1.));
+
+          std::sort(condensed_rows.begin(),
+                    condensed_rows.end(),
+                    [](const auto &a, const auto &b) {
+                      return std::get<0>(a) < std::get<0>(b);
+                    });
+
+          // the diagonal entry of a global row is the sum over all pairs
+          // of cell matrix entries that are condensed into that row
+          for (auto begin = condensed_rows.begin();
+               begin != condensed_rows.end();)
+            {
+              auto end = begin;
+              while (end != condensed_rows.end() &&
+                     std::get<0>(*end) == std::get<0>(*begin))
+                ++end;
+
+              Number sum = Number();
+              for (auto a = begin; a != end; ++a)
+                for (auto b = begin; b != end; ++b)
+                  sum += std::get<2>(*a) *
+                         cell_matrix(std::get<1>(*a), std::get<1>(*b)) *
+                         std::get<2>(*b);
+              diagonal_global(std::get<0>(*begin)) += sum;
+
+              begin = end;
+            }
+
+          // set the diagonal of the constrained rows in the same way as
+          // AffineConstraints::distribute_local_to_global() does
+          if (has_constraints)
+            {
+              Number average_diagonal = Number();
+              for (unsigned int i = 0; i < cell_matrix.m(); ++i)
+                average_diagonal += std::abs(cell_matrix(i, i));
+              average_diagonal /= static_cast<Number>(cell_matrix.m());
+              if (average_diagonal == static_cast<Number>(0.))
+                {
+                  average_diagonal =
+                    static_cast<Number>(cell_matrix.l1_norm()) /
+                    static_cast<Number>(cell_matrix.m());
+                  if (average_diagonal == static_cast<Number>(0.))
+                    average_diagonal = static_cast<Number>(1.);
+                }
+
+              for (unsigned int i = 0; i < dof_indices.size(); ++i)
+                if (constraints.is_constrained(dof_indices[i]))
+                  diagonal_global(dof_indices[i]) +=
+                    (std::abs(cell_matrix(i, i)) != 0. ?
+                       std::abs(cell_matrix(i, i)) :
+                       average_diagonal);
+            }
+        }));
+
+    diagonal_global.compress(VectorOperation::add);
+  }
+
+
+
+  template <typename CLASS,
+            int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType>
+  void
+  compute_diagonal(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    const AffineConstraints<Number> &                   constraints,
+    LinearAlgebra::distributed::Vector<Number> &        diagonal_global,
+    void (CLASS::*cell_operation)(FEEvaluation<dim,
+                                               fe_degree,
+                                               n_q_points_1d,
+                                               n_components,
+                                               Number,
+                                               VectorizedArrayType> &) const,
+    const CLASS *      owning_class,
+    const unsigned int dof_no,
+    const unsigned int quad_no,
+    const unsigned int first_selected_component)
+  {
+    compute_diagonal<dim,
+                     fe_degree,
+                     n_q_points_1d,
+                     n_components,
+                     Number,
+                     VectorizedArrayType>(
+      matrix_free,
+      constraints,
+      diagonal_global,
+      [&](FEEvaluation<dim,
+                       fe_degree,
+                       n_q_points_1d,
+                       n_components,
+                       Number,
+                       VectorizedArrayType> &phi) {
+        (owning_class->*cell_operation)(phi);
+      },
+      dof_no,
+      quad_no,
+      first_selected_component);
+  }
+
+
+
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType,
+            typename MatrixType>
+  void
+  compute_matrix(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    const AffineConstraints<Number> &                   constraints,
+    MatrixType &                                        matrix,
+    const std::function<void(FEEvaluation<dim,
+                                          fe_degree,
+                                          n_q_points_1d,
+                                          n_components,
+                                          Number,
+                                          VectorizedArrayType> &)>
+      &                local_vmult,
+    const unsigned int dof_no,
+    const unsigned int quad_no,
+    const unsigned int first_selected_component)
+  {
+    internal::loop_over_cell_matrices(
+      matrix_free,
+      local_vmult,
+      dof_no,
+      quad_no,
+      first_selected_component,
+      std::function<void(const FullMatrix<Number> &,
+                         const std::vector<types::global_dof_index> &)>(
+        [&](const FullMatrix<Number> &                  cell_matrix,
+            const std::vector<types::global_dof_index> &dof_indices) {
+          constraints.distribute_local_to_global(cell_matrix,
+                                                 dof_indices,
+                                                 matrix);
+        }));
+
+    matrix.compress(VectorOperation::add);
+  }
+
+
+
+  template <typename CLASS,
+            int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType,
+            typename MatrixType>
+  void
+  compute_matrix(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    const AffineConstraints<Number> &                   constraints,
+    MatrixType &                                        matrix,
+    void (CLASS::*cell_operation)(FEEvaluation<dim,
+                                               fe_degree,
+                                               n_q_points_1d,
+                                               n_components,
+                                               Number,
+                                               VectorizedArrayType> &) const,
+    const CLASS *      owning_class,
+    const unsigned int dof_no,
+    const unsigned int quad_no,
+    const unsigned int first_selected_component)
+  {
+    compute_matrix<dim,
+                   fe_degree,
+                   n_q_points_1d,
+                   n_components,
+                   Number,
+                   VectorizedArrayType,
+                   MatrixType>(
+      matrix_free,
+      constraints,
+      matrix,
+      [&](FEEvaluation<dim,
+                       fe_degree,
+                       n_q_points_1d,
+                       n_components,
+                       Number,
+                       VectorizedArrayType> &phi) {
+        (owning_class->*cell_operation)(phi);
+      },
+      dof_no,
+      quad_no,
+      first_selected_component);
+  }
+
+#endif // DOXYGEN
+
+} // namespace MatrixFreeTools
 
 
 DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,679 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mg_transfer_global_coarsening_h
+#define dealii_mg_transfer_global_coarsening_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/partitioner.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/multigrid/mg_base.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+// Forward declarations
+namespace internal
+{
+  class MGTwoLevelTransferImplementation;
+}
+
+
+
+/**
+ * Utility functions for setting up the hierarchy of independent meshes and
+ * polynomial degrees used by global-coarsening multigrid, see
+ * MGTransferGlobalCoarsening.
+ */
+namespace MGTransferGlobalCoarseningTools
+{
+  /**
+   * Common polynomial coarsening sequences.
+   */
+  enum class PolynomialCoarseningSequenceType
+  {
+    /**
+     * Half polynomial degree by integer division. For example, for degree=7
+     * the following sequence would be obtained:: 7 -> 3 -> 1
+     */
+    bisect,
+    /**
+     * Decrease the polynomial degree by one. E.g., for degree=7 following
+     * sequence would result: 7 -> 6 -> 5 -> 4 -> 3 -> 2 -> 1
+     */
+    decrease_by_one,
+    /**
+     * Decrease the polynomial degree to one. E.g., for degree=7 following
+     * sequence would result: 7 -> 1
+     */
+    go_to_one
+  };
+
+  /**
+   * For a given @p degree and polynomial coarsening sequence @p p_sequence,
+   * determine the next coarser degree.
+   */
+  unsigned int
+  create_next_polynomial_coarsening_degree(
+    const unsigned int                      degree,
+    const PolynomialCoarseningSequenceType &p_sequence);
+
+  /**
+   * For a given @p max_degree and polynomial coarsening sequence @p p_sequence,
+   * determine the full sequence of polynomial degrees, sorted in ascending
+   * order.
+   */
+  std::vector<unsigned int>
+  create_polynomial_coarsening_sequence(
+    const unsigned int                      max_degree,
+    const PolynomialCoarseningSequenceType &p_sequence);
+
+  /**
+   * For a given triangulation @p tria, determine the geometric coarsening
+   * sequence by repeated global coarsening of the provided triangulation.
+   * The returned triangulations are sorted from the coarsest to the finest
+   * one; the last entry is a copy of @p tria. Each triangulation in the
+   * sequence differs from the next finer one in that every cell whose
+   * children are all active has been coarsened, i.e., all cells are
+   * coarsened at the same time independently of their refinement level.
+   *
+   * For parallel::distributed::Triangulation objects, the coarser meshes
+   * are not repartitioned. This ensures that the children of a locally
+   * owned cell of a coarser mesh are locally owned on the next finer mesh,
+   * which is what MGTwoLevelTransfer::reinit_geometric_transfer() requires.
+   */
+  template <int dim, int spacedim>
+  std::vector<std::shared_ptr<const Triangulation<dim, spacedim>>>
+  create_geometric_coarsening_sequence(
+    const Triangulation<dim, spacedim> &tria);
+
+} // namespace MGTransferGlobalCoarseningTools
+
+
+
+/**
+ * Class for transfer between two multigrid levels for p- or global
+ * h-coarsening. In contrast to MGTransferMatrixFree, the two levels are
+ * described by two independent DoFHandler objects that may live on
+ * different triangulations, rather than by two levels of the same
+ * DoFHandler. This allows to set up multigrid hierarchies in which all
+ * cells are coarsened at the same time (global coarsening), which avoids
+ * the load imbalance of the level-wise partitioning of adaptively refined
+ * meshes, and to coarsen the polynomial degree (p-multigrid).
+ *
+ * The transfer is applied cell by cell, vectorized over several coarse
+ * cells with VectorizedArray, using sum factorization with one-dimensional
+ * interpolation matrices.
+ *
+ * This class is only implemented for LinearAlgebra::distributed::Vector and
+ * scalar or vector-valued elements that are built from FE_Q or FE_DGQ.
+ */
+template <int dim, typename VectorType>
+class MGTwoLevelTransfer
+{
+public:
+  /**
+   * Perform prolongation.
+   */
+  void
+  prolongate(VectorType &dst, const VectorType &src) const;
+
+  /**
+   * Perform restriction.
+   */
+  void
+  restrict_and_add(VectorType &dst, const VectorType &src) const;
+
+  /**
+   * Perform interpolation of a solution vector from the fine level to the
+   * coarse level. This function is different from restriction, where a
+   * weighted residual is transferred to a coarser level (transposition of
+   * prolongation matrix).
+   */
+  void
+  interpolate(VectorType &dst, const VectorType &src) const;
+};
+
+
+
+/**
+ * Class for transfer between two multigrid levels for p- or global
+ * h-coarsening. Specialization for LinearAlgebra::distributed::Vector.
+ */
+template <int dim, typename Number>
+class MGTwoLevelTransfer<dim, LinearAlgebra::distributed::Vector<Number>>
+{
+public:
+  /**
+   * Set up global coarsening between the given DoFHandler objects
+   * (@p dof_handler_fine and @p dof_handler_coarse), which use the same
+   * finite element on two triangulations where the fine triangulation is
+   * obtained from the coarse one by refining some of its active cells once,
+   * as generated by
+   * MGTransferGlobalCoarseningTools::create_geometric_coarsening_sequence().
+   *
+   * The constraints describe the subspaces (hanging nodes, homogeneous
+   * Dirichlet boundary conditions) in which the level vectors live.
+   * Constrained entries of the coarse vector are reconstructed from their
+   * masters before prolongation, and constrained entries of the fine vector
+   * are neither written by prolongation nor read by restriction.
+   *
+   * In parallel, the children of each locally owned cell of the coarse
+   * triangulation need to be locally owned or ghost cells of the fine
+   * triangulation.
+   */
+  void
+  reinit_geometric_transfer(
+    const DoFHandler<dim> &          dof_handler_fine,
+    const DoFHandler<dim> &          dof_handler_coarse,
+    const AffineConstraints<Number> &constraint_fine =
+      AffineConstraints<Number>(),
+    const AffineConstraints<Number> &constraint_coarse =
+      AffineConstraints<Number>());
+
+  /**
+   * Set up polynomial coarsening between the given DoFHandler objects
+   * (@p dof_handler_fine and @p dof_handler_coarse), which need to be
+   * defined on the same triangulation and use elements of the same type,
+   * with the polynomial degree of the coarse element not exceeding the one
+   * of the fine element. The constraints are used as in
+   * reinit_geometric_transfer().
+   */
+  void
+  reinit_polynomial_transfer(
+    const DoFHandler<dim> &          dof_handler_fine,
+    const DoFHandler<dim> &          dof_handler_coarse,
+    const AffineConstraints<Number> &constraint_fine =
+      AffineConstraints<Number>(),
+    const AffineConstraints<Number> &constraint_coarse =
+      AffineConstraints<Number>());
+
+  /**
+   * Perform prolongation. The previous content of @p dst is overwritten.
+   */
+  void
+  prolongate(LinearAlgebra::distributed::Vector<Number> &      dst,
+             const LinearAlgebra::distributed::Vector<Number> &src) const;
+
+  /**
+   * Perform restriction, i.e., apply the transpose of the prolongation
+   * operator and add the result to @p dst.
+   */
+  void
+  restrict_and_add(LinearAlgebra::distributed::Vector<Number> &      dst,
+                   const LinearAlgebra::distributed::Vector<Number> &src) const;
+
+  /**
+   * Perform interpolation of a solution vector from the fine level to the
+   * coarse level, i.e., evaluate the fine-level function in the nodes of the
+   * coarse element. The previous content of @p dst is overwritten.
+   */
+  void
+  interpolate(LinearAlgebra::distributed::Vector<Number> &      dst,
+              const LinearAlgebra::distributed::Vector<Number> &src) const;
+
+  /**
+   * Return the partitioner describing the locally owned degrees of freedom
+   * on the fine level.
+   */
+  std::shared_ptr<const Utilities::MPI::Partitioner>
+  get_partitioner_fine() const;
+
+  /**
+   * Return the partitioner describing the locally owned degrees of freedom
+   * on the coarse level.
+   */
+  std::shared_ptr<const Utilities::MPI::Partitioner>
+  get_partitioner_coarse() const;
+
+  /**
+   * Return the memory consumption of the allocated memory in this class.
+   */
+  std::size_t
+  memory_consumption() const;
+
+private:
+  /**
+   * A multigrid transfer scheme. A multigrid transfer class can have
+   * different transfer schemes to enable p-adaptivity (one multigrid transfer
+   * scheme per polynomial degree pair) and to enable global coarsening (one
+   * transfer scheme for transfer between children and parent cells, as well
+   * as, one transfer scheme for cells that are not refined).
+   */
+  struct MGTransferScheme
+  {
+    /**
+     * Number of coarse cells.
+     */
+    unsigned int n_coarse_cells;
+
+    /**
+     * Number of degrees of freedom of a coarse cell, summed over all
+     * components.
+     */
+    unsigned int dofs_per_cell_coarse;
+
+    /**
+     * Number of degrees of freedom of the fine cells (or the patch of child
+     * cells) that correspond to a coarse cell, summed over all components.
+     */
+    unsigned int dofs_per_cell_fine;
+
+    /**
+     * Number of one-dimensional coarse basis functions.
+     */
+    unsigned int n_dofs_1d_coarse;
+
+    /**
+     * Number of one-dimensional fine basis functions, counting the shared
+     * nodes of the child cells of continuous elements only once.
+     */
+    unsigned int n_dofs_1d_fine;
+
+    /**
+     * Whether the transfer is the identity, i.e., whether fine and coarse
+     * cell coincide and use the same element.
+     */
+    bool transfer_is_identity;
+
+    /**
+     * One-dimensional prolongation matrix, containing the coarse basis
+     * functions evaluated in the fine nodes, stored as
+     * n_dofs_1d_coarse x n_dofs_1d_fine.
+     */
+    AlignedVector<Number> prolongation_matrix_1d;
+
+    /**
+     * One-dimensional interpolation matrix, containing the fine basis
+     * functions evaluated in the coarse nodes, stored as
+     * n_dofs_1d_coarse x n_dofs_1d_fine.
+     */
+    AlignedVector<Number> interpolation_matrix_1d;
+
+    /**
+     * Local indices (into the vectors described by partitioner_coarse) of
+     * the coarse degrees of freedom of each cell in lexicographic order.
+     */
+    std::vector<unsigned int> level_dof_indices_coarse;
+
+    /**
+     * Local indices (into the vectors described by partitioner_fine) of
+     * the fine degrees of freedom corresponding to each coarse cell in
+     * lexicographic order.
+     */
+    std::vector<unsigned int> level_dof_indices_fine;
+  };
+
+  /**
+   * Transfer schemes.
+   */
+  std::vector<MGTransferScheme> schemes;
+
+  /**
+   * Number of components.
+   */
+  unsigned int n_components;
+
+  /**
+   * Partitioner needed by the intermediate vector on the fine level, which
+   * contains all fine degrees of freedom touched by the locally owned coarse
+   * cells as ghosts.
+   */
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner_fine;
+
+  /**
+   * Partitioner needed by the intermediate vector on the coarse level, which
+   * contains all coarse degrees of freedom of the locally owned coarse
+   * cells and the masters of their constrained entries as ghosts.
+   */
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner_coarse;
+
+  /**
+   * Internal vector needed for collecting all degrees of freedom of the fine
+   * cells.
+   */
+  mutable LinearAlgebra::distributed::Vector<Number> vec_fine;
+
+  /**
+   * Internal vector on which the actual prolongation/restriction is
+   * performed.
+   */
+  mutable LinearAlgebra::distributed::Vector<Number> vec_coarse;
+
+  /**
+   * Weights of the fine degrees of freedom, indexed by their local index.
+   * The weight is the inverse of the number of coarse cells a degree of
+   * freedom contributes to, or zero for constrained degrees of freedom.
+   */
+  AlignedVector<Number> weights_fine;
+
+  /**
+   * Weights of the coarse degrees of freedom used by interpolate(), defined
+   * as for the fine level.
+   */
+  AlignedVector<Number> weights_coarse;
+
+  /**
+   * For each local index of the coarse level, the row of its constraint in
+   * constraint_coarse_row_starts, or numbers::invalid_unsigned_int for
+   * unconstrained degrees of freedom.
+   */
+  std::vector<unsigned int> constraint_coarse_rows;
+
+  /**
+   * Start of the constraint entries of each constrained coarse degree of
+   * freedom in constraint_coarse_entries.
+   */
+  std::vector<unsigned int> constraint_coarse_row_starts;
+
+  /**
+   * Masters (as local index) and weights of the constrained coarse degrees
+   * of freedom.
+   */
+  std::vector<std::pair<unsigned int, Number>> constraint_coarse_entries;
+
+  friend class internal::MGTwoLevelTransferImplementation;
+};
+
+
+
+/**
+ * Implementation of the MGTransferBase interface for global coarsening,
+ * i.e., for multigrid hierarchies in which every level is described by its
+ * own DoFHandler, possibly on its own triangulation. The transfer between
+ * two consecutive levels is done by MGTwoLevelTransfer objects, which can
+ * describe polynomial coarsening as well as geometric global coarsening, so
+ * that hybrid hierarchies (e.g., first coarsening the polynomial degree,
+ * then the mesh) are possible.
+ *
+ * This class can be used with Multigrid and PreconditionMG in the same way as
+ * MGTransferMatrixFree, with the difference that the DoFHandler passed to
+ * the copy functions is the one of the finest level.
+ */
+template <int dim, typename VectorType>
+class MGTransferGlobalCoarsening : public dealii::MGTransferBase<VectorType>
+{
+public:
+  /**
+   * Value type.
+   */
+  using Number = typename VectorType::value_type;
+
+  /**
+   * Constructor taking a collection of transfer operators (with the coarsest
+   * level kept empty in @p transfer) and an optional function that
+   * initializes the internal level vectors within the function call
+   * copy_to_mg() if used in the context of PreconditionMG. If no such
+   * function is given, the level vectors are initialized without ghost
+   * entries from the partitioners of the transfer operators.
+   */
+  MGTransferGlobalCoarsening(
+    const MGLevelObject<MGTwoLevelTransfer<dim, VectorType>> &transfer,
+    const std::function<void(const unsigned int, VectorType &)>
+      &initialize_dof_vector = {});
+
+  /**
+   * Perform prolongation.
+   */
+  void
+  prolongate(const unsigned int to_level,
+             VectorType &       dst,
+             const VectorType & src) const override;
+
+  /**
+   * Perform restriction.
+   */
+  virtual void
+  restrict_and_add(const unsigned int from_level,
+                   VectorType &       dst,
+                   const VectorType & src) const override;
+
+  /**
+   * Initialize internal vectors and copy @p src vector to the finest
+   * multigrid level.
+   *
+   * @note DoFHandler is not needed here, but is required by the interface.
+   */
+  template <class InVector, int spacedim>
+  void
+  copy_to_mg(const DoFHandler<dim, spacedim> &dof_handler,
+             MGLevelObject<VectorType> &      dst,
+             const InVector &                 src) const;
+
+  /**
+   * Initialize internal vectors and copy the values on the finest
+   * multigrid level to @p dst vector.
+   *
+   * @note DoFHandler is not needed here, but is required by the interface.
+   */
+  template <class OutVector, int spacedim>
+  void
+  copy_from_mg(const DoFHandler<dim, spacedim> &dof_handler,
+               OutVector &                      dst,
+               const MGLevelObject<VectorType> &src) const;
+
+  /**
+   * Add the values on the finest multigrid level to @p dst vector.
+   *
+   * @note DoFHandler is not needed here, but is required by the interface.
+   */
+  template <class OutVector, int spacedim>
+  void
+  copy_from_mg_add(const DoFHandler<dim, spacedim> &dof_handler,
+                   OutVector &                      dst,
+                   const MGLevelObject<VectorType> &src) const;
+
+  /**
+   * Interpolate fine-mesh field @p src to each multigrid level in
+   * @p dof_handler and store the result in @p dst.
+   *
+   * @note DoFHandler is not needed here, but is required by the interface.
+   */
+  template <class InVector, int spacedim>
+  void
+  interpolate_to_mg(const DoFHandler<dim, spacedim> &dof_handler,
+                    MGLevelObject<VectorType> &      dst,
+                    const InVector &                 src) const;
+
+private:
+  /**
+   * Initialize the level vectors of @p vectors on all levels.
+   */
+  void
+  initialize_level_vectors(MGLevelObject<VectorType> &vectors) const;
+
+  /**
+   * Collection of the two-level transfer operators.
+   */
+  const MGLevelObject<MGTwoLevelTransfer<dim, VectorType>> &transfer;
+
+  /**
+   * Function to initialize internal level vectors.
+   */
+  const std::function<void(const unsigned int, VectorType &)>
+    initialize_dof_vector;
+};
+
+
+
+/*@}*/
+
+
+
+#ifndef DOXYGEN
+
+/* ----------------------- Inline functions --------------------------------- */
+
+
+
+template <int dim, typename VectorType>
+MGTransferGlobalCoarsening<dim, VectorType>::MGTransferGlobalCoarsening(
+  const MGLevelObject<MGTwoLevelTransfer<dim, VectorType>> &transfer,
+  const std::function<void(const unsigned int, VectorType &)>
+    &initialize_dof_vector)
+  : transfer(transfer)
+  , initialize_dof_vector(initialize_dof_vector)
+{}
+
+
+
+template <int dim, typename VectorType>
+void
+MGTransferGlobalCoarsening<dim, VectorType>::prolongate(
+  const unsigned int to_level,
+  VectorType &       dst,
+  const VectorType & src) const
+{
+  this->transfer[to_level].prolongate(dst, src);
+}
+
+
+
+template <int dim, typename VectorType>
+void
+MGTransferGlobalCoarsening<dim, VectorType>::restrict_and_add(
+  const unsigned int from_level,
+  VectorType &       dst,
+  const VectorType & src) const
+{
+  this->transfer[from_level].restrict_and_add(dst, src);
+}
+
+
+
+template <int dim, typename VectorType>
+void
+MGTransferGlobalCoarsening<dim, VectorType>::initialize_level_vectors(
+  MGLevelObject<VectorType> &vectors) const
+{
+  const unsigned int min_level = transfer.min_level();
+  const unsigned int max_level = transfer.max_level();
+
+  vectors.resize(min_level, max_level);
+
+  for (unsigned int level = min_level; level <= max_level; ++level)
+    if (initialize_dof_vector)
+      initialize_dof_vector(level, vectors[level]);
+    else
+      {
+        // the coarsest level does not have a transfer operator of its own,
+        // so take the coarse partitioner of the next finer level
+        const auto partitioner =
+          (level == max_level && level == min_level) ?
+            nullptr :
+            (level == min_level ?
+               transfer[level + 1].get_partitioner_coarse() :
+               transfer[level].get_partitioner_fine());
+        Assert(partitioner != nullptr,
+               ExcMessage("The level vectors can only be set up from the "
+                          "transfer operators if there are at least two "
+                          "levels. Provide a function to initialize the "
+                          "level vectors instead."));
+
+        vectors[level].reinit(partitioner->locally_owned_range(),
+                              partitioner->get_mpi_communicator());
+      }
+}
+
+
+
+template <int dim, typename VectorType>
+template <class InVector, int spacedim>
+void
+MGTransferGlobalCoarsening<dim, VectorType>::copy_to_mg(
+  const DoFHandler<dim, spacedim> &dof_handler,
+  MGLevelObject<VectorType> &      dst,
+  const InVector &                 src) const
+{
+  (void)dof_handler;
+
+  initialize_level_vectors(dst);
+
+  dst[dst.max_level()].copy_locally_owned_data_from(src);
+}
+
+
+
+template <int dim, typename VectorType>
+template <class OutVector, int spacedim>
+void
+MGTransferGlobalCoarsening<dim, VectorType>::copy_from_mg(
+  const DoFHandler<dim, spacedim> &dof_handler,
+  OutVector &                      dst,
+  const MGLevelObject<VectorType> &src) const
+{
+  (void)dof_handler;
+
+  dst.copy_locally_owned_data_from(src[src.max_level()]);
+}
+
+
+
+template <int dim, typename VectorType>
+template <class OutVector, int spacedim>
+void
+MGTransferGlobalCoarsening<dim, VectorType>::copy_from_mg_add(
+  const DoFHandler<dim, spacedim> &dof_handler,
+  OutVector &                      dst,
+  const MGLevelObject<VectorType> &src) const
+{
+  (void)dof_handler;
+
+  const VectorType &src_finest = src[src.max_level()];
+  AssertDimension(dst.local_size(), src_finest.local_size());
+  for (unsigned int i = 0; i < dst.local_size(); ++i)
+    dst.local_element(i) += src_finest.local_element(i);
+}
+
+
+
+template <int dim, typename VectorType>
+template <class InVector, int spacedim>
+void
+MGTransferGlobalCoarsening<dim, VectorType>::interpolate_to_mg(
+  const DoFHandler<dim, spacedim> &dof_handler,
+  MGLevelObject<VectorType> &      dst,
+  const InVector &                 src) const
+{
+  (void)dof_handler;
+
+  initialize_level_vectors(dst);
+
+  const unsigned int min_level = transfer.min_level();
+  const unsigned int max_level = transfer.max_level();
+
+  dst[max_level].copy_locally_owned_data_from(src);
+
+  for (unsigned int l = max_level; l > min_level; --l)
+    this->transfer[l].interpolate(dst[l - 1], dst[l]);
+}
+
+#endif
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -227,6 +227,11 @@ public:
    */
   DataOut();
 
+  /**
+   * Destructor.
+   */
+  virtual ~DataOut() override;
+
   /**
    * This is the central function of this class since it builds the list of
    * patches to be written by the low-level functions of the base class. A
@@ -325,6 +330,78 @@ public:
                 const unsigned int     n_subdivisions = 0,
                 const CurvedCellRegion curved_region  = curved_boundary);
 
+  /**
+   * Re-evaluate the data vectors on the patches generated by the last call
+   * to build_patches(), without recomputing the connectivity and, where
+   * possible, the geometry of the patches.
+   *
+   * build_patches() computes the location of the vertices of each patch
+   * (possibly using the mapping for Eulerian or curved cells), the
+   * neighborship information between patches and, if curved cells are
+   * requested, the mapped location of all subdivision points of a patch.
+   * Apart from the output of mappings that move the vertices (see below),
+   * none of this information changes as long as the triangulation is not
+   * modified, which is the common case in time dependent problems solved
+   * on a fixed mesh. In such cases, one can call build_patches() once and
+   * then, in every time step, only call this function to refresh the data
+   * values stored in the patches from the current values of the vectors
+   * that have been added via add_data_vector(). This saves the
+   * computation of the cell-to-patch connectivity, the evaluation of the
+   * mapping at the vertices and subdivision points, and the memory
+   * allocation for the patches. The result is identical to what another
+   * call to build_patches() with the same arguments would produce.
+   *
+   * This also holds for mappings for which
+   * Mapping::preserves_vertex_locations() returns false, such as
+   * MappingQEulerian or MappingFEField. The location of the cells they
+   * describe depends on a vector that is typically updated in every time
+   * step as well, so this function re-evaluates the mapping at the vertices
+   * and subdivision points of each patch in that case. Only the
+   * connectivity between the patches and the memory allocation are then
+   * reused.
+   *
+   * A typical use in a time stepping loop looks as follows:
+   * @code
+   *   DataOut<dim> data_out;
+   *   data_out.attach_dof_handler(dof_handler);
+   *   data_out.add_data_vector(solution, "u");
+   *   data_out.build_patches(mapping, fe.degree);
+   *
+   *   for (unsigned int step = 0; step < n_steps; ++step)
+   *     {
+   *       ... // compute the new values of the vector 'solution'
+   *
+   *       if (step > 0)
+   *         data_out.update_patch_data();
+   *       std::ofstream out("solution-" + std::to_string(step) + ".vtu");
+   *       data_out.write_vtu(out);
+   *     }
+   * @endcode
+   * Since the DataOut object only stores references to the data vectors,
+   * the vectors have to be updated in place, i.e., the same vector objects
+   * that were given to add_data_vector() have to hold the new values.
+   *
+   * If the geometry of the patches is the same at all time steps, i.e.,
+   * for mappings that preserve the vertex locations, the output can also
+   * reference a mesh that has only been written once:
+   * When writing HDF5 files through DataOutInterface::write_hdf5_parallel(),
+   * pass `write_mesh_file = true` only at the first time step and let all
+   * DataOutInterface::create_xdmf_entry() calls refer to the mesh file
+   * written then. Formats such as VTU, on the other hand, have no way to
+   * refer to geometry stored in another file and always write the
+   * vertices again.
+   *
+   * @note This function requires that build_patches() has been called
+   *   before, that neither the triangulation nor the set of data vectors
+   *   has changed since then (clear_data_vectors() and clear() release the
+   *   patches, for example), and that the mapping passed to build_patches()
+   *   is still alive. Any refinement, coarsening or other change of the
+   *   triangulation invalidates the stored patch geometry, and
+   *   build_patches() has to be called again.
+   */
+  void
+  update_patch_data();
+
   /**
    * A function that allows selecting for which cells output should be
    * generated. This function takes two arguments, both `std::function`
@@ -469,6 +546,50 @@ private:
                               const cell_iterator &)>
     next_cell_function;
 
+  /**
+   * The cells on which the present patches were created by build_patches(),
+   * together with their active cell index. The patch with index $i$
+   * corresponds to `patch_cells[i]`. This list, and all of the following
+   * member variables, are needed by update_patch_data() to re-evaluate the
+   * data on the same cells. The list is cleared whenever the triangulation
+   * changes.
+   */
+  std::vector<std::pair<cell_iterator, unsigned int>> patch_cells;
+
+  /**
+   * A map from the level and index of each cell in patch_cells to the
+   * index of its patch.
+   */
+  std::vector<std::vector<unsigned int>> cell_to_patch_index_map;
+
+  /**
+   * The mapping that was given to the last call of build_patches(), or a
+   * null pointer if there are no patches that could be updated.
+   */
+  const Mapping<DoFHandlerType::dimension, DoFHandlerType::space_dimension>
+    *patch_mapping;
+
+  /**
+   * The number of subdivisions and the region of curved cells that were
+   * used in the last call of build_patches().
+   */
+  unsigned int     patch_n_subdivisions;
+  CurvedCellRegion patch_curved_cell_region;
+
+  /**
+   * A connection to the triangulation that invalidates the information
+   * stored for update_patch_data() whenever the triangulation changes.
+   */
+  boost::signals2::connection tria_listener;
+
+  /**
+   * Compute the data of all patches on the cells stored in patch_cells,
+   * either building them from scratch (if @p update_data_only is false) or
+   * only re-evaluating the data vectors on patches that were built before.
+   */
+  void
+  build_patches_on_cells(const bool update_data_only);
+
   /**
    * Return the first cell produced by the first_cell()/next_cell() function
    * pair that is locally owned. If this object operates on a non-distributed
@@ -506,7 +627,8 @@ private:
                     DoFHandlerType::dimension,
                     DoFHandlerType::space_dimension> &scratch_data,
                   const unsigned int                  n_subdivisions,
-                  const CurvedCellRegion              curved_cell_region);
+                  const CurvedCellRegion              curved_cell_region,
+                  const bool                          update_data_only);
 };
 
 
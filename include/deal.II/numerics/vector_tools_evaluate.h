@@ -0,0 +1,166 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_vector_tools_evaluate_h
+#define dealii_vector_tools_evaluate_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/mpi_remote_point_evaluation.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/matrix_free/fe_point_evaluation.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace VectorTools
+{
+  /**
+   * Given a (distributed) solution vector @p vector, evaluate the values of
+   * the (distributed) finite element solution at the points that have been
+   * passed to the Utilities::MPI::RemotePointEvaluation object @p cache
+   * during its reinit() call. The points can be located on any process of
+   * the triangulation, the search of the owning cells has already been
+   * done by @p cache, so that this function only needs to evaluate the
+   * solution on the locally owned cells around the points and perform a
+   * single exchange of the values. This makes the function suitable for
+   * repeatedly evaluating a solution at a fixed set of points.
+   *
+   * If a point has been found on several cells (e.g., because it is located
+   * on a face or vertex), the average of the values computed on these
+   * cells is returned. Points that have not been found on any cell get the
+   * value zero, which can be checked with
+   * Utilities::MPI::RemotePointEvaluation::get_point_ptrs().
+   *
+   * The template argument @p n_components selects the number of components
+   * evaluated, starting at the first component of the finite element.
+   *
+   * @note The values of @p vector on the degrees of freedom of locally owned
+   *   cells need to be accessible, i.e., ghost values of distributed vectors
+   *   need to be updated before calling this function.
+   *
+   * @note This is a collective call that needs to be executed by all
+   *   processors of the communicator of the triangulation.
+   */
+  template <int n_components, int dim, int spacedim, typename VectorType>
+  std::vector<
+    typename FEPointEvaluation<n_components,
+                               dim,
+                               spacedim,
+                               typename VectorType::value_type>::value_type>
+  point_values(
+    const Utilities::MPI::RemotePointEvaluation<dim, spacedim> &cache,
+    const DoFHandler<dim, spacedim> &                           dof_handler,
+    const VectorType &                                          vector);
+
+
+
+  // ---------------------------- inline functions ---------------------------
+
+#ifndef DOXYGEN
+  template <int n_components, int dim, int spacedim, typename VectorType>
+  std::vector<
+    typename FEPointEvaluation<n_components,
+                               dim,
+                               spacedim,
+                               typename VectorType::value_type>::value_type>
+  point_values(
+    const Utilities::MPI::RemotePointEvaluation<dim, spacedim> &cache,
+    const DoFHandler<dim, spacedim> &                           dof_handler,
+    const VectorType &                                          vector)
+  {
+    using Number     = typename VectorType::value_type;
+    using value_type = typename FEPointEvaluation<n_components,
+                                                  dim,
+                                                  spacedim,
+                                                  Number>::value_type;
+
+    Assert(cache.is_ready(),
+           ExcMessage("Utilities::MPI::RemotePointEvaluation is not ready, "
+                      "call its reinit() function first."));
+    Assert(&dof_handler.get_triangulation() == &cache.get_triangulation(),
+           ExcMessage("The DoFHandler and the RemotePointEvaluation object "
+                      "need to be based on the same triangulation."));
+    Assert(dof_handler.get_fe_collection().size() == 1,
+           ExcNotImplemented());
+
+    const auto evaluation_function =
+      [&](const ArrayView<value_type> &values,
+          const typename Utilities::MPI::RemotePointEvaluation<dim, spacedim>::
+            CellData &cell_data) {
+        FEPointEvaluation<n_components, dim, spacedim, Number> evaluator(
+          cache.get_mapping(), dof_handler.get_fe(), update_values);
+
+        std::vector<Number> solution_values(dof_handler.get_fe().dofs_per_cell);
+
+        for (unsigned int i = 0; i < cell_data.cells.size(); ++i)
+          {
+            const typename DoFHandler<dim, spacedim>::active_cell_iterator cell(
+              &cache.get_triangulation(),
+              cell_data.cells[i].first,
+              cell_data.cells[i].second,
+              &dof_handler);
+
+            const ArrayView<const Point<dim>> unit_points(
+              cell_data.reference_point_values.data() +
+                cell_data.reference_point_ptrs[i],
+              cell_data.reference_point_ptrs[i + 1] -
+                cell_data.reference_point_ptrs[i]);
+
+            cell->get_dof_values(vector,
+                                 solution_values.begin(),
+                                 solution_values.end());
+
+            evaluator.reinit(cell, unit_points);
+            evaluator.evaluate(solution_values, EvaluationFlags::values);
+
+            for (unsigned int q = 0; q < unit_points.size(); ++q)
+              values[cell_data.reference_point_ptrs[i] + q] =
+                evaluator.get_value(q);
+          }
+      };
+
+    std::vector<value_type> evaluation_values;
+    std::vector<value_type> buffer;
+    cache.template evaluate_and_process<value_type>(evaluation_values,
+                                                    buffer,
+                                                    evaluation_function);
+
+    // average the values of points that have been found on several cells
+    const auto &            point_ptrs = cache.get_point_ptrs();
+    std::vector<value_type> result(point_ptrs.size() - 1, value_type());
+    for (unsigned int i = 0; i < point_ptrs.size() - 1; ++i)
+      {
+        const unsigned int n_entries = point_ptrs[i + 1] - point_ptrs[i];
+        if (n_entries == 0)
+          continue;
+
+        for (unsigned int j = point_ptrs[i]; j < point_ptrs[i + 1]; ++j)
+          result[i] += evaluation_values[j];
+        result[i] /= static_cast<Number>(n_entries);
+      }
+
+    return result;
+  }
+#endif
+
+} // namespace VectorTools
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
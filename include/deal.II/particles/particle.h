@@ -90,6 +90,9 @@ namespace Particles
      * Internal alias of cell level/index pair.
      */
     using LevelInd = std::pair<int, int>;
+
+    template <int, int>
+    class ParticleStorage;
   } // namespace internal
 
   /**
@@ -368,6 +371,13 @@ namespace Particles
 #endif
 
   private:
+    /**
+     * The particle containers of ParticleHandler copy the properties of
+     * particles directly from the property pool.
+     */
+    template <int, int>
+    friend class internal::ParticleStorage;
+
     /**
      * Current particle location.
      */
@@ -408,8 +418,17 @@ namespace Particles
 
     if (n_properties > 0)
       {
-        properties = new double[n_properties];
-        ar &boost::serialization::make_array(properties, n_properties);
+        Assert(property_pool != nullptr,
+               ExcMessage("A particle with properties can only be loaded if "
+                          "a property pool has been set with "
+                          "set_property_pool() before."));
+        AssertDimension(n_properties, property_pool->n_properties_per_slot());
+
+        if (properties == PropertyPool::invalid_handle)
+          properties = property_pool->allocate_properties_array();
+
+        for (unsigned int i = 0; i < n_properties; ++i)
+          ar &property_pool->get_property(properties, i);
       }
   }
 
@@ -421,12 +440,15 @@ namespace Particles
     unsigned int n_properties = 0;
     if ((property_pool != nullptr) &&
         (properties != PropertyPool::invalid_handle))
-      n_properties = get_properties().size();
+      n_properties = property_pool->n_properties_per_slot();
 
     ar &location &reference_location &id &n_properties;
 
-    if (n_properties > 0)
-      ar &boost::serialization::make_array(properties, n_properties);
+    for (unsigned int i = 0; i < n_properties; ++i)
+      {
+        double property = property_pool->get_property(properties, i);
+        ar &property;
+      }
   }
 } // namespace Particles
 
@@ -23,6 +23,7 @@
 #include <deal.II/grid/tria.h>
 
 #include <deal.II/particles/particle.h>
+#include <deal.II/particles/particle_storage.h>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -98,11 +99,10 @@ namespace Particles
     get_id() const;
 
     /**
-     * Tell the particle where to store its properties (even if it does not
-     * own properties). Usually this is only done once per particle, but
-     * since the particle generator does not know about the properties
-     * we want to do it not at construction time. Another use for this
-     * function is after particle transfer to a new process.
+     * Tell the particle where to store its properties. Since all particles
+     * of a container store their properties in the property pool of the
+     * container, this function only checks that @p property_pool is this
+     * pool and does not change anything.
      */
     void
     set_property_pool(PropertyPool &property_pool);
@@ -204,29 +204,40 @@ namespace Particles
     ParticleAccessor();
 
     /**
-     * Construct an accessor from a reference to a map and an iterator to the
-     * map. This constructor is protected so that it can only be accessed by
-     * friend classes.
+     * Construct an accessor from a reference to a container of particles,
+     * the cell the particle lives in, and the index of the particle within
+     * that cell. This constructor is protected so that it can only be
+     * accessed by friend classes.
      */
     ParticleAccessor(
-      const std::multimap<internal::LevelInd, Particle<dim, spacedim>> &map,
-      const typename std::multimap<internal::LevelInd,
-                                   Particle<dim, spacedim>>::iterator
-        &particle);
+      const internal::ParticleStorage<dim, spacedim> &particles,
+      const typename Triangulation<dim, spacedim>::active_cell_iterator &cell,
+      const unsigned int particle_index_within_cell);
 
   private:
+    /**
+     * Return the particle data of the cell the current particle lives in.
+     */
+    typename internal::ParticleStorage<dim, spacedim>::CellData &
+    cell_data() const;
+
     /**
      * A pointer to the container that stores the particles. Obviously,
      * this accessor is invalidated if the container changes.
      */
-    std::multimap<internal::LevelInd, Particle<dim, spacedim>> *map;
+    internal::ParticleStorage<dim, spacedim> *particles;
 
     /**
-     * An iterator into the container of particles. Obviously,
-     * this accessor is invalidated if the container changes.
+     * The cell the current particle lives in. An iterator past the end of
+     * the triangulation marks an accessor past the last particle of the
+     * container.
      */
-    typename std::multimap<internal::LevelInd,
-                           Particle<dim, spacedim>>::iterator particle;
+    typename Triangulation<dim, spacedim>::active_cell_iterator cell;
+
+    /**
+     * The index of the current particle within its cell.
+     */
+    unsigned int particle_index_within_cell;
 
     // Make ParticleIterator a friend to allow it constructing
     // ParticleAccessors.
@@ -241,10 +252,31 @@ namespace Particles
   template <int dim, int spacedim>
   template <class Archive>
   void
-  ParticleAccessor<dim, spacedim>::serialize(Archive &          ar,
-                                             const unsigned int version)
+  ParticleAccessor<dim, spacedim>::serialize(Archive &ar, const unsigned int)
   {
-    return particle->second.serialize(ar, version);
+    // Use the same format as Particle::save() and Particle::load(), so that
+    // the data can be read into a Particle object and vice versa.
+    typename internal::ParticleStorage<dim, spacedim>::CellData &data =
+      cell_data();
+
+    unsigned int n_properties =
+      has_properties() ?
+        particles->get_property_pool()->n_properties_per_slot() :
+        0;
+
+    ar &data.locations[particle_index_within_cell]
+      &data.reference_locations[particle_index_within_cell]
+        &data.ids[particle_index_within_cell] &n_properties;
+
+    if (n_properties > 0)
+      {
+        AssertDimension(n_properties,
+                        particles->get_property_pool()->n_properties_per_slot());
+        const PropertyPool::Handle handle =
+          data.properties[particle_index_within_cell];
+        for (unsigned int i = 0; i < n_properties; ++i)
+          ar &particles->get_property_pool()->get_property(handle, i);
+      }
   }
 
 
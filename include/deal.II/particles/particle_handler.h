@@ -33,6 +33,7 @@
 
 #include <deal.II/particles/particle.h>
 #include <deal.II/particles/particle_iterator.h>
+#include <deal.II/particles/particle_storage.h>
 #include <deal.II/particles/property_pool.h>
 
 #include <boost/range/iterator_range.hpp>
@@ -52,6 +53,16 @@ namespace Particles
    * and particles that belong to neighbor processes and live in the ghost cells
    * around the locally owned domain "ghost particles".
    *
+   * Particles are stored bucketed by the active cell they live in. The
+   * locations, reference locations, ids, and property handles of the
+   * particles of one cell are each kept in contiguous arrays, so that
+   * inserting a particle only appends to the arrays of its cell and loops
+   * over the particles of a cell stream through memory. Iterating over all
+   * particles visits the cells in the order of their active cell index and
+   * the particles within each cell in the order in which they were inserted.
+   * Inserting or removing particles invalidates iterators to other particles
+   * of the same cell.
+   *
    * This class is used in step-70.
    *
    * @ingroup Particle
@@ -85,22 +96,30 @@ namespace Particles
      */
     ParticleHandler(const Triangulation<dim, spacedim> &tria,
                     const Mapping<dim, spacedim> &      mapping,
-                    const unsigned int                  n_properties = 0);
+                    const unsigned int                  n_properties = 0,
+                    const PropertyPool::Layout          property_layout =
+                      PropertyPool::Layout::array_of_structures);
 
     /**
      * Destructor.
      */
-    virtual ~ParticleHandler() override = default;
+    virtual ~ParticleHandler() override;
 
     /**
-     * Initialize the particle handler. This function does not clear the
-     * internal data structures, it just sets the triangulation and the
-     * mapping to be used.
+     * Initialize the particle handler. This function does not reset the
+     * cached numbers of particles, it sets the triangulation and the
+     * mapping to be used and sets up a new property pool. Since the
+     * properties of existing particles are owned by the previous pool, all
+     * particles are removed. The argument @p property_layout determines how
+     * the properties are arranged within the property pool, see
+     * PropertyPool::Layout.
      */
     void
     initialize(const Triangulation<dim, spacedim> &tria,
                const Mapping<dim, spacedim> &      mapping,
-               const unsigned int                  n_properties = 0);
+               const unsigned int                  n_properties = 0,
+               const PropertyPool::Layout          property_layout =
+                 PropertyPool::Layout::array_of_structures);
 
     /**
      * Clear all particle related data.
@@ -210,15 +229,36 @@ namespace Particles
 
     /**
      * Remove a particle pointed to by the iterator.
+     *
+     * @note The particles of each cell are stored contiguously, and
+     * removing a particle moves the particles that follow it in the same
+     * cell one position forward. This invalidates all iterators to
+     * particles in the same cell as the removed particle that came after it,
+     * and all iterators past the end of that cell. To remove several
+     * particles, collect iterators to them and call remove_particles()
+     * instead.
      */
     void
     remove_particle(const particle_iterator &particle);
 
+    /**
+     * Remove all particles pointed to by the iterators in @p particles.
+     * The iterators may be given in any order, but must not contain the
+     * same particle twice. Since the particles of each cell are removed in
+     * a single pass, none of the given iterators is invalidated by the
+     * removal of another one, and the cost is linear in the number of
+     * particles of the affected cells. All iterators into the affected
+     * cells are invalid after this call.
+     */
+    void
+    remove_particles(const std::vector<particle_iterator> &particles);
+
     /**
      * Insert a particle into the collection of particles. Return an iterator
      * to the new position of the particle. This function involves a copy of
-     * the particle and its properties. Note that this function is of $O(N \log
-     * N)$ complexity for $N$ particles.
+     * the particle and its properties. Note that this function is of $O(1)$
+     * complexity (amortized), since the particle is appended to the
+     * particles of @p cell.
      */
     particle_iterator
     insert_particle(
@@ -228,8 +268,7 @@ namespace Particles
     /**
      * Insert a number of particles into the collection of particles.
      * This function involves a copy of the particles and their properties.
-     * Note that this function is of O(n_existing_particles + n_particles)
-     * complexity.
+     * Note that this function is of O(n_particles) complexity.
      */
     void
     insert_particles(
@@ -654,16 +693,16 @@ namespace Particles
 
     /**
      * Set of particles currently living in the local domain, organized by
-     * the level/index of the cell they are in.
+     * the active cell index of the cell they are in.
      */
-    std::multimap<internal::LevelInd, Particle<dim, spacedim>> particles;
+    internal::ParticleStorage<dim, spacedim> particles;
 
     /**
      * Set of particles that currently live in the ghost cells of the local
      * domain, organized by the level/index of the cell they are in. These
      * particles are equivalent to the ghost entries in distributed vectors.
      */
-    std::multimap<internal::LevelInd, Particle<dim, spacedim>> ghost_particles;
+    internal::ParticleStorage<dim, spacedim> ghost_particles;
 
     /**
      * This variable stores how many particles are stored globally. It is
@@ -750,20 +789,41 @@ namespace Particles
      */
     std::unique_ptr<GridTools::Cache<dim, spacedim>> triangulation_cache;
 
+    /**
+     * Set up the containers for particles and ghost particles for the
+     * current number of active cells of the triangulation, if this number
+     * has changed since they were last set up. This is only allowed while
+     * the containers are empty, because the active cell indices that
+     * identify the cells of existing particles are no longer valid after
+     * the triangulation changed.
+     */
+    void
+    resize_particle_storage();
+
+    /**
+     * Return an iterator to the first particle in @p particle_storage that
+     * lives in @p cell or in one of the active cells that follow it, or an
+     * iterator past the end of @p particle_storage if there is none.
+     */
+    particle_iterator
+    first_particle_from(
+      const internal::ParticleStorage<dim, spacedim> &particle_storage,
+      typename Triangulation<dim, spacedim>::active_cell_iterator cell) const;
+
 #ifdef DEAL_II_WITH_MPI
     /**
      * Transfer particles that have crossed subdomain boundaries to other
      * processors.
-     * All received particles and their new cells will be appended to the
-     * @p received_particles vector.
+     * All received particles will be appended to the particles of their new
+     * cells in @p received_particles.
      *
      * @param [in] particles_to_send All particles that should be sent and
      * their new subdomain_ids are in this map.
      *
-     * @param [in,out] received_particles Vector that stores all received
-     * particles. Note that it is not required nor checked that the list
+     * @param [in,out] received_particles Container that stores all received
+     * particles. Note that it is not required nor checked that the container
      * is empty, received particles are simply attached to the end of
-     * the vector.
+     * the particles of their cells.
      *
      * @param [in] new_cells_for_particles Optional vector of cell
      * iterators with the same structure as @p particles_to_send. If this
@@ -776,8 +836,7 @@ namespace Particles
     send_recv_particles(
       const std::map<types::subdomain_id, std::vector<particle_iterator>>
         &particles_to_send,
-      std::multimap<internal::LevelInd, Particle<dim, spacedim>>
-        &received_particles,
+      internal::ParticleStorage<dim, spacedim> &received_particles,
       const std::map<
         types::subdomain_id,
         std::vector<
@@ -46,13 +46,15 @@ namespace Particles
 
     /**
      * Constructor of the iterator. Takes a reference to the particle
-     * container, and an iterator to the cell-particle pair.
+     * container, the cell the particle lives in, and the index of the
+     * particle within this cell. An iterator past the last particle of the
+     * container is constructed by passing an iterator past the end of the
+     * triangulation as @p cell and zero as @p particle_index_within_cell.
      */
     ParticleIterator(
-      const std::multimap<internal::LevelInd, Particle<dim, spacedim>> &map,
-      const typename std::multimap<internal::LevelInd,
-                                   Particle<dim, spacedim>>::iterator
-        &particle);
+      const internal::ParticleStorage<dim, spacedim> &particles,
+      const typename Triangulation<dim, spacedim>::active_cell_iterator &cell,
+      const unsigned int particle_index_within_cell);
 
     /**
      * Dereferencing operator, returns a reference to an accessor. Usage is thus
@@ -0,0 +1,615 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_particles_particle_storage_h
+#define dealii_particles_particle_storage_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/point.h>
+
+#include <deal.II/particles/particle.h>
+#include <deal.II/particles/property_pool.h>
+
+#include <algorithm>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Particles
+{
+  namespace internal
+  {
+    /**
+     * A container that stores particles bucketed by the active cell they
+     * live in. Within each cell, the particles are kept as a structure of
+     * arrays: the locations, reference locations, ids, and property handles
+     * of all particles of one cell are each stored contiguously in memory.
+     * A particle is therefore identified by the active cell index of its
+     * cell and its index within that cell.
+     *
+     * Compared to a node-based container, inserting a particle only appends
+     * to the arrays of its cell, and looping over all particles of a cell
+     * streams through contiguous memory. Removing particles from a cell keeps
+     * the order of the remaining particles of that cell intact and leaves no
+     * holes in the arrays.
+     *
+     * The properties of the particles are not stored by this class, only the
+     * handles returned by the PropertyPool that owns them. Every particle in
+     * the container owns one such handle (unless the pool stores no
+     * properties), which is released when the particle is removed.
+     */
+    template <int dim, int spacedim>
+    class ParticleStorage
+    {
+    public:
+      /**
+       * The data of all particles that live in one cell.
+       */
+      struct CellData
+      {
+        /**
+         * The locations of the particles in real space.
+         */
+        std::vector<Point<spacedim>> locations;
+
+        /**
+         * The locations of the particles in the reference coordinates of
+         * the cell.
+         */
+        std::vector<Point<dim>> reference_locations;
+
+        /**
+         * The globally unique ids of the particles.
+         */
+        std::vector<types::particle_index> ids;
+
+        /**
+         * The handles to the properties of the particles.
+         */
+        std::vector<PropertyPool::Handle> properties;
+      };
+
+      /**
+       * Constructor. Creates an empty container without any cells.
+       */
+      ParticleStorage();
+
+      /**
+       * The copy constructor is deleted since the particle properties are
+       * owned by the property pool and can not be shared between two
+       * containers.
+       */
+      ParticleStorage(const ParticleStorage<dim, spacedim> &) = delete;
+
+      /**
+       * Destructor. Releases the property handles of all particles.
+       */
+      ~ParticleStorage();
+
+      /**
+       * The copy assignment operator is deleted, see the copy constructor.
+       */
+      ParticleStorage<dim, spacedim> &
+      operator=(const ParticleStorage<dim, spacedim> &) = delete;
+
+      /**
+       * Remove all particles and set up the container for @p n_cells
+       * (active) cells, whose particles store their properties in
+       * @p property_pool.
+       */
+      void
+      reinit(const unsigned int n_cells, PropertyPool &property_pool);
+
+      /**
+       * Remove all particles, but keep the number of cells and the
+       * property pool.
+       */
+      void
+      clear();
+
+      /**
+       * Return the number of cells this container has been set up for.
+       */
+      unsigned int
+      n_cells() const;
+
+      /**
+       * Return the total number of particles in the container.
+       */
+      std::size_t
+      n_particles() const;
+
+      /**
+       * Return the number of particles in the cell with the given active
+       * cell index.
+       */
+      unsigned int
+      n_particles_in_cell(const unsigned int cell) const;
+
+      /**
+       * Return a pointer to the property pool that stores the properties of
+       * the particles in this container.
+       */
+      PropertyPool *
+      get_property_pool() const;
+
+      /**
+       * Return read-write access to the particle data of the cell with the
+       * given active cell index.
+       */
+      CellData &
+      cell_data(const unsigned int cell);
+
+      /**
+       * Return read access to the particle data of the cell with the given
+       * active cell index.
+       */
+      const CellData &
+      cell_data(const unsigned int cell) const;
+
+      /**
+       * Append a copy of @p particle to the particles of @p cell. The
+       * properties of the particle are copied into a newly allocated slot
+       * of the property pool of this container; if @p particle has no
+       * properties, the new slot is initialized with zeros. Return the index
+       * of the new particle within the cell.
+       */
+      unsigned int
+      insert(const unsigned int cell, const Particle<dim, spacedim> &particle);
+
+      /**
+       * Append a particle to the particles of @p cell by reading it from
+       * the memory location @p data, which has to contain a particle
+       * serialized by Particle::write_data() or write_data(). The pointer is
+       * advanced past the data read. Return the index of the new particle
+       * within the cell.
+       */
+      unsigned int
+      insert(const unsigned int cell, const void *&data);
+
+      /**
+       * Move the particle with index @p index in @p cell to the end of the
+       * particles of @p new_cell. Its properties are not copied; instead,
+       * the property handle is transferred to the new entry. The old entry
+       * remains in @p cell with an invalid property handle and has to be
+       * removed afterwards by a call to remove_particles(). This allows to
+       * relocate several particles without invalidating the indices of the
+       * particles that still need to be processed. Return the index of the
+       * new entry within @p new_cell.
+       */
+      unsigned int
+      relocate(const unsigned int cell,
+               const unsigned int index,
+               const unsigned int new_cell);
+
+      /**
+       * Remove the particle with the given index from @p cell, releasing its
+       * properties. The order of the remaining particles is not changed.
+       */
+      void
+      remove_particle(const unsigned int cell, const unsigned int index);
+
+      /**
+       * Remove the particles whose indices are given in the sorted array
+       * @p indices from @p cell, releasing their properties. The remaining
+       * particles are compacted to the front of the arrays of the cell in a
+       * single pass, keeping their order.
+       */
+      void
+      remove_particles(const unsigned int               cell,
+                       const std::vector<unsigned int> &indices);
+
+      /**
+       * Write the data of the particle with the given index in @p cell to
+       * the memory location @p data, using the same format as
+       * Particle::write_data(). The pointer is advanced past the data
+       * written.
+       */
+      void
+      write_data(const unsigned int cell,
+                 const unsigned int index,
+                 void *&            data) const;
+
+      /**
+       * Return the number of bytes that write_data() writes per particle.
+       */
+      std::size_t
+      serialized_size_in_bytes() const;
+
+    private:
+      /**
+       * Release the property slot referenced by @p handle, if it is valid.
+       */
+      void
+      release(const PropertyPool::Handle handle);
+
+      /**
+       * The particle data of all cells, indexed by the active cell index.
+       */
+      std::vector<CellData> cells;
+
+      /**
+       * A pointer to the pool that owns the properties of the particles.
+       */
+      PropertyPool *property_pool;
+
+      /**
+       * The total number of particles in all cells.
+       */
+      std::size_t n_total_particles;
+    };
+
+
+
+    /* ---------------------- inline and template functions ---------------- */
+
+
+
+    template <int dim, int spacedim>
+    inline ParticleStorage<dim, spacedim>::ParticleStorage()
+      : property_pool(nullptr)
+      , n_total_particles(0)
+    {}
+
+
+
+    template <int dim, int spacedim>
+    inline ParticleStorage<dim, spacedim>::~ParticleStorage()
+    {
+      clear();
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline void
+    ParticleStorage<dim, spacedim>::reinit(const unsigned int n_cells,
+                                           PropertyPool &     new_pool)
+    {
+      clear();
+      property_pool = &new_pool;
+      cells.clear();
+      cells.resize(n_cells);
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline void
+    ParticleStorage<dim, spacedim>::clear()
+    {
+      for (CellData &cell : cells)
+        {
+          if (property_pool != nullptr)
+            property_pool->deallocate_properties_arrays(cell.properties);
+          cell.locations.clear();
+          cell.reference_locations.clear();
+          cell.ids.clear();
+          cell.properties.clear();
+        }
+      n_total_particles = 0;
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline unsigned int
+    ParticleStorage<dim, spacedim>::n_cells() const
+    {
+      return cells.size();
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline std::size_t
+    ParticleStorage<dim, spacedim>::n_particles() const
+    {
+      return n_total_particles;
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline unsigned int
+    ParticleStorage<dim, spacedim>::n_particles_in_cell(
+      const unsigned int cell) const
+    {
+      AssertIndexRange(cell, cells.size());
+      return cells[cell].ids.size();
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline PropertyPool *
+    ParticleStorage<dim, spacedim>::get_property_pool() const
+    {
+      return property_pool;
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline typename ParticleStorage<dim, spacedim>::CellData &
+    ParticleStorage<dim, spacedim>::cell_data(const unsigned int cell)
+    {
+      AssertIndexRange(cell, cells.size());
+      return cells[cell];
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline const typename ParticleStorage<dim, spacedim>::CellData &
+    ParticleStorage<dim, spacedim>::cell_data(const unsigned int cell) const
+    {
+      AssertIndexRange(cell, cells.size());
+      return cells[cell];
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline unsigned int
+    ParticleStorage<dim, spacedim>::insert(
+      const unsigned int             cell,
+      const Particle<dim, spacedim> &particle)
+    {
+      Assert(property_pool != nullptr, ExcNotInitialized());
+      AssertIndexRange(cell, cells.size());
+
+      CellData &data = cells[cell];
+      data.locations.push_back(particle.get_location());
+      data.reference_locations.push_back(particle.get_reference_location());
+      data.ids.push_back(particle.get_id());
+
+      const PropertyPool::Handle handle =
+        property_pool->allocate_properties_array();
+      data.properties.push_back(handle);
+
+      if (handle != PropertyPool::invalid_handle)
+        {
+          const unsigned int n_properties =
+            property_pool->n_properties_per_slot();
+          if (particle.has_properties())
+            {
+              AssertDimension(
+                particle.property_pool->n_properties_per_slot(),
+                n_properties);
+              for (unsigned int i = 0; i < n_properties; ++i)
+                property_pool->get_property(handle, i) =
+                  particle.property_pool->get_property(particle.properties,
+                                                       i);
+            }
+          else
+            for (unsigned int i = 0; i < n_properties; ++i)
+              property_pool->get_property(handle, i) = 0.;
+        }
+
+      ++n_total_particles;
+      return data.ids.size() - 1;
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline unsigned int
+    ParticleStorage<dim, spacedim>::insert(const unsigned int cell,
+                                           const void *&      data)
+    {
+      Assert(property_pool != nullptr, ExcNotInitialized());
+      AssertIndexRange(cell, cells.size());
+
+      CellData &cell_data = cells[cell];
+
+      const types::particle_index *id_data =
+        static_cast<const types::particle_index *>(data);
+      cell_data.ids.push_back(*id_data++);
+      const double *pdata = reinterpret_cast<const double *>(id_data);
+
+      Point<spacedim> location;
+      for (unsigned int i = 0; i < spacedim; ++i)
+        location(i) = *pdata++;
+      cell_data.locations.push_back(location);
+
+      Point<dim> reference_location;
+      for (unsigned int i = 0; i < dim; ++i)
+        reference_location(i) = *pdata++;
+      cell_data.reference_locations.push_back(reference_location);
+
+      const PropertyPool::Handle handle =
+        property_pool->allocate_properties_array();
+      cell_data.properties.push_back(handle);
+      if (handle != PropertyPool::invalid_handle)
+        for (unsigned int i = 0; i < property_pool->n_properties_per_slot();
+             ++i)
+          property_pool->get_property(handle, i) = *pdata++;
+
+      data = static_cast<const void *>(pdata);
+
+      ++n_total_particles;
+      return cell_data.ids.size() - 1;
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline unsigned int
+    ParticleStorage<dim, spacedim>::relocate(const unsigned int cell,
+                                             const unsigned int index,
+                                             const unsigned int new_cell)
+    {
+      AssertIndexRange(cell, cells.size());
+      AssertIndexRange(new_cell, cells.size());
+      AssertIndexRange(index, cells[cell].ids.size());
+
+      CellData &old_data = cells[cell];
+      CellData &new_data = cells[new_cell];
+
+      // read all values before appending, since cell and new_cell might be
+      // the same object
+      const Point<spacedim>       location           = old_data.locations[index];
+      const Point<dim>            reference_location =
+        old_data.reference_locations[index];
+      const types::particle_index id     = old_data.ids[index];
+      const PropertyPool::Handle  handle = old_data.properties[index];
+      old_data.properties[index]         = PropertyPool::invalid_handle;
+
+      new_data.locations.push_back(location);
+      new_data.reference_locations.push_back(reference_location);
+      new_data.ids.push_back(id);
+      new_data.properties.push_back(handle);
+
+      ++n_total_particles;
+      return new_data.ids.size() - 1;
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline void
+    ParticleStorage<dim, spacedim>::remove_particle(const unsigned int cell,
+                                                    const unsigned int index)
+    {
+      AssertIndexRange(cell, cells.size());
+      AssertIndexRange(index, cells[cell].ids.size());
+
+      CellData &data = cells[cell];
+      release(data.properties[index]);
+
+      data.locations.erase(data.locations.begin() + index);
+      data.reference_locations.erase(data.reference_locations.begin() + index);
+      data.ids.erase(data.ids.begin() + index);
+      data.properties.erase(data.properties.begin() + index);
+
+      --n_total_particles;
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline void
+    ParticleStorage<dim, spacedim>::remove_particles(
+      const unsigned int               cell,
+      const std::vector<unsigned int> &indices)
+    {
+      AssertIndexRange(cell, cells.size());
+      if (indices.empty())
+        return;
+
+      CellData &         data        = cells[cell];
+      const unsigned int n_particles = data.ids.size();
+
+      unsigned int next_removed = 0;
+      unsigned int n_kept       = 0;
+      for (unsigned int i = 0; i < n_particles; ++i)
+        {
+          if (next_removed < indices.size() && indices[next_removed] == i)
+            {
+              release(data.properties[i]);
+              ++next_removed;
+              Assert(next_removed == indices.size() ||
+                       indices[next_removed] > i,
+                     ExcMessage("The indices of the particles to be removed "
+                                "must be sorted and unique."));
+              continue;
+            }
+
+          if (n_kept != i)
+            {
+              data.locations[n_kept]           = data.locations[i];
+              data.reference_locations[n_kept] = data.reference_locations[i];
+              data.ids[n_kept]                 = data.ids[i];
+              data.properties[n_kept]          = data.properties[i];
+            }
+          ++n_kept;
+        }
+      Assert(next_removed == indices.size(),
+             ExcMessage("Some of the particles to be removed do not exist."));
+
+      data.locations.resize(n_kept);
+      data.reference_locations.resize(n_kept);
+      data.ids.resize(n_kept);
+      data.properties.resize(n_kept);
+
+      n_total_particles -= indices.size();
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline void
+    ParticleStorage<dim, spacedim>::write_data(const unsigned int cell,
+                                               const unsigned int index,
+                                               void *&            data) const
+    {
+      AssertIndexRange(cell, cells.size());
+      AssertIndexRange(index, cells[cell].ids.size());
+
+      const CellData &cell_data = cells[cell];
+
+      types::particle_index *id_data =
+        static_cast<types::particle_index *>(data);
+      *id_data = cell_data.ids[index];
+      ++id_data;
+      double *pdata = reinterpret_cast<double *>(id_data);
+
+      for (unsigned int i = 0; i < spacedim; ++i, ++pdata)
+        *pdata = cell_data.locations[index][i];
+
+      for (unsigned int i = 0; i < dim; ++i, ++pdata)
+        *pdata = cell_data.reference_locations[index][i];
+
+      const PropertyPool::Handle handle = cell_data.properties[index];
+      if (handle != PropertyPool::invalid_handle)
+        for (unsigned int i = 0; i < property_pool->n_properties_per_slot();
+             ++i, ++pdata)
+          *pdata = property_pool->get_property(handle, i);
+
+      data = static_cast<void *>(pdata);
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline std::size_t
+    ParticleStorage<dim, spacedim>::serialized_size_in_bytes() const
+    {
+      return sizeof(types::particle_index) + sizeof(Point<spacedim>) +
+             sizeof(Point<dim>) +
+             (property_pool != nullptr ?
+                sizeof(double) * property_pool->n_properties_per_slot() :
+                0);
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline void
+    ParticleStorage<dim, spacedim>::release(const PropertyPool::Handle handle)
+    {
+      if (handle != PropertyPool::invalid_handle)
+        property_pool->deallocate_properties_array(handle);
+    }
+  } // namespace internal
+} // namespace Particles
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2017 - 2019 by the deal.II authors
+// Copyright (C) 2017 - 2020 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -18,7 +18,11 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/aligned_vector.h>
 #include <deal.II/base/array_view.h>
+#include <deal.II/base/exceptions.h>
+
+#include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -30,12 +34,35 @@ namespace Particles
    * needs the same amount, it is more efficient to let this be handled by a
    * central manager that does not need to allocate/deallocate memory every
    * time a particle is constructed/destroyed.
-   * The current implementation uses simple new/delete allocation for every
-   * block. Additionally, the current implementation
-   * assumes the same number of properties per particle, but of course the
-   * PropertyType could contain a pointer to dynamically allocated memory
-   * with varying sizes per particle (this memory would not be managed by this
-   * class).
+   *
+   * The memory is organized in slabs, i.e., large blocks of memory that each
+   * provide room for the properties of slots_per_slab particles. Slabs are
+   * never moved or released while the pool is alive, so handles stay valid
+   * when the pool grows. Slots that are returned to the pool via
+   * deallocate_properties_array() are kept in a free list and are handed out
+   * again by the next allocation, which makes allocating and releasing
+   * property slots an O(1) operation that does not involve the system
+   * allocator in the common case. Groups of slots can be allocated and
+   * released at once with allocate_properties_arrays() and
+   * deallocate_properties_arrays().
+   *
+   * Within a slab, the properties can be arranged in two different ways,
+   * selected by the Layout argument of the constructor:
+   * - Layout::array_of_structures (the default) stores all properties of a
+   *   slot contiguously. get_properties() then returns an ArrayView to the
+   *   properties of a single particle.
+   * - Layout::structure_of_arrays stores the same property of all slots of a
+   *   slab contiguously. In this case, get_slab_column() gives access to one
+   *   property of slots_per_slab consecutive slots, which allows to process
+   *   this property with VectorizedArray in user code. Since the properties
+   *   of a single particle are no longer contiguous, get_properties() can
+   *   not be used in this case and individual properties have to be accessed
+   *   through get_property().
+   *
+   * The current implementation assumes the same number of properties per
+   * particle, but of course the PropertyType could contain a pointer to
+   * dynamically allocated memory with varying sizes per particle (this
+   * memory would not be managed by this class).
    * Because PropertyPool only returns handles it could be enhanced internally
    * (e.g. to allow for varying number of properties per handle) without
    * affecting its interface.
@@ -56,9 +83,32 @@ namespace Particles
     static const Handle invalid_handle;
 
     /**
-     * Constructor. Stores the number of properties per reserved slot.
+     * The number of slots that are stored within one slab of memory.
+     */
+    static constexpr unsigned int slots_per_slab = 1024;
+
+    /**
+     * An enum describing how the properties of the slots within one slab are
+     * arranged in memory.
      */
-    PropertyPool(const unsigned int n_properties_per_slot);
+    enum class Layout
+    {
+      /**
+       * All properties of a slot are stored next to each other.
+       */
+      array_of_structures,
+      /**
+       * Each property is stored contiguously for all slots of a slab.
+       */
+      structure_of_arrays
+    };
+
+    /**
+     * Constructor. Stores the number of properties per reserved slot and the
+     * layout in which the properties are arranged in memory.
+     */
+    PropertyPool(const unsigned int n_properties_per_slot,
+                 const Layout       layout = Layout::array_of_structures);
 
     /**
      * Return a new handle that allows accessing the reserved block
@@ -68,21 +118,66 @@ namespace Particles
     Handle
     allocate_properties_array();
 
+    /**
+     * Return @p n_slots new handles at once. If the number of properties is
+     * zero, all returned handles are invalid. This is equivalent to calling
+     * allocate_properties_array() @p n_slots times, but grows the pool at most
+     * once.
+     */
+    std::vector<Handle>
+    allocate_properties_arrays(const std::size_t n_slots);
+
     /**
      * Mark the properties corresponding to the handle @p handle as
-     * deleted. Calling this function more than once for the same
-     * handle causes undefined behavior.
+     * deleted. The slot is reused by subsequent allocations. Calling this
+     * function more than once for the same handle causes undefined behavior.
      */
     void
     deallocate_properties_array(const Handle handle);
 
+    /**
+     * Mark the properties corresponding to all handles in @p handles as
+     * deleted. Invalid handles in @p handles are ignored.
+     */
+    void
+    deallocate_properties_arrays(const ArrayView<const Handle> &handles);
+
     /**
      * Return an ArrayView to the properties that correspond to the given
      * handle @p handle.
+     *
+     * @note This function can only be called if the pool uses
+     * Layout::array_of_structures.
      */
     ArrayView<double>
     get_properties(const Handle handle);
 
+    /**
+     * Return a reference to the property with index @p component of the slot
+     * identified by @p handle. This function works for both layouts.
+     */
+    double &
+    get_property(const Handle handle, const unsigned int component);
+
+    /**
+     * Return the property with index @p component of the slot identified by
+     * @p handle. This function works for both layouts.
+     */
+    double
+    get_property(const Handle handle, const unsigned int component) const;
+
+    /**
+     * Return an ArrayView to the property with index @p component of all
+     * slots_per_slab slots of slab @p slab. The returned memory is aligned
+     * suitably for loads into VectorizedArray. Note that the view also
+     * contains unused slots whose values are unspecified.
+     *
+     * @note This function can only be called if the pool uses
+     * Layout::structure_of_arrays.
+     */
+    ArrayView<double>
+    get_slab_column(const unsigned int slab, const unsigned int component);
+
     /**
      * Reserve the dynamic memory needed for storing the properties of
      * @p size particles.
@@ -96,14 +191,86 @@ namespace Particles
     unsigned int
     n_properties_per_slot() const;
 
+    /**
+     * Return the layout of the properties within a slab.
+     */
+    Layout
+    get_layout() const;
+
+    /**
+     * Return the number of slabs currently owned by the pool.
+     */
+    unsigned int
+    n_slabs() const;
+
+    /**
+     * Return the number of slots that are currently handed out.
+     */
+    std::size_t
+    n_allocated_slots() const;
+
   private:
+    /**
+     * Allocate a new slab and put all of its slots into the free list.
+     */
+    void
+    add_slab();
+
     /**
      * The number of properties that are reserved per particle.
      */
     const unsigned int n_properties;
+
+    /**
+     * The layout of the properties within a slab.
+     */
+    const Layout layout;
+
+    /**
+     * The memory blocks that store the properties. Each slab provides room
+     * for slots_per_slab slots.
+     */
+    std::vector<AlignedVector<double>> slabs;
+
+    /**
+     * Handles of all slots that are currently unused. Slots are taken from
+     * the back.
+     */
+    std::vector<Handle> free_slots;
   };
 
 
+
+  /* ---------------------- inline functions ---------------------- */
+
+
+
+  inline double &
+  PropertyPool::get_property(const Handle handle, const unsigned int component)
+  {
+    Assert(handle != invalid_handle, ExcInternalError());
+    AssertIndexRange(component, n_properties);
+
+    return (layout == Layout::array_of_structures) ?
+             handle[component] :
+             handle[component * slots_per_slab];
+  }
+
+
+
+  inline double
+  PropertyPool::get_property(const Handle       handle,
+                             const unsigned int component) const
+  {
+    Assert(handle != invalid_handle, ExcInternalError());
+    AssertIndexRange(component, n_properties);
+
+    return (layout == Layout::array_of_structures) ?
+             handle[component] :
+             handle[component * slots_per_slab];
+  }
+
+
 } // namespace Particles
 
 DEAL_II_NAMESPACE_CLOSE
@@ -34,6 +34,7 @@
 #include <deal.II/base/data_out_base.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/mpi.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/parameter_handler.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/utilities.h>
@@ -47,6 +48,7 @@
 #include <fstream>
 #include <iomanip>
 #include <memory>
+#include <numeric>
 #include <set>
 #include <sstream>
 
@@ -103,9 +105,23 @@ namespace
       }
   }
 
+  /**
+   * The size in bytes of the blocks into which data arrays are split before
+   * compression. The blocks are compressed independently of each other and
+   * in parallel.
+   */
+  constexpr std::size_t compression_block_size = std::size_t(1) << 20;
+
   /**
    * Do a zlib compression followed by a base64 encoding of the given data. The
    * result is then written to the given stream.
+   *
+   * Following the format VTK uses for compressed data, the data is split into
+   * blocks of size compression_block_size (the last block possibly being
+   * smaller), which are compressed independently. The header lists the
+   * number of blocks, the uncompressed sizes of the first and the last block,
+   * and the compressed size of each block. Data smaller than one block
+   * results in a single block, as without the splitting.
    */
   template <typename T>
   void
@@ -115,37 +131,99 @@ namespace
   {
     if (data.size() != 0)
       {
-        // allocate a buffer for compressing data and do so
-        auto compressed_data_length = compressBound(data.size() * sizeof(T));
-        std::vector<unsigned char> compressed_data(compressed_data_length);
-
-        int err =
-          compress2(&compressed_data[0],
-                    &compressed_data_length,
-                    reinterpret_cast<const Bytef *>(data.data()),
-                    data.size() * sizeof(T),
-                    get_zlib_compression_level(flags.compression_level));
-        (void)err;
-        Assert(err == Z_OK, ExcInternalError());
-
-        // Discard the unnecessary bytes
-        compressed_data.resize(compressed_data_length);
+        const std::size_t n_bytes = data.size() * sizeof(T);
+        const std::size_t n_blocks =
+          (n_bytes + compression_block_size - 1) / compression_block_size;
+        const std::size_t block_size =
+          std::min(n_bytes, compression_block_size);
+        const std::size_t last_block_size =
+          n_bytes - (n_blocks - 1) * compression_block_size;
+
+        // compress the blocks in parallel, into a buffer each
+        std::vector<std::vector<unsigned char>> compressed_blocks(n_blocks);
+        parallel::apply_to_subranges(
+          std::size_t(0),
+          n_blocks,
+          [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t block = begin; block < end; ++block)
+              {
+                const std::size_t size =
+                  (block + 1 == n_blocks) ? last_block_size : block_size;
+                auto compressed_data_length = compressBound(size);
+                compressed_blocks[block].resize(compressed_data_length);
+
+                int err = compress2(
+                  compressed_blocks[block].data(),
+                  &compressed_data_length,
+                  reinterpret_cast<const Bytef *>(data.data()) +
+                    block * compression_block_size,
+                  size,
+                  get_zlib_compression_level(flags.compression_level));
+                (void)err;
+                Assert(err == Z_OK, ExcInternalError());
+
+                // Discard the unnecessary bytes
+                compressed_blocks[block].resize(compressed_data_length);
+              }
+          },
+          1);
 
         // now encode the compression header
-        const uint32_t compression_header[4] = {
-          1,                                              /* number of blocks */
-          static_cast<uint32_t>(data.size() * sizeof(T)), /* size of block */
-          static_cast<uint32_t>(data.size() *
-                                sizeof(T)), /* size of last block */
-          static_cast<uint32_t>(
-            compressed_data_length)}; /* list of compressed sizes of blocks */
+        std::vector<uint32_t> compression_header(3 + n_blocks);
+        compression_header[0] = n_blocks;        /* number of blocks */
+        compression_header[1] = block_size;      /* size of block */
+        compression_header[2] = last_block_size; /* size of last block */
+        for (std::size_t block = 0; block < n_blocks; ++block)
+          compression_header[3 + block] =
+            compressed_blocks[block].size(); /* compressed sizes of blocks */
 
         const auto header_start =
-          reinterpret_cast<const unsigned char *>(&compression_header[0]);
-
+          reinterpret_cast<const unsigned char *>(compression_header.data());
         output_stream << Utilities::encode_base64(
-                           {header_start, header_start + 4 * sizeof(uint32_t)})
-                      << Utilities::encode_base64(compressed_data);
+          {header_start,
+           header_start + compression_header.size() * sizeof(uint32_t)});
+
+        // the compressed data of all blocks is encoded as one piece
+        if (n_blocks == 1)
+          output_stream << Utilities::encode_base64(compressed_blocks[0]);
+        else
+          {
+            std::vector<unsigned char> compressed_data;
+            compressed_data.reserve(
+              std::accumulate(compression_header.begin() + 3,
+                              compression_header.end(),
+                              std::size_t(0)));
+            for (const auto &block : compressed_blocks)
+              compressed_data.insert(compressed_data.end(),
+                                     block.begin(),
+                                     block.end());
+            output_stream << Utilities::encode_base64(compressed_data);
+          }
+      }
+  }
+#endif
+
+#ifdef DEAL_II_WITH_HDF5
+  /**
+   * Convert between the enum specified inside Hdf5Flags and the level of the
+   * deflate filter of HDF5.
+   */
+  unsigned int
+  get_hdf5_deflate_level(const DataOutBase::Hdf5Flags::CompressionLevel level)
+  {
+    switch (level)
+      {
+        case (DataOutBase::Hdf5Flags::no_compression):
+          return 0;
+        case (DataOutBase::Hdf5Flags::best_speed):
+          return 1;
+        case (DataOutBase::Hdf5Flags::best_compression):
+          return 9;
+        case (DataOutBase::Hdf5Flags::default_compression):
+          return 6;
+        default:
+          Assert(false, ExcNotImplemented());
+          return 0;
       }
   }
 #endif
@@ -2265,6 +2343,14 @@ namespace DataOutBase
 
 
 
+  Hdf5Flags::Hdf5Flags(const Hdf5Flags::CompressionLevel compression_level,
+                       const unsigned int                chunk_size)
+    : compression_level(compression_level)
+    , chunk_size(chunk_size)
+  {}
+
+
+
   OutputFormat
   parse_output_format(const std::string &format_name)
   {
@@ -7368,7 +7454,8 @@ DataOutInterface<dim, spacedim>::write_hdf5_parallel(
   const std::string &               filename,
   MPI_Comm                          comm) const
 {
-  DataOutBase::write_hdf5_parallel(get_patches(), data_filter, filename, comm);
+  DataOutBase::write_hdf5_parallel(
+    get_patches(), data_filter, true, filename, filename, comm, hdf5_flags);
 }
 
 
@@ -7387,7 +7474,8 @@ DataOutInterface<dim, spacedim>::write_hdf5_parallel(
                                    write_mesh_file,
                                    mesh_filename,
                                    solution_filename,
-                                   comm);
+                                   comm,
+                                   hdf5_flags);
 }
 
 
@@ -7413,7 +7501,8 @@ DataOutBase::write_hdf5_parallel(
   const bool                        write_mesh_file,
   const std::string &               mesh_filename,
   const std::string &               solution_filename,
-  MPI_Comm                          comm)
+  MPI_Comm                          comm,
+  const DataOutBase::Hdf5Flags &    flags)
 {
   AssertThrow(
     spacedim >= 2,
@@ -7431,6 +7520,7 @@ DataOutBase::write_hdf5_parallel(
   (void)mesh_filename;
   (void)solution_filename;
   (void)comm;
+  (void)flags;
   AssertThrow(false, ExcMessage("HDF5 support is disabled."));
 #else
 #  ifndef DEAL_II_WITH_MPI
@@ -7510,6 +7600,48 @@ DataOutBase::write_hdf5_parallel(
   global_node_cell_offsets[0] = global_node_cell_offsets[1] = 0;
 #  endif
 
+  // Compressed datasets can only be written in parallel by recent versions
+  // of HDF5
+#  ifdef H5_HAVE_PARALLEL
+#    if !H5_VERSION_GE(1, 10, 2)
+  AssertThrow(flags.compression_level == DataOutBase::Hdf5Flags::no_compression,
+              ExcMessage("Writing compressed HDF5 files in parallel requires "
+                         "HDF5 version 1.10.2 or newer."));
+#    endif
+#  endif
+
+  // Create the property list for a dataset with the given number of rows and
+  // columns: datasets are stored in chunks if requested by the flags or if
+  // they are compressed, since HDF5 can only compress chunked datasets. Since
+  // datasets are created collectively, the numbers of rows and columns are
+  // global ones, and therefore all processes create the same property list.
+  const auto create_dataset_plist = [&flags](const hsize_t n_rows,
+                                             const hsize_t n_columns) {
+    const hid_t dataset_plist_id = H5Pcreate(H5P_DATASET_CREATE);
+    AssertThrow(dataset_plist_id >= 0, ExcIO());
+
+    const bool compress =
+      (flags.compression_level != DataOutBase::Hdf5Flags::no_compression);
+    if ((flags.chunk_size > 0 || compress) && n_rows > 0)
+      {
+        const hsize_t chunk_dims[2] = {
+          std::min<hsize_t>(n_rows,
+                            (flags.chunk_size > 0 ? flags.chunk_size : 65536)),
+          n_columns};
+        herr_t status = H5Pset_chunk(dataset_plist_id, 2, chunk_dims);
+        AssertThrow(status >= 0, ExcIO());
+
+        if (compress)
+          {
+            status = H5Pset_deflate(dataset_plist_id,
+                                    get_hdf5_deflate_level(
+                                      flags.compression_level));
+            AssertThrow(status >= 0, ExcIO());
+          }
+      }
+    return dataset_plist_id;
+  };
+
   // Create the property list for a collective write
   plist_id = H5Pcreate(H5P_DATASET_XFER);
   AssertThrow(plist_id >= 0, ExcIO());
@@ -7542,36 +7674,48 @@ DataOutBase::write_hdf5_parallel(
       AssertThrow(cell_dataspace >= 0, ExcIO());
 
       // Create the dataset for the nodes and cells
+      const hid_t node_dataset_plist_id =
+        create_dataset_plist(node_ds_dim[0], node_ds_dim[1]);
+      const hid_t cell_dataset_plist_id =
+        create_dataset_plist(cell_ds_dim[0], cell_ds_dim[1]);
 #  if H5Gcreate_vers == 1
       node_dataset = H5Dcreate(h5_mesh_file_id,
                                "nodes",
                                H5T_NATIVE_DOUBLE,
                                node_dataspace,
-                               H5P_DEFAULT);
+                               node_dataset_plist_id);
 #  else
       node_dataset = H5Dcreate(h5_mesh_file_id,
                                "nodes",
                                H5T_NATIVE_DOUBLE,
                                node_dataspace,
                                H5P_DEFAULT,
-                               H5P_DEFAULT,
+                               node_dataset_plist_id,
                                H5P_DEFAULT);
 #  endif
       AssertThrow(node_dataset >= 0, ExcIO());
 #  if H5Gcreate_vers == 1
-      cell_dataset = H5Dcreate(
-        h5_mesh_file_id, "cells", H5T_NATIVE_UINT, cell_dataspace, H5P_DEFAULT);
+      cell_dataset = H5Dcreate(h5_mesh_file_id,
+                               "cells",
+                               H5T_NATIVE_UINT,
+                               cell_dataspace,
+                               cell_dataset_plist_id);
 #  else
       cell_dataset = H5Dcreate(h5_mesh_file_id,
                                "cells",
                                H5T_NATIVE_UINT,
                                cell_dataspace,
                                H5P_DEFAULT,
-                               H5P_DEFAULT,
+                               cell_dataset_plist_id,
                                H5P_DEFAULT);
 #  endif
       AssertThrow(cell_dataset >= 0, ExcIO());
 
+      status = H5Pclose(node_dataset_plist_id);
+      AssertThrow(status >= 0, ExcIO());
+      status = H5Pclose(cell_dataset_plist_id);
+      AssertThrow(status >= 0, ExcIO());
+
       // Close the node and cell dataspaces since we're done with them
       status = H5Sclose(node_dataspace);
       AssertThrow(status >= 0, ExcIO());
@@ -7690,22 +7834,26 @@ DataOutBase::write_hdf5_parallel(
       pt_data_dataspace = H5Screate_simple(2, node_ds_dim, nullptr);
       AssertThrow(pt_data_dataspace >= 0, ExcIO());
 
+      const hid_t pt_data_dataset_plist_id =
+        create_dataset_plist(node_ds_dim[0], node_ds_dim[1]);
 #  if H5Gcreate_vers == 1
       pt_data_dataset = H5Dcreate(h5_solution_file_id,
                                   vector_name.c_str(),
                                   H5T_NATIVE_DOUBLE,
                                   pt_data_dataspace,
-                                  H5P_DEFAULT);
+                                  pt_data_dataset_plist_id);
 #  else
       pt_data_dataset = H5Dcreate(h5_solution_file_id,
                                   vector_name.c_str(),
                                   H5T_NATIVE_DOUBLE,
                                   pt_data_dataspace,
                                   H5P_DEFAULT,
-                                  H5P_DEFAULT,
+                                  pt_data_dataset_plist_id,
                                   H5P_DEFAULT);
 #  endif
       AssertThrow(pt_data_dataset >= 0, ExcIO());
+      status = H5Pclose(pt_data_dataset_plist_id);
+      AssertThrow(status >= 0, ExcIO());
 
       // Create the data subset we'll use to read from memory
       count[0] = local_node_cell_count[0];
@@ -7763,6 +7911,205 @@ DataOutBase::write_hdf5_parallel(
 
 
 
+namespace DataOutBase
+{
+  template <int dim, int spacedim>
+  AsynchronousHDF5Writer<dim, spacedim>::AsynchronousHDF5Writer(
+    const MPI_Comm &   comm,
+    const unsigned int max_pending_snapshots,
+    const Hdf5Flags &  flags)
+    : communicator(comm)
+    , max_pending_snapshots(max_pending_snapshots)
+    , flags(flags)
+    , asynchronous(true)
+    , stop_writing(false)
+  {
+    Assert(max_pending_snapshots > 0,
+           ExcMessage("At least one snapshot must be allowed to be pending."));
+
+    // the background thread can only communicate if MPI allows calls from
+    // several threads at the same time, since other threads of the program
+    // may communicate concurrently. This also holds for a single process,
+    // since the parallel HDF5 functions call MPI in any case
+#ifdef DEAL_II_WITH_MPI
+    if (Utilities::MPI::job_supports_mpi())
+      {
+        int       provided = MPI_THREAD_SINGLE;
+        const int ierr     = MPI_Query_thread(&provided);
+        AssertThrowMPI(ierr);
+        asynchronous = (provided == MPI_THREAD_MULTIPLE);
+      }
+#endif
+
+    if (asynchronous)
+      writer_thread = std::thread([this]() { this->run(); });
+  }
+
+
+
+  template <int dim, int spacedim>
+  AsynchronousHDF5Writer<dim, spacedim>::~AsynchronousHDF5Writer()
+  {
+    if (writer_thread.joinable())
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stop_writing = true;
+        }
+        queue_changed.notify_all();
+        writer_thread.join();
+      }
+  }
+
+
+
+  template <int dim, int spacedim>
+  std::future<void>
+  AsynchronousHDF5Writer<dim, spacedim>::write(
+    DataOutFilter &&   data_filter,
+    const bool         write_mesh_file,
+    const std::string &mesh_filename,
+    const std::string &solution_filename)
+  {
+    Snapshot snapshot;
+    snapshot.data_filter       = std::move(data_filter);
+    snapshot.write_mesh_file   = write_mesh_file;
+    snapshot.mesh_filename     = mesh_filename;
+    snapshot.solution_filename = solution_filename;
+    std::future<void> future   = snapshot.promise.get_future();
+
+    if (asynchronous == false)
+      {
+        const std::exception_ptr exception = write_snapshot(snapshot);
+        if (exception)
+          snapshot.promise.set_exception(exception);
+        else
+          snapshot.promise.set_value();
+        return future;
+      }
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      queue_changed.wait(lock, [this]() {
+        return pending_snapshots.size() < max_pending_snapshots;
+      });
+      pending_snapshots.emplace_back(std::move(snapshot));
+    }
+    queue_changed.notify_all();
+
+    return future;
+  }
+
+
+
+  template <int dim, int spacedim>
+  std::future<void>
+  AsynchronousHDF5Writer<dim, spacedim>::write(DataOutFilter &&   data_filter,
+                                               const std::string &filename)
+  {
+    return write(std::move(data_filter), true, filename, filename);
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  AsynchronousHDF5Writer<dim, spacedim>::wait() const
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    queue_changed.wait(lock, [this]() { return pending_snapshots.empty(); });
+  }
+
+
+
+  template <int dim, int spacedim>
+  unsigned int
+  AsynchronousHDF5Writer<dim, spacedim>::n_pending_snapshots() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending_snapshots.size();
+  }
+
+
+
+  template <int dim, int spacedim>
+  bool
+  AsynchronousHDF5Writer<dim, spacedim>::writes_asynchronously() const
+  {
+    return asynchronous;
+  }
+
+
+
+  template <int dim, int spacedim>
+  std::exception_ptr
+  AsynchronousHDF5Writer<dim, spacedim>::write_snapshot(
+    const Snapshot &snapshot) const
+  {
+    try
+      {
+        write_hdf5_parallel(std::vector<Patch<dim, spacedim>>(),
+                            snapshot.data_filter,
+                            snapshot.write_mesh_file,
+                            snapshot.mesh_filename,
+                            snapshot.solution_filename,
+                            *communicator,
+                            flags);
+      }
+    catch (...)
+      {
+        return std::current_exception();
+      }
+    return nullptr;
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  AsynchronousHDF5Writer<dim, spacedim>::run()
+  {
+    while (true)
+      {
+        Snapshot *snapshot = nullptr;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          queue_changed.wait(lock, [this]() {
+            return stop_writing || !pending_snapshots.empty();
+          });
+          if (pending_snapshots.empty())
+            return;
+
+          // elements of a std::deque do not move when other elements are
+          // added at the end, so we can keep a pointer to the first element
+          // while write() adds more snapshots
+          snapshot = &pending_snapshots.front();
+        }
+
+        const std::exception_ptr exception = write_snapshot(*snapshot);
+
+        // only now remove the snapshot from the queue, so that its memory
+        // counts towards the limit of pending snapshots until it has been
+        // written. the promise is fulfilled last, so that the snapshot is no
+        // longer counted as pending once the future becomes ready
+        std::promise<void> promise;
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          promise = std::move(pending_snapshots.front().promise);
+          pending_snapshots.pop_front();
+        }
+        queue_changed.notify_all();
+
+        if (exception)
+          promise.set_exception(exception);
+        else
+          promise.set_value();
+      }
+  }
+} // namespace DataOutBase
+
+
+
 template <int dim, int spacedim>
 void
 DataOutInterface<dim, spacedim>::write(
@@ -7872,6 +8219,8 @@ DataOutInterface<dim, spacedim>::set_flags(const FlagType &flags)
   else if (typeid(flags) == typeid(deal_II_intermediate_flags))
     deal_II_intermediate_flags =
       *reinterpret_cast<const DataOutBase::Deal_II_IntermediateFlags *>(&flags);
+  else if (typeid(flags) == typeid(hdf5_flags))
+    hdf5_flags = *reinterpret_cast<const DataOutBase::Hdf5Flags *>(&flags);
   else
     Assert(false, ExcNotImplemented());
 }
@@ -8005,7 +8354,8 @@ DataOutInterface<dim, spacedim>::memory_consumption() const
           MemoryConsumption::memory_consumption(tecplot_flags) +
           MemoryConsumption::memory_consumption(vtk_flags) +
           MemoryConsumption::memory_consumption(svg_flags) +
-          MemoryConsumption::memory_consumption(deal_II_intermediate_flags));
+          MemoryConsumption::memory_consumption(deal_II_intermediate_flags) +
+          MemoryConsumption::memory_consumption(hdf5_flags));
 }
 
 
@@ -0,0 +1,271 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/hardware_counters.h>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#ifdef DEAL_II_HAVE_LINUX_PERF_EVENT_H
+#  include <linux/perf_event.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#  include <cpuid.h>
+#endif
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace
+{
+#ifdef DEAL_II_HAVE_LINUX_PERF_EVENT_H
+  /**
+   * A counter of the kernel from which (together with other counters) an
+   * event is computed.
+   */
+  struct KernelCounter
+  {
+    std::uint32_t type;
+    std::uint64_t config;
+    double        weight;
+  };
+
+
+
+  /**
+   * Return whether the processor is made by Intel, whose raw event codes
+   * are used for the floating point operations.
+   */
+  bool
+  is_intel_processor()
+  {
+#  if defined(__x86_64__) && defined(__GNUC__)
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0, &eax, &ebx, &ecx, &edx) == 0)
+      return false;
+    char vendor[12];
+    std::memcpy(vendor, &ebx, 4);
+    std::memcpy(vendor + 4, &edx, 4);
+    std::memcpy(vendor + 8, &ecx, 4);
+    return std::memcmp(vendor, "GenuineIntel", 12) == 0;
+#  else
+    return false;
+#  endif
+  }
+
+
+
+  /**
+   * Return the kernel counters from which the given event is computed, or
+   * an empty vector if the event can not be counted on this processor.
+   */
+  std::vector<KernelCounter>
+  get_kernel_counters(const HardwareCounters::Event event)
+  {
+    const auto cache_event = [](const std::uint64_t result) {
+      return (PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+              (result << 16));
+    };
+
+    // the event FP_ARITH_INST_RETIRED (0xc7) with the umasks for scalar,
+    // 128 bit, 256 bit, and 512 bit instructions, weighted by the number of
+    // lanes; fused multiply-adds are counted twice by the processor
+    const auto fp_arith_event = [](const std::uint64_t umask) {
+      return (umask << 8) | 0xc7;
+    };
+
+    switch (event)
+      {
+        case HardwareCounters::cycles:
+          return {{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 1.}};
+        case HardwareCounters::instructions:
+          return {{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 1.}};
+        case HardwareCounters::cache_references:
+          return {{PERF_TYPE_HW_CACHE,
+                   cache_event(PERF_COUNT_HW_CACHE_RESULT_ACCESS),
+                   1.}};
+        case HardwareCounters::cache_misses:
+          return {{PERF_TYPE_HW_CACHE,
+                   cache_event(PERF_COUNT_HW_CACHE_RESULT_MISS),
+                   1.}};
+        case HardwareCounters::branch_instructions:
+          return {{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS, 1.}};
+        case HardwareCounters::branch_misses:
+          return {{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, 1.}};
+        case HardwareCounters::double_precision_flops:
+          if (is_intel_processor() == false)
+            return {};
+          return {{PERF_TYPE_RAW, fp_arith_event(0x01), 1.},
+                  {PERF_TYPE_RAW, fp_arith_event(0x04), 2.},
+                  {PERF_TYPE_RAW, fp_arith_event(0x10), 4.},
+                  {PERF_TYPE_RAW, fp_arith_event(0x40), 8.}};
+        case HardwareCounters::single_precision_flops:
+          if (is_intel_processor() == false)
+            return {};
+          return {{PERF_TYPE_RAW, fp_arith_event(0x02), 1.},
+                  {PERF_TYPE_RAW, fp_arith_event(0x08), 4.},
+                  {PERF_TYPE_RAW, fp_arith_event(0x20), 8.},
+                  {PERF_TYPE_RAW, fp_arith_event(0x80), 16.}};
+        default:
+          Assert(false, ExcNotImplemented());
+          return {};
+      }
+  }
+
+
+
+  /**
+   * Open a counter for the calling thread, as a member of the group with
+   * the given leader or as a new group if @p group_leader is -1. Return the
+   * file descriptor, or -1 if the counter can not be opened.
+   */
+  int
+  open_kernel_counter(const KernelCounter &counter, const int group_leader)
+  {
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size           = sizeof(attributes);
+    attributes.type           = counter.type;
+    attributes.config         = counter.config;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv     = 1;
+    attributes.read_format    = PERF_FORMAT_GROUP |
+                             PERF_FORMAT_TOTAL_TIME_ENABLED |
+                             PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // count the calling thread on whatever CPU it runs
+    const long fd = syscall(
+      __NR_perf_event_open, &attributes, 0, -1, group_leader, 0UL);
+    return (fd < 0 ? -1 : static_cast<int>(fd));
+  }
+#endif
+} // namespace
+
+
+
+std::string
+HardwareCounters::get_name(const Event event)
+{
+  switch (event)
+    {
+      case cycles:
+        return "cycles";
+      case instructions:
+        return "instructions";
+      case cache_references:
+        return "LLC accesses";
+      case cache_misses:
+        return "LLC misses";
+      case branch_instructions:
+        return "branches";
+      case branch_misses:
+        return "branch misses";
+      case double_precision_flops:
+        return "DP FLOP";
+      case single_precision_flops:
+        return "SP FLOP";
+      default:
+        Assert(false, ExcNotImplemented());
+        return "";
+    }
+}
+
+
+
+HardwareCounters::HardwareCounters(const std::vector<Event> &events)
+  : events(events)
+  , group_leaders(events.size(), -1)
+  , group_members(events.size())
+{
+#ifdef DEAL_II_HAVE_LINUX_PERF_EVENT_H
+  // every event gets a group of its own: the counters of a group are
+  // always scheduled together, which we need for the events that are
+  // computed from several counters, but the processor might not be able to
+  // count all events at the same time
+  for (unsigned int e = 0; e < events.size(); ++e)
+    {
+      for (const KernelCounter &counter : get_kernel_counters(events[e]))
+        {
+          const int fd = open_kernel_counter(counter, group_leaders[e]);
+          if (fd < 0)
+            {
+              for (const auto &member : group_members[e])
+                close(member.first);
+              group_members[e].clear();
+              group_leaders[e] = -1;
+              break;
+            }
+          if (group_leaders[e] < 0)
+            group_leaders[e] = fd;
+          group_members[e].emplace_back(fd, counter.weight);
+        }
+    }
+#endif
+}
+
+
+
+HardwareCounters::~HardwareCounters()
+{
+#ifdef DEAL_II_HAVE_LINUX_PERF_EVENT_H
+  for (const auto &members : group_members)
+    for (const auto &member : members)
+      close(member.first);
+#endif
+}
+
+
+
+void
+HardwareCounters::read(std::vector<double> &values) const
+{
+  values.resize(events.size());
+  for (unsigned int e = 0; e < events.size(); ++e)
+    {
+      values[e] = std::numeric_limits<double>::quiet_NaN();
+#ifdef DEAL_II_HAVE_LINUX_PERF_EVENT_H
+      if (group_leaders[e] < 0)
+        continue;
+
+      // the layout of the data read from a group: the number of counters,
+      // the times the group was enabled and running, and one value per
+      // counter
+      std::uint64_t data[3 + 4];
+      Assert(group_members[e].size() <= 4, ExcInternalError());
+      const std::size_t n_bytes =
+        (3 + group_members[e].size()) * sizeof(std::uint64_t);
+      if (::read(group_leaders[e], data, n_bytes) !=
+          static_cast<ssize_t>(n_bytes))
+        continue;
+
+      double value = 0.;
+      for (unsigned int m = 0; m < group_members[e].size(); ++m)
+        value += group_members[e][m].second * data[3 + m];
+
+      // extrapolate if the kernel had to multiplex the counters
+      const std::uint64_t time_enabled = data[1], time_running = data[2];
+      if (time_running == 0)
+        value = 0.;
+      else if (time_running < time_enabled)
+        value *= static_cast<double>(time_enabled) / time_running;
+      values[e] = value;
+#endif
+    }
+}
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,841 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/instrumentation.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/mpi.templates.h>
+
+#include <boost/io/ios_state.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace internal
+{
+  namespace Instrumentation
+  {
+    using dealii::Instrumentation::Clock;
+    using dealii::Instrumentation::n_histogram_bins;
+
+    std::atomic<bool> enabled(false);
+
+    /**
+     * One node in the hierarchy of regions recorded by a thread, i.e., one
+     * region together with the path of regions within which it was entered.
+     */
+    struct Node
+    {
+      Node(const unsigned int region, const unsigned int parent)
+        : region(region)
+        , parent(parent)
+        , n_calls(0)
+        , total_time(0.)
+        , min_call_time(std::numeric_limits<double>::max())
+        , max_call_time(0.)
+        , histogram{}
+      {}
+
+      /**
+       * The index of the region, or numbers::invalid_unsigned_int for the
+       * root of the hierarchy.
+       */
+      unsigned int region;
+
+      /**
+       * The index of the parent node.
+       */
+      unsigned int parent;
+
+      /**
+       * The indices of the child nodes.
+       */
+      std::vector<unsigned int> children;
+
+      unsigned long long int                               n_calls;
+      double                                               total_time;
+      double                                               min_call_time;
+      double                                               max_call_time;
+      std::array<unsigned long long int, n_histogram_bins> histogram;
+
+      /**
+       * The accumulated values of the hardware counters, or an empty vector
+       * if they have not been recorded.
+       */
+      std::vector<double> hardware_counters;
+
+      /**
+       * The values of the hardware counters when the region was entered,
+       * or an empty vector if they are not recorded for the current call.
+       * Since a node can only be active once at a time on its thread, we can
+       * store them here rather than on a stack.
+       */
+      std::vector<double> hardware_counters_at_entry;
+    };
+
+
+
+    /**
+     * One recorded call of a region, as written into a trace.
+     */
+    struct TraceEvent
+    {
+      unsigned int      region;
+      Clock::time_point start_time;
+      Clock::time_point end_time;
+    };
+
+
+
+    /**
+     * The data recorded by one thread. Only the owning thread writes into
+     * an object of this type.
+     */
+    struct ThreadData
+    {
+      explicit ThreadData(const unsigned int thread_index)
+        : thread_index(thread_index)
+        , current_node(0)
+        , counter_configuration(0)
+      {
+        nodes.emplace_back(numbers::invalid_unsigned_int,
+                           numbers::invalid_unsigned_int);
+      }
+
+      /**
+       * The number of the thread in the order in which the threads were
+       * registered.
+       */
+      const unsigned int thread_index;
+
+      /**
+       * The hierarchy of regions. The first entry is the root, and each node
+       * is stored after its parent.
+       */
+      std::vector<Node> nodes;
+
+      /**
+       * The node of the innermost region the thread is currently in.
+       */
+      unsigned int current_node;
+
+      /**
+       * The calls recorded while tracing was enabled.
+       */
+      std::vector<TraceEvent> events;
+
+      /**
+       * The hardware counters of the thread, which are opened by the thread
+       * itself on the first call of enter_region() after
+       * enable_hardware_counters().
+       */
+      std::unique_ptr<HardwareCounters> counters;
+
+      /**
+       * The value of the global variable counter_configuration at the time
+       * @p counters were opened.
+       */
+      unsigned int counter_configuration;
+
+      /**
+       * Scratch space for reading the counters.
+       */
+      std::vector<double> counter_values;
+    };
+
+
+
+    namespace
+    {
+      /**
+       * Whether every single call is recorded as an event.
+       */
+      std::atomic<bool> record_trace(false);
+
+      /**
+       * Whether hardware counters are recorded.
+       */
+      std::atomic<bool> record_counters(false);
+
+      /**
+       * A number that is incremented with every call of
+       * enable_hardware_counters(), which tells the threads to open the
+       * requested counters.
+       */
+      std::atomic<unsigned int> counter_configuration(0);
+
+      /**
+       * The global data shared by all threads. All members are protected by
+       * the mutex, except for the objects pointed to by the elements of
+       * @p threads, which are written by their threads without a lock.
+       */
+      struct Registry
+      {
+        std::mutex                               mutex;
+        std::map<std::string, unsigned int>      region_indices;
+        std::vector<std::string>                 region_names;
+        std::vector<std::unique_ptr<ThreadData>> threads;
+        std::vector<HardwareCounters::Event>     counter_events;
+        Clock::time_point                        epoch;
+        bool                                     epoch_is_set = false;
+      };
+
+      Registry &
+      get_registry()
+      {
+        static Registry registry;
+        return registry;
+      }
+
+      /**
+       * The data of the current thread, or a null pointer if the thread has
+       * not entered any region yet. The object itself is owned by the
+       * registry, so that the data remains available after the thread has
+       * ended.
+       */
+      thread_local ThreadData *this_thread_data = nullptr;
+
+
+
+      /**
+       * Return the bin of the histogram a call of the given duration (in
+       * seconds) belongs to.
+       */
+      unsigned int
+      histogram_bin(const double duration)
+      {
+        const double microseconds = duration * 1e6;
+        if (microseconds < 1.)
+          return 0;
+        return std::min(n_histogram_bins - 1,
+                        1 + static_cast<unsigned int>(std::log2(microseconds)));
+      }
+
+
+
+      /**
+       * Return the given string in a form that can be used as a string in a
+       * JSON file.
+       */
+      std::string
+      escape_json(const std::string &text)
+      {
+        std::string result;
+        for (const char c : text)
+          if (c == '"' || c == '\\')
+            {
+              result += '\\';
+              result += c;
+            }
+          else if (static_cast<unsigned char>(c) < 0x20)
+            result += ' ';
+          else
+            result += c;
+        return result;
+      }
+
+
+
+      /**
+       * Format a time given in microseconds for the labels of the
+       * histogram bins.
+       */
+      std::string
+      format_microseconds(const double microseconds)
+      {
+        std::ostringstream out;
+        out << std::setprecision(3);
+        if (microseconds < 1e3)
+          out << microseconds << "us";
+        else if (microseconds < 1e6)
+          out << microseconds * 1e-3 << "ms";
+        else
+          out << microseconds * 1e-6 << "s";
+        return out.str();
+      }
+
+
+
+      /**
+       * The statistics of one region recorded on the current process,
+       * accumulated over all threads.
+       */
+      struct LocalStatistics
+      {
+        unsigned long long int n_calls    = 0;
+        double                 total_time = 0.;
+        double min_call_time = std::numeric_limits<double>::max();
+        double max_call_time = 0.;
+        std::array<unsigned long long int, n_histogram_bins> histogram{};
+        std::vector<double> hardware_counters;
+      };
+
+
+
+      /**
+       * Merge the hierarchies of regions of all threads of the current
+       * process into one map from paths of region names to statistics.
+       */
+      std::map<std::vector<std::string>, LocalStatistics>
+      collect_local_statistics()
+      {
+        Registry &                  registry = get_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        std::map<std::vector<std::string>, LocalStatistics> statistics;
+        for (const auto &thread : registry.threads)
+          {
+            // since parents are stored before their children, we can build
+            // up the paths of all nodes in one sweep
+            std::vector<std::vector<std::string>> paths(thread->nodes.size());
+            for (unsigned int n = 1; n < thread->nodes.size(); ++n)
+              {
+                const Node &node = thread->nodes[n];
+                paths[n]         = paths[node.parent];
+                paths[n].push_back(registry.region_names[node.region]);
+
+                LocalStatistics &entry = statistics[paths[n]];
+                entry.n_calls += node.n_calls;
+                entry.total_time += node.total_time;
+                entry.min_call_time =
+                  std::min(entry.min_call_time, node.min_call_time);
+                entry.max_call_time =
+                  std::max(entry.max_call_time, node.max_call_time);
+                for (unsigned int b = 0; b < n_histogram_bins; ++b)
+                  entry.histogram[b] += node.histogram[b];
+
+                entry.hardware_counters.resize(registry.counter_events.size(),
+                                               0.);
+                if (node.hardware_counters.size() ==
+                    entry.hardware_counters.size())
+                  for (unsigned int e = 0; e < node.hardware_counters.size();
+                       ++e)
+                    entry.hardware_counters[e] += node.hardware_counters[e];
+              }
+          }
+        return statistics;
+      }
+    } // namespace
+
+
+
+    ThreadData *
+    enter_region(const unsigned int region_index, unsigned int &parent_node)
+    {
+      if (this_thread_data == nullptr)
+        {
+          Registry &                  registry = get_registry();
+          std::lock_guard<std::mutex> lock(registry.mutex);
+          registry.threads.emplace_back(
+            std::make_unique<ThreadData>(registry.threads.size()));
+          this_thread_data = registry.threads.back().get();
+        }
+
+      ThreadData &data = *this_thread_data;
+      parent_node      = data.current_node;
+      AssertIndexRange(parent_node, data.nodes.size());
+
+      unsigned int child = numbers::invalid_unsigned_int;
+      for (const unsigned int c : data.nodes[parent_node].children)
+        if (data.nodes[c].region == region_index)
+          {
+            child = c;
+            break;
+          }
+      if (child == numbers::invalid_unsigned_int)
+        {
+          child = data.nodes.size();
+          data.nodes.emplace_back(region_index, parent_node);
+          data.nodes[parent_node].children.push_back(child);
+        }
+
+      data.current_node = child;
+
+      if (record_counters.load(std::memory_order_relaxed))
+        {
+          const unsigned int configuration = counter_configuration.load();
+          if (data.counter_configuration != configuration)
+            {
+              Registry &                  registry = get_registry();
+              std::lock_guard<std::mutex> lock(registry.mutex);
+              data.counters =
+                std::make_unique<HardwareCounters>(registry.counter_events);
+              data.counter_configuration = configuration;
+            }
+          data.counters->read(data.nodes[child].hardware_counters_at_entry);
+        }
+
+      return this_thread_data;
+    }
+
+
+
+    void
+    leave_region(ThreadData &                                     thread_data,
+                 const unsigned int                               parent_node,
+                 const dealii::Instrumentation::Clock::time_point start_time)
+    {
+      const Clock::time_point end_time = Clock::now();
+
+      AssertIndexRange(thread_data.current_node, thread_data.nodes.size());
+      Node &node = thread_data.nodes[thread_data.current_node];
+      Assert(node.parent == parent_node,
+             ExcMessage("The scopes of a thread must be left in the reverse "
+                        "order in which they were entered."));
+
+      const double duration =
+        std::chrono::duration<double>(end_time - start_time).count();
+      ++node.n_calls;
+      node.total_time += duration;
+      node.min_call_time = std::min(node.min_call_time, duration);
+      node.max_call_time = std::max(node.max_call_time, duration);
+      ++node.histogram[histogram_bin(duration)];
+
+      if (record_trace.load(std::memory_order_relaxed))
+        thread_data.events.push_back({node.region, start_time, end_time});
+
+      if (node.hardware_counters_at_entry.empty() == false)
+        {
+          std::vector<double> &values = thread_data.counter_values;
+          thread_data.counters->read(values);
+          Assert(values.size() == node.hardware_counters_at_entry.size(),
+                 ExcInternalError());
+          node.hardware_counters.resize(values.size(), 0.);
+          for (unsigned int e = 0; e < values.size(); ++e)
+            node.hardware_counters[e] +=
+              values[e] - node.hardware_counters_at_entry[e];
+          node.hardware_counters_at_entry.clear();
+        }
+
+      thread_data.current_node = parent_node;
+    }
+  } // namespace Instrumentation
+} // namespace internal
+
+
+
+namespace Instrumentation
+{
+  void
+  enable(const bool record_trace)
+  {
+    internal::Instrumentation::Registry &registry =
+      internal::Instrumentation::get_registry();
+    {
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      if (registry.epoch_is_set == false)
+        {
+          registry.epoch        = Clock::now();
+          registry.epoch_is_set = true;
+        }
+    }
+
+    internal::Instrumentation::record_trace.store(record_trace);
+    internal::Instrumentation::enabled.store(true);
+  }
+
+
+
+  void
+  disable()
+  {
+    internal::Instrumentation::enabled.store(false);
+  }
+
+
+
+  void
+  reset()
+  {
+    internal::Instrumentation::Registry &registry =
+      internal::Instrumentation::get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (const auto &thread : registry.threads)
+      {
+        Assert(thread->current_node == 0,
+               ExcMessage("The recorded data can not be reset while a "
+                          "thread is within a recorded region."));
+        thread->nodes.clear();
+        thread->nodes.emplace_back(numbers::invalid_unsigned_int,
+                                   numbers::invalid_unsigned_int);
+        thread->events.clear();
+      }
+  }
+
+
+
+  void
+  enable_hardware_counters(const std::vector<HardwareCounters::Event> &events)
+  {
+    internal::Instrumentation::Registry &registry =
+      internal::Instrumentation::get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (const auto &thread : registry.threads)
+      {
+        Assert(thread->current_node == 0,
+               ExcMessage("Hardware counters can not be enabled while a "
+                          "thread is within a recorded region."));
+        for (internal::Instrumentation::Node &node : thread->nodes)
+          node.hardware_counters.clear();
+      }
+
+    registry.counter_events = events;
+    ++internal::Instrumentation::counter_configuration;
+    internal::Instrumentation::record_counters.store(events.size() > 0);
+  }
+
+
+
+  std::vector<HardwareCounters::Event>
+  get_hardware_counter_events()
+  {
+    internal::Instrumentation::Registry &registry =
+      internal::Instrumentation::get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.counter_events;
+  }
+
+
+
+  Region::Region(const std::string &name)
+    : region_name(name)
+    , region_index([&name]() {
+      internal::Instrumentation::Registry &registry =
+        internal::Instrumentation::get_registry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+
+      const auto position = registry.region_indices.find(name);
+      if (position != registry.region_indices.end())
+        return position->second;
+
+      const unsigned int index       = registry.region_names.size();
+      registry.region_indices[name] = index;
+      registry.region_names.push_back(name);
+      return index;
+    }())
+  {}
+
+
+
+  double
+  RegionStatistics::imbalance() const
+  {
+    return (total_time.avg > 0. ? total_time.max / total_time.avg : 1.);
+  }
+
+
+
+  std::vector<RegionStatistics>
+  get_statistics(const MPI_Comm &mpi_communicator)
+  {
+    const auto local_statistics =
+      internal::Instrumentation::collect_local_statistics();
+
+    // not every process needs to have entered every region, so first build
+    // the union of all paths
+    std::vector<std::vector<std::string>> local_paths;
+    for (const auto &entry : local_statistics)
+      local_paths.push_back(entry.first);
+
+    std::set<std::vector<std::string>> all_paths;
+    for (const auto &paths :
+         Utilities::MPI::all_gather(mpi_communicator, local_paths))
+      all_paths.insert(paths.begin(), paths.end());
+
+    // then reduce the data of all regions at once
+    const unsigned int  n_regions = all_paths.size();
+    std::vector<double> total_times(n_regions, 0.);
+    std::vector<double> min_call_times(n_regions,
+                                       std::numeric_limits<double>::max());
+    std::vector<double> max_call_times(n_regions, 0.);
+    std::vector<unsigned long long int> counts(n_regions *
+                                                 (n_histogram_bins + 1),
+                                               0);
+    const unsigned int  n_events = get_hardware_counter_events().size();
+    std::vector<double> hardware_counters(n_regions * n_events, 0.);
+    {
+      unsigned int r = 0;
+      for (const auto &path : all_paths)
+        {
+          const auto entry = local_statistics.find(path);
+          if (entry != local_statistics.end())
+            {
+              total_times[r]    = entry->second.total_time;
+              min_call_times[r] = entry->second.min_call_time;
+              max_call_times[r] = entry->second.max_call_time;
+              counts[r * (n_histogram_bins + 1)] = entry->second.n_calls;
+              std::copy(entry->second.histogram.begin(),
+                        entry->second.histogram.end(),
+                        counts.begin() + r * (n_histogram_bins + 1) + 1);
+              std::copy(entry->second.hardware_counters.begin(),
+                        entry->second.hardware_counters.end(),
+                        hardware_counters.begin() + r * n_events);
+            }
+          ++r;
+        }
+    }
+
+    const std::vector<Utilities::MPI::MinMaxAvg> time_statistics =
+      Utilities::MPI::min_max_avg(total_times, mpi_communicator);
+    Utilities::MPI::min(min_call_times, mpi_communicator, min_call_times);
+    Utilities::MPI::max(max_call_times, mpi_communicator, max_call_times);
+    Utilities::MPI::sum(counts, mpi_communicator, counts);
+    Utilities::MPI::sum(hardware_counters, mpi_communicator, hardware_counters);
+
+    std::vector<RegionStatistics> statistics(n_regions);
+    unsigned int                  r = 0;
+    for (const auto &path : all_paths)
+      {
+        RegionStatistics &entry = statistics[r];
+        entry.path              = path;
+        entry.n_calls           = counts[r * (n_histogram_bins + 1)];
+        entry.total_time        = time_statistics[r];
+        entry.min_call_time     = min_call_times[r];
+        entry.max_call_time     = max_call_times[r];
+        std::copy(counts.begin() + r * (n_histogram_bins + 1) + 1,
+                  counts.begin() + (r + 1) * (n_histogram_bins + 1),
+                  entry.histogram.begin());
+        entry.hardware_counters.assign(hardware_counters.begin() +
+                                         r * n_events,
+                                       hardware_counters.begin() +
+                                         (r + 1) * n_events);
+        ++r;
+      }
+    return statistics;
+  }
+
+
+
+  void
+  print_statistics(std::ostream &out, const MPI_Comm &mpi_communicator)
+  {
+    const std::vector<RegionStatistics> statistics =
+      get_statistics(mpi_communicator);
+    if (Utilities::MPI::this_mpi_process(mpi_communicator) != 0)
+      return;
+
+    const boost::io::ios_base_all_saver restore_stream(out);
+
+    // the regions are indented by two spaces per level
+    unsigned int name_width = 6;
+    for (const RegionStatistics &entry : statistics)
+      name_width =
+        std::max<unsigned int>(name_width,
+                               2 * (entry.path.size() - 1) +
+                                 entry.path.back().size());
+
+    const std::string rule = "+" + std::string(name_width + 2, '-') +
+                             "+---------+-----------+-----------+" +
+                             "-----------+---------+\n";
+    out << rule << "| " << std::left << std::setw(name_width) << "Region"
+        << " |   calls |  min time |  avg time |  max time | max/avg |\n"
+        << rule;
+    for (const RegionStatistics &entry : statistics)
+      {
+        out << "| " << std::left << std::setw(name_width)
+            << std::string(2 * (entry.path.size() - 1), ' ') +
+                 entry.path.back()
+            << " | " << std::right << std::setw(7) << entry.n_calls;
+        out << std::setprecision(3);
+        for (const double time : {entry.total_time.min,
+                                  entry.total_time.avg,
+                                  entry.total_time.max})
+          out << " | " << std::setw(8) << time << 's';
+        out << " | " << std::setw(7) << entry.imbalance() << " |\n";
+      }
+    out << rule;
+
+    const std::vector<HardwareCounters::Event> events =
+      get_hardware_counter_events();
+    if (events.empty() == false)
+      {
+        // the columns of the table: the counters summed over all threads and
+        // processes, followed by the instructions per cycle and the rates of
+        // floating point operations per thread if the respective counters
+        // were recorded
+        std::vector<std::string> headings;
+        std::vector<std::function<double(const RegionStatistics &)>> columns;
+        unsigned int cycles       = numbers::invalid_unsigned_int;
+        unsigned int instructions = numbers::invalid_unsigned_int;
+        for (unsigned int e = 0; e < events.size(); ++e)
+          {
+            headings.push_back(HardwareCounters::get_name(events[e]));
+            columns.emplace_back([e](const RegionStatistics &entry) {
+              return entry.hardware_counters[e];
+            });
+            if (events[e] == HardwareCounters::cycles)
+              cycles = e;
+            else if (events[e] == HardwareCounters::instructions)
+              instructions = e;
+          }
+        if (cycles != numbers::invalid_unsigned_int &&
+            instructions != numbers::invalid_unsigned_int)
+          {
+            headings.emplace_back("IPC");
+            columns.emplace_back(
+              [cycles, instructions](const RegionStatistics &entry) {
+                return entry.hardware_counters[instructions] /
+                       entry.hardware_counters[cycles];
+              });
+          }
+        for (unsigned int e = 0; e < events.size(); ++e)
+          if (events[e] == HardwareCounters::double_precision_flops ||
+              events[e] == HardwareCounters::single_precision_flops)
+            {
+              headings.push_back(events[e] ==
+                                     HardwareCounters::double_precision_flops ?
+                                   "DP GFLOP/s" :
+                                   "SP GFLOP/s");
+              columns.emplace_back([e](const RegionStatistics &entry) {
+                return 1e-9 * entry.hardware_counters[e] /
+                       entry.total_time.sum;
+              });
+            }
+
+        std::string counter_rule = "+" + std::string(name_width + 2, '-');
+        for (unsigned int c = 0; c < columns.size(); ++c)
+          counter_rule += "+---------------";
+        counter_rule += "+\n";
+
+        out << "\nHardware counters:\n"
+            << counter_rule << "| " << std::left << std::setw(name_width)
+            << "Region";
+        for (const std::string &heading : headings)
+          out << " | " << std::right << std::setw(13) << heading;
+        out << " |\n" << counter_rule;
+        out << std::setprecision(4);
+        for (const RegionStatistics &entry : statistics)
+          {
+            out << "| " << std::left << std::setw(name_width)
+                << std::string(2 * (entry.path.size() - 1), ' ') +
+                     entry.path.back()
+                << std::right;
+            for (const auto &column : columns)
+              {
+                const double value = column(entry);
+                out << " | " << std::setw(13);
+                if (std::isfinite(value))
+                  out << value;
+                else
+                  out << "n/a";
+              }
+            out << " |\n";
+          }
+        out << counter_rule;
+      }
+
+    out << "\nHistograms of the call durations:\n";
+    for (const RegionStatistics &entry : statistics)
+      {
+        std::string path;
+        for (const std::string &name : entry.path)
+          path += (path.empty() ? "" : "/") + name;
+        out << path << ":\n";
+
+        for (unsigned int b = 0; b < n_histogram_bins; ++b)
+          if (entry.histogram[b] > 0)
+            {
+              using internal::Instrumentation::format_microseconds;
+              const std::string lower =
+                (b == 0 ? "0us" : format_microseconds(std::ldexp(1., b - 1)));
+              const std::string upper =
+                (b == n_histogram_bins - 1 ?
+                   "" :
+                   format_microseconds(std::ldexp(1., b)));
+              out << "  [" << std::right << std::setw(8) << lower << ", "
+                  << std::setw(8) << upper << (upper.empty() ? " " : ")")
+                  << ": " << entry.histogram[b] << '\n';
+            }
+      }
+    out << std::flush;
+  }
+
+
+
+  void
+  write_chrome_trace(std::ostream &out, const MPI_Comm &mpi_communicator)
+  {
+    const unsigned int my_rank =
+      Utilities::MPI::this_mpi_process(mpi_communicator);
+
+    // every process describes its own events, which are then written by the
+    // root process
+    std::ostringstream events;
+    {
+      internal::Instrumentation::Registry &registry =
+        internal::Instrumentation::get_registry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+
+      events << std::fixed << std::setprecision(3);
+      events << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << my_rank
+             << ",\"tid\":0,\"args\":{\"name\":\"MPI process " << my_rank
+             << "\"}}";
+      for (const auto &thread : registry.threads)
+        {
+          if (thread->events.empty())
+            continue;
+
+          events << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"
+                 << my_rank << ",\"tid\":" << thread->thread_index
+                 << ",\"args\":{\"name\":\"thread " << thread->thread_index
+                 << "\"}}";
+          for (const internal::Instrumentation::TraceEvent &event :
+               thread->events)
+            {
+              const double start =
+                std::chrono::duration<double, std::micro>(event.start_time -
+                                                          registry.epoch)
+                  .count();
+              const double duration =
+                std::chrono::duration<double, std::micro>(event.end_time -
+                                                          event.start_time)
+                  .count();
+              events << ",\n{\"name\":\""
+                     << internal::Instrumentation::escape_json(
+                          registry.region_names[event.region])
+                     << "\",\"cat\":\"deal.II\",\"ph\":\"X\",\"ts\":" << start
+                     << ",\"dur\":" << duration << ",\"pid\":" << my_rank
+                     << ",\"tid\":" << thread->thread_index << '}';
+            }
+        }
+    }
+
+    const std::vector<std::string> all_events =
+      Utilities::MPI::gather(mpi_communicator, events.str());
+    if (my_rank != 0)
+      return;
+
+    out << "{\"traceEvents\":[\n";
+    for (unsigned int p = 0; p < all_events.size(); ++p)
+      out << (p > 0 ? ",\n" : "") << all_events[p];
+    out << "\n],\n\"displayTimeUnit\":\"ms\"}\n" << std::flush;
+  }
+} // namespace Instrumentation
+
+DEAL_II_NAMESPACE_CLOSE
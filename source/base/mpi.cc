@@ -1042,6 +1042,22 @@ namespace Utilities
 
 
 
+    void
+    wait(MPI_Request &request)
+    {
+#ifdef DEAL_II_WITH_MPI
+      if (request != MPI_REQUEST_NULL)
+        {
+          const int ierr = MPI_Wait(&request, MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+        }
+#else
+      request = MPI_REQUEST_NULL;
+#endif
+    }
+
+
+
     std::vector<unsigned int>
     compute_index_owner(const IndexSet &owned_indices,
                         const IndexSet &indices_to_look_up,
@@ -48,6 +48,24 @@ namespace Utilities
         std::pair<types::global_dof_index, types::global_dof_index>,
         unsigned int>;
 
+
+      template class Process<double, unsigned int>;
+
+      template class NBX<double, unsigned int>;
+
+      template class PEX<double, unsigned int>;
+
+      template class Selector<double, unsigned int>;
+
+
+      template class Process<types::global_vertex_index, unsigned int>;
+
+      template class NBX<types::global_vertex_index, unsigned int>;
+
+      template class PEX<types::global_vertex_index, unsigned int>;
+
+      template class Selector<types::global_vertex_index, unsigned int>;
+
     } // namespace ConsensusAlgorithms
   }   // end of namespace MPI
 } // end of namespace Utilities
@@ -0,0 +1,357 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/mpi_consensus_algorithms.h>
+#include <deal.II/base/mpi_remote_point_evaluation.h>
+
+#include <deal.II/distributed/tria_base.h>
+
+#include <deal.II/fe/mapping.h>
+
+#include <deal.II/grid/grid_tools.h>
+
+#include <map>
+#include <tuple>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Utilities
+{
+  namespace MPI
+  {
+    template <int dim, int spacedim>
+    RemotePointEvaluation<dim, spacedim>::RemotePointEvaluation(
+      const double tolerance)
+      : tolerance(tolerance)
+      , ready_flag(false)
+      , communicator(MPI_COMM_SELF)
+      , unique_mapping(false)
+    {}
+
+
+
+    template <int dim, int spacedim>
+    RemotePointEvaluation<dim, spacedim>::~RemotePointEvaluation()
+    {
+      if (tria_signal.connected())
+        tria_signal.disconnect();
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    RemotePointEvaluation<dim, spacedim>::reinit(
+      const std::vector<Point<spacedim>> &  points,
+      const GridTools::Cache<dim, spacedim> &cache)
+    {
+      this->tria    = &cache.get_triangulation();
+      this->mapping = &cache.get_mapping();
+
+      if (tria_signal.connected())
+        tria_signal.disconnect();
+
+      tria_signal = tria->signals.any_change.connect(
+        [this]() { this->ready_flag = false; });
+
+      if (const auto tria_mpi =
+            dynamic_cast<const parallel::TriangulationBase<dim, spacedim> *>(
+              &*tria))
+        communicator = tria_mpi->get_communicator();
+      else
+        communicator = MPI_COMM_SELF;
+
+      const unsigned int my_rank = this_mpi_process(communicator);
+
+      // Step 1: identify the processes that might own the points with the
+      // bounding boxes describing the locally owned part of each process
+      const auto potential_owners =
+        std::get<0>(GridTools::guess_point_owner(cache.get_covering_rtree(),
+                                                 points));
+
+      // Step 2: search the points received from other processes (or this
+      // process) among the locally owned cells. The found points are
+      // collected as tuples (cell, reference point, requesting rank, index
+      // within the data exchanged with that rank), and the number of cells
+      // found for each requested point is returned to the requesting rank.
+      // Since the values are later sent in the order of the request, this
+      // information is enough for the requesting rank to assign them to
+      // its points.
+      std::vector<
+        std::tuple<std::pair<int, int>, Point<dim>, unsigned int, unsigned int>>
+        found_points;
+
+      const auto &cell_rtree = cache.get_cell_bounding_boxes_rtree();
+
+      const auto find_points =
+        [&](const unsigned int                  other_rank,
+            const std::vector<Point<spacedim>> &requested_points) {
+          std::vector<unsigned int> n_cells_found(requested_points.size(), 0);
+          unsigned int              n_found_for_rank = 0;
+          std::vector<std::pair<
+            BoundingBox<spacedim>,
+            typename Triangulation<dim, spacedim>::active_cell_iterator>>
+            box_and_cells;
+          for (unsigned int i = 0; i < requested_points.size(); ++i)
+            {
+              box_and_cells.clear();
+              cell_rtree.query(boost::geometry::index::intersects(
+                                 requested_points[i]),
+                               std::back_inserter(box_and_cells));
+
+              for (const auto &box_and_cell : box_and_cells)
+                {
+                  const auto &cell = box_and_cell.second;
+                  if (cell->is_locally_owned() == false)
+                    continue;
+
+                  try
+                    {
+                      const Point<dim> reference_point =
+                        mapping->transform_real_to_unit_cell(
+                          cell, requested_points[i]);
+                      if (GeometryInfo<dim>::is_inside_unit_cell(
+                            reference_point, tolerance))
+                        {
+                          found_points.emplace_back(
+                            std::make_pair(cell->level(), cell->index()),
+                            reference_point,
+                            other_rank,
+                            n_found_for_rank++);
+                          ++n_cells_found[i];
+                        }
+                    }
+                  catch (
+                    typename Mapping<dim, spacedim>::ExcTransformationFailed &)
+                    {
+                      // the transformation failed because the point is
+                      // outside of the cell, so the cell does not contain
+                      // the point
+                    }
+                }
+            }
+          return n_cells_found;
+        };
+
+      // indices of the points in the list of this process, for each rank
+      // that reported to have found some of them (in the order the rank
+      // will send the values)
+      std::map<unsigned int, std::vector<unsigned int>> recv_indices;
+
+      const auto pack_points = [&](const std::vector<unsigned int> &indices) {
+        std::vector<double> buffer;
+        buffer.reserve(indices.size() * spacedim);
+        for (const unsigned int i : indices)
+          for (unsigned int d = 0; d < spacedim; ++d)
+            buffer.push_back(points[i][d]);
+        return buffer;
+      };
+
+      const auto unpack_points = [](const std::vector<double> &buffer) {
+        AssertDimension(buffer.size() % spacedim, 0);
+        std::vector<Point<spacedim>> requested_points(buffer.size() /
+                                                      spacedim);
+        for (unsigned int i = 0; i < requested_points.size(); ++i)
+          for (unsigned int d = 0; d < spacedim; ++d)
+            requested_points[i][d] = buffer[i * spacedim + d];
+        return requested_points;
+      };
+
+      const auto add_found_indices =
+        [&](const unsigned int               other_rank,
+            const std::vector<unsigned int> &n_cells_found) {
+          const auto &requested = potential_owners.at(other_rank);
+          AssertDimension(n_cells_found.size(), requested.size());
+          std::vector<unsigned int> indices;
+          for (unsigned int i = 0; i < requested.size(); ++i)
+            for (unsigned int j = 0; j < n_cells_found[i]; ++j)
+              indices.push_back(requested[i]);
+          if (indices.size() > 0)
+            recv_indices[other_rank] = std::move(indices);
+        };
+
+      // the points that might be owned by this process are searched
+      // directly without communication
+      {
+        const auto local = potential_owners.find(my_rank);
+        if (local != potential_owners.end())
+          {
+            std::vector<Point<spacedim>> local_points;
+            local_points.reserve(local->second.size());
+            for (const unsigned int i : local->second)
+              local_points.push_back(points[i]);
+            add_found_indices(my_rank, find_points(my_rank, local_points));
+          }
+      }
+
+      ConsensusAlgorithms::AnonymousProcess<double, unsigned int> process(
+        [&]() {
+          std::vector<unsigned int> targets;
+          for (const auto &rank_and_indices : potential_owners)
+            if (rank_and_indices.first != my_rank)
+              targets.push_back(rank_and_indices.first);
+          return targets;
+        },
+        [&](const unsigned int other_rank, std::vector<double> &send_buffer) {
+          send_buffer = pack_points(potential_owners.at(other_rank));
+        },
+        [&](const unsigned int         other_rank,
+            const std::vector<double> &buffer_recv,
+            std::vector<unsigned int> &request_buffer) {
+          request_buffer = find_points(other_rank, unpack_points(buffer_recv));
+        },
+        [&](const unsigned int other_rank, std::vector<unsigned int> &buffer) {
+          buffer.resize(potential_owners.at(other_rank).size());
+        },
+        [&](const unsigned int               other_rank,
+            const std::vector<unsigned int> &buffer) {
+          add_found_indices(other_rank, buffer);
+        });
+
+      ConsensusAlgorithms::Selector<double, unsigned int>(process,
+                                                          communicator)
+        .run();
+
+      // Step 3: set up the data structures on the requesting side, i.e.,
+      // the ranks to receive from and the permutation from the received
+      // values to the (possibly multiple) values of each point
+      recv_ranks.clear();
+      recv_ptrs.assign(1, 0);
+      std::vector<unsigned int> n_found(points.size(), 0);
+      for (const auto &rank_and_indices : recv_indices)
+        {
+          recv_ranks.push_back(rank_and_indices.first);
+          recv_ptrs.push_back(recv_ptrs.back() +
+                              rank_and_indices.second.size());
+          for (const unsigned int i : rank_and_indices.second)
+            ++n_found[i];
+        }
+
+      point_ptrs.assign(points.size() + 1, 0);
+      unique_mapping = true;
+      for (unsigned int i = 0; i < points.size(); ++i)
+        {
+          point_ptrs[i + 1] = point_ptrs[i] + n_found[i];
+          if (n_found[i] != 1)
+            unique_mapping = false;
+        }
+
+      recv_permutation.clear();
+      recv_permutation.reserve(recv_ptrs.back());
+      std::fill(n_found.begin(), n_found.end(), 0);
+      for (const auto &rank_and_indices : recv_indices)
+        for (const unsigned int i : rank_and_indices.second)
+          recv_permutation.push_back(point_ptrs[i] + n_found[i]++);
+
+      // Step 4: set up the data structures on the evaluating side, i.e.,
+      // sort the points by cells and compute the permutation into the
+      // send buffers
+      std::stable_sort(found_points.begin(),
+                       found_points.end(),
+                       [](const auto &a, const auto &b) {
+                         return std::get<0>(a) < std::get<0>(b);
+                       });
+
+      cell_data.cells.clear();
+      cell_data.reference_point_ptrs.assign(1, 0);
+      cell_data.reference_point_values.clear();
+      cell_data.reference_point_values.reserve(found_points.size());
+
+      std::map<unsigned int, unsigned int> n_send_per_rank;
+      for (const auto &point : found_points)
+        {
+          if (cell_data.cells.empty() ||
+              cell_data.cells.back() != std::get<0>(point))
+            {
+              cell_data.cells.push_back(std::get<0>(point));
+              cell_data.reference_point_ptrs.push_back(
+                cell_data.reference_point_ptrs.back());
+            }
+          ++cell_data.reference_point_ptrs.back();
+          cell_data.reference_point_values.push_back(std::get<1>(point));
+          ++n_send_per_rank[std::get<2>(point)];
+        }
+
+      send_ranks.clear();
+      send_ptrs.assign(1, 0);
+      std::map<unsigned int, unsigned int> rank_offset;
+      for (const auto &rank_and_count : n_send_per_rank)
+        {
+          rank_offset[rank_and_count.first] = send_ptrs.back();
+          send_ranks.push_back(rank_and_count.first);
+          send_ptrs.push_back(send_ptrs.back() + rank_and_count.second);
+        }
+
+      send_permutation.clear();
+      send_permutation.reserve(found_points.size());
+      for (const auto &point : found_points)
+        send_permutation.push_back(rank_offset[std::get<2>(point)] +
+                                   std::get<3>(point));
+
+      ready_flag = true;
+    }
+
+
+
+    template <int dim, int spacedim>
+    const std::vector<unsigned int> &
+    RemotePointEvaluation<dim, spacedim>::get_point_ptrs() const
+    {
+      return point_ptrs;
+    }
+
+
+
+    template <int dim, int spacedim>
+    bool
+    RemotePointEvaluation<dim, spacedim>::is_map_unique() const
+    {
+      return unique_mapping;
+    }
+
+
+
+    template <int dim, int spacedim>
+    const Triangulation<dim, spacedim> &
+    RemotePointEvaluation<dim, spacedim>::get_triangulation() const
+    {
+      return *tria;
+    }
+
+
+
+    template <int dim, int spacedim>
+    const Mapping<dim, spacedim> &
+    RemotePointEvaluation<dim, spacedim>::get_mapping() const
+    {
+      return *mapping;
+    }
+
+
+
+    template <int dim, int spacedim>
+    bool
+    RemotePointEvaluation<dim, spacedim>::is_ready() const
+    {
+      return ready_flag;
+    }
+
+  } // end of namespace MPI
+} // end of namespace Utilities
+
+#include "mpi_remote_point_evaluation.inst"
+
+DEAL_II_NAMESPACE_CLOSE
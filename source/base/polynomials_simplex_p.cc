@@ -0,0 +1,326 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/polynomial.h>
+#include <deal.II/base/polynomials_simplex_p.h>
+
+#include <deal.II/lac/full_matrix.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace PolynomialsSimplexP
+  {
+    /**
+     * Return the number of polynomials of total degree at most @p degree in
+     * @p dim dimensions.
+     */
+    unsigned int
+    n_polynomials(const unsigned int dim, const unsigned int degree)
+    {
+      unsigned int n = 1;
+      for (unsigned int d = 1; d <= dim; ++d)
+        n = n * (degree + d) / d;
+      return n;
+    }
+
+
+
+    /**
+     * Return the points of the equispaced lattice of the given degree on
+     * the reference simplex, with the vertices first and all other points
+     * in lexicographic order.
+     */
+    template <int dim>
+    std::vector<Point<dim>>
+    create_support_points(const unsigned int degree)
+    {
+      std::vector<Point<dim>> points;
+      if (degree == 0)
+        {
+          Point<dim> barycenter;
+          for (unsigned int d = 0; d < dim; ++d)
+            barycenter[d] = 1. / (dim + 1);
+          points.push_back(barycenter);
+          return points;
+        }
+
+      points.emplace_back();
+      for (unsigned int d = 0; d < dim; ++d)
+        points.push_back(Point<dim>::unit_vector(d));
+
+      std::array<unsigned int, dim> index;
+      std::fill(index.begin(), index.end(), 0U);
+      while (true)
+        {
+          unsigned int sum = 0, n_nonzero = 0;
+          for (unsigned int d = 0; d < dim; ++d)
+            {
+              sum += index[d];
+              if (index[d] > 0)
+                ++n_nonzero;
+            }
+
+          // skip the vertices, which have been added above
+          const bool is_vertex =
+            n_nonzero == 0 || (n_nonzero == 1 && sum == degree);
+          if (sum <= degree && !is_vertex)
+            {
+              Point<dim> p;
+              for (unsigned int d = 0; d < dim; ++d)
+                p[d] = static_cast<double>(index[d]) / degree;
+              points.push_back(p);
+            }
+
+          unsigned int d = 0;
+          for (; d < dim; ++d)
+            if (++index[d] <= degree)
+              break;
+            else
+              index[d] = 0;
+          if (d == dim)
+            break;
+        }
+
+      AssertDimension(points.size(), n_polynomials(dim, degree));
+      return points;
+    }
+  } // namespace PolynomialsSimplexP
+} // namespace internal
+
+
+
+template <int dim>
+PolynomialsSimplexP<dim>::PolynomialsSimplexP(const unsigned int degree)
+  : ScalarPolynomialsBase<dim>(
+      degree,
+      internal::PolynomialsSimplexP::n_polynomials(dim, degree))
+  , monomials(Polynomials::Monomial<double>::generate_complete_basis(degree))
+  , support_points(
+      internal::PolynomialsSimplexP::create_support_points<dim>(degree))
+{
+  const unsigned int n = this->n();
+  AssertDimension(monomials.n(), n);
+
+  // the coefficients of the Lagrange polynomials are given by the inverse
+  // of the Vandermonde matrix V(i,j) = m_j(x_i): with L = C m and the
+  // condition L_i(x_k) = delta_ik, we get C V^T = I
+  FullMatrix<double> vandermonde(n, n);
+  for (unsigned int i = 0; i < n; ++i)
+    for (unsigned int j = 0; j < n; ++j)
+      vandermonde(i, j) = monomials.compute_value(j, support_points[i]);
+  vandermonde.gauss_jordan();
+
+  coefficients.reinit(n, n);
+  for (unsigned int i = 0; i < n; ++i)
+    for (unsigned int j = 0; j < n; ++j)
+      coefficients(i, j) = vandermonde(j, i);
+}
+
+
+
+template <int dim>
+void
+PolynomialsSimplexP<dim>::evaluate(
+  const Point<dim> &           unit_point,
+  std::vector<double> &        values,
+  std::vector<Tensor<1, dim>> &grads,
+  std::vector<Tensor<2, dim>> &grad_grads,
+  std::vector<Tensor<3, dim>> &third_derivatives,
+  std::vector<Tensor<4, dim>> &fourth_derivatives) const
+{
+  const unsigned int n = this->n();
+  Assert(values.size() == n || values.size() == 0,
+         ExcDimensionMismatch2(values.size(), n, 0));
+  Assert(grads.size() == n || grads.size() == 0,
+         ExcDimensionMismatch2(grads.size(), n, 0));
+  Assert(grad_grads.size() == n || grad_grads.size() == 0,
+         ExcDimensionMismatch2(grad_grads.size(), n, 0));
+  Assert(third_derivatives.size() == n || third_derivatives.size() == 0,
+         ExcDimensionMismatch2(third_derivatives.size(), n, 0));
+  Assert(fourth_derivatives.size() == n || fourth_derivatives.size() == 0,
+         ExcDimensionMismatch2(fourth_derivatives.size(), n, 0));
+
+  // evaluate the monomials and combine them with the coefficients
+  std::vector<double>         monomial_values(values.size());
+  std::vector<Tensor<1, dim>> monomial_grads(grads.size());
+  std::vector<Tensor<2, dim>> monomial_grad_grads(grad_grads.size());
+  std::vector<Tensor<3, dim>> monomial_third_derivatives(
+    third_derivatives.size());
+  std::vector<Tensor<4, dim>> monomial_fourth_derivatives(
+    fourth_derivatives.size());
+  monomials.evaluate(unit_point,
+                     monomial_values,
+                     monomial_grads,
+                     monomial_grad_grads,
+                     monomial_third_derivatives,
+                     monomial_fourth_derivatives);
+
+  for (unsigned int i = 0; i < values.size(); ++i)
+    {
+      values[i] = 0;
+      for (unsigned int j = 0; j < n; ++j)
+        values[i] += coefficients(i, j) * monomial_values[j];
+    }
+  for (unsigned int i = 0; i < grads.size(); ++i)
+    {
+      grads[i] = Tensor<1, dim>();
+      for (unsigned int j = 0; j < n; ++j)
+        grads[i] += coefficients(i, j) * monomial_grads[j];
+    }
+  for (unsigned int i = 0; i < grad_grads.size(); ++i)
+    {
+      grad_grads[i] = Tensor<2, dim>();
+      for (unsigned int j = 0; j < n; ++j)
+        grad_grads[i] += coefficients(i, j) * monomial_grad_grads[j];
+    }
+  for (unsigned int i = 0; i < third_derivatives.size(); ++i)
+    {
+      third_derivatives[i] = Tensor<3, dim>();
+      for (unsigned int j = 0; j < n; ++j)
+        third_derivatives[i] +=
+          coefficients(i, j) * monomial_third_derivatives[j];
+    }
+  for (unsigned int i = 0; i < fourth_derivatives.size(); ++i)
+    {
+      fourth_derivatives[i] = Tensor<4, dim>();
+      for (unsigned int j = 0; j < n; ++j)
+        fourth_derivatives[i] +=
+          coefficients(i, j) * monomial_fourth_derivatives[j];
+    }
+}
+
+
+
+template <int dim>
+double
+PolynomialsSimplexP<dim>::compute_value(const unsigned int i,
+                                        const Point<dim> & p) const
+{
+  AssertIndexRange(i, this->n());
+  double value = 0;
+  for (unsigned int j = 0; j < this->n(); ++j)
+    value += coefficients(i, j) * monomials.compute_value(j, p);
+  return value;
+}
+
+
+
+template <int dim>
+template <int order>
+Tensor<order, dim>
+PolynomialsSimplexP<dim>::compute_lagrange_derivative(
+  const unsigned int i,
+  const Point<dim> & p) const
+{
+  AssertIndexRange(i, this->n());
+  Tensor<order, dim> derivative;
+  for (unsigned int j = 0; j < this->n(); ++j)
+    derivative +=
+      coefficients(i, j) * monomials.template compute_derivative<order>(j, p);
+  return derivative;
+}
+
+
+
+template <int dim>
+Tensor<1, dim>
+PolynomialsSimplexP<dim>::compute_1st_derivative(const unsigned int i,
+                                                 const Point<dim> & p) const
+{
+  return compute_lagrange_derivative<1>(i, p);
+}
+
+
+
+template <int dim>
+Tensor<2, dim>
+PolynomialsSimplexP<dim>::compute_2nd_derivative(const unsigned int i,
+                                                 const Point<dim> & p) const
+{
+  return compute_lagrange_derivative<2>(i, p);
+}
+
+
+
+template <int dim>
+Tensor<3, dim>
+PolynomialsSimplexP<dim>::compute_3rd_derivative(const unsigned int i,
+                                                 const Point<dim> & p) const
+{
+  return compute_lagrange_derivative<3>(i, p);
+}
+
+
+
+template <int dim>
+Tensor<4, dim>
+PolynomialsSimplexP<dim>::compute_4th_derivative(const unsigned int i,
+                                                 const Point<dim> & p) const
+{
+  return compute_lagrange_derivative<4>(i, p);
+}
+
+
+
+template <int dim>
+Tensor<1, dim>
+PolynomialsSimplexP<dim>::compute_grad(const unsigned int i,
+                                       const Point<dim> & p) const
+{
+  return compute_lagrange_derivative<1>(i, p);
+}
+
+
+
+template <int dim>
+Tensor<2, dim>
+PolynomialsSimplexP<dim>::compute_grad_grad(const unsigned int i,
+                                            const Point<dim> & p) const
+{
+  return compute_lagrange_derivative<2>(i, p);
+}
+
+
+
+template <int dim>
+std::unique_ptr<ScalarPolynomialsBase<dim>>
+PolynomialsSimplexP<dim>::clone() const
+{
+  return std::make_unique<PolynomialsSimplexP<dim>>(*this);
+}
+
+
+
+template <int dim>
+std::size_t
+PolynomialsSimplexP<dim>::memory_consumption() const
+{
+  return monomials.memory_consumption() +
+         MemoryConsumption::memory_consumption(support_points) +
+         MemoryConsumption::memory_consumption(coefficients);
+}
+
+
+
+template class PolynomialsSimplexP<1>;
+template class PolynomialsSimplexP<2>;
+template class PolynomialsSimplexP<3>;
+
+DEAL_II_NAMESPACE_CLOSE
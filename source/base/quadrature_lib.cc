@@ -16,8 +16,10 @@
 #include <deal.II/base/geometry_info.h>
 #include <deal.II/base/polynomial.h>
 #include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/utilities.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <functional>
 #include <limits>
@@ -1388,6 +1390,115 @@ template class QGaussLobattoChebyshev<1>;
 template class QGaussLobattoChebyshev<2>;
 template class QGaussLobattoChebyshev<3>;
 
+namespace internal
+{
+  namespace QGaussSimplex
+  {
+    /**
+     * Compute the points and weights of the Gauss-Jacobi quadrature formula
+     * on [0,1] with @p n_points points for the weight function
+     * $(1-x)^{\alpha}$.
+     */
+    Quadrature<1>
+    create_gauss_jacobi_formula(const unsigned int n_points,
+                                const unsigned int alpha)
+    {
+      const std::vector<double> points =
+        Polynomials::jacobi_polynomial_roots<double>(n_points, alpha, 0);
+
+      // the weights are the integrals of the weight function times the
+      // Lagrange polynomials in the points, which are computed exactly with
+      // a Gauss formula
+      const QGauss<1>     gauss(n_points / 2 + alpha / 2 + 1);
+      std::vector<double> weights(n_points, 0.);
+      for (unsigned int q = 0; q < gauss.size(); ++q)
+        {
+          const double x = gauss.point(q)[0];
+          const double weight_function =
+            gauss.weight(q) * std::pow(1. - x, static_cast<double>(alpha));
+          for (unsigned int i = 0; i < n_points; ++i)
+            {
+              double lagrange = 1.;
+              for (unsigned int j = 0; j < n_points; ++j)
+                if (j != i)
+                  lagrange *= (x - points[j]) / (points[i] - points[j]);
+              weights[i] += weight_function * lagrange;
+            }
+        }
+
+      std::vector<Point<1>> quadrature_points(n_points);
+      for (unsigned int i = 0; i < n_points; ++i)
+        quadrature_points[i][0] = points[i];
+
+      return Quadrature<1>(quadrature_points, weights);
+    }
+
+
+
+    /**
+     * Build the conical product formula on the unit hypercube, collapsed
+     * onto the reference simplex.
+     */
+    template <int dim>
+    Quadrature<dim>
+    create_collapsed_formula(const unsigned int n_points_1D)
+    {
+      // direction d is collapsed by the coordinates d+1,...,dim-1, which
+      // gives a weight (1-xi_d)^d in that direction
+      std::array<Quadrature<1>, dim> formulas_1d;
+      for (unsigned int d = 0; d < dim; ++d)
+        formulas_1d[d] = create_gauss_jacobi_formula(n_points_1D, d);
+
+      std::vector<Point<dim>> points;
+      std::vector<double>     weights;
+      points.reserve(Utilities::fixed_power<dim>(n_points_1D));
+      weights.reserve(Utilities::fixed_power<dim>(n_points_1D));
+
+      std::array<unsigned int, dim> index;
+      std::fill(index.begin(), index.end(), 0U);
+      for (unsigned int q = 0; q < Utilities::fixed_power<dim>(n_points_1D);
+           ++q)
+        {
+          // map the hypercube point to the simplex, starting from the
+          // outermost collapsed direction: x_d = xi_d prod_{e>d} (1-xi_e)
+          Point<dim> point;
+          double     weight = 1.;
+          double     scale  = 1.;
+          for (int d = dim - 1; d >= 0; --d)
+            {
+              const double xi = formulas_1d[d].point(index[d])[0];
+              point[d]        = xi * scale;
+              scale *= (1. - xi);
+              weight *= formulas_1d[d].weight(index[d]);
+            }
+          points.push_back(point);
+          weights.push_back(weight);
+
+          for (unsigned int d = 0; d < dim; ++d)
+            if (++index[d] < n_points_1D)
+              break;
+            else
+              index[d] = 0;
+        }
+
+      return Quadrature<dim>(points, weights);
+    }
+  } // namespace QGaussSimplex
+} // namespace internal
+
+
+
+template <int dim>
+QGaussSimplex<dim>::QGaussSimplex(const unsigned int n_points_1D)
+  : QSimplex<dim>(
+      internal::QGaussSimplex::create_collapsed_formula<dim>(n_points_1D))
+{
+  Assert(n_points_1D > 0,
+         ExcMessage("Need at least one point for the quadrature rule"));
+}
+
+
+
 template class QSimplex<1>;
 template class QSimplex<2>;
 template class QSimplex<3>;
@@ -1396,4 +1507,8 @@ template class QSplit<1>;
 template class QSplit<2>;
 template class QSplit<3>;
 
+template class QGaussSimplex<1>;
+template class QGaussSimplex<2>;
+template class QGaussSimplex<3>;
+
 DEAL_II_NAMESPACE_CLOSE
@@ -14,6 +14,7 @@
 // ---------------------------------------------------------------------
 
 
+#include <deal.II/base/instrumentation.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/utilities.h>
@@ -30,6 +31,7 @@
 #include <deal.II/lac/sparsity_tools.h>
 
 #include <algorithm>
+#include <exception>
 #include <fstream>
 #include <iostream>
 #include <numeric>
@@ -1923,6 +1925,128 @@ namespace parallel
 
 
 
+    template <int dim, int spacedim>
+    std::function<void()>
+    Triangulation<dim, spacedim>::DataTransfer::prepare_save_async(
+      const typename dealii::internal::p4est::types<dim>::forest
+        *                parallel_forest,
+      const std::string &filename)
+    {
+      Assert(sizes_fixed_cumulative.size() > 0,
+             ExcMessage("No data has been packed!"));
+
+      const int myrank = Utilities::MPI::this_mpi_process(mpi_communicator);
+
+      // Check if number of processors is lined up with p4est partitioning.
+      Assert(myrank < parallel_forest->mpisize, ExcInternalError());
+
+      const std::string fname_fixed = std::string(filename) + "_fixed.data";
+      const std::string fname_variable =
+        std::string(filename) + "_variable.data";
+
+      // The files are laid out exactly as in save(). Here, we only determine
+      // where each piece of data goes, and move it into a list of writes
+      // that can be executed without any communication.
+      struct Write
+      {
+        std::string       filename;
+        std::uint64_t     position;
+        std::vector<char> data;
+      };
+      const auto writes = std::make_shared<std::vector<Write>>();
+
+      const auto as_bytes = [](const auto &values) {
+        const char *begin = reinterpret_cast<const char *>(values.data());
+        return std::vector<char>(begin,
+                                 begin + values.size() * sizeof(values[0]));
+      };
+
+      //
+      // ---------- Fixed size data ----------
+      //
+      // Since each processor owns the same information about the data sizes,
+      // it is sufficient to let only the first processor write them.
+      if (myrank == 0)
+        writes->push_back({fname_fixed, 0, as_bytes(sizes_fixed_cumulative)});
+
+      const std::uint64_t offset_fixed =
+        sizes_fixed_cumulative.size() * sizeof(unsigned int);
+      writes->push_back(
+        {fname_fixed,
+         offset_fixed +
+           static_cast<std::uint64_t>(
+             parallel_forest->global_first_quadrant[myrank]) *
+             sizes_fixed_cumulative.back(),
+         std::move(src_data_fixed)});
+
+      //
+      // ---------- Variable size data ----------
+      //
+      if (variable_size_data_stored)
+        {
+          writes->push_back(
+            {fname_variable,
+             static_cast<std::uint64_t>(
+               parallel_forest->global_first_quadrant[myrank]) *
+               sizeof(int),
+             as_bytes(src_sizes_variable)});
+
+          const std::uint64_t offset_variable =
+            static_cast<std::uint64_t>(parallel_forest->global_num_quadrants) *
+            sizeof(int);
+
+          // Compute prefix sum of the data sizes in bytes
+          const std::uint64_t size_on_proc = src_data_variable.size();
+          std::uint64_t       prefix_sum   = 0;
+          const int           ierr =
+            MPI_Exscan(DEAL_II_MPI_CONST_CAST(&size_on_proc),
+                       &prefix_sum,
+                       1,
+                       MPI_UINT64_T,
+                       MPI_SUM,
+                       mpi_communicator);
+          AssertThrowMPI(ierr);
+          // the result of MPI_Exscan is undefined on the first processor
+          if (myrank == 0)
+            prefix_sum = 0;
+
+          writes->push_back({fname_variable,
+                             offset_variable + prefix_sum,
+                             std::move(src_data_variable)});
+        }
+
+      // Delete the contents of existing files on the first processor. The
+      // barrier makes sure that no processor writes before this is done.
+      if (myrank == 0)
+        {
+          std::ofstream file_fixed(fname_fixed, std::ios::binary);
+          AssertThrow(file_fixed, ExcFileNotOpen(fname_fixed));
+          if (variable_size_data_stored)
+            {
+              std::ofstream file_variable(fname_variable, std::ios::binary);
+              AssertThrow(file_variable, ExcFileNotOpen(fname_variable));
+            }
+        }
+      const int ierr = MPI_Barrier(mpi_communicator);
+      AssertThrowMPI(ierr);
+
+      return [writes]() {
+        for (const Write &write : *writes)
+          {
+            std::fstream file(write.filename,
+                              std::ios::binary | std::ios::in |
+                                std::ios::out);
+            AssertThrow(file, ExcFileNotOpen(write.filename));
+            file.seekp(write.position);
+            file.write(write.data.data(), write.data.size());
+            file.close();
+            AssertThrow(file, ExcIO());
+          }
+      };
+    }
+
+
+
     template <int dim, int spacedim>
     void
     Triangulation<dim, spacedim>::DataTransfer::load(
@@ -2151,6 +2275,16 @@ namespace parallel
       catch (...)
         {}
 
+      // wait for a checkpoint still being written. errors are reported
+      // through the handle returned by save_async()
+      if (checkpoint_write_task.joinable())
+        try
+          {
+            checkpoint_write_task.join();
+          }
+        catch (...)
+          {}
+
       AssertNothrow(triangulation_has_content == false, ExcInternalError());
       AssertNothrow(connectivity == nullptr, ExcInternalError());
       AssertNothrow(parallel_forest == nullptr, ExcInternalError());
@@ -2669,6 +2803,69 @@ namespace parallel
     template <int dim, int spacedim>
     void
     Triangulation<dim, spacedim>::save(const std::string &filename) const
+    {
+      save_checkpoint(filename, false);
+    }
+
+
+
+    template <int dim, int spacedim>
+    Threads::Task<>
+    Triangulation<dim, spacedim>::save_async(const std::string &filename) const
+    {
+      std::function<void()> write_attached_data =
+        save_checkpoint(filename, true);
+      if (!write_attached_data)
+        write_attached_data = []() {};
+
+      checkpoint_write_task = Threads::new_task(write_attached_data);
+      return checkpoint_write_task;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim, spacedim>::wait_for_checkpoint_write() const
+    {
+      // save_async() is collective, so either all processes have a task to
+      // wait for or none has
+      if (checkpoint_write_task.joinable() == false)
+        return;
+
+      std::exception_ptr write_error;
+      try
+        {
+          checkpoint_write_task.join();
+        }
+      catch (...)
+        {
+          write_error = std::current_exception();
+        }
+      checkpoint_write_task = Threads::Task<>();
+
+      // a process whose write failed must not leave the other processes
+      // waiting in the next collective operation, so agree on the outcome
+      // first and then throw on all processes. the reduction also ensures
+      // that all processes have completed their write when we return
+      const unsigned int n_failed_processes =
+        Utilities::MPI::sum(write_error ? 1U : 0U, this->mpi_communicator);
+      if (write_error)
+        std::rethrow_exception(write_error);
+      AssertThrow(n_failed_processes == 0,
+                  ExcMessage("Writing the cell data of the last checkpoint "
+                             "created with save_async() failed on " +
+                             std::to_string(n_failed_processes) +
+                             " other process(es)."));
+    }
+
+
+
+    template <int dim, int spacedim>
+    std::function<void()>
+    Triangulation<dim, spacedim>::save_checkpoint(
+      const std::string &filename,
+      const bool         write_asynchronously) const
     {
       Assert(
         cell_attached_data.n_attached_deserialize == 0,
@@ -2680,6 +2877,23 @@ namespace parallel
       // signal that serialization is going to happen
       this->signals.pre_distributed_save();
 
+      // cast away constness
+      auto tria =
+        const_cast<dealii::parallel::distributed::Triangulation<dim, spacedim>
+                     *>(this);
+
+      // pack attached data first, which can overlap with the background write
+      // of a previous checkpoint
+      if (cell_attached_data.n_attached_data_sets > 0)
+        tria->data_transfer.pack_data(
+          local_quadrant_cell_relations,
+          cell_attached_data.pack_callbacks_fixed,
+          cell_attached_data.pack_callbacks_variable);
+
+      // but do not touch any file before the previous checkpoint has been
+      // written completely
+      wait_for_checkpoint_write();
+
       if (this->my_subdomain == 0)
         {
           std::string   fname = std::string(filename) + ".info";
@@ -2703,21 +2917,17 @@ namespace parallel
             ExcInternalError());
         }
 
+      std::function<void()> write_attached_data;
       if (cell_attached_data.n_attached_data_sets > 0)
         {
-          // cast away constness
-          auto tria = const_cast<
-            dealii::parallel::distributed::Triangulation<dim, spacedim> *>(
-            this);
-
-          // pack attached data first
-          tria->data_transfer.pack_data(
-            local_quadrant_cell_relations,
-            cell_attached_data.pack_callbacks_fixed,
-            cell_attached_data.pack_callbacks_variable);
-
-          // then store buffers in file
-          tria->data_transfer.save(parallel_forest, filename);
+          // then store buffers in file, or hand them over to the returned
+          // function object
+          if (write_asynchronously)
+            write_attached_data =
+              tria->data_transfer.prepare_save_async(parallel_forest,
+                                                     filename);
+          else
+            tria->data_transfer.save(parallel_forest, filename);
 
           // and release the memory afterwards
           tria->data_transfer.clear();
@@ -2729,19 +2939,14 @@ namespace parallel
 
       // clear all of the callback data, as explained in the documentation of
       // register_data_attach()
-      {
-        dealii::parallel::distributed::Triangulation<dim, spacedim> *tria =
-          const_cast<
-            dealii::parallel::distributed::Triangulation<dim, spacedim> *>(
-            this);
-
-        tria->cell_attached_data.n_attached_data_sets = 0;
-        tria->cell_attached_data.pack_callbacks_fixed.clear();
-        tria->cell_attached_data.pack_callbacks_variable.clear();
-      }
+      tria->cell_attached_data.n_attached_data_sets = 0;
+      tria->cell_attached_data.pack_callbacks_fixed.clear();
+      tria->cell_attached_data.pack_callbacks_variable.clear();
 
       // signal that serialization has finished
       this->signals.post_distributed_save();
+
+      return write_attached_data;
     }
 
 
@@ -2760,6 +2965,10 @@ namespace parallel
         ExcMessage(
           "Triangulation may only contain coarse cells when calling load()."));
 
+      // a checkpoint that is still being written by this object needs to be
+      // complete on all processes before we can read from it
+      wait_for_checkpoint_write();
+
       // signal that de-serialization is going to happen
       this->signals.pre_distributed_load();
 
@@ -3811,6 +4020,11 @@ namespace parallel
     void
     Triangulation<dim, spacedim>::execute_coarsening_and_refinement()
     {
+      static const Instrumentation::Region region(
+        "parallel::distributed::Triangulation::"
+        "execute_coarsening_and_refinement");
+      Instrumentation::Scope scope(region);
+
       // do not allow anisotropic refinement
 #  ifdef DEBUG
       for (const auto &cell : this->active_cell_iterators())
@@ -5089,6 +5303,16 @@ namespace parallel
 
 
 
+    template <int spacedim>
+    Threads::Task<>
+    Triangulation<1, spacedim>::save_async(const std::string &) const
+    {
+      Assert(false, ExcNotImplemented());
+      return Threads::Task<>();
+    }
+
+
+
     template <int spacedim>
     bool
     Triangulation<1, spacedim>::is_multilevel_hierarchy_constructed() const
@@ -2215,6 +2215,10 @@ template <int dim, int spacedim>
 MappingQGeneric<dim, spacedim>::MappingQGeneric(const unsigned int p)
   : polynomial_degree(p)
   , line_support_points(this->polynomial_degree + 1)
+  , polynomials_1d(Polynomials::generate_complete_Lagrange_basis(
+      line_support_points.get_points()))
+  , renumber_lexicographic_to_hierarchic(
+      FETools::lexicographic_to_hierarchic_numbering<dim>(p))
   , support_point_weights_perimeter_to_interior(
       internal::MappingQGenericImplementation::
         compute_support_point_weights_perimeter_to_interior(
@@ -2236,6 +2240,9 @@ MappingQGeneric<dim, spacedim>::MappingQGeneric(
   const MappingQGeneric<dim, spacedim> &mapping)
   : polynomial_degree(mapping.polynomial_degree)
   , line_support_points(mapping.line_support_points)
+  , polynomials_1d(mapping.polynomials_1d)
+  , renumber_lexicographic_to_hierarchic(
+      mapping.renumber_lexicographic_to_hierarchic)
   , support_point_weights_perimeter_to_interior(
       mapping.support_point_weights_perimeter_to_interior)
   , support_point_weights_cell(mapping.support_point_weights_cell)
@@ -3293,6 +3300,63 @@ MappingQGeneric<dim, spacedim>::fill_fe_subface_values(
 
 
 
+template <int dim, int spacedim>
+void
+MappingQGeneric<dim, spacedim>::fill_mapping_data_for_generic_points(
+  const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+  const ArrayView<const Point<dim>> &                         unit_points,
+  const UpdateFlags                                           update_flags,
+  internal::FEValuesImplementation::MappingRelatedData<dim, spacedim>
+    &output_data) const
+{
+  Assert((update_flags & ~(update_quadrature_points | update_jacobians |
+                           update_inverse_jacobians)) == update_default,
+         ExcMessage("This function only supports the update flags "
+                    "update_quadrature_points, update_jacobians, and "
+                    "update_inverse_jacobians."));
+
+  if (update_flags == update_default)
+    return;
+
+  output_data.initialize(unit_points.size(), update_flags);
+
+  // convert the support points to tensors such that the point evaluation
+  // below can sum them up as a vector-valued polynomial
+  const std::vector<Point<spacedim>> support_points =
+    this->compute_mapping_support_points(cell);
+  std::vector<Tensor<1, spacedim>> support_point_tensors(
+    support_points.begin(), support_points.end());
+
+  for (unsigned int q = 0; q < unit_points.size(); ++q)
+    {
+      const std::pair<Tensor<1, spacedim>, Tensor<1, dim, Tensor<1, spacedim>>>
+        result = dealii::internal::evaluate_tensor_product_value_and_gradient(
+          polynomials_1d,
+          support_point_tensors,
+          unit_points[q],
+          renumber_lexicographic_to_hierarchic);
+
+      if (update_flags & update_quadrature_points)
+        output_data.quadrature_points[q] = Point<spacedim>(result.first);
+
+      if (update_flags & (update_jacobians | update_inverse_jacobians))
+        {
+          DerivativeForm<1, dim, spacedim> jacobian;
+          for (unsigned int d = 0; d < spacedim; ++d)
+            for (unsigned int e = 0; e < dim; ++e)
+              jacobian[d][e] = result.second[e][d];
+
+          if (update_flags & update_jacobians)
+            output_data.jacobians[q] = jacobian;
+          if (update_flags & update_inverse_jacobians)
+            output_data.inverse_jacobians[q] =
+              jacobian.covariant_form().transpose();
+        }
+    }
+}
+
+
+
 namespace internal
 {
   namespace MappingQGenericImplementation
@@ -15,6 +15,7 @@
 
 
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/path_search.h>
 #include <deal.II/base/utilities.h>
 
@@ -31,9 +32,22 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <fstream>
 #include <functional>
+#include <istream>
+#include <iterator>
+#include <locale>
 #include <map>
+#include <memory>
+#include <streambuf>
+
+#ifdef DEAL_II_HAVE_SYS_MMAN_H
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
 
 #ifdef DEAL_II_WITH_ASSIMP
 #  include <assimp/Importer.hpp>  // C++ importer interface
@@ -89,6 +103,379 @@ namespace
   }
 } // namespace
 
+
+namespace internal
+{
+  namespace GridInImplementation
+  {
+    /**
+     * A read-only view of the complete content of a file. Where supported by
+     * the operating system, the file is mapped into memory, so that its pages
+     * are only loaded once they are accessed and no copy is made. Otherwise,
+     * the file is read into a buffer in one piece.
+     */
+    class FileContent
+    {
+    public:
+      explicit FileContent(const std::string &filename)
+        : mapped_data(nullptr)
+        , mapped_size(0)
+      {
+#ifdef DEAL_II_HAVE_SYS_MMAN_H
+        const int file_descriptor = open(filename.c_str(), O_RDONLY);
+        AssertThrow(file_descriptor >= 0, ExcFileNotOpen(filename));
+
+        struct stat file_status;
+        if (fstat(file_descriptor, &file_status) == 0 &&
+            file_status.st_size > 0)
+          {
+            void *address = mmap(nullptr,
+                                 file_status.st_size,
+                                 PROT_READ,
+                                 MAP_PRIVATE,
+                                 file_descriptor,
+                                 0);
+            if (address != MAP_FAILED)
+              {
+                mapped_data = static_cast<const char *>(address);
+                mapped_size = file_status.st_size;
+              }
+          }
+        close(file_descriptor);
+
+        if (mapped_data != nullptr)
+          return;
+#endif
+
+        std::ifstream in(filename, std::ios::binary);
+        AssertThrow(in, ExcFileNotOpen(filename));
+        buffer.assign(std::istreambuf_iterator<char>(in),
+                      std::istreambuf_iterator<char>());
+      }
+
+      ~FileContent()
+      {
+#ifdef DEAL_II_HAVE_SYS_MMAN_H
+        if (mapped_data != nullptr)
+          munmap(const_cast<char *>(mapped_data), mapped_size);
+#endif
+      }
+
+      FileContent(const FileContent &) = delete;
+
+      FileContent &
+      operator=(const FileContent &) = delete;
+
+      const char *
+      begin() const
+      {
+        return mapped_data != nullptr ? mapped_data : buffer.data();
+      }
+
+      const char *
+      end() const
+      {
+        return begin() + (mapped_data != nullptr ? mapped_size : buffer.size());
+      }
+
+    private:
+      const char *      mapped_data;
+      std::size_t       mapped_size;
+      std::vector<char> buffer;
+    };
+
+
+
+    /**
+     * A stream buffer that reads from a range of characters without copying
+     * them, used to convert single tokens of a %Gmsh file into numbers.
+     */
+    class CharRangeStreamBuffer : public std::streambuf
+    {
+    public:
+      void
+      set_range(const char *begin, const char *end)
+      {
+        // the characters are only read, so casting away the const is safe
+        setg(const_cast<char *>(begin),
+             const_cast<char *>(begin),
+             const_cast<char *>(end));
+      }
+    };
+
+
+
+    /**
+     * A class to extract whitespace-separated tokens and binary data from a
+     * range of characters, as used by the reader for %Gmsh files in memory.
+     * Integers are converted directly. Floating point numbers are converted
+     * by a stream that uses the classic "C" locale, independently of the
+     * locale set by the program, since %Gmsh files always use a period as
+     * the decimal separator. This stream is created at the first conversion
+     * and then reused for all further tokens.
+     */
+    class MshTokenReader
+    {
+    public:
+      MshTokenReader(const char *begin, const char *end)
+        : current(begin)
+        , end(end)
+      {}
+
+      const char *
+      position() const
+      {
+        return current;
+      }
+
+      /**
+       * Return the next token as a string.
+       */
+      std::string
+      next_word()
+      {
+        skip_whitespace();
+        const char *start = current;
+        skip_token();
+        return std::string(start, current);
+      }
+
+      /**
+       * Return the next token converted to an integer.
+       */
+      template <typename Integer>
+      Integer
+      next_integer()
+      {
+        skip_whitespace();
+        const bool negative = (current != end && *current == '-');
+        if (current != end && (*current == '-' || *current == '+'))
+          ++current;
+        AssertThrow(current != end && *current >= '0' && *current <= '9',
+                    ExcMessage("Expected an integer in Gmsh file."));
+
+        std::uint64_t value = 0;
+        for (; current != end && *current >= '0' && *current <= '9';
+             ++current)
+          value = 10 * value + (*current - '0');
+        return negative ?
+                 static_cast<Integer>(-static_cast<std::int64_t>(value)) :
+                 static_cast<Integer>(value);
+      }
+
+      /**
+       * Return the next token converted to a floating point number.
+       */
+      double
+      next_double()
+      {
+        skip_whitespace();
+        const char *start = current;
+        skip_token();
+        AssertThrow(current != start,
+                    ExcMessage("Expected a number in Gmsh file."));
+
+        if (number_converter == nullptr)
+          number_converter = std::make_unique<NumberConverter>();
+        number_converter->buffer.set_range(start, current);
+        number_converter->stream.clear();
+
+        // the whole token must have been consumed by the conversion
+        double value = 0;
+        number_converter->stream >> value;
+        AssertThrow(!number_converter->stream.fail() &&
+                      number_converter->stream.peek() ==
+                        std::char_traits<char>::eof(),
+                    ExcMessage("Expected a number in Gmsh file."));
+        return value;
+      }
+
+      /**
+       * Return the next <code>sizeof(T)</code> bytes interpreted as an object
+       * of type T.
+       */
+      template <typename T>
+      T
+      next_binary()
+      {
+        AssertThrow(static_cast<std::size_t>(end - current) >= sizeof(T),
+                    ExcMessage("Unexpected end of binary Gmsh file."));
+        T value;
+        std::memcpy(&value, current, sizeof(T));
+        current += sizeof(T);
+        return value;
+      }
+
+      /**
+       * Skip the next @p n_tokens tokens without converting them.
+       */
+      void
+      skip_tokens(const std::size_t n_tokens)
+      {
+        for (std::size_t i = 0; i < n_tokens; ++i)
+          {
+            skip_whitespace();
+            AssertThrow(current != end,
+                        ExcMessage("Unexpected end of Gmsh file."));
+            skip_token();
+          }
+      }
+
+      /**
+       * Skip the next @p n_bytes bytes.
+       */
+      void
+      skip_bytes(const std::size_t n_bytes)
+      {
+        AssertThrow(static_cast<std::size_t>(end - current) >= n_bytes,
+                    ExcMessage("Unexpected end of binary Gmsh file."));
+        current += n_bytes;
+      }
+
+      /**
+       * Skip the line break that separates a section header from binary data.
+       */
+      void
+      skip_line_break()
+      {
+        if (current != end && *current == '\r')
+          ++current;
+        if (current != end && *current == '\n')
+          ++current;
+      }
+
+      /**
+       * Move to the position right after the next occurrence of @p marker.
+       */
+      void
+      skip_past(const std::string &marker)
+      {
+        const char *found =
+          std::search(current,
+                      end,
+                      marker.data(),
+                      marker.data() + marker.size());
+        AssertThrow(found != end,
+                    ExcMessage("Could not find <" + marker +
+                               "> in Gmsh file."));
+        current = found + marker.size();
+      }
+
+    private:
+      static bool
+      is_whitespace(const char c)
+      {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+      }
+
+      void
+      skip_whitespace()
+      {
+        while (current != end && is_whitespace(*current))
+          ++current;
+      }
+
+      void
+      skip_token()
+      {
+        while (current != end && !is_whitespace(*current))
+          ++current;
+      }
+
+      /**
+       * A stream reading from a buffer that is set to the token to be
+       * converted, using the classic "C" locale.
+       */
+      struct NumberConverter
+      {
+        NumberConverter()
+          : stream(&buffer)
+        {
+          stream.imbue(std::locale::classic());
+        }
+
+        CharRangeStreamBuffer buffer;
+        std::istream          stream;
+      };
+
+      const char *                     current;
+      const char *const                end;
+      std::unique_ptr<NumberConverter> number_converter;
+    };
+
+
+
+    /**
+     * Parse @p n_records records of a %Gmsh file, starting at the current
+     * position of @p reader, in parallel by calling
+     * <code>parse_record(index, record_reader)</code> for each record. For
+     * binary data, each record consists of @p bytes_per_record bytes and can
+     * be accessed directly. For ASCII data, each record consists of
+     * @p tokens_per_record tokens. Here, a serial pass over the records only
+     * determines the beginning of chunks of records, which is much cheaper
+     * than the conversion of the tokens into numbers that is then done in
+     * parallel. Upon return, @p reader is positioned after the last record.
+     */
+    template <typename Function>
+    void
+    parse_msh_records(MshTokenReader &   reader,
+                      const bool         binary,
+                      const std::size_t  n_records,
+                      const unsigned int tokens_per_record,
+                      const unsigned int bytes_per_record,
+                      const Function &   parse_record)
+    {
+      if (binary)
+        {
+          const char *start = reader.position();
+          reader.skip_bytes(n_records * bytes_per_record);
+          parallel::apply_to_subranges(
+            std::size_t(0),
+            n_records,
+            [&](const std::size_t begin, const std::size_t end) {
+              for (std::size_t record = begin; record < end; ++record)
+                {
+                  MshTokenReader record_reader(
+                    start + record * bytes_per_record,
+                    start + (record + 1) * bytes_per_record);
+                  parse_record(record, record_reader);
+                }
+            },
+            1024);
+        }
+      else
+        {
+          const std::size_t         chunk_size = 1024;
+          std::vector<const char *> chunk_starts;
+          for (std::size_t record = 0; record < n_records; record += chunk_size)
+            {
+              chunk_starts.push_back(reader.position());
+              reader.skip_tokens(std::min(chunk_size, n_records - record) *
+                                 tokens_per_record);
+            }
+          const char *end = reader.position();
+
+          parallel::apply_to_subranges(
+            std::size_t(0),
+            chunk_starts.size(),
+            [&](const std::size_t begin, const std::size_t end_chunk) {
+              for (std::size_t chunk = begin; chunk < end_chunk; ++chunk)
+                {
+                  MshTokenReader    chunk_reader(chunk_starts[chunk], end);
+                  const std::size_t end_record =
+                    std::min((chunk + 1) * chunk_size, n_records);
+                  for (std::size_t record = chunk * chunk_size;
+                       record < end_record;
+                       ++record)
+                    parse_record(record, chunk_reader);
+                }
+            },
+            1);
+        }
+    }
+  } // namespace GridInImplementation
+} // namespace internal
+
 template <int dim, int spacedim>
 GridIn<dim, spacedim>::GridIn()
   : tria(nullptr, typeid(*this).name())
@@ -2040,6 +2427,345 @@ GridIn<dim, spacedim>::read_msh(std::istream &in)
 
 
 
+template <int dim, int spacedim>
+void
+GridIn<dim, spacedim>::read_msh(const std::string &filename)
+{
+  Assert(tria != nullptr, ExcNoTriangulationSelected());
+
+  using internal::GridInImplementation::MshTokenReader;
+  using internal::GridInImplementation::parse_msh_records;
+
+  const internal::GridInImplementation::FileContent content(filename);
+  MshTokenReader reader(content.begin(), content.end());
+
+  // read the header and hand files in other versions than 4.1 to the
+  // stream-based reader
+  std::string  line    = reader.next_word();
+  const double version = (line == "$MeshFormat") ? reader.next_double() : 0.;
+  if (version != 4.1)
+    {
+      std::ifstream in(filename);
+      read_msh(in);
+      return;
+    }
+
+  const unsigned int file_type = reader.next_integer<unsigned int>();
+  const unsigned int data_size = reader.next_integer<unsigned int>();
+  AssertThrow(file_type == 0 || file_type == 1, ExcNotImplemented());
+  AssertThrow(data_size == sizeof(std::uint64_t), ExcNotImplemented());
+
+  const bool binary = (file_type == 1);
+  if (binary)
+    {
+      // the binary header contains the integer one to detect a mismatch in
+      // the byte order
+      reader.skip_line_break();
+      AssertThrow(reader.next_binary<int>() == 1,
+                  ExcMessage("The byte order of the binary Gmsh file <" +
+                             filename + "> is not supported."));
+    }
+  line = reader.next_word();
+  AssertThrow(line == "$EndMeshFormat", ExcInvalidGMSHInput(line));
+
+  const auto read_size = [&](MshTokenReader &r) -> std::uint64_t {
+    return binary ? r.next_binary<std::uint64_t>() :
+                    r.next_integer<std::uint64_t>();
+  };
+  const auto read_int = [&](MshTokenReader &r) -> int {
+    return binary ? r.next_binary<int>() : r.next_integer<int>();
+  };
+  const auto read_double = [&](MshTokenReader &r) -> double {
+    return binary ? r.next_binary<double>() : r.next_double();
+  };
+
+  // This array stores maps from the 'entities' to the 'physical tags' for
+  // points, curves, surfaces and volumes. We use this information later to
+  // assign material and boundary ids.
+  std::array<std::map<int, int>, 4> tag_maps;
+
+  std::vector<Point<spacedim>>               vertices;
+  std::vector<unsigned int>                  vertex_of_node_tag;
+  std::uint64_t                              min_node_tag = 0;
+  std::vector<CellData<dim>>                 cells;
+  SubCellData                                subcelldata;
+  std::map<unsigned int, types::boundary_id> boundary_ids_1d;
+
+  // translate a node tag of the file into the index of the vertex
+  const auto vertex_index = [&](const std::uint64_t node_tag,
+                                const std::size_t   cell) -> unsigned int {
+    const std::uint64_t index = node_tag - min_node_tag;
+    AssertThrow(node_tag >= min_node_tag &&
+                  index < vertex_of_node_tag.size() &&
+                  vertex_of_node_tag[index] != numbers::invalid_unsigned_int,
+                ExcInvalidVertexIndex(cell, node_tag));
+    return vertex_of_node_tag[index];
+  };
+
+  bool found_elements = false;
+  while (found_elements == false)
+    {
+      line = reader.next_word();
+      AssertThrow(!line.empty(), ExcGmshNoCellInformation());
+      if (binary && (line == "$Entities" || line == "$Nodes" ||
+                     line == "$Elements"))
+        reader.skip_line_break();
+
+      if (line == "$Entities")
+        {
+          std::uint64_t n_entities[4];
+          for (auto &n : n_entities)
+            n = read_size(reader);
+          for (unsigned int entity_dim = 0; entity_dim < 4; ++entity_dim)
+            for (std::uint64_t i = 0; i < n_entities[entity_dim]; ++i)
+              {
+                // we only care for 'tag' as key for tag_maps and skip the
+                // bounding box
+                const int tag = read_int(reader);
+                for (unsigned int d = 0; d < (entity_dim == 0 ? 3 : 6); ++d)
+                  read_double(reader);
+
+                // if there is a physical tag, we will use it as material or
+                // boundary id below, otherwise use 0 as default
+                const std::uint64_t n_physicals = read_size(reader);
+                AssertThrow(n_physicals < 2,
+                            ExcMessage("More than one tag is not supported!"));
+                int physical_tag = 0;
+                for (std::uint64_t j = 0; j < n_physicals; ++j)
+                  physical_tag = read_int(reader);
+                tag_maps[entity_dim][tag] = physical_tag;
+
+                // skip the bounding entities
+                if (entity_dim > 0)
+                  {
+                    const std::uint64_t n_bounding = read_size(reader);
+                    for (std::uint64_t j = 0; j < n_bounding; ++j)
+                      read_int(reader);
+                  }
+              }
+          line = reader.next_word();
+          AssertThrow(line == "$EndEntities", ExcInvalidGMSHInput(line));
+        }
+      else if (line == "$Nodes")
+        {
+          const std::uint64_t n_blocks = read_size(reader);
+          const std::uint64_t n_nodes  = read_size(reader);
+          min_node_tag                 = read_size(reader);
+          const std::uint64_t max_node_tag = read_size(reader);
+
+          vertices.resize(n_nodes);
+          if (n_nodes > 0)
+            vertex_of_node_tag.assign(max_node_tag - min_node_tag + 1,
+                                      numbers::invalid_unsigned_int);
+
+          std::size_t offset = 0;
+          for (std::uint64_t block = 0; block < n_blocks; ++block)
+            {
+              const int           entity_dim = read_int(reader);
+              const int           entity_tag = read_int(reader);
+              const int           parametric = read_int(reader);
+              const std::uint64_t n_block_nodes = read_size(reader);
+              (void)entity_tag;
+              AssertThrow(offset + n_block_nodes <= n_nodes,
+                          ExcMessage("Invalid number of nodes in Gmsh file."));
+
+              // first all node tags of the block, then all coordinates,
+              // possibly followed by parametric coordinates we ignore
+              parse_msh_records(
+                reader,
+                binary,
+                n_block_nodes,
+                1,
+                sizeof(std::uint64_t),
+                [&](const std::size_t i, MshTokenReader &r) {
+                  const std::uint64_t node_tag = read_size(r);
+                  AssertThrow(node_tag >= min_node_tag &&
+                                node_tag <= max_node_tag,
+                              ExcMessage("Invalid node tag in Gmsh file."));
+                  vertex_of_node_tag[node_tag - min_node_tag] = offset + i;
+                });
+
+              const unsigned int n_coordinates =
+                3 + (parametric != 0 ? entity_dim : 0);
+              parse_msh_records(
+                reader,
+                binary,
+                n_block_nodes,
+                n_coordinates,
+                n_coordinates * sizeof(double),
+                [&](const std::size_t i, MshTokenReader &r) {
+                  double x[3];
+                  for (double &coordinate : x)
+                    coordinate = read_double(r);
+                  for (unsigned int d = 3; d < n_coordinates; ++d)
+                    read_double(r);
+                  for (unsigned int d = 0; d < spacedim; ++d)
+                    vertices[offset + i][d] = x[d];
+                });
+
+              offset += n_block_nodes;
+            }
+          AssertDimension(offset, n_nodes);
+
+          line = reader.next_word();
+          AssertThrow(line == "$EndNodes", ExcInvalidGMSHInput(line));
+        }
+      else if (line == "$Elements")
+        {
+          const std::uint64_t n_blocks = read_size(reader);
+          read_size(reader); // number of elements
+          read_size(reader); // minimal element tag
+          read_size(reader); // maximal element tag
+
+          for (std::uint64_t block = 0; block < n_blocks; ++block)
+            {
+              const int           entity_dim = read_int(reader);
+              const int           entity_tag = read_int(reader);
+              const int           cell_type  = read_int(reader);
+              const std::uint64_t n_elements = read_size(reader);
+
+              AssertThrow(entity_dim >= 0 && entity_dim < 4,
+                          ExcMessage("Invalid entity dimension in Gmsh file."));
+              const auto physical_tag = tag_maps[entity_dim].find(entity_tag);
+              const unsigned int material_id =
+                (physical_tag != tag_maps[entity_dim].end()) ?
+                  physical_tag->second :
+                  0;
+
+              /*       `ELM-TYPE'
+                       defines the geometrical type of the element:
+                       `1'
+                       Line (2 nodes, 1 edge).
+
+                       `3'
+                       Quadrangle (4 nodes, 4 edges).
+
+                       `5'
+                       Hexahedron (8 nodes, 12 edges, 6 faces).
+
+                       `15'
+                       Point (1 node).
+              */
+              unsigned int n_element_nodes = 0;
+              if (cell_type == 1)
+                n_element_nodes = 2;
+              else if (cell_type == 3)
+                n_element_nodes = 4;
+              else if (cell_type == 5)
+                n_element_nodes = 8;
+              else if (cell_type == 15)
+                n_element_nodes = 1;
+              else
+                {
+                  AssertThrow(cell_type != 2,
+                              ExcMessage("Found triangles while reading a file "
+                                         "in gmsh format. deal.II does not "
+                                         "support triangles"));
+                  AssertThrow(cell_type != 11,
+                              ExcMessage("Found tetrahedra while reading a "
+                                         "file in gmsh format. deal.II does "
+                                         "not support tetrahedra"));
+                  AssertThrow(false, ExcGmshUnsupportedGeometry(cell_type));
+                }
+
+              // read the element tag and the node tags of each element into
+              // the given array of cells or faces, with the material or
+              // boundary id set for all of them
+              const auto parse_elements = [&](auto &objects) {
+                const std::size_t offset = objects.size();
+                objects.resize(offset + n_elements);
+                for (std::size_t i = offset; i < objects.size(); ++i)
+                  objects[i].material_id = material_id;
+
+                parse_msh_records(
+                  reader,
+                  binary,
+                  n_elements,
+                  1 + n_element_nodes,
+                  (1 + n_element_nodes) * sizeof(std::uint64_t),
+                  [&](const std::size_t i, MshTokenReader &r) {
+                    read_size(r); // element tag
+                    auto &object = objects[offset + i];
+                    for (unsigned int v = 0; v < n_element_nodes; ++v)
+                      object.vertices[v] =
+                        vertex_index(read_size(r), offset + i);
+                  });
+              };
+
+              if ((cell_type == 1 && dim == 1) ||
+                  (cell_type == 3 && dim == 2) || (cell_type == 5 && dim == 3))
+                {
+                  // we use only material_ids in the range from 0 to
+                  // numbers::invalid_material_id-1
+                  AssertIndexRange(material_id, numbers::invalid_material_id);
+                  parse_elements(cells);
+                }
+              else if ((cell_type == 1 && dim > 1) ||
+                       (cell_type == 3 && dim == 3))
+                {
+                  // we use only boundary_ids in the range from 0 to
+                  // numbers::internal_face_boundary_id-1
+                  AssertIndexRange(material_id,
+                                   numbers::internal_face_boundary_id);
+                  if (cell_type == 1)
+                    parse_elements(subcelldata.boundary_lines);
+                  else
+                    parse_elements(subcelldata.boundary_quads);
+                }
+              else if (cell_type == 15)
+                {
+                  // we only care about boundary indicators assigned to
+                  // individual vertices in 1d (because otherwise the
+                  // vertices are not faces)
+                  for (std::uint64_t i = 0; i < n_elements; ++i)
+                    {
+                      read_size(reader); // element tag
+                      const std::uint64_t node_tag = read_size(reader);
+                      if (dim == 1)
+                        boundary_ids_1d[vertex_index(node_tag, i)] =
+                          material_id;
+                    }
+                }
+              else
+                AssertThrow(false, ExcGmshUnsupportedGeometry(cell_type));
+            }
+
+          line = reader.next_word();
+          AssertThrow(line == "$EndElements", ExcInvalidGMSHInput(line));
+          found_elements = true;
+        }
+      else
+        {
+          // skip all other sections, like $PhysicalNames or
+          // $PartitionedEntities
+          AssertThrow(line[0] == '$', ExcInvalidGMSHInput(line));
+          reader.skip_past("$End" + line.substr(1));
+        }
+    }
+
+  // check that no forbidden arrays are used
+  Assert(subcelldata.check_consistency(dim), ExcInternalError());
+
+  // check that we actually read some cells.
+  AssertThrow(cells.size() > 0, ExcGmshNoCellInformation());
+
+  // do some clean-up on vertices...
+  GridTools::delete_unused_vertices(vertices, cells, subcelldata);
+  // ... and cells
+  if (dim == spacedim)
+    GridReordering<dim, spacedim>::invert_all_cells_of_negative_grid(vertices,
+                                                                     cells);
+  GridReordering<dim, spacedim>::reorder_cells(cells);
+  tria->create_triangulation_compatibility(vertices, cells, subcelldata);
+
+  // in 1d, we also have to attach boundary ids to vertices, which does not
+  // currently work through the call above
+  if (dim == 1)
+    assign_1d_boundary_ids(boundary_ids_1d, *tria);
+}
+
+
+
 template <int dim, int spacedim>
 void
 GridIn<dim, spacedim>::parse_tecplot_header(
@@ -2896,8 +3622,6 @@ GridIn<dim, spacedim>::read(const std::string &filename, Format format)
   else
     name = search.find(filename, default_suffix(format));
 
-  std::ifstream in(name.c_str());
-
   if (format == Default)
     {
       const std::string::size_type slashpos = name.find_last_of('/');
@@ -2909,6 +3633,16 @@ GridIn<dim, spacedim>::read(const std::string &filename, Format format)
           format          = parse_format(ext);
         }
     }
+
+  // Gmsh files are read directly from the file, which allows to map the
+  // file into memory and to parse large files in parallel
+  if (format == msh || (format == Default && default_format == msh))
+    {
+      read_msh(name);
+      return;
+    }
+
+  std::ifstream in(name.c_str());
   read(in, format);
 }
 
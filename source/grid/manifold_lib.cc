@@ -15,6 +15,7 @@
 
 #include <deal.II/base/table.h>
 #include <deal.II/base/tensor.h>
+#include <deal.II/base/vectorization.h>
 
 #include <deal.II/fe/mapping.h>
 
@@ -26,6 +27,7 @@
 #include <deal.II/lac/vector.h>
 
 #include <cmath>
+#include <functional>
 #include <memory>
 
 DEAL_II_NAMESPACE_OPEN
@@ -1633,6 +1635,40 @@ TorusManifold<dim>::push_forward_gradient(const Point<3> &chart_point) const
 // ============================================================
 // TransfiniteInterpolationManifold
 // ============================================================
+namespace
+{
+  // create the key into the cache of chart points of
+  // TransfiniteInterpolationManifold, consisting of the index of the coarse
+  // cell and the coordinates of the point
+  template <int spacedim>
+  std::pair<unsigned int, std::array<double, spacedim>>
+  make_chart_point_key(const unsigned int      coarse_cell_index,
+                       const Point<spacedim> &point)
+  {
+    std::array<double, spacedim> coordinates;
+    for (unsigned int d = 0; d < spacedim; ++d)
+      coordinates[d] = point[d];
+    return std::make_pair(coarse_cell_index, coordinates);
+  }
+
+  // select the part of the cache of chart points of
+  // TransfiniteInterpolationManifold by a hash of the key
+  template <int spacedim>
+  std::size_t
+  chart_point_cache_shard(
+    const std::pair<unsigned int, std::array<double, spacedim>> &key,
+    const std::size_t                                            n_shards)
+  {
+    std::size_t hash = std::hash<unsigned int>()(key.first);
+    for (unsigned int d = 0; d < spacedim; ++d)
+      hash ^= std::hash<double>()(key.second[d]) + 0x9e3779b9 + (hash << 6) +
+              (hash >> 2);
+    return hash % n_shards;
+  }
+} // namespace
+
+
+
 template <int dim, int spacedim>
 TransfiniteInterpolationManifold<dim,
                                  spacedim>::TransfiniteInterpolationManifold()
@@ -1650,6 +1686,8 @@ TransfiniteInterpolationManifold<dim,
 {
   if (clear_signal.connected())
     clear_signal.disconnect();
+  if (any_change_signal.connected())
+    any_change_signal.disconnect();
 }
 
 
@@ -1677,9 +1715,16 @@ TransfiniteInterpolationManifold<dim, spacedim>::initialize(
   clear_signal = triangulation.signals.clear.connect([&]() -> void {
     this->triangulation = nullptr;
     this->level_coarse  = -1;
+    this->reset_chart_point_cache();
   });
+  // the cached chart points are only kept during one refinement step or
+  // between two changes of the mesh
+  any_change_signal.disconnect();
+  any_change_signal = triangulation.signals.any_change.connect(
+    [&]() -> void { this->reset_chart_point_cache(); });
   level_coarse = triangulation.last()->level();
   coarse_cell_is_flat.resize(triangulation.n_cells(level_coarse), false);
+  reset_chart_point_cache();
   typename Triangulation<dim, spacedim>::active_cell_iterator
     cell = triangulation.begin(level_coarse),
     endc = triangulation.end(level_coarse);
@@ -1703,6 +1748,109 @@ TransfiniteInterpolationManifold<dim, spacedim>::initialize(
 
 
 
+template <int dim, int spacedim>
+bool
+TransfiniteInterpolationManifold<dim, spacedim>::find_in_chart_point_cache(
+  const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+  const Point<spacedim> &                                     point,
+  Point<dim> &                                                chart_point) const
+{
+  if (!coarse_cell_matches_chart_point_cache(cell))
+    return false;
+
+  const auto        key         = make_chart_point_key(cell->index(), point);
+  const std::size_t shard_index =
+    chart_point_cache_shard<spacedim>(key, chart_point_cache.size());
+
+  ChartPointCacheShard &      shard = chart_point_cache[shard_index];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  const auto                  entry = shard.chart_points.find(key);
+  if (entry == shard.chart_points.end())
+    return false;
+  chart_point = entry->second;
+  return true;
+}
+
+
+
+template <int dim, int spacedim>
+void
+TransfiniteInterpolationManifold<dim, spacedim>::add_to_chart_point_cache(
+  const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+  const Point<spacedim> &                                     point,
+  const Point<dim> &                                          chart_point) const
+{
+  if (!coarse_cell_matches_chart_point_cache(cell))
+    return;
+
+  const auto        key         = make_chart_point_key(cell->index(), point);
+  const std::size_t shard_index =
+    chart_point_cache_shard<spacedim>(key, chart_point_cache.size());
+
+  ChartPointCacheShard &      shard = chart_point_cache[shard_index];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.chart_points.emplace(key, chart_point);
+}
+
+
+
+template <int dim, int spacedim>
+bool
+TransfiniteInterpolationManifold<dim, spacedim>::
+  coarse_cell_matches_chart_point_cache(
+    const typename Triangulation<dim, spacedim>::cell_iterator &cell) const
+{
+  const std::size_t first_vertex =
+    static_cast<std::size_t>(cell->index()) *
+    GeometryInfo<dim>::vertices_per_cell;
+  if (first_vertex + GeometryInfo<dim>::vertices_per_cell >
+      chart_point_cache_coarse_vertices.size())
+    return false;
+  for (const unsigned int v : GeometryInfo<dim>::vertex_indices())
+    if (cell->vertex(v) != chart_point_cache_coarse_vertices[first_vertex + v])
+      return false;
+  return true;
+}
+
+
+
+template <int dim, int spacedim>
+void
+TransfiniteInterpolationManifold<dim, spacedim>::reset_chart_point_cache()
+{
+  for (ChartPointCacheShard &shard : chart_point_cache)
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.chart_points.clear();
+    }
+
+  chart_point_cache_coarse_vertices.clear();
+  if (triangulation == nullptr || level_coarse < 0 ||
+      static_cast<unsigned int>(level_coarse) >= triangulation->n_levels())
+    return;
+
+  chart_point_cache_coarse_vertices.resize(
+    triangulation->n_cells(level_coarse) *
+    GeometryInfo<dim>::vertices_per_cell);
+  for (const auto &cell : triangulation->cell_iterators_on_level(level_coarse))
+    {
+      for (const unsigned int v : GeometryInfo<dim>::vertex_indices())
+        chart_point_cache_coarse_vertices
+          [static_cast<std::size_t>(cell->index()) *
+             GeometryInfo<dim>::vertices_per_cell +
+           v] = cell->vertex(v);
+
+      // the vertices of the coarse cell are the vertices of the unit cell in
+      // the chart of the cell
+      for (const unsigned int v : GeometryInfo<dim>::vertex_indices())
+        add_to_chart_point_cache(cell,
+                                 cell->vertex(v),
+                                 GeometryInfo<dim>::unit_cell_vertex(v));
+    }
+}
+
+
+
 namespace
 {
   // version for 1D
@@ -2010,6 +2158,54 @@ namespace
       }
     return new_point;
   }
+
+
+
+  // version for cells without curved lines or faces, where the transfinite
+  // interpolation reduces to the multilinear interpolation of the vertices.
+  // Several chart points are processed at once with VectorizedArray, the
+  // order of operations is the same as in the scalar versions above.
+  template <int dim, int spacedim>
+  void
+  compute_flat_transfinite_interpolation(
+    const std::array<Point<spacedim>, GeometryInfo<dim>::vertices_per_cell>
+      &                                vertices,
+    const ArrayView<const Point<dim>> &chart_points,
+    const ArrayView<Point<spacedim>> & new_points)
+  {
+    AssertDimension(chart_points.size(), new_points.size());
+    constexpr unsigned int n_lanes = VectorizedArray<double>::size();
+
+    for (unsigned int offset = 0; offset < chart_points.size();
+         offset += n_lanes)
+      {
+        const unsigned int n_filled =
+          std::min<unsigned int>(n_lanes, chart_points.size() - offset);
+
+        // fill the unused lanes with the first point to stay in the unit cell
+        Point<dim, VectorizedArray<double>> chart_point;
+        for (unsigned int d = 0; d < dim; ++d)
+          for (unsigned int v = 0; v < n_lanes; ++v)
+            chart_point[d][v] = chart_points[offset + (v < n_filled ? v : 0)][d];
+
+        Point<spacedim, VectorizedArray<double>> new_point;
+        for (const unsigned int v : GeometryInfo<dim>::vertex_indices())
+          {
+            VectorizedArray<double> weight = (v & (1 << (dim - 1))) ?
+                                               chart_point[dim - 1] :
+                                               1. - chart_point[dim - 1];
+            for (int d = dim - 2; d >= 0; --d)
+              weight *=
+                (v & (1 << d)) ? chart_point[d] : 1. - chart_point[d];
+            for (unsigned int e = 0; e < spacedim; ++e)
+              new_point[e] += weight * vertices[v][e];
+          }
+
+        for (unsigned int v = 0; v < n_filled; ++v)
+          for (unsigned int e = 0; e < spacedim; ++e)
+            new_points[offset + v][e] = new_point[e][v];
+      }
+  }
 } // namespace
 
 
@@ -2431,6 +2627,13 @@ TransfiniteInterpolationManifold<dim, spacedim>::compute_chart_points(
   auto compute_chart_point =
     [&](const typename Triangulation<dim, spacedim>::cell_iterator &cell,
         const unsigned int point_index) {
+      // look for the point among the points for which we have computed the
+      // chart point before
+      if (find_in_chart_point_cache(cell,
+                                    surrounding_points[point_index],
+                                    chart_points[point_index]))
+        return;
+
       Point<dim> guess;
       // an optimization: keep track of whether or not we used the affine
       // approximation so that we don't call pull_back with the same
@@ -2494,6 +2697,10 @@ TransfiniteInterpolationManifold<dim, spacedim>::compute_chart_points(
           chart_points[point_index] =
             pull_back(cell, surrounding_points[point_index], guess);
         }
+
+      add_to_chart_point_cache(cell,
+                               surrounding_points[point_index],
+                               chart_points[point_index]);
     };
 
   // check whether all points are inside the unit cell of the current chart
@@ -2576,7 +2783,14 @@ TransfiniteInterpolationManifold<dim, spacedim>::get_new_point(
   const Point<dim> p_chart =
     chart_manifold.get_new_point(chart_points_view, weights);
 
-  return push_forward(cell, p_chart);
+  const Point<spacedim> new_point = push_forward(cell, p_chart);
+
+  // this function is called when the triangulation creates new vertices,
+  // which are the surrounding points in the next refinement step, so we
+  // remember the chart point
+  add_to_chart_point_cache(cell, new_point, p_chart);
+
+  return new_point;
 }
 
 
@@ -2604,8 +2818,25 @@ TransfiniteInterpolationManifold<dim, spacedim>::get_new_points(
                                 make_array_view(new_points_on_chart.begin(),
                                                 new_points_on_chart.end()));
 
-  for (unsigned int row = 0; row < weights.size(0); ++row)
-    new_points[row] = push_forward(cell, new_points_on_chart[row]);
+  if (coarse_cell_is_flat[cell->index()])
+    {
+      for (unsigned int row = 0; row < weights.size(0); ++row)
+        Assert(GeometryInfo<dim>::is_inside_unit_cell(new_points_on_chart[row],
+                                                      5e-4),
+               ExcMessage("chart_point is not in unit interval"));
+
+      std::array<Point<spacedim>, GeometryInfo<dim>::vertices_per_cell>
+        vertices;
+      for (const unsigned int v : GeometryInfo<dim>::vertex_indices())
+        vertices[v] = cell->vertex(v);
+      compute_flat_transfinite_interpolation<dim, spacedim>(
+        vertices,
+        make_array_view(new_points_on_chart.begin(), new_points_on_chart.end()),
+        new_points);
+    }
+  else
+    for (unsigned int row = 0; row < weights.size(0); ++row)
+      new_points[row] = push_forward(cell, new_points_on_chart[row]);
 }
 
 
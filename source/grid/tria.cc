@@ -15,6 +15,7 @@
 
 
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/instrumentation.h>
 #include <deal.II/base/memory_consumption.h>
 
 #include <deal.II/fe/mapping_q1.h>
@@ -13603,6 +13604,10 @@ template <int dim, int spacedim>
 void
 Triangulation<dim, spacedim>::execute_coarsening_and_refinement()
 {
+  static const Instrumentation::Region region(
+    "Triangulation::execute_coarsening_and_refinement");
+  Instrumentation::Scope scope(region);
+
   prepare_coarsening_and_refinement();
 
   // verify a case with which we have had
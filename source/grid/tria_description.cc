@@ -15,6 +15,7 @@
 
 #include <deal.II/base/geometry_info.h>
 #include <deal.II/base/mpi.h>
+#include <deal.II/base/mpi_consensus_algorithms.h>
 
 #include <deal.II/distributed/tria.h>
 
@@ -25,6 +26,8 @@
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_description.h>
 
+#include <fstream>
+
 DEAL_II_NAMESPACE_OPEN
 
 
@@ -528,6 +531,466 @@ namespace TriangulationDescription
 #endif
     }
 
+
+    namespace
+    {
+      /**
+       * Identifier at the beginning of a file in the binary coarse-mesh
+       * format.
+       */
+      const char binary_coarse_mesh_identifier[8] =
+        {'d', 'e', 'a', 'l', 'I', 'I', 'c', 'm'};
+
+      /**
+       * Number of line manifold ids in the record of a single cell in the
+       * binary coarse-mesh format. In 1D, the only line is the cell itself,
+       * whose manifold id is stored anyway.
+       */
+      template <int dim>
+      constexpr unsigned int
+      binary_cell_record_n_line_manifold_ids()
+      {
+        return dim >= 2 ? GeometryInfo<dim>::lines_per_cell : 0;
+      }
+
+      /**
+       * Number of face manifold ids in the record of a single cell in the
+       * binary coarse-mesh format, which are only stored in 3D, since the
+       * faces are the lines of the cell in 2D.
+       */
+      template <int dim>
+      constexpr unsigned int
+      binary_cell_record_n_quad_manifold_ids()
+      {
+        return dim == 3 ? GeometryInfo<dim>::faces_per_cell : 0;
+      }
+
+      /**
+       * Number of integers in the record of a single cell in the binary
+       * coarse-mesh format.
+       */
+      template <int dim>
+      constexpr unsigned int
+      binary_cell_record_size()
+      {
+        return GeometryInfo<dim>::vertices_per_cell + 2 +
+               GeometryInfo<dim>::faces_per_cell +
+               binary_cell_record_n_line_manifold_ids<dim>() +
+               binary_cell_record_n_quad_manifold_ids<dim>();
+      }
+
+      /**
+       * Return the first index of the range assigned to process @p rank if
+       * @p n_entries entries are split into @p n_ranks contiguous ranges of
+       * (almost) the same size.
+       */
+      std::uint64_t
+      first_index_of_rank(const std::uint64_t n_entries,
+                          const unsigned int  rank,
+                          const unsigned int  n_ranks)
+      {
+        return n_entries * rank / n_ranks;
+      }
+
+      /**
+       * Return the rank of the process the entry @p index is assigned to by
+       * first_index_of_rank().
+       */
+      unsigned int
+      rank_of_index(const std::uint64_t index,
+                    const std::uint64_t n_entries,
+                    const unsigned int  n_ranks)
+      {
+        return ((index + 1) * n_ranks - 1) / n_entries;
+      }
+
+      /**
+       * Read the records with the given sorted @p indices from a block of
+       * records that starts at position @p offset of the file, where each
+       * record consists of @p record_size numbers of type T. Runs of
+       * consecutive indices are read with a single read operation.
+       */
+      template <typename T>
+      std::vector<T>
+      read_binary_records(std::ifstream &                   file,
+                          const std::streamoff              offset,
+                          const unsigned int                record_size,
+                          const std::vector<std::uint64_t> &indices)
+      {
+        std::vector<T> data(indices.size() * record_size);
+        for (std::size_t i = 0; i < indices.size();)
+          {
+            std::size_t end = i + 1;
+            while (end < indices.size() && indices[end] == indices[end - 1] + 1)
+              ++end;
+
+            file.seekg(offset + static_cast<std::streamoff>(
+                                  indices[i] * record_size * sizeof(T)));
+            file.read(reinterpret_cast<char *>(data.data() + i * record_size),
+                      (end - i) * record_size * sizeof(T));
+            AssertThrow(file, ExcIO());
+
+            i = end;
+          }
+        return data;
+      }
+    } // namespace
+
+
+
+    template <int dim, int spacedim>
+    Description<dim, spacedim>
+    create_description_from_binary_coarse_mesh(
+      const std::string &                                        filename,
+      const MPI_Comm                                             comm,
+      const typename Triangulation<dim, spacedim>::MeshSmoothing smoothing,
+      const TriangulationDescription::Settings                   settings)
+    {
+      using index_type = types::global_vertex_index;
+
+      const unsigned int my_rank =
+        dealii::Utilities::MPI::this_mpi_process(comm);
+      const unsigned int n_ranks =
+        dealii::Utilities::MPI::n_mpi_processes(comm);
+
+      constexpr unsigned int vertices_per_cell =
+        GeometryInfo<dim>::vertices_per_cell;
+      constexpr unsigned int line_manifold_ids_offset =
+        vertices_per_cell + 2 + GeometryInfo<dim>::faces_per_cell;
+      constexpr unsigned int quad_manifold_ids_offset =
+        line_manifold_ids_offset +
+        binary_cell_record_n_line_manifold_ids<dim>();
+      constexpr unsigned int record_size = binary_cell_record_size<dim>();
+
+      // 1) read the header and the records of the locally owned cells
+      std::ifstream file(filename, std::ios::binary);
+      AssertThrow(file, ExcFileNotOpen(filename));
+
+      char          identifier[8];
+      std::uint64_t header[4];
+      file.read(identifier, sizeof(identifier));
+      file.read(reinterpret_cast<char *>(header), sizeof(header));
+      AssertThrow(file && std::equal(identifier,
+                                     identifier + sizeof(identifier),
+                                     binary_coarse_mesh_identifier),
+                  ExcMessage("The file <" + filename +
+                             "> is not in the binary coarse-mesh format."));
+      AssertThrow(header[0] == dim && header[1] == spacedim,
+                  ExcMessage("The dimensions of the mesh in the file <" +
+                             filename +
+                             "> do not match the template arguments."));
+
+      const std::uint64_t  n_vertices    = header[2];
+      const std::uint64_t  n_cells       = header[3];
+      const std::streamoff vertex_offset = sizeof(identifier) + sizeof(header);
+      const std::streamoff cell_offset =
+        vertex_offset + n_vertices * spacedim * sizeof(double);
+
+      std::vector<std::uint64_t> owned_cells;
+      for (std::uint64_t cell = first_index_of_rank(n_cells, my_rank, n_ranks);
+           cell < first_index_of_rank(n_cells, my_rank + 1, n_ranks);
+           ++cell)
+        owned_cells.push_back(cell);
+
+      const std::vector<std::uint64_t> owned_records =
+        read_binary_records<std::uint64_t>(file,
+                                           cell_offset,
+                                           record_size,
+                                           owned_cells);
+
+      // 2) register the locally owned cells in a distributed dictionary of
+      //    vertices, where each process stores the cells around the
+      //    vertices of a contiguous range of vertex indices
+      const std::uint64_t first_dictionary_vertex =
+        first_index_of_rank(n_vertices, my_rank, n_ranks);
+      std::vector<std::vector<std::uint64_t>> cells_around_vertex(
+        first_index_of_rank(n_vertices, my_rank + 1, n_ranks) -
+        first_dictionary_vertex);
+
+      {
+        // pairs of vertex and cell index to be registered
+        std::map<unsigned int, std::vector<index_type>> registrations;
+        for (std::size_t c = 0; c < owned_cells.size(); ++c)
+          for (unsigned int v = 0; v < vertices_per_cell; ++v)
+            {
+              const std::uint64_t vertex = owned_records[c * record_size + v];
+              AssertThrow(vertex < n_vertices,
+                          ExcMessage("The file <" + filename +
+                                     "> contains an invalid vertex index."));
+
+              auto &buffer =
+                registrations[rank_of_index(vertex, n_vertices, n_ranks)];
+              buffer.push_back(vertex);
+              buffer.push_back(owned_cells[c]);
+            }
+
+        const auto add_to_dictionary =
+          [&](const std::vector<index_type> &buffer) {
+            for (std::size_t i = 0; i < buffer.size(); i += 2)
+              cells_around_vertex[buffer[i] - first_dictionary_vertex]
+                .push_back(buffer[i + 1]);
+          };
+
+        // the vertices owned by this process are registered directly
+        // without communication
+        const auto local = registrations.find(my_rank);
+        if (local != registrations.end())
+          add_to_dictionary(local->second);
+
+        dealii::Utilities::MPI::ConsensusAlgorithms::
+          AnonymousProcess<index_type, unsigned int>
+            process(
+              [&]() {
+                std::vector<unsigned int> targets;
+                for (const auto &rank_and_buffer : registrations)
+                  if (rank_and_buffer.first != my_rank)
+                    targets.push_back(rank_and_buffer.first);
+                return targets;
+              },
+              [&](const unsigned int       other_rank,
+                  std::vector<index_type> &send_buffer) {
+                send_buffer.swap(registrations[other_rank]);
+              },
+              [&](const unsigned int,
+                  const std::vector<index_type> &buffer_recv,
+                  std::vector<unsigned int> &) {
+                add_to_dictionary(buffer_recv);
+              });
+
+        dealii::Utilities::MPI::ConsensusAlgorithms::
+          Selector<index_type, unsigned int>(process, comm)
+            .run();
+      }
+
+      // 3) for each vertex of the dictionary that is shared between several
+      //    processes, send the cells around it to each of these processes,
+      //    where the cells owned by other processes become ghost cells
+      std::vector<std::uint64_t> ghost_cells;
+      {
+        std::map<unsigned int, std::vector<index_type>> notifications;
+        std::vector<unsigned int>                       ranks;
+        for (const auto &cells : cells_around_vertex)
+          {
+            ranks.clear();
+            for (const auto cell : cells)
+              ranks.push_back(rank_of_index(cell, n_cells, n_ranks));
+            std::sort(ranks.begin(), ranks.end());
+            ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+
+            if (ranks.size() > 1)
+              for (const auto rank : ranks)
+                for (const auto cell : cells)
+                  if (rank_of_index(cell, n_cells, n_ranks) != rank)
+                    notifications[rank].push_back(cell);
+          }
+        cells_around_vertex.clear();
+
+        for (auto &rank_and_buffer : notifications)
+          {
+            auto &buffer = rank_and_buffer.second;
+            std::sort(buffer.begin(), buffer.end());
+            buffer.erase(std::unique(buffer.begin(), buffer.end()),
+                         buffer.end());
+          }
+
+        const auto local = notifications.find(my_rank);
+        if (local != notifications.end())
+          ghost_cells.insert(ghost_cells.end(),
+                             local->second.begin(),
+                             local->second.end());
+
+        dealii::Utilities::MPI::ConsensusAlgorithms::
+          AnonymousProcess<index_type, unsigned int>
+            process(
+              [&]() {
+                std::vector<unsigned int> targets;
+                for (const auto &rank_and_buffer : notifications)
+                  if (rank_and_buffer.first != my_rank)
+                    targets.push_back(rank_and_buffer.first);
+                return targets;
+              },
+              [&](const unsigned int       other_rank,
+                  std::vector<index_type> &send_buffer) {
+                send_buffer.swap(notifications[other_rank]);
+              },
+              [&](const unsigned int,
+                  const std::vector<index_type> &buffer_recv,
+                  std::vector<unsigned int> &) {
+                ghost_cells.insert(ghost_cells.end(),
+                                   buffer_recv.begin(),
+                                   buffer_recv.end());
+              });
+
+        dealii::Utilities::MPI::ConsensusAlgorithms::
+          Selector<index_type, unsigned int>(process, comm)
+            .run();
+
+        std::sort(ghost_cells.begin(), ghost_cells.end());
+        ghost_cells.erase(std::unique(ghost_cells.begin(), ghost_cells.end()),
+                          ghost_cells.end());
+      }
+
+      // 4) read the records of the ghost cells and the coordinates of the
+      //    vertices of all locally relevant cells
+      const std::vector<std::uint64_t> ghost_records =
+        read_binary_records<std::uint64_t>(file,
+                                           cell_offset,
+                                           record_size,
+                                           ghost_cells);
+
+      std::vector<std::pair<std::uint64_t, const std::uint64_t *>>
+        relevant_cells;
+      for (std::size_t c = 0; c < owned_cells.size(); ++c)
+        relevant_cells.emplace_back(owned_cells[c],
+                                    owned_records.data() + c * record_size);
+      for (std::size_t c = 0; c < ghost_cells.size(); ++c)
+        relevant_cells.emplace_back(ghost_cells[c],
+                                    ghost_records.data() + c * record_size);
+      std::sort(relevant_cells.begin(), relevant_cells.end());
+
+      std::vector<std::uint64_t> relevant_vertices;
+      for (const auto &cell : relevant_cells)
+        relevant_vertices.insert(relevant_vertices.end(),
+                                 cell.second,
+                                 cell.second + vertices_per_cell);
+      std::sort(relevant_vertices.begin(), relevant_vertices.end());
+      relevant_vertices.erase(std::unique(relevant_vertices.begin(),
+                                          relevant_vertices.end()),
+                              relevant_vertices.end());
+
+      const std::vector<double> coordinates =
+        read_binary_records<double>(file,
+                                    vertex_offset,
+                                    spacedim,
+                                    relevant_vertices);
+
+      // 5) set up the description of the coarse grid with the locally
+      //    relevant vertices enumerated in ascending order
+      Description<dim, spacedim> construction_data;
+      construction_data.comm     = comm;
+      construction_data.settings = settings;
+
+      const bool construct_multigrid =
+        settings &
+        TriangulationDescription::Settings::construct_multigrid_hierarchy;
+      construction_data.smoothing =
+        construct_multigrid ?
+          static_cast<
+            typename dealii::Triangulation<dim, spacedim>::MeshSmoothing>(
+            smoothing |
+            Triangulation<dim, spacedim>::limit_level_difference_at_vertices) :
+          smoothing;
+
+      construction_data.coarse_cell_vertices.resize(relevant_vertices.size());
+      for (std::size_t i = 0; i < relevant_vertices.size(); ++i)
+        for (unsigned int d = 0; d < spacedim; ++d)
+          construction_data.coarse_cell_vertices[i][d] =
+            coordinates[i * spacedim + d];
+
+      construction_data.cell_infos.resize(1);
+      for (const auto &cell : relevant_cells)
+        {
+          const std::uint64_t *record = cell.second;
+
+          dealii::CellData<dim> cell_data(vertices_per_cell);
+          for (unsigned int v = 0; v < vertices_per_cell; ++v)
+            cell_data.vertices[v] = std::lower_bound(relevant_vertices.begin(),
+                                                     relevant_vertices.end(),
+                                                     record[v]) -
+                                    relevant_vertices.begin();
+          cell_data.material_id = record[vertices_per_cell];
+          cell_data.manifold_id = record[vertices_per_cell + 1];
+          construction_data.coarse_cells.push_back(cell_data);
+
+          construction_data.coarse_cell_index_to_coarse_cell_id.push_back(
+            cell.first);
+
+          CellData<dim> cell_info;
+          cell_info.id = CellId(cell.first, std::vector<std::uint8_t>())
+                           .template to_binary<dim>();
+          cell_info.subdomain_id = rank_of_index(cell.first, n_cells, n_ranks);
+          cell_info.level_subdomain_id = construct_multigrid ?
+                                           cell_info.subdomain_id :
+                                           numbers::artificial_subdomain_id;
+          cell_info.manifold_id = cell_data.manifold_id;
+          for (unsigned int line = 0;
+               line < binary_cell_record_n_line_manifold_ids<dim>();
+               ++line)
+            cell_info.manifold_line_ids[line] =
+              record[line_manifold_ids_offset + line];
+          for (unsigned int quad = 0;
+               quad < binary_cell_record_n_quad_manifold_ids<dim>();
+               ++quad)
+            cell_info.manifold_quad_ids[quad] =
+              record[quad_manifold_ids_offset + quad];
+          for (const auto f : GeometryInfo<dim>::face_indices())
+            if (record[vertices_per_cell + 2 + f] !=
+                numbers::internal_face_boundary_id)
+              cell_info.boundary_ids.emplace_back(
+                f, record[vertices_per_cell + 2 + f]);
+
+          construction_data.cell_infos[0].push_back(cell_info);
+        }
+
+      return construction_data;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    write_binary_coarse_mesh(const dealii::Triangulation<dim, spacedim> &tria,
+                             const std::string &filename)
+    {
+      std::ofstream file(filename, std::ios::binary);
+      AssertThrow(file, ExcFileNotOpen(filename));
+
+      const std::uint64_t header[4] = {static_cast<std::uint64_t>(dim),
+                                       static_cast<std::uint64_t>(spacedim),
+                                       tria.n_vertices(),
+                                       tria.n_cells(0)};
+      file.write(binary_coarse_mesh_identifier,
+                 sizeof(binary_coarse_mesh_identifier));
+      file.write(reinterpret_cast<const char *>(header), sizeof(header));
+
+      for (const auto &vertex : tria.get_vertices())
+        for (unsigned int d = 0; d < spacedim; ++d)
+          file.write(reinterpret_cast<const char *>(&vertex[d]),
+                     sizeof(double));
+
+      constexpr unsigned int vertices_per_cell =
+        GeometryInfo<dim>::vertices_per_cell;
+      constexpr unsigned int line_manifold_ids_offset =
+        vertices_per_cell + 2 + GeometryInfo<dim>::faces_per_cell;
+      constexpr unsigned int quad_manifold_ids_offset =
+        line_manifold_ids_offset +
+        binary_cell_record_n_line_manifold_ids<dim>();
+      std::array<std::uint64_t, binary_cell_record_size<dim>()> record;
+      for (const auto &cell : tria.cell_iterators_on_level(0))
+        {
+          for (const auto v : GeometryInfo<dim>::vertex_indices())
+            record[v] = cell->vertex_index(v);
+          record[vertices_per_cell]     = cell->material_id();
+          record[vertices_per_cell + 1] = cell->manifold_id();
+          for (const auto f : GeometryInfo<dim>::face_indices())
+            record[vertices_per_cell + 2 + f] = cell->face(f)->boundary_id();
+          for (unsigned int line = 0;
+               line < binary_cell_record_n_line_manifold_ids<dim>();
+               ++line)
+            record[line_manifold_ids_offset + line] =
+              cell->line(line)->manifold_id();
+          for (unsigned int quad = 0;
+               quad < binary_cell_record_n_quad_manifold_ids<dim>();
+               ++quad)
+            record[quad_manifold_ids_offset + quad] =
+              cell->quad(quad)->manifold_id();
+          file.write(reinterpret_cast<const char *>(record.data()),
+                     sizeof(record));
+        }
+
+      AssertThrow(file, ExcIO());
+    }
+
   } // namespace Utilities
 } // namespace TriangulationDescription
 
@@ -0,0 +1,162 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+
+#include <deal.II/lac/la_parallel_vector_shared_memory.h>
+
+#include <boost/serialization/vector.hpp>
+
+#include <map>
+#include <numeric>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    namespace internal
+    {
+      SharedMemoryPattern::SharedMemoryPattern(
+        const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+        const MPI_Comm &communicator_sm)
+        : communicator_sm(communicator_sm)
+      {
+#ifdef DEAL_II_WITH_MPI
+        const MPI_Comm &communicator = partitioner->get_mpi_communicator();
+        const unsigned int n_sm_processes =
+          Utilities::MPI::n_mpi_processes(communicator_sm);
+        const unsigned int my_sm_rank =
+          Utilities::MPI::this_mpi_process(communicator_sm);
+
+        // find out the rank of each process of the shared-memory
+        // communicator within the communicator of the partitioner
+        std::vector<int> sm_ranks(n_sm_processes), ranks(n_sm_processes);
+        std::iota(sm_ranks.begin(), sm_ranks.end(), 0);
+        MPI_Group group, group_sm;
+        int       ierr = MPI_Comm_group(communicator, &group);
+        AssertThrowMPI(ierr);
+        ierr = MPI_Comm_group(communicator_sm, &group_sm);
+        AssertThrowMPI(ierr);
+        ierr = MPI_Group_translate_ranks(
+          group_sm, n_sm_processes, sm_ranks.data(), group, ranks.data());
+        AssertThrowMPI(ierr);
+        ierr = MPI_Group_free(&group_sm);
+        AssertThrowMPI(ierr);
+        ierr = MPI_Group_free(&group);
+        AssertThrowMPI(ierr);
+
+        std::map<unsigned int, unsigned int> sm_rank_of_rank;
+        for (unsigned int i = 0; i < n_sm_processes; ++i)
+          {
+            AssertThrow(ranks[i] != MPI_UNDEFINED,
+                        ExcMessage("The processes of the shared-memory "
+                                   "communicator must be a subset of the "
+                                   "processes of the communicator of the "
+                                   "partitioner."));
+            sm_rank_of_rank[ranks[i]] = i;
+          }
+
+        const std::vector<types::global_dof_index> first_owned_index =
+          Utilities::MPI::all_gather(communicator_sm,
+                                     partitioner->local_range().first);
+        sm_array_sizes = Utilities::MPI::all_gather(
+          communicator_sm,
+          partitioner->local_size() + partitioner->n_ghost_indices());
+
+        // go through the ghost indices, which are sorted by their owner, and
+        // split them into those owned on this node, for which we record the
+        // position in the array of the owner, and those owned elsewhere
+        std::vector<types::global_dof_index> remote_ghost_indices;
+        IndexSet::ElementIterator ghost = partitioner->ghost_indices().begin();
+        unsigned int              position = partitioner->local_size();
+        for (const auto &target : partitioner->ghost_targets())
+          {
+            const auto sm_rank = sm_rank_of_rank.find(target.first);
+            for (unsigned int i = 0; i < target.second;
+                 ++i, ++ghost, ++position)
+              if (sm_rank == sm_rank_of_rank.end())
+                remote_ghost_indices.push_back(*ghost);
+              else
+                {
+                  const unsigned int sm_position =
+                    *ghost - first_owned_index[sm_rank->second];
+                  if (!ghost_chunks.empty() &&
+                      ghost_chunks.back().sm_rank == sm_rank->second &&
+                      ghost_chunks.back().position + ghost_chunks.back().size ==
+                        position &&
+                      ghost_chunks.back().sm_position +
+                          ghost_chunks.back().size ==
+                        sm_position)
+                    ++ghost_chunks.back().size;
+                  else
+                    ghost_chunks.push_back(
+                      Chunk{sm_rank->second, position, sm_position, 1});
+                }
+          }
+        AssertDimension(position,
+                        partitioner->local_size() +
+                          partitioner->n_ghost_indices());
+
+        IndexSet remote_ghosts(partitioner->size());
+        remote_ghosts.add_indices(remote_ghost_indices.begin(),
+                                  remote_ghost_indices.end());
+        remote_ghosts.compress();
+        const auto new_partitioner =
+          std::make_shared<Utilities::MPI::Partitioner>(
+            partitioner->locally_owned_range(), communicator);
+        new_partitioner->set_ghost_indices(remote_ghosts,
+                                           partitioner->ghost_indices());
+        remote_partitioner = new_partitioner;
+
+        // the entries this process owns and which are ghosts on other
+        // processes of the node are the transpose of the ghost chunks of
+        // these processes
+        std::vector<unsigned int> my_ghost_chunks;
+        for (const Chunk &chunk : ghost_chunks)
+          my_ghost_chunks.insert(
+            my_ghost_chunks.end(),
+            {chunk.sm_rank, chunk.position, chunk.sm_position, chunk.size});
+        const std::vector<std::vector<unsigned int>> all_ghost_chunks =
+          Utilities::MPI::all_gather(communicator_sm, my_ghost_chunks);
+        for (unsigned int p = 0; p < n_sm_processes; ++p)
+          for (unsigned int c = 0; c < all_ghost_chunks[p].size(); c += 4)
+            if (all_ghost_chunks[p][c] == my_sm_rank)
+              import_chunks.push_back(Chunk{p,
+                                            all_ghost_chunks[p][c + 2],
+                                            all_ghost_chunks[p][c + 1],
+                                            all_ghost_chunks[p][c + 3]});
+#else
+        (void)partitioner;
+        AssertThrow(false, ExcNeedsMPI());
+#endif
+      }
+
+
+
+      std::size_t
+      SharedMemoryPattern::memory_consumption() const
+      {
+        return MemoryConsumption::memory_consumption(sm_array_sizes) +
+               remote_partitioner->memory_consumption() +
+               (ghost_chunks.capacity() + import_chunks.capacity()) *
+                 sizeof(Chunk);
+      }
+    } // namespace internal
+  }   // namespace distributed
+} // namespace LinearAlgebra
+
+DEAL_II_NAMESPACE_CLOSE
@@ -33,6 +33,7 @@ namespace internal
 
     template void
     DoFInfo::read_dof_indices<double>(
+      const std::vector<types::global_dof_index> &,
       const std::vector<types::global_dof_index> &,
       const std::vector<unsigned int> &,
       const dealii::AffineConstraints<double> &,
@@ -42,6 +43,7 @@ namespace internal
 
     template void
     DoFInfo::read_dof_indices<float>(
+      const std::vector<types::global_dof_index> &,
       const std::vector<types::global_dof_index> &,
       const std::vector<unsigned int> &,
       const dealii::AffineConstraints<float> &,
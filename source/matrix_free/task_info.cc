@@ -15,6 +15,7 @@
 
 
 #include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/instrumentation.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/mpi.h>
 #include <deal.II/base/multithread_info.h>
@@ -338,6 +339,10 @@ namespace internal
     void
     TaskInfo::loop(MFWorkerInterface &funct) const
     {
+      // all loops of MatrixFree end up here
+      static const dealii::Instrumentation::Region region("MatrixFree::loop");
+      dealii::Instrumentation::Scope               scope(region);
+
       // If we use thread parallelism, we do not currently support to schedule
       // pieces of updates within the loop, so this index will collect all
       // calls in that case and work like a single complete loop over all
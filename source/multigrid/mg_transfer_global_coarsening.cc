@@ -0,0 +1,1051 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_accessor.h>
+
+#include <deal.II/fe/fe.h>
+
+#include <deal.II/grid/cell_id.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <deal.II/matrix_free/evaluation_kernels.h>
+#include <deal.II/matrix_free/shape_info.h>
+
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace MGTransferGlobalCoarseningTools
+{
+  unsigned int
+  create_next_polynomial_coarsening_degree(
+    const unsigned int                      degree,
+    const PolynomialCoarseningSequenceType &p_sequence)
+  {
+    switch (p_sequence)
+      {
+        case PolynomialCoarseningSequenceType::bisect:
+          return std::max(degree / 2, 1u);
+        case PolynomialCoarseningSequenceType::decrease_by_one:
+          return std::max(degree - 1, 1u);
+        case PolynomialCoarseningSequenceType::go_to_one:
+          return 1u;
+        default:
+          Assert(false, ExcNotImplemented());
+          return 1u;
+      }
+  }
+
+
+
+  std::vector<unsigned int>
+  create_polynomial_coarsening_sequence(
+    const unsigned int                      max_degree,
+    const PolynomialCoarseningSequenceType &p_sequence)
+  {
+    Assert(max_degree > 0, ExcMessage("This function expects a degree of at "
+                                      "least one."));
+
+    std::vector<unsigned int> degrees{max_degree};
+
+    while (degrees.back() > 1)
+      degrees.push_back(
+        create_next_polynomial_coarsening_degree(degrees.back(), p_sequence));
+
+    std::reverse(degrees.begin(), degrees.end());
+
+    return degrees;
+  }
+
+
+
+  template <int dim, int spacedim>
+  std::vector<std::shared_ptr<const Triangulation<dim, spacedim>>>
+  create_geometric_coarsening_sequence(const Triangulation<dim, spacedim> &tria)
+  {
+    // create an empty triangulation of the same type as the given one
+    const auto create_empty_triangulation =
+      [&tria]() -> std::shared_ptr<Triangulation<dim, spacedim>> {
+#ifdef DEAL_II_WITH_P4EST
+      if (const auto tria_pdt = dynamic_cast<
+            const parallel::distributed::Triangulation<dim, spacedim> *>(&tria))
+        return std::make_shared<
+          parallel::distributed::Triangulation<dim, spacedim>>(
+          tria_pdt->get_communicator(),
+          tria.get_mesh_smoothing(),
+          parallel::distributed::Triangulation<dim, spacedim>::Settings::
+            no_automatic_repartitioning);
+#endif
+      AssertThrow(
+        (dynamic_cast<const parallel::TriangulationBase<dim, spacedim> *>(
+           &tria) == nullptr),
+        ExcMessage("Geometric coarsening sequences can only be created for "
+                   "serial triangulations and for "
+                   "parallel::distributed::Triangulation objects."));
+      return std::make_shared<Triangulation<dim, spacedim>>(
+        tria.get_mesh_smoothing());
+    };
+
+    std::vector<std::shared_ptr<const Triangulation<dim, spacedim>>>
+      triangulations;
+
+    auto current_tria = create_empty_triangulation();
+    current_tria->copy_triangulation(tria);
+    triangulations.push_back(current_tria);
+
+    while (current_tria->n_global_levels() > 1)
+      {
+        auto new_tria = create_empty_triangulation();
+        new_tria->copy_triangulation(*current_tria);
+
+        for (const auto &cell : new_tria->active_cell_iterators())
+          if (cell->is_locally_owned() && cell->level() > 0)
+            cell->set_coarsen_flag();
+        new_tria->execute_coarsening_and_refinement();
+
+        // stop if no cell could be coarsened, which can happen in parallel
+        // if the children of all remaining parents are distributed among
+        // several processes
+        if (new_tria->n_global_active_cells() ==
+            current_tria->n_global_active_cells())
+          break;
+
+        triangulations.push_back(new_tria);
+        current_tria = new_tria;
+      }
+
+    std::reverse(triangulations.begin(), triangulations.end());
+
+    return triangulations;
+  }
+} // namespace MGTransferGlobalCoarseningTools
+
+
+
+namespace internal
+{
+  class MGTwoLevelTransferImplementation
+  {
+    /**
+     * The numbering of the degrees of freedom of the element @p fe in
+     * lexicographic order, with components following each other.
+     */
+    template <int dim>
+    static std::vector<unsigned int>
+    get_lexicographic_numbering(const FiniteElement<dim> &fe)
+    {
+      const internal::MatrixFreeFunctions::ShapeInfo<double> shape_info(
+        QGauss<1>(fe.degree + 1), fe, 0);
+      return shape_info.lexicographic_numbering;
+    }
+
+
+
+    /**
+     * Return the values of the one-dimensional basis functions of the
+     * scalar tensor-product element @p fe in the points @p points, stored as
+     * n_dofs_1d x n_points.
+     */
+    template <int dim>
+    static std::vector<double>
+    evaluate_1d_basis(const FiniteElement<dim> & fe,
+                      const std::vector<double> &points)
+    {
+      const std::vector<unsigned int> lexicographic =
+        get_lexicographic_numbering(fe);
+      const unsigned int n_dofs_1d = fe.degree + 1;
+
+      // evaluate along the line through the first support point, assuming
+      // that the first basis function is one there and all others vanish,
+      // as done for the shape info of the matrix-free framework
+      Assert(fe.has_support_points(), ExcNotImplemented());
+      const Point<dim> first_support_point =
+        fe.get_unit_support_points()[lexicographic[0]];
+
+      std::vector<double> values(n_dofs_1d * points.size());
+      for (unsigned int i = 0; i < n_dofs_1d; ++i)
+        for (unsigned int q = 0; q < points.size(); ++q)
+          {
+            Point<dim> point = first_support_point;
+            point[0]         = points[q];
+            values[i * points.size() + q] =
+              fe.shape_value(lexicographic[i], point);
+          }
+      return values;
+    }
+
+
+
+    /**
+     * Return the one-dimensional support points of the scalar
+     * tensor-product element @p fe in lexicographic order.
+     */
+    template <int dim>
+    static std::vector<double>
+    get_1d_support_points(const FiniteElement<dim> &fe)
+    {
+      const std::vector<unsigned int> lexicographic =
+        get_lexicographic_numbering(fe);
+      const unsigned int n_dofs_1d = fe.degree + 1;
+
+      std::vector<double> points(n_dofs_1d);
+      for (unsigned int i = 0; i < n_dofs_1d; ++i)
+        points[i] = fe.get_unit_support_points()[lexicographic[i]][0];
+      return points;
+    }
+
+
+
+    /**
+     * Set up the one-dimensional prolongation and interpolation matrices of
+     * a transfer scheme. If @p refined is true, the fine basis is the one of
+     * the patch of 2^dim children of the coarse cell.
+     */
+    template <int dim, typename SchemeType>
+    static void
+    setup_matrices(SchemeType &              scheme,
+                   const FiniteElement<dim> &fe_fine,
+                   const FiniteElement<dim> &fe_coarse,
+                   const bool                element_is_continuous,
+                   const bool                refined)
+    {
+      const unsigned int n_dofs_1d_cell_fine = fe_fine.degree + 1;
+      const unsigned int n_dofs_1d_coarse    = fe_coarse.degree + 1;
+
+      // offset of the nodes of the second child within the patch
+      const unsigned int offset =
+        element_is_continuous ? fe_fine.degree : n_dofs_1d_cell_fine;
+
+      const std::vector<double> support_points_fine =
+        get_1d_support_points(fe_fine);
+      const std::vector<double> support_points_coarse =
+        get_1d_support_points(fe_coarse);
+
+      std::vector<double> points_fine;
+      if (refined)
+        {
+          points_fine.resize(offset + n_dofs_1d_cell_fine);
+          for (unsigned int c = 0; c < 2; ++c)
+            for (unsigned int i = 0; i < n_dofs_1d_cell_fine; ++i)
+              points_fine[c * offset + i] = 0.5 * (c + support_points_fine[i]);
+        }
+      else
+        points_fine = support_points_fine;
+
+      scheme.n_dofs_1d_coarse = n_dofs_1d_coarse;
+      scheme.n_dofs_1d_fine   = points_fine.size();
+      scheme.transfer_is_identity =
+        (refined == false) && (fe_fine.degree == fe_coarse.degree);
+
+      // coarse basis functions in the fine nodes
+      const std::vector<double> prolongation =
+        evaluate_1d_basis(fe_coarse, points_fine);
+      scheme.prolongation_matrix_1d.resize(prolongation.size());
+      std::copy(prolongation.begin(),
+                prolongation.end(),
+                scheme.prolongation_matrix_1d.begin());
+
+      // fine basis functions in the coarse nodes; for the patch of
+      // children, evaluate the basis of the child that contains the node
+      scheme.interpolation_matrix_1d.resize(n_dofs_1d_coarse *
+                                            scheme.n_dofs_1d_fine);
+      std::fill(scheme.interpolation_matrix_1d.begin(),
+                scheme.interpolation_matrix_1d.end(),
+                0.);
+      for (unsigned int i = 0; i < n_dofs_1d_coarse; ++i)
+        {
+          const double       x     = support_points_coarse[i];
+          const unsigned int child = (refined && x >= 0.5) ? 1 : 0;
+          const double local_x     = refined ? 2. * x - child : x;
+
+          const std::vector<double> values =
+            evaluate_1d_basis(fe_fine, std::vector<double>(1, local_x));
+          for (unsigned int j = 0; j < n_dofs_1d_cell_fine; ++j)
+            scheme.interpolation_matrix_1d[i * scheme.n_dofs_1d_fine +
+                                           child * offset + j] = values[j];
+        }
+    }
+
+
+
+    /**
+     * Compute the inverse of the number of coarse cells each locally
+     * relevant degree of freedom of @p vector is visited from, or zero for
+     * constrained degrees of freedom.
+     */
+    template <typename Number>
+    static void
+    compute_weights(const std::vector<std::vector<unsigned int> *> &indices,
+                    const dealii::AffineConstraints<Number> &       constraints,
+                    LinearAlgebra::distributed::Vector<Number> &    vector,
+                    AlignedVector<Number> &                         weights)
+    {
+      vector = Number(0.);
+      vector.zero_out_ghosts();
+      for (const auto index_list : indices)
+        for (const unsigned int index : *index_list)
+          vector.local_element(index) += Number(1.);
+      vector.compress(VectorOperation::add);
+      vector.update_ghost_values();
+
+      const auto &partitioner = *vector.get_partitioner();
+      weights.resize(partitioner.local_size() + partitioner.n_ghost_indices());
+      for (unsigned int i = 0; i < weights.size(); ++i)
+        {
+          const Number valence = vector.local_element(i);
+          weights[i] = (valence == Number(0.) ||
+                        constraints.is_constrained(
+                          partitioner.local_to_global(i))) ?
+                         Number(0.) :
+                         Number(1.) / valence;
+        }
+
+      vector.zero_out_ghosts();
+      vector = Number(0.);
+    }
+
+
+
+  public:
+    template <int dim, typename Number>
+    static void
+    reinit(MGTwoLevelTransfer<dim, LinearAlgebra::distributed::Vector<Number>>
+             &                                      transfer,
+           const DoFHandler<dim> &                  dof_handler_fine,
+           const DoFHandler<dim> &                  dof_handler_coarse,
+           const dealii::AffineConstraints<Number> &constraint_fine,
+           const dealii::AffineConstraints<Number> &constraint_coarse,
+           const bool                               geometric)
+    {
+      const FiniteElement<dim> &fe_fine   = dof_handler_fine.get_fe();
+      const FiniteElement<dim> &fe_coarse = dof_handler_coarse.get_fe();
+
+      AssertThrow(fe_fine.n_base_elements() == 1 &&
+                    fe_coarse.n_base_elements() == 1,
+                  ExcMessage("Only elements consisting of a single base "
+                             "element (possibly with multiple components) "
+                             "are supported."));
+      AssertDimension(fe_fine.n_components(), fe_coarse.n_components());
+
+      const FiniteElement<dim> &base_fine   = fe_fine.base_element(0);
+      const FiniteElement<dim> &base_coarse = fe_coarse.base_element(0);
+
+      const bool element_is_continuous = base_fine.dofs_per_vertex > 0;
+      AssertThrow(element_is_continuous == (base_coarse.dofs_per_vertex > 0),
+                  ExcMessage("Both elements need to be either continuous or "
+                             "discontinuous."));
+
+      const Triangulation<dim> &tria_fine =
+        dof_handler_fine.get_triangulation();
+      const Triangulation<dim> &tria_coarse =
+        dof_handler_coarse.get_triangulation();
+
+      if (geometric)
+        {
+          AssertThrow(base_fine.degree == base_coarse.degree,
+                      ExcMessage("Geometric transfer requires the same "
+                                 "element on both levels."));
+        }
+      else
+        {
+          AssertThrow(&tria_fine == &tria_coarse,
+                      ExcMessage("Polynomial transfer requires both "
+                                 "DoFHandler objects to be defined on the "
+                                 "same triangulation."));
+          AssertThrow(base_coarse.degree <= base_fine.degree,
+                      ExcMessage("The coarse element must not have a higher "
+                                 "degree than the fine element."));
+        }
+
+      MPI_Comm communicator = MPI_COMM_SELF;
+      if (const auto tria_parallel =
+            dynamic_cast<const parallel::TriangulationBase<dim> *>(&tria_fine))
+        communicator = tria_parallel->get_communicator();
+
+      transfer.n_components = fe_fine.n_components();
+
+      const std::vector<unsigned int> lexicographic_fine =
+        get_lexicographic_numbering(fe_fine);
+      const std::vector<unsigned int> lexicographic_coarse =
+        get_lexicographic_numbering(fe_coarse);
+
+      // set up the schemes: for the geometric transfer, scheme 0 describes
+      // cells that are not refined and scheme 1 cells that are refined once;
+      // the polynomial transfer only has cells of the first kind
+      transfer.schemes.clear();
+      transfer.schemes.resize(geometric ? 2 : 1);
+      for (unsigned int s = 0; s < transfer.schemes.size(); ++s)
+        {
+          auto &scheme = transfer.schemes[s];
+          setup_matrices(
+            scheme, base_fine, base_coarse, element_is_continuous, s == 1);
+          scheme.n_coarse_cells       = 0;
+          scheme.dofs_per_cell_coarse = fe_coarse.dofs_per_cell;
+          scheme.dofs_per_cell_fine =
+            transfer.n_components *
+            Utilities::pow(scheme.n_dofs_1d_fine, dim);
+        }
+
+      const unsigned int n_dofs_1d_cell_fine = base_fine.degree + 1;
+      const unsigned int dofs_per_component_cell_fine =
+        base_fine.dofs_per_cell;
+      const unsigned int offset =
+        element_is_continuous ? base_fine.degree : n_dofs_1d_cell_fine;
+
+      // collect the global indices of all locally owned coarse cells and the
+      // corresponding fine cells in lexicographic order
+      std::vector<std::vector<types::global_dof_index>> global_indices_coarse(
+        transfer.schemes.size());
+      std::vector<std::vector<types::global_dof_index>> global_indices_fine(
+        transfer.schemes.size());
+
+      std::vector<types::global_dof_index> local_dof_indices_coarse(
+        fe_coarse.dofs_per_cell);
+      std::vector<types::global_dof_index> local_dof_indices_fine(
+        fe_fine.dofs_per_cell);
+
+      for (const auto &cell_coarse : dof_handler_coarse.active_cell_iterators())
+        {
+          if (cell_coarse->is_locally_owned() == false)
+            continue;
+
+          typename DoFHandler<dim>::cell_iterator cell_fine;
+          if (geometric)
+            {
+              const auto tria_cell_fine = cell_coarse->id().to_cell(tria_fine);
+              cell_fine = typename DoFHandler<dim>::cell_iterator(
+                &tria_fine,
+                tria_cell_fine->level(),
+                tria_cell_fine->index(),
+                &dof_handler_fine);
+            }
+          else
+            cell_fine =
+              typename DoFHandler<dim>::cell_iterator(&tria_fine,
+                                                      cell_coarse->level(),
+                                                      cell_coarse->index(),
+                                                      &dof_handler_fine);
+
+          const unsigned int scheme_index = cell_fine->is_active() ? 0 : 1;
+          auto &             scheme       = transfer.schemes[scheme_index];
+          ++scheme.n_coarse_cells;
+
+          cell_coarse->get_dof_indices(local_dof_indices_coarse);
+          for (unsigned int i = 0; i < fe_coarse.dofs_per_cell; ++i)
+            global_indices_coarse[scheme_index].push_back(
+              local_dof_indices_coarse[lexicographic_coarse[i]]);
+
+          if (scheme_index == 0)
+            {
+              AssertThrow(cell_fine->is_artificial() == false,
+                          ExcMessage("The fine cell corresponding to a "
+                                     "locally owned coarse cell must not be "
+                                     "artificial."));
+              cell_fine->get_dof_indices(local_dof_indices_fine);
+              for (unsigned int i = 0; i < fe_fine.dofs_per_cell; ++i)
+                global_indices_fine[0].push_back(
+                  local_dof_indices_fine[lexicographic_fine[i]]);
+            }
+          else
+            {
+              // assemble the indices of the patch of children in
+              // lexicographic order, where the nodes shared by the children
+              // of continuous elements are only counted once
+              std::vector<types::global_dof_index> patch_indices(
+                scheme.dofs_per_cell_fine, numbers::invalid_dof_index);
+              const unsigned int n_dofs_1d_patch = scheme.n_dofs_1d_fine;
+              const unsigned int dofs_per_component_patch =
+                Utilities::pow(n_dofs_1d_patch, dim);
+
+              for (unsigned int child = 0; child < cell_fine->n_children();
+                   ++child)
+                {
+                  const auto cell_child = cell_fine->child(child);
+                  AssertThrow(cell_child->is_active(),
+                              ExcMessage("The fine triangulation may only "
+                                         "refine the cells of the coarse "
+                                         "triangulation once."));
+                  AssertThrow(cell_child->is_artificial() == false,
+                              ExcMessage("The children of a locally owned "
+                                         "coarse cell must not be "
+                                         "artificial on the fine "
+                                         "triangulation."));
+
+                  cell_child->get_dof_indices(local_dof_indices_fine);
+
+                  // children of hypercubes are numbered lexicographically
+                  const unsigned int child_offset[3] = {
+                    (child & 1) * offset,
+                    ((child >> 1) & 1) * offset,
+                    ((child >> 2) & 1) * offset};
+
+                  for (unsigned int c = 0; c < transfer.n_components; ++c)
+                    for (unsigned int k = 0;
+                         k < (dim > 2 ? n_dofs_1d_cell_fine : 1);
+                         ++k)
+                      for (unsigned int j = 0;
+                           j < (dim > 1 ? n_dofs_1d_cell_fine : 1);
+                           ++j)
+                        for (unsigned int i = 0; i < n_dofs_1d_cell_fine; ++i)
+                          {
+                            const unsigned int index_cell =
+                              c * dofs_per_component_cell_fine +
+                              (k * n_dofs_1d_cell_fine + j) *
+                                n_dofs_1d_cell_fine +
+                              i;
+                            const unsigned int index_patch =
+                              c * dofs_per_component_patch +
+                              ((k + child_offset[2]) * n_dofs_1d_patch + j +
+                               child_offset[1]) *
+                                n_dofs_1d_patch +
+                              i + child_offset[0];
+                            patch_indices[index_patch] =
+                              local_dof_indices_fine
+                                [lexicographic_fine[index_cell]];
+                          }
+                }
+
+              global_indices_fine[1].insert(global_indices_fine[1].end(),
+                                            patch_indices.begin(),
+                                            patch_indices.end());
+            }
+        }
+
+      // set up the partitioner for the fine level
+      {
+        std::vector<types::global_dof_index> ghost_indices;
+        for (const auto &indices : global_indices_fine)
+          ghost_indices.insert(ghost_indices.end(),
+                               indices.begin(),
+                               indices.end());
+        std::sort(ghost_indices.begin(), ghost_indices.end());
+        ghost_indices.erase(std::unique(ghost_indices.begin(),
+                                        ghost_indices.end()),
+                            ghost_indices.end());
+
+        const IndexSet &locally_owned = dof_handler_fine.locally_owned_dofs();
+        IndexSet        ghost_set(locally_owned.size());
+        ghost_set.add_indices(ghost_indices.begin(), ghost_indices.end());
+        ghost_set.subtract_set(locally_owned);
+
+        transfer.partitioner_fine =
+          std::make_shared<Utilities::MPI::Partitioner>(locally_owned,
+                                                        ghost_set,
+                                                        communicator);
+      }
+
+      // set up the partitioner for the coarse level, which also needs the
+      // masters of all constrained degrees of freedom
+      std::vector<types::global_dof_index> relevant_indices_coarse;
+      {
+        for (const auto &indices : global_indices_coarse)
+          relevant_indices_coarse.insert(relevant_indices_coarse.end(),
+                                         indices.begin(),
+                                         indices.end());
+        std::sort(relevant_indices_coarse.begin(),
+                  relevant_indices_coarse.end());
+        relevant_indices_coarse.erase(
+          std::unique(relevant_indices_coarse.begin(),
+                      relevant_indices_coarse.end()),
+          relevant_indices_coarse.end());
+
+        std::vector<types::global_dof_index> ghost_indices =
+          relevant_indices_coarse;
+        for (const auto index : relevant_indices_coarse)
+          if (constraint_coarse.is_constrained(index))
+            for (const auto &entry :
+                 *constraint_coarse.get_constraint_entries(index))
+              ghost_indices.push_back(entry.first);
+        std::sort(ghost_indices.begin(), ghost_indices.end());
+        ghost_indices.erase(std::unique(ghost_indices.begin(),
+                                        ghost_indices.end()),
+                            ghost_indices.end());
+
+        const IndexSet &locally_owned =
+          dof_handler_coarse.locally_owned_dofs();
+        IndexSet ghost_set(locally_owned.size());
+        ghost_set.add_indices(ghost_indices.begin(), ghost_indices.end());
+        ghost_set.subtract_set(locally_owned);
+
+        transfer.partitioner_coarse =
+          std::make_shared<Utilities::MPI::Partitioner>(locally_owned,
+                                                        ghost_set,
+                                                        communicator);
+      }
+
+      transfer.vec_fine.reinit(transfer.partitioner_fine);
+      transfer.vec_coarse.reinit(transfer.partitioner_coarse);
+
+      // translate the global indices to local ones
+      for (unsigned int s = 0; s < transfer.schemes.size(); ++s)
+        {
+          auto &scheme = transfer.schemes[s];
+
+          scheme.level_dof_indices_coarse.resize(
+            global_indices_coarse[s].size());
+          for (unsigned int i = 0; i < global_indices_coarse[s].size(); ++i)
+            scheme.level_dof_indices_coarse[i] =
+              transfer.partitioner_coarse->global_to_local(
+                global_indices_coarse[s][i]);
+
+          scheme.level_dof_indices_fine.resize(global_indices_fine[s].size());
+          for (unsigned int i = 0; i < global_indices_fine[s].size(); ++i)
+            scheme.level_dof_indices_fine[i] =
+              transfer.partitioner_fine->global_to_local(
+                global_indices_fine[s][i]);
+        }
+
+      // store the constraints of the coarse level in compressed form with
+      // local indices
+      transfer.constraint_coarse_rows.assign(
+        transfer.partitioner_coarse->local_size() +
+          transfer.partitioner_coarse->n_ghost_indices(),
+        numbers::invalid_unsigned_int);
+      transfer.constraint_coarse_row_starts.clear();
+      transfer.constraint_coarse_entries.clear();
+      for (const auto index : relevant_indices_coarse)
+        if (constraint_coarse.is_constrained(index))
+          {
+            transfer.constraint_coarse_rows
+              [transfer.partitioner_coarse->global_to_local(index)] =
+              transfer.constraint_coarse_row_starts.size();
+            transfer.constraint_coarse_row_starts.push_back(
+              transfer.constraint_coarse_entries.size());
+            for (const auto &entry :
+                 *constraint_coarse.get_constraint_entries(index))
+              transfer.constraint_coarse_entries.emplace_back(
+                transfer.partitioner_coarse->global_to_local(entry.first),
+                entry.second);
+          }
+      transfer.constraint_coarse_row_starts.push_back(
+        transfer.constraint_coarse_entries.size());
+
+      // compute the weights that compensate for the multiple visits of
+      // degrees of freedom shared between cells
+      {
+        std::vector<std::vector<unsigned int> *> indices_fine;
+        std::vector<std::vector<unsigned int> *> indices_coarse;
+        for (auto &scheme : transfer.schemes)
+          {
+            indices_fine.push_back(&scheme.level_dof_indices_fine);
+            indices_coarse.push_back(&scheme.level_dof_indices_coarse);
+          }
+        compute_weights(indices_fine,
+                        constraint_fine,
+                        transfer.vec_fine,
+                        transfer.weights_fine);
+        compute_weights(indices_coarse,
+                        constraint_coarse,
+                        transfer.vec_coarse,
+                        transfer.weights_coarse);
+      }
+    }
+  };
+} // namespace internal
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransfer<dim, LinearAlgebra::distributed::Vector<Number>>::
+  reinit_geometric_transfer(const DoFHandler<dim> &          dof_handler_fine,
+                            const DoFHandler<dim> &          dof_handler_coarse,
+                            const AffineConstraints<Number> &constraint_fine,
+                            const AffineConstraints<Number> &constraint_coarse)
+{
+  internal::MGTwoLevelTransferImplementation::reinit(*this,
+                                                     dof_handler_fine,
+                                                     dof_handler_coarse,
+                                                     constraint_fine,
+                                                     constraint_coarse,
+                                                     true);
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransfer<dim, LinearAlgebra::distributed::Vector<Number>>::
+  reinit_polynomial_transfer(const DoFHandler<dim> &dof_handler_fine,
+                             const DoFHandler<dim> &dof_handler_coarse,
+                             const AffineConstraints<Number> &constraint_fine,
+                             const AffineConstraints<Number> &constraint_coarse)
+{
+  internal::MGTwoLevelTransferImplementation::reinit(*this,
+                                                     dof_handler_fine,
+                                                     dof_handler_coarse,
+                                                     constraint_fine,
+                                                     constraint_coarse,
+                                                     false);
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransfer<dim, LinearAlgebra::distributed::Vector<Number>>::prolongate(
+  LinearAlgebra::distributed::Vector<Number> &      dst,
+  const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  using VectorizedArrayType           = VectorizedArray<Number>;
+  constexpr unsigned int n_lanes      = VectorizedArrayType::size();
+  const Number *const    weights_fine = this->weights_fine.data();
+
+  this->vec_coarse.copy_locally_owned_data_from(src);
+  this->vec_coarse.update_ghost_values();
+
+  this->vec_fine = Number(0.);
+  this->vec_fine.zero_out_ghosts();
+
+  AlignedVector<VectorizedArrayType> evaluation_data_coarse;
+  AlignedVector<VectorizedArrayType> evaluation_data_fine;
+
+  for (const auto &scheme : schemes)
+    {
+      evaluation_data_coarse.resize(scheme.dofs_per_cell_coarse);
+      evaluation_data_fine.resize(scheme.dofs_per_cell_fine);
+
+      const unsigned int n_dofs_coarse_component =
+        scheme.dofs_per_cell_coarse / n_components;
+      const unsigned int n_dofs_fine_component =
+        scheme.dofs_per_cell_fine / n_components;
+
+      for (unsigned int cell = 0; cell < scheme.n_coarse_cells; cell += n_lanes)
+        {
+          const unsigned int n_lanes_filled =
+            std::min(n_lanes, scheme.n_coarse_cells - cell);
+
+          // read from the coarse vector, resolving the constraints
+          for (unsigned int v = 0; v < n_lanes_filled; ++v)
+            {
+              const unsigned int *indices =
+                &scheme.level_dof_indices_coarse[(cell + v) *
+                                                 scheme.dofs_per_cell_coarse];
+              for (unsigned int i = 0; i < scheme.dofs_per_cell_coarse; ++i)
+                {
+                  const unsigned int row = constraint_coarse_rows[indices[i]];
+                  if (row == numbers::invalid_unsigned_int)
+                    evaluation_data_coarse[i][v] =
+                      this->vec_coarse.local_element(indices[i]);
+                  else
+                    {
+                      Number value = 0.;
+                      for (unsigned int e = constraint_coarse_row_starts[row];
+                           e < constraint_coarse_row_starts[row + 1];
+                           ++e)
+                        value += constraint_coarse_entries[e].second *
+                                 this->vec_coarse.local_element(
+                                   constraint_coarse_entries[e].first);
+                      evaluation_data_coarse[i][v] = value;
+                    }
+                }
+            }
+
+          // perform the prolongation
+          if (scheme.transfer_is_identity)
+            std::copy(evaluation_data_coarse.begin(),
+                      evaluation_data_coarse.end(),
+                      evaluation_data_fine.begin());
+          else
+            for (unsigned int c = 0; c < n_components; ++c)
+              internal::FEEvaluationImplBasisChange<
+                internal::evaluate_general,
+                dim,
+                0,
+                0,
+                1,
+                VectorizedArrayType,
+                Number>::do_forward(scheme.prolongation_matrix_1d,
+                                    evaluation_data_coarse.begin() +
+                                      c * n_dofs_coarse_component,
+                                    evaluation_data_fine.begin() +
+                                      c * n_dofs_fine_component,
+                                    scheme.n_dofs_1d_coarse,
+                                    scheme.n_dofs_1d_fine);
+
+          // weight and add into the fine vector
+          for (unsigned int v = 0; v < n_lanes_filled; ++v)
+            {
+              const unsigned int *indices =
+                &scheme.level_dof_indices_fine[(cell + v) *
+                                               scheme.dofs_per_cell_fine];
+              for (unsigned int i = 0; i < scheme.dofs_per_cell_fine; ++i)
+                this->vec_fine.local_element(indices[i]) +=
+                  weights_fine[indices[i]] * evaluation_data_fine[i][v];
+            }
+        }
+    }
+
+  this->vec_fine.compress(VectorOperation::add);
+  dst.copy_locally_owned_data_from(this->vec_fine);
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransfer<dim, LinearAlgebra::distributed::Vector<Number>>::
+  restrict_and_add(LinearAlgebra::distributed::Vector<Number> &      dst,
+                   const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  using VectorizedArrayType           = VectorizedArray<Number>;
+  constexpr unsigned int n_lanes      = VectorizedArrayType::size();
+  const Number *const    weights_fine = this->weights_fine.data();
+
+  this->vec_fine.copy_locally_owned_data_from(src);
+  this->vec_fine.update_ghost_values();
+
+  this->vec_coarse = Number(0.);
+  this->vec_coarse.zero_out_ghosts();
+
+  AlignedVector<VectorizedArrayType> evaluation_data_coarse;
+  AlignedVector<VectorizedArrayType> evaluation_data_fine;
+
+  for (const auto &scheme : schemes)
+    {
+      evaluation_data_coarse.resize(scheme.dofs_per_cell_coarse);
+      evaluation_data_fine.resize(scheme.dofs_per_cell_fine);
+
+      const unsigned int n_dofs_coarse_component =
+        scheme.dofs_per_cell_coarse / n_components;
+      const unsigned int n_dofs_fine_component =
+        scheme.dofs_per_cell_fine / n_components;
+
+      for (unsigned int cell = 0; cell < scheme.n_coarse_cells; cell += n_lanes)
+        {
+          const unsigned int n_lanes_filled =
+            std::min(n_lanes, scheme.n_coarse_cells - cell);
+
+          // read and weight the values of the fine vector
+          for (unsigned int v = 0; v < n_lanes_filled; ++v)
+            {
+              const unsigned int *indices =
+                &scheme.level_dof_indices_fine[(cell + v) *
+                                               scheme.dofs_per_cell_fine];
+              for (unsigned int i = 0; i < scheme.dofs_per_cell_fine; ++i)
+                evaluation_data_fine[i][v] =
+                  weights_fine[indices[i]] *
+                  this->vec_fine.local_element(indices[i]);
+            }
+
+          // perform the restriction
+          if (scheme.transfer_is_identity)
+            std::copy(evaluation_data_fine.begin(),
+                      evaluation_data_fine.end(),
+                      evaluation_data_coarse.begin());
+          else
+            for (unsigned int c = 0; c < n_components; ++c)
+              internal::FEEvaluationImplBasisChange<
+                internal::evaluate_general,
+                dim,
+                0,
+                0,
+                1,
+                VectorizedArrayType,
+                Number>::do_backward(scheme.prolongation_matrix_1d,
+                                     false,
+                                     evaluation_data_fine.begin() +
+                                       c * n_dofs_fine_component,
+                                     evaluation_data_coarse.begin() +
+                                       c * n_dofs_coarse_component,
+                                     scheme.n_dofs_1d_coarse,
+                                     scheme.n_dofs_1d_fine);
+
+          // add into the coarse vector, distributing the contributions of
+          // constrained entries to their masters
+          for (unsigned int v = 0; v < n_lanes_filled; ++v)
+            {
+              const unsigned int *indices =
+                &scheme.level_dof_indices_coarse[(cell + v) *
+                                                 scheme.dofs_per_cell_coarse];
+              for (unsigned int i = 0; i < scheme.dofs_per_cell_coarse; ++i)
+                {
+                  const unsigned int row = constraint_coarse_rows[indices[i]];
+                  if (row == numbers::invalid_unsigned_int)
+                    this->vec_coarse.local_element(indices[i]) +=
+                      evaluation_data_coarse[i][v];
+                  else
+                    for (unsigned int e = constraint_coarse_row_starts[row];
+                         e < constraint_coarse_row_starts[row + 1];
+                         ++e)
+                      this->vec_coarse.local_element(
+                        constraint_coarse_entries[e].first) +=
+                        constraint_coarse_entries[e].second *
+                        evaluation_data_coarse[i][v];
+                }
+            }
+        }
+    }
+
+  this->vec_coarse.compress(VectorOperation::add);
+
+  AssertDimension(dst.local_size(), this->vec_coarse.local_size());
+  for (unsigned int i = 0; i < dst.local_size(); ++i)
+    dst.local_element(i) += this->vec_coarse.local_element(i);
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransfer<dim, LinearAlgebra::distributed::Vector<Number>>::
+  interpolate(LinearAlgebra::distributed::Vector<Number> &      dst,
+              const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  using VectorizedArrayType             = VectorizedArray<Number>;
+  constexpr unsigned int n_lanes        = VectorizedArrayType::size();
+  const Number *const    weights_coarse = this->weights_coarse.data();
+
+  this->vec_fine.copy_locally_owned_data_from(src);
+  this->vec_fine.update_ghost_values();
+
+  this->vec_coarse = Number(0.);
+  this->vec_coarse.zero_out_ghosts();
+
+  AlignedVector<VectorizedArrayType> evaluation_data_coarse;
+  AlignedVector<VectorizedArrayType> evaluation_data_fine;
+
+  for (const auto &scheme : schemes)
+    {
+      evaluation_data_coarse.resize(scheme.dofs_per_cell_coarse);
+      evaluation_data_fine.resize(scheme.dofs_per_cell_fine);
+
+      const unsigned int n_dofs_coarse_component =
+        scheme.dofs_per_cell_coarse / n_components;
+      const unsigned int n_dofs_fine_component =
+        scheme.dofs_per_cell_fine / n_components;
+
+      for (unsigned int cell = 0; cell < scheme.n_coarse_cells; cell += n_lanes)
+        {
+          const unsigned int n_lanes_filled =
+            std::min(n_lanes, scheme.n_coarse_cells - cell);
+
+          for (unsigned int v = 0; v < n_lanes_filled; ++v)
+            {
+              const unsigned int *indices =
+                &scheme.level_dof_indices_fine[(cell + v) *
+                                               scheme.dofs_per_cell_fine];
+              for (unsigned int i = 0; i < scheme.dofs_per_cell_fine; ++i)
+                evaluation_data_fine[i][v] =
+                  this->vec_fine.local_element(indices[i]);
+            }
+
+          if (scheme.transfer_is_identity)
+            std::copy(evaluation_data_fine.begin(),
+                      evaluation_data_fine.end(),
+                      evaluation_data_coarse.begin());
+          else
+            for (unsigned int c = 0; c < n_components; ++c)
+              internal::FEEvaluationImplBasisChange<
+                internal::evaluate_general,
+                dim,
+                0,
+                0,
+                1,
+                VectorizedArrayType,
+                Number>::do_backward(scheme.interpolation_matrix_1d,
+                                     false,
+                                     evaluation_data_fine.begin() +
+                                       c * n_dofs_fine_component,
+                                     evaluation_data_coarse.begin() +
+                                       c * n_dofs_coarse_component,
+                                     scheme.n_dofs_1d_coarse,
+                                     scheme.n_dofs_1d_fine);
+
+          // the weights average the values computed from the different
+          // cells around a degree of freedom and skip constrained entries
+          for (unsigned int v = 0; v < n_lanes_filled; ++v)
+            {
+              const unsigned int *indices =
+                &scheme.level_dof_indices_coarse[(cell + v) *
+                                                 scheme.dofs_per_cell_coarse];
+              for (unsigned int i = 0; i < scheme.dofs_per_cell_coarse; ++i)
+                this->vec_coarse.local_element(indices[i]) +=
+                  weights_coarse[indices[i]] * evaluation_data_coarse[i][v];
+            }
+        }
+    }
+
+  this->vec_coarse.compress(VectorOperation::add);
+  dst.copy_locally_owned_data_from(this->vec_coarse);
+}
+
+
+
+template <int dim, typename Number>
+std::shared_ptr<const Utilities::MPI::Partitioner>
+MGTwoLevelTransfer<dim, LinearAlgebra::distributed::Vector<Number>>::
+  get_partitioner_fine() const
+{
+  return partitioner_fine;
+}
+
+
+
+template <int dim, typename Number>
+std::shared_ptr<const Utilities::MPI::Partitioner>
+MGTwoLevelTransfer<dim, LinearAlgebra::distributed::Vector<Number>>::
+  get_partitioner_coarse() const
+{
+  return partitioner_coarse;
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+MGTwoLevelTransfer<dim, LinearAlgebra::distributed::Vector<Number>>::
+  memory_consumption() const
+{
+  std::size_t size = 0;
+
+  for (const auto &scheme : schemes)
+    {
+      size += scheme.prolongation_matrix_1d.memory_consumption();
+      size += scheme.interpolation_matrix_1d.memory_consumption();
+      size += MemoryConsumption::memory_consumption(
+        scheme.level_dof_indices_coarse);
+      size +=
+        MemoryConsumption::memory_consumption(scheme.level_dof_indices_fine);
+    }
+
+  size += vec_fine.memory_consumption();
+  size += vec_coarse.memory_consumption();
+  size += weights_fine.memory_consumption();
+  size += weights_coarse.memory_consumption();
+  size += MemoryConsumption::memory_consumption(constraint_coarse_rows);
+  size += MemoryConsumption::memory_consumption(constraint_coarse_row_starts);
+  size += MemoryConsumption::memory_consumption(constraint_coarse_entries);
+
+  return size;
+}
+
+
+// explicit instantiation
+#include "mg_transfer_global_coarsening.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
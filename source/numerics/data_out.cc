@@ -13,6 +13,7 @@
 //
 // ---------------------------------------------------------------------
 
+#include <deal.II/base/instrumentation.h>
 #include <deal.II/base/work_stream.h>
 
 #include <deal.II/dofs/dof_accessor.h>
@@ -67,6 +68,9 @@ namespace internal
 
 template <int dim, typename DoFHandlerType>
 DataOut<dim, DoFHandlerType>::DataOut()
+  : patch_mapping(nullptr)
+  , patch_n_subdivisions(0)
+  , patch_curved_cell_region(no_curved_cells)
 {
   // For the moment, just call the existing virtual functions. This
   // preserves backward compatibility. When these deprecated functions are
@@ -83,6 +87,15 @@ DataOut<dim, DoFHandlerType>::DataOut()
 
 
 
+template <int dim, typename DoFHandlerType>
+DataOut<dim, DoFHandlerType>::~DataOut()
+{
+  if (tria_listener.connected())
+    tria_listener.disconnect();
+}
+
+
+
 template <int dim, typename DoFHandlerType>
 void
 DataOut<dim, DoFHandlerType>::build_one_patch(
@@ -91,26 +104,53 @@ DataOut<dim, DoFHandlerType>::build_one_patch(
                                                 DoFHandlerType::space_dimension>
     &                    scratch_data,
   const unsigned int     n_subdivisions,
-  const CurvedCellRegion curved_cell_region)
+  const CurvedCellRegion curved_cell_region,
+  const bool             update_data_only)
 {
-  // first create the output object that we will write into
+  const unsigned int patch_idx =
+    (*scratch_data.cell_to_patch_index_map)[cell_and_index->first->level()]
+                                           [cell_and_index->first->index()];
+  // did we mess up the indices?
+  Assert(patch_idx < this->patches.size(), ExcInternalError());
+
+  // first create the output object that we will write into. if we only
+  // update the data of an existing patch, we write directly into the patch
+  // in question instead, since its connectivity and layout stay the same
   ::dealii::DataOutBase::Patch<DoFHandlerType::dimension,
                                DoFHandlerType::space_dimension>
-    patch;
-  patch.n_subdivisions = n_subdivisions;
-
-  // set the vertices of the patch. if the mapping does not preserve locations
-  // (e.g. MappingQEulerian), we need to compute the offset of the vertex for
-  // the graphical output. Otherwise, we can just use the vertex info.
-  for (const unsigned int vertex :
-       GeometryInfo<DoFHandlerType::dimension>::vertex_indices())
-    if (scratch_data.mapping_collection[0].preserves_vertex_locations())
-      patch.vertices[vertex] = cell_and_index->first->vertex(vertex);
-    else
-      patch.vertices[vertex] =
-        scratch_data.mapping_collection[0].transform_unit_to_real_cell(
-          cell_and_index->first,
-          GeometryInfo<DoFHandlerType::dimension>::unit_cell_vertex(vertex));
+    new_patch;
+  ::dealii::DataOutBase::Patch<DoFHandlerType::dimension,
+                               DoFHandlerType::space_dimension> &patch =
+    (update_data_only ? this->patches[patch_idx] : new_patch);
+
+  // the geometry of the patch only stays the same if the mapping places the
+  // vertices at the locations stored in the triangulation. mappings such as
+  // MappingQEulerian or MappingFEField depend on a vector that may have
+  // changed since the last call, so we need to recompute the geometry
+  const bool update_geometry =
+    (update_data_only == false ||
+     scratch_data.mapping_collection[0].preserves_vertex_locations() == false);
+
+  if (update_data_only == false)
+    patch.n_subdivisions = n_subdivisions;
+
+  if (update_geometry)
+    {
+      // set the vertices of the patch. if the mapping does not preserve
+      // locations (e.g. MappingQEulerian), we need to compute the offset of
+      // the vertex for the graphical output. Otherwise, we can just use the
+      // vertex info.
+      for (const unsigned int vertex :
+           GeometryInfo<DoFHandlerType::dimension>::vertex_indices())
+        if (scratch_data.mapping_collection[0].preserves_vertex_locations())
+          patch.vertices[vertex] = cell_and_index->first->vertex(vertex);
+        else
+          patch.vertices[vertex] =
+            scratch_data.mapping_collection[0].transform_unit_to_real_cell(
+              cell_and_index->first,
+              GeometryInfo<DoFHandlerType::dimension>::unit_cell_vertex(
+                vertex));
+    }
 
   // initialize FEValues
   scratch_data.reinit_all_fe_values(this->dof_data, cell_and_index->first);
@@ -120,6 +160,34 @@ DataOut<dim, DoFHandlerType>::build_one_patch(
 
   const unsigned int n_q_points = fe_patch_values.n_quadrature_points;
 
+  // When only updating the data, the quadrature points of curved cells are
+  // still stored in the last rows of patch.data from the previous call, and
+  // we only have to make sure that the layout of the patch is still the one
+  // we are going to fill. If the geometry has to be recomputed, we overwrite
+  // the quadrature points stored there.
+  if (update_data_only)
+    {
+      Assert(patch.data.size(0) ==
+                 scratch_data.n_datasets +
+                   (patch.points_are_available ?
+                      DoFHandlerType::space_dimension :
+                      0) &&
+               patch.data.size(1) == n_q_points,
+             ExcMessage("The layout of the patches does not match the data "
+                        "vectors that are presently attached to this "
+                        "object. Call build_patches() again."));
+
+      if (update_geometry && patch.points_are_available)
+        {
+          const std::vector<Point<DoFHandlerType::space_dimension>>
+            &q_points = fe_patch_values.get_quadrature_points();
+          for (unsigned int i = 0; i < DoFHandlerType::space_dimension; ++i)
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              patch.data(patch.data.size(0) -
+                           DoFHandlerType::space_dimension + i,
+                         q) = q_points[q][i];
+        }
+    }
   // First fill the geometric information for the patch: Where are the
   // nodes in question located.
   //
@@ -130,10 +198,10 @@ DataOut<dim, DoFHandlerType>::build_one_patch(
   // want to produce curved cells everywhere
   //
   // note: a cell is *always* at the boundary if dim<spacedim
-  if (curved_cell_region == curved_inner_cells ||
-      (curved_cell_region == curved_boundary &&
-       (cell_and_index->first->at_boundary() ||
-        (DoFHandlerType::dimension != DoFHandlerType::space_dimension))))
+  else if (curved_cell_region == curved_inner_cells ||
+           (curved_cell_region == curved_boundary &&
+            (cell_and_index->first->at_boundary() ||
+             (DoFHandlerType::dimension != DoFHandlerType::space_dimension))))
     {
       Assert(patch.space_dim == DoFHandlerType::space_dimension,
              ExcInternalError());
@@ -1008,6 +1076,10 @@ DataOut<dim, DoFHandlerType>::build_one_patch(
         }
     }
 
+  // if we only update the data, the neighbors and the patch index are
+  // already set, and we have written directly into the patch
+  if (update_data_only)
+    return;
 
   for (const unsigned int f :
        GeometryInfo<DoFHandlerType::dimension>::face_indices())
@@ -1051,11 +1123,6 @@ DataOut<dim, DoFHandlerType>::build_one_patch(
             .cell_to_patch_index_map)[neighbor->level()][neighbor->index()];
     }
 
-  const unsigned int patch_idx =
-    (*scratch_data.cell_to_patch_index_map)[cell_and_index->first->level()]
-                                           [cell_and_index->first->index()];
-  // did we mess up the indices?
-  Assert(patch_idx < this->patches.size(), ExcInternalError());
   patch.patch_index = patch_idx;
 
   // Put the patch into the patches vector. instead of copying the data,
@@ -1086,6 +1153,9 @@ DataOut<dim, DoFHandlerType>::build_patches(
   const unsigned int     n_subdivisions_,
   const CurvedCellRegion curved_region)
 {
+  static const Instrumentation::Region region("DataOut::build_patches");
+  Instrumentation::Scope               scope(region);
+
   // Check consistency of redundant template parameter
   Assert(dim == DoFHandlerType::dimension,
          ExcDimensionMismatch(dim, DoFHandlerType::dimension));
@@ -1105,7 +1175,7 @@ DataOut<dim, DoFHandlerType>::build_patches(
   // that maps the cell indices to the patch numbers, as this will be needed
   // for generation of neighborship information.
   // Note, there is a confusing mess of different indices here at play:
-  // - patch_index: the index of a patch in all_cells
+  // - patch_index: the index of a patch in patch_cells
   // - cell->index: only unique on each level, used in cell_to_patch_index_map
   // - active_index: index for a cell when counting from begin_active() using
   //   ++cell (identical to cell->active_cell_index())
@@ -1117,7 +1187,7 @@ DataOut<dim, DoFHandlerType>::build_patches(
   //
   // Now construct the map such that
   // cell_to_patch_index_map[cell->level][cell->index] = patch_index
-  std::vector<std::vector<unsigned int>> cell_to_patch_index_map;
+  cell_to_patch_index_map.clear();
   cell_to_patch_index_map.resize(this->triangulation->n_levels());
   for (unsigned int l = 0; l < this->triangulation->n_levels(); ++l)
     {
@@ -1137,8 +1207,8 @@ DataOut<dim, DoFHandlerType>::build_patches(
           DoFHandlerType::space_dimension>::no_neighbor);
     }
 
-  // will be all_cells[patch_index] = pair(cell, active_index)
-  std::vector<std::pair<cell_iterator, unsigned int>> all_cells;
+  // will be patch_cells[patch_index] = pair(cell, active_index)
+  patch_cells.clear();
   {
     // important: we need to compute the active_index of the cell in the range
     // 0..n_active_cells() because this is where we need to look up cell
@@ -1169,14 +1239,66 @@ DataOut<dim, DoFHandlerType>::build_patches(
         Assert(active_index < this->triangulation->n_active_cells(),
                ExcInternalError());
         cell_to_patch_index_map[cell->level()][cell->index()] =
-          all_cells.size();
+          patch_cells.size();
 
-        all_cells.emplace_back(cell, active_index);
+        patch_cells.emplace_back(cell, active_index);
       }
   }
 
   this->patches.clear();
-  this->patches.resize(all_cells.size());
+  this->patches.resize(patch_cells.size());
+
+  // store everything that is needed to later update the data on the same
+  // patches, and make sure that this information is invalidated once the
+  // triangulation changes
+  patch_mapping            = &mapping;
+  patch_n_subdivisions     = n_subdivisions;
+  patch_curved_cell_region =
+    (n_subdivisions < 2 ? no_curved_cells : curved_region);
+
+  if (tria_listener.connected())
+    tria_listener.disconnect();
+  tria_listener = this->triangulation->signals.any_change.connect([this]() {
+    patch_cells.clear();
+    cell_to_patch_index_map.clear();
+    patch_mapping = nullptr;
+  });
+
+  build_patches_on_cells(/*update_data_only = */ false);
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void
+DataOut<dim, DoFHandlerType>::update_patch_data()
+{
+  static const Instrumentation::Region region("DataOut::update_patch_data");
+  Instrumentation::Scope               scope(region);
+
+  Assert(patch_mapping != nullptr && patch_cells.size() == this->patches.size(),
+         ExcMessage("There are no patches whose data could be updated. You "
+                    "need to call build_patches() first, and the "
+                    "triangulation and the data vectors must not have "
+                    "changed since then."));
+  Assert(patch_cells.size() == 0 ||
+           &patch_cells[0].first->get_triangulation() ==
+             &*this->triangulation,
+         ExcMessage("The patches were built on a different triangulation "
+                    "than the one presently attached to this object."));
+
+  build_patches_on_cells(/*update_data_only = */ true);
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void
+DataOut<dim, DoFHandlerType>::build_patches_on_cells(
+  const bool update_data_only)
+{
+  Assert(patch_mapping != nullptr, ExcInternalError());
+  const unsigned int n_subdivisions = patch_n_subdivisions;
 
   // Now create a default object for the WorkStream object to work with. The
   // first step is to count how many output data sets there will be. This is,
@@ -1205,11 +1327,15 @@ DataOut<dim, DoFHandlerType>::build_patches(
     else
       n_postprocessor_outputs[dataset] = 0;
 
-  const CurvedCellRegion curved_cell_region =
-    (n_subdivisions < 2 ? no_curved_cells : curved_region);
+  const CurvedCellRegion curved_cell_region = patch_curved_cell_region;
 
+  // the quadrature points are only needed to set up the geometry of curved
+  // cells, which is kept as is when only updating the data unless the
+  // mapping moves the vertices
   UpdateFlags update_flags = update_values;
-  if (curved_cell_region != no_curved_cells)
+  if (curved_cell_region != no_curved_cells &&
+      (update_data_only == false ||
+       patch_mapping->preserves_vertex_locations() == false))
     update_flags |= update_quadrature_points;
 
   for (unsigned int i = 0; i < this->dof_data.size(); ++i)
@@ -1229,12 +1355,12 @@ DataOut<dim, DoFHandlerType>::build_patches(
     thread_data(n_datasets,
                 n_subdivisions,
                 n_postprocessor_outputs,
-                mapping,
+                *patch_mapping,
                 this->get_fes(),
                 update_flags,
                 cell_to_patch_index_map);
 
-  auto worker = [this, n_subdivisions, curved_cell_region](
+  auto worker = [this, n_subdivisions, curved_cell_region, update_data_only](
                   const std::pair<cell_iterator, unsigned int> *cell_and_index,
                   internal::DataOutImplementation::ParallelData<
                     DoFHandlerType::dimension,
@@ -1245,13 +1371,14 @@ DataOut<dim, DoFHandlerType>::build_patches(
     this->build_one_patch(cell_and_index,
                           scratch_data,
                           n_subdivisions,
-                          curved_cell_region);
+                          curved_cell_region,
+                          update_data_only);
   };
 
   // now build the patches in parallel
-  if (all_cells.size() > 0)
-    WorkStream::run(all_cells.data(),
-                    all_cells.data() + all_cells.size(),
+  if (patch_cells.size() > 0)
+    WorkStream::run(patch_cells.data(),
+                    patch_cells.data() + patch_cells.size(),
                     worker,
                     // no copy-local-to-global function needed here
                     std::function<void(const int)>(),
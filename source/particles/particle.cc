@@ -56,16 +56,9 @@ namespace Particles
                    PropertyPool::invalid_handle)
   {
     if (particle.has_properties())
-      {
-        const ArrayView<double> my_properties =
-          property_pool->get_properties(properties);
-        const ArrayView<const double> their_properties =
-          particle.get_properties();
-
-        std::copy(their_properties.begin(),
-                  their_properties.end(),
-                  my_properties.begin());
-      }
+      for (unsigned int i = 0; i < property_pool->n_properties_per_slot(); ++i)
+        property_pool->get_property(properties, i) =
+          particle.property_pool->get_property(particle.properties, i);
   }
 
 
@@ -93,13 +86,8 @@ namespace Particles
 
     // See if there are properties to load
     if (has_properties())
-      {
-        const ArrayView<double> particle_properties =
-          property_pool->get_properties(properties);
-        const unsigned int size = particle_properties.size();
-        for (unsigned int i = 0; i < size; ++i)
-          particle_properties[i] = *pdata++;
-      }
+      for (unsigned int i = 0; i < property_pool->n_properties_per_slot(); ++i)
+        property_pool->get_property(properties, i) = *pdata++;
 
     data = static_cast<const void *>(pdata);
   }
@@ -128,22 +116,28 @@ namespace Particles
         location           = particle.location;
         reference_location = particle.reference_location;
         id                 = particle.id;
-        property_pool      = particle.property_pool;
+
+        // Reuse the slot we already own if it comes from the same pool,
+        // otherwise return it before taking one from the new pool.
+        if (has_properties() &&
+            (!particle.has_properties() ||
+             property_pool != particle.property_pool))
+          {
+            property_pool->deallocate_properties_array(properties);
+            properties = PropertyPool::invalid_handle;
+          }
+        property_pool = particle.property_pool;
 
         if (particle.has_properties())
           {
-            properties = property_pool->allocate_properties_array();
-            const ArrayView<const double> their_properties =
-              particle.get_properties();
-            const ArrayView<double> my_properties =
-              property_pool->get_properties(properties);
-
-            std::copy(their_properties.begin(),
-                      their_properties.end(),
-                      my_properties.begin());
+            if (properties == PropertyPool::invalid_handle)
+              properties = property_pool->allocate_properties_array();
+
+            for (unsigned int i = 0; i < property_pool->n_properties_per_slot();
+                 ++i)
+              property_pool->get_property(properties, i) =
+                particle.property_pool->get_property(particle.properties, i);
           }
-        else
-          properties = PropertyPool::invalid_handle;
       }
     return *this;
   }
@@ -157,6 +151,9 @@ namespace Particles
   {
     if (this != &particle)
       {
+        if (has_properties())
+          property_pool->deallocate_properties_array(properties);
+
         location            = particle.location;
         reference_location  = particle.reference_location;
         id                  = particle.id;
@@ -197,12 +194,9 @@ namespace Particles
 
     // Write property data
     if (has_properties())
-      {
-        const ArrayView<double> particle_properties =
-          property_pool->get_properties(properties);
-        for (unsigned int i = 0; i < particle_properties.size(); ++i, ++pdata)
-          *pdata = particle_properties[i];
-      }
+      for (unsigned int i = 0; i < property_pool->n_properties_per_slot();
+           ++i, ++pdata)
+        *pdata = property_pool->get_property(properties, i);
 
     data = static_cast<void *>(pdata);
   }
@@ -217,11 +211,7 @@ namespace Particles
                        sizeof(reference_location);
 
     if (has_properties())
-      {
-        const ArrayView<double> particle_properties =
-          property_pool->get_properties(properties);
-        size += sizeof(double) * particle_properties.size();
-      }
+      size += sizeof(double) * property_pool->n_properties_per_slot();
     return size;
   }
 
@@ -300,24 +290,20 @@ namespace Particles
     if (properties == PropertyPool::invalid_handle)
       properties = property_pool->allocate_properties_array();
 
-    const ArrayView<double> old_properties =
-      property_pool->get_properties(properties);
+    const unsigned int n_properties = property_pool->n_properties_per_slot();
 
     Assert(
-      new_properties.size() == old_properties.size(),
+      new_properties.size() == n_properties,
       ExcMessage(
         std::string(
           "You are trying to assign properties with an incompatible length. ") +
-        "The particle has space to store " +
-        std::to_string(old_properties.size()) + " properties, " +
-        "and this function tries to assign" +
+        "The particle has space to store " + std::to_string(n_properties) +
+        " properties, " + "and this function tries to assign" +
         std::to_string(new_properties.size()) + " properties. " +
         "This is not allowed."));
 
-    if (old_properties.size() > 0)
-      std::copy(new_properties.begin(),
-                new_properties.end(),
-                old_properties.begin());
+    for (unsigned int i = 0; i < n_properties; ++i)
+      property_pool->get_property(properties, i) = new_properties[i];
   }
 
 
@@ -344,10 +330,9 @@ namespace Particles
       {
         properties = property_pool->allocate_properties_array();
 
-        ArrayView<double> my_properties =
-          property_pool->get_properties(properties);
-
-        std::fill(my_properties.begin(), my_properties.end(), 0.0);
+        for (unsigned int i = 0; i < property_pool->n_properties_per_slot();
+             ++i)
+          property_pool->get_property(properties, i) = 0.;
       }
 
     return property_pool->get_properties(properties);
@@ -21,31 +21,51 @@ namespace Particles
 {
   template <int dim, int spacedim>
   ParticleAccessor<dim, spacedim>::ParticleAccessor()
-    : map(nullptr)
-    , particle()
+    : particles(nullptr)
+    , cell()
+    , particle_index_within_cell(numbers::invalid_unsigned_int)
   {}
 
 
 
   template <int dim, int spacedim>
   ParticleAccessor<dim, spacedim>::ParticleAccessor(
-    const std::multimap<internal::LevelInd, Particle<dim, spacedim>> &map,
-    const typename std::multimap<internal::LevelInd,
-                                 Particle<dim, spacedim>>::iterator & particle)
-    : map(const_cast<
-          std::multimap<internal::LevelInd, Particle<dim, spacedim>> *>(&map))
-    , particle(particle)
+    const internal::ParticleStorage<dim, spacedim> &particles,
+    const typename Triangulation<dim, spacedim>::active_cell_iterator &cell,
+    const unsigned int particle_index_within_cell)
+    : particles(
+        const_cast<internal::ParticleStorage<dim, spacedim> *>(&particles))
+    , cell(cell)
+    , particle_index_within_cell(particle_index_within_cell)
   {}
 
 
 
+  template <int dim, int spacedim>
+  typename internal::ParticleStorage<dim, spacedim>::CellData &
+  ParticleAccessor<dim, spacedim>::cell_data() const
+  {
+    Assert(particles != nullptr, ExcInternalError());
+    Assert(cell.state() == IteratorState::valid, ExcInternalError());
+    Assert(particle_index_within_cell <
+             particles->n_particles_in_cell(cell->active_cell_index()),
+           ExcInternalError());
+
+    return particles->cell_data(cell->active_cell_index());
+  }
+
+
+
   template <int dim, int spacedim>
   void
   ParticleAccessor<dim, spacedim>::write_data(void *&data) const
   {
-    Assert(particle != map->end(), ExcInternalError());
+    Assert(particles != nullptr, ExcInternalError());
+    Assert(cell.state() == IteratorState::valid, ExcInternalError());
 
-    particle->second.write_data(data);
+    particles->write_data(cell->active_cell_index(),
+                          particle_index_within_cell,
+                          data);
   }
 
 
@@ -54,9 +74,7 @@ namespace Particles
   void
   ParticleAccessor<dim, spacedim>::set_location(const Point<spacedim> &new_loc)
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    particle->second.set_location(new_loc);
+    cell_data().locations[particle_index_within_cell] = new_loc;
   }
 
 
@@ -65,9 +83,7 @@ namespace Particles
   const Point<spacedim> &
   ParticleAccessor<dim, spacedim>::get_location() const
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    return particle->second.get_location();
+    return cell_data().locations[particle_index_within_cell];
   }
 
 
@@ -77,9 +93,7 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::set_reference_location(
     const Point<dim> &new_loc)
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    particle->second.set_reference_location(new_loc);
+    cell_data().reference_locations[particle_index_within_cell] = new_loc;
   }
 
 
@@ -88,9 +102,7 @@ namespace Particles
   const Point<dim> &
   ParticleAccessor<dim, spacedim>::get_reference_location() const
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    return particle->second.get_reference_location();
+    return cell_data().reference_locations[particle_index_within_cell];
   }
 
 
@@ -99,9 +111,7 @@ namespace Particles
   types::particle_index
   ParticleAccessor<dim, spacedim>::get_id() const
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    return particle->second.get_id();
+    return cell_data().ids[particle_index_within_cell];
   }
 
 
@@ -111,9 +121,11 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::set_property_pool(
     PropertyPool &new_property_pool)
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    particle->second.set_property_pool(new_property_pool);
+    Assert(particles != nullptr, ExcInternalError());
+    Assert(&new_property_pool == particles->get_property_pool(),
+           ExcMessage("The particles of a container have to store their "
+                      "properties in the property pool of the container."));
+    (void)new_property_pool;
   }
 
 
@@ -122,9 +134,9 @@ namespace Particles
   bool
   ParticleAccessor<dim, spacedim>::has_properties() const
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    return particle->second.has_properties();
+    return (particles->get_property_pool() != nullptr) &&
+           (cell_data().properties[particle_index_within_cell] !=
+            PropertyPool::invalid_handle);
   }
 
 
@@ -134,9 +146,7 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::set_properties(
     const std::vector<double> &new_properties)
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    particle->second.set_properties(new_properties);
+    set_properties(ArrayView<const double>(new_properties));
   }
 
 
@@ -146,9 +156,25 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::set_properties(
     const ArrayView<const double> &new_properties)
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    particle->second.set_properties(new_properties);
+    Assert(particles->get_property_pool() != nullptr, ExcInternalError());
+
+    PropertyPool &     property_pool = *particles->get_property_pool();
+    const unsigned int n_properties  = property_pool.n_properties_per_slot();
+
+    Assert(
+      new_properties.size() == n_properties,
+      ExcMessage(
+        std::string(
+          "You are trying to assign properties with an incompatible length. ") +
+        "The particle has space to store " + std::to_string(n_properties) +
+        " properties, " + "and this function tries to assign" +
+        std::to_string(new_properties.size()) + " properties. " +
+        "This is not allowed."));
+
+    const PropertyPool::Handle handle =
+      cell_data().properties[particle_index_within_cell];
+    for (unsigned int i = 0; i < n_properties; ++i)
+      property_pool.get_property(handle, i) = new_properties[i];
   }
 
 
@@ -157,9 +183,10 @@ namespace Particles
   const ArrayView<const double>
   ParticleAccessor<dim, spacedim>::get_properties() const
   {
-    Assert(particle != map->end(), ExcInternalError());
+    Assert(has_properties(), ExcInternalError());
 
-    return particle->second.get_properties();
+    return particles->get_property_pool()->get_properties(
+      cell_data().properties[particle_index_within_cell]);
   }
 
 
@@ -169,10 +196,12 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::get_surrounding_cell(
     const Triangulation<dim, spacedim> &triangulation) const
   {
-    Assert(particle != map->end(), ExcInternalError());
+    Assert(cell.state() == IteratorState::valid, ExcInternalError());
+    Assert(&cell->get_triangulation() == &triangulation,
+           ExcMessage("The particle does not live on the given "
+                      "triangulation."));
+    (void)triangulation;
 
-    const typename Triangulation<dim, spacedim>::cell_iterator cell(
-      &triangulation, particle->first.first, particle->first.second);
     return cell;
   }
 
@@ -182,9 +211,10 @@ namespace Particles
   const ArrayView<double>
   ParticleAccessor<dim, spacedim>::get_properties()
   {
-    Assert(particle != map->end(), ExcInternalError());
+    Assert(particles->get_property_pool() != nullptr, ExcInternalError());
 
-    return particle->second.get_properties();
+    return particles->get_property_pool()->get_properties(
+      cell_data().properties[particle_index_within_cell]);
   }
 
 
@@ -193,9 +223,14 @@ namespace Particles
   std::size_t
   ParticleAccessor<dim, spacedim>::serialized_size_in_bytes() const
   {
-    Assert(particle != map->end(), ExcInternalError());
+    std::size_t size = sizeof(types::particle_index) +
+                       sizeof(Point<spacedim>) + sizeof(Point<dim>);
+
+    if (has_properties())
+      size +=
+        sizeof(double) * particles->get_property_pool()->n_properties_per_slot();
 
-    return particle->second.serialized_size_in_bytes();
+    return size;
   }
 
 
@@ -204,8 +239,20 @@ namespace Particles
   void
   ParticleAccessor<dim, spacedim>::next()
   {
-    Assert(particle != map->end(), ExcInternalError());
-    ++particle;
+    Assert(cell.state() == IteratorState::valid, ExcInternalError());
+
+    ++particle_index_within_cell;
+    if (particle_index_within_cell <
+        particles->n_particles_in_cell(cell->active_cell_index()))
+      return;
+
+    // Move on to the next cell that contains particles, or past the end of
+    // the triangulation if there is none.
+    particle_index_within_cell = 0;
+    do
+      ++cell;
+    while (cell.state() == IteratorState::valid &&
+           particles->n_particles_in_cell(cell->active_cell_index()) == 0);
   }
 
 
@@ -214,8 +261,26 @@ namespace Particles
   void
   ParticleAccessor<dim, spacedim>::prev()
   {
-    Assert(particle != map->begin(), ExcInternalError());
-    --particle;
+    if (cell.state() == IteratorState::valid && particle_index_within_cell > 0)
+      {
+        --particle_index_within_cell;
+        return;
+      }
+
+    // Move back to the previous cell that contains particles. If we are past
+    // the end, start the search at the last cell of the triangulation.
+    if (cell.state() == IteratorState::valid)
+      --cell;
+    else
+      cell = cell.access_any().get_triangulation().last_active();
+
+    while (cell.state() == IteratorState::valid &&
+           particles->n_particles_in_cell(cell->active_cell_index()) == 0)
+      --cell;
+
+    Assert(cell.state() == IteratorState::valid, ExcInternalError());
+    particle_index_within_cell =
+      particles->n_particles_in_cell(cell->active_cell_index()) - 1;
   }
 
 
@@ -225,7 +290,7 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::
   operator!=(const ParticleAccessor<dim, spacedim> &other) const
   {
-    return (map != other.map) || (particle != other.particle);
+    return !(*this == other);
   }
 
 
@@ -235,7 +300,8 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::
   operator==(const ParticleAccessor<dim, spacedim> &other) const
   {
-    return (map == other.map) && (particle == other.particle);
+    return (particles == other.particles) && (cell == other.cell) &&
+           (particle_index_within_cell == other.particle_index_within_cell);
   }
 } // namespace Particles
 
@@ -18,6 +18,7 @@
 
 #include <deal.II/particles/particle_handler.h>
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -27,60 +28,52 @@ namespace Particles
 {
   namespace
   {
+    /**
+     * Append the serialized data of all particles that @p particle_storage
+     * holds for @p cell to @p buffer.
+     */
     template <int dim, int spacedim>
-    std::vector<char>
-    pack_particles(std::vector<Particle<dim, spacedim>> &particles)
+    void
+    pack_particles(
+      const internal::ParticleStorage<dim, spacedim> &            particle_storage,
+      const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+      std::vector<char> &                                         buffer)
     {
-      std::vector<char> buffer;
+      const unsigned int cell_index = cell->active_cell_index();
+      const unsigned int n_particles =
+        particle_storage.n_particles_in_cell(cell_index);
 
-      if (particles.size() == 0)
-        return buffer;
+      if (n_particles == 0)
+        return;
 
-      buffer.resize(particles.size() *
-                    particles.front().serialized_size_in_bytes());
-      void *current_data = buffer.data();
+      const std::size_t old_size = buffer.size();
+      buffer.resize(old_size +
+                    n_particles * particle_storage.serialized_size_in_bytes());
+      void *current_data = buffer.data() + old_size;
 
-      for (const auto &particle : particles)
-        {
-          particle.write_data(current_data);
-        }
-
-      return buffer;
+      for (unsigned int i = 0; i < n_particles; ++i)
+        particle_storage.write_data(cell_index, i, current_data);
     }
 
-    template <int dim, int spacedim>
-    std::vector<Particle<dim, spacedim>>
-    unpack_particles(
-      const boost::iterator_range<std::vector<char>::const_iterator>
-        &           data_range,
-      PropertyPool &property_pool)
-    {
-      std::vector<Particle<dim, spacedim>> particles;
-
-      if (data_range.empty())
-        return particles;
-
-      Particle<dim, spacedim> particle;
-      particle.set_property_pool(property_pool);
-      const unsigned int particle_size = particle.serialized_size_in_bytes();
-
-      particles.reserve(data_range.size() / particle_size);
-
-      const void *data = static_cast<const void *>(&(*data_range.begin()));
-
-      while (data < &(*data_range.end()))
-        {
-          particles.emplace_back(data, &property_pool);
-        }
 
-      Assert(
-        data == &(*data_range.end()),
-        ExcMessage(
-          "The particle data could not be deserialized successfully. "
-          "Check that when deserializing the particles you expect the same "
-          "number of properties that were serialized."));
 
-      return particles;
+    /**
+     * Return the location of the particle whose serialized data starts at
+     * @p data, without advancing the pointer.
+     */
+    template <int spacedim>
+    Point<spacedim>
+    get_serialized_location(const void *data)
+    {
+      const types::particle_index *id_data =
+        static_cast<const types::particle_index *>(data);
+      ++id_data;
+      const double *pdata = reinterpret_cast<const double *>(id_data);
+
+      Point<spacedim> location;
+      for (unsigned int i = 0; i < spacedim; ++i)
+        location(i) = pdata[i];
+      return location;
     }
   } // namespace
 
@@ -97,7 +90,10 @@ namespace Particles
     , store_callback()
     , load_callback()
     , handle(numbers::invalid_unsigned_int)
-  {}
+  {
+    particles.reinit(0, *property_pool);
+    ghost_particles.reinit(0, *property_pool);
+  }
 
 
 
@@ -105,7 +101,8 @@ namespace Particles
   ParticleHandler<dim, spacedim>::ParticleHandler(
     const Triangulation<dim, spacedim> &triangulation,
     const Mapping<dim, spacedim> &      mapping,
-    const unsigned int                  n_properties)
+    const unsigned int                  n_properties,
+    const PropertyPool::Layout          property_layout)
     : triangulation(&triangulation, typeid(*this).name())
     , mapping(&mapping, typeid(*this).name())
     , particles()
@@ -113,30 +110,52 @@ namespace Particles
     , global_number_of_particles(0)
     , global_max_particles_per_cell(0)
     , next_free_particle_index(0)
-    , property_pool(new PropertyPool(n_properties))
+    , property_pool(new PropertyPool(n_properties, property_layout))
     , size_callback()
     , store_callback()
     , load_callback()
     , handle(numbers::invalid_unsigned_int)
   {
+    particles.reinit(triangulation.n_active_cells(), *property_pool);
+    ghost_particles.reinit(triangulation.n_active_cells(), *property_pool);
+
     triangulation_cache =
       std::make_unique<GridTools::Cache<dim, spacedim>>(triangulation, mapping);
   }
 
 
 
+  template <int dim, int spacedim>
+  ParticleHandler<dim, spacedim>::~ParticleHandler()
+  {
+    // Release the properties of all particles while the property pool that
+    // owns them still exists.
+    particles.clear();
+    ghost_particles.clear();
+  }
+
+
+
   template <int dim, int spacedim>
   void
   ParticleHandler<dim, spacedim>::initialize(
     const Triangulation<dim, spacedim> &new_triangulation,
     const Mapping<dim, spacedim> &      new_mapping,
-    const unsigned int                  n_properties)
+    const unsigned int                  n_properties,
+    const PropertyPool::Layout          property_layout)
   {
     triangulation = &new_triangulation;
     mapping       = &new_mapping;
 
-    // Create the memory pool that will store all particle properties
-    property_pool = std::make_unique<PropertyPool>(n_properties);
+    // Create the memory pool that will store all particle properties. The
+    // particles stored so far own properties in the old pool, so they have
+    // to be removed before the pool is replaced.
+    particles.clear();
+    ghost_particles.clear();
+    property_pool =
+      std::make_unique<PropertyPool>(n_properties, property_layout);
+    particles.reinit(new_triangulation.n_active_cells(), *property_pool);
+    ghost_particles.reinit(new_triangulation.n_active_cells(), *property_pool);
 
     // Create the grid cache to cache the information about the triangulation
     // that is used to locate the particles into subdomains and cells
@@ -174,24 +193,14 @@ namespace Particles
   {
     types::particle_index locally_highest_index        = 0;
     unsigned int          local_max_particles_per_cell = 0;
-    unsigned int          current_particles_per_cell   = 0;
-    typename Triangulation<dim, spacedim>::active_cell_iterator current_cell =
-      triangulation->begin_active();
 
-    for (particle_iterator particle = begin(); particle != end(); ++particle)
+    for (unsigned int cell = 0; cell < particles.n_cells(); ++cell)
       {
-        locally_highest_index =
-          std::max(locally_highest_index, particle->get_id());
-
-        if (particle->get_surrounding_cell(*triangulation) != current_cell)
-          {
-            current_particles_per_cell = 0;
-            current_cell = particle->get_surrounding_cell(*triangulation);
-          }
-
-        ++current_particles_per_cell;
+        const auto &ids = particles.cell_data(cell).ids;
         local_max_particles_per_cell =
-          std::max(local_max_particles_per_cell, current_particles_per_cell);
+          std::max<unsigned int>(local_max_particles_per_cell, ids.size());
+        for (const types::particle_index id : ids)
+          locally_highest_index = std::max(locally_highest_index, id);
       }
 
     if (const auto parallel_triangulation =
@@ -199,7 +208,7 @@ namespace Particles
             &*triangulation))
       {
         global_number_of_particles = dealii::Utilities::MPI::sum(
-          particles.size(), parallel_triangulation->get_communicator());
+          particles.n_particles(), parallel_triangulation->get_communicator());
         next_free_particle_index =
           global_number_of_particles == 0 ?
             0 :
@@ -213,7 +222,7 @@ namespace Particles
       }
     else
       {
-        global_number_of_particles = particles.size();
+        global_number_of_particles = particles.n_particles();
         next_free_particle_index =
           global_number_of_particles == 0 ? 0 : locally_highest_index + 1;
         global_max_particles_per_cell = local_max_particles_per_cell;
@@ -235,7 +244,10 @@ namespace Particles
   typename ParticleHandler<dim, spacedim>::particle_iterator
   ParticleHandler<dim, spacedim>::begin()
   {
-    return particle_iterator(particles, particles.begin());
+    if (triangulation == nullptr)
+      return end();
+
+    return first_particle_from(particles, triangulation->begin_active());
   }
 
 
@@ -253,7 +265,9 @@ namespace Particles
   typename ParticleHandler<dim, spacedim>::particle_iterator
   ParticleHandler<dim, spacedim>::end()
   {
-    return particle_iterator(particles, particles.end());
+    return first_particle_from(
+      particles,
+      typename Triangulation<dim, spacedim>::active_cell_iterator());
   }
 
 
@@ -271,7 +285,10 @@ namespace Particles
   typename ParticleHandler<dim, spacedim>::particle_iterator
   ParticleHandler<dim, spacedim>::begin_ghost()
   {
-    return particle_iterator(ghost_particles, ghost_particles.begin());
+    if (triangulation == nullptr)
+      return end_ghost();
+
+    return first_particle_from(ghost_particles, triangulation->begin_active());
   }
 
 
@@ -289,7 +306,9 @@ namespace Particles
   typename ParticleHandler<dim, spacedim>::particle_iterator
   ParticleHandler<dim, spacedim>::end_ghost()
   {
-    return particle_iterator(ghost_particles, ghost_particles.end());
+    return first_particle_from(
+      ghost_particles,
+      typename Triangulation<dim, spacedim>::active_cell_iterator());
   }
 
 
@@ -300,13 +319,10 @@ namespace Particles
     const typename Triangulation<dim, spacedim>::active_cell_iterator &cell)
     const
   {
-    const internal::LevelInd found_cell =
-      std::make_pair(cell->level(), cell->index());
-
     if (cell->is_locally_owned())
-      return particles.count(found_cell);
+      return particles.n_particles_in_cell(cell->active_cell_index());
     else if (cell->is_ghost())
-      return ghost_particles.count(found_cell);
+      return ghost_particles.n_particles_in_cell(cell->active_cell_index());
     else
       AssertThrow(false,
                   ExcMessage("You can't ask for the particles on an artificial "
@@ -335,30 +351,30 @@ namespace Particles
   ParticleHandler<dim, spacedim>::particles_in_cell(
     const typename Triangulation<dim, spacedim>::active_cell_iterator &cell)
   {
-    const internal::LevelInd level_index =
-      std::make_pair(cell->level(), cell->index());
-
+    const internal::ParticleStorage<dim, spacedim> *particle_storage = nullptr;
     if (cell->is_ghost())
-      {
-        const auto particles_in_cell = ghost_particles.equal_range(level_index);
-        return boost::make_iterator_range(
-          particle_iterator(ghost_particles, particles_in_cell.first),
-          particle_iterator(ghost_particles, particles_in_cell.second));
-      }
+      particle_storage = &ghost_particles;
     else if (cell->is_locally_owned())
-      {
-        const auto particles_in_cell = particles.equal_range(level_index);
-        return boost::make_iterator_range(
-          particle_iterator(particles, particles_in_cell.first),
-          particle_iterator(particles, particles_in_cell.second));
-      }
+      particle_storage = &particles;
     else
       AssertThrow(false,
                   ExcMessage("You can't ask for the particles on an artificial "
                              "cell since we don't know what exists on these "
                              "kinds of cells."));
 
-    return {};
+    const particle_iterator first_particle(*particle_storage, cell, 0);
+
+    if (particle_storage->n_particles_in_cell(cell->active_cell_index()) == 0)
+      return boost::make_iterator_range(first_particle, first_particle);
+
+    // The end of the range is the position an iterator to the last particle
+    // of this cell reaches when it is incremented, i.e., the first particle
+    // of the next cell that contains particles.
+    typename Triangulation<dim, spacedim>::active_cell_iterator next_cell =
+      cell;
+    ++next_cell;
+    return boost::make_iterator_range(
+      first_particle, first_particle_from(*particle_storage, next_cell));
   }
 
 
@@ -368,7 +384,42 @@ namespace Particles
   ParticleHandler<dim, spacedim>::remove_particle(
     const ParticleHandler<dim, spacedim>::particle_iterator &particle)
   {
-    particles.erase(particle->particle);
+    particle->particles->remove_particle(
+      particle->cell->active_cell_index(),
+      particle->particle_index_within_cell);
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  ParticleHandler<dim, spacedim>::remove_particles(
+    const std::vector<ParticleHandler<dim, spacedim>::particle_iterator>
+      &particles_to_remove)
+  {
+    // sort the particles by cell and by their index within the cell, so
+    // that the particles of each cell can be removed in one pass before
+    // any of the remaining indices changes
+    std::vector<std::pair<unsigned int, unsigned int>> cells_and_indices;
+    cells_and_indices.reserve(particles_to_remove.size());
+    for (const auto &particle : particles_to_remove)
+      cells_and_indices.emplace_back(particle->cell->active_cell_index(),
+                                     particle->particle_index_within_cell);
+    std::sort(cells_and_indices.begin(), cells_and_indices.end());
+
+    std::vector<unsigned int> indices_to_remove;
+    for (unsigned int i = 0; i < cells_and_indices.size();)
+      {
+        const unsigned int cell_index = cells_and_indices[i].first;
+
+        indices_to_remove.clear();
+        for (; i < cells_and_indices.size() &&
+               cells_and_indices[i].first == cell_index;
+             ++i)
+          indices_to_remove.push_back(cells_and_indices[i].second);
+
+        particles.remove_particles(cell_index, indices_to_remove);
+      }
   }
 
 
@@ -379,20 +430,12 @@ namespace Particles
     const Particle<dim, spacedim> &                                    particle,
     const typename Triangulation<dim, spacedim>::active_cell_iterator &cell)
   {
-    typename std::multimap<internal::LevelInd,
-                           Particle<dim, spacedim>>::iterator it =
-      particles.insert(
-        std::make_pair(internal::LevelInd(cell->level(), cell->index()),
-                       particle));
-
-    particle_iterator particle_it(particles, it);
-    particle_it->set_property_pool(*property_pool);
+    resize_particle_storage();
 
-    if (particle.has_properties())
-      for (unsigned int n = 0; n < particle.get_properties().size(); ++n)
-        particle_it->get_properties()[n] = particle.get_properties()[n];
+    const unsigned int index_within_cell =
+      particles.insert(cell->active_cell_index(), particle);
 
-    return particle_it;
+    return particle_iterator(particles, cell, index_within_cell);
   }
 
 
@@ -404,13 +447,11 @@ namespace Particles
       typename Triangulation<dim, spacedim>::active_cell_iterator,
       Particle<dim, spacedim>> &new_particles)
   {
-    for (auto particle = new_particles.begin(); particle != new_particles.end();
-         ++particle)
-      particles.insert(
-        particles.end(),
-        std::make_pair(internal::LevelInd(particle->first->level(),
-                                          particle->first->index()),
-                       particle->second));
+    resize_particle_storage();
+
+    for (const auto &cell_and_particle : new_particles)
+      particles.insert(cell_and_particle.first->active_cell_index(),
+                       cell_and_particle.second);
 
     update_cached_numbers();
   }
@@ -461,21 +502,17 @@ namespace Particles
     if (cells.size() == 0)
       return;
 
-    auto hint =
-      particles.find(std::make_pair(cells[0]->level(), cells[0]->index()));
+    resize_particle_storage();
+
     for (unsigned int i = 0; i < cells.size(); ++i)
       {
-        internal::LevelInd current_cell(cells[i]->level(), cells[i]->index());
+        const unsigned int cell_index = cells[i]->active_cell_index();
         for (unsigned int p = 0; p < local_positions[i].size(); ++p)
-          {
-            hint = particles.insert(
-              hint,
-              std::make_pair(current_cell,
-                             Particle<dim, spacedim>(positions[index_map[i][p]],
-                                                     local_positions[i][p],
-                                                     local_start_index +
-                                                       index_map[i][p])));
-          }
+          particles.insert(cell_index,
+                           Particle<dim, spacedim>(positions[index_map[i][p]],
+                                                   local_positions[i][p],
+                                                   local_start_index +
+                                                     index_map[i][p]));
       }
 
     update_cached_numbers();
@@ -703,7 +740,7 @@ namespace Particles
   types::particle_index
   ParticleHandler<dim, spacedim>::n_locally_owned_particles() const
   {
-    return particles.size();
+    return particles.n_particles();
   }
 
 
@@ -819,6 +856,53 @@ namespace Particles
 
 
 
+  template <int dim, int spacedim>
+  void
+  ParticleHandler<dim, spacedim>::resize_particle_storage()
+  {
+    const unsigned int n_active_cells = triangulation->n_active_cells();
+
+    if (particles.n_cells() != n_active_cells)
+      {
+        Assert(particles.n_particles() == 0,
+               ExcMessage("The triangulation has changed since the particles "
+                          "were inserted, so their cells are no longer known. "
+                          "Use register_store_callback_function() and "
+                          "register_load_callback_function() to transfer "
+                          "particles across mesh refinement."));
+        particles.reinit(n_active_cells, *property_pool);
+      }
+
+    // Ghost particles can always be discarded, they are recreated by the
+    // next call to exchange_ghost_particles().
+    if (ghost_particles.n_cells() != n_active_cells)
+      ghost_particles.reinit(n_active_cells, *property_pool);
+  }
+
+
+
+  template <int dim, int spacedim>
+  typename ParticleHandler<dim, spacedim>::particle_iterator
+  ParticleHandler<dim, spacedim>::first_particle_from(
+    const internal::ParticleStorage<dim, spacedim> &particle_storage,
+    typename Triangulation<dim, spacedim>::active_cell_iterator cell) const
+  {
+    if (particle_storage.n_particles() > 0)
+      for (; cell.state() == IteratorState::valid; ++cell)
+        if (particle_storage.n_particles_in_cell(cell->active_cell_index()) > 0)
+          return particle_iterator(particle_storage, cell, 0);
+
+    if (triangulation == nullptr)
+      return particle_iterator(
+        particle_storage,
+        typename Triangulation<dim, spacedim>::active_cell_iterator(),
+        0);
+
+    return particle_iterator(particle_storage, triangulation->end(), 0);
+  }
+
+
+
   namespace
   {
     /**
@@ -894,12 +978,14 @@ namespace Particles
 
     // There are three reasons why a particle is not in its old cell:
     // It moved to another cell, to another subdomain or it left the mesh.
-    // Particles that moved to another cell are updated and stored inside the
-    // sorted_particles vector, particles that moved to another domain are
-    // collected in the moved_particles_domain vector. Particles that left
-    // the mesh completely are ignored and removed.
-    std::vector<std::pair<internal::LevelInd, Particle<dim, spacedim>>>
-      sorted_particles;
+    // Particles that moved to another cell are collected together with their
+    // new cell in the relocated_particles vector, particles that moved to
+    // another domain are collected in the moved_particles map. Particles
+    // that left the mesh completely are ignored and removed.
+    std::vector<std::pair<
+      particle_iterator,
+      typename Triangulation<dim, spacedim>::active_cell_iterator>>
+      relocated_particles;
     std::map<types::subdomain_id, std::vector<particle_iterator>>
       moved_particles;
     std::map<
@@ -913,7 +999,7 @@ namespace Particles
     // automatic and relatively fast (compared to other parts of this
     // algorithm) re-allocation will happen.
     using vector_size = typename std::vector<particle_iterator>::size_type;
-    sorted_particles.reserve(
+    relocated_particles.reserve(
       static_cast<vector_size>(particles_out_of_cell.size() * 1.25));
 
     std::set<types::subdomain_id> ghost_owners;
@@ -1046,10 +1132,7 @@ namespace Particles
           // Mark it for MPI transfer otherwise
           if (current_cell->is_locally_owned())
             {
-              sorted_particles.push_back(
-                std::make_pair(internal::LevelInd(current_cell->level(),
-                                                  current_cell->index()),
-                               (*it)->particle->second));
+              relocated_particles.emplace_back(*it, current_cell);
             }
           else
             {
@@ -1059,12 +1142,10 @@ namespace Particles
         }
     }
 
-    // Sort the updated particles. This pre-sort speeds up inserting
-    // them into particles to O(N) complexity.
-    std::multimap<internal::LevelInd, Particle<dim, spacedim>>
-      sorted_particles_map;
-
-    // Exchange particles between processors if we have more than one process
+    // Exchange particles between processors if we have more than one
+    // process. The received particles are appended to the particles of their
+    // new cells. This does not change the position of any particle that is
+    // still to be processed below.
 #ifdef DEAL_II_WITH_MPI
     if (const auto parallel_triangulation =
           dynamic_cast<const parallel::Triangulation<dim, spacedim> *>(
@@ -1072,19 +1153,39 @@ namespace Particles
       {
         if (dealii::Utilities::MPI::n_mpi_processes(
               parallel_triangulation->get_communicator()) > 1)
-          send_recv_particles(moved_particles,
-                              sorted_particles_map,
-                              moved_cells);
+          send_recv_particles(moved_particles, particles, moved_cells);
       }
 #endif
 
-    sorted_particles_map.insert(sorted_particles.begin(),
-                                sorted_particles.end());
-
-    for (unsigned int i = 0; i < particles_out_of_cell.size(); ++i)
-      remove_particle(particles_out_of_cell[i]);
+    // Append the particles that stayed on this process to the particles of
+    // their new cells. This transfers their properties without copying.
+    for (const auto &particle_and_cell : relocated_particles)
+      particles.relocate(
+        particle_and_cell.first->cell->active_cell_index(),
+        particle_and_cell.first->particle_index_within_cell,
+        particle_and_cell.second->active_cell_index());
+
+    // Finally compact the cells the particles have left. Since the particles
+    // were collected in the order of iteration, the particles of each cell
+    // are contiguous in this vector and sorted by their index within the
+    // cell.
+    std::vector<unsigned int> indices_to_remove;
+    for (unsigned int i = 0; i < particles_out_of_cell.size();)
+      {
+        const unsigned int cell_index =
+          particles_out_of_cell[i]->cell->active_cell_index();
+
+        indices_to_remove.clear();
+        for (; i < particles_out_of_cell.size() &&
+               particles_out_of_cell[i]->cell->active_cell_index() ==
+                 cell_index;
+             ++i)
+          indices_to_remove.push_back(
+            particles_out_of_cell[i]->particle_index_within_cell);
+
+        particles.remove_particles(cell_index, indices_to_remove);
+      }
 
-    particles.insert(sorted_particles_map.begin(), sorted_particles_map.end());
     update_cached_numbers();
   }
 
@@ -1109,6 +1210,7 @@ namespace Particles
 
 #ifdef DEAL_II_WITH_MPI
     // First clear the current ghost_particle information
+    resize_particle_storage();
     ghost_particles.clear();
 
     std::map<types::subdomain_id, std::vector<particle_iterator>>
@@ -1119,7 +1221,7 @@ namespace Particles
     for (const auto ghost_owner : ghost_owners)
       ghost_particles_by_domain[ghost_owner].reserve(
         static_cast<typename std::vector<particle_iterator>::size_type>(
-          particles.size() * 0.25));
+          particles.n_particles() * 0.25));
 
     std::vector<std::set<unsigned int>> vertex_to_neighbor_subdomain(
       triangulation->n_vertices());
@@ -1172,9 +1274,8 @@ namespace Particles
   void
   ParticleHandler<dim, spacedim>::send_recv_particles(
     const std::map<types::subdomain_id, std::vector<particle_iterator>>
-      &particles_to_send,
-    std::multimap<internal::LevelInd, Particle<dim, spacedim>>
-      &received_particles,
+      &                                       particles_to_send,
+    internal::ParticleStorage<dim, spacedim> &received_particles,
     const std::map<
       types::subdomain_id,
       std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>>
@@ -1233,7 +1334,7 @@ namespace Particles
       {
         // Allocate space for sending particle data
         const unsigned int particle_size =
-          begin()->serialized_size_in_bytes() + cellid_size +
+          particles.serialized_size_in_bytes() + cellid_size +
           (size_callback ? size_callback() : 0);
         send_data.resize(n_send_particles * particle_size);
         void *data = static_cast<void *>(&send_data.front());
@@ -1366,7 +1467,14 @@ namespace Particles
     }
 
     // Put the received particles into the domain if they are in the
-    // triangulation
+    // triangulation. Since all particles have the same size, we know how many
+    // particles arrive and can grow the property pool once up front.
+    const unsigned int received_particle_size =
+      received_particles.serialized_size_in_bytes() + cellid_size +
+      (size_callback ? size_callback() : 0);
+    property_pool->reserve(property_pool->n_allocated_slots() +
+                           total_recv_data / received_particle_size);
+
     const void *recv_data_it = static_cast<const void *>(recv_data.data());
 
     while (reinterpret_cast<std::size_t>(recv_data_it) -
@@ -1381,16 +1489,14 @@ namespace Particles
         const typename Triangulation<dim, spacedim>::active_cell_iterator cell =
           id.to_cell(*triangulation);
 
-        typename std::multimap<internal::LevelInd,
-                               Particle<dim, spacedim>>::iterator
-          recv_particle = received_particles.insert(std::make_pair(
-            internal::LevelInd(cell->level(), cell->index()),
-            Particle<dim, spacedim>(recv_data_it, property_pool.get())));
+        const unsigned int index_within_cell =
+          received_particles.insert(cell->active_cell_index(), recv_data_it);
 
         if (load_callback)
-          recv_data_it =
-            load_callback(particle_iterator(received_particles, recv_particle),
-                          recv_data_it);
+          recv_data_it = load_callback(particle_iterator(received_particles,
+                                                         cell,
+                                                         index_within_cell),
+                                       recv_data_it);
       }
 
     AssertThrow(recv_data_it == recv_data.data() + recv_data.size(),
@@ -1460,8 +1566,9 @@ namespace Particles
     const bool serialization)
   {
     // All particles have been stored, when we reach this point. Empty the
-    // particle data.
+    // particle data and set up the containers for the new mesh.
     clear_particles();
+    resize_particle_storage();
 
     parallel::distributed::Triangulation<dim, spacedim>
       *non_const_triangulation =
@@ -1525,7 +1632,7 @@ namespace Particles
     const typename Triangulation<dim, spacedim>::cell_iterator &cell,
     const typename Triangulation<dim, spacedim>::CellStatus     status) const
   {
-    std::vector<Particle<dim, spacedim>> stored_particles_on_cell;
+    std::vector<char> buffer;
 
     switch (status)
       {
@@ -1533,73 +1640,24 @@ namespace Particles
         case parallel::distributed::Triangulation<dim, spacedim>::CELL_REFINE:
           // If the cell persist or is refined store all particles of the
           // current cell.
-          {
-            unsigned int n_particles = 0;
-
-            const internal::LevelInd level_index = {cell->level(),
-                                                    cell->index()};
-            const auto               particles_in_cell =
-              (cell->is_ghost() ? ghost_particles.equal_range(level_index) :
-                                  particles.equal_range(level_index));
-
-            n_particles = n_particles_in_cell(cell);
-            stored_particles_on_cell.reserve(n_particles);
-
-            std::for_each(
-              particles_in_cell.first,
-              particles_in_cell.second,
-              [&stored_particles_on_cell](
-                const std::pair<internal::LevelInd, Particle<dim, spacedim>>
-                  &particle) {
-                stored_particles_on_cell.push_back(particle.second);
-              });
-
-            AssertDimension(n_particles, stored_particles_on_cell.size());
-          }
+          pack_particles(cell->is_ghost() ? ghost_particles : particles,
+                         cell,
+                         buffer);
           break;
 
         case parallel::distributed::Triangulation<dim, spacedim>::CELL_COARSEN:
           // If this cell is the parent of children that will be coarsened,
           // collect the particles of all children.
-          {
-            unsigned int n_particles = 0;
-
-            for (unsigned int child_index = 0;
-                 child_index < GeometryInfo<dim>::max_children_per_cell;
-                 ++child_index)
-              {
-                const typename Triangulation<dim, spacedim>::cell_iterator
-                  child = cell->child(child_index);
-                n_particles += n_particles_in_cell(child);
-              }
-
-            stored_particles_on_cell.reserve(n_particles);
-
-            for (unsigned int child_index = 0;
-                 child_index < GeometryInfo<dim>::max_children_per_cell;
-                 ++child_index)
-              {
-                const typename Triangulation<dim, spacedim>::cell_iterator
-                                         child       = cell->child(child_index);
-                const internal::LevelInd level_index = {child->level(),
-                                                        child->index()};
-                const auto               particles_in_cell =
-                  (child->is_ghost() ?
-                     ghost_particles.equal_range(level_index) :
-                     particles.equal_range(level_index));
-
-                std::for_each(
-                  particles_in_cell.first,
-                  particles_in_cell.second,
-                  [&stored_particles_on_cell](
-                    const std::pair<internal::LevelInd, Particle<dim, spacedim>>
-                      &particle) {
-                    stored_particles_on_cell.push_back(particle.second);
-                  });
-              }
-
-            AssertDimension(n_particles, stored_particles_on_cell.size());
-          }
+          for (unsigned int child_index = 0;
+               child_index < GeometryInfo<dim>::max_children_per_cell;
+               ++child_index)
+            {
+              const typename Triangulation<dim, spacedim>::cell_iterator child =
+                cell->child(child_index);
+              pack_particles(child->is_ghost() ? ghost_particles : particles,
+                             child,
+                             buffer);
+            }
           break;
 
         default:
@@ -1607,7 +1665,7 @@ namespace Particles
           break;
       }
 
-    return pack_particles(stored_particles_on_cell);
+    return buffer;
   }
 
   template <int dim, int spacedim>
@@ -1617,83 +1675,49 @@ namespace Particles
     const typename Triangulation<dim, spacedim>::CellStatus         status,
     const boost::iterator_range<std::vector<char>::const_iterator> &data_range)
   {
-    // We leave this container non-const to be able to `std::move`
-    // its contents directly into the particles multimap later.
-    std::vector<Particle<dim, spacedim>> loaded_particles_on_cell =
-      unpack_particles<dim, spacedim>(data_range, *property_pool);
+    if (data_range.empty())
+      return;
 
-    // Update the reference to the current property pool for all particles.
-    // This was not stored, because they might be transported across process
-    // domains.
-    for (auto &particle : loaded_particles_on_cell)
-      particle.set_property_pool(*property_pool);
+    const std::size_t particle_size = particles.serialized_size_in_bytes();
+    const void *      data = static_cast<const void *>(&(*data_range.begin()));
+    const void *const data_end =
+      static_cast<const void *>(&(*data_range.end()));
 
     switch (status)
       {
         case parallel::distributed::Triangulation<dim, spacedim>::CELL_PERSIST:
           {
-            auto position_hint = particles.end();
-            for (const auto &particle : loaded_particles_on_cell)
-              {
-                // Use std::multimap::emplace_hint to speed up insertion of
-                // particles.
-                position_hint =
-                  particles.emplace_hint(position_hint,
-                                         std::make_pair(cell->level(),
-                                                        cell->index()),
-                                         std::move(particle));
-                // Move the hint position forward by one, i.e., for the next
-                // particle. The 'hint' position will thus be right after the
-                // one just inserted.
-                ++position_hint;
-              }
+            while (data < data_end)
+              particles.insert(cell->active_cell_index(), data);
           }
           break;
 
         case parallel::distributed::Triangulation<dim, spacedim>::CELL_COARSEN:
           {
-            typename std::multimap<internal::LevelInd,
-                                   Particle<dim, spacedim>>::iterator
-              position_hint = particles.end();
-            for (auto &particle : loaded_particles_on_cell)
+            const unsigned int cell_index = cell->active_cell_index();
+            auto &reference_locations =
+              particles.cell_data(cell_index).reference_locations;
+            while (data < data_end)
               {
-                const Point<dim> p_unit =
-                  mapping->transform_real_to_unit_cell(cell,
-                                                       particle.get_location());
-                particle.set_reference_location(p_unit);
-                // Use std::multimap::emplace_hint to speed up insertion of
-                // particles.
-                position_hint =
-                  particles.emplace_hint(position_hint,
-                                         std::make_pair(cell->level(),
-                                                        cell->index()),
-                                         std::move(particle));
-                // Move the hint position forward by one, i.e., for the next
-                // particle. The 'hint' position will thus be right after the
-                // one just inserted.
-                ++position_hint;
+                const unsigned int index_within_cell =
+                  particles.insert(cell_index, data);
+                reference_locations[index_within_cell] =
+                  mapping->transform_real_to_unit_cell(
+                    cell,
+                    particles.cell_data(cell_index)
+                      .locations[index_within_cell]);
               }
           }
           break;
 
         case parallel::distributed::Triangulation<dim, spacedim>::CELL_REFINE:
           {
-            std::vector<
-              typename std::multimap<internal::LevelInd,
-                                     Particle<dim, spacedim>>::iterator>
-              position_hints(GeometryInfo<dim>::max_children_per_cell);
-            for (unsigned int child_index = 0;
-                 child_index < GeometryInfo<dim>::max_children_per_cell;
-                 ++child_index)
+            while (data < data_end)
               {
-                const typename Triangulation<dim, spacedim>::cell_iterator
-                  child                     = cell->child(child_index);
-                position_hints[child_index] = particles.upper_bound(
-                  std::make_pair(child->level(), child->index()));
-              }
+                const Point<spacedim> location =
+                  get_serialized_location<spacedim>(data);
 
-            for (auto &particle : loaded_particles_on_cell)
-              {
+                bool found_child = false;
                 for (unsigned int child_index = 0;
                      child_index < GeometryInfo<dim>::max_children_per_cell;
                      ++child_index)
@@ -1704,28 +1728,27 @@ namespace Particles
                     try
                       {
                         const Point<dim> p_unit =
-                          mapping->transform_real_to_unit_cell(
-                            child, particle.get_location());
+                          mapping->transform_real_to_unit_cell(child,
+                                                               location);
                         if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
                           {
-                            particle.set_reference_location(p_unit);
-                            // Use std::multimap::emplace_hint to speed up
-                            // insertion of particles.
-                            position_hints[child_index] =
-                              particles.emplace_hint(
-                                position_hints[child_index],
-                                std::make_pair(child->level(), child->index()),
-                                std::move(particle));
-                            // Move the hint position forward by one, i.e.,
-                            // for the next particle. The 'hint' position will
-                            // thus be right after the one just inserted.
-                            ++position_hints[child_index];
+                            const unsigned int child_cell_index =
+                              child->active_cell_index();
+                            const unsigned int index_within_cell =
+                              particles.insert(child_cell_index, data);
+                            particles.cell_data(child_cell_index)
+                              .reference_locations[index_within_cell] = p_unit;
+                            found_child = true;
                             break;
                           }
                       }
                     catch (typename Mapping<dim>::ExcTransformationFailed &)
                       {}
                   }
+
+                // Particles that are in none of the children are discarded.
+                if (!found_child)
+                  data = static_cast<const char *>(data) + particle_size;
               }
           }
           break;
@@ -1734,6 +1757,12 @@ namespace Particles
           Assert(false, ExcInternalError());
           break;
       }
+
+    Assert(data == data_end,
+           ExcMessage(
+             "The particle data could not be deserialized successfully. "
+             "Check that when deserializing the particles you expect the same "
+             "number of properties that were serialized."));
   }
 } // namespace Particles
 
@@ -21,10 +21,10 @@ namespace Particles
 {
   template <int dim, int spacedim>
   ParticleIterator<dim, spacedim>::ParticleIterator(
-    const std::multimap<internal::LevelInd, Particle<dim, spacedim>> &map,
-    const typename std::multimap<internal::LevelInd,
-                                 Particle<dim, spacedim>>::iterator & particle)
-    : accessor(map, particle)
+    const internal::ParticleStorage<dim, spacedim> &particles,
+    const typename Triangulation<dim, spacedim>::active_cell_iterator &cell,
+    const unsigned int particle_index_within_cell)
+    : accessor(particles, cell, particle_index_within_cell)
   {}
 
 
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2017 - 2018 by the deal.II authors
+// Copyright (C) 2017 - 2020 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -22,9 +22,13 @@ namespace Particles
 {
   const PropertyPool::Handle PropertyPool::invalid_handle = nullptr;
 
+  constexpr unsigned int PropertyPool::slots_per_slab;
 
-  PropertyPool::PropertyPool(const unsigned int n_properties_per_slot)
+
+  PropertyPool::PropertyPool(const unsigned int n_properties_per_slot,
+                             const Layout       layout)
     : n_properties(n_properties_per_slot)
+    , layout(layout)
   {}
 
 
@@ -32,19 +36,58 @@ namespace Particles
   PropertyPool::Handle
   PropertyPool::allocate_properties_array()
   {
-    PropertyPool::Handle handle = PropertyPool::invalid_handle;
-    if (n_properties > 0)
-      handle = new double[n_properties];
+    if (n_properties == 0)
+      return PropertyPool::invalid_handle;
+
+    if (free_slots.empty())
+      add_slab();
 
+    const Handle handle = free_slots.back();
+    free_slots.pop_back();
     return handle;
   }
 
 
 
+  std::vector<PropertyPool::Handle>
+  PropertyPool::allocate_properties_arrays(const std::size_t n_slots)
+  {
+    if (n_properties == 0)
+      return std::vector<Handle>(n_slots, invalid_handle);
+
+    reserve(n_allocated_slots() + n_slots);
+    Assert(free_slots.size() >= n_slots, ExcInternalError());
+
+    std::vector<Handle> handles(free_slots.rbegin(),
+                                free_slots.rbegin() + n_slots);
+    free_slots.resize(free_slots.size() - n_slots);
+    return handles;
+  }
+
+
+
   void
   PropertyPool::deallocate_properties_array(Handle handle)
   {
-    delete[] handle;
+    if (handle != invalid_handle)
+      free_slots.push_back(handle);
+  }
+
+
+
+  void
+  PropertyPool::deallocate_properties_arrays(
+    const ArrayView<const Handle> &handles)
+  {
+    // insert in reverse order, so that the slots are handed out again in the
+    // order in which they were given in
+    free_slots.reserve(free_slots.size() + handles.size());
+    for (auto handle = handles.end(); handle != handles.begin();)
+      {
+        --handle;
+        if (*handle != invalid_handle)
+          free_slots.push_back(*handle);
+      }
   }
 
 
@@ -52,15 +95,42 @@ namespace Particles
   ArrayView<double>
   PropertyPool::get_properties(const Handle handle)
   {
+    Assert(layout == Layout::array_of_structures,
+           ExcMessage("The properties of a particle are only stored "
+                      "contiguously if the PropertyPool uses the "
+                      "array_of_structures layout. Use get_property() "
+                      "to access individual properties instead."));
+
     return ArrayView<double>(handle, n_properties);
   }
 
 
 
+  ArrayView<double>
+  PropertyPool::get_slab_column(const unsigned int slab,
+                                const unsigned int component)
+  {
+    Assert(layout == Layout::structure_of_arrays,
+           ExcMessage("Columns of properties are only stored contiguously "
+                      "if the PropertyPool uses the structure_of_arrays "
+                      "layout."));
+    AssertIndexRange(slab, slabs.size());
+    AssertIndexRange(component, n_properties);
+
+    return ArrayView<double>(slabs[slab].data() + component * slots_per_slab,
+                             slots_per_slab);
+  }
+
+
+
   void
   PropertyPool::reserve(const std::size_t size)
   {
-    (void)size;
+    if (n_properties == 0)
+      return;
+
+    while (n_allocated_slots() + free_slots.size() < size)
+      add_slab();
   }
 
 
@@ -70,5 +140,54 @@ namespace Particles
   {
     return n_properties;
   }
+
+
+
+  PropertyPool::Layout
+  PropertyPool::get_layout() const
+  {
+    return layout;
+  }
+
+
+
+  unsigned int
+  PropertyPool::n_slabs() const
+  {
+    return slabs.size();
+  }
+
+
+
+  std::size_t
+  PropertyPool::n_allocated_slots() const
+  {
+    return slabs.size() * static_cast<std::size_t>(slots_per_slab) -
+           free_slots.size();
+  }
+
+
+
+  void
+  PropertyPool::add_slab()
+  {
+    Assert(n_properties > 0, ExcInternalError());
+
+    // slabs are only ever appended, and AlignedVector keeps its memory when
+    // the surrounding std::vector moves it, so existing handles stay valid
+    slabs.emplace_back(slots_per_slab * n_properties);
+    double *const slab = slabs.back().data();
+
+    // the slot with the lowest address ends up at the back of the free list
+    // and is therefore handed out first
+    const unsigned int stride =
+      (layout == Layout::array_of_structures) ? n_properties : 1;
+    free_slots.reserve(free_slots.size() + slots_per_slab);
+    for (unsigned int slot = slots_per_slab; slot > 0;)
+      {
+        --slot;
+        free_slots.push_back(slab + slot * stride);
+      }
+  }
 } // namespace Particles
 DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,67 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// check that HardwareCounters can be used regardless of whether the counters
+// are available on the machine running the test: available counters must
+// not decrease, and unavailable ones must be read as NaN
+
+#include <deal.II/base/hardware_counters.h>
+
+#include <cmath>
+
+#include "../tests.h"
+
+
+int
+main()
+{
+  initlog();
+
+  const std::vector<HardwareCounters::Event> events = {
+    HardwareCounters::cycles,
+    HardwareCounters::instructions,
+    HardwareCounters::cache_references,
+    HardwareCounters::cache_misses,
+    HardwareCounters::branch_instructions,
+    HardwareCounters::branch_misses,
+    HardwareCounters::double_precision_flops,
+    HardwareCounters::single_precision_flops};
+
+  HardwareCounters counters(events);
+  AssertThrow(counters.get_events() == events, ExcInternalError());
+
+  std::vector<double> start, end;
+  counters.read(start);
+
+  double sum = 0.;
+  for (unsigned int i = 0; i < 1000000; ++i)
+    sum += std::sqrt(static_cast<double>(i));
+  deallog << "Sum: " << sum << std::endl;
+
+  counters.read(end);
+  AssertThrow(start.size() == events.size() && end.size() == events.size(),
+              ExcInternalError());
+
+  for (unsigned int e = 0; e < events.size(); ++e)
+    {
+      const bool valid =
+        counters.is_available(e) ?
+          (std::isfinite(start[e]) && start[e] >= 0. && end[e] >= start[e]) :
+          (std::isnan(start[e]) && std::isnan(end[e]));
+      deallog << HardwareCounters::get_name(events[e]) << ": "
+              << (valid ? "OK" : "invalid") << std::endl;
+    }
+}
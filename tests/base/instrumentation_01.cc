@@ -0,0 +1,156 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the hierarchy of regions recorded by the functions in namespace
+// Instrumentation for nested regions, regions entered on several threads,
+// and the built-in probe in SolverCG, as well as the number of events
+// written into a trace
+
+#include <deal.II/base/instrumentation.h>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector.h>
+
+#include <numeric>
+#include <thread>
+
+#include "../tests.h"
+
+
+void
+inner()
+{
+  static const Instrumentation::Region region("inner");
+  Instrumentation::Scope               scope(region);
+}
+
+
+
+void
+outer()
+{
+  static const Instrumentation::Region region("outer");
+  Instrumentation::Scope               scope(region);
+
+  inner();
+  inner();
+}
+
+
+
+void
+solve()
+{
+  static const Instrumentation::Region region("solve");
+  Instrumentation::Scope               scope(region);
+
+  FullMatrix<double> matrix(4, 4);
+  Vector<double>     rhs(4), solution(4);
+  for (unsigned int i = 0; i < 4; ++i)
+    {
+      matrix(i, i) = 2. + i;
+      rhs(i)       = 1.;
+    }
+
+  SolverControl            control(10, 1e-12);
+  SolverCG<Vector<double>> solver(control);
+  solver.solve(matrix, solution, rhs, PreconditionIdentity());
+}
+
+
+
+void
+print_statistics()
+{
+  for (const Instrumentation::RegionStatistics &entry :
+       Instrumentation::get_statistics(MPI_COMM_SELF))
+    {
+      std::string path;
+      for (const std::string &name : entry.path)
+        path += (path.empty() ? "" : "/") + name;
+
+      const unsigned long long int histogram_sum =
+        std::accumulate(entry.histogram.begin(),
+                        entry.histogram.end(),
+                        0ull);
+      const bool valid =
+        histogram_sum == entry.n_calls &&
+        entry.min_call_time <= entry.max_call_time &&
+        entry.total_time.min == entry.total_time.max &&
+        entry.total_time.max >= entry.max_call_time &&
+        entry.imbalance() == 1.;
+
+      deallog << path << ": " << entry.n_calls << " calls, "
+              << (valid ? "OK" : "invalid statistics") << std::endl;
+    }
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  // nothing is recorded before the instrumentation is enabled
+  outer();
+  deallog << "Disabled: "
+          << Instrumentation::get_statistics(MPI_COMM_SELF).size()
+          << " regions" << std::endl;
+
+  Instrumentation::enable(/*record_trace = */ true);
+  for (unsigned int i = 0; i < 3; ++i)
+    outer();
+  inner();
+  solve();
+
+  // regions entered on other threads are recorded separately for each
+  // thread, and start at the top level of the hierarchy
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < 4; ++t)
+    threads.emplace_back([]() {
+      for (unsigned int i = 0; i < 5; ++i)
+        outer();
+    });
+  for (std::thread &thread : threads)
+    thread.join();
+
+  print_statistics();
+
+  std::ostringstream trace;
+  Instrumentation::write_chrome_trace(trace, MPI_COMM_SELF);
+  const std::string trace_string = trace.str();
+  unsigned int      n_events     = 0;
+  for (std::size_t p = trace_string.find("\"ph\":\"X\"");
+       p != std::string::npos;
+       p = trace_string.find("\"ph\":\"X\"", p + 1))
+    ++n_events;
+  deallog << "Trace: " << n_events << " events, "
+          << (trace_string.find("{\"traceEvents\":[") == 0 ? "OK" : "invalid")
+          << std::endl;
+
+  // after a reset, recording starts from scratch
+  Instrumentation::reset();
+  Instrumentation::disable();
+  outer();
+  Instrumentation::enable();
+  inner();
+  print_statistics();
+}
@@ -0,0 +1,87 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// check that Instrumentation records hardware counters for the built-in
+// probes in SparseMatrix::vmult() and LinearAlgebra::distributed::Vector.
+// The counters might not be available on the machine running the test, so
+// we only check that the values are consistent
+
+#include <deal.II/base/instrumentation.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include <cmath>
+
+#include "../tests.h"
+
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int size = 100;
+  SparsityPattern    sparsity(size, size, 1);
+  sparsity.compress();
+  SparseMatrix<double> matrix(sparsity);
+  for (unsigned int i = 0; i < size; ++i)
+    matrix.diag_element(i) = 2.;
+
+  LinearAlgebra::distributed::Vector<double> src(size), dst(size);
+  src = 1.;
+
+  Instrumentation::enable();
+  Instrumentation::enable_hardware_counters(
+    {HardwareCounters::cycles, HardwareCounters::instructions});
+  AssertThrow(Instrumentation::get_hardware_counter_events().size() == 2,
+              ExcInternalError());
+
+  for (unsigned int i = 0; i < 3; ++i)
+    {
+      matrix.vmult(dst, src);
+      dst.add(1., src);
+    }
+  deallog << "Norm: " << dst.l2_norm() << std::endl;
+
+  for (const Instrumentation::RegionStatistics &entry :
+       Instrumentation::get_statistics(MPI_COMM_SELF))
+    {
+      bool valid = (entry.hardware_counters.size() == 2);
+      for (const double value : entry.hardware_counters)
+        valid = valid && (std::isnan(value) || value >= 0.);
+      deallog << entry.path.back() << ": " << entry.n_calls << " calls, "
+              << (valid ? "OK" : "invalid counters") << std::endl;
+    }
+
+  // the table of the counters is printed after the table of the times
+  std::ostringstream out;
+  Instrumentation::print_statistics(out, MPI_COMM_SELF);
+  deallog << "Table of counters: "
+          << (out.str().find("|        cycles |  instructions |") !=
+                  std::string::npos ?
+                "OK" :
+                "missing")
+          << std::endl;
+
+  // without counters, the statistics contain no counter values
+  Instrumentation::enable_hardware_counters({});
+  for (const Instrumentation::RegionStatistics &entry :
+       Instrumentation::get_statistics(MPI_COMM_SELF))
+    AssertThrow(entry.hardware_counters.empty(), ExcInternalError());
+  deallog << "Disabled counters: OK" << std::endl;
+}
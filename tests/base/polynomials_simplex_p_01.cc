@@ -0,0 +1,114 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the Lagrange property of PolynomialsSimplexP in the support points,
+// the partition of unity, and the consistency of evaluate() with the
+// compute_* functions and of the gradients with finite differences
+
+#include <deal.II/base/polynomials_simplex_p.h>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+void
+test(const unsigned int degree)
+{
+  const PolynomialsSimplexP<dim> poly(degree);
+  const unsigned int             n = poly.n();
+
+  deallog << poly.name() << "<" << dim << ">(" << degree << "): " << n
+          << " polynomials" << std::endl;
+  if (degree == 2)
+    for (const Point<dim> &p : poly.get_support_points())
+      deallog << "Support point " << p << std::endl;
+
+  double max_error_lagrange = 0;
+  for (unsigned int i = 0; i < n; ++i)
+    for (unsigned int k = 0; k < n; ++k)
+      max_error_lagrange =
+        std::max(max_error_lagrange,
+                 std::abs(poly.compute_value(i, poly.get_support_points()[k]) -
+                          (i == k ? 1. : 0.)));
+
+  // evaluate in a point inside the simplex
+  Point<dim> p;
+  for (unsigned int d = 0; d < dim; ++d)
+    p[d] = 0.7 / (d + 2);
+
+  std::vector<double>         values(n);
+  std::vector<Tensor<1, dim>> grads(n);
+  std::vector<Tensor<2, dim>> grad_grads(n);
+  std::vector<Tensor<3, dim>> third_derivatives;
+  std::vector<Tensor<4, dim>> fourth_derivatives;
+  poly.evaluate(
+    p, values, grads, grad_grads, third_derivatives, fourth_derivatives);
+
+  double         sum_values = 0;
+  Tensor<1, dim> sum_grads;
+  double         max_error_evaluate = 0, max_error_fd = 0;
+  const double   h                  = 1e-6;
+  for (unsigned int i = 0; i < n; ++i)
+    {
+      sum_values += values[i];
+      sum_grads += grads[i];
+      max_error_evaluate =
+        std::max(max_error_evaluate,
+                 std::abs(values[i] - poly.compute_value(i, p)) +
+                   (grads[i] - poly.compute_grad(i, p)).norm() +
+                   (grad_grads[i] - poly.compute_grad_grad(i, p)).norm());
+      for (unsigned int d = 0; d < dim; ++d)
+        {
+          Point<dim> p_plus = p, p_minus = p;
+          p_plus[d] += h;
+          p_minus[d] -= h;
+          max_error_fd =
+            std::max(max_error_fd,
+                     std::abs(grads[i][d] - (poly.compute_value(i, p_plus) -
+                                             poly.compute_value(i, p_minus)) /
+                                              (2. * h)));
+        }
+    }
+
+  deallog << "Lagrange property:   "
+          << (max_error_lagrange < 1e-12 ? "OK" : "FAIL") << std::endl;
+  deallog << "Partition of unity:  "
+          << (std::abs(sum_values - 1.) < 1e-12 && sum_grads.norm() < 1e-10 ?
+                "OK" :
+                "FAIL")
+          << std::endl;
+  deallog << "Evaluate:            "
+          << (max_error_evaluate < 1e-12 ? "OK" : "FAIL") << std::endl;
+  deallog << "Finite differences:  " << (max_error_fd < 1e-7 ? "OK" : "FAIL")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  for (unsigned int degree = 0; degree < 4; ++degree)
+    test<1>(degree);
+  for (unsigned int degree = 0; degree < 4; ++degree)
+    test<2>(degree);
+  for (unsigned int degree = 0; degree < 4; ++degree)
+    test<3>(degree);
+}
@@ -0,0 +1,121 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that QGaussSimplex with n points per direction integrates all
+// monomials of total degree up to 2n-1 exactly on the reference simplex,
+// that the points are inside the simplex and that the weights are positive
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include "../tests.h"
+
+
+
+double
+factorial(const unsigned int n)
+{
+  double result = 1;
+  for (unsigned int i = 2; i <= n; ++i)
+    result *= i;
+  return result;
+}
+
+
+
+template <int dim>
+void
+test(const unsigned int n_points_1D)
+{
+  const QGaussSimplex<dim> quad(n_points_1D);
+
+  // the smallest weight or point coordinate must be positive, and the sum
+  // of the coordinates smaller than one
+  double sum_weights = 0, min_entry = 1, max_coordinate_sum = 0;
+  for (unsigned int q = 0; q < quad.size(); ++q)
+    {
+      sum_weights += quad.weight(q);
+      min_entry = std::min(min_entry, quad.weight(q));
+      double coordinate_sum = 0;
+      for (unsigned int d = 0; d < dim; ++d)
+        {
+          coordinate_sum += quad.point(q)[d];
+          min_entry = std::min(min_entry, quad.point(q)[d]);
+        }
+      max_coordinate_sum = std::max(max_coordinate_sum, coordinate_sum);
+    }
+
+  // the exact integral of x^a y^b z^c over the reference simplex is
+  // a! b! c! / (a + b + c + dim)!
+  const unsigned int            max_degree = 2 * n_points_1D - 1;
+  double                        max_error  = 0;
+  std::array<unsigned int, dim> exponents;
+  std::fill(exponents.begin(), exponents.end(), 0U);
+  while (true)
+    {
+      unsigned int degree = 0;
+      double       exact  = 1;
+      for (unsigned int d = 0; d < dim; ++d)
+        {
+          degree += exponents[d];
+          exact *= factorial(exponents[d]);
+        }
+      exact /= factorial(degree + dim);
+
+      if (degree <= max_degree)
+        {
+          double integral = 0;
+          for (unsigned int q = 0; q < quad.size(); ++q)
+            {
+              double value = quad.weight(q);
+              for (unsigned int d = 0; d < dim; ++d)
+                value *= std::pow(quad.point(q)[d], exponents[d]);
+              integral += value;
+            }
+          max_error = std::max(max_error, std::abs(integral - exact) / exact);
+        }
+
+      unsigned int d = 0;
+      for (; d < dim; ++d)
+        if (++exponents[d] <= max_degree)
+          break;
+        else
+          exponents[d] = 0;
+      if (d == dim)
+        break;
+    }
+
+  deallog << "dim=" << dim << " n=" << n_points_1D
+          << " points=" << quad.size() << " volume=" << sum_weights
+          << " inside=" << (min_entry > 0 && max_coordinate_sum < 1)
+          << " error degree " << max_degree << ": "
+          << (max_error < 1e-13 ? "OK" : "FAIL") << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  for (unsigned int n = 1; n < 6; ++n)
+    test<1>(n);
+  for (unsigned int n = 1; n < 6; ++n)
+    test<2>(n);
+  for (unsigned int n = 1; n < 6; ++n)
+    test<3>(n);
+}
@@ -0,0 +1,144 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/time_stepping.h>
+
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+// test low-storage Runge-Kutta methods: convergence rate for the ODE
+// y' = y cos(t) with solution y = exp(sin(t)), and identical results when
+// the vector updates are done within the stage operation
+
+Vector<double>
+f(const double t, const Vector<double> &y)
+{
+  Vector<double> values(y);
+  for (unsigned int i = 0; i < values.size(); ++i)
+    values[i] = std::cos(t) * y[i];
+
+  return values;
+}
+
+
+
+double
+compute_error(const TimeStepping::runge_kutta_method method,
+              const unsigned int                     n_time_steps)
+{
+  const double   final_time = 2.;
+  const double   delta_t    = final_time / n_time_steps;
+  Vector<double> solution(1), vec_ri, vec_ki;
+  solution[0] = 1.;
+
+  TimeStepping::LowStorageRungeKutta<Vector<double>> rk(method);
+  double                                             time = 0;
+  for (unsigned int i = 0; i < n_time_steps; ++i)
+    time = rk.evolve_one_time_step(f, time, delta_t, solution, vec_ri, vec_ki);
+
+  return std::abs(solution[0] - std::exp(std::sin(final_time)));
+}
+
+
+
+void
+test_convergence(const TimeStepping::runge_kutta_method method)
+{
+  std::vector<double> ai, bi, ci;
+  TimeStepping::LowStorageRungeKutta<Vector<double>>(method).get_coefficients(
+    ai, bi, ci);
+  deallog << "Number of stages: " << bi.size() << std::endl;
+
+  const double error_coarse = compute_error(method, 20);
+  const double error_fine   = compute_error(method, 40);
+  deallog << "Convergence rate: " << std::setprecision(2)
+          << std::log2(error_coarse / error_fine) << std::setprecision(6)
+          << std::endl;
+}
+
+
+
+void
+test_stage_operation(const TimeStepping::runge_kutta_method method)
+{
+  const double delta_t = 0.1;
+
+  TimeStepping::LowStorageRungeKutta<Vector<double>> rk(method);
+
+  Vector<double> solution(3), vec_ri, vec_ki;
+  for (unsigned int i = 0; i < solution.size(); ++i)
+    solution[i] = 1. + i;
+  Vector<double> solution_fused(solution), vec_ri_fused(solution.size()),
+    vec_ki_fused(solution.size());
+
+  double time = 0, time_fused = 0;
+  for (unsigned int step = 0; step < 10; ++step)
+    {
+      time = rk.evolve_one_time_step(f, time, delta_t, solution, vec_ri, vec_ki);
+      time_fused = rk.evolve_one_time_step(
+        [](const double          t,
+           const double          factor_solution,
+           const double          factor_ai,
+           const Vector<double> &current_ri,
+           Vector<double> &      ki,
+           Vector<double> &      y,
+           Vector<double> &      next_ri) {
+          // entry-wise evaluation and update as it would be done in the
+          // operation after the cell loop in a matrix-free operator
+          for (unsigned int i = 0; i < y.size(); ++i)
+            {
+              const double k_i = std::cos(t) * current_ri[i];
+              const double y_i = y[i];
+              ki[i]            = k_i;
+              if (factor_ai != 0.)
+                next_ri[i] = y_i + factor_ai * k_i;
+              y[i] = y_i + factor_solution * k_i;
+            }
+        },
+        time_fused,
+        delta_t,
+        solution_fused,
+        vec_ri_fused,
+        vec_ki_fused);
+    }
+
+  solution_fused -= solution;
+  deallog << "Difference fused stage operation: "
+          << solution_fused.linfty_norm() << " at time " << time_fused
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  const std::vector<std::pair<TimeStepping::runge_kutta_method, std::string>>
+    methods = {{TimeStepping::LOW_STORAGE_RK_STAGE3_ORDER3, "stage3"},
+               {TimeStepping::LOW_STORAGE_RK_STAGE5_ORDER4, "stage5"},
+               {TimeStepping::LOW_STORAGE_RK_STAGE7_ORDER4, "stage7"},
+               {TimeStepping::LOW_STORAGE_RK_STAGE9_ORDER5, "stage9"}};
+
+  for (const auto &method : methods)
+    {
+      deallog.push(method.second);
+      test_convergence(method.first);
+      test_stage_operation(method.first);
+      deallog.pop();
+    }
+}
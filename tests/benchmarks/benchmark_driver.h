@@ -0,0 +1,228 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_benchmarks_benchmark_driver_h
+#define dealii_benchmarks_benchmark_driver_h
+
+// Common infrastructure of the benchmarks: every benchmark measures a few
+// kernels with time_best_of(), registers the results with a Report, and
+// returns Report::finalize() from main(). The report is written as JSON and
+// compared against the baseline given on the command line:
+//
+//   ./benchmark --output result.json [--baseline baseline.json]
+//               [--tolerance 0.1]
+//
+// A kernel counts as a regression if its throughput is smaller than the
+// baseline throughput by more than the relative tolerance.
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace dealii;
+
+namespace Benchmark
+{
+  /**
+   * Run @p kernel @p n_repetitions times and return the shortest wall time
+   * of a single run in seconds, which is the measure least affected by
+   * other processes on the machine. The kernel is run once more before the
+   * measurement to warm up caches and memory pools.
+   */
+  template <typename Kernel>
+  double
+  time_best_of(const unsigned int n_repetitions, const Kernel &kernel)
+  {
+    kernel();
+
+    double best_time = std::numeric_limits<double>::max();
+    for (unsigned int r = 0; r < n_repetitions; ++r)
+      {
+        const auto start = std::chrono::steady_clock::now();
+        kernel();
+        const std::chrono::duration<double> time =
+          std::chrono::steady_clock::now() - start;
+        best_time = std::min(best_time, time.count());
+      }
+    return best_time;
+  }
+
+
+
+  /**
+   * The result of one kernel: the time of a single run, and the throughput
+   * derived from it in the given unit (e.g., "DoFs/s" or "GB/s"), where a
+   * larger throughput is better.
+   */
+  struct Measurement
+  {
+    std::string name;
+    double      time;
+    double      throughput;
+    std::string unit;
+  };
+
+
+
+  /**
+   * Collect the measurements of one benchmark, write them as JSON and
+   * compare them against a baseline.
+   */
+  class Report
+  {
+  public:
+    /**
+     * Constructor. Parse the command line arguments.
+     */
+    Report(const std::string &benchmark_name, int argc, char **argv)
+      : benchmark_name(benchmark_name)
+      , tolerance(0.1)
+    {
+      for (int i = 1; i < argc; ++i)
+        {
+          const std::string argument = argv[i];
+          AssertThrow(i + 1 < argc,
+                      ExcMessage("Missing value for argument " + argument));
+          if (argument == "--output")
+            output_filename = argv[++i];
+          else if (argument == "--baseline")
+            baseline_filename = argv[++i];
+          else if (argument == "--tolerance")
+            tolerance = std::atof(argv[++i]);
+          else
+            AssertThrow(false, ExcMessage("Unknown argument " + argument));
+        }
+    }
+
+    /**
+     * Add the result of one kernel, where @p work is the amount of work
+     * done in one run, measured in the given unit times seconds, e.g., the
+     * number of DoFs for a throughput in DoFs/s.
+     */
+    void
+    add(const std::string &name,
+        const double       time,
+        const double       work,
+        const std::string &unit)
+    {
+      measurements.push_back({name, time, work / time, unit});
+      std::cout << std::left << std::setw(40) << name << std::right
+                << std::setprecision(4) << std::setw(12) << time << " s "
+                << std::setw(12) << work / time << ' ' << unit << std::endl;
+    }
+
+    /**
+     * Write the JSON file and compare against the baseline. Return the exit
+     * code of the benchmark, which is nonzero if any kernel has regressed.
+     */
+    int
+    finalize() const
+    {
+      if (output_filename.empty() == false)
+        {
+          std::ofstream out(output_filename);
+          AssertThrow(out, ExcIO());
+          write_json(out);
+        }
+
+      if (baseline_filename.empty())
+        return 0;
+
+      std::ifstream in(baseline_filename);
+      if (!in)
+        {
+          std::cout << "No baseline found at " << baseline_filename
+                    << std::endl;
+          return 0;
+        }
+      std::stringstream baseline_json;
+      baseline_json << in.rdbuf();
+      const std::map<std::string, double> baseline =
+        parse_throughputs(baseline_json.str());
+
+      unsigned int n_regressions = 0;
+      for (const Measurement &measurement : measurements)
+        {
+          const auto entry = baseline.find(measurement.name);
+          if (entry == baseline.end())
+            continue;
+
+          const double ratio     = measurement.throughput / entry->second;
+          const bool   regressed = ratio < 1. - tolerance;
+          if (regressed)
+            ++n_regressions;
+          std::cout << std::left << std::setw(40) << measurement.name
+                    << std::right << std::fixed << std::setprecision(2)
+                    << std::setw(8) << ratio * 100. << "% of baseline"
+                    << (regressed ? "  REGRESSION" : "") << std::endl
+                    << std::defaultfloat;
+        }
+      return (n_regressions == 0 ? 0 : 1);
+    }
+
+  private:
+    void
+    write_json(std::ostream &out) const
+    {
+      out << std::setprecision(8);
+      out << "{\n  \"benchmark\": \"" << benchmark_name << "\",\n"
+          << "  \"results\": [";
+      for (unsigned int i = 0; i < measurements.size(); ++i)
+        out << (i == 0 ? "" : ",") << "\n    {\"name\": \""
+            << measurements[i].name << "\", \"time\": " << measurements[i].time
+            << ", \"throughput\": " << measurements[i].throughput
+            << ", \"unit\": \"" << measurements[i].unit << "\"}";
+      out << "\n  ]\n}\n";
+    }
+
+    /**
+     * Extract the throughput of all kernels from a file written by
+     * write_json().
+     */
+    static std::map<std::string, double>
+    parse_throughputs(const std::string &json)
+    {
+      std::map<std::string, double> throughputs;
+      const std::regex              entry(
+        "\"name\":\\s*\"([^\"]*)\"[^}]*\"throughput\":\\s*([-+0-9.eE]+)");
+      for (std::sregex_iterator match(json.begin(), json.end(), entry);
+           match != std::sregex_iterator();
+           ++match)
+        throughputs[(*match)[1]] = std::atof((*match)[2].str().c_str());
+      return throughputs;
+    }
+
+    const std::string        benchmark_name;
+    std::string              output_filename;
+    std::string              baseline_filename;
+    double                   tolerance;
+    std::vector<Measurement> measurements;
+  };
+} // namespace Benchmark
+
+#endif
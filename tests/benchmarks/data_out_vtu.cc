@@ -0,0 +1,95 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Benchmark DataOut::build_patches() and DataOut::write_vtu() for a Q2
+// solution in 3D. The output is written into memory to exclude the speed of
+// the file system from the measurement.
+
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/data_out.h>
+
+#include <sstream>
+
+#include "benchmark_driver.h"
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+
+  Benchmark::Report report("data_out_vtu", argc, argv);
+
+  constexpr int      dim    = 3;
+  const unsigned int degree = 2;
+
+  Triangulation<dim> tria;
+  GridGenerator::subdivided_hyper_cube(tria, 40);
+
+  FE_Q<dim>       fe(degree);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  Vector<double> solution(dof_handler.n_dofs());
+  for (unsigned int i = 0; i < solution.size(); ++i)
+    solution(i) = std::sin(0.01 * i);
+
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler(dof_handler);
+  data_out.add_data_vector(solution, "solution");
+
+  const double build_time =
+    Benchmark::time_best_of(3, [&]() { data_out.build_patches(degree); });
+  report.add("build_patches_q2", build_time, tria.n_active_cells(), "cells/s");
+
+  // each cell is written as a patch with (degree+1)^dim points
+  const unsigned int n_points =
+    tria.n_active_cells() * Utilities::fixed_power<dim>(degree + 1);
+
+  const std::vector<std::pair<DataOutBase::VtkFlags::ZlibCompressionLevel,
+                              std::string>>
+    compression_levels = {{DataOutBase::VtkFlags::no_compression, "none"},
+                          {DataOutBase::VtkFlags::best_speed, "best_speed"},
+                          {DataOutBase::VtkFlags::best_compression,
+                           "best_compression"}};
+  for (const auto &level : compression_levels)
+    {
+      DataOutBase::VtkFlags flags;
+      flags.print_date_and_time = false;
+      flags.compression_level   = level.first;
+      data_out.set_flags(flags);
+
+      const double time = Benchmark::time_best_of(3, [&]() {
+        std::ostringstream out;
+        data_out.write_vtu(out);
+      });
+      report.add("write_vtu_" + level.second, time, n_points, "points/s");
+    }
+
+  return report.finalize();
+}
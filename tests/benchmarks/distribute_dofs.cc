@@ -0,0 +1,78 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Benchmark DoFHandler::distribute_dofs() for continuous elements of degree
+// one and two on adaptively refined meshes in 2D and 3D
+
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include "benchmark_driver.h"
+
+
+template <int dim>
+void
+run(const unsigned int n_global_refinements, Benchmark::Report &report)
+{
+  // a mesh with hanging nodes, refined around one corner of the domain
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(n_global_refinements);
+  for (unsigned int step = 0; step < 2; ++step)
+    {
+      for (const auto &cell : tria.active_cell_iterators())
+        if (cell->center().norm() < 0.5)
+          cell->set_refine_flag();
+      tria.execute_coarsening_and_refinement();
+    }
+
+  for (const unsigned int degree : {1, 2})
+    {
+      FE_Q<dim>       fe(degree);
+      DoFHandler<dim> dof_handler(tria);
+
+      const double time = Benchmark::time_best_of(5, [&]() {
+        dof_handler.distribute_dofs(fe);
+      });
+      report.add("distribute_dofs_" + std::to_string(dim) + "d_q" +
+                   std::to_string(degree),
+                 time,
+                 dof_handler.n_dofs(),
+                 "DoFs/s");
+    }
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  Benchmark::Report report("distribute_dofs", argc, argv);
+  run<2>(9, report);
+  run<3>(5, report);
+  return report.finalize();
+}
@@ -0,0 +1,264 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Benchmark the application of matrix-free operators in 3D for polynomial
+// degrees one to six: the Laplacian with continuous FE_Q elements, which
+// only runs over cells, and the symmetric interior penalty discretization of
+// the Laplacian with FE_DGQ elements, which also runs over faces.
+
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include "benchmark_driver.h"
+
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+constexpr unsigned int dimension = 3;
+
+// the minimal number of unknowns of the operators, which makes sure that the
+// vectors do not fit into caches
+constexpr unsigned int min_n_dofs = 1000000;
+
+
+
+// the Laplacian on cells and the interior penalty terms on faces
+template <int dim, int degree>
+class LaplaceOperator
+{
+public:
+  LaplaceOperator(const double h)
+    : penalty(2. * (degree + 1) * (degree + 1) / h)
+  {}
+
+  void
+  cell(const MatrixFree<dim, double> &              data,
+       VectorType &                                 dst,
+       const VectorType &                           src,
+       const std::pair<unsigned int, unsigned int> &cell_range) const
+  {
+    FEEvaluation<dim, degree> phi(data);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second;
+         ++cell)
+      {
+        phi.reinit(cell);
+        phi.gather_evaluate(src, EvaluationFlags::gradients);
+        for (unsigned int q = 0; q < phi.n_q_points; ++q)
+          phi.submit_gradient(phi.get_gradient(q), q);
+        phi.integrate_scatter(EvaluationFlags::gradients, dst);
+      }
+  }
+
+  void
+  face(const MatrixFree<dim, double> &              data,
+       VectorType &                                 dst,
+       const VectorType &                           src,
+       const std::pair<unsigned int, unsigned int> &face_range) const
+  {
+    FEFaceEvaluation<dim, degree> phi_m(data, true), phi_p(data, false);
+    for (unsigned int face = face_range.first; face < face_range.second;
+         ++face)
+      {
+        phi_m.reinit(face);
+        phi_p.reinit(face);
+        phi_m.gather_evaluate(src,
+                              EvaluationFlags::values |
+                                EvaluationFlags::gradients);
+        phi_p.gather_evaluate(src,
+                              EvaluationFlags::values |
+                                EvaluationFlags::gradients);
+        for (unsigned int q = 0; q < phi_m.n_q_points; ++q)
+          {
+            const VectorizedArray<double> jump =
+              phi_m.get_value(q) - phi_p.get_value(q);
+            const VectorizedArray<double> flux =
+              penalty * jump - 0.5 * (phi_m.get_normal_derivative(q) +
+                                      phi_p.get_normal_derivative(q));
+            phi_m.submit_value(flux, q);
+            phi_p.submit_value(-flux, q);
+            phi_m.submit_normal_derivative(-0.5 * jump, q);
+            phi_p.submit_normal_derivative(-0.5 * jump, q);
+          }
+        phi_m.integrate_scatter(EvaluationFlags::values |
+                                  EvaluationFlags::gradients,
+                                dst);
+        phi_p.integrate_scatter(EvaluationFlags::values |
+                                  EvaluationFlags::gradients,
+                                dst);
+      }
+  }
+
+  void
+  boundary(const MatrixFree<dim, double> &              data,
+           VectorType &                                 dst,
+           const VectorType &                           src,
+           const std::pair<unsigned int, unsigned int> &face_range) const
+  {
+    // homogeneous Dirichlet conditions imposed weakly, i.e., with a mirror
+    // value of -u on the outside
+    FEFaceEvaluation<dim, degree> phi(data, true);
+    for (unsigned int face = face_range.first; face < face_range.second;
+         ++face)
+      {
+        phi.reinit(face);
+        phi.gather_evaluate(src,
+                            EvaluationFlags::values |
+                              EvaluationFlags::gradients);
+        for (unsigned int q = 0; q < phi.n_q_points; ++q)
+          {
+            const VectorizedArray<double> jump = 2. * phi.get_value(q);
+            phi.submit_value(penalty * jump - phi.get_normal_derivative(q),
+                             q);
+            phi.submit_normal_derivative(-0.5 * jump, q);
+          }
+        phi.integrate_scatter(EvaluationFlags::values |
+                                EvaluationFlags::gradients,
+                              dst);
+      }
+  }
+
+private:
+  const double penalty;
+};
+
+
+
+template <int degree>
+void
+run(Benchmark::Report &report)
+{
+  constexpr int dim = dimension;
+
+  // subdivide until the continuous element has enough unknowns; the DG
+  // element then has more than that
+  unsigned int n_subdivisions = 1;
+  while (Utilities::fixed_power<dim>(n_subdivisions * degree + 1) <
+         min_n_dofs)
+    ++n_subdivisions;
+
+  Triangulation<dim> tria;
+  GridGenerator::subdivided_hyper_cube(tria, n_subdivisions);
+
+  const MappingQGeneric<dim> mapping(1);
+
+  {
+    FE_Q<dim>       fe(degree);
+    DoFHandler<dim> dof_handler(tria);
+    dof_handler.distribute_dofs(fe);
+
+    AffineConstraints<double> constraints;
+    constraints.close();
+
+    typename MatrixFree<dim, double>::AdditionalData additional_data;
+    additional_data.mapping_update_flags = update_gradients | update_JxW_values;
+    MatrixFree<dim, double> matrix_free;
+    matrix_free.reinit(mapping,
+                       dof_handler,
+                       constraints,
+                       QGauss<1>(degree + 1),
+                       additional_data);
+
+    VectorType src, dst;
+    matrix_free.initialize_dof_vector(src);
+    matrix_free.initialize_dof_vector(dst);
+    src = 1.;
+
+    const LaplaceOperator<dim, degree> op(1. / n_subdivisions);
+    const double time = Benchmark::time_best_of(10, [&]() {
+      matrix_free.cell_loop(
+        &LaplaceOperator<dim, degree>::cell, &op, dst, src, true);
+    });
+    report.add("laplace_q" + std::to_string(degree),
+               time,
+               dof_handler.n_dofs(),
+               "DoFs/s");
+  }
+
+  {
+    FE_DGQ<dim>     fe(degree);
+    DoFHandler<dim> dof_handler(tria);
+    dof_handler.distribute_dofs(fe);
+
+    AffineConstraints<double> constraints;
+    constraints.close();
+
+    typename MatrixFree<dim, double>::AdditionalData additional_data;
+    additional_data.mapping_update_flags = update_gradients | update_JxW_values;
+    additional_data.mapping_update_flags_inner_faces =
+      update_values | update_gradients | update_JxW_values |
+      update_normal_vectors;
+    additional_data.mapping_update_flags_boundary_faces =
+      additional_data.mapping_update_flags_inner_faces;
+    MatrixFree<dim, double> matrix_free;
+    matrix_free.reinit(mapping,
+                       dof_handler,
+                       constraints,
+                       QGauss<1>(degree + 1),
+                       additional_data);
+
+    VectorType src, dst;
+    matrix_free.initialize_dof_vector(src);
+    matrix_free.initialize_dof_vector(dst);
+    src = 1.;
+
+    const LaplaceOperator<dim, degree> op(1. / n_subdivisions);
+    const double time = Benchmark::time_best_of(10, [&]() {
+      matrix_free.loop(&LaplaceOperator<dim, degree>::cell,
+                       &LaplaceOperator<dim, degree>::face,
+                       &LaplaceOperator<dim, degree>::boundary,
+                       &op,
+                       dst,
+                       src,
+                       true);
+    });
+    report.add("dg_laplace_q" + std::to_string(degree),
+               time,
+               dof_handler.n_dofs(),
+               "DoFs/s");
+  }
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  Benchmark::Report report("matrix_free_operators", argc, argv);
+  run<1>(report);
+  run<2>(report);
+  run<3>(report);
+  run<4>(report);
+  run<5>(report);
+  run<6>(report);
+  return report.finalize();
+}
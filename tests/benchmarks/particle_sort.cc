@@ -0,0 +1,92 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Benchmark the sorting of particles into cells after they have moved, as
+// done in ParticleHandler::set_particle_positions(). The particles move back
+// and forth by the size of a cell, so most of them change cells in every
+// step but none of them leaves the domain.
+
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/particles/particle_handler.h>
+
+#include <random>
+
+#include "benchmark_driver.h"
+
+
+template <int dim>
+void
+run(const unsigned int n_subdivisions,
+    const unsigned int n_particles,
+    Benchmark::Report &report)
+{
+  Triangulation<dim> tria;
+  GridGenerator::subdivided_hyper_cube(tria, n_subdivisions);
+
+  Particles::ParticleHandler<dim> particle_handler(
+    tria, StaticMappingQ1<dim>::mapping, 0);
+
+  // place the particles into the interior of the domain so that the
+  // displacement below keeps them inside
+  std::mt19937                           generator(42);
+  std::uniform_real_distribution<double> distribution(0.25, 0.75);
+  std::vector<Point<dim>>                positions(n_particles);
+  for (auto &position : positions)
+    for (unsigned int d = 0; d < dim; ++d)
+      position[d] = distribution(generator);
+  particle_handler.insert_particles(positions);
+  AssertThrow(particle_handler.n_locally_owned_particles() == n_particles,
+              ExcInternalError());
+
+  Point<dim> step;
+  for (unsigned int d = 0; d < dim; ++d)
+    step[d] = 1. / n_subdivisions;
+
+  std::vector<Point<dim>> displacements(n_particles);
+  double                  sign = 1.;
+  const double            time = Benchmark::time_best_of(5, [&]() {
+    std::fill(displacements.begin(), displacements.end(), sign * step);
+    particle_handler.set_particle_positions(displacements);
+    sign = -sign;
+  });
+  AssertThrow(particle_handler.n_locally_owned_particles() == n_particles,
+              ExcInternalError());
+
+  report.add("sort_particles_" + std::to_string(dim) + "d",
+             time,
+             n_particles,
+             "particles/s");
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  Benchmark::Report report("particle_sort", argc, argv);
+  run<2>(128, 1000000, report);
+  run<3>(32, 1000000, report);
+  return report.finalize();
+}
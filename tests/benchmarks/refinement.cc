@@ -0,0 +1,82 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Benchmark Triangulation::execute_coarsening_and_refinement() by
+// refining a part of a mesh and coarsening it again, which brings the mesh
+// back to its original state so that the cycle can be repeated
+
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include "benchmark_driver.h"
+
+
+template <int dim>
+void
+run(const unsigned int  n_global_refinements,
+    const double        radius,
+    const std::string & name,
+    Benchmark::Report & report)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(n_global_refinements);
+  const unsigned int n_cells = tria.n_active_cells();
+
+  unsigned int n_refined_cells = 0;
+  const double time            = Benchmark::time_best_of(5, [&]() {
+    n_refined_cells = 0;
+    for (const auto &cell : tria.active_cell_iterators())
+      if (cell->center().norm() < radius)
+        {
+          cell->set_refine_flag();
+          ++n_refined_cells;
+        }
+    tria.execute_coarsening_and_refinement();
+
+    for (const auto &cell : tria.active_cell_iterators())
+      if (cell->level() > static_cast<int>(n_global_refinements))
+        cell->set_coarsen_flag();
+    tria.execute_coarsening_and_refinement();
+  });
+  AssertThrow(tria.n_active_cells() == n_cells, ExcInternalError());
+
+  // each refined cell is replaced by its children and then restored
+  report.add(name + "_" + std::to_string(dim) + "d",
+             time,
+             n_refined_cells * (GeometryInfo<dim>::max_children_per_cell + 1),
+             "cells/s");
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  Benchmark::Report report("refinement", argc, argv);
+  run<2>(9, 2., "refine_coarsen_all", report);
+  run<2>(9, 0.5, "refine_coarsen_local", report);
+  run<3>(5, 2., "refine_coarsen_all", report);
+  run<3>(5, 0.5, "refine_coarsen_local", report);
+  return report.finalize();
+}
@@ -0,0 +1,59 @@
+## ---------------------------------------------------------------------
+##
+## Copyright (C) 2020 by the deal.II authors
+##
+## This file is part of the deal.II library.
+##
+## The deal.II library is free software; you can use it, redistribute
+## it, and/or modify it under the terms of the GNU Lesser General
+## Public License as published by the Free Software Foundation; either
+## version 2.1 of the License, or (at your option) any later version.
+## The full text of the license can be found in the file LICENSE.md at
+## the top level directory of deal.II.
+##
+## ---------------------------------------------------------------------
+
+# This file is run when "make benchmarks" or "make
+# benchmarks_update_baselines" is executed by the user. The benchmarks are
+# run one after the other (and not through ctest in parallel) because they
+# would otherwise compete for cores and memory bandwidth.
+
+SEPARATE_ARGUMENTS(ALL_BENCHMARKS)
+
+SET(_failed)
+FOREACH(_benchmark ${ALL_BENCHMARKS})
+  MESSAGE("Running benchmark ${_benchmark}")
+
+  SET(_arguments --output ${_benchmark}.json)
+  IF(NOT UPDATE_BASELINES)
+    LIST(APPEND _arguments
+      --baseline ${BASELINE_DIR}/${_benchmark}.json
+      --tolerance ${TOLERANCE}
+      )
+  ENDIF()
+
+  EXECUTE_PROCESS(COMMAND ./benchmark_${_benchmark} ${_arguments}
+    RESULT_VARIABLE _result
+    )
+  IF(NOT "${_result}" STREQUAL "0")
+    LIST(APPEND _failed ${_benchmark})
+  ELSEIF(UPDATE_BASELINES)
+    FILE(COPY ${_benchmark}.json DESTINATION ${BASELINE_DIR})
+  ENDIF()
+ENDFOREACH()
+
+IF(NOT "${_failed}" STREQUAL "")
+  STRING(REPLACE ";" " " _failed "${_failed}")
+  MESSAGE("
+***************************************************************************
+**          Error: Some of the benchmarks failed or regressed.           **
+***************************************************************************
+
+The following benchmarks are slower than the baseline in ${BASELINE_DIR}
+by more than the tolerance of ${TOLERANCE}, or did not run at all:
+  ${_failed}
+The results are stored in the JSON files in tests/benchmarks of the build
+directory.\n"
+    )
+  MESSAGE(SEND_ERROR "")
+ENDIF()
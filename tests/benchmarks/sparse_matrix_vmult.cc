@@ -0,0 +1,94 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Benchmark SparseMatrix::vmult() for the sparsity patterns of Q1 and Q2
+// elements in 3D, reporting the memory throughput. This kernel is limited
+// by the memory bandwidth, so the throughput should be compared to the
+// bandwidth of the machine.
+
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include "benchmark_driver.h"
+
+
+void
+run(const unsigned int degree, Benchmark::Report &report)
+{
+  constexpr int dim = 3;
+
+  unsigned int n_subdivisions = 1;
+  while (Utilities::fixed_power<dim>(n_subdivisions * degree + 1) < 1000000)
+    ++n_subdivisions;
+
+  Triangulation<dim> tria;
+  GridGenerator::subdivided_hyper_cube(tria, n_subdivisions);
+
+  FE_Q<dim>       fe(degree);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  SparsityPattern sparsity;
+  {
+    DynamicSparsityPattern dsp(dof_handler.n_dofs());
+    DoFTools::make_sparsity_pattern(dof_handler, dsp);
+    sparsity.copy_from(dsp);
+  }
+  SparseMatrix<double> matrix(sparsity);
+  for (auto entry = matrix.begin(); entry != matrix.end(); ++entry)
+    entry->value() = (entry->row() == entry->column() ? 2. : -0.01);
+
+  Vector<double> src(dof_handler.n_dofs()), dst(dof_handler.n_dofs());
+  src = 1.;
+
+  const double time =
+    Benchmark::time_best_of(20, [&]() { matrix.vmult(dst, src); });
+
+  // values and column indices of all entries, row starts, and reading the
+  // source and writing the destination vector, where the latter also needs
+  // to be read into the caches first
+  const double bytes =
+    sparsity.n_nonzero_elements() * (sizeof(double) + sizeof(unsigned int)) +
+    sparsity.n_rows() * (sizeof(std::size_t) + 3 * sizeof(double));
+  report.add("vmult_q" + std::to_string(degree), time, bytes * 1e-9, "GB/s");
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+
+  Benchmark::Report report("sparse_matrix_vmult", argc, argv);
+  run(1, report);
+  run(2, report);
+  return report.finalize();
+}
@@ -0,0 +1,164 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Benchmark the assembly of the matrix and the right hand side of the
+// Laplace equation with Q1 and Q2 elements in 3D using WorkStream::run(),
+// in the form used by step-9 and many other tutorial programs.
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/work_stream.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include "benchmark_driver.h"
+
+
+template <int dim>
+struct ScratchData
+{
+  ScratchData(const FiniteElement<dim> &fe, const Quadrature<dim> &quadrature)
+    : fe_values(fe,
+                quadrature,
+                update_values | update_gradients | update_JxW_values)
+  {}
+
+  ScratchData(const ScratchData &scratch)
+    : fe_values(scratch.fe_values.get_fe(),
+                scratch.fe_values.get_quadrature(),
+                scratch.fe_values.get_update_flags())
+  {}
+
+  FEValues<dim> fe_values;
+};
+
+
+
+struct CopyData
+{
+  FullMatrix<double>                   cell_matrix;
+  Vector<double>                       cell_rhs;
+  std::vector<types::global_dof_index> local_dof_indices;
+};
+
+
+
+template <int dim>
+void
+run(const unsigned int degree, Benchmark::Report &report)
+{
+  unsigned int n_subdivisions = 1;
+  while (Utilities::fixed_power<dim>(n_subdivisions * degree + 1) < 500000)
+    ++n_subdivisions;
+
+  Triangulation<dim> tria;
+  GridGenerator::subdivided_hyper_cube(tria, n_subdivisions);
+
+  FE_Q<dim>       fe(degree);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  SparsityPattern sparsity;
+  {
+    DynamicSparsityPattern dsp(dof_handler.n_dofs());
+    DoFTools::make_sparsity_pattern(dof_handler, dsp, constraints);
+    sparsity.copy_from(dsp);
+  }
+  SparseMatrix<double> system_matrix(sparsity);
+  Vector<double>       system_rhs(dof_handler.n_dofs());
+
+  const unsigned int dofs_per_cell = fe.dofs_per_cell;
+
+  const auto cell_worker =
+    [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+        ScratchData<dim> &                                    scratch,
+        CopyData &                                            copy) {
+      FEValues<dim> &fe_values = scratch.fe_values;
+      fe_values.reinit(cell);
+
+      copy.cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+      copy.cell_rhs.reinit(dofs_per_cell);
+      copy.local_dof_indices.resize(dofs_per_cell);
+      cell->get_dof_indices(copy.local_dof_indices);
+
+      for (const unsigned int q : fe_values.quadrature_point_indices())
+        for (unsigned int i = 0; i < dofs_per_cell; ++i)
+          {
+            for (unsigned int j = 0; j < dofs_per_cell; ++j)
+              copy.cell_matrix(i, j) += fe_values.shape_grad(i, q) *
+                                        fe_values.shape_grad(j, q) *
+                                        fe_values.JxW(q);
+            copy.cell_rhs(i) += fe_values.shape_value(i, q) * fe_values.JxW(q);
+          }
+    };
+
+  const auto copier = [&](const CopyData &copy) {
+    constraints.distribute_local_to_global(copy.cell_matrix,
+                                           copy.cell_rhs,
+                                           copy.local_dof_indices,
+                                           system_matrix,
+                                           system_rhs);
+  };
+
+  const QGauss<dim> quadrature(degree + 1);
+  const double      time = Benchmark::time_best_of(3, [&]() {
+    system_matrix = 0.;
+    system_rhs    = 0.;
+    WorkStream::run(dof_handler.begin_active(),
+                    dof_handler.end(),
+                    cell_worker,
+                    copier,
+                    ScratchData<dim>(fe, quadrature),
+                    CopyData());
+  });
+  report.add("assemble_laplace_" + std::to_string(dim) + "d_q" +
+               std::to_string(degree),
+             time,
+             tria.n_active_cells(),
+             "cells/s");
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+
+  Benchmark::Report report("workstream_assembly", argc, argv);
+  run<3>(1, report);
+  run<3>(2, report);
+  return report.finalize();
+}
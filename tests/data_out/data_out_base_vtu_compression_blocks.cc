@@ -0,0 +1,161 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check that large data arrays in VTU files are split into several
+// independently compressed blocks, and that the block headers and the
+// compressed data can be decoded again
+
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/base/utilities.h>
+
+#include <zlib.h>
+
+#include <string>
+#include <vector>
+
+#include "../tests.h"
+
+
+// decode the header and the data of one array, and return the decompressed
+// data together with the number of blocks
+std::pair<std::vector<unsigned char>, unsigned int>
+decode_array(const std::string &encoded)
+{
+  // the first two entries of the header (number of blocks and block size)
+  // are encoded in the first eight characters
+  const std::vector<unsigned char> start =
+    Utilities::decode_base64(encoded.substr(0, 8));
+  uint32_t n_blocks;
+  std::memcpy(&n_blocks, start.data(), sizeof(uint32_t));
+
+  const std::size_t header_length =
+    4 * (((3 + n_blocks) * sizeof(uint32_t) + 2) / 3);
+  const std::vector<unsigned char> header_bytes =
+    Utilities::decode_base64(encoded.substr(0, header_length));
+  std::vector<uint32_t> header(3 + n_blocks);
+  std::memcpy(header.data(), header_bytes.data(), header.size() * 4);
+
+  const std::vector<unsigned char> compressed =
+    Utilities::decode_base64(encoded.substr(header_length));
+
+  std::vector<unsigned char> data;
+  std::size_t                position = 0;
+  for (unsigned int block = 0; block < n_blocks; ++block)
+    {
+      uLongf size = (block + 1 == n_blocks) ? header[2] : header[1];
+      std::vector<unsigned char> decompressed(size);
+      const int                  err = uncompress(decompressed.data(),
+                                 &size,
+                                 compressed.data() + position,
+                                 header[3 + block]);
+      AssertThrow(err == Z_OK, ExcInternalError());
+      AssertThrow(size == decompressed.size(), ExcInternalError());
+      position += header[3 + block];
+      data.insert(data.end(), decompressed.begin(), decompressed.end());
+    }
+  AssertThrow(position == compressed.size(), ExcInternalError());
+
+  return {data, n_blocks};
+}
+
+
+
+void
+check(const unsigned int n_patches)
+{
+  std::vector<DataOutBase::Patch<2, 2>> patches(n_patches);
+  std::vector<float>                    points, values;
+  for (unsigned int p = 0; p < n_patches; ++p)
+    {
+      patches[p].patch_index = p;
+      patches[p].data.reinit(1, 4);
+      for (unsigned int v = 0; v < 4; ++v)
+        {
+          patches[p].vertices[v] = Point<2>(p + v % 2, v / 2);
+          patches[p].data(0, v)  = p * 0.25 + v;
+          points.push_back(p + v % 2);
+          points.push_back(v / 2);
+          points.push_back(0);
+          values.push_back(patches[p].data(0, v));
+        }
+    }
+
+  std::vector<std::string> names(1, "u");
+  std::vector<
+    std::tuple<unsigned int,
+               unsigned int,
+               std::string,
+               DataComponentInterpretation::DataComponentInterpretation>>
+                        vectors;
+  DataOutBase::VtkFlags flags;
+  flags.compression_level = DataOutBase::VtkFlags::best_speed;
+
+  std::ostringstream out;
+  DataOutBase::write_vtu(patches, names, vectors, flags, out);
+  const std::string file = out.str();
+
+  deallog << "Patches: " << n_patches << std::endl;
+
+  // the first array contains the points, and the one named "u" the values
+  std::size_t position = 0;
+  for (unsigned int array = 0;
+       (position = file.find("<DataArray", position)) != std::string::npos;
+       ++array)
+    {
+      const std::size_t tag_end = file.find('>', position);
+      const std::size_t name_start =
+        std::min(file.find("Name=\"", position) + 6, tag_end);
+      const std::string name =
+        file.substr(name_start, file.find('"', name_start) - name_start);
+      const std::size_t data_end = file.find('<', tag_end);
+      std::string encoded = file.substr(tag_end + 1, data_end - tag_end - 1);
+      encoded.erase(std::remove_if(encoded.begin(),
+                                   encoded.end(),
+                                   [](const char c) {
+                                     return std::isspace(c);
+                                   }),
+                    encoded.end());
+      position = data_end;
+
+      const auto decoded = decode_array(encoded);
+      deallog << (array == 0 ? "points" : name) << ": " << decoded.second
+              << " blocks, " << decoded.first.size() << " bytes";
+
+      const std::vector<float> *expected =
+        (array == 0 ? &points : (name == "u" ? &values : nullptr));
+      if (expected != nullptr)
+        deallog << ", "
+                << (decoded.first.size() == expected->size() * sizeof(float) &&
+                        std::memcmp(decoded.first.data(),
+                                    expected->data(),
+                                    decoded.first.size()) == 0 ?
+                      "OK" :
+                      "wrong data");
+      deallog << std::endl;
+    }
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  check(10);
+  check(200000);
+}
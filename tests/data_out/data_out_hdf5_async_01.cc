@@ -0,0 +1,191 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// write a sequence of snapshots with DataOutBase::AsynchronousHDF5Writer,
+// the mesh only for the first one, using chunked and compressed datasets,
+// and read the files back to check their layout and their content
+
+#include <deal.II/base/data_out_base.h>
+
+#include <hdf5.h>
+
+#include <string>
+#include <vector>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+create_patches(std::vector<DataOutBase::Patch<dim, dim>> &patches,
+               const double                               time)
+{
+  for (unsigned int p = 0; p < patches.size(); ++p)
+    {
+      DataOutBase::Patch<dim, dim> &patch = patches[p];
+      patch.patch_index                    = p;
+      patch.n_subdivisions                 = 1;
+      patch.data.reinit(2, GeometryInfo<dim>::vertices_per_cell);
+      for (const unsigned int v : GeometryInfo<dim>::vertex_indices())
+        {
+          patch.vertices[v] = GeometryInfo<dim>::unit_cell_vertex(v);
+          patch.vertices[v][0] += p;
+          patch.data(0, v) = time + p + v;
+          patch.data(1, v) = time * v;
+        }
+    }
+}
+
+
+
+// read the dataset with the given name and print its dimensions, its chunk
+// dimensions, and whether it is compressed
+std::vector<double>
+read_dataset(const std::string &filename, const std::string &name)
+{
+  const hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  AssertThrow(file >= 0, ExcIO());
+  const hid_t dataset = H5Dopen2(file, name.c_str(), H5P_DEFAULT);
+  AssertThrow(dataset >= 0, ExcIO());
+
+  const hid_t dataspace = H5Dget_space(dataset);
+  hsize_t     dims[2];
+  H5Sget_simple_extent_dims(dataspace, dims, nullptr);
+
+  const hid_t plist = H5Dget_create_plist(dataset);
+  deallog << filename << ":" << name << " " << dims[0] << 'x' << dims[1];
+  if (H5Pget_layout(plist) == H5D_CHUNKED)
+    {
+      hsize_t chunk_dims[2];
+      H5Pget_chunk(plist, 2, chunk_dims);
+      deallog << ", chunks " << chunk_dims[0] << 'x' << chunk_dims[1];
+    }
+  for (int f = 0; f < H5Pget_nfilters(plist); ++f)
+    {
+      unsigned int filter_flags;
+      std::size_t  n_values = 1;
+      unsigned int level    = 0;
+      if (H5Pget_filter2(plist,
+                         f,
+                         &filter_flags,
+                         &n_values,
+                         &level,
+                         0,
+                         nullptr,
+                         nullptr) == H5Z_FILTER_DEFLATE)
+        deallog << ", deflate level " << level;
+    }
+  deallog << std::endl;
+
+  std::vector<double> values(dims[0] * dims[1]);
+  H5Dread(dataset,
+          H5T_NATIVE_DOUBLE,
+          H5S_ALL,
+          H5S_ALL,
+          H5P_DEFAULT,
+          values.data());
+
+  H5Pclose(plist);
+  H5Sclose(dataspace);
+  H5Dclose(dataset);
+  H5Fclose(file);
+
+  return values;
+}
+
+
+
+template <int dim>
+void
+check()
+{
+  std::vector<DataOutBase::Patch<dim, dim>> patches(100);
+  std::vector<std::string>                  names = {"u", "v"};
+  std::vector<
+    std::tuple<unsigned int,
+               unsigned int,
+               std::string,
+               DataComponentInterpretation::DataComponentInterpretation>>
+    vectors;
+
+  const std::string prefix = std::to_string(dim) + "d-";
+
+  std::vector<std::vector<double>> expected_values;
+  std::vector<double>              expected_nodes;
+  {
+    DataOutBase::AsynchronousHDF5Writer<dim> writer(
+      MPI_COMM_SELF,
+      /*max_pending_snapshots = */ 1,
+      DataOutBase::Hdf5Flags(DataOutBase::Hdf5Flags::best_speed, 64));
+
+    std::vector<std::future<void>> futures;
+    for (unsigned int step = 0; step < 3; ++step)
+      {
+        create_patches(patches, step);
+
+        DataOutBase::DataOutFilter data_filter(
+          DataOutBase::DataOutFilterFlags(true, true));
+        DataOutBase::write_filtered_data(patches,
+                                         names,
+                                         vectors,
+                                         data_filter);
+        expected_values.emplace_back(data_filter.get_data_set(0),
+                                     data_filter.get_data_set(0) +
+                                       data_filter.n_nodes());
+        if (step == 0)
+          data_filter.fill_node_data(expected_nodes);
+
+        futures.push_back(
+          writer.write(std::move(data_filter),
+                       step == 0,
+                       prefix + "mesh.h5",
+                       prefix + "solution-" + std::to_string(step) + ".h5"));
+
+        // we only allow one pending snapshot
+        AssertThrow(writer.n_pending_snapshots() <= 1, ExcInternalError());
+      }
+
+    for (auto &future : futures)
+      future.get();
+    AssertThrow(writer.n_pending_snapshots() == 0, ExcInternalError());
+  }
+
+  deallog << "nodes "
+          << (read_dataset(prefix + "mesh.h5", "nodes") == expected_nodes ?
+                "OK" :
+                "wrong")
+          << std::endl;
+  for (unsigned int step = 0; step < 3; ++step)
+    deallog << "values "
+            << (read_dataset(prefix + "solution-" + std::to_string(step) +
+                               ".h5",
+                             "u") == expected_values[step] ?
+                  "OK" :
+                  "wrong")
+            << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  check<2>();
+  check<3>();
+}
@@ -0,0 +1,181 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that DataOut::update_patch_data() produces the same output as
+// calling build_patches() again after the data vectors have changed, for
+// straight and for curved cells, and that the patch geometry is rebuilt
+// after the triangulation has been refined
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/data_out.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+class TimeDependentFunction : public Function<dim>
+{
+public:
+  TimeDependentFunction(const double time)
+    : Function<dim>(1, time)
+  {}
+
+  virtual double
+  value(const Point<dim> &p, const unsigned int) const override
+  {
+    return std::sin(p[0] + this->get_time()) * (1. + p[dim - 1]);
+  }
+};
+
+
+
+// write the patches in gnuplot format, leaving out the header because it
+// contains the current time
+template <int dim>
+std::string
+write_patches(const DataOut<dim> &data_out)
+{
+  std::ostringstream out;
+  data_out.write_gnuplot(out);
+
+  std::istringstream in(out.str());
+  std::string        line, result;
+  while (std::getline(in, line))
+    if (line.size() == 0 || line[0] != '#')
+      result += line + '\n';
+  return result;
+}
+
+
+
+template <int dim>
+std::string
+build_and_write(const DoFHandler<dim> &                        dof_handler,
+                const Vector<double> &                         solution,
+                const Vector<double> &                         cell_data,
+                const Mapping<dim> &                           mapping,
+                const unsigned int                             n_subdivisions,
+                const typename DataOut<dim>::CurvedCellRegion curved_region)
+{
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler(dof_handler);
+  data_out.add_data_vector(solution, "u");
+  data_out.add_data_vector(cell_data, "cell");
+  data_out.build_patches(mapping, n_subdivisions, curved_region);
+
+  return write_patches(data_out);
+}
+
+
+
+template <int dim>
+void
+check(const unsigned int                            n_subdivisions,
+      const typename DataOut<dim>::CurvedCellRegion curved_region)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball(tria);
+  tria.refine_global(1);
+
+  FE_Q<dim>       fe(2);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  MappingQ<dim> mapping(2);
+
+  Vector<double> solution(dof_handler.n_dofs());
+  Vector<double> cell_data(tria.n_active_cells());
+
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler(dof_handler);
+  data_out.add_data_vector(solution, "u");
+  data_out.add_data_vector(cell_data, "cell");
+
+  for (unsigned int step = 0; step < 3; ++step)
+    {
+      VectorTools::interpolate(mapping,
+                               dof_handler,
+                               TimeDependentFunction<dim>(0.1 * step),
+                               solution);
+      for (unsigned int c = 0; c < cell_data.size(); ++c)
+        cell_data[c] = c + step;
+
+      if (step == 0)
+        data_out.build_patches(mapping, n_subdivisions, curved_region);
+      else
+        data_out.update_patch_data();
+
+      const std::string reference = build_and_write(dof_handler,
+                                                    solution,
+                                                    cell_data,
+                                                    mapping,
+                                                    n_subdivisions,
+                                                    curved_region);
+      deallog << "Step " << step << ": "
+              << (write_patches(data_out) == reference ? "OK" :
+                                                         "different output")
+              << std::endl;
+    }
+
+  // after refinement, the patches have to be built from scratch, after
+  // which they can be updated again
+  tria.refine_global(1);
+  dof_handler.distribute_dofs(fe);
+  solution.reinit(dof_handler.n_dofs());
+  cell_data.reinit(tria.n_active_cells());
+
+  data_out.build_patches(mapping, n_subdivisions, curved_region);
+  VectorTools::interpolate(mapping,
+                           dof_handler,
+                           TimeDependentFunction<dim>(1.),
+                           solution);
+  data_out.update_patch_data();
+
+  const std::string reference = build_and_write(
+    dof_handler, solution, cell_data, mapping, n_subdivisions, curved_region);
+  deallog << "After refinement: " << tria.n_active_cells() << " cells, "
+          << (write_patches(data_out) == reference ? "OK" : "different output")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  check<2>(1, DataOut<2>::no_curved_cells);
+  check<2>(3, DataOut<2>::curved_boundary);
+  check<2>(3, DataOut<2>::curved_inner_cells);
+  deallog.pop();
+
+  deallog.push("3d");
+  check<3>(2, DataOut<3>::curved_inner_cells);
+  deallog.pop();
+}
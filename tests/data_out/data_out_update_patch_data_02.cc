@@ -0,0 +1,148 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that DataOut::update_patch_data() recomputes the location of the
+// vertices and of the subdivision points of the patches for a
+// MappingQEulerian whose displacement changes between the calls, so that
+// the output is the same as the one of a new call to build_patches()
+
+#include <deal.II/base/function_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/mapping_q_eulerian.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/data_out.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+class Displacement : public Function<dim>
+{
+public:
+  Displacement(const double time)
+    : Function<dim>(dim, time)
+  {}
+
+  virtual double
+  value(const Point<dim> &p, const unsigned int component) const override
+  {
+    return 0.1 * this->get_time() * std::sin(p[0] + component) * p[dim - 1];
+  }
+};
+
+
+
+// write the patches in gnuplot format, leaving out the header because it
+// contains the current time
+template <int dim>
+std::string
+write_patches(const DataOut<dim> &data_out)
+{
+  std::ostringstream out;
+  data_out.write_gnuplot(out);
+
+  std::istringstream in(out.str());
+  std::string        line, result;
+  while (std::getline(in, line))
+    if (line.size() == 0 || line[0] != '#')
+      result += line + '\n';
+  return result;
+}
+
+
+
+template <int dim>
+void
+check(const unsigned int                            n_subdivisions,
+      const typename DataOut<dim>::CurvedCellRegion curved_region)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+
+  FE_Q<dim>       fe(2);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  FESystem<dim>   fe_shift(FE_Q<dim>(2), dim);
+  DoFHandler<dim> dof_handler_shift(tria);
+  dof_handler_shift.distribute_dofs(fe_shift);
+
+  Vector<double> solution(dof_handler.n_dofs());
+  Vector<double> shift(dof_handler_shift.n_dofs());
+
+  MappingQEulerian<dim> mapping(2, dof_handler_shift, shift);
+
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler(dof_handler);
+  data_out.add_data_vector(solution, "u");
+
+  for (unsigned int step = 0; step < 3; ++step)
+    {
+      VectorTools::interpolate(dof_handler_shift,
+                               Displacement<dim>(step + 1.),
+                               shift);
+      VectorTools::interpolate(dof_handler,
+                               Functions::SquareFunction<dim>(),
+                               solution);
+      solution *= step + 1.;
+
+      if (step == 0)
+        data_out.build_patches(mapping, n_subdivisions, curved_region);
+      else
+        data_out.update_patch_data();
+
+      DataOut<dim> data_out_reference;
+      data_out_reference.attach_dof_handler(dof_handler);
+      data_out_reference.add_data_vector(solution, "u");
+      data_out_reference.build_patches(mapping, n_subdivisions, curved_region);
+
+      deallog << "Step " << step << ": "
+              << (write_patches(data_out) ==
+                      write_patches(data_out_reference) ?
+                    "OK" :
+                    "different output")
+              << std::endl;
+    }
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  check<2>(1, DataOut<2>::no_curved_cells);
+  check<2>(3, DataOut<2>::curved_inner_cells);
+  deallog.pop();
+
+  deallog.push("3d");
+  check<3>(2, DataOut<3>::curved_inner_cells);
+  deallog.pop();
+}
@@ -0,0 +1,145 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Write a coarse mesh in the binary coarse-mesh format and read it in
+// parallel, with each process reading only its locally relevant cells. The
+// boundary faces and, in 3D, the lines at x=1 carry manifold ids that must
+// survive the round trip.
+
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/distributed/fully_distributed_tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_description.h>
+
+#include "./tests.h"
+
+using namespace dealii;
+
+template <int dim>
+void
+test(const unsigned int n_subdivisions, MPI_Comm comm)
+{
+  const std::string filename = "coarse_mesh_" + std::to_string(dim) + "d.bin";
+
+  // write the coarse mesh on a single process
+  if (Utilities::MPI::this_mpi_process(comm) == 0)
+    {
+      Triangulation<dim> basetria;
+      GridGenerator::subdivided_hyper_cube(
+        basetria, n_subdivisions, -1, 1, true);
+      for (const auto &cell : basetria.active_cell_iterators())
+        for (const auto f : GeometryInfo<dim>::face_indices())
+          if (cell->at_boundary(f))
+            {
+              cell->face(f)->set_manifold_id(f + 1);
+              if (dim == 3 && f == 1)
+                for (unsigned int l = 0;
+                     l < GeometryInfo<dim - 1>::lines_per_cell;
+                     ++l)
+                  cell->face(f)->line(l)->set_manifold_id(10);
+            }
+      TriangulationDescription::Utilities::write_binary_coarse_mesh(basetria,
+                                                                    filename);
+    }
+  MPI_Barrier(comm);
+
+  // read the mesh in parallel and create the triangulation
+  const auto construction_data = TriangulationDescription::Utilities::
+    create_description_from_binary_coarse_mesh<dim>(filename, comm);
+
+  parallel::fullydistributed::Triangulation<dim> tria_pft(comm);
+  tria_pft.create_triangulation(construction_data);
+
+  // check the boundary, material, and manifold ids of the locally owned
+  // cells, which are surrounded by a complete layer of ghost cells
+  bool ids_ok          = true;
+  bool manifold_ids_ok = true;
+  for (const auto &cell : tria_pft.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        types::material_id material_id = 0;
+        for (unsigned int d = 0; d < dim; ++d)
+          if (cell->center()[d] > 0)
+            material_id += (1 << d);
+        if (cell->material_id() != material_id)
+          ids_ok = false;
+
+        for (const auto f : GeometryInfo<dim>::face_indices())
+          {
+            if (cell->at_boundary(f) && cell->face(f)->boundary_id() != f)
+              ids_ok = false;
+            if (cell->face(f)->manifold_id() !=
+                (cell->at_boundary(f) ? f + 1 : numbers::flat_manifold_id))
+              manifold_ids_ok = false;
+          }
+
+        if (dim == 3)
+          for (unsigned int l = 0; l < GeometryInfo<dim>::lines_per_cell; ++l)
+            if (cell->line(l)->manifold_id() !=
+                (std::abs(cell->line(l)->center()[0] - 1.) < 1e-10 ?
+                   10 :
+                   numbers::flat_manifold_id))
+              manifold_ids_ok = false;
+      }
+
+  FE_Q<dim>       fe(1);
+  DoFHandler<dim> dof_handler(tria_pft);
+  dof_handler.distribute_dofs(fe);
+
+  deallog << "n_active_cells:               " << tria_pft.n_active_cells()
+          << std::endl;
+  deallog << "n_locally_owned_active_cells: "
+          << tria_pft.n_locally_owned_active_cells() << std::endl;
+  deallog << "n_global_active_cells:        "
+          << tria_pft.n_global_active_cells() << std::endl;
+  deallog << "n_dofs:                       " << dof_handler.n_dofs()
+          << std::endl;
+  deallog << "Boundary and material ids:    " << (ids_ok ? "ok" : "fail")
+          << std::endl;
+  deallog << "Manifold ids:                 "
+          << (manifold_ids_ok ? "ok" : "fail") << std::endl;
+
+  MPI_Barrier(comm);
+  if (Utilities::MPI::this_mpi_process(comm) == 0)
+    std::remove(filename.c_str());
+}
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  MPILogInitAll                    all;
+
+  const MPI_Comm comm = MPI_COMM_WORLD;
+
+  {
+    deallog.push("2d");
+    test<2>(5, comm);
+    deallog.pop();
+  }
+  {
+    deallog.push("3d");
+    test<3>(4, comm);
+    deallog.pop();
+  }
+}
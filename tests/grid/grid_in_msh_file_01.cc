@@ -0,0 +1,290 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that GridIn::read_msh(filename), which parses files in the Gmsh 4.1
+// format from memory, produces the same triangulation as the stream-based
+// reader, both for ASCII files and for binary files. The meshes written by
+// this test are large enough to be parsed in several chunks.
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_in.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <string>
+
+#include "../tests.h"
+
+
+template <int dim>
+bool
+same_triangulation(const Triangulation<dim> &tria_1,
+                   const Triangulation<dim> &tria_2)
+{
+  if (tria_1.n_vertices() != tria_2.n_vertices() ||
+      tria_1.n_active_cells() != tria_2.n_active_cells())
+    return false;
+  for (unsigned int v = 0; v < tria_1.n_vertices(); ++v)
+    if (tria_1.get_vertices()[v] != tria_2.get_vertices()[v])
+      return false;
+
+  for (auto cell_1 = tria_1.begin_active(), cell_2 = tria_2.begin_active();
+       cell_1 != tria_1.end();
+       ++cell_1, ++cell_2)
+    {
+      if (cell_1->material_id() != cell_2->material_id())
+        return false;
+      for (const unsigned int v : GeometryInfo<dim>::vertex_indices())
+        if (cell_1->vertex_index(v) != cell_2->vertex_index(v))
+          return false;
+      for (const unsigned int f : GeometryInfo<dim>::face_indices())
+        if (cell_1->face(f)->boundary_id() != cell_2->face(f)->boundary_id())
+          return false;
+      for (unsigned int l = 0; l < GeometryInfo<dim>::lines_per_cell; ++l)
+        if (cell_1->line(l)->boundary_id() != cell_2->line(l)->boundary_id())
+          return false;
+    }
+  return true;
+}
+
+
+
+template <int dim>
+void
+check_file(const std::string &filename)
+{
+  Triangulation<dim> tria_stream, tria_file;
+
+  GridIn<dim> grid_in;
+  grid_in.attach_triangulation(tria_stream);
+  std::ifstream in(filename);
+  grid_in.read_msh(in);
+
+  grid_in.attach_triangulation(tria_file);
+  grid_in.read_msh(filename);
+
+  deallog << tria_file.n_active_cells() << " active cells, "
+          << tria_file.n_vertices() << " vertices, "
+          << (same_triangulation(tria_stream, tria_file) ? "OK" : "failed")
+          << std::endl;
+}
+
+
+
+// write a number in either the ASCII or the binary representation used by
+// Gmsh files
+template <typename Number>
+void
+write_number(std::ostream &out, const Number number, const bool binary)
+{
+  if (binary)
+    out.write(reinterpret_cast<const char *>(&number), sizeof(Number));
+  else
+    out << number << ' ';
+}
+
+
+
+// write a colorized hyper cube with two materials into a file in the Gmsh
+// 4.1 format, with one entity per material and per boundary id
+template <int dim>
+void
+write_msh_41(const Triangulation<dim> &tria,
+             const std::string &       filename,
+             const bool                binary)
+{
+  std::ofstream out(filename, std::ios::binary);
+  out << std::setprecision(17);
+  out << "$MeshFormat\n4.1 " << (binary ? 1 : 0) << " 8\n";
+  if (binary)
+    {
+      write_number<int>(out, 1, true);
+      out << '\n';
+    }
+  out << "$EndMeshFormat\n";
+
+  const std::uint64_t n_faces  = 2 * dim;
+  const std::uint64_t n_volume = 2;
+
+  // the physical tag of the cells is the material id, the one of the faces
+  // the boundary id plus ten
+  out << "$Entities\n";
+  for (unsigned int d = 0; d < 4; ++d)
+    write_number<std::uint64_t>(out,
+                                d == dim - 1 ? n_faces :
+                                               (d == dim ? n_volume : 0),
+                                binary);
+  for (const unsigned int d : {dim - 1, dim})
+    for (std::uint64_t e = 0; e < (d == dim ? n_volume : n_faces); ++e)
+      {
+        write_number<int>(out, e + 1, binary);
+        for (unsigned int c = 0; c < 6; ++c)
+          write_number<double>(out, 0., binary);
+        write_number<std::uint64_t>(out, 1, binary);
+        write_number<int>(out, d == dim ? e + 1 : e + 10, binary);
+        write_number<std::uint64_t>(out, 0, binary);
+      }
+  out << "\n$EndEntities\n";
+
+  out << "$Nodes\n";
+  write_number<std::uint64_t>(out, 1, binary);
+  write_number<std::uint64_t>(out, tria.n_vertices(), binary);
+  write_number<std::uint64_t>(out, 1, binary);
+  write_number<std::uint64_t>(out, tria.n_vertices(), binary);
+  write_number<int>(out, dim, binary);
+  write_number<int>(out, 1, binary);
+  write_number<int>(out, 0, binary);
+  write_number<std::uint64_t>(out, tria.n_vertices(), binary);
+  for (unsigned int v = 0; v < tria.n_vertices(); ++v)
+    write_number<std::uint64_t>(out, v + 1, binary);
+  for (const Point<dim> &vertex : tria.get_vertices())
+    for (unsigned int d = 0; d < 3; ++d)
+      write_number<double>(out, d < dim ? vertex[d] : 0., binary);
+  out << "\n$EndNodes\n";
+
+  // Gmsh enumerates the vertices of quadrilaterals and hexahedra in
+  // counter-clockwise order
+  const unsigned int vertex_permutation[8] = {0, 1, 3, 2, 4, 5, 7, 6};
+  const unsigned int face_type = (dim == 2 ? 1 : 3);
+  const unsigned int cell_type = (dim == 2 ? 3 : 5);
+
+  std::uint64_t n_elements = 0;
+  for (const auto &cell : tria.active_cell_iterators())
+    {
+      ++n_elements;
+      for (const unsigned int f : GeometryInfo<dim>::face_indices())
+        if (cell->at_boundary(f))
+          ++n_elements;
+    }
+
+  out << "$Elements\n";
+  write_number<std::uint64_t>(out, n_faces + n_volume, binary);
+  write_number<std::uint64_t>(out, n_elements, binary);
+  write_number<std::uint64_t>(out, 1, binary);
+  write_number<std::uint64_t>(out, n_elements, binary);
+  std::uint64_t element_tag = 1;
+  for (std::uint64_t e = 0; e < n_faces; ++e)
+    {
+      std::vector<std::vector<unsigned int>> faces;
+      for (const auto &cell : tria.active_cell_iterators())
+        for (const unsigned int f : GeometryInfo<dim>::face_indices())
+          if (cell->at_boundary(f) && cell->face(f)->boundary_id() == e)
+            {
+              std::vector<unsigned int> face_vertices;
+              for (const unsigned int v :
+                   GeometryInfo<dim - 1>::vertex_indices())
+                face_vertices.push_back(
+                  cell->face(f)->vertex_index(vertex_permutation[v]));
+              faces.push_back(face_vertices);
+            }
+
+      write_number<int>(out, dim - 1, binary);
+      write_number<int>(out, e + 1, binary);
+      write_number<int>(out, face_type, binary);
+      write_number<std::uint64_t>(out, faces.size(), binary);
+      for (const auto &face : faces)
+        {
+          write_number<std::uint64_t>(out, element_tag++, binary);
+          for (const unsigned int v : face)
+            write_number<std::uint64_t>(out, v + 1, binary);
+        }
+    }
+  for (std::uint64_t e = 0; e < n_volume; ++e)
+    {
+      std::uint64_t n_cells = 0;
+      for (const auto &cell : tria.active_cell_iterators())
+        if (cell->material_id() == e + 1)
+          ++n_cells;
+
+      write_number<int>(out, dim, binary);
+      write_number<int>(out, e + 1, binary);
+      write_number<int>(out, cell_type, binary);
+      write_number<std::uint64_t>(out, n_cells, binary);
+      for (const auto &cell : tria.active_cell_iterators())
+        if (cell->material_id() == e + 1)
+          {
+            write_number<std::uint64_t>(out, element_tag++, binary);
+            for (const unsigned int v : GeometryInfo<dim>::vertex_indices())
+              write_number<std::uint64_t>(
+                out, cell->vertex_index(vertex_permutation[v]) + 1, binary);
+          }
+    }
+  out << "\n$EndElements\n";
+}
+
+
+
+template <int dim>
+void
+check_generated(const unsigned int n_subdivisions)
+{
+  Triangulation<dim> tria;
+  GridGenerator::subdivided_hyper_cube(tria, n_subdivisions, 0., 1., true);
+  for (const auto &cell : tria.active_cell_iterators())
+    cell->set_material_id(cell->center()[0] < 0.5 ? 1 : 2);
+
+  const std::string ascii_name  = "mesh_" + std::to_string(dim) + "d.msh";
+  const std::string binary_name = "mesh_" + std::to_string(dim) + "d_bin.msh";
+  write_msh_41(tria, ascii_name, false);
+  write_msh_41(tria, binary_name, true);
+
+  deallog << "ASCII:  ";
+  check_file<dim>(ascii_name);
+
+  Triangulation<dim> tria_ascii, tria_binary;
+  GridIn<dim>        grid_in;
+  grid_in.attach_triangulation(tria_ascii);
+  grid_in.read(ascii_name);
+  grid_in.attach_triangulation(tria_binary);
+  grid_in.read(binary_name);
+
+  std::map<types::boundary_id, unsigned int> n_boundary_faces;
+  for (const auto &cell : tria_binary.active_cell_iterators())
+    for (const unsigned int f : GeometryInfo<dim>::face_indices())
+      if (cell->at_boundary(f))
+        ++n_boundary_faces[cell->face(f)->boundary_id()];
+
+  deallog << "Binary: " << tria_binary.n_active_cells() << " active cells, "
+          << tria_binary.n_vertices() << " vertices, "
+          << (same_triangulation(tria_ascii, tria_binary) ? "OK" : "failed")
+          << std::endl;
+  for (const auto &it : n_boundary_faces)
+    deallog << "Boundary id " << it.first << ": " << it.second << " faces"
+            << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  check_file<2>(SOURCE_DIR "/grids/grid_in_msh_01.2d.v41.msh");
+  check_file<2>(SOURCE_DIR "/grids/grid_in_msh_01.2da.v41.msh");
+  check_generated<2>(40);
+  deallog.pop();
+
+  deallog.push("3d");
+  check_file<3>(SOURCE_DIR "/grids/grid_in_msh_01.3d.v41.msh");
+  check_file<3>(SOURCE_DIR "/grids/grid_in_msh_01.3da.v41.msh");
+  check_file<3>(SOURCE_DIR "/grids/grid_in_msh_01.3d_neg.v41.msh");
+  check_generated<3>(12);
+  deallog.pop();
+}
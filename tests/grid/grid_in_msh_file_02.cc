@@ -0,0 +1,96 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that GridIn::read_msh(filename) reads the coordinates of the
+// vertices correctly if the program uses a locale with a comma as decimal
+// separator, both for the C library and for C++ streams. Gmsh files always
+// use a period as decimal separator.
+
+#include <deal.II/grid/grid_in.h>
+#include <deal.II/grid/tria.h>
+
+#include <clocale>
+#include <locale>
+#include <string>
+
+#include "../tests.h"
+
+
+// a numeric punctuation facet with comma as decimal separator
+class CommaNumpunct : public std::numpunct<char>
+{
+protected:
+  char
+  do_decimal_point() const override
+  {
+    return ',';
+  }
+};
+
+
+
+template <int dim>
+void
+check_file(const std::string &filename)
+{
+  Triangulation<dim> tria_stream, tria_file;
+
+  GridIn<dim> grid_in;
+  grid_in.attach_triangulation(tria_stream);
+  std::ifstream in(filename);
+  grid_in.read_msh(in);
+
+  // change the locale of C++ streams created from now on, and, if one of
+  // the following locales is installed, the locale used by the functions of
+  // the C library to convert numbers
+  const std::locale old_locale =
+    std::locale::global(std::locale(std::locale::classic(), new CommaNumpunct));
+  for (const char *name : {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8"})
+    if (std::setlocale(LC_NUMERIC, name) != nullptr)
+      break;
+
+  grid_in.attach_triangulation(tria_file);
+  grid_in.read_msh(filename);
+
+  std::setlocale(LC_NUMERIC, "C");
+  std::locale::global(old_locale);
+
+  bool same_vertices = (tria_stream.n_vertices() == tria_file.n_vertices());
+  for (unsigned int v = 0; same_vertices && v < tria_stream.n_vertices(); ++v)
+    if (tria_stream.get_vertices()[v] != tria_file.get_vertices()[v])
+      same_vertices = false;
+
+  deallog << tria_file.n_active_cells() << " active cells, "
+          << tria_file.n_vertices() << " vertices, "
+          << (same_vertices ? "OK" : "failed") << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  check_file<2>(SOURCE_DIR "/grids/grid_in_msh_01.2da.v41.msh");
+  deallog.pop();
+
+  deallog.push("3d");
+  check_file<3>(SOURCE_DIR "/grids/grid_in_msh_01.3da.v41.msh");
+  deallog.pop();
+}
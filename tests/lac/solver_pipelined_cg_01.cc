@@ -0,0 +1,138 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// check SolverPipelinedCG and SolverSStepCG against SolverCG on the
+// five-point Laplacian with different preconditioners: all solvers must
+// converge to the same solution, the pipelined method in about the same
+// number of iterations
+
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_pipelined_cg.h>
+#include <deal.II/lac/solver_s_step_cg.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_memory.h>
+
+#include "../tests.h"
+
+#include "../testmatrix.h"
+
+
+template <typename SolverType, typename PreconditionerType>
+void
+check_solve(const std::string &         name,
+            SolverType &                solver,
+            const SolverControl &       control,
+            const SparseMatrix<double> &A,
+            const Vector<double> &      reference,
+            const PreconditionerType &  preconditioner)
+{
+  Vector<double> u(reference.size());
+  Vector<double> f(reference.size());
+  f = 1.;
+  try
+    {
+      solver.solve(A, u, f, preconditioner);
+    }
+  catch (SolverControl::NoConvergence &e)
+    {
+      deallog << "Exception: " << e.get_exc_name() << std::endl;
+    }
+  u -= reference;
+  deallog << name << " iterations: " << control.last_step()
+          << ", difference to CG solution: "
+          << (u.l2_norm() < 1e-7 * reference.l2_norm() ? "ok" : "too large")
+          << std::endl;
+}
+
+
+
+template <typename PreconditionerType>
+void
+check(const SparseMatrix<double> &A, const PreconditionerType &preconditioner)
+{
+  GrowingVectorMemory<Vector<double>> memory;
+
+  // the residual values at convergence depend on roundoff, so only the
+  // number of iterations is printed
+  SolverControl control(1000, 1e-10, false, false);
+
+  Vector<double> reference(A.m());
+  Vector<double> f(A.m());
+  f = 1.;
+  {
+    SolverCG<Vector<double>> solver(control, memory);
+    solver.solve(A, reference, f, preconditioner);
+    deallog << "CG iterations: " << control.last_step() << std::endl;
+  }
+
+  {
+    SolverPipelinedCG<Vector<double>> solver(control, memory);
+    check_solve("Pipelined CG", solver, control, A, reference, preconditioner);
+  }
+
+  for (unsigned int s = 1; s < 6; s += 2)
+    {
+      SolverSStepCG<Vector<double>> solver(
+        control, memory, SolverSStepCG<Vector<double>>::AdditionalData(s));
+      check_solve("s-step CG with s=" + std::to_string(s),
+                  solver,
+                  control,
+                  A,
+                  reference,
+                  preconditioner);
+    }
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  for (unsigned int size = 4; size <= 30; size *= 3)
+    {
+      const unsigned int dim = (size - 1) * (size - 1);
+
+      deallog << "Size " << size << " Unknowns " << dim << std::endl;
+
+      FDMatrix        testproblem(size, size);
+      SparsityPattern structure(dim, dim, 5);
+      testproblem.five_point_structure(structure);
+      structure.compress();
+      SparseMatrix<double> A(structure);
+      testproblem.five_point(A);
+
+      deallog.push("no");
+      check(A, PreconditionIdentity());
+      deallog.pop();
+
+      deallog.push("jacobi");
+      PreconditionJacobi<> jacobi;
+      jacobi.initialize(A, 0.8);
+      check(A, jacobi);
+      deallog.pop();
+
+      deallog.push("ssor");
+      PreconditionSSOR<> ssor;
+      ssor.initialize(A, 1.2);
+      check(A, ssor);
+      deallog.pop();
+    }
+}
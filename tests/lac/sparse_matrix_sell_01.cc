@@ -0,0 +1,167 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// check that SparseMatrixSELL computes the same products and
+// preconditioner applications as the SparseMatrix it was copied from, for a
+// matrix with rows of varying length, and that it can be used in SolverCG
+
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparse_matrix_sell.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+template <typename number>
+void
+check_difference(const Vector<number> &reference,
+                 const Vector<number> &result,
+                 const std::string &   name)
+{
+  Vector<number> diff(reference);
+  diff -= result;
+  deallog << name << " difference: "
+          << (diff.linfty_norm() <= 1e-12 * reference.linfty_norm() ? "OK" :
+                                                                        "FAIL")
+          << std::endl;
+}
+
+
+
+void
+test(const unsigned int n, const unsigned int sorting_scope)
+{
+  deallog << "n=" << n << ", sorting_scope=" << sorting_scope << std::endl;
+
+  // set up a symmetric, diagonally dominant matrix whose rows have different
+  // lengths: every row couples to its neighbors, and every third row also
+  // to rows further away
+  SparsityPattern sparsity(n, n, 7);
+  for (unsigned int i = 0; i < n; ++i)
+    {
+      sparsity.add(i, i);
+      if (i > 0)
+        sparsity.add(i, i - 1);
+      if (i + 1 < n)
+        sparsity.add(i, i + 1);
+      if (i % 3 == 0 && i + 7 < n)
+        {
+          sparsity.add(i, i + 7);
+          sparsity.add(i + 7, i);
+        }
+    }
+  sparsity.compress();
+
+  SparseMatrix<double> matrix(sparsity);
+  for (unsigned int i = 0; i < n; ++i)
+    for (auto entry = sparsity.begin(i); entry != sparsity.end(i); ++entry)
+      if (entry->column() < i)
+        {
+          const double value = -1. - 0.1 * ((i + entry->column()) % 5);
+          matrix.set(i, entry->column(), value);
+          matrix.set(entry->column(), i, value);
+        }
+  for (unsigned int i = 0; i < n; ++i)
+    {
+      double sum = 0;
+      for (auto entry = matrix.begin(i); entry != matrix.end(i); ++entry)
+        sum += std::abs(entry->value());
+      matrix.set(i, i, sum + 1.);
+    }
+
+  SparseMatrixSELL<double> sell(matrix, sorting_scope);
+  AssertDimension(sell.m(), n);
+  AssertDimension(sell.n(), n);
+  AssertDimension(sell.n_nonzero_elements(), matrix.n_nonzero_elements());
+  AssertThrow(sell.n_stored_elements() >= sell.n_nonzero_elements(),
+              ExcInternalError());
+
+  for (unsigned int i = 0; i < n; ++i)
+    for (auto entry = matrix.begin(i); entry != matrix.end(i); ++entry)
+      AssertThrow(sell.el(i, entry->column()) == entry->value(),
+                  ExcInternalError());
+
+  Vector<double> src(n), reference(n), result(n);
+  for (unsigned int i = 0; i < n; ++i)
+    src(i) = random_value<double>();
+
+  matrix.vmult(reference, src);
+  sell.vmult(result, src);
+  check_difference(reference, result, "vmult");
+
+  matrix.vmult_add(reference, src);
+  sell.vmult_add(result, src);
+  check_difference(reference, result, "vmult_add");
+
+  matrix.Tvmult(reference, src);
+  sell.Tvmult(result, src);
+  check_difference(reference, result, "Tvmult");
+
+  matrix.precondition_Jacobi(reference, src, 0.8);
+  sell.precondition_Jacobi(result, src, 0.8);
+  check_difference(reference, result, "Jacobi");
+
+  matrix.precondition_SOR(reference, src, 1.2);
+  sell.precondition_SOR(result, src, 1.2);
+  check_difference(reference, result, "SOR");
+
+  matrix.precondition_TSOR(reference, src, 1.2);
+  sell.precondition_TSOR(result, src, 1.2);
+  check_difference(reference, result, "TSOR");
+
+  matrix.precondition_SSOR(reference, src, 1.2);
+  sell.precondition_SSOR(result, src, 1.2);
+  check_difference(reference, result, "SSOR");
+
+  // solve a linear system with both matrices and compare the solutions
+  SolverControl        control(1000, 1e-12 * src.l2_norm());
+  SolverCG<>           solver(control);
+  PreconditionJacobi<> preconditioner;
+  preconditioner.initialize(matrix);
+  reference = 0;
+  solver.solve(matrix, reference, src, preconditioner);
+
+  PreconditionJacobi<SparseMatrixSELL<double>> preconditioner_sell;
+  preconditioner_sell.initialize(sell);
+  result = 0;
+  solver.solve(sell, result, src, preconditioner_sell);
+
+  Vector<double> diff(reference);
+  diff -= result;
+  deallog << "CG difference: "
+          << (diff.linfty_norm() <= 1e-8 * reference.linfty_norm() ? "OK" :
+                                                                     "FAIL")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+  deallog.depth_file(1);
+
+  test(1, 8);
+  test(13, 1);
+  test(100, 8);
+  test(100, 32);
+  test(1000, 64);
+}
@@ -0,0 +1,131 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// This test verifies that TransfiniteInterpolationManifold::get_new_points()
+// computes the same points as get_new_point() on both flat and curved coarse
+// cells, also with a number of points that is not a multiple of the width
+// of VectorizedArray, and that the cache of chart points is reset when the
+// mesh is moved.
+
+#include <deal.II/base/table.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/manifold_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+check_new_points(const Triangulation<dim> &tria)
+{
+  const Manifold<dim> &manifold = tria.get_manifold(1);
+
+  const unsigned int n_points       = 7;
+  double             max_difference = 0;
+  Point<dim>         sum_of_points;
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->manifold_id() == 1)
+      {
+        std::vector<Point<dim>> surrounding_points;
+        for (const unsigned int v : GeometryInfo<dim>::vertex_indices())
+          surrounding_points.push_back(cell->vertex(v));
+
+        Table<2, double> weights(n_points, surrounding_points.size());
+        for (unsigned int i = 0; i < n_points; ++i)
+          {
+            double sum = 0;
+            for (unsigned int v = 0; v < surrounding_points.size(); ++v)
+              {
+                weights(i, v) = 0.1 + random_value<double>();
+                sum += weights(i, v);
+              }
+            for (unsigned int v = 0; v < surrounding_points.size(); ++v)
+              weights(i, v) /= sum;
+          }
+
+        std::vector<Point<dim>> new_points(n_points);
+        manifold.get_new_points(make_array_view(surrounding_points),
+                                weights,
+                                make_array_view(new_points));
+
+        for (unsigned int i = 0; i < n_points; ++i)
+          {
+            std::vector<double> point_weights(surrounding_points.size());
+            for (unsigned int v = 0; v < surrounding_points.size(); ++v)
+              point_weights[v] = weights(i, v);
+            const Point<dim> new_point =
+              manifold.get_new_point(make_array_view(surrounding_points),
+                                     make_array_view(point_weights));
+            max_difference =
+              std::max(max_difference, new_point.distance(new_points[i]));
+            sum_of_points += new_point;
+          }
+      }
+
+  deallog << "Sum of new points: " << sum_of_points << std::endl;
+  deallog << "get_new_points() matches get_new_point(): "
+          << (max_difference < 1e-12 ? "yes" : "no") << std::endl;
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  deallog << "Testing dim=" << dim << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball(tria);
+  tria.set_all_manifold_ids(1);
+  tria.set_all_manifold_ids_on_boundary(0);
+  tria.set_manifold(0, SphericalManifold<dim>());
+  TransfiniteInterpolationManifold<dim> transfinite;
+  transfinite.initialize(tria);
+  tria.set_manifold(1, transfinite);
+  tria.refine_global(1);
+
+  check_new_points(tria);
+
+  // move the mesh and make sure that the chart points of the old positions
+  // are not used any more
+  Tensor<1, dim> shift;
+  shift[0] = 0.5;
+  GridTools::shift(shift, tria);
+  tria.set_manifold(0, SphericalManifold<dim>(Point<dim>(shift)));
+  tria.refine_global(1);
+
+  check_new_points(tria);
+}
+
+
+
+int
+main()
+{
+  initlog();
+  deallog << std::setprecision(9);
+
+  test<2>();
+  test<3>();
+
+  return 0;
+}
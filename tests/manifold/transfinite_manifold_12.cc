@@ -0,0 +1,132 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// This test verifies that TransfiniteInterpolationManifold does not use the
+// chart points it memorized for a coarse cell once a vertex of that coarse
+// cell has been moved directly, i.e., without a signal of the
+// triangulation. The new points must match the ones of a manifold on a
+// coarse mesh where the vertex has been moved before initialization.
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/manifold_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+attach_manifolds(Triangulation<dim> &                   tria,
+                 TransfiniteInterpolationManifold<dim> &transfinite)
+{
+  tria.set_all_manifold_ids(1);
+  tria.set_all_manifold_ids_on_boundary(0);
+  tria.set_manifold(0, SphericalManifold<dim>());
+  transfinite.initialize(tria);
+  tria.set_manifold(1, transfinite);
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  deallog << "Testing dim=" << dim << std::endl;
+
+  Triangulation<dim>                    tria;
+  TransfiniteInterpolationManifold<dim> transfinite;
+  GridGenerator::hyper_ball(tria);
+  attach_manifolds(tria, transfinite);
+  tria.refine_global(1);
+
+  // find a vertex of a coarse cell in the interior of the ball and a child
+  // of that cell that does not touch the vertex
+  typename Triangulation<dim>::cell_iterator coarse_cell = tria.begin(0);
+  unsigned int                                moved_vertex = 0;
+  for (; coarse_cell != tria.end(0); ++coarse_cell)
+    {
+      bool found = false;
+      for (const unsigned int v : GeometryInfo<dim>::vertex_indices())
+        if (coarse_cell->vertex(v).norm() < 0.9)
+          {
+            moved_vertex = v;
+            found        = true;
+            break;
+          }
+      if (found)
+        break;
+    }
+  AssertThrow(coarse_cell != tria.end(0), ExcInternalError());
+  const auto child = coarse_cell->child(GeometryInfo<dim>::vertices_per_cell -
+                                        1 - moved_vertex);
+
+  std::vector<Point<dim>> surrounding_points;
+  for (const unsigned int v : GeometryInfo<dim>::vertex_indices())
+    surrounding_points.push_back(child->vertex(v));
+  const std::vector<double> weights(surrounding_points.size(),
+                                    1. / surrounding_points.size());
+
+  const Point<dim> point_before =
+    tria.get_manifold(1).get_new_point(make_array_view(surrounding_points),
+                                       make_array_view(weights));
+
+  // move the vertex without notifying the triangulation
+  Point<dim> shift;
+  for (unsigned int d = 0; d < dim; ++d)
+    shift[d] = 0.02 * (d + 1);
+  coarse_cell->vertex(moved_vertex) += shift;
+
+  const Point<dim> point_after =
+    tria.get_manifold(1).get_new_point(make_array_view(surrounding_points),
+                                       make_array_view(weights));
+
+  // move the same vertex on a new coarse mesh before setting up the manifold
+  Triangulation<dim>                    reference_tria;
+  TransfiniteInterpolationManifold<dim> reference_transfinite;
+  GridGenerator::hyper_ball(reference_tria);
+  typename Triangulation<dim>::cell_iterator reference_cell(
+    &reference_tria, 0, coarse_cell->index());
+  reference_cell->vertex(moved_vertex) += shift;
+  attach_manifolds(reference_tria, reference_transfinite);
+
+  const Point<dim> point_reference =
+    reference_tria.get_manifold(1).get_new_point(
+      make_array_view(surrounding_points), make_array_view(weights));
+
+  deallog << "Moving the vertex changes the new point: "
+          << (point_before.distance(point_reference) > 1e-6 ? "yes" : "no")
+          << std::endl;
+  deallog << "New point matches the one of a new manifold: "
+          << (point_after.distance(point_reference) < 1e-12 ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+
+  return 0;
+}
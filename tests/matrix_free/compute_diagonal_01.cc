@@ -0,0 +1,189 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// test MatrixFreeTools::compute_diagonal() and
+// MatrixFreeTools::compute_matrix() for a Helmholtz operator on a mesh with
+// hanging nodes and Dirichlet boundary conditions by comparing with the
+// matrix assembled with FEValues
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/tools.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+template <int dim, int fe_degree>
+class HelmholtzOperator
+{
+public:
+  void
+  local_apply_cell(FEEvaluation<dim, fe_degree> &phi) const
+  {
+    phi.evaluate(true, true);
+    for (unsigned int q = 0; q < phi.n_q_points; ++q)
+      {
+        phi.submit_value(10. * phi.get_value(q), q);
+        phi.submit_gradient(phi.get_gradient(q), q);
+      }
+    phi.integrate(true, true);
+  }
+};
+
+
+
+template <int dim, int fe_degree>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball(tria);
+  tria.refine_global(1);
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->center().norm() < 0.5)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  FE_Q<dim>       fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  DoFTools::make_hanging_node_constraints(dof, constraints);
+  VectorTools::interpolate_boundary_values(dof,
+                                           0,
+                                           Functions::ZeroFunction<dim>(),
+                                           constraints);
+  constraints.close();
+
+  deallog << "Testing " << fe.get_name() << std::endl;
+
+  MappingQGeneric<dim> mapping(fe_degree);
+  MatrixFree<dim>      matrix_free;
+  matrix_free.reinit(mapping, dof, constraints, QGauss<1>(fe_degree + 1));
+
+  // assemble the reference matrix
+  SparsityPattern sparsity;
+  {
+    DynamicSparsityPattern dsp(dof.n_dofs(), dof.n_dofs());
+    DoFTools::make_sparsity_pattern(dof, dsp, constraints, false);
+    sparsity.copy_from(dsp);
+  }
+  SparseMatrix<double> reference_matrix(sparsity);
+  {
+    const QGauss<dim> quadrature(fe_degree + 1);
+    FEValues<dim>     fe_values(mapping,
+                            fe,
+                            quadrature,
+                            update_values | update_gradients |
+                              update_JxW_values);
+
+    FullMatrix<double> cell_matrix(fe.dofs_per_cell, fe.dofs_per_cell);
+    std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+    for (const auto &cell : dof.active_cell_iterators())
+      {
+        fe_values.reinit(cell);
+        cell_matrix = 0;
+        for (unsigned int q = 0; q < quadrature.size(); ++q)
+          for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+            for (unsigned int j = 0; j < fe.dofs_per_cell; ++j)
+              cell_matrix(i, j) +=
+                (fe_values.shape_grad(i, q) * fe_values.shape_grad(j, q) +
+                 10. * fe_values.shape_value(i, q) *
+                   fe_values.shape_value(j, q)) *
+                fe_values.JxW(q);
+        cell->get_dof_indices(dof_indices);
+        constraints.distribute_local_to_global(cell_matrix,
+                                               dof_indices,
+                                               reference_matrix);
+      }
+  }
+
+  // compute the diagonal with a lambda
+  LinearAlgebra::distributed::Vector<double> diagonal;
+  MatrixFreeTools::compute_diagonal(
+    matrix_free,
+    constraints,
+    diagonal,
+    std::function<void(FEEvaluation<dim, fe_degree> &)>(
+      [](FEEvaluation<dim, fe_degree> &phi) {
+        HelmholtzOperator<dim, fe_degree>().local_apply_cell(phi);
+      }));
+
+  double diagonal_error = 0;
+  for (unsigned int i = 0; i < dof.n_dofs(); ++i)
+    diagonal_error =
+      std::max(diagonal_error,
+               std::abs(diagonal(i) - reference_matrix.diag_element(i)));
+  deallog << "Error diagonal: "
+          << (diagonal_error / diagonal.linfty_norm() < 1e-12 ? "ok" : "fail")
+          << std::endl;
+
+  // compute the matrix with a member function pointer
+  HelmholtzOperator<dim, fe_degree> helmholtz_operator;
+  SparseMatrix<double>              matrix(sparsity);
+  MatrixFreeTools::compute_matrix(
+    matrix_free,
+    constraints,
+    matrix,
+    &HelmholtzOperator<dim, fe_degree>::local_apply_cell,
+    &helmholtz_operator);
+
+  matrix.add(-1., reference_matrix);
+  deallog << "Error matrix: "
+          << (matrix.frobenius_norm() / reference_matrix.frobenius_norm() <
+                  1e-12 ?
+                "ok" :
+                "fail")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2, 1>();
+  test<2, 2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3, 1>();
+  test<3, 2>();
+  deallog.pop();
+}
@@ -0,0 +1,158 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// test the application of hanging-node constraints on the fly in
+// FEEvaluation (AdditionalData::use_fast_hanging_node_algorithm) by comparing
+// a Helmholtz operator against the same operator using the general
+// constraint pool, on meshes with hanging faces and (in 3D) hanging edges
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+template <int dim, int fe_degree, int n_components>
+void
+helmholtz_operator(const MatrixFree<dim, double> &               data,
+                   Vector<double> &                              dst,
+                   const Vector<double> &                        src,
+                   const std::pair<unsigned int, unsigned int> &cell_range)
+{
+  FEEvaluation<dim, fe_degree, fe_degree + 1, n_components> phi(data);
+
+  for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      phi.reinit(cell);
+      phi.read_dof_values(src);
+      phi.evaluate(EvaluationFlags::values | EvaluationFlags::gradients);
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+        {
+          phi.submit_value(10. * phi.get_value(q), q);
+          phi.submit_gradient(phi.get_gradient(q), q);
+        }
+      phi.integrate(EvaluationFlags::values | EvaluationFlags::gradients);
+      phi.distribute_local_to_global(dst);
+    }
+}
+
+
+
+template <int dim, int fe_degree, int n_components>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria, -1, 1);
+  tria.refine_global(1);
+  // refine all cells except those in the quadrant x>0, y>0 to get hanging
+  // edges in 3D, then refine the small cell in the corner to get a second
+  // level of hanging nodes
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->center()[0] < 0. || cell->center()[1] < 0.)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->center()[0] < -0.6 && cell->center()[1] < -0.6 &&
+        (dim == 2 || cell->center()[dim - 1] < -0.6))
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  const FESystem<dim> fe(FE_Q<dim>{fe_degree}, n_components);
+  DoFHandler<dim>     dof(tria);
+  dof.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  DoFTools::make_hanging_node_constraints(dof, constraints);
+  VectorTools::interpolate_boundary_values(
+    dof, 0, Functions::ZeroFunction<dim>(n_components), constraints);
+  constraints.close();
+
+  deallog << "Testing " << fe.get_name() << std::endl;
+
+  const QGauss<1> quad(fe_degree + 1);
+  typename MatrixFree<dim, double>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::none;
+
+  MatrixFree<dim, double> mf_data_fast, mf_data_pool;
+  data.use_fast_hanging_node_algorithm = true;
+  mf_data_fast.reinit(dof, constraints, quad, data);
+  data.use_fast_hanging_node_algorithm = false;
+  mf_data_pool.reinit(dof, constraints, quad, data);
+
+  deallog << "Uses hanging-node masks: "
+          << !mf_data_fast.get_dof_info().hanging_node_constraint_masks.empty()
+          << " / "
+          << !mf_data_pool.get_dof_info().hanging_node_constraint_masks.empty()
+          << std::endl;
+
+  Vector<double> src(dof.n_dofs()), dst_fast(dof.n_dofs()),
+    dst_pool(dof.n_dofs());
+  for (unsigned int i = 0; i < dof.n_dofs(); ++i)
+    if (constraints.is_constrained(i) == false)
+      src(i) = random_value<double>();
+
+  mf_data_fast.cell_loop(&helmholtz_operator<dim, fe_degree, n_components>,
+                         dst_fast,
+                         src);
+  mf_data_pool.cell_loop(&helmholtz_operator<dim, fe_degree, n_components>,
+                         dst_pool,
+                         src);
+
+  dst_fast -= dst_pool;
+  deallog << "Error vmult: "
+          << (dst_fast.linfty_norm() / dst_pool.linfty_norm() < 1e-12 ? "ok" :
+                                                                        "fail")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2, 1, 1>();
+  test<2, 2, 1>();
+  test<2, 3, 1>();
+  test<2, 2, 2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3, 1, 1>();
+  test<3, 2, 1>();
+  test<3, 3, 1>();
+  test<3, 2, 3>();
+  deallog.pop();
+}
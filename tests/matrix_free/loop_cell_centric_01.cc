@@ -0,0 +1,325 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// compares the application of a symmetric interior penalty DG Laplacian with
+// MatrixFree::loop() and with MatrixFree::loop_cell_centric(), where the
+// latter reads the values and gradients of the neighbors through an
+// FEFaceEvaluation object on the exterior side of the faces of each cell
+
+#include <deal.II/base/logstream.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include "../tests.h"
+
+
+template <int dim, int fe_degree, typename number>
+class LaplaceOperator
+{
+public:
+  using VectorType = LinearAlgebra::distributed::Vector<number>;
+
+  LaplaceOperator(const Mapping<dim> &mapping, const DoFHandler<dim> &dof)
+  {
+    typename MatrixFree<dim, number>::AdditionalData additional_data;
+    additional_data.tasks_parallel_scheme =
+      MatrixFree<dim, number>::AdditionalData::none;
+    additional_data.mapping_update_flags =
+      update_gradients | update_JxW_values;
+    additional_data.mapping_update_flags_inner_faces =
+      update_JxW_values | update_normal_vectors | update_jacobians;
+    additional_data.mapping_update_flags_boundary_faces =
+      update_JxW_values | update_normal_vectors | update_jacobians;
+    additional_data.mapping_update_flags_faces_by_cells =
+      update_JxW_values | update_normal_vectors | update_jacobians;
+    additional_data.hold_all_faces_to_owned_cells = true;
+
+    AffineConstraints<double> constraints;
+    constraints.close();
+    data.reinit(
+      mapping, dof, constraints, QGauss<1>(fe_degree + 1), additional_data);
+  }
+
+  void
+  initialize_dof_vector(VectorType &vec) const
+  {
+    data.initialize_dof_vector(vec);
+  }
+
+  void
+  vmult_face_centric(VectorType &dst, const VectorType &src) const
+  {
+    data.loop(&LaplaceOperator::local_apply_cell,
+              &LaplaceOperator::local_apply_face,
+              &LaplaceOperator::local_apply_boundary,
+              this,
+              dst,
+              src,
+              true,
+              MatrixFree<dim, number>::DataAccessOnFaces::gradients,
+              MatrixFree<dim, number>::DataAccessOnFaces::gradients);
+  }
+
+  void
+  vmult_cell_centric(VectorType &dst, const VectorType &src) const
+  {
+    data.loop_cell_centric(
+      &LaplaceOperator::local_apply_cell_centric,
+      this,
+      dst,
+      src,
+      true,
+      MatrixFree<dim, number>::DataAccessOnFaces::gradients);
+  }
+
+private:
+  const number penalty = 10.;
+
+  void
+  local_apply_cell(const MatrixFree<dim, number> &              data,
+                   VectorType &                                 dst,
+                   const VectorType &                           src,
+                   const std::pair<unsigned int, unsigned int> &range) const
+  {
+    FEEvaluation<dim, fe_degree, fe_degree + 1, 1, number> phi(data);
+    for (unsigned int cell = range.first; cell < range.second; ++cell)
+      {
+        phi.reinit(cell);
+        phi.gather_evaluate(src, EvaluationFlags::gradients);
+        for (unsigned int q = 0; q < phi.n_q_points; ++q)
+          phi.submit_gradient(phi.get_gradient(q), q);
+        phi.integrate_scatter(EvaluationFlags::gradients, dst);
+      }
+  }
+
+  void
+  local_apply_face(const MatrixFree<dim, number> &              data,
+                   VectorType &                                 dst,
+                   const VectorType &                           src,
+                   const std::pair<unsigned int, unsigned int> &range) const
+  {
+    FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, number> phi_m(data,
+                                                                     true);
+    FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, number> phi_p(data,
+                                                                     false);
+    for (unsigned int face = range.first; face < range.second; ++face)
+      {
+        phi_m.reinit(face);
+        phi_p.reinit(face);
+        phi_m.gather_evaluate(src,
+                              EvaluationFlags::values |
+                                EvaluationFlags::gradients);
+        phi_p.gather_evaluate(src,
+                              EvaluationFlags::values |
+                                EvaluationFlags::gradients);
+        for (unsigned int q = 0; q < phi_m.n_q_points; ++q)
+          {
+            const VectorizedArray<number> jump =
+              phi_m.get_value(q) - phi_p.get_value(q);
+            const VectorizedArray<number> average_normal_derivative =
+              (phi_m.get_normal_derivative(q) +
+               phi_p.get_normal_derivative(q)) *
+              number(0.5);
+            const VectorizedArray<number> test_by_value =
+              jump * penalty - average_normal_derivative;
+            phi_m.submit_value(test_by_value, q);
+            phi_p.submit_value(-test_by_value, q);
+            phi_m.submit_normal_derivative(-jump * number(0.5), q);
+            phi_p.submit_normal_derivative(-jump * number(0.5), q);
+          }
+        phi_m.integrate_scatter(EvaluationFlags::values |
+                                  EvaluationFlags::gradients,
+                                dst);
+        phi_p.integrate_scatter(EvaluationFlags::values |
+                                  EvaluationFlags::gradients,
+                                dst);
+      }
+  }
+
+  void
+  local_apply_boundary(const MatrixFree<dim, number> &              data,
+                       VectorType &                                 dst,
+                       const VectorType &                           src,
+                       const std::pair<unsigned int, unsigned int> &range) const
+  {
+    FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, number> phi_m(data,
+                                                                     true);
+    for (unsigned int face = range.first; face < range.second; ++face)
+      {
+        phi_m.reinit(face);
+        phi_m.gather_evaluate(src,
+                              EvaluationFlags::values |
+                                EvaluationFlags::gradients);
+        for (unsigned int q = 0; q < phi_m.n_q_points; ++q)
+          {
+            // homogeneous Dirichlet condition by the mirror principle, i.e.,
+            // u^+ = -u^- and grad u^+ = grad u^-
+            const VectorizedArray<number> jump = phi_m.get_value(q) * 2.;
+            const VectorizedArray<number> average_normal_derivative =
+              phi_m.get_normal_derivative(q);
+            phi_m.submit_value(jump * penalty - average_normal_derivative, q);
+            phi_m.submit_normal_derivative(-jump * number(0.5), q);
+          }
+        phi_m.integrate_scatter(EvaluationFlags::values |
+                                  EvaluationFlags::gradients,
+                                dst);
+      }
+  }
+
+  void
+  local_apply_cell_centric(
+    const MatrixFree<dim, number> &              data,
+    VectorType &                                 dst,
+    const VectorType &                           src,
+    const std::pair<unsigned int, unsigned int> &range) const
+  {
+    FEEvaluation<dim, fe_degree, fe_degree + 1, 1, number> phi(data);
+    FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, number> phi_m(data,
+                                                                     true);
+    FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, number> phi_p(data,
+                                                                     false);
+    AlignedVector<VectorizedArray<number>> cell_values(phi.dofs_per_cell);
+
+    for (unsigned int cell = range.first; cell < range.second; ++cell)
+      {
+        phi.reinit(cell);
+        phi.gather_evaluate(src, EvaluationFlags::gradients);
+        for (unsigned int q = 0; q < phi.n_q_points; ++q)
+          phi.submit_gradient(phi.get_gradient(q), q);
+        phi.integrate(EvaluationFlags::gradients);
+        for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+          cell_values[i] = phi.begin_dof_values()[i];
+
+        for (const unsigned int face : GeometryInfo<dim>::face_indices())
+          {
+            const auto boundary_ids =
+              data.get_faces_by_cells_boundary_id(cell, face);
+
+            phi_m.reinit(cell, face);
+            phi_p.reinit(cell, face);
+            phi_m.gather_evaluate(src,
+                                  EvaluationFlags::values |
+                                    EvaluationFlags::gradients);
+            phi_p.gather_evaluate(src,
+                                  EvaluationFlags::values |
+                                    EvaluationFlags::gradients);
+
+            for (unsigned int q = 0; q < phi_m.n_q_points; ++q)
+              {
+                VectorizedArray<number> value_p = phi_p.get_value(q);
+                VectorizedArray<number> normal_derivative_p =
+                  phi_p.get_normal_derivative(q);
+
+                // apply the mirror principle on lanes at the boundary
+                for (unsigned int v = 0; v < VectorizedArray<number>::size();
+                     ++v)
+                  if (boundary_ids[v] != numbers::invalid_boundary_id)
+                    {
+                      value_p[v]             = -phi_m.get_value(q)[v];
+                      normal_derivative_p[v] = phi_m.get_normal_derivative(q)[v];
+                    }
+
+                const VectorizedArray<number> jump =
+                  phi_m.get_value(q) - value_p;
+                const VectorizedArray<number> average_normal_derivative =
+                  (phi_m.get_normal_derivative(q) + normal_derivative_p) *
+                  number(0.5);
+                phi_m.submit_value(jump * penalty - average_normal_derivative,
+                                   q);
+                phi_m.submit_normal_derivative(-jump * number(0.5), q);
+              }
+            phi_m.integrate(EvaluationFlags::values |
+                            EvaluationFlags::gradients);
+            for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+              cell_values[i] += phi_m.begin_dof_values()[i];
+          }
+
+        for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+          phi.begin_dof_values()[i] = cell_values[i];
+        phi.set_dof_values(dst);
+      }
+  }
+
+  MatrixFree<dim, number> data;
+};
+
+
+
+template <int dim, int fe_degree, typename number>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria, -1., 1.);
+  tria.refine_global(5 - dim);
+  GridTools::distort_random(0.2, tria, true);
+
+  FE_DGQ<dim>     fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  MappingQGeneric<dim>                   mapping(2);
+  LaplaceOperator<dim, fe_degree, number> laplace(mapping, dof);
+
+  LinearAlgebra::distributed::Vector<number> src, result_face, result_cell;
+  laplace.initialize_dof_vector(src);
+  laplace.initialize_dof_vector(result_face);
+  laplace.initialize_dof_vector(result_cell);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    src.local_element(i) = random_value<number>();
+
+  laplace.vmult_face_centric(result_face, src);
+  laplace.vmult_cell_centric(result_cell, src);
+
+  deallog << "Testing " << dim << "D, degree " << fe_degree << ", "
+          << (std::is_same<number, double>::value ? "double" : "float")
+          << std::endl;
+  result_cell -= result_face;
+  const number tolerance =
+    (std::is_same<number, double>::value ? 1e-12 : 1e-5) *
+    result_face.linfty_norm();
+  deallog << "Difference between face-centric and cell-centric loop: "
+          << (result_cell.linfty_norm() < tolerance ? "OK" : "FAIL")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2, 1, double>();
+  test<2, 3, double>();
+  test<2, 2, float>();
+  test<3, 1, double>();
+  test<3, 2, double>();
+}
@@ -0,0 +1,192 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check FEPointEvaluation against FEValues with a quadrature formula on the
+// same points, for scalar and vector-valued FE_Q elements (evaluated by the
+// tensor product kernels), an FE_DGP element (evaluated via FEValues), and a
+// MappingQGeneric as well as a MappingCartesian (mapping data via FEValues).
+// The integrate() function is checked against sums over FEValues shape
+// functions.
+
+#include <deal.II/base/function_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_dgp.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_cartesian.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/matrix_free/fe_point_evaluation.h>
+
+#include "../tests.h"
+
+
+
+template <int n_components, int dim>
+void
+test(const Mapping<dim> &mapping, const FiniteElement<dim> &fe)
+{
+  using Traits = internal::FEPointEvaluation::
+    EvaluatorTypeTraits<dim, dim, n_components, double>;
+
+  deallog << "Testing " << fe.get_name() << " with " << n_components
+          << " component(s)" << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(1);
+  if (dynamic_cast<const MappingCartesian<dim> *>(&mapping) == nullptr)
+    GridTools::distort_random(0.15, tria, false);
+
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  Vector<double> vector(dof_handler.n_dofs());
+  for (unsigned int i = 0; i < vector.size(); ++i)
+    vector(i) = random_value<double>();
+
+  std::vector<Point<dim>> unit_points;
+  for (unsigned int i = 0; i < 7; ++i)
+    {
+      Point<dim> p;
+      for (unsigned int d = 0; d < dim; ++d)
+        p[d] = random_value<double>();
+      unit_points.push_back(p);
+    }
+
+  FEPointEvaluation<n_components, dim> evaluator(mapping,
+                                                 fe,
+                                                 update_values |
+                                                   update_gradients |
+                                                   update_quadrature_points);
+  FEValues<dim> fe_values(mapping,
+                          fe,
+                          Quadrature<dim>(unit_points),
+                          update_values | update_gradients |
+                            update_quadrature_points);
+
+  std::vector<double> solution_values(fe.dofs_per_cell);
+  std::vector<double> integrated(fe.dofs_per_cell);
+  std::vector<double> reference(fe.dofs_per_cell);
+
+  double max_error_point = 0, max_error_value = 0, max_error_gradient = 0,
+         max_error_integrate = 0;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    {
+      fe_values.reinit(cell);
+      evaluator.reinit(cell, unit_points);
+      cell->get_dof_values(vector,
+                           solution_values.begin(),
+                           solution_values.end());
+      evaluator.evaluate(solution_values,
+                         EvaluationFlags::values | EvaluationFlags::gradients);
+
+      for (unsigned int q = 0; q < unit_points.size(); ++q)
+        {
+          max_error_point =
+            std::max(max_error_point,
+                     evaluator.real_point(q).distance(
+                       fe_values.quadrature_point(q)));
+          for (unsigned int c = 0; c < n_components; ++c)
+            {
+              double         value = 0;
+              Tensor<1, dim> gradient;
+              for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+                {
+                  value += fe_values.shape_value_component(i, q, c) *
+                           solution_values[i];
+                  gradient += fe_values.shape_grad_component(i, q, c) *
+                              solution_values[i];
+                }
+              max_error_value =
+                std::max(max_error_value,
+                         std::abs(Traits::access(evaluator.get_value(q), c) -
+                                  value));
+              for (unsigned int d = 0; d < dim; ++d)
+                max_error_gradient = std::max(
+                  max_error_gradient,
+                  std::abs(Traits::access(evaluator.get_gradient(q), c, d) -
+                           gradient[d]));
+            }
+
+          // test integrate() with the evaluated quantities
+          evaluator.submit_value(evaluator.get_value(q), q);
+          evaluator.submit_gradient(evaluator.get_gradient(q), q);
+        }
+
+      evaluator.integrate(integrated,
+                          EvaluationFlags::values | EvaluationFlags::gradients);
+      for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+        {
+          reference[i] = 0;
+          for (unsigned int q = 0; q < unit_points.size(); ++q)
+            for (unsigned int c = 0; c < n_components; ++c)
+              {
+                reference[i] += fe_values.shape_value_component(i, q, c) *
+                                Traits::access(evaluator.get_value(q), c);
+                for (unsigned int d = 0; d < dim; ++d)
+                  reference[i] +=
+                    fe_values.shape_grad_component(i, q, c)[d] *
+                    Traits::access(evaluator.get_gradient(q), c, d);
+              }
+          max_error_integrate =
+            std::max(max_error_integrate,
+                     std::abs(reference[i] - integrated[i]));
+        }
+    }
+
+  deallog << "Error points:    "
+          << (max_error_point < 1e-12 ? "OK" : "FAIL") << std::endl;
+  deallog << "Error values:    "
+          << (max_error_value < 1e-12 ? "OK" : "FAIL") << std::endl;
+  deallog << "Error gradients: "
+          << (max_error_gradient < 1e-10 ? "OK" : "FAIL") << std::endl;
+  deallog << "Error integrate: "
+          << (max_error_integrate < 1e-10 ? "OK" : "FAIL") << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  {
+    MappingQGeneric<2> mapping(3);
+    test<1>(mapping, FE_Q<2>(1));
+    test<1>(mapping, FE_Q<2>(4));
+    test<1>(mapping, FE_DGP<2>(2));
+    test<2>(mapping, FESystem<2>(FE_Q<2>(2), 2));
+    test<1>(MappingCartesian<2>(), FE_Q<2>(2));
+  }
+  {
+    MappingQGeneric<3> mapping(2);
+    test<1>(mapping, FE_Q<3>(2));
+    test<3>(mapping, FESystem<3>(FE_Q<3>(3), 3));
+    test<1>(MappingCartesian<3>(), FE_DGP<3>(1));
+  }
+}
@@ -0,0 +1,213 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that SolverCG gives the same iterates when the vector updates are
+// merged into the matrix-vector product via the operation_before_loop and
+// operation_after_loop arguments of MatrixFree::cell_loop() as with the
+// basic algorithm, both for the identity and a diagonal preconditioner
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+
+#include "../tests.h"
+
+#include "matrix_vector_mf.h"
+
+
+
+template <int dim, int fe_degree, typename Number>
+class MatrixBasic
+{
+public:
+  using VectorType = LinearAlgebra::distributed::Vector<Number>;
+
+  MatrixBasic(const MatrixFree<dim, Number> &data_in)
+    : data(data_in)
+  {}
+
+  void
+  vmult(VectorType &dst, const VectorType &src) const
+  {
+    const std::function<void(const MatrixFree<dim, Number> &,
+                             VectorType &,
+                             const VectorType &,
+                             const std::pair<unsigned int, unsigned int> &)>
+      wrap = helmholtz_operator<dim, fe_degree, VectorType, fe_degree + 1>;
+    data.cell_loop(wrap, dst, src, true);
+  }
+
+protected:
+  const MatrixFree<dim, Number> &data;
+};
+
+
+
+template <int dim, int fe_degree, typename Number>
+class MatrixFused : public MatrixBasic<dim, fe_degree, Number>
+{
+public:
+  using VectorType = LinearAlgebra::distributed::Vector<Number>;
+
+  MatrixFused(const MatrixFree<dim, Number> &data_in)
+    : MatrixBasic<dim, fe_degree, Number>(data_in)
+  {}
+
+  using MatrixBasic<dim, fe_degree, Number>::vmult;
+
+  void
+  vmult(VectorType &      dst,
+        const VectorType &src,
+        const std::function<void(const unsigned int, const unsigned int)>
+          &operation_before_matrix_vector_product,
+        const std::function<void(const unsigned int, const unsigned int)>
+          &operation_after_matrix_vector_product) const
+  {
+    const std::function<void(const MatrixFree<dim, Number> &,
+                             VectorType &,
+                             const VectorType &,
+                             const std::pair<unsigned int, unsigned int> &)>
+      wrap = helmholtz_operator<dim, fe_degree, VectorType, fe_degree + 1>;
+    this->data.cell_loop(
+      wrap,
+      dst,
+      src,
+      [&](const unsigned int start_range, const unsigned int end_range) {
+        operation_before_matrix_vector_product(start_range, end_range);
+        for (unsigned int i = start_range; i < end_range; ++i)
+          dst.local_element(i) = 0;
+      },
+      operation_after_matrix_vector_product);
+  }
+};
+
+
+
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename PreconditionerType,
+          typename VectorType>
+void
+compare_solvers(const MatrixType1 &       matrix_basic,
+                const MatrixType2 &       matrix_fused,
+                const PreconditionerType &preconditioner,
+                const VectorType &        rhs)
+{
+  using Number = typename VectorType::value_type;
+
+  VectorType sol_basic(rhs), sol_fused(rhs);
+  sol_basic = 0;
+  sol_fused = 0;
+
+  const double tolerance = std::is_same<Number, double>::value ? 1e-10 : 1e-5;
+  SolverControl control_basic(200, tolerance * rhs.l2_norm());
+  SolverControl control_fused(200, tolerance * rhs.l2_norm());
+
+  SolverCG<VectorType> solver_basic(control_basic);
+  solver_basic.solve(matrix_basic, sol_basic, rhs, preconditioner);
+  SolverCG<VectorType> solver_fused(control_fused);
+  solver_fused.solve(matrix_fused, sol_fused, rhs, preconditioner);
+
+  // the iterates only differ by roundoff, so allow for one more or less
+  // iteration until convergence
+  const int iteration_difference = static_cast<int>(control_basic.last_step()) -
+                                   static_cast<int>(control_fused.last_step());
+  deallog << "Number of iterations: "
+          << (std::abs(iteration_difference) <= 1 ? "OK" : "FAIL")
+          << std::endl;
+
+  sol_fused -= sol_basic;
+  deallog << "Difference between solutions: "
+          << (sol_fused.linfty_norm() < 1e4 * tolerance *
+                                          sol_basic.linfty_norm() ?
+                "OK" :
+                "FAIL")
+          << std::endl;
+}
+
+
+
+template <int dim, int fe_degree, typename Number>
+void
+test()
+{
+  using VectorType = LinearAlgebra::distributed::Vector<Number>;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(6 - dim);
+  GridTools::distort_random(0.2, tria, true);
+
+  FE_Q<dim>       fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  deallog << "Testing " << dim << "D, " << fe.get_name() << ", "
+          << (std::is_same<Number, double>::value ? "double" : "float")
+          << std::endl;
+
+  MatrixFree<dim, Number> mf_data;
+  {
+    typename MatrixFree<dim, Number>::AdditionalData data;
+    data.tasks_parallel_scheme = MatrixFree<dim, Number>::AdditionalData::none;
+    mf_data.reinit(dof, constraints, QGauss<1>(fe_degree + 1), data);
+  }
+
+  const MatrixBasic<dim, fe_degree, Number> matrix_basic(mf_data);
+  const MatrixFused<dim, fe_degree, Number> matrix_fused(mf_data);
+
+  VectorType rhs;
+  mf_data.initialize_dof_vector(rhs);
+  for (unsigned int i = 0; i < rhs.local_size(); ++i)
+    rhs.local_element(i) = random_value<Number>();
+
+  compare_solvers(matrix_basic, matrix_fused, PreconditionIdentity(), rhs);
+
+  // a diagonal preconditioner with entries of varying size
+  DiagonalMatrix<VectorType> preconditioner;
+  mf_data.initialize_dof_vector(preconditioner.get_vector());
+  for (unsigned int i = 0; i < rhs.local_size(); ++i)
+    preconditioner.get_vector().local_element(i) = 1. + 0.2 * (i % 5);
+  compare_solvers(matrix_basic, matrix_fused, preconditioner, rhs);
+}
+
+
+
+int
+main()
+{
+  initlog();
+  deallog.depth_file(1);
+
+  test<2, 1, double>();
+  test<2, 3, double>();
+  test<2, 2, float>();
+  test<3, 2, double>();
+}
@@ -0,0 +1,85 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check AlignedVector::replicate_across_communicator() for all possible
+// root processes, including the subsequent reallocation of the vector in
+// local memory
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/point.h>
+
+#include "../tests.h"
+
+
+void
+test(const unsigned int root)
+{
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+
+  AlignedVector<Point<2>> vector;
+  if (my_rank == root)
+    {
+      vector.resize(5);
+      for (unsigned int i = 0; i < vector.size(); ++i)
+        vector[i] = Point<2>(i, root);
+    }
+  else
+    vector.resize(2);
+
+  vector.replicate_across_communicator(MPI_COMM_WORLD, root);
+
+  // check the content on all processes
+  unsigned int n_errors = vector.size() != 5;
+  for (unsigned int i = 0; i < vector.size(); ++i)
+    if (vector[i] != Point<2>(i, root))
+      ++n_errors;
+
+  // a copy lives in local memory and can be modified
+  AlignedVector<Point<2>> copy(vector);
+  copy[0] = Point<2>(-1, -1);
+  if (vector[0] != Point<2>(0, root))
+    ++n_errors;
+
+  // growing the vector moves the data to local memory
+  vector.resize(7);
+  for (unsigned int i = 0; i < 5; ++i)
+    if (vector[i] != Point<2>(i, root))
+      ++n_errors;
+
+  n_errors = Utilities::MPI::sum(n_errors, MPI_COMM_WORLD);
+  deallog << "Root " << root << ": " << (n_errors == 0 ? "ok" : "fail")
+          << std::endl;
+}
+
+
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  MPILogInitAll                    log;
+
+  for (unsigned int root = 0;
+       root < Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+       ++root)
+    test(root);
+
+  AlignedVector<double> empty;
+  empty.replicate_across_communicator(MPI_COMM_WORLD, 0);
+  deallog << "Size of empty vector: " << empty.size() << std::endl;
+}
@@ -0,0 +1,117 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that modifying a vector after
+// AlignedVector::replicate_across_communicator(), by copy assignment of a
+// smaller or larger vector or by resizing it to a smaller size, moves the
+// data to memory owned by each process, so that the processes do not write
+// into the memory shared within the node
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/point.h>
+
+#include "../tests.h"
+
+
+AlignedVector<Point<2>>
+create_replicated_vector()
+{
+  AlignedVector<Point<2>> vector;
+  if (Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
+    {
+      vector.resize(5);
+      for (unsigned int i = 0; i < vector.size(); ++i)
+        vector[i] = Point<2>(i, 0);
+    }
+  vector.replicate_across_communicator(MPI_COMM_WORLD, 0);
+  return vector;
+}
+
+
+
+// fill the vector with values unique to this process, wait until all
+// processes have done so, and check that no other process has overwritten
+// the values
+void
+check_local_values(AlignedVector<Point<2>> &vector, const std::string &name)
+{
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+
+  for (unsigned int i = 0; i < vector.size(); ++i)
+    vector[i] = Point<2>(i, my_rank + 1);
+
+  const int ierr = MPI_Barrier(MPI_COMM_WORLD);
+  AssertThrowMPI(ierr);
+
+  unsigned int n_errors = 0;
+  for (unsigned int i = 0; i < vector.size(); ++i)
+    if (vector[i] != Point<2>(i, my_rank + 1))
+      ++n_errors;
+
+  n_errors = Utilities::MPI::sum(n_errors, MPI_COMM_WORLD);
+  deallog << name << ": size " << vector.size() << ", "
+          << (n_errors == 0 ? "ok" : "fail") << std::endl;
+}
+
+
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  MPILogInitAll                    log;
+
+  {
+    AlignedVector<Point<2>>       vector = create_replicated_vector();
+    const AlignedVector<Point<2>> other(3);
+    vector = other;
+    check_local_values(vector, "Copy assignment of smaller vector");
+  }
+
+  {
+    AlignedVector<Point<2>>       vector = create_replicated_vector();
+    const AlignedVector<Point<2>> other(8);
+    vector = other;
+    check_local_values(vector, "Copy assignment of larger vector");
+  }
+
+  {
+    AlignedVector<Point<2>>       vector = create_replicated_vector();
+    const AlignedVector<Point<2>> other(5);
+    vector = other;
+    check_local_values(vector, "Copy assignment of vector of same size");
+  }
+
+  {
+    AlignedVector<Point<2>> vector = create_replicated_vector();
+    vector.resize_fast(3);
+    check_local_values(vector, "resize_fast() to smaller size");
+  }
+
+  {
+    AlignedVector<Point<2>> vector = create_replicated_vector();
+    vector.resize(4);
+    check_local_values(vector, "resize() to smaller size");
+  }
+
+  {
+    AlignedVector<Point<2>> vector = create_replicated_vector();
+    vector.reserve(2);
+    check_local_values(vector, "reserve() of smaller size");
+  }
+}
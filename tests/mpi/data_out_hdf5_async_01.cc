@@ -0,0 +1,51 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that DataOutBase::AsynchronousHDF5Writer only writes in a background
+// thread if MPI provides MPI_THREAD_MULTIPLE, also on a single process,
+// since the parallel HDF5 functions communicate in any case. With
+// Utilities::MPI::MPI_InitFinalize, which only requests
+// MPI_THREAD_SERIALIZED, the snapshots are written in the calling thread.
+// The test does not write any files, so that it also runs without HDF5.
+
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/base/mpi.h>
+
+#include "../tests.h"
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  MPILogInitAll log;
+
+  int       provided = MPI_THREAD_SINGLE;
+  const int ierr     = MPI_Query_thread(&provided);
+  AssertThrowMPI(ierr);
+
+  DataOutBase::AsynchronousHDF5Writer<2> writer(MPI_COMM_WORLD);
+  deallog << "Writes asynchronously only with MPI_THREAD_MULTIPLE: "
+          << (writer.writes_asynchronously() ==
+                  (provided == MPI_THREAD_MULTIPLE) ?
+                "OK" :
+                "wrong")
+          << std::endl;
+  deallog << "Pending snapshots: " << writer.n_pending_snapshots()
+          << std::endl;
+}
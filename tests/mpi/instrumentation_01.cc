@@ -0,0 +1,123 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that Instrumentation::get_statistics() combines the regions of all
+// processes, also if some of them were only entered on some processes, and
+// that the trace written by Instrumentation::write_chrome_trace() contains
+// the events of all processes
+
+#include <deal.II/base/instrumentation.h>
+#include <deal.II/base/mpi.h>
+
+#include "../tests.h"
+
+
+void
+work()
+{
+  static const Instrumentation::Region region("work");
+  Instrumentation::Scope               scope(region);
+
+  // make sure the region takes a measurable amount of time
+  const auto start = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - start <
+         std::chrono::microseconds(10))
+    ;
+}
+
+
+
+void
+test()
+{
+  const unsigned int my_id = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int n_procs =
+    Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+
+  Instrumentation::enable(/*record_trace = */ true);
+
+  // process p calls the region p+1 times, and only process 1 calls it from
+  // within another region
+  for (unsigned int i = 0; i <= my_id; ++i)
+    work();
+  if (my_id == 1)
+    {
+      static const Instrumentation::Region region("outer");
+      Instrumentation::Scope               scope(region);
+      work();
+    }
+
+  for (const Instrumentation::RegionStatistics &entry :
+       Instrumentation::get_statistics(MPI_COMM_WORLD))
+    {
+      std::string path;
+      for (const std::string &name : entry.path)
+        path += (path.empty() ? "" : "/") + name;
+
+      // the regions of process 1 are the only ones entered on a single
+      // process, so their imbalance is the number of processes
+      const bool only_on_process_1 = (path != "work");
+      const bool valid =
+        entry.total_time.max > 0 &&
+        (only_on_process_1 ?
+           (entry.total_time.min == 0. && entry.total_time.max_index == 1 &&
+            std::abs(entry.imbalance() - n_procs) < 1e-12) :
+           (entry.total_time.min > 0. && entry.imbalance() >= 1.));
+
+      deallog << path << ": " << entry.n_calls << " calls, "
+              << (valid ? "OK" : "invalid statistics") << std::endl;
+    }
+
+  std::ostringstream trace;
+  Instrumentation::write_chrome_trace(trace, MPI_COMM_WORLD);
+  if (my_id == 0)
+    {
+      const std::string trace_string = trace.str();
+      unsigned int      n_events     = 0;
+      for (std::size_t p = trace_string.find("\"ph\":\"X\"");
+           p != std::string::npos;
+           p = trace_string.find("\"ph\":\"X\"", p + 1))
+        ++n_events;
+      deallog << "Trace: " << n_events << " events" << std::endl;
+      for (unsigned int p = 0; p < n_procs; ++p)
+        deallog << "Process " << p << ": "
+                << (trace_string.find("\"name\":\"MPI process " +
+                                      std::to_string(p) + "\"") !=
+                        std::string::npos ?
+                      "OK" :
+                      "missing")
+                << std::endl;
+    }
+  else
+    AssertThrow(trace.str().empty(), ExcInternalError());
+}
+
+
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  if (Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
+    {
+      initlog();
+      test();
+    }
+  else
+    test();
+}
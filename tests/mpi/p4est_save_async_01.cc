@@ -0,0 +1,161 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// write two checkpoints with fixed and variable size data attached using
+// parallel::distributed::Triangulation::save_async(), where the second one
+// is packed while the first one may still be written, and check that both
+// can be read with load()
+
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+using CellIterator =
+  typename parallel::distributed::Triangulation<dim>::cell_iterator;
+
+template <int dim>
+using CellStatus =
+  typename parallel::distributed::Triangulation<dim>::CellStatus;
+
+
+
+template <int dim>
+std::vector<char>
+pack_center(const CellIterator<dim> &cell, const CellStatus<dim>)
+{
+  return Utilities::pack(cell->center(), /*allow_compression=*/false);
+}
+
+
+
+template <int dim>
+std::vector<char>
+pack_id(const CellIterator<dim> &cell, const CellStatus<dim>)
+{
+  return Utilities::pack(cell->id().to_string(),
+                         /*allow_compression=*/false);
+}
+
+
+
+template <int dim>
+std::array<unsigned int, 2>
+register_data(parallel::distributed::Triangulation<dim> &tria)
+{
+  return {{tria.register_data_attach(pack_center<dim>, false),
+           tria.register_data_attach(pack_id<dim>, true)}};
+}
+
+
+
+template <int dim>
+void
+check_checkpoint(const std::string &filename)
+{
+  parallel::distributed::Triangulation<dim> tria(MPI_COMM_WORLD);
+  GridGenerator::subdivided_hyper_cube(tria, 2);
+  tria.load(filename);
+
+  const std::array<unsigned int, 2> handles = register_data(tria);
+
+  unsigned int n_errors = 0;
+  tria.notify_ready_to_unpack(
+    handles[0],
+    [&](const CellIterator<dim> &cell,
+        const CellStatus<dim>,
+        const boost::iterator_range<std::vector<char>::const_iterator>
+          &data_range) {
+      const Point<dim> center =
+        Utilities::unpack<Point<dim>>(data_range.begin(),
+                                      data_range.end(),
+                                      /*allow_compression=*/false);
+      if (center.distance(cell->center()) > 1e-12)
+        ++n_errors;
+    });
+  tria.notify_ready_to_unpack(
+    handles[1],
+    [&](const CellIterator<dim> &cell,
+        const CellStatus<dim>,
+        const boost::iterator_range<std::vector<char>::const_iterator>
+          &data_range) {
+      const std::string id =
+        Utilities::unpack<std::string>(data_range.begin(),
+                                       data_range.end(),
+                                       /*allow_compression=*/false);
+      if (id != cell->id().to_string())
+        ++n_errors;
+    });
+
+  n_errors = Utilities::MPI::sum(n_errors, MPI_COMM_WORLD);
+  deallog << filename << ": " << tria.n_global_active_cells() << " cells, "
+          << (n_errors == 0 ? "OK" : "failed") << std::endl;
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  {
+    parallel::distributed::Triangulation<dim> tria(MPI_COMM_WORLD);
+    GridGenerator::subdivided_hyper_cube(tria, 2);
+    tria.refine_global(2);
+
+    register_data(tria);
+    Threads::Task<> first_checkpoint = tria.save_async("checkpoint_1");
+
+    tria.refine_global(1);
+    register_data(tria);
+    Threads::Task<> second_checkpoint = tria.save_async("checkpoint_2");
+
+    first_checkpoint.join();
+    second_checkpoint.join();
+  }
+
+  // make sure all processes have finished writing
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  check_checkpoint<dim>("checkpoint_1");
+  check_checkpoint<dim>("checkpoint_2");
+}
+
+
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, testing_max_num_threads());
+  MPILogInitAll log;
+
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+
+  deallog.push("3d");
+  test<3>();
+  deallog.pop();
+}
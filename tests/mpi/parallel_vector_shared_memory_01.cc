@@ -0,0 +1,171 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// check LA::distributed::Vector in the shared-memory mode: the ghost
+// exchange in update_ghost_values() and compress() must give the same
+// results as for a vector using MPI messages only. The shared-memory
+// communicator is either the full node or pairs of processes, in which
+// case part of the ghost entries is still exchanged through MPI
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include "../tests.h"
+
+
+void
+test(const MPI_Comm &comm_sm)
+{
+  const unsigned int myid    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+  const unsigned int n_local = 5;
+
+  // each process owns five entries and has the second and the last entry of
+  // all other processes as ghosts, plus the first entry of the next process
+  IndexSet locally_owned(numproc * n_local);
+  locally_owned.add_range(myid * n_local, (myid + 1) * n_local);
+  IndexSet ghosts(numproc * n_local);
+  for (unsigned int p = 0; p < numproc; ++p)
+    if (p != myid)
+      {
+        ghosts.add_index(p * n_local + 1);
+        ghosts.add_index(p * n_local + n_local - 1);
+      }
+  ghosts.add_index(((myid + 1) % numproc) * n_local);
+  ghosts.subtract_set(locally_owned);
+
+  const auto partitioner =
+    std::make_shared<Utilities::MPI::Partitioner>(locally_owned,
+                                                  ghosts,
+                                                  MPI_COMM_WORLD);
+
+  LinearAlgebra::distributed::Vector<double> reference(partitioner);
+  LinearAlgebra::distributed::Vector<double> v;
+  v.reinit(partitioner, comm_sm);
+  deallog << "Number of arrays in shared memory: "
+          << v.shared_memory_data().size() << std::endl;
+
+  // vectors initialized from v share its memory layout
+  LinearAlgebra::distributed::Vector<double> w;
+  w.reinit(v);
+  deallog << "Shared memory in copy: " << w.shared_memory_data().size()
+          << std::endl;
+
+  const auto check = [&](const std::string &name) {
+    bool ok = true;
+    for (unsigned int i = 0; i < reference.local_size() + ghosts.n_elements();
+         ++i)
+      if (v.local_element(i) != reference.local_element(i))
+        ok = false;
+    deallog << name << ": " << (ok ? "OK" : "failed") << std::endl;
+  };
+
+  // update_ghost_values
+  for (const auto i : locally_owned)
+    {
+      v(i)         = i + 1.;
+      reference(i) = i + 1.;
+    }
+  v.update_ghost_values();
+  reference.update_ghost_values();
+  deallog << "Ghost values:";
+  for (const auto i : ghosts)
+    deallog << ' ' << v(i);
+  deallog << std::endl;
+  check("update_ghost_values");
+
+  // compress with add
+  v.zero_out_ghosts();
+  reference.zero_out_ghosts();
+  for (const auto i : ghosts)
+    {
+      v(i) += myid + 1.;
+      reference(i) += myid + 1.;
+    }
+  v.compress(VectorOperation::add);
+  reference.compress(VectorOperation::add);
+  deallog << "Owned values after add:";
+  for (const auto i : locally_owned)
+    deallog << ' ' << v(i);
+  deallog << std::endl;
+  check("compress add");
+
+  // compress with max
+  for (const auto i : ghosts)
+    {
+      v(i)         = 10. * (myid + 1.);
+      reference(i) = 10. * (myid + 1.);
+    }
+  v.compress(VectorOperation::max);
+  reference.compress(VectorOperation::max);
+  check("compress max");
+
+  // the split functions and ghost exchanges of a vector sharing the layout
+  w = v;
+  w *= 2.;
+  w.update_ghost_values_start();
+  w.update_ghost_values_finish();
+  reference *= 2.;
+  reference.update_ghost_values();
+  bool ok = true;
+  for (const auto i : ghosts)
+    if (w(i) != reference(i))
+      ok = false;
+  deallog << "copied vector: " << (ok ? "OK" : "failed") << std::endl;
+
+  // read the first entry of the other processes of the node in place
+  const unsigned int sm_rank = Utilities::MPI::this_mpi_process(comm_sm);
+  deallog << "First entries of processes in shared memory:";
+  for (unsigned int p = 0; p < v.shared_memory_data().size(); ++p)
+    deallog << ' ' << (p == sm_rank ? "*" : "")
+            << v.shared_memory_data()[p][0];
+  deallog << std::endl;
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  MPILogInitAll log;
+
+#if DEAL_II_MPI_VERSION_GTE(3, 0)
+  {
+    deallog.push("node");
+    MPI_Comm comm_sm;
+    MPI_Comm_split_type(
+      MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &comm_sm);
+    test(comm_sm);
+    MPI_Comm_free(&comm_sm);
+    deallog.pop();
+  }
+  {
+    deallog.push("pairs");
+    MPI_Comm comm_sm;
+    MPI_Comm_split(MPI_COMM_WORLD,
+                   Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) / 2,
+                   0,
+                   &comm_sm);
+    test(comm_sm);
+    MPI_Comm_free(&comm_sm);
+    deallog.pop();
+  }
+#endif
+}
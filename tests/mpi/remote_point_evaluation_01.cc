@@ -0,0 +1,198 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Test Utilities::MPI::RemotePointEvaluation and VectorTools::point_values()
+// on a distributed mesh: every process asks for a different set of points,
+// including a point on a vertex shared by several cells and a point outside
+// of the domain, and the values are compared against the interpolated
+// function. The communication pattern is reused for a second vector, and the
+// inverse operation process_and_evaluate() is checked by sending values
+// back to the cells.
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/mpi_remote_point_evaluation.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools_cache.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/numerics/vector_tools.h>
+#include <deal.II/numerics/vector_tools_evaluate.h>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+class MyFunction : public Function<dim>
+{
+public:
+  virtual double
+  value(const Point<dim> &p, const unsigned int) const override
+  {
+    return p[0] + 2. * p[1] * p[1] - (dim == 3 ? p[2] * p[0] : 0.);
+  }
+};
+
+
+
+template <int dim>
+void
+test()
+{
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+
+  parallel::distributed::Triangulation<dim> tria(MPI_COMM_WORLD);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(6 - dim);
+
+  MappingQGeneric<dim> mapping(2);
+  FE_Q<dim>            fe(2);
+  DoFHandler<dim>      dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  IndexSet locally_relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs(dof_handler, locally_relevant_dofs);
+  LinearAlgebra::distributed::Vector<double> vector(
+    dof_handler.locally_owned_dofs(), locally_relevant_dofs, MPI_COMM_WORLD);
+  VectorTools::interpolate(mapping, dof_handler, MyFunction<dim>(), vector);
+  vector.update_ghost_values();
+
+  // each process asks for different points, with the random numbers of the
+  // lower ranks skipped
+  for (unsigned int i = 0; i < my_rank * 10 * dim; ++i)
+    random_value<double>();
+  std::vector<Point<dim>> points;
+  for (unsigned int i = 0; i < 10; ++i)
+    {
+      Point<dim> p;
+      for (unsigned int d = 0; d < dim; ++d)
+        p[d] = random_value<double>();
+      points.push_back(p);
+    }
+  const unsigned int vertex_point = points.size();
+  Point<dim>         p_vertex;
+  for (unsigned int d = 0; d < dim; ++d)
+    p_vertex[d] = 0.5;
+  points.push_back(p_vertex);
+  points.push_back(Point<dim>::unit_vector(0) * 2.);
+
+  deallog << "Testing " << dim << "D with " << points.size() << " points"
+          << std::endl;
+
+  GridTools::Cache<dim>                      cache(tria, mapping);
+  Utilities::MPI::RemotePointEvaluation<dim> evaluator;
+  evaluator.reinit(points, cache);
+
+  const auto & point_ptrs  = evaluator.get_point_ptrs();
+  unsigned int n_not_found = 0;
+  for (unsigned int i = 0; i < points.size(); ++i)
+    if (point_ptrs[i + 1] == point_ptrs[i])
+      ++n_not_found;
+  deallog << "Points not found: " << n_not_found << std::endl;
+  deallog << "Cells around vertex point: "
+          << point_ptrs[vertex_point + 1] - point_ptrs[vertex_point]
+          << std::endl;
+  deallog << "Unique map: " << evaluator.is_map_unique() << std::endl;
+
+  // evaluate the solution twice with the same communication pattern
+  for (unsigned int run = 0; run < 2; ++run)
+    {
+      if (run == 1)
+        {
+          vector *= 2.;
+          vector.update_ghost_values();
+        }
+
+      const std::vector<double> values =
+        VectorTools::point_values<1>(evaluator, dof_handler, vector);
+
+      double max_error = 0;
+      for (unsigned int i = 0; i < points.size(); ++i)
+        if (point_ptrs[i + 1] > point_ptrs[i])
+          max_error =
+            std::max(max_error,
+                     std::abs(values[i] - (run + 1.) *
+                                            MyFunction<dim>().value(points[i],
+                                                                    0)));
+      deallog << "Error point_values run " << run << ": "
+              << (max_error < 1e-10 ? "OK" : "FAIL") << std::endl;
+    }
+
+  // send the point index back to the cells and check on the cells that the
+  // index refers to a point inside the cell, and that all values arrive
+  std::vector<double> input(point_ptrs.back());
+  for (unsigned int i = 0; i < points.size(); ++i)
+    for (unsigned int j = point_ptrs[i]; j < point_ptrs[i + 1]; ++j)
+      input[j] = points[i][0];
+
+  unsigned int        n_received = 0;
+  double              max_error  = 0;
+  std::vector<double> buffer;
+  evaluator.template process_and_evaluate<double>(
+    input,
+    buffer,
+    [&](const ArrayView<const double> &values,
+        const typename Utilities::MPI::RemotePointEvaluation<dim>::CellData
+          &cell_data) {
+      for (unsigned int c = 0; c < cell_data.cells.size(); ++c)
+        {
+          const typename Triangulation<dim>::active_cell_iterator cell(
+            &tria, cell_data.cells[c].first, cell_data.cells[c].second);
+          for (unsigned int q = cell_data.reference_point_ptrs[c];
+               q < cell_data.reference_point_ptrs[c + 1];
+               ++q)
+            {
+              const Point<dim> p = mapping.transform_unit_to_real_cell(
+                cell, cell_data.reference_point_values[q]);
+              max_error = std::max(max_error, std::abs(p[0] - values[q]));
+              ++n_received;
+            }
+        }
+    });
+
+  const unsigned int n_sent =
+    Utilities::MPI::sum(point_ptrs.back(), MPI_COMM_WORLD);
+  n_received = Utilities::MPI::sum(n_received, MPI_COMM_WORLD);
+  deallog << "Error process_and_evaluate: "
+          << (max_error < 1e-10 && n_sent == n_received ? "OK" : "FAIL")
+          << std::endl;
+
+  tria.refine_global(1);
+  deallog << "Ready after refinement: " << evaluator.is_ready() << std::endl;
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  MPILogInitAll                    log;
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,199 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// check SolverPipelinedCG and SolverSStepCG with
+// LinearAlgebra::distributed::Vector in parallel, where the inner products
+// are summed up by non-blocking reductions, against SolverCG for a
+// one-dimensional Laplacian with variable coefficient
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_pipelined_cg.h>
+#include <deal.II/lac/solver_s_step_cg.h>
+
+#include "../tests.h"
+
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+
+// the matrix of the finite difference discretization of -(a u')' = f with
+// a = 1 + x and zero boundary values, with the first and last neighbor
+// entry of each process as ghost entries
+class LaplaceOperator
+{
+public:
+  LaplaceOperator(const types::global_dof_index n)
+    : n(n)
+  {}
+
+  double
+  coefficient(const types::global_dof_index i) const
+  {
+    return 1. + static_cast<double>(i) / n;
+  }
+
+  void
+  vmult(VectorType &dst, const VectorType &src) const
+  {
+    src.update_ghost_values();
+    const auto range = src.get_partitioner()->local_range();
+    for (types::global_dof_index i = range.first; i < range.second; ++i)
+      {
+        double value = (coefficient(i) + coefficient(i + 1)) * src(i);
+        if (i > 0)
+          value -= coefficient(i) * src(i - 1);
+        if (i + 1 < n)
+          value -= coefficient(i + 1) * src(i + 1);
+        dst(i) = value;
+      }
+    src.zero_out_ghosts();
+  }
+
+  double
+  diagonal(const types::global_dof_index i) const
+  {
+    return coefficient(i) + coefficient(i + 1);
+  }
+
+private:
+  const types::global_dof_index n;
+};
+
+
+
+template <typename SolverType, typename PreconditionerType>
+void
+check_solve(const std::string &       name,
+            SolverType &              solver,
+            const SolverControl &     control,
+            const LaplaceOperator &   A,
+            const VectorType &        reference,
+            const PreconditionerType &preconditioner)
+{
+  VectorType u, f;
+  u.reinit(reference);
+  f.reinit(reference);
+  f = 1.;
+  try
+    {
+      solver.solve(A, u, f, preconditioner);
+    }
+  catch (SolverControl::NoConvergence &e)
+    {
+      deallog << "Exception: " << e.get_exc_name() << std::endl;
+    }
+  u -= reference;
+  deallog << name << " iterations: " << control.last_step()
+          << ", difference to CG solution: "
+          << (u.l2_norm() < 1e-5 * reference.l2_norm() ? "ok" : "too large")
+          << std::endl;
+}
+
+
+
+template <typename PreconditionerType>
+void
+check(const LaplaceOperator &                                   A,
+      const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+      const PreconditionerType &                                preconditioner)
+{
+  // the pipelined method can not reach much tighter tolerances for this
+  // problem due to the propagation of roundoff errors in its recurrences
+  SolverControl control(1000, 1e-8, false, false);
+
+  VectorType reference(partitioner), f(partitioner);
+  f = 1.;
+  {
+    SolverCG<VectorType> solver(control);
+    solver.solve(A, reference, f, preconditioner);
+    deallog << "CG iterations: " << control.last_step() << std::endl;
+  }
+
+  {
+    SolverPipelinedCG<VectorType> solver(control);
+    check_solve("Pipelined CG", solver, control, A, reference, preconditioner);
+  }
+
+  for (unsigned int s = 2; s < 6; s += 3)
+    {
+      SolverSStepCG<VectorType> solver(
+        control, SolverSStepCG<VectorType>::AdditionalData(s));
+      check_solve("s-step CG with s=" + std::to_string(s),
+                  solver,
+                  control,
+                  A,
+                  reference,
+                  preconditioner);
+    }
+}
+
+
+
+void
+test()
+{
+  const unsigned int myid    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+
+  const unsigned int            n_local = 25;
+  const types::global_dof_index n       = numproc * n_local;
+
+  IndexSet locally_owned(n);
+  locally_owned.add_range(myid * n_local, (myid + 1) * n_local);
+  IndexSet ghosts(n);
+  if (myid > 0)
+    ghosts.add_index(myid * n_local - 1);
+  if (myid + 1 < numproc)
+    ghosts.add_index((myid + 1) * n_local);
+
+  const auto partitioner =
+    std::make_shared<Utilities::MPI::Partitioner>(locally_owned,
+                                                  ghosts,
+                                                  MPI_COMM_WORLD);
+
+  const LaplaceOperator A(n);
+
+  deallog.push("no");
+  check(A, partitioner, PreconditionIdentity());
+  deallog.pop();
+
+  deallog.push("jacobi");
+  DiagonalMatrix<VectorType> jacobi;
+  jacobi.get_vector().reinit(partitioner);
+  for (const auto i : locally_owned)
+    jacobi.get_vector()(i) = 1. / A.diagonal(i);
+  check(A, partitioner, jacobi);
+  deallog.pop();
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  MPILogInitAll log;
+
+  test();
+}
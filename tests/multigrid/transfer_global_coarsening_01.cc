@@ -0,0 +1,288 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Check MGTwoLevelTransfer for polynomial and geometric global coarsening:
+// prolongation and interpolation must reproduce linear functions exactly and
+// restriction must be the transpose of prolongation, also in the presence
+// of constraints. Finally, run MGTransferGlobalCoarsening on a hybrid
+// hierarchy.
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+class LinearFunction : public Function<dim>
+{
+public:
+  LinearFunction(const unsigned int n_components)
+    : Function<dim>(n_components)
+  {}
+
+  virtual double
+  value(const Point<dim> &p, const unsigned int component) const override
+  {
+    double result = 1. + component;
+    for (unsigned int d = 0; d < dim; ++d)
+      result += (d + 1.) * p[d];
+    return result;
+  }
+};
+
+
+
+double
+filter(const double value)
+{
+  return std::abs(value) < 1e-12 ? 0. : value;
+}
+
+
+
+template <int dim>
+void
+check(const DoFHandler<dim> &dof_handler_fine,
+      const DoFHandler<dim> &dof_handler_coarse,
+      const bool             geometric)
+{
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+  deallog << (geometric ? "geometric: " : "polynomial: ")
+          << dof_handler_fine.get_fe().get_name() << " <-> "
+          << dof_handler_coarse.get_fe().get_name() << std::endl;
+
+  const LinearFunction<dim> function(dof_handler_fine.get_fe().n_components());
+
+  // transfer without constraints
+  {
+    MGTwoLevelTransfer<dim, VectorType> transfer;
+    if (geometric)
+      transfer.reinit_geometric_transfer(dof_handler_fine, dof_handler_coarse);
+    else
+      transfer.reinit_polynomial_transfer(dof_handler_fine,
+                                          dof_handler_coarse);
+
+    VectorType fine_ref(transfer.get_partitioner_fine()->locally_owned_range(),
+                        MPI_COMM_WORLD);
+    VectorType coarse_ref(
+      transfer.get_partitioner_coarse()->locally_owned_range(),
+      MPI_COMM_WORLD);
+    VectorTools::interpolate(dof_handler_fine, function, fine_ref);
+    VectorTools::interpolate(dof_handler_coarse, function, coarse_ref);
+
+    VectorType fine(fine_ref), coarse(coarse_ref);
+
+    transfer.prolongate(fine, coarse_ref);
+    fine -= fine_ref;
+    deallog << "Prolongation error:  " << filter(fine.linfty_norm())
+            << std::endl;
+
+    transfer.interpolate(coarse, fine_ref);
+    coarse -= coarse_ref;
+    deallog << "Interpolation error: " << filter(coarse.linfty_norm())
+            << std::endl;
+  }
+
+  // restriction is the transpose of prolongation when constraints are
+  // present
+  {
+    AffineConstraints<double> constraint_fine, constraint_coarse;
+    DoFTools::make_zero_boundary_constraints(dof_handler_fine,
+                                             constraint_fine);
+    DoFTools::make_zero_boundary_constraints(dof_handler_coarse,
+                                             constraint_coarse);
+    constraint_fine.close();
+    constraint_coarse.close();
+
+    MGTwoLevelTransfer<dim, VectorType> transfer;
+    if (geometric)
+      transfer.reinit_geometric_transfer(dof_handler_fine,
+                                         dof_handler_coarse,
+                                         constraint_fine,
+                                         constraint_coarse);
+    else
+      transfer.reinit_polynomial_transfer(dof_handler_fine,
+                                          dof_handler_coarse,
+                                          constraint_fine,
+                                          constraint_coarse);
+
+    VectorType fine(transfer.get_partitioner_fine()->locally_owned_range(),
+                    MPI_COMM_WORLD);
+    VectorType coarse(transfer.get_partitioner_coarse()->locally_owned_range(),
+                      MPI_COMM_WORLD);
+    VectorType fine_random(fine), coarse_random(coarse);
+    for (unsigned int i = 0; i < fine.local_size(); ++i)
+      fine_random.local_element(i) = random_value<double>();
+    for (unsigned int i = 0; i < coarse.local_size(); ++i)
+      coarse_random.local_element(i) = random_value<double>();
+
+    transfer.prolongate(fine, coarse_random);
+    transfer.restrict_and_add(coarse, fine_random);
+
+    deallog << "Adjoint error:       "
+            << filter((fine * fine_random - coarse * coarse_random) /
+                      (fine * fine_random))
+            << std::endl;
+  }
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  deallog.push(std::to_string(dim) + "d");
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+
+  const auto trias =
+    MGTransferGlobalCoarseningTools::create_geometric_coarsening_sequence(
+      tria);
+  deallog << "Active cells per level:";
+  for (const auto &t : trias)
+    deallog << ' ' << t->n_active_cells();
+  deallog << std::endl;
+
+  // polynomial transfer with continuous and discontinuous elements
+  {
+    DoFHandler<dim> dof_handler_fine(tria), dof_handler_coarse(tria);
+    dof_handler_fine.distribute_dofs(FE_Q<dim>(3));
+    dof_handler_coarse.distribute_dofs(FE_Q<dim>(1));
+    check(dof_handler_fine, dof_handler_coarse, false);
+
+    dof_handler_fine.distribute_dofs(FE_DGQ<dim>(2));
+    dof_handler_coarse.distribute_dofs(FE_DGQ<dim>(1));
+    check(dof_handler_fine, dof_handler_coarse, false);
+  }
+
+  // geometric transfer with continuous, discontinuous, and vector-valued
+  // elements
+  {
+    DoFHandler<dim> dof_handler_fine(*trias[2]), dof_handler_coarse(*trias[1]);
+    dof_handler_fine.distribute_dofs(FE_Q<dim>(2));
+    dof_handler_coarse.distribute_dofs(FE_Q<dim>(2));
+    check(dof_handler_fine, dof_handler_coarse, true);
+
+    dof_handler_fine.distribute_dofs(FE_DGQ<dim>(1));
+    dof_handler_coarse.distribute_dofs(FE_DGQ<dim>(1));
+    check(dof_handler_fine, dof_handler_coarse, true);
+
+    dof_handler_fine.distribute_dofs(FESystem<dim>(FE_Q<dim>(1), 2));
+    dof_handler_coarse.distribute_dofs(FESystem<dim>(FE_Q<dim>(1), 2));
+    check(dof_handler_fine, dof_handler_coarse, true);
+  }
+
+  // hybrid hierarchy: first coarsen the degree, then the mesh
+  {
+    using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+    std::vector<std::unique_ptr<DoFHandler<dim>>> dof_handlers;
+    dof_handlers.emplace_back(new DoFHandler<dim>(*trias[0]));
+    dof_handlers.emplace_back(new DoFHandler<dim>(*trias[1]));
+    dof_handlers.emplace_back(new DoFHandler<dim>(*trias[2]));
+    dof_handlers.emplace_back(new DoFHandler<dim>(*trias[2]));
+    dof_handlers[0]->distribute_dofs(FE_Q<dim>(1));
+    dof_handlers[1]->distribute_dofs(FE_Q<dim>(1));
+    dof_handlers[2]->distribute_dofs(FE_Q<dim>(1));
+    dof_handlers[3]->distribute_dofs(FE_Q<dim>(2));
+
+    MGLevelObject<MGTwoLevelTransfer<dim, VectorType>> transfers(0, 3);
+    transfers[1].reinit_geometric_transfer(*dof_handlers[1], *dof_handlers[0]);
+    transfers[2].reinit_geometric_transfer(*dof_handlers[2], *dof_handlers[1]);
+    transfers[3].reinit_polynomial_transfer(*dof_handlers[3],
+                                            *dof_handlers[2]);
+
+    MGTransferGlobalCoarsening<dim, VectorType> transfer(transfers);
+
+    const LinearFunction<dim> function(1);
+
+    VectorType fine(dof_handlers[3]->n_dofs());
+    VectorTools::interpolate(*dof_handlers[3], function, fine);
+
+    MGLevelObject<VectorType> levels;
+    transfer.interpolate_to_mg(*dof_handlers[3], levels, fine);
+
+    for (unsigned int level = 0; level <= 3; ++level)
+      {
+        VectorType reference(levels[level]);
+        VectorTools::interpolate(*dof_handlers[level], function, reference);
+        reference -= levels[level];
+        deallog << "Level " << level << " size " << levels[level].size()
+                << " interpolation error " << filter(reference.linfty_norm())
+                << std::endl;
+      }
+
+    // go down and up again through the hierarchy with prolongation
+    for (unsigned int level = 1; level <= 3; ++level)
+      transfer.prolongate(level, levels[level], levels[level - 1]);
+
+    VectorType result(fine);
+    transfer.copy_from_mg(*dof_handlers[3], result, levels);
+    result -= fine;
+    deallog << "Prolongation through hierarchy error "
+            << filter(result.linfty_norm()) << std::endl;
+  }
+
+  deallog.pop();
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog << "Polynomial sequences for degree 7:" << std::endl;
+  for (const auto type :
+       {MGTransferGlobalCoarseningTools::PolynomialCoarseningSequenceType::
+          bisect,
+        MGTransferGlobalCoarseningTools::PolynomialCoarseningSequenceType::
+          decrease_by_one,
+        MGTransferGlobalCoarseningTools::PolynomialCoarseningSequenceType::
+          go_to_one})
+    {
+      for (const unsigned int degree :
+           MGTransferGlobalCoarseningTools::
+             create_polynomial_coarsening_sequence(7, type))
+        deallog << degree << ' ';
+      deallog << std::endl;
+    }
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,245 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check MGTwoLevelTransfer for polynomial and geometric global coarsening
+// on locally refined meshes distributed among several processes, with
+// hanging-node constraints on both levels: prolongation must reproduce
+// linear functions exactly once the constraints of the fine level have been
+// applied, and restriction must be the transpose of prolongation.
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/distributed/shared_tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+class LinearFunction : public Function<dim>
+{
+public:
+  virtual double
+  value(const Point<dim> &p, const unsigned int) const override
+  {
+    double result = 1.;
+    for (unsigned int d = 0; d < dim; ++d)
+      result += (d + 1.) * p[d];
+    return result;
+  }
+};
+
+
+
+double
+filter(const double value)
+{
+  return std::abs(value) < 1e-12 ? 0. : value;
+}
+
+
+
+// create a mesh with hanging nodes: refine once globally and then refine
+// the cell whose first vertex is at the origin, followed by
+// @p n_global_refinements global refinements
+template <int dim>
+void
+create_mesh(parallel::shared::Triangulation<dim> &tria,
+            const unsigned int                    n_global_refinements)
+{
+  GridGenerator::hyper_cube(tria, -1., 1.);
+  tria.refine_global(1);
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->vertex(0).norm() < 1e-10)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  tria.refine_global(n_global_refinements);
+}
+
+
+
+// interpolate LinearFunction into the vector @p vec, whose layout is the one
+// of the transfer operator. VectorTools::interpolate() writes to all degrees
+// of freedom of the locally owned cells, so go through a ghosted vector
+template <int dim, typename VectorType>
+void
+interpolate_linear_function(const DoFHandler<dim> &dof_handler,
+                            VectorType &           vec)
+{
+  IndexSet locally_relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs(dof_handler, locally_relevant_dofs);
+  VectorType ghosted(dof_handler.locally_owned_dofs(),
+                     locally_relevant_dofs,
+                     MPI_COMM_WORLD);
+  VectorTools::interpolate(dof_handler, LinearFunction<dim>(), ghosted);
+  vec.copy_locally_owned_data_from(ghosted);
+}
+
+
+
+template <int dim>
+void
+make_constraints(const DoFHandler<dim> &    dof_handler,
+                 AffineConstraints<double> &constraints)
+{
+  IndexSet locally_relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs(dof_handler, locally_relevant_dofs);
+  constraints.reinit(locally_relevant_dofs);
+  DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+  constraints.close();
+}
+
+
+
+template <int dim>
+void
+check(const DoFHandler<dim> &dof_handler_fine,
+      const DoFHandler<dim> &dof_handler_coarse,
+      const bool             geometric)
+{
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+  deallog << (geometric ? "geometric: " : "polynomial: ")
+          << dof_handler_fine.get_fe().get_name() << " <-> "
+          << dof_handler_coarse.get_fe().get_name() << std::endl;
+
+  AffineConstraints<double> constraint_fine, constraint_coarse;
+  make_constraints(dof_handler_fine, constraint_fine);
+  make_constraints(dof_handler_coarse, constraint_coarse);
+
+  const unsigned int n_constraints_fine = Utilities::MPI::sum(
+    constraint_fine.n_constraints(), MPI_COMM_WORLD);
+  deallog << "Hanging-node constraints: "
+          << (n_constraints_fine > 0 ? "present" : "none") << std::endl;
+
+  MGTwoLevelTransfer<dim, VectorType> transfer;
+  if (geometric)
+    transfer.reinit_geometric_transfer(dof_handler_fine,
+                                       dof_handler_coarse,
+                                       constraint_fine,
+                                       constraint_coarse);
+  else
+    transfer.reinit_polynomial_transfer(dof_handler_fine,
+                                        dof_handler_coarse,
+                                        constraint_fine,
+                                        constraint_coarse);
+
+  // prolongation of a linear function
+  {
+    VectorType fine_ref(transfer.get_partitioner_fine()->locally_owned_range(),
+                        MPI_COMM_WORLD);
+    VectorType coarse_ref(
+      transfer.get_partitioner_coarse()->locally_owned_range(),
+      MPI_COMM_WORLD);
+    interpolate_linear_function(dof_handler_fine, fine_ref);
+    interpolate_linear_function(dof_handler_coarse, coarse_ref);
+
+    VectorType fine(fine_ref);
+    transfer.prolongate(fine, coarse_ref);
+    constraint_fine.distribute(fine);
+    fine -= fine_ref;
+    deallog << "Prolongation error: " << filter(fine.linfty_norm())
+            << std::endl;
+  }
+
+  // restriction is the transpose of prolongation
+  {
+    VectorType fine(transfer.get_partitioner_fine()->locally_owned_range(),
+                    MPI_COMM_WORLD);
+    VectorType coarse(transfer.get_partitioner_coarse()->locally_owned_range(),
+                      MPI_COMM_WORLD);
+    VectorType fine_random(fine), coarse_random(coarse);
+    for (unsigned int i = 0; i < fine.local_size(); ++i)
+      fine_random.local_element(i) = random_value<double>();
+    for (unsigned int i = 0; i < coarse.local_size(); ++i)
+      coarse_random.local_element(i) = random_value<double>();
+
+    transfer.prolongate(fine, coarse_random);
+    transfer.restrict_and_add(coarse, fine_random);
+
+    deallog << "Adjoint error:      "
+            << filter((fine * fine_random - coarse * coarse_random) /
+                      (fine * fine_random))
+            << std::endl;
+  }
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  deallog.push(std::to_string(dim) + "d");
+
+  parallel::shared::Triangulation<dim> tria_fine(MPI_COMM_WORLD);
+  parallel::shared::Triangulation<dim> tria_coarse(MPI_COMM_WORLD);
+  create_mesh(tria_fine, 1);
+  create_mesh(tria_coarse, 0);
+
+  deallog << "Active cells: " << tria_fine.n_global_active_cells() << " and "
+          << tria_coarse.n_global_active_cells() << std::endl;
+
+  // polynomial transfer on the fine mesh
+  {
+    DoFHandler<dim> dof_handler_fine(tria_fine), dof_handler_coarse(tria_fine);
+    dof_handler_fine.distribute_dofs(FE_Q<dim>(2));
+    dof_handler_coarse.distribute_dofs(FE_Q<dim>(1));
+    check(dof_handler_fine, dof_handler_coarse, false);
+  }
+
+  // geometric transfer between the two meshes
+  {
+    DoFHandler<dim> dof_handler_fine(tria_fine),
+      dof_handler_coarse(tria_coarse);
+    dof_handler_fine.distribute_dofs(FE_Q<dim>(1));
+    dof_handler_coarse.distribute_dofs(FE_Q<dim>(1));
+    check(dof_handler_fine, dof_handler_coarse, true);
+
+    dof_handler_fine.distribute_dofs(FE_Q<dim>(2));
+    dof_handler_coarse.distribute_dofs(FE_Q<dim>(2));
+    check(dof_handler_fine, dof_handler_coarse, true);
+  }
+
+  deallog.pop();
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  MPILogInitAll                    log;
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,139 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that the cell-bucketed particle storage of the particle handler keeps
+// particles grouped by cell, correctly skips empty cells during iteration,
+// and keeps properties attached to their particles when particles are
+// removed or moved to other cells.
+
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/particles/particle_handler.h>
+
+#include "../tests.h"
+
+template <int dim>
+Point<dim>
+cell_center(const unsigned int index)
+{
+  // center of cell 2.index of a twice globally refined unit square
+  const unsigned int parent = index / 4;
+  const unsigned int child  = index % 4;
+  return Point<dim>(0.5 * (parent % 2) + 0.25 * (child % 2) + 0.125,
+                    0.5 * (parent / 2) + 0.25 * (child / 2) + 0.125);
+}
+
+
+
+template <int dim>
+void
+print_particles(const Particles::ParticleHandler<dim> &particle_handler,
+                const Triangulation<dim> &             tr)
+{
+  for (const auto &particle : particle_handler)
+    deallog << "Particle " << particle.get_id() << " in cell "
+            << particle.get_surrounding_cell(tr) << " at reference location "
+            << particle.get_reference_location() << " with property "
+            << particle.get_properties()[0] << std::endl;
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  {
+    Triangulation<dim> tr;
+
+    GridGenerator::hyper_cube(tr);
+    tr.refine_global(2);
+    MappingQ<dim> mapping(1);
+
+    Particles::ParticleHandler<dim> particle_handler(tr, mapping, 1);
+
+    // insert particles into cells 2.5, 2.0, 2.5, 2.12, and 2.2, in this order
+    const std::vector<unsigned int> cell_indices = {5, 0, 5, 12, 2};
+    for (unsigned int i = 0; i < cell_indices.size(); ++i)
+      {
+        const typename Triangulation<dim>::active_cell_iterator cell(
+          &tr, 2, cell_indices[i]);
+        Particles::Particle<dim> particle(cell_center<dim>(cell_indices[i]),
+                                          Point<dim>(0.5, 0.5),
+                                          i);
+        auto particle_it = particle_handler.insert_particle(particle, cell);
+        particle_it->get_properties()[0] = 10. * i;
+      }
+
+    print_particles(particle_handler, tr);
+
+    for (const auto &cell : tr.active_cell_iterators())
+      if (particle_handler.n_particles_in_cell(cell) > 0)
+        {
+          deallog << "Cell " << cell << " contains "
+                  << particle_handler.n_particles_in_cell(cell)
+                  << " particles:";
+          for (const auto &particle : particle_handler.particles_in_cell(cell))
+            deallog << ' ' << particle.get_id();
+          deallog << std::endl;
+        }
+
+    // remove particle 0
+    for (auto particle = particle_handler.begin();
+         particle != particle_handler.end();
+         ++particle)
+      if (particle->get_id() == 0)
+        {
+          particle_handler.remove_particle(particle);
+          break;
+        }
+
+    deallog << "Number of particles: "
+            << particle_handler.n_locally_owned_particles() << std::endl;
+
+    // move particle 1 from cell 2.0 into cell 2.2, which already contains
+    // particle 4
+    for (auto &particle : particle_handler)
+      if (particle.get_id() == 1)
+        particle.set_location(cell_center<dim>(2));
+
+    particle_handler.sort_particles_into_subdomains_and_cells();
+
+    print_particles(particle_handler, tr);
+
+    auto last_particle = particle_handler.end();
+    --last_particle;
+    deallog << "Last particle: " << last_particle->get_id() << std::endl;
+  }
+
+  deallog << "OK" << std::endl;
+}
+
+
+
+int
+main(int argc, char *argv[])
+{
+  initlog();
+
+  deallog.push("2d/2d");
+  test<2>();
+  deallog.pop();
+}
@@ -0,0 +1,119 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that ParticleHandler::remove_particles() removes several particles
+// of the same cell at once, given by iterators in arbitrary order, and keeps
+// the properties of the remaining particles attached to them
+
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/particles/particle_handler.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+print_particles(const Particles::ParticleHandler<dim> &particle_handler,
+                const Triangulation<dim> &             tr)
+{
+  for (const auto &particle : particle_handler)
+    deallog << "Particle " << particle.get_id() << " in cell "
+            << particle.get_surrounding_cell(tr) << " with property "
+            << particle.get_properties()[0] << std::endl;
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  {
+    Triangulation<dim> tr;
+
+    GridGenerator::hyper_cube(tr);
+    tr.refine_global(1);
+    MappingQ<dim> mapping(1);
+
+    Particles::ParticleHandler<dim> particle_handler(tr, mapping, 1);
+
+    // insert six particles into the first cell and two into the last one
+    const auto first_cell = tr.begin_active();
+    const auto last_cell  = tr.last_active();
+    for (unsigned int i = 0; i < 8; ++i)
+      {
+        const auto cell = (i < 6 ? first_cell : last_cell);
+        Point<dim> reference_location;
+        for (unsigned int d = 0; d < dim; ++d)
+          reference_location[d] = 0.1 * (i + 1);
+        Particles::Particle<dim> particle(
+          mapping.transform_unit_to_real_cell(cell, reference_location),
+          reference_location,
+          i);
+        auto particle_it = particle_handler.insert_particle(particle, cell);
+        particle_it->get_properties()[0] = 10. * i;
+      }
+
+    print_particles(particle_handler, tr);
+
+    // remove the particles with ids 0, 2, 3, 5 in the first cell and 7 in
+    // the last cell, collecting the iterators in descending order of the
+    // ids to make sure that the order does not matter
+    std::vector<typename Particles::ParticleHandler<dim>::particle_iterator>
+      particles_to_remove;
+    for (auto particle = particle_handler.begin();
+         particle != particle_handler.end();
+         ++particle)
+      if (particle->get_id() == 0 || particle->get_id() == 2 ||
+          particle->get_id() == 3 || particle->get_id() == 5 ||
+          particle->get_id() == 7)
+        particles_to_remove.insert(particles_to_remove.begin(), particle);
+
+    particle_handler.remove_particles(particles_to_remove);
+
+    deallog << "Number of particles: "
+            << particle_handler.n_locally_owned_particles() << std::endl;
+    deallog << "Particles in first cell: "
+            << particle_handler.n_particles_in_cell(first_cell) << std::endl;
+    deallog << "Particles in last cell: "
+            << particle_handler.n_particles_in_cell(last_cell) << std::endl;
+
+    print_particles(particle_handler, tr);
+  }
+
+  deallog << "OK" << std::endl;
+}
+
+
+
+int
+main(int argc, char *argv[])
+{
+  initlog();
+
+  deallog.push("2d/2d");
+  test<2>();
+  deallog.pop();
+
+  deallog.push("3d/3d");
+  test<3>();
+  deallog.pop();
+}
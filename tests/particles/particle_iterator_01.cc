@@ -20,6 +20,9 @@
 
 #include <deal.II/base/array_view.h>
 
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
 #include <deal.II/particles/particle.h>
 #include <deal.II/particles/particle_iterator.h>
 
@@ -55,16 +58,23 @@ test()
     particle.set_properties(
       ArrayView<double>(&properties[0], properties.size()));
 
-    std::multimap<Particles::internal::LevelInd, Particles::Particle<dim>> map;
+    Triangulation<dim> tr;
+    GridGenerator::hyper_cube(tr);
 
-    Particles::internal::LevelInd level_index = std::make_pair(0, 0);
-    map.insert(std::make_pair(level_index, particle));
+    Particles::internal::ParticleStorage<dim, dim> particle_container;
+    particle_container.reinit(tr.n_active_cells(), pool);
 
-    particle.get_properties()[0] = 0.05;
-    map.insert(std::make_pair(level_index, particle));
+    particle_container.insert(0, particle);
 
-    Particles::ParticleIterator<dim> particle_it(map, map.begin());
-    Particles::ParticleIterator<dim> particle_end(map, map.end());
+    particle.get_properties()[0] = 0.05;
+    particle_container.insert(0, particle);
+
+    Particles::ParticleIterator<dim> particle_it(particle_container,
+                                                 tr.begin_active(),
+                                                 0);
+    Particles::ParticleIterator<dim> particle_end(particle_container,
+                                                  tr.end(),
+                                                  0);
 
     for (; particle_it != particle_end; ++particle_it)
       {
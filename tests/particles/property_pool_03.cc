@@ -0,0 +1,84 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2020 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that a property pool reuses released slots, that slots can be
+// allocated and released in bulk, and that the structure-of-arrays layout
+// stores the same property of consecutive slots contiguously
+
+#include <deal.II/particles/property_pool.h>
+
+#include "../tests.h"
+
+
+void
+test()
+{
+  {
+    Particles::PropertyPool pool(2);
+
+    const Particles::PropertyPool::Handle handle1 =
+      pool.allocate_properties_array();
+    const Particles::PropertyPool::Handle handle2 =
+      pool.allocate_properties_array();
+    deallog << "Distance between consecutive slots: " << handle2 - handle1
+            << std::endl;
+
+    pool.deallocate_properties_array(handle1);
+    const Particles::PropertyPool::Handle handle3 =
+      pool.allocate_properties_array();
+    deallog << "Slot reused: " << (handle3 == handle1) << std::endl;
+    deallog << "Allocated slots: " << pool.n_allocated_slots() << std::endl;
+
+    const std::vector<Particles::PropertyPool::Handle> handles =
+      pool.allocate_properties_arrays(1500);
+    deallog << "Allocated slots: " << pool.n_allocated_slots() << std::endl;
+    deallog << "Slabs: " << pool.n_slabs() << std::endl;
+
+    pool.deallocate_properties_arrays(handles);
+    deallog << "Allocated slots: " << pool.n_allocated_slots() << std::endl;
+    deallog << "First bulk slot reused: "
+            << (pool.allocate_properties_array() == handles[0]) << std::endl;
+  }
+
+  {
+    Particles::PropertyPool pool(
+      3, Particles::PropertyPool::Layout::structure_of_arrays);
+
+    const std::vector<Particles::PropertyPool::Handle> handles =
+      pool.allocate_properties_arrays(4);
+    for (unsigned int slot = 0; slot < handles.size(); ++slot)
+      for (unsigned int component = 0; component < 3; ++component)
+        pool.get_property(handles[slot], component) = 10. * slot + component;
+
+    const ArrayView<double> column = pool.get_slab_column(0, 1);
+    deallog << "Column 1:";
+    for (unsigned int slot = 0; slot < handles.size(); ++slot)
+      deallog << ' ' << column[slot];
+    deallog << std::endl;
+  }
+
+  deallog << "OK" << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+  test();
+}